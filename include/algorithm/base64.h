@@ -9,6 +9,7 @@
 // @date 2017.11.17
 //
 // @see https://en.wikipedia.org/wiki/Base64
+// @note x86平台运行时检测SSSE3/AVX2，使用SIMD批量编解码，其他平台使用标量实现
 
 #pragma once
 
@@ -138,5 +139,115 @@ ATFRAMEWORK_UTILS_API int base64_decode(std::string &dst, const unsigned char *s
  */
 ATFRAMEWORK_UTILS_API int base64_decode(std::string &dst, const std::string &in,
                                         base64_mode_t::type mode = base64_mode_t::EN_BMT_STANDARD);
+
+/**
+ * @brief          Streaming base64 encoder
+ *
+ * @note           Input can be split into chunks of any size, the output is the same as base64_encode on the whole
+ *                 input. Only complete 4-character groups are written by update(), up to 2 bytes are kept
+ *                 internally and flushed (with padding) by finish().
+ * @note           No trailing \0 is written.
+ */
+class ATFRAMEWORK_UTILS_API base64_encoder {
+ public:
+  explicit base64_encoder(base64_mode_t::type mode = base64_mode_t::EN_BMT_STANDARD) noexcept;
+
+  /**
+   * @brief          Encode a chunk
+   *
+   * @param dst      destination buffer
+   * @param dlen     size of the destination buffer
+   * @param olen     number of bytes written
+   * @param src      source buffer
+   * @param slen     amount of data to be encoded
+   *
+   * @return         0 if successful, or -1 if dlen is too small. *olen is set to the required size when failed,
+   *                 and nothing is consumed.
+   */
+  int update(unsigned char *dst, size_t dlen, size_t *olen, const unsigned char *src, size_t slen) noexcept;
+
+  /**
+   * @brief          Encode a chunk and append the result to dst
+   * @return         0 if successful
+   */
+  int update(std::string &dst, const unsigned char *src, size_t slen);
+
+  /**
+   * @brief          Flush the pending bytes and padding, then reset the encoder
+   *
+   * @return         0 if successful, or -1 if dlen is too small(at most 4 bytes are needed).
+   */
+  int finish(unsigned char *dst, size_t dlen, size_t *olen) noexcept;
+
+  /**
+   * @brief          Flush the pending bytes and padding to the end of dst, then reset the encoder
+   * @return         0 if successful
+   */
+  int finish(std::string &dst);
+
+  void reset() noexcept;
+
+  inline base64_mode_t::type get_mode() const noexcept { return mode_; }
+
+ private:
+  base64_mode_t::type mode_;
+  unsigned char pending_[3];
+  size_t pending_len_;
+};
+
+/**
+ * @brief          Streaming base64 decoder, support no padding
+ *
+ * @note           Input can be split into chunks of any size. Spaces, tabs and line breaks are skipped anywhere.
+ * @note           After an error(-2) is returned, reset() must be called before decoding another stream.
+ */
+class ATFRAMEWORK_UTILS_API base64_decoder {
+ public:
+  explicit base64_decoder(base64_mode_t::type mode = base64_mode_t::EN_BMT_STANDARD) noexcept;
+
+  /**
+   * @brief          Decode a chunk
+   *
+   * @param dst      destination buffer
+   * @param dlen     size of the destination buffer, (pending + slen) / 4 * 3 bytes is always enough
+   * @param olen     number of bytes written
+   * @param src      source buffer
+   * @param slen     amount of data to be decoded
+   *
+   * @return         0 if successful, -1 for too small dlen, or -2 if the input data is not correct.
+   *                 *olen is set to the required size and nothing is consumed when -1 is returned.
+   */
+  int update(unsigned char *dst, size_t dlen, size_t *olen, const unsigned char *src, size_t slen) noexcept;
+
+  /**
+   * @brief          Decode a chunk and append the result to dst
+   * @return         0 if successful, or -2 if the input data is not correct.
+   */
+  int update(std::string &dst, const unsigned char *src, size_t slen);
+
+  /**
+   * @brief          Flush the tail of a stream without padding, then reset the decoder
+   *
+   * @return         0 if successful, -1 for too small dlen(at most 2 bytes are needed), or -2 if the stream is
+   *                 truncated.
+   */
+  int finish(unsigned char *dst, size_t dlen, size_t *olen) noexcept;
+
+  /**
+   * @brief          Flush the tail of a stream to the end of dst, then reset the decoder
+   * @return         0 if successful, or -2 if the stream is truncated.
+   */
+  int finish(std::string &dst);
+
+  void reset() noexcept;
+
+  inline base64_mode_t::type get_mode() const noexcept { return mode_; }
+
+ private:
+  base64_mode_t::type mode_;
+  uint32_t pending_bits_;
+  size_t pending_len_;
+  size_t padding_len_;
+};
 ATFRAMEWORK_UTILS_NAMESPACE_END
 
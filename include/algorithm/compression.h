@@ -38,7 +38,13 @@
 #  include <cstdint>
 #  include <vector>
 
+#  include "lock/spin_lock.h"
+
 ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace thread {
+class work_stealing_pool;
+}
+
 namespace compression {
 
 /**
@@ -76,6 +82,7 @@ struct ATFRAMEWORK_UTILS_API error_code_t {
     kBufferTooSmall = -3,
     kOperation = -4,
     kDisabled = -5,
+    kBadFormat = -6,
   };
 };
 
@@ -142,6 +149,421 @@ ATFRAMEWORK_UTILS_API int compress_with_raw_level(algorithm_t type, gsl::span<co
 ATFRAMEWORK_UTILS_API int decompress(algorithm_t type, gsl::span<const unsigned char> input, size_t original_size,
                                      std::vector<unsigned char>& output) noexcept;
 
+/**
+ * @brief Train a dictionary from samples for small message compression
+ * @note Only zstd supports trained dictionaries, other algorithms return kNotSupport
+ * @param type Compression algorithm
+ * @param samples All samples stored back to back
+ * @param sample_sizes Size of each sample in samples
+ * @param max_dictionary_size Max size of the dictionary, 100KB is a reasonable default for zstd
+ * @param output Output dictionary (will be resized)
+ * @return 0 on success, or error code
+ */
+ATFRAMEWORK_UTILS_API int train_dictionary(algorithm_t type, gsl::span<const unsigned char> samples,
+                                           gsl::span<const size_t> sample_sizes, size_t max_dictionary_size,
+                                           std::vector<unsigned char>& output) noexcept;
+
+/**
+ * @brief Reusable compression context
+ *
+ * The algorithm context (ZSTD_CCtx, LZ4_stream_t/LZ4_streamHC_t, z_stream) is created once by init() and reused by
+ * every compress() call, so small messages do not pay for context setup and allocation.
+ * One-shot output is the same format as compression::compress(), and can be decoded by compression::decompress().
+ * Streaming output uses the standard frame format of each algorithm (zstd frame, LZ4 frame, zlib stream).
+ *
+ * @note Not thread-safe, use one compressor per thread.
+ */
+class ATFRAMEWORK_UTILS_API compressor {
+ public:
+  compressor() noexcept;
+  ~compressor();
+
+  compressor(const compressor&) = delete;
+  compressor& operator=(const compressor&) = delete;
+
+  compressor(compressor&& other) noexcept;
+  compressor& operator=(compressor&& other) noexcept;
+
+  /**
+   * @brief Create algorithm context with unified level mapping
+   * @return 0 on success, or error code
+   */
+  int init(algorithm_t type, level_t level = level_t::kDefault) noexcept;
+
+  /**
+   * @brief Create algorithm context with algorithm-specific raw level, same meaning as compress_with_raw_level()
+   * @return 0 on success, or error code
+   */
+  int init_with_raw_level(algorithm_t type, int raw_level) noexcept;
+
+  /**
+   * @brief Release algorithm context and dictionary
+   */
+  void close() noexcept;
+
+  bool is_valid() const noexcept;
+
+  algorithm_t get_algorithm() const noexcept;
+
+  /**
+   * @brief Load dictionary used by the following compress() and stream_*() calls, empty dictionary to unload
+   * @note zstd only, the decompressor must load the same dictionary
+   * @return 0 on success, or error code
+   */
+  int load_dictionary(gsl::span<const unsigned char> dictionary) noexcept;
+
+  /**
+   * @brief Max output size of compress() for input_size bytes
+   */
+  size_t compress_bound(size_t input_size) const noexcept;
+
+  /**
+   * @brief Compress into caller-provided buffer
+   * @param input Input data
+   * @param output Output buffer, compress_bound(input.size()) is always enough
+   * @param output_size Size of compressed data
+   * @return 0 on success, kBufferTooSmall if output is not enough, or other error code
+   */
+  int compress(gsl::span<const unsigned char> input, gsl::span<unsigned char> output, size_t& output_size) noexcept;
+
+  /**
+   * @brief Compress into vector, the capacity of output is reused
+   * @return 0 on success, or error code
+   */
+  int compress(gsl::span<const unsigned char> input, std::vector<unsigned char>& output) noexcept;
+
+  /**
+   * @brief Start a new streaming frame, any unfinished frame is discarded
+   * @return 0 on success, or error code
+   */
+  int stream_begin() noexcept;
+
+  /**
+   * @brief Compress next chunk of the frame
+   * @param input Input data
+   * @param output Compressed data is appended to output
+   * @return 0 on success, or error code
+   */
+  int stream_update(gsl::span<const unsigned char> input, std::vector<unsigned char>& output) noexcept;
+
+  /**
+   * @brief Flush and finish the frame
+   * @param output Compressed data is appended to output
+   * @return 0 on success, or error code
+   */
+  int stream_end(std::vector<unsigned char>& output) noexcept;
+
+  /**
+   * @brief Compress one frame with internal worker threads of the algorithm library
+   * @note zstd only, and libzstd must be built with multithread support. Output is still a single zstd frame, use
+   *       compress_blocks() when random access is required.
+   * @param worker_count Worker thread count, 0 to disable
+   * @return 0 on success, or error code
+   */
+  int set_worker_count(size_t worker_count) noexcept;
+
+ private:
+  int init_internal(algorithm_t type, bool use_raw_level, int raw_level, level_t level) noexcept;
+
+ private:
+  algorithm_t algorithm_;
+  void* context_;
+};
+
+/**
+ * @brief Reusable decompression context
+ *
+ * The algorithm context (ZSTD_DCtx, LZ4F_dctx, z_stream) is created once by init() and reused by every call.
+ *
+ * @note Not thread-safe, use one decompressor per thread.
+ */
+class ATFRAMEWORK_UTILS_API decompressor {
+ public:
+  decompressor() noexcept;
+  ~decompressor();
+
+  decompressor(const decompressor&) = delete;
+  decompressor& operator=(const decompressor&) = delete;
+
+  decompressor(decompressor&& other) noexcept;
+  decompressor& operator=(decompressor&& other) noexcept;
+
+  int init(algorithm_t type) noexcept;
+
+  void close() noexcept;
+
+  bool is_valid() const noexcept;
+
+  algorithm_t get_algorithm() const noexcept;
+
+  /**
+   * @brief Load dictionary used by the following decompress() and stream_*() calls, empty dictionary to unload
+   * @note zstd only
+   * @return 0 on success, or error code
+   */
+  int load_dictionary(gsl::span<const unsigned char> dictionary) noexcept;
+
+  /**
+   * @brief Decompress data produced by compressor::compress() or compression::compress() into caller-provided buffer
+   * @param input Compressed data
+   * @param output Output buffer, must be at least the original size for lz4 and zlib
+   * @param output_size Size of decompressed data
+   * @return 0 on success, kBufferTooSmall if output is not enough, or other error code
+   */
+  int decompress(gsl::span<const unsigned char> input, gsl::span<unsigned char> output, size_t& output_size) noexcept;
+
+  /**
+   * @brief Decompress into vector, the capacity of output is reused
+   * @param original_size Original size (bytes); 0 means auto-detect when supported
+   * @return 0 on success, or error code
+   */
+  int decompress(gsl::span<const unsigned char> input, size_t original_size,
+                 std::vector<unsigned char>& output) noexcept;
+
+  /**
+   * @brief Start decoding a new streaming frame
+   * @return 0 on success, or error code
+   */
+  int stream_begin() noexcept;
+
+  /**
+   * @brief Decode next chunk of a frame produced by compressor::stream_*()
+   * @param input Compressed data, may be split at any position
+   * @param output Decompressed data is appended to output
+   * @return 0 on success, or error code. Data after the end of frame is ignored.
+   */
+  int stream_update(gsl::span<const unsigned char> input, std::vector<unsigned char>& output) noexcept;
+
+  /**
+   * @brief Whether the end of the current frame has been decoded
+   */
+  bool is_stream_finished() const noexcept;
+
+ private:
+  algorithm_t algorithm_;
+  void* context_;
+};
+
+/**
+ * @brief Header of block container
+ *
+ * Layout of block container (all integers are little-endian):
+ *   header: magic "ATCB"(4) | version(1) | reserved(3) | algorithm(4) | block_size(4) | block_count(8) |
+ *           original_size(8)
+ *   index:  block_count * { compressed_offset(8) | compressed_size(4) | original_size(4) }
+ *   data:   compressed blocks, compressed_offset is relative to the beginning of data
+ *
+ * Every block is compressed independently in the same format as compress(), so any block can be decompressed
+ * without touching the others.
+ */
+struct ATFRAMEWORK_UTILS_API block_container_info {
+  algorithm_t algorithm;
+  size_t block_size;
+  size_t block_count;
+  size_t original_size;
+};
+
+struct ATFRAMEWORK_UTILS_API block_info {
+  size_t original_offset;
+  size_t original_size;
+  size_t compressed_offset;  // Offset in the whole container
+  size_t compressed_size;
+};
+
+/**
+ * @brief Split input into independent blocks, compress them in parallel and write a seekable block container
+ * @param type Compression algorithm
+ * @param input Input data
+ * @param output Output container (will be resized)
+ * @param level Unified compression level
+ * @param block_size Uncompressed size of each block, 0 means 1MB. Larger blocks get better ratio, smaller blocks
+ *                   get finer random access.
+ * @param pool Worker pool, nullptr to compress on the calling thread. The calling thread always takes part, so it's
+ *             safe to call from a worker of pool.
+ * @return 0 on success, or error code
+ */
+ATFRAMEWORK_UTILS_API int compress_blocks(algorithm_t type, gsl::span<const unsigned char> input,
+                                          std::vector<unsigned char>& output, level_t level = level_t::kDefault,
+                                          size_t block_size = 0, thread::work_stealing_pool* pool = nullptr) noexcept;
+
+/**
+ * @brief Decompress the whole block container in parallel
+ * @param input Block container produced by compress_blocks()
+ * @param output Output buffer (will be resized)
+ * @param pool Worker pool, nullptr to decompress on the calling thread
+ * @param max_output_size Max original size accepted from the container header, 0 means unlimited. Set it when the
+ *                        container comes from an untrusted source.
+ * @return 0 on success, kBufferTooSmall if the original size is larger than max_output_size, or other error code
+ */
+ATFRAMEWORK_UTILS_API int decompress_blocks(gsl::span<const unsigned char> input, std::vector<unsigned char>& output,
+                                            thread::work_stealing_pool* pool = nullptr,
+                                            size_t max_output_size = 0) noexcept;
+
+/**
+ * @brief Random access reader of block container
+ * @note The container memory is not copied and must outlive the reader. Not thread-safe.
+ */
+class ATFRAMEWORK_UTILS_API block_container_reader {
+ public:
+  block_container_reader() noexcept;
+
+  /**
+   * @brief Parse and validate header and block index
+   * @return 0 on success, kBadFormat if the container is broken, or other error code
+   */
+  int open(gsl::span<const unsigned char> container) noexcept;
+
+  void close() noexcept;
+
+  bool is_valid() const noexcept;
+
+  const block_container_info& get_info() const noexcept;
+
+  /**
+   * @return 0 on success, or kInvalidParam if index is out of range
+   */
+  int get_block_info(size_t index, block_info& output) const noexcept;
+
+  /**
+   * @brief Get index of the block which contains original_offset
+   * @return Block index, or get_info().block_count if original_offset is out of range
+   */
+  size_t find_block(size_t original_offset) const noexcept;
+
+  /**
+   * @brief Decompress one block
+   * @param output Output buffer (will be resized)
+   * @return 0 on success, or error code
+   */
+  int decompress_block(size_t index, std::vector<unsigned char>& output) noexcept;
+
+  /**
+   * @brief Decompress one block into caller-provided buffer
+   * @param output Output buffer, must be at least the original size of block
+   * @param output_size Size of decompressed data
+   * @return 0 on success, or error code
+   */
+  int decompress_block(size_t index, gsl::span<unsigned char> output, size_t& output_size) noexcept;
+
+ private:
+  gsl::span<const unsigned char> container_;
+  size_t data_offset_;
+  block_container_info info_;
+  decompressor decompressor_;
+};
+
+/**
+ * @brief Estimate Shannon entropy of data by sampling
+ * @param input Input data
+ * @param sample_size Max bytes to sample, samples are taken from several positions spread over input
+ * @return Estimated entropy in bits per byte (0-8), encrypted or already compressed data is close to 8
+ */
+ATFRAMEWORK_UTILS_API double estimate_entropy(gsl::span<const unsigned char> input, size_t sample_size = 4096) noexcept;
+
+struct ATFRAMEWORK_UTILS_API adaptive_candidate {
+  algorithm_t algorithm;
+  level_t level;
+};
+
+struct ATFRAMEWORK_UTILS_API adaptive_policy_options {
+  // Candidates to choose from, empty means kFast and kBalanced of all supported algorithms
+  std::vector<adaptive_candidate> candidates;
+  // Max compression CPU time in nanoseconds per input byte, 0 means unlimited
+  double cpu_budget_ns_per_byte;
+  // Payloads smaller than this are never compressed
+  size_t min_input_size;
+  // Skip compression when the expected saving ratio (1 - output/input) is lower than this
+  double min_saving_ratio;
+  // Skip compression when sampled entropy in bits per byte is higher than this
+  double max_entropy;
+  // Max bytes sampled by estimate_entropy()
+  size_t entropy_sample_size;
+  // Try another candidate every explore_interval decisions of the same size bucket to refresh stale stats
+  uint32_t explore_interval;
+
+  adaptive_policy_options() noexcept
+      : cpu_budget_ns_per_byte(0),
+        min_input_size(64),
+        min_saving_ratio(0.05),
+        max_entropy(7.5),
+        entropy_sample_size(4096),
+        explore_interval(64) {}
+};
+
+struct ATFRAMEWORK_UTILS_API adaptive_decision {
+  bool skip;               // Send uncompressed data
+  size_t candidate_index;  // Index in adaptive_policy::get_candidates(), valid when skip is false
+  algorithm_t algorithm;   // kNone when skip is true
+  level_t level;
+  size_t size_bucket;
+  double entropy;  // Sampled entropy, negative if not sampled
+};
+
+struct ATFRAMEWORK_UTILS_API adaptive_policy_stats {
+  uint64_t sample_count;
+  double compression_ratio;     // Moving average of output/input
+  double nanoseconds_per_byte;  // Moving average of compression CPU time
+};
+
+/**
+ * @brief Adaptive compression policy
+ *
+ * Tracks moving averages of compression ratio and CPU time for each candidate and size bucket, and picks the
+ * candidate with the best ratio inside the CPU budget. Payloads which are too small, have high sampled entropy (already
+ * compressed or encrypted) or are expected to save too little are not compressed.
+ *
+ * @note Thread-safe, one policy can be shared by all senders.
+ */
+class ATFRAMEWORK_UTILS_API adaptive_policy {
+ public:
+  enum : size_t {
+    kSizeBucketCount = 8,  // <256, <1K, <4K, <16K, <64K, <256K, <1M, >=1M
+    kWarmupSamples = 2,    // Samples of each candidate before it's trusted
+  };
+
+  adaptive_policy();
+  explicit adaptive_policy(const adaptive_policy_options& options);
+
+  /**
+   * @brief Choose algorithm and level for input
+   */
+  adaptive_decision choose(gsl::span<const unsigned char> input) noexcept;
+
+  /**
+   * @brief Report the result of a decision made by choose()
+   * @param cpu_time_ns CPU time of compression in nanoseconds
+   */
+  void report(const adaptive_decision& decision, size_t input_size, size_t output_size, uint64_t cpu_time_ns) noexcept;
+
+  /**
+   * @brief choose(), compress and report()
+   * @param output Compressed data, cleared when decision.skip is true and the caller should send input as is
+   * @param decision Decision made for input, skip is also set when the result saves less than min_saving_ratio
+   * @return 0 on success, or error code
+   */
+  int compress(gsl::span<const unsigned char> input, std::vector<unsigned char>& output,
+               adaptive_decision& decision) noexcept;
+
+  const std::vector<adaptive_candidate>& get_candidates() const noexcept;
+
+  const adaptive_policy_options& get_options() const noexcept;
+
+  adaptive_policy_stats get_stats(size_t candidate_index, size_t size_bucket) const noexcept;
+
+  static size_t get_size_bucket(size_t input_size) noexcept;
+
+ private:
+  struct bucket_state {
+    uint32_t decision_count;
+    uint32_t explore_cursor;
+  };
+
+  adaptive_policy_options options_;
+  mutable lock::spin_lock lock_;
+  std::vector<adaptive_policy_stats> stats_;  // candidates * kSizeBucketCount
+  bucket_state buckets_[kSizeBucketCount];
+};
+
 }  // namespace compression
 ATFRAMEWORK_UTILS_NAMESPACE_END
 
@@ -1,7 +1,7 @@
 // Copyright 2026 atframework
 //
 // @file crc.h
-// @brief mapping方法实现的crc16/crc32/crc64算法
+// @brief mapping方法实现的crc16/crc32/crc32c/crc64算法
 // Licensed under the MIT licenses.
 //
 // @version 1.0
@@ -9,6 +9,11 @@
 // @date 2017.11.30
 //
 // @history
+//   2026-10-19: 增加 slice-by-8/16 查表、PCLMULQDQ(crc32/crc64) 和 SSE4.2(crc32c) 硬件加速，运行时按CPU选择实现
+//               增加 crc32c 和 *_combine 接口
+//
+// @note 所有接口都不做初始值取反和结果异或，init_val 和返回值都是CRC寄存器的原始值。
+//       例如标准的 CRC-32 需要 crc32(s, l, 0xFFFFFFFF) ^ 0xFFFFFFFF
 
 #ifndef UTIL_ALGORITHM_CRC_H
 #define UTIL_ALGORITHM_CRC_H
@@ -27,6 +32,17 @@
 #include <config/atframe_utils_build_feature.h>
 
 ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+/**
+ * @brief CRC计算引擎，kAuto 时根据CPU和数据长度自动选择
+ */
+enum class crc_engine_t : uint8_t {
+  kAuto = 0,
+  kByteTable = 1,  // 每次处理1字节
+  kSlice8 = 2,     // 每次处理8字节
+  kSlice16 = 3,    // 每次处理16字节，crc16 使用 slice-by-8
+  kHardware = 4,   // crc32/crc64: PCLMULQDQ，crc32c: SSE4.2，不支持时使用 kSlice16
+};
+
 /**
  * @brief          Calculate crc32
  *
@@ -50,15 +66,62 @@ ATFRAMEWORK_UTILS_API uint16_t crc16(const unsigned char *s, size_t l, uint16_t
 ATFRAMEWORK_UTILS_API uint32_t crc32(const unsigned char *s, size_t l, uint32_t init_val = 0);
 
 /**
- * @brief          Calculate crc32
+ * @brief          Calculate crc32c(Castagnoli)
  *
  * @param init_val initialize value
  * @param s        buffer address
  * @param l        buffer length
  *
- * @return         crc32 result
+ * @return         crc32c result
+ */
+ATFRAMEWORK_UTILS_API uint32_t crc32c(const unsigned char *s, size_t l, uint32_t init_val = 0);
+
+/**
+ * @brief          Calculate crc64
+ *
+ * @param init_val initialize value
+ * @param s        buffer address
+ * @param l        buffer length
+ *
+ * @return         crc64 result
  */
 ATFRAMEWORK_UTILS_API uint64_t crc64(const unsigned char *s, size_t l, uint64_t init_val = 0);
+
+/**
+ * @brief          Calculate crc with specify engine, mainly for benchmark and test
+ * @note           Unavailable engine fallback to kSlice16
+ */
+ATFRAMEWORK_UTILS_API uint16_t crc16_with_engine(crc_engine_t engine, const unsigned char *s, size_t l,
+                                                 uint16_t init_val = 0);
+ATFRAMEWORK_UTILS_API uint32_t crc32_with_engine(crc_engine_t engine, const unsigned char *s, size_t l,
+                                                 uint32_t init_val = 0);
+ATFRAMEWORK_UTILS_API uint32_t crc32c_with_engine(crc_engine_t engine, const unsigned char *s, size_t l,
+                                                  uint32_t init_val = 0);
+ATFRAMEWORK_UTILS_API uint64_t crc64_with_engine(crc_engine_t engine, const unsigned char *s, size_t l,
+                                                 uint64_t init_val = 0);
+
+/**
+ * @brief          Check if hardware engine is available on current CPU
+ */
+ATFRAMEWORK_UTILS_API bool crc32_has_hardware_engine();
+ATFRAMEWORK_UTILS_API bool crc32c_has_hardware_engine();
+ATFRAMEWORK_UTILS_API bool crc64_has_hardware_engine();
+
+/**
+ * @brief          Combine crc of two adjacent blocks, crc(A + B) = combine(crc(A), crc(B), len(B))
+ * @note           Can be used to calculate crc of chunks in parallel
+ *
+ * @param crc1     crc of first block, calculated with init_val
+ * @param crc2     crc of second block, calculated with the same init_val
+ * @param len2     length of second block
+ * @param init_val initialize value used by both crc1 and crc2
+ *
+ * @return         crc of the concatenated block, the same as calculate directly with init_val
+ */
+ATFRAMEWORK_UTILS_API uint16_t crc16_combine(uint16_t crc1, uint16_t crc2, size_t len2, uint16_t init_val = 0);
+ATFRAMEWORK_UTILS_API uint32_t crc32_combine(uint32_t crc1, uint32_t crc2, size_t len2, uint32_t init_val = 0);
+ATFRAMEWORK_UTILS_API uint32_t crc32c_combine(uint32_t crc1, uint32_t crc2, size_t len2, uint32_t init_val = 0);
+ATFRAMEWORK_UTILS_API uint64_t crc64_combine(uint64_t crc1, uint64_t crc2, size_t len2, uint64_t init_val = 0);
 ATFRAMEWORK_UTILS_NAMESPACE_END
 
 #endif
\ No newline at end of file
@@ -279,6 +279,37 @@ class cipher {
   ATFRAMEWORK_UTILS_API int decrypt_aead(const unsigned char *input, size_t ilen, unsigned char *output, size_t *olen,
                                          const unsigned char *ad, size_t ad_len);
 
+  /**
+   * @brief               packet descriptor of batched AEAD API, all buffers are owned by caller
+   * @note                data is encrypted or decrypted in place, tag is written by encrypt and read by decrypt
+   */
+  struct aead_packet_t {
+    gsl::span<unsigned char> data;      // plaintext(encrypt) or ciphertext(decrypt), processed in place
+    gsl::span<unsigned char> tag;       // tag buffer, size must not be less than get_tag_size()
+    gsl::span<const unsigned char> ad;  // additional data to authenticate, can be empty
+  };
+
+  /**
+   * @brief               encrypt many packets in place with one backend context
+   * @note                nonce of packets[i] is current iv + i (big-endian counter), which is the same as calling
+   *                      encrypt_aead() for each packet with IV_ROLL_AEAD_INC1_BE. The iv is rolled once for the
+   *                      whole batch after success.
+   * @param packets       packets to encrypt
+   * @param processed     optional, will be filled with the number of packets successfully encrypted
+   * @return              0 or error code, packets after the failed one are not touched
+   */
+  ATFRAMEWORK_UTILS_API int encrypt_aead_batch(gsl::span<aead_packet_t> packets, size_t *processed = nullptr);
+
+  /**
+   * @brief               decrypt many packets in place with one backend context
+   * @note                nonce of packets[i] is current iv + i (big-endian counter), see encrypt_aead_batch()
+   * @param packets       packets to decrypt
+   * @param processed     optional, will be filled with the number of packets successfully decrypted, the data of
+   *                      the failed packet is undefined
+   * @return              0 or error code, packets after the failed one are not touched
+   */
+  ATFRAMEWORK_UTILS_API int decrypt_aead_batch(gsl::span<aead_packet_t> packets, size_t *processed = nullptr);
+
  public:
   static ATFRAMEWORK_UTILS_API const cipher_kt_t *get_cipher_by_name(const char *name);
   /**
@@ -296,6 +327,7 @@ class cipher {
  private:
   int init_with_cipher(const cipher_interface_info_t *, int32_t mode);
   int close_with_cipher();
+  int aead_batch(gsl::span<aead_packet_t> packets, bool is_encrypt, size_t *processed);
 
  private:
   const cipher_interface_info_t *interface_;
@@ -21,7 +21,9 @@
 
 #ifdef CRYPTO_DH_ENABLED
 
+#  include <cstddef>
 #  include <cstdint>
+#  include <functional>
 #  include <memory>
 #  include <string>
 #  include <vector>
@@ -32,10 +34,15 @@
 // Declaring these here lets us avoid pulling <openssl/bn.h> into the public header.
 extern "C" {
 struct bignum_st;
+struct evp_pkey_st;
 }
 #  endif
 
 ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace thread {
+class work_stealing_pool;
+}
+
 namespace crypto {
 
 /**
@@ -102,10 +109,18 @@ class dh {
   // public header does not depend on OpenSSL/mbedtls headers.
   struct dh_context_t;
 
-  class shared_context {
+  struct key_pool_stats_t {
+    size_t cached_count;       // key pairs in pool now
+    uint64_t hit_count;        // key pairs taken from pool
+    uint64_t miss_count;       // key pairs generated inline because the pool is empty
+    uint64_t generated_count;  // key pairs generated by refill
+  };
+
+  class shared_context : public std::enable_shared_from_this<shared_context> {
    public:
     struct dh_param_t;
     struct random_engine_t;
+    struct key_pool_t;
 
     using ptr_t = std::shared_ptr<shared_context>;
 
@@ -149,6 +164,28 @@ class dh {
 
     ATFRAMEWORK_UTILS_API method_t get_method() const;
 
+    /**
+     * @brief enable pre-generated key pair pool, used by make_params(server mode) and read_params(client mode)
+     * @param low_watermark   refill is started when the number of cached key pairs is less than this value
+     * @param high_watermark  refill until the number of cached key pairs reach this value, 0 to disable the pool
+     * @param worker          worker pool to run refill in background, or nullptr to refill only by refill_key_pool()
+     * @note worker must outlive this shared context or be unset by calling set_key_pool(0, 0, nullptr)
+     * @note all cached key pairs are dropped when the parameters or curve is changed
+     * @note only openssl/libressl/boringssl support key pool now
+     * @return error_code_t::kOk or error code
+     */
+    ATFRAMEWORK_UTILS_API error_code_t set_key_pool(size_t low_watermark, size_t high_watermark,
+                                                    thread::work_stealing_pool *worker = nullptr);
+
+    /**
+     * @brief generate key pairs in current thread until the pool reach the high watermark
+     * @param max_count max number of key pairs to generate, 0 means no limit
+     * @return number of generated key pairs
+     */
+    ATFRAMEWORK_UTILS_API size_t refill_key_pool(size_t max_count = 0);
+
+    ATFRAMEWORK_UTILS_API key_pool_stats_t get_key_pool_stats() const;
+
    private:
     friend class dh;
 
@@ -168,14 +205,25 @@ class dh {
      * @note DH_p and DH_g will be set to nullptr when moved in, user must free them if they are still not nullptr
      */
     ATFRAMEWORK_UTILS_API error_code_t try_reset_dh_params(struct bignum_st *&DH_p, struct bignum_st *&DH_g);
+
+    /**
+     * @brief take a key pair from pool, or generate one inline if pool is empty
+     * @param output key pair, caller must free it
+     * @return error_code_t::kOk or error code
+     */
+    ATFRAMEWORK_UTILS_API error_code_t acquire_key_pair(struct evp_pkey_st *&output);
+    void schedule_key_pool_refill();
 #  endif
 
     uint32_t flags_;
     method_t method_;
     std::unique_ptr<dh_param_t> dh_param_;
     std::unique_ptr<random_engine_t> random_engine_;
+    std::unique_ptr<key_pool_t> key_pool_;
   };
 
+  using calc_secret_callback_t = std::function<void(dh &, error_code_t, std::vector<unsigned char> &)>;
+
  public:
   ATFRAMEWORK_UTILS_API dh();
   ATFRAMEWORK_UTILS_API ~dh();
@@ -260,6 +308,18 @@ class dh {
    */
   ATFRAMEWORK_UTILS_API error_code_t calc_secret(std::vector<unsigned char> &output);
 
+  /**
+   * @brief          Derive the shared secret on a worker pool
+   *
+   * @param worker   worker pool to run calc_secret()
+   * @param callback called on the worker thread with the result and the shared secret
+   *
+   * @note           This object must be kept alive and must not be used until the callback is called
+   * @return         error_code_t::kOk if the task is posted, or error code
+   */
+  ATFRAMEWORK_UTILS_API error_code_t calc_secret_async(thread::work_stealing_pool &worker,
+                                                       calc_secret_callback_t callback);
+
  public:
   static ATFRAMEWORK_UTILS_API const std::vector<std::string> &get_all_curve_names();
 
@@ -111,6 +111,22 @@ class hmac {
    */
   ATFRAMEWORK_UTILS_API hmac_error_code_t close();
 
+  /**
+   * @brief Restart HMAC computation with the current key, reusing the allocated context
+   * @note The inner/outer key blocks are not recomputed, cheaper than close() + init()
+   * @return kOk on success, or error code
+   */
+  ATFRAMEWORK_UTILS_API hmac_error_code_t reset();
+
+  /**
+   * @brief Restart HMAC computation with a new key, reusing the allocated context and digest algorithm
+   * @param key Key data
+   * @param key_len Key length in bytes
+   * @return kOk on success, or error code
+   */
+  ATFRAMEWORK_UTILS_API hmac_error_code_t rekey(const unsigned char* key, size_t key_len);
+  ATFRAMEWORK_UTILS_API hmac_error_code_t rekey(gsl::span<const unsigned char> key);
+
   /**
    * @brief Update HMAC with additional data
    * @param input Input data
@@ -140,6 +156,12 @@ class hmac {
    */
   ATFRAMEWORK_UTILS_API bool is_valid() const noexcept;
 
+  /**
+   * @brief Get the digest algorithm of this context
+   * @return Digest algorithm type, kNone if not initialized
+   */
+  ATFRAMEWORK_UTILS_API digest_type_t get_digest_type() const noexcept;
+
   /**
    * @brief Get last error code from underlying crypto library
    * @return Error code
@@ -206,6 +228,27 @@ class hmac {
   static ATFRAMEWORK_UTILS_API std::string compute_to_hex(digest_type_t type, gsl::span<const unsigned char> key,
                                                           gsl::span<const unsigned char> input, bool uppercase = false);
 
+  /**
+   * @brief Compute HMAC of many independent messages with the same key in one call
+   *
+   * The key schedule runs once per batch and each message only restarts the context.
+   * Contexts are cached per thread and digest algorithm, so steady-state calls do not allocate.
+   *
+   * @param type Digest algorithm type
+   * @param key Key data
+   * @param key_len Key length
+   * @param inputs Address of each message
+   * @param input_lengths Length of each message
+   * @param count Number of messages
+   * @param output Output buffer, the HMAC of message i is written to output + i * get_digest_output_length(type)
+   * @param output_len Size of output buffer, must be at least count * get_digest_output_length(type)
+   * @return kOk on success, or error code
+   */
+  static ATFRAMEWORK_UTILS_API hmac_error_code_t compute_batch(digest_type_t type, const unsigned char* key,
+                                                               size_t key_len, const unsigned char* const* inputs,
+                                                               const size_t* input_lengths, size_t count,
+                                                               unsigned char* output, size_t output_len);
+
  private:
   digest_type_t digest_type_;
   int64_t last_errno_;
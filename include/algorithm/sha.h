@@ -4,6 +4,9 @@
 // @brief sha算法适配,如果没有openssl和mbedtls则使用内置的软实现
 // Licensed under the MIT licenses.
 //
+// @note hash_to_* 和 hash_batch 复用线程本地缓存的上下文，不会每次调用都重新分配
+// @note 内置软实现在CPU支持AVX2时，hash_batch 对 SHA-224/SHA-256 使用8路并行的多缓冲区实现
+//
 // @version 1.0
 // @author OWenT
 // @date 2019.12.20
@@ -63,6 +66,12 @@ class sha {
 
   ATFRAMEWORK_UTILS_API bool init(type);
   ATFRAMEWORK_UTILS_API void close();
+
+  /**
+   * @brief 重置为刚 init 完的状态，复用已分配的上下文
+   * @return 未初始化或底层库失败时返回false
+   */
+  ATFRAMEWORK_UTILS_API bool reset();
   ATFRAMEWORK_UTILS_API void swap(sha& other) noexcept;
 
   ATFRAMEWORK_UTILS_API bool update(const unsigned char* in, size_t inlen);
@@ -70,6 +79,8 @@ class sha {
 
   ATFRAMEWORK_UTILS_API size_t get_output_length() const;
 
+  inline type get_type() const noexcept { return hash_type_; }
+
   static ATFRAMEWORK_UTILS_API size_t get_output_length(type bt);
 
   ATFRAMEWORK_UTILS_API const unsigned char* get_output() const;
@@ -87,6 +98,19 @@ class sha {
       ATFRAMEWORK_UTILS_NAMESPACE_ID::base64_mode_t::type bt =
           ATFRAMEWORK_UTILS_NAMESPACE_ID::base64_mode_t::EN_BMT_STANDARD);
 
+  /**
+   * @brief 批量计算多条独立消息的摘要
+   * @param t 算法类型
+   * @param inputs 每条消息的数据地址
+   * @param input_lengths 每条消息的长度
+   * @param count 消息数量
+   * @param outputs 输出缓冲区，第i条消息的摘要写到 outputs + i * get_output_length(t)
+   * @param output_size 输出缓冲区长度，至少为 count * get_output_length(t)
+   * @return 全部成功返回true，参数错误或输出缓冲区不足时返回false
+   */
+  static ATFRAMEWORK_UTILS_API bool hash_batch(type t, const void* const* inputs, const size_t* input_lengths,
+                                               size_t count, unsigned char* outputs, size_t output_size);
+
  private:
   type hash_type_;
   void* private_raw_data_;
@@ -0,0 +1,128 @@
+// Copyright 2026 atframework
+//
+// @file xxh3_hash.h
+// @brief XXH3 64/128位非加密哈希算法
+// Licensed under the MIT licenses.
+//
+// @note 输出和 xxHash v0.8 的 XXH3_64bits_withSeed/XXH3_128bits_withSeed 一致，可以和其他语言的实现互通
+// @note 只依赖64x64->128位乘法和x86_64基础的SSE2指令，不需要AVX2/NEON；长度使用 size_t，支持超过2GB的数据
+// @see https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+
+#ifndef UTIL_HASH_XXH3_HASH_H
+#define UTIL_HASH_XXH3_HASH_H
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <type_traits>
+
+#include <config/atframe_utils_build_feature.h>
+
+#include "nostd/string_view.h"
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace hash {
+
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY xxh3_hash128_t {
+  uint64_t low64;
+  uint64_t high64;
+
+  friend inline bool operator==(const xxh3_hash128_t &l, const xxh3_hash128_t &r) noexcept {
+    return l.low64 == r.low64 && l.high64 == r.high64;
+  }
+
+  friend inline bool operator!=(const xxh3_hash128_t &l, const xxh3_hash128_t &r) noexcept { return !(l == r); }
+};
+
+/**
+ * @brief 计算64位XXH3
+ * @param data 数据
+ * @param len 数据长度
+ * @param seed 种子
+ */
+ATFRAMEWORK_UTILS_API uint64_t xxh3_64(const void *data, size_t len, uint64_t seed = 0) noexcept;
+
+/**
+ * @brief 计算128位XXH3
+ * @param data 数据
+ * @param len 数据长度
+ * @param seed 种子
+ */
+ATFRAMEWORK_UTILS_API xxh3_hash128_t xxh3_128(const void *data, size_t len, uint64_t seed = 0) noexcept;
+
+/**
+ * @brief XXH3流式计算状态
+ * @note 任意分段 update 的结果和一次性计算整段数据相同，digest 之后可以继续 update
+ */
+class ATFRAMEWORK_UTILS_API xxh3_state {
+ public:
+  enum : size_t {
+    SECRET_SIZE = 192,
+    BUFFER_SIZE = 256,
+    ACCUMULATOR_COUNT = 8,
+  };
+
+  explicit xxh3_state(uint64_t seed = 0) noexcept;
+
+  void reset(uint64_t seed = 0) noexcept;
+
+  void update(const void *data, size_t len) noexcept;
+
+  uint64_t digest64() const noexcept;
+
+  xxh3_hash128_t digest128() const noexcept;
+
+  inline uint64_t get_seed() const noexcept { return seed_; }
+
+  inline uint64_t get_total_length() const noexcept { return total_len_; }
+
+ private:
+  void digest_long(uint64_t *acc) const noexcept;
+
+ private:
+  uint64_t acc_[ACCUMULATOR_COUNT];
+  unsigned char secret_[SECRET_SIZE];
+  unsigned char buffer_[BUFFER_SIZE];
+  size_t buffered_size_;
+  size_t stripes_so_far_;
+  uint64_t total_len_;
+  uint64_t seed_;
+};
+
+/**
+ * @brief 兼容 std::hash 的哈希适配器，可用于 unordered_map、lru_map 等容器
+ * @note 支持整数、枚举、指针、std::basic_string 和 nostd::basic_string_view
+ */
+template <class T, class = void>
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY xxh3_hasher;
+
+template <class T>
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY
+xxh3_hasher<T, typename ::std::enable_if<::std::is_integral<T>::value || ::std::is_enum<T>::value ||
+                                         ::std::is_pointer<T>::value>::type> {
+  inline size_t operator()(const T &value) const noexcept {
+    return static_cast<size_t>(xxh3_64(&value, sizeof(value)));
+  }
+};
+
+template <class CharT, class Traits, class Allocator>
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY xxh3_hasher<::std::basic_string<CharT, Traits, Allocator>> {
+  inline size_t operator()(const ::std::basic_string<CharT, Traits, Allocator> &value) const noexcept {
+    return static_cast<size_t>(xxh3_64(value.data(), value.size() * sizeof(CharT)));
+  }
+};
+
+template <class CharT, class Traits>
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY xxh3_hasher<nostd::basic_string_view<CharT, Traits>> {
+  inline size_t operator()(const nostd::basic_string_view<CharT, Traits> &value) const noexcept {
+    return static_cast<size_t>(xxh3_64(value.data(), value.size() * sizeof(CharT)));
+  }
+};
+
+}  // namespace hash
+ATFRAMEWORK_UTILS_NAMESPACE_END
+
+#endif
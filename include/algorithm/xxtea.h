@@ -79,6 +79,28 @@ ATFRAMEWORK_UTILS_API void xxtea_decrypt(const xxtea_key *key, void *buffer, siz
  */
 ATFRAMEWORK_UTILS_API void xxtea_decrypt(const xxtea_key *key, const void *input, size_t ilen, void *output,
                                          size_t *olen);
+
+/**
+ * @brief encrypt many independent buffers use xxtea, result is the same as calling xxtea_encrypt on each buffer
+ * @param key           xxtea key, should be initialized by xxtea_setup
+ * @param buffers       buffer addresses
+ * @param lens          buffer sizes, every size must padding to uint32_t, can not be greater than 2^34
+ * @param count         number of buffers
+ * @note buffers with the same length are processed together in 4(SSE2) or 8(AVX2) SIMD lanes when available
+ */
+ATFRAMEWORK_UTILS_API void xxtea_encrypt_multi(const xxtea_key *key, void *const *buffers, const size_t *lens,
+                                               size_t count);
+
+/**
+ * @brief decrypt many independent buffers use xxtea, result is the same as calling xxtea_decrypt on each buffer
+ * @param key           xxtea key, should be initialized by xxtea_setup
+ * @param buffers       buffer addresses
+ * @param lens          buffer sizes, every size must padding to uint32_t, can not be greater than 2^34
+ * @param count         number of buffers
+ * @note buffers with the same length are processed together in 4(SSE2) or 8(AVX2) SIMD lanes when available
+ */
+ATFRAMEWORK_UTILS_API void xxtea_decrypt_multi(const xxtea_key *key, void *const *buffers, const size_t *lens,
+                                               size_t count);
 ATFRAMEWORK_UTILS_NAMESPACE_END
 
 #endif
\ No newline at end of file
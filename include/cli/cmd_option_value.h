@@ -50,42 +50,60 @@ struct string2any<unsigned char> {
 template <>
 struct string2any<int16_t> {
   UTIL_FORCEINLINE int16_t operator()(const std::string &s) const {
-    return ATFRAMEWORK_UTILS_NAMESPACE_ID::string::to_int<int16_t>(s.c_str());
+    return ATFRAMEWORK_UTILS_NAMESPACE_ID::string::to_int<int16_t>(s);
   }
 };
 
 template <>
 struct string2any<uint16_t> {
   UTIL_FORCEINLINE uint16_t operator()(const std::string &s) const {
-    return ATFRAMEWORK_UTILS_NAMESPACE_ID::string::to_int<uint16_t>(s.c_str());
+    return ATFRAMEWORK_UTILS_NAMESPACE_ID::string::to_int<uint16_t>(s);
   }
 };
 
 template <>
 struct string2any<int32_t> {
   UTIL_FORCEINLINE int32_t operator()(const std::string &s) const {
-    return ATFRAMEWORK_UTILS_NAMESPACE_ID::string::to_int<int32_t>(s.c_str());
+    return ATFRAMEWORK_UTILS_NAMESPACE_ID::string::to_int<int32_t>(s);
   }
 };
 
 template <>
 struct string2any<uint32_t> {
   UTIL_FORCEINLINE uint32_t operator()(const std::string &s) const {
-    return ATFRAMEWORK_UTILS_NAMESPACE_ID::string::to_int<uint32_t>(s.c_str());
+    return ATFRAMEWORK_UTILS_NAMESPACE_ID::string::to_int<uint32_t>(s);
   }
 };
 
 template <>
 struct string2any<int64_t> {
   UTIL_FORCEINLINE int64_t operator()(const std::string &s) const {
-    return ATFRAMEWORK_UTILS_NAMESPACE_ID::string::to_int<int64_t>(s.c_str());
+    return ATFRAMEWORK_UTILS_NAMESPACE_ID::string::to_int<int64_t>(s);
   }
 };
 
 template <>
 struct string2any<uint64_t> {
   UTIL_FORCEINLINE uint64_t operator()(const std::string &s) const {
-    return ATFRAMEWORK_UTILS_NAMESPACE_ID::string::to_int<uint64_t>(s.c_str());
+    return ATFRAMEWORK_UTILS_NAMESPACE_ID::string::to_int<uint64_t>(s);
+  }
+};
+
+template <>
+struct string2any<double> {
+  UTIL_FORCEINLINE double operator()(const std::string &s) const {
+    double ret;
+    ATFRAMEWORK_UTILS_NAMESPACE_ID::string::str2float(ret, s);
+    return ret;
+  }
+};
+
+template <>
+struct string2any<float> {
+  UTIL_FORCEINLINE float operator()(const std::string &s) const {
+    float ret;
+    ATFRAMEWORK_UTILS_NAMESPACE_ID::string::str2float(ret, s);
+    return ret;
   }
 };
 
@@ -0,0 +1,71 @@
+// Copyright 2026 atframework
+//
+// @file cpu_features.h
+// @brief 运行时CPU指令集检测
+// Licensed under the MIT licenses.
+//
+// @note 用于SIMD实现的运行时分派。使用 ATFW_UTIL_MACRO_TARGET_ATTRIBUTE 标记的函数可以在未开启对应编译选项时使用指令集，
+//       调用前必须先通过 get_cpu_features() 确认CPU支持。
+
+#pragma once
+
+#include <config/atframe_utils_build_feature.h>
+
+#include <cstdint>
+
+#if !defined(ATFW_UTIL_MACRO_ARCH_X86)
+#  if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#    if !defined(_M_ARM64EC)
+#      define ATFW_UTIL_MACRO_ARCH_X86 1
+#    endif
+#  endif
+#endif
+
+#if !defined(ATFW_UTIL_MACRO_ARCH_X86_64)
+#  if defined(__x86_64__) || (defined(_M_X64) && !defined(_M_ARM64EC))
+#    define ATFW_UTIL_MACRO_ARCH_X86_64 1
+#  endif
+#endif
+
+// 给单个函数开启指令集，MSVC不需要
+#ifndef ATFW_UTIL_MACRO_TARGET_ATTRIBUTE
+#  if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5)
+#    define ATFW_UTIL_MACRO_TARGET_ATTRIBUTE(...) __attribute__((target(__VA_ARGS__)))
+#  else
+#    define ATFW_UTIL_MACRO_TARGET_ATTRIBUTE(...)
+#  endif
+#endif
+
+// 是否可以编译带运行时分派的x86 SIMD实现
+#ifndef ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH
+#  if defined(ATFW_UTIL_MACRO_ARCH_X86) && \
+      (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5) || (defined(_MSC_VER) && _MSC_VER >= 1900))
+#    define ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH 1
+#  endif
+#endif
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace platform {
+
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY cpu_features {
+  bool has_sse2;
+  bool has_ssse3;
+  bool has_sse41;
+  bool has_sse42;
+  bool has_pclmulqdq;
+  bool has_aesni;
+  bool has_popcnt;
+  bool has_avx;
+  bool has_avx2;
+  bool has_bmi1;
+  bool has_bmi2;
+};
+
+/**
+ * @brief 获取当前CPU支持的指令集，首次调用时检测
+ * @note AVX/AVX2 同时检查了操作系统是否保存YMM寄存器
+ */
+ATFRAMEWORK_UTILS_API const cpu_features& get_cpu_features() noexcept;
+
+}  // namespace platform
+ATFRAMEWORK_UTILS_NAMESPACE_END
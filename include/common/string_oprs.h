@@ -18,6 +18,7 @@
 
 #include <config/atframe_utils_build_feature.h>
 
+#include <algorithm/bit.h>
 #include <gsl/select-gsl.h>
 #include <nostd/string_view.h>
 
@@ -27,6 +28,7 @@
 #include <cctype>
 #include <cstdlib>
 #include <cstring>
+#include <limits>
 #include <memory>
 #include <ostream>
 #include <string>
@@ -166,6 +168,61 @@ ATFRAMEWORK_UTILS_API_HEAD_ONLY std::pair<const TCH *, size_t> trim(const TCH *s
 ATFRAMEWORK_UTILS_API gsl::string_view trim_string(gsl::string_view input, bool trim_left = true,
                                                    bool trim_right = true);
 
+/**
+ * @brief 批量把ASCII大写字母转为小写，其他字节原样输出
+ * @param out 输出缓冲区，长度至少为sz，可以和in相同(原地转换)，但不能部分重叠
+ * @param in 输入
+ * @param sz 长度
+ * @note 支持时使用SSE2/AVX2每次处理16/32字节
+ */
+ATFRAMEWORK_UTILS_API void ascii_tolower(char *out, const char *in, size_t sz) noexcept;
+
+/**
+ * @brief 批量把ASCII小写字母转为大写，参数同 ascii_tolower
+ */
+ATFRAMEWORK_UTILS_API void ascii_toupper(char *out, const char *in, size_t sz) noexcept;
+
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline void ascii_tolower(std::string &str) noexcept {
+  if (!str.empty()) {
+    ascii_tolower(&str[0], str.data(), str.size());
+  }
+}
+
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline void ascii_toupper(std::string &str) noexcept {
+  if (!str.empty()) {
+    ascii_toupper(&str[0], str.data(), str.size());
+  }
+}
+
+/**
+ * @brief 忽略ASCII大小写比较是否相等
+ * @note 非ASCII字节按原值比较
+ */
+ATFRAMEWORK_UTILS_API bool ascii_iequals(nostd::string_view l, nostd::string_view r) noexcept;
+
+/**
+ * @brief 忽略ASCII大小写查找子串
+ * @param haystack 被查找的字符串
+ * @param needle 要查找的子串
+ * @param pos 开始查找的位置
+ * @return 找到时返回子串位置，否则返回 nostd::string_view::npos
+ * @note 支持时先用SIMD同时匹配子串的首尾字符过滤候选位置，再比较中间部分
+ */
+ATFRAMEWORK_UTILS_API size_t ascii_ifind(nostd::string_view haystack, nostd::string_view needle,
+                                         size_t pos = 0) noexcept;
+
+/**
+ * @brief 按多个分隔符切分字符串，不分配内存
+ * @param input 输入
+ * @param delimiters 分隔符集合，其中任意一个字符都是分隔符
+ * @param output 输出的子串，和input共享地址
+ * @param skip_empty 是否跳过空子串(连续的分隔符以及首尾的分隔符)
+ * @return 子串总数，大于 output.size() 时只输出前 output.size() 个
+ * @note 分隔符不超过16个时使用SIMD批量查找，否则使用查表
+ */
+ATFRAMEWORK_UTILS_API size_t split(nostd::string_view input, nostd::string_view delimiters,
+                                   gsl::span<nostd::string_view> output, bool skip_empty = true) noexcept;
+
 /**
  * @brief 翻转字符串
  * @param begin 字符串起始地址
@@ -208,30 +265,58 @@ ATFRAMEWORK_UTILS_API_HEAD_ONLY inline void reverse(TCH *begin, std::nullptr_t)
   reverse<TCH, TCH *>(begin, static_cast<TCH *>(nullptr));
 }
 
+/**
+ * @brief 00-99的两位数字表，整数转字符串时每次处理两位
+ */
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline const char *int2str_digits_table() noexcept {
+  static const char digits[] =
+      "00010203040506070809"
+      "10111213141516171819"
+      "20212223242526272829"
+      "30313233343536373839"
+      "40414243444546474849"
+      "50515253545556575859"
+      "60616263646566676869"
+      "70717273747576777879"
+      "80818283848586878889"
+      "90919293949596979899";
+  return digits;
+}
+
 template <class T>
 ATFRAMEWORK_UTILS_API_HEAD_ONLY size_t int2str_unsigned(char *str, size_t strsz, T in) {
   if (0 == strsz) {
     return 0;
   }
 
-  if (0 == in) {
-    *str = '0';
-    return 1;
+  // 先从后往前写到栈上，长度足够时再复制，不需要reverse
+  char buffer[std::numeric_limits<T>::digits10 + 2];
+  char *end = buffer + sizeof(buffer);
+  char *cur = end;
+  const char *digits = int2str_digits_table();
+  while (in >= 100) {
+    size_t index = static_cast<size_t>(in % 100) * 2;
+    in = static_cast<T>(in / 100);
+    cur -= 2;
+    cur[0] = digits[index];
+    cur[1] = digits[index + 1];
   }
 
-  size_t ret = 0;
-  while (ret < strsz && in > 0) {
-    str[ret] = static_cast<char>((in % 10) + '0');
-
-    in /= 10;
-    ++ret;
+  if (in >= 10) {
+    size_t index = static_cast<size_t>(in) * 2;
+    cur -= 2;
+    cur[0] = digits[index];
+    cur[1] = digits[index + 1];
+  } else {
+    *(--cur) = static_cast<char>('0' + static_cast<char>(in));
   }
 
-  if (in > 0 && ret >= strsz) {
+  size_t ret = static_cast<size_t>(end - cur);
+  if (ret > strsz) {
     return 0;
   }
 
-  reverse(str, str + ret);
+  memcpy(str, cur, ret);
   return ret;
 }
 
@@ -243,7 +328,8 @@ ATFRAMEWORK_UTILS_API_HEAD_ONLY size_t int2str_signed(char *str, size_t strsz, T
 
   if (in < 0) {
     *str = '-';
-    size_t ret = int2str_unsigned(str + 1, strsz - 1, static_cast<typename std::make_unsigned<T>::type>(-in));
+    using unsigned_type = typename std::make_unsigned<T>::type;
+    size_t ret = int2str_unsigned(str + 1, strsz - 1, static_cast<unsigned_type>(0 - static_cast<unsigned_type>(in)));
     if (0 == ret) {
       return 0;
     }
@@ -281,6 +367,36 @@ ATFRAMEWORK_UTILS_API_HEAD_ONLY inline size_t int2str(char *str, size_t strsz, c
   return ret;
 }
 
+/**
+ * @brief 检查接下来的8个字符是否都是十进制数字，是则解析出数值
+ * @note SWAR方式，一次处理8个字符，调用者需要保证str后至少有8个字符可读
+ */
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool str2int_parse_eight_digits(uint64_t &out, const char *str) noexcept {
+  uint64_t val;
+#if defined(ATFW_UTIL_ENDIAN_COMPILETIME_LITTLE)
+  memcpy(&val, str, sizeof(val));
+#else
+  val = 0;
+  for (int i = 0; i < 8; ++i) {
+    val |= static_cast<uint64_t>(static_cast<unsigned char>(str[i])) << (i * 8);
+  }
+#endif
+
+  // 任意字节小于'0'或者大于'9'时对应字节的最高位为1
+  if (0 != (((val + 0x4646464646464646ULL) | (val - 0x3030303030303030ULL)) & 0x8080808080808080ULL)) {
+    return false;
+  }
+
+  // 相邻的数字两两合并，再四四合并，最后合并为8位
+  val -= 0x3030303030303030ULL;
+  val = (val * 10) + (val >> 8);
+  val = (((val & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+         (((val >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >>
+        32;
+  out = static_cast<uint32_t>(val);
+  return true;
+}
+
 /**
  * @brief 字符串转整数
  * @param out 输出的整数
@@ -330,6 +446,15 @@ ATFRAMEWORK_UTILS_API_HEAD_ONLY const TCHAR *str2int(T &out, const TCHAR *str, s
       out = static_cast<T>(out + static_cast<T>(str[cur] - static_cast<char>('0')));
     }
   } else {  // dec
+    // 已知长度时每次解析8位，最后不足8位的部分逐个字符处理
+    if (sizeof(TCHAR) == 1 && sizeof(T) <= sizeof(uint64_t) && 0 != strsz) {
+      uint64_t eight_digits = 0;
+      while (cur + 8 <= strsz && str2int_parse_eight_digits(eight_digits, reinterpret_cast<const char *>(str + cur))) {
+        out = static_cast<T>(static_cast<uint64_t>(out) * 100000000ULL + eight_digits);
+        cur += 8;
+      }
+    }
+
     for (; (0 == strsz || cur < strsz) && (str[cur] >= '0' && str[cur] <= '9'); ++cur) {
       out = static_cast<T>(out * 10);
       out = static_cast<T>(out + static_cast<T>(str[cur] - static_cast<char>('0')));
@@ -372,6 +497,39 @@ ATFRAMEWORK_UTILS_API_HEAD_ONLY inline T to_int(TINPUT &&input) {
   return ret;
 }
 
+/**
+ * @brief 浮点数转字符串，输出能还原出相同数值的最短表示
+ * @param str 输出的字符串缓冲区
+ * @param strsz 字符串缓冲区长度
+ * @param in 输入的数字
+ * @return 返回输出的数据长度，失败返回0
+ * @note 支持 <charconv> 浮点转换时使用 std::to_chars (Ryu系算法)，否则逐步增加 snprintf 的精度直到能还原
+ */
+ATFRAMEWORK_UTILS_API size_t float2str(char *str, size_t strsz, double in) noexcept;
+
+ATFRAMEWORK_UTILS_API size_t float2str(char *str, size_t strsz, float in) noexcept;
+
+/**
+ * @brief 字符串转浮点数
+ * @param out 输出的浮点数，无法解析时为0
+ * @param str 被转换的字符串
+ * @param strsz 字符串长度，为0时表示以0结尾
+ * @return 解析结束的位置，无法解析时返回str
+ * @note 支持 <charconv> 浮点转换时使用 std::from_chars (fast_float系算法)，否则使用 strtod/strtof
+ */
+ATFRAMEWORK_UTILS_API const char *str2float(double &out, const char *str, size_t strsz = 0) noexcept;
+
+ATFRAMEWORK_UTILS_API const char *str2float(float &out, const char *str, size_t strsz = 0) noexcept;
+
+template <class T>
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline const char *str2float(T &out, nostd::string_view str) noexcept {
+  if (str.empty()) {
+    out = static_cast<T>(0);
+    return str.data();
+  }
+  return str2float(out, str.data(), str.size());
+}
+
 /**
  * @brief 字符转十六进制表示
  * @param out 输出的字符串(缓冲区长度至少为2)
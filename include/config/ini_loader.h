@@ -162,6 +162,16 @@ class ini_value : public std::enable_shared_from_this<ini_value> {
     UTIL_FORCEINLINE static uint64_t convert(const ini_value &val, size_t index) { return val.as_uint64(index); }
   };
 
+  template <typename _TVOID>
+  struct ATFRAMEWORK_UTILS_API_HEAD_ONLY as_helper<double, _TVOID> {
+    UTIL_FORCEINLINE static double convert(const ini_value &val, size_t index) { return val.as_double(index); }
+  };
+
+  template <typename _TVOID>
+  struct ATFRAMEWORK_UTILS_API_HEAD_ONLY as_helper<float, _TVOID> {
+    UTIL_FORCEINLINE static float convert(const ini_value &val, size_t index) { return val.as_float(index); }
+  };
+
   template <typename _TVOID>
   struct ATFRAMEWORK_UTILS_API_HEAD_ONLY as_helper<const char *, _TVOID> {
     UTIL_FORCEINLINE static const char *convert(const ini_value &val, size_t index) { return val.as_string(index); }
@@ -0,0 +1,131 @@
+// Copyright 2026 atframework
+//
+// @file http_request_awaitable.h
+// @brief 等待 http_request 完成的协程适配
+// Licensed under the MIT licenses.
+//
+// @note co_await wait_http_request(req, method) 启动请求并在 on_complete 时恢复协程，原有的 on_complete 回调仍会被调用。
+// @note 结果为 result_type<int, int>，成功时为HTTP响应码，失败时为 curl 错误码或 start() 的返回值。
+
+#ifndef UTIL_COROUTINE_HTTP_REQUEST_AWAITABLE_H
+#define UTIL_COROUTINE_HTTP_REQUEST_AWAITABLE_H
+
+#pragma once
+
+#include "coroutine/task.h"
+
+#include "network/http_request.h"
+
+#if defined(ATFW_UTIL_MACRO_ENABLE_COROUTINE) && ATFW_UTIL_MACRO_ENABLE_COROUTINE && \
+    defined(ATFRAMEWORK_UTILS_NETWORK_EVPOLL_ENABLE_LIBUV) && defined(ATFRAMEWORK_UTILS_NETWORK_ENABLE_CURL)
+#  if ATFRAMEWORK_UTILS_NETWORK_ENABLE_CURL && ATFRAMEWORK_UTILS_NETWORK_EVPOLL_ENABLE_LIBUV
+
+#    include <memory>
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace coroutine {
+
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY http_request_awaitable {
+ public:
+  using result_type = design_pattern::result_type<int, int>;
+
+ private:
+  // 状态通过共享对象和协程帧解耦，协程帧销毁后回调仍然可以安全执行
+  struct wait_state {
+    ::std::coroutine_handle<> handle;
+    bool completed = false;
+  };
+
+ public:
+  http_request_awaitable(network::http_request::ptr_t request, network::http_request::method_t::type method) noexcept
+      : request_(std::move(request)), method_(method), start_result_(0) {}
+
+  http_request_awaitable(const http_request_awaitable&) = delete;
+  http_request_awaitable& operator=(const http_request_awaitable&) = delete;
+
+  ~http_request_awaitable() {
+    // 协程帧被销毁时请求可能还在进行，回调不再恢复协程
+    if (state_) {
+      state_->handle = nullptr;
+    }
+  }
+
+  inline bool await_ready() const noexcept { return !request_; }
+
+  bool await_suspend(::std::coroutine_handle<> handle) {
+    state_ = ::std::make_shared<wait_state>();
+
+    std::shared_ptr<wait_state> state = state_;
+    network::http_request::on_complete_fn_t previous_fn = request_->get_on_complete();
+    request_->set_on_complete([state, previous_fn](network::http_request& req) -> int {
+      // http_request 执行的是 on_complete 的副本，可以在这里恢复原来的回调，重复等待同一个请求不会层层包装
+      req.set_on_complete(previous_fn);
+
+      int ret = 0;
+      if (previous_fn) {
+        ret = previous_fn(req);
+      }
+
+      state->completed = true;
+      ::std::coroutine_handle<> resume_handle = state->handle;
+      state->handle = nullptr;
+      // 恢复后协程可能已经结束并释放了等待对象，之后只能访问局部变量
+      if (resume_handle) {
+        resume_handle.resume();
+      }
+      return ret;
+    });
+
+    start_result_ = request_->start(method_, false);
+    // 启动失败或者同步完成时不挂起
+    if (0 != start_result_ || state_->completed) {
+      if (!state_->completed) {
+        request_->set_on_complete(std::move(previous_fn));
+      }
+      return false;
+    }
+
+    state_->handle = handle;
+    return true;
+  }
+
+  result_type await_resume() noexcept {
+    if (!request_) {
+      return result_type::make_error(-1);
+    }
+
+    if (0 != start_result_) {
+      return result_type::make_error(start_result_);
+    }
+
+    if (0 != request_->get_error_code()) {
+      return result_type::make_error(request_->get_error_code());
+    }
+
+    return result_type::make_success(request_->get_response_code());
+  }
+
+ private:
+  network::http_request::ptr_t request_;
+  network::http_request::method_t::type method_;
+  int start_result_;
+  std::shared_ptr<wait_state> state_;
+};
+
+/**
+ * @brief 启动请求并等待完成
+ * @note 调用者需要在协程中持有 request 直到 co_await 返回
+ */
+ATFW_UTIL_FORCEINLINE http_request_awaitable wait_http_request(
+    network::http_request::ptr_t request,
+    network::http_request::method_t::type method = network::http_request::method_t::EN_MT_GET) noexcept {
+  return http_request_awaitable(std::move(request), method);
+}
+
+}  // namespace coroutine
+ATFRAMEWORK_UTILS_NAMESPACE_END
+
+#  endif
+#endif
+
+#endif /* UTIL_COROUTINE_HTTP_REQUEST_AWAITABLE_H */
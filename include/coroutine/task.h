@@ -0,0 +1,265 @@
+// Copyright 2026 atframework
+//
+// @file task.h
+// @brief 轻量级C++20协程任务
+// Licensed under the MIT licenses.
+//
+// @note task<TValue, TError> 是惰性启动的协程，结果通过 design_pattern::result_type<TValue, TError> 返回。
+//       co_await 另一个 task 时使用对称转移(symmetric transfer)，多级调用不会增长调用栈。
+// @note 协程帧通过 frame_allocator 按大小分级缓存在线程本地空闲链表中，稳定运行后不再访问全局堆。
+// @note frame_allocator 不依赖C++20，始终编译；task 只在编译器支持协程时可用(ATFW_UTIL_MACRO_ENABLE_COROUTINE)。
+// @note 协程体抛出的异常保存在 promise 中，任务照常结束并恢复等待者，在 co_await 的结果或 take_result() 中重新抛出。
+
+#ifndef UTIL_COROUTINE_TASK_H
+#define UTIL_COROUTINE_TASK_H
+
+#pragma once
+
+#include <config/atframe_utils_build_feature.h>
+#include <config/compile_optimize.h>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <utility>
+
+#if !defined(ATFW_UTIL_MACRO_ENABLE_COROUTINE)
+#  if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L && defined(__has_include)
+#    if __has_include(<coroutine>)
+#      define ATFW_UTIL_MACRO_ENABLE_COROUTINE 1
+#    endif
+#  endif
+#endif
+
+#if defined(ATFW_UTIL_MACRO_ENABLE_COROUTINE) && ATFW_UTIL_MACRO_ENABLE_COROUTINE
+#  include <coroutine>
+
+#  include "design_pattern/result_type.h"
+#endif
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace coroutine {
+
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY frame_allocator_stats {
+  uint64_t allocate_count;      // 分配次数
+  uint64_t cache_hit_count;     // 从线程缓存分配的次数
+  uint64_t cached_block_count;  // 当前线程缓存中的空闲块数量
+};
+
+/**
+ * @brief 协程帧分配器
+ * @note 按 SIZE_CLASS_GRANULARITY 对齐分级，每级在线程本地缓存最多 MAX_CACHED_BLOCKS_PER_CLASS 个空闲块，
+ *       超过 MAX_CACHED_SIZE 的帧直接使用全局堆
+ * @note 可以在一个线程分配、另一个线程释放，释放的块进入释放线程的缓存
+ */
+class ATFRAMEWORK_UTILS_API frame_allocator {
+ public:
+  enum : size_t {
+    SIZE_CLASS_GRANULARITY = 64,
+    MAX_CACHED_SIZE = 2048,
+    SIZE_CLASS_COUNT = MAX_CACHED_SIZE / SIZE_CLASS_GRANULARITY,
+    MAX_CACHED_BLOCKS_PER_CLASS = 64,
+  };
+
+  static void* allocate(size_t size);
+  static void deallocate(void* ptr, size_t size) noexcept;
+
+  /**
+   * @brief 获取当前线程的统计
+   */
+  static frame_allocator_stats get_thread_stats() noexcept;
+
+  /**
+   * @brief 释放当前线程缓存的所有空闲块
+   */
+  static void release_thread_cache() noexcept;
+};
+
+#if defined(ATFW_UTIL_MACRO_ENABLE_COROUTINE) && ATFW_UTIL_MACRO_ENABLE_COROUTINE
+
+template <class TValue, class TError = int32_t>
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY task;
+
+namespace detail {
+template <class TPromise>
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY task_final_awaiter {
+  inline bool await_ready() const noexcept { return false; }
+
+  // 完成时直接转移到等待者，没有等待者时返回调用 resume() 的地方
+  inline ::std::coroutine_handle<> await_suspend(::std::coroutine_handle<TPromise> handle) noexcept {
+    ::std::coroutine_handle<> continuation = handle.promise().continuation;
+    if (continuation) {
+      return continuation;
+    }
+    return ::std::noop_coroutine();
+  }
+
+  inline void await_resume() const noexcept {}
+};
+}  // namespace detail
+
+/**
+ * @brief 协程任务
+ * @note 创建后不会立即执行，被 co_await 或调用 start() 时才开始执行
+ * @note start() 之后仍然可以被 co_await(最多一个等待者)，任务完成时恢复等待者
+ * @note 协程体内使用 co_return result_type::make_success(...) 或 co_return result_type::make_error(...) 返回
+ */
+template <class TValue, class TError>
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY task {
+ public:
+  using value_type = TValue;
+  using error_type = TError;
+  using result_type = design_pattern::result_type<TValue, TError>;
+
+  struct promise_type {
+    result_type result;
+    ::std::coroutine_handle<> continuation;
+    bool started = false;
+#  if defined(ATFRAMEWORK_UTILS_ENABLE_EXCEPTION) && ATFRAMEWORK_UTILS_ENABLE_EXCEPTION
+    ::std::exception_ptr exception;
+#  endif
+
+    static void* operator new(size_t size) { return frame_allocator::allocate(size); }
+    static void operator delete(void* ptr, size_t size) noexcept { frame_allocator::deallocate(ptr, size); }
+
+    inline task get_return_object() noexcept {
+      return task{::std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+
+    inline ::std::suspend_always initial_suspend() const noexcept { return {}; }
+
+    inline detail::task_final_awaiter<promise_type> final_suspend() const noexcept { return {}; }
+
+    inline void return_value(result_type&& value) noexcept { result = std::move(value); }
+
+    // 异常不能直接抛出协程，否则不会执行 final_suspend，等待者永远不会被恢复
+    inline void unhandled_exception() noexcept {
+#  if defined(ATFRAMEWORK_UTILS_ENABLE_EXCEPTION) && ATFRAMEWORK_UTILS_ENABLE_EXCEPTION
+      exception = ::std::current_exception();
+#  else
+      ::std::terminate();
+#  endif
+    }
+
+    inline result_type take_result() {
+#  if defined(ATFRAMEWORK_UTILS_ENABLE_EXCEPTION) && ATFRAMEWORK_UTILS_ENABLE_EXCEPTION
+      if (exception) {
+        ::std::rethrow_exception(::std::exchange(exception, nullptr));
+      }
+#  endif
+      return std::move(result);
+    }
+  };
+
+  using handle_type = ::std::coroutine_handle<promise_type>;
+
+  struct awaiter {
+    handle_type handle;
+
+    inline bool await_ready() const noexcept { return !handle || handle.done(); }
+
+    inline ::std::coroutine_handle<> await_suspend(::std::coroutine_handle<> continuation) noexcept {
+      // 只能有一个等待者
+      assert(!handle.promise().continuation);
+      handle.promise().continuation = continuation;
+      // 已经通过 start() 启动的任务停在自己的挂起点上，不能再恢复它，完成时 final_suspend 会转移回等待者
+      if (handle.promise().started) {
+        return ::std::noop_coroutine();
+      }
+
+      handle.promise().started = true;
+      return handle;
+    }
+
+    /**
+     * @note 协程体抛出的异常在这里重新抛出
+     */
+    inline result_type await_resume() {
+      if (!handle) {
+        return result_type{};
+      }
+      return handle.promise().take_result();
+    }
+  };
+
+ public:
+  task() noexcept : handle_(nullptr) {}
+  explicit task(handle_type handle) noexcept : handle_(handle) {}
+
+  task(task&& other) noexcept : handle_(other.handle_) { other.handle_ = nullptr; }
+
+  task& operator=(task&& other) noexcept {
+    if (this != &other) {
+      reset();
+      handle_ = other.handle_;
+      other.handle_ = nullptr;
+    }
+    return *this;
+  }
+
+  task(const task&) = delete;
+  task& operator=(const task&) = delete;
+
+  ~task() { reset(); }
+
+  inline awaiter operator co_await() && noexcept { return awaiter{handle_}; }
+  inline awaiter operator co_await() & noexcept { return awaiter{handle_}; }
+
+  /**
+   * @brief 作为顶层任务启动，执行到第一个挂起点或结束时返回
+   * @return 是否启动了任务(重复启动返回false)
+   */
+  bool start() {
+    if (!handle_ || handle_.done() || handle_.promise().started) {
+      return false;
+    }
+
+    handle_.promise().started = true;
+    handle_.resume();
+    return true;
+  }
+
+  ATFW_UTIL_FORCEINLINE bool valid() const noexcept { return !!handle_; }
+
+  ATFW_UTIL_FORCEINLINE bool is_done() const noexcept { return handle_ && handle_.done(); }
+
+  /**
+   * @brief 获取结果，未完成或者协程体抛出了异常时返回 is_none() 的结果
+   */
+  ATFW_UTIL_FORCEINLINE const result_type& get_result() const noexcept {
+    static const result_type empty_result;
+    return is_done() ? handle_.promise().result : empty_result;
+  }
+
+  /**
+   * @brief 取出结果，未完成时返回 is_none() 的结果
+   * @note 协程体抛出的异常在这里重新抛出(只抛出一次)
+   */
+  ATFW_UTIL_FORCEINLINE result_type take_result() {
+    if (!is_done()) {
+      return result_type{};
+    }
+    return handle_.promise().take_result();
+  }
+
+  /**
+   * @brief 销毁协程帧，未完成的任务会在当前挂起点被取消(挂起点的 awaitable 负责注销回调)
+   */
+  void reset() noexcept {
+    if (handle_) {
+      handle_.destroy();
+      handle_ = nullptr;
+    }
+  }
+
+ private:
+  handle_type handle_;
+};
+
+#endif
+
+}  // namespace coroutine
+ATFRAMEWORK_UTILS_NAMESPACE_END
+
+#endif /* UTIL_COROUTINE_TASK_H */
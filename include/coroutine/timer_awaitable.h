@@ -0,0 +1,114 @@
+// Copyright 2026 atframework
+//
+// @file timer_awaitable.h
+// @brief 基于 jiffies_timer 的协程等待
+// Licensed under the MIT licenses.
+//
+// @note co_await sleep_for(timer, delta) 在 timer.tick() 推进到超时时恢复协程，恢复发生在调用 tick() 的线程中。
+// @note 挂起期间协程帧被销毁时，会禁用尚未触发的定时器，回调不会访问已销毁的帧。
+
+#ifndef UTIL_COROUTINE_TIMER_AWAITABLE_H
+#define UTIL_COROUTINE_TIMER_AWAITABLE_H
+
+#pragma once
+
+#include "coroutine/task.h"
+
+#if defined(ATFW_UTIL_MACRO_ENABLE_COROUTINE) && ATFW_UTIL_MACRO_ENABLE_COROUTINE
+
+#  include <ctime>
+
+#  include "time/jiffies_timer.h"
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace coroutine {
+
+template <class TTimer>
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY timer_awaitable {
+ public:
+  using timer_manager_type = TTimer;
+  using timer_wptr_t = typename timer_manager_type::timer_wptr_t;
+  using timer_t = typename timer_manager_type::timer_t;
+  using result_type = design_pattern::result_type<time_t, int>;
+
+ public:
+  timer_awaitable(timer_manager_type& timer_manager, time_t delta) noexcept
+      : timer_manager_(&timer_manager), delta_(delta), error_code_(0), fired_tick_(0) {}
+
+  timer_awaitable(const timer_awaitable&) = delete;
+  timer_awaitable& operator=(const timer_awaitable&) = delete;
+
+  ~timer_awaitable() { cancel(); }
+
+  inline bool await_ready() const noexcept { return false; }
+
+  bool await_suspend(::std::coroutine_handle<> handle) {
+    handle_ = handle;
+    error_code_ = timer_manager_->add_timer(
+        delta_,
+        [this](time_t tick, const timer_t&) {
+          fired_tick_ = tick;
+          ::std::coroutine_handle<> resume_handle = handle_;
+          handle_ = nullptr;
+          watcher_.reset();
+          resume_handle.resume();
+        },
+        nullptr, &watcher_);
+
+    // 添加失败时不挂起，由 await_resume 返回错误码
+    if (0 != error_code_) {
+      handle_ = nullptr;
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * @return 成功时为触发时的tick，失败时为 jiffies_timer 的错误码(error_type_t::EN_JTET_*)
+   */
+  inline result_type await_resume() const noexcept {
+    if (0 != error_code_) {
+      return result_type::make_error(error_code_);
+    }
+    return result_type::make_success(fired_tick_);
+  }
+
+ private:
+  void cancel() noexcept {
+    if (!handle_) {
+      return;
+    }
+
+    handle_ = nullptr;
+    auto timer_inst = watcher_.lock();
+    if (timer_inst) {
+      timer_manager_type::set_timer_flags(*timer_inst, timer_manager_type::timer_flag_t::EN_JTTF_DISABLED);
+    }
+    watcher_.reset();
+  }
+
+ private:
+  timer_manager_type* timer_manager_;
+  time_t delta_;
+  int error_code_;
+  time_t fired_tick_;
+  ::std::coroutine_handle<> handle_;
+  timer_wptr_t watcher_;
+};
+
+/**
+ * @brief 等待 delta 个 tick
+ * @note 用法: auto res = co_await atfw::util::coroutine::sleep_for(timer_manager, 3);
+ *       成功时 *res.get_success() 是触发时的tick
+ */
+template <class TTimer>
+ATFRAMEWORK_UTILS_API_HEAD_ONLY timer_awaitable<TTimer> sleep_for(TTimer& timer_manager, time_t delta) noexcept {
+  return timer_awaitable<TTimer>(timer_manager, delta);
+}
+
+}  // namespace coroutine
+ATFRAMEWORK_UTILS_NAMESPACE_END
+
+#endif
+
+#endif /* UTIL_COROUTINE_TIMER_AWAITABLE_H */
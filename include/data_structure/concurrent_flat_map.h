@@ -0,0 +1,708 @@
+// Copyright 2026 atframework
+//
+// @brief 读多写少场景的并发开放寻址哈希表
+// @note 布局参考 Swiss Table: 每16个槽位为一组(按缓存行对齐)，每个槽位对应1字节标签(哈希值低7位)，
+//       查找时一次SIMD比较整组标签。
+// @note 读操作无锁: 每组有一个版本号(seqlock)，读者拷贝数据后校验版本号，冲突时重试。
+// @note 写操作先按哈希值获取分段锁(保证同一个key的写操作串行)，再通过版本号的锁定位锁定单个组。
+// @note 扩容是渐进式的: 新表发布后，每次写操作顺带迁移少量旧表的组，读操作同时查找新旧两张表。
+// @note 由于读者会拷贝可能正在被修改的数据再校验，key和value必须是 trivially copyable 的类型。
+//       旧表默认在容器析构时才释放，所以读者不需要额外的内存回收机制；也可以在没有并发访问时调用
+//       reclaim_retired_tables() 提前释放。
+
+#pragma once
+
+#include <config/atframe_utils_build_feature.h>
+#include <config/compile_optimize.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define ATFW_UTIL_DS_CONCURRENT_FLAT_MAP_USE_SSE2 1
+#endif
+
+#include "algorithm/bit.h"
+#include "lock/lock_holder.h"
+#include "lock/spin_lock.h"
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace ds {
+namespace details {
+
+/**
+ * @brief 组内标签操作，返回值的第i位表示第i个槽位匹配
+ */
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY concurrent_flat_map_ctrl {
+  enum : uint8_t {
+    TAG_EMPTY = 0x80,
+    TAG_DELETED = 0xFE,
+  };
+
+  enum : size_t {
+    GROUP_SIZE = 16,
+  };
+
+#if defined(ATFW_UTIL_DS_CONCURRENT_FLAT_MAP_USE_SSE2)
+  ATFW_UTIL_FORCEINLINE ATFW_UTIL_SANITIZER_NO_THREAD static uint32_t match(const uint8_t* tags,
+                                                                            uint8_t tag) noexcept {
+    __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tags));
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(static_cast<char>(tag)))));
+  }
+
+  // 空位和删除标记的最高位都是1，满槽位的最高位是0
+  ATFW_UTIL_FORCEINLINE ATFW_UTIL_SANITIZER_NO_THREAD static uint32_t match_empty_or_deleted(
+      const uint8_t* tags) noexcept {
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(tags))));
+  }
+#else
+  ATFW_UTIL_FORCEINLINE ATFW_UTIL_SANITIZER_NO_THREAD static uint32_t match(const uint8_t* tags,
+                                                                            uint8_t tag) noexcept {
+    uint32_t ret = 0;
+    for (size_t i = 0; i < GROUP_SIZE; ++i) {
+      ret |= static_cast<uint32_t>(tags[i] == tag) << i;
+    }
+    return ret;
+  }
+
+  ATFW_UTIL_FORCEINLINE ATFW_UTIL_SANITIZER_NO_THREAD static uint32_t match_empty_or_deleted(
+      const uint8_t* tags) noexcept {
+    uint32_t ret = 0;
+    for (size_t i = 0; i < GROUP_SIZE; ++i) {
+      ret |= static_cast<uint32_t>(tags[i] >> 7) << i;
+    }
+    return ret;
+  }
+#endif
+
+  ATFW_UTIL_FORCEINLINE ATFW_UTIL_SANITIZER_NO_THREAD static uint32_t match_empty(const uint8_t* tags) noexcept {
+    return match(tags, static_cast<uint8_t>(TAG_EMPTY));
+  }
+
+  ATFW_UTIL_FORCEINLINE ATFW_UTIL_SANITIZER_NO_THREAD static uint32_t match_full(const uint8_t* tags) noexcept {
+    return (~match_empty_or_deleted(tags)) & 0xFFFFu;
+  }
+
+  ATFW_UTIL_FORCEINLINE static uint64_t mix_hash(size_t h) noexcept {
+    // murmur3 fmix64，避免 std::hash 对整数是恒等映射导致标签和组下标分布不均
+    uint64_t x = static_cast<uint64_t>(h);
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+  }
+};
+
+}  // namespace details
+
+/**
+ * @brief 并发哈希表
+ * @note find/contains 无锁，insert/insert_or_assign/erase 使用分段锁+组锁
+ * @note 不提供迭代器，也不返回元素引用，所有读取都通过拷贝完成
+ */
+template <class TKey, class TValue, class THash = std::hash<TKey>, class TKeyEqual = std::equal_to<TKey>>
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY concurrent_flat_map {
+ public:
+  using key_type = TKey;
+  using mapped_type = TValue;
+  using hasher = THash;
+  using key_equal = TKeyEqual;
+  using size_type = size_t;
+
+  static_assert(std::is_trivially_copyable<key_type>::value, "key_type must be trivially copyable");
+  static_assert(std::is_trivially_copyable<mapped_type>::value, "mapped_type must be trivially copyable");
+
+ private:
+  using ctrl = details::concurrent_flat_map_ctrl;
+
+  enum : size_t {
+    GROUP_SIZE = ctrl::GROUP_SIZE,
+    CACHE_LINE_SIZE = 64,
+    STRIPE_COUNT = 64,
+    MIGRATE_GROUPS_PER_WRITE = 2,
+  };
+
+  enum : uint32_t {
+    VERSION_LOCKED = 1,
+    VERSION_MOVED = 2,
+    VERSION_STEP = 4,
+  };
+
+  enum op_result_t : int {
+    OP_RETRY = 0,
+    OP_INSERTED,
+    OP_EXISTED,
+    OP_NEED_RESIZE,
+    OP_ERASED,
+    OP_NOT_FOUND,
+  };
+
+  struct slot_type {
+    key_type key;
+    mapped_type value;
+  };
+
+  struct alignas(CACHE_LINE_SIZE) group_type {
+    // bit0: 写锁定, bit1: 已迁移到新表(之后只读), 其余位为修改计数
+    ::std::atomic<uint32_t> version;
+    uint8_t tags[GROUP_SIZE];
+    alignas(slot_type) unsigned char slots[GROUP_SIZE][sizeof(slot_type)];
+
+    group_type() noexcept : version(0) { memset(tags, static_cast<int>(ctrl::TAG_EMPTY), sizeof(tags)); }
+
+    ATFW_UTIL_FORCEINLINE slot_type* slot_at(size_t idx) noexcept { return reinterpret_cast<slot_type*>(slots[idx]); }
+    ATFW_UTIL_FORCEINLINE const slot_type* slot_at(size_t idx) const noexcept {
+      return reinterpret_cast<const slot_type*>(slots[idx]);
+    }
+  };
+
+  struct table_type {
+    explicit table_type(size_t group_count)
+        : group_mask(group_count - 1),
+          buffer(new unsigned char[group_count * sizeof(group_type) + CACHE_LINE_SIZE]),
+          groups(nullptr),
+          used(0),
+          moved_count(0),
+          migrate_cursor(0),
+          prev(nullptr),
+          next(nullptr) {
+      // C++14 的 new 不保证超过 max_align_t 的对齐，手动对齐到缓存行
+      uintptr_t addr = reinterpret_cast<uintptr_t>(buffer.get());
+      addr = (addr + CACHE_LINE_SIZE - 1) & ~static_cast<uintptr_t>(CACHE_LINE_SIZE - 1);
+      groups = reinterpret_cast<group_type*>(addr);
+      for (size_t i = 0; i < group_count; ++i) {
+        new (groups + i) group_type();
+      }
+    }
+
+    ~table_type() {
+      for (size_t i = 0; i <= group_mask; ++i) {
+        groups[i].~group_type();
+      }
+    }
+
+    table_type(const table_type&) = delete;
+    table_type& operator=(const table_type&) = delete;
+
+    ATFW_UTIL_FORCEINLINE size_t group_count() const noexcept { return group_mask + 1; }
+    ATFW_UTIL_FORCEINLINE size_t capacity() const noexcept { return group_count() * GROUP_SIZE; }
+    // 最大负载 7/8，保证探测总能遇到空位
+    ATFW_UTIL_FORCEINLINE size_t max_used() const noexcept { return capacity() - capacity() / 8; }
+    ATFW_UTIL_FORCEINLINE group_type& group_at(size_t idx) noexcept { return groups[idx]; }
+    ATFW_UTIL_FORCEINLINE const group_type& group_at(size_t idx) const noexcept { return groups[idx]; }
+
+    size_t group_mask;
+    ::std::unique_ptr<unsigned char[]> buffer;
+    group_type* groups;
+    ::std::atomic<size_t> used;  // 满槽位+删除标记数量
+    ::std::atomic<size_t> moved_count;
+    ::std::atomic<size_t> migrate_cursor;
+    ::std::atomic<table_type*> prev;  // 迁移中的旧表，迁移完成后置空
+    ::std::atomic<table_type*> next;  // 扩容后的新表
+  };
+
+  struct stripe_type {
+    lock::spin_lock lock;
+    char padding[CACHE_LINE_SIZE > sizeof(lock::spin_lock) ? CACHE_LINE_SIZE - sizeof(lock::spin_lock) : 1];
+  };
+
+ public:
+  explicit concurrent_flat_map(size_type init_capacity = 0, const hasher& hash = hasher(),
+                               const key_equal& equal = key_equal())
+      : hasher_(hash), key_equal_(equal), current_(nullptr), size_(0) {
+    size_t group_count = 1;
+    while (group_count * GROUP_SIZE - group_count * GROUP_SIZE / 8 < init_capacity) {
+      group_count <<= 1;
+    }
+
+    tables_.emplace_back(new table_type(group_count));
+    current_.store(tables_.back().get(), ::std::memory_order_release);
+  }
+
+  concurrent_flat_map(const concurrent_flat_map&) = delete;
+  concurrent_flat_map& operator=(const concurrent_flat_map&) = delete;
+
+  /**
+   * @brief 查找key，找到时把值拷贝到out
+   * @return 是否找到
+   */
+  bool find(const key_type& key, mapped_type& out) const noexcept { return find_impl(key, &out); }
+
+  bool contains(const key_type& key) const noexcept { return find_impl(key, nullptr); }
+
+  /**
+   * @brief 插入，key已存在时不修改
+   * @return 是否插入了新元素
+   */
+  bool insert(const key_type& key, const mapped_type& value) { return upsert(key, value, false); }
+
+  /**
+   * @brief 插入或覆盖
+   * @return 是否插入了新元素(false表示覆盖了已有元素)
+   */
+  bool insert_or_assign(const key_type& key, const mapped_type& value) { return upsert(key, value, true); }
+
+  /**
+   * @brief 删除
+   * @return 是否删除了元素
+   */
+  bool erase(const key_type& key) noexcept {
+    uint64_t h = hash_of(key);
+    lock::lock_holder<lock::spin_lock> stripe_holder(stripe_of(h));
+
+    while (true) {
+      table_type* t = current_.load(::std::memory_order_acquire);
+      help_migrate(*t, h);
+
+      op_result_t res = erase_in_table(*t, key, h);
+      if (res == OP_RETRY) {
+        continue;
+      }
+
+      if (res == OP_ERASED) {
+        size_.fetch_sub(1, ::std::memory_order_relaxed);
+        return true;
+      }
+      return false;
+    }
+  }
+
+  ATFW_UTIL_FORCEINLINE size_type size() const noexcept { return size_.load(::std::memory_order_relaxed); }
+
+  ATFW_UTIL_FORCEINLINE bool empty() const noexcept { return size() == 0; }
+
+  /**
+   * @brief 当前表在触发扩容前最多能容纳的元素数量
+   */
+  ATFW_UTIL_FORCEINLINE size_type capacity() const noexcept {
+    return current_.load(::std::memory_order_acquire)->max_used();
+  }
+
+  /**
+   * @brief 释放扩容后保留的旧表
+   * @note 读者不登记访问，所以只能在没有任何并发访问时调用(比如所有工作线程停止后)
+   * @return 释放的表数量
+   */
+  size_t reclaim_retired_tables() noexcept {
+    lock::lock_holder<lock::spin_lock> resize_holder(resize_lock_);
+    table_type* t = current_.load(::std::memory_order_acquire);
+    finish_migrate(*t);
+
+    size_t ret = 0;
+    for (size_t i = 0; i < tables_.size(); ++i) {
+      if (tables_[i].get() == t) {
+        tables_[i].release();
+      } else {
+        ++ret;
+      }
+    }
+    tables_.clear();
+    tables_.emplace_back(t);
+    return ret;
+  }
+
+ private:
+  ATFW_UTIL_FORCEINLINE uint64_t hash_of(const key_type& key) const noexcept {
+    return ctrl::mix_hash(static_cast<size_t>(hasher_(key)));
+  }
+
+  ATFW_UTIL_FORCEINLINE static uint8_t tag_of(uint64_t h) noexcept { return static_cast<uint8_t>(h & 0x7F); }
+
+  ATFW_UTIL_FORCEINLINE static size_t first_group_of(const table_type& t, uint64_t h) noexcept {
+    return static_cast<size_t>(h >> 7) & t.group_mask;
+  }
+
+  ATFW_UTIL_FORCEINLINE lock::spin_lock& stripe_of(uint64_t h) noexcept {
+    return stripes_[static_cast<size_t>(h >> 58) & (STRIPE_COUNT - 1)].lock;
+  }
+
+  /**
+   * @brief 锁定组
+   * @return 组已迁移时返回false
+   */
+  static bool lock_group(group_type& g, uint32_t& version) noexcept {
+    uint32_t v = g.version.load(::std::memory_order_relaxed);
+    unsigned int try_times = 0;
+    while (true) {
+      if (v & VERSION_MOVED) {
+        ::std::atomic_thread_fence(::std::memory_order_acquire);
+        return false;
+      }
+
+      if (v & VERSION_LOCKED) {
+        lock::detail::spin_wait(try_times++);
+        v = g.version.load(::std::memory_order_relaxed);
+        continue;
+      }
+
+      if (g.version.compare_exchange_weak(v, v | VERSION_LOCKED, ::std::memory_order_acquire,
+                                          ::std::memory_order_relaxed)) {
+        // 保证读者先观察到锁定位，再观察到数据修改
+        ::std::atomic_thread_fence(::std::memory_order_release);
+        version = v;
+        return true;
+      }
+    }
+  }
+
+  // 数据有修改，增加版本号使并发的读者重试
+  ATFW_UTIL_FORCEINLINE static void unlock_group_modified(group_type& g, uint32_t version, uint32_t flags) noexcept {
+    g.version.store((version + VERSION_STEP) | flags, ::std::memory_order_release);
+  }
+
+  // 数据未修改，恢复原版本号
+  ATFW_UTIL_FORCEINLINE static void unlock_group_unchanged(group_type& g, uint32_t version) noexcept {
+    g.version.store(version, ::std::memory_order_release);
+  }
+
+  int find_slot_locked(const group_type& g, const key_type& key, uint8_t tag) const noexcept {
+    uint32_t mask = ctrl::match(g.tags, tag);
+    while (mask) {
+      int idx = bit::countr_zero(mask);
+      if (key_equal_(g.slot_at(static_cast<size_t>(idx))->key, key)) {
+        return idx;
+      }
+      mask &= mask - 1;
+    }
+    return -1;
+  }
+
+  bool find_impl(const key_type& key, mapped_type* out) const noexcept {
+    uint64_t h = hash_of(key);
+    const table_type* t = current_.load(::std::memory_order_acquire);
+    // 迁移期间先查旧表，旧表中已迁移的组一定已经出现在新表中
+    const table_type* prev = t->prev.load(::std::memory_order_acquire);
+    if (nullptr != prev) {
+      t = prev;
+    }
+
+    while (nullptr != t) {
+      if (find_in_table(*t, key, h, out)) {
+        return true;
+      }
+      // 读取期间可能发生了扩容，新插入的元素在新表中
+      t = t->next.load(::std::memory_order_acquire);
+    }
+    return false;
+  }
+
+  ATFW_UTIL_SANITIZER_NO_THREAD bool find_in_table(const table_type& t, const key_type& key, uint64_t h,
+                                                   mapped_type* out) const noexcept {
+    uint8_t tag = tag_of(h);
+    size_t gi = first_group_of(t, h);
+    for (size_t probe = 1; probe <= t.group_count(); ++probe) {
+      const group_type& g = t.group_at(gi);
+      bool has_empty = false;
+      unsigned int try_times = 0;
+      while (true) {
+        uint32_t v1 = g.version.load(::std::memory_order_acquire);
+        if (v1 & VERSION_LOCKED) {
+          lock::detail::spin_wait(try_times++);
+          continue;
+        }
+
+        // 已迁移的组只读，直接用标签判断是否需要继续探测，元素本身在新表中查找
+        if (v1 & VERSION_MOVED) {
+          has_empty = ctrl::match_empty(g.tags) != 0;
+          break;
+        }
+
+        alignas(slot_type) unsigned char copied[sizeof(slot_type)];
+        bool found = false;
+        uint32_t mask = ctrl::match(g.tags, tag);
+        while (mask) {
+          memcpy(copied, g.slots[bit::countr_zero(mask)], sizeof(slot_type));
+          if (key_equal_(reinterpret_cast<const slot_type*>(copied)->key, key)) {
+            found = true;
+            break;
+          }
+          mask &= mask - 1;
+        }
+        has_empty = ctrl::match_empty(g.tags) != 0;
+
+        ::std::atomic_thread_fence(::std::memory_order_acquire);
+        if (g.version.load(::std::memory_order_relaxed) != v1) {
+          continue;
+        }
+
+        if (found) {
+          if (nullptr != out) {
+            memcpy(static_cast<void*>(out), &reinterpret_cast<const slot_type*>(copied)->value, sizeof(mapped_type));
+          }
+          return true;
+        }
+        break;
+      }
+
+      if (has_empty) {
+        return false;
+      }
+      gi = (gi + probe) & t.group_mask;
+    }
+    return false;
+  }
+
+  bool upsert(const key_type& key, const mapped_type& value, bool assign) {
+    uint64_t h = hash_of(key);
+    lock::lock_holder<lock::spin_lock> stripe_holder(stripe_of(h));
+
+    while (true) {
+      table_type* t = current_.load(::std::memory_order_acquire);
+      help_migrate(*t, h);
+
+      op_result_t res = upsert_in_table(*t, key, value, h, assign);
+      switch (res) {
+        case OP_INSERTED:
+          size_.fetch_add(1, ::std::memory_order_relaxed);
+          return true;
+        case OP_EXISTED:
+          return false;
+        case OP_NEED_RESIZE:
+          rehash(t);
+          break;
+        default:
+          break;
+      }
+    }
+  }
+
+  op_result_t upsert_in_table(table_type& t, const key_type& key, const mapped_type& value, uint64_t h,
+                              bool assign) noexcept {
+    uint8_t tag = tag_of(h);
+
+    // 第一遍: 查找已有元素。同一个key的写操作被分段锁串行化，所以两遍之间key不会被其他线程插入
+    size_t gi = first_group_of(t, h);
+    for (size_t probe = 1; probe <= t.group_count(); ++probe) {
+      group_type& g = t.group_at(gi);
+      uint32_t v;
+      if (!lock_group(g, v)) {
+        return OP_RETRY;
+      }
+
+      int idx = find_slot_locked(g, key, tag);
+      if (idx >= 0) {
+        if (assign) {
+          memcpy(static_cast<void*>(&g.slot_at(static_cast<size_t>(idx))->value), &value, sizeof(mapped_type));
+          unlock_group_modified(g, v, 0);
+        } else {
+          unlock_group_unchanged(g, v);
+        }
+        return OP_EXISTED;
+      }
+
+      bool has_empty = ctrl::match_empty(g.tags) != 0;
+      unlock_group_unchanged(g, v);
+      if (has_empty) {
+        break;
+      }
+      gi = (gi + probe) & t.group_mask;
+    }
+
+    // 第二遍: 插入到探测序列上的第一个空位或删除标记
+    gi = first_group_of(t, h);
+    for (size_t probe = 1; probe <= t.group_count(); ++probe) {
+      group_type& g = t.group_at(gi);
+      uint32_t v;
+      if (!lock_group(g, v)) {
+        return OP_RETRY;
+      }
+
+      uint32_t mask = ctrl::match_empty_or_deleted(g.tags);
+      if (mask) {
+        size_t idx = static_cast<size_t>(bit::countr_zero(mask));
+        if (g.tags[idx] == static_cast<uint8_t>(ctrl::TAG_EMPTY)) {
+          if (t.used.load(::std::memory_order_relaxed) >= t.max_used()) {
+            unlock_group_unchanged(g, v);
+            return OP_NEED_RESIZE;
+          }
+          t.used.fetch_add(1, ::std::memory_order_relaxed);
+        }
+
+        new (g.slots[idx]) slot_type{key, value};
+        g.tags[idx] = tag;
+        unlock_group_modified(g, v, 0);
+        return OP_INSERTED;
+      }
+
+      unlock_group_unchanged(g, v);
+      gi = (gi + probe) & t.group_mask;
+    }
+
+    return OP_NEED_RESIZE;
+  }
+
+  op_result_t erase_in_table(table_type& t, const key_type& key, uint64_t h) noexcept {
+    uint8_t tag = tag_of(h);
+    size_t gi = first_group_of(t, h);
+    for (size_t probe = 1; probe <= t.group_count(); ++probe) {
+      group_type& g = t.group_at(gi);
+      uint32_t v;
+      if (!lock_group(g, v)) {
+        return OP_RETRY;
+      }
+
+      int idx = find_slot_locked(g, key, tag);
+      bool has_empty = ctrl::match_empty(g.tags) != 0;
+      if (idx >= 0) {
+        // 组内已有空位时探测不会越过本组，可以直接标记为空位而不留删除标记
+        if (has_empty) {
+          g.tags[idx] = static_cast<uint8_t>(ctrl::TAG_EMPTY);
+          t.used.fetch_sub(1, ::std::memory_order_relaxed);
+        } else {
+          g.tags[idx] = static_cast<uint8_t>(ctrl::TAG_DELETED);
+        }
+        unlock_group_modified(g, v, 0);
+        return OP_ERASED;
+      }
+
+      unlock_group_unchanged(g, v);
+      if (has_empty) {
+        break;
+      }
+      gi = (gi + probe) & t.group_mask;
+    }
+
+    return OP_NOT_FOUND;
+  }
+
+  /**
+   * @brief 迁移旧表中的一个组，迁移期间持有旧组的锁，所以迁移是原子的
+   */
+  void migrate_group(table_type& from, size_t gi, table_type& to) noexcept {
+    group_type& g = from.group_at(gi);
+    uint32_t v;
+    if (!lock_group(g, v)) {
+      return;
+    }
+
+    uint32_t mask = ctrl::match_full(g.tags);
+    while (mask) {
+      const slot_type* slot = g.slot_at(static_cast<size_t>(bit::countr_zero(mask)));
+      migrate_insert(to, *slot, hash_of(slot->key));
+      mask &= mask - 1;
+    }
+
+    unlock_group_modified(g, v, VERSION_MOVED);
+    if (from.moved_count.fetch_add(1, ::std::memory_order_acq_rel) + 1 == from.group_count()) {
+      to.prev.store(nullptr, ::std::memory_order_release);
+    }
+  }
+
+  // 迁移目标表一定是最新的表(迁移完成前不会再次扩容)，且key不会重复，不需要查重
+  void migrate_insert(table_type& to, const slot_type& slot, uint64_t h) noexcept {
+    size_t gi = first_group_of(to, h);
+    for (size_t probe = 1; probe <= to.group_count(); ++probe) {
+      group_type& g = to.group_at(gi);
+      uint32_t v;
+      if (lock_group(g, v)) {
+        uint32_t mask = ctrl::match_empty_or_deleted(g.tags);
+        if (mask) {
+          size_t idx = static_cast<size_t>(bit::countr_zero(mask));
+          if (g.tags[idx] == static_cast<uint8_t>(ctrl::TAG_EMPTY)) {
+            to.used.fetch_add(1, ::std::memory_order_relaxed);
+          }
+          memcpy(g.slots[idx], &slot, sizeof(slot_type));
+          g.tags[idx] = tag_of(h);
+          unlock_group_modified(g, v, 0);
+          return;
+        }
+        unlock_group_unchanged(g, v);
+      }
+      gi = (gi + probe) & to.group_mask;
+    }
+  }
+
+  /**
+   * @brief 写操作前协助迁移: 先迁移当前key在旧表中的探测路径，保证key只存在于新表；再按游标迁移少量组
+   */
+  void help_migrate(table_type& t, uint64_t h) noexcept {
+    table_type* from = t.prev.load(::std::memory_order_acquire);
+    if (nullptr == from) {
+      return;
+    }
+
+    size_t gi = first_group_of(*from, h);
+    for (size_t probe = 1; probe <= from->group_count(); ++probe) {
+      migrate_group(*from, gi, t);
+      // 迁移后的组只读，标签可以直接访问
+      if (ctrl::match_empty(from->group_at(gi).tags) != 0) {
+        break;
+      }
+      gi = (gi + probe) & from->group_mask;
+    }
+
+    for (size_t i = 0; i < MIGRATE_GROUPS_PER_WRITE; ++i) {
+      size_t idx = from->migrate_cursor.fetch_add(1, ::std::memory_order_relaxed);
+      if (idx >= from->group_count()) {
+        break;
+      }
+      migrate_group(*from, idx, t);
+    }
+  }
+
+  void finish_migrate(table_type& t) noexcept {
+    table_type* from = t.prev.load(::std::memory_order_acquire);
+    if (nullptr == from) {
+      return;
+    }
+
+    for (size_t i = 0; i < from->group_count(); ++i) {
+      migrate_group(*from, i, t);
+    }
+
+    // 等待其他线程正在进行的组迁移完成
+    unsigned int try_times = 0;
+    while (nullptr != t.prev.load(::std::memory_order_acquire)) {
+      lock::detail::spin_wait(try_times++);
+    }
+  }
+
+  void rehash(table_type* t) {
+    lock::lock_holder<lock::spin_lock> resize_holder(resize_lock_);
+    if (current_.load(::std::memory_order_acquire) != t) {
+      return;
+    }
+
+    // 同时最多只有新旧两张表
+    finish_migrate(*t);
+    if (t->used.load(::std::memory_order_relaxed) < t->max_used()) {
+      return;
+    }
+
+    // 删除标记过多时原尺寸重建即可
+    size_t group_count = t->group_count();
+    if (size_.load(::std::memory_order_relaxed) >= t->capacity() / 2) {
+      group_count <<= 1;
+    }
+
+    tables_.emplace_back(new table_type(group_count));
+    table_type* next = tables_.back().get();
+    next->prev.store(t, ::std::memory_order_relaxed);
+    t->next.store(next, ::std::memory_order_release);
+    current_.store(next, ::std::memory_order_release);
+  }
+
+ private:
+  hasher hasher_;
+  key_equal key_equal_;
+  ::std::atomic<table_type*> current_;
+  ::std::atomic<size_type> size_;
+
+  lock::spin_lock resize_lock_;
+  ::std::vector<::std::unique_ptr<table_type>> tables_;
+  stripe_type stripes_[STRIPE_COUNT];
+};
+
+}  // namespace ds
+ATFRAMEWORK_UTILS_NAMESPACE_END
@@ -0,0 +1,174 @@
+// Copyright 2026 atframework
+//
+// @brief 稠密有限状态机(状态为从0开始的连续枚举值)
+// @note 转移表使用 bitset 矩阵，监听器按状态下标索引，状态切换为O(1)且不会分配内存
+// @note 转移表构建完成后是只读的，可以被大量状态机实例共享
+// @note 监听器使用 nostd::function_ref 保存，不持有回调对象，调用者需要保证回调对象的生命周期长于转移表
+
+#pragma once
+
+#include <config/atframe_utils_build_feature.h>
+
+#include <bitset>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "nostd/function_ref.h"
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace ds {
+
+/**
+ * 稠密有限状态机的转移表
+ * @brief 所有状态值必须在 [0, StateCount) 范围内
+ */
+template <typename T, size_t StateCount, typename... TParams>
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY dense_finite_state_machine_table {
+ public:
+  static_assert(std::is_enum<T>::value || std::is_integral<T>::value, "state must be enum or integer");
+  static_assert(StateCount > 0, "StateCount must be greater than 0");
+
+  using key_type = T;
+  using value_type = nostd::function_ref<void(key_type, key_type, TParams...)>;
+  using listener_list_type = std::vector<value_type>;
+  using state_set_type = std::bitset<StateCount>;
+
+  static constexpr const size_t state_count = StateCount;
+
+ public:
+  dense_finite_state_machine_table() : pairs_listener_(StateCount * StateCount) {}
+
+  static constexpr bool is_valid(key_type k) noexcept { return static_cast<size_t>(k) < StateCount; }
+
+  /**
+   * @brief 允许 from -> to 的转移
+   */
+  bool add_transition(key_type from, key_type to) {
+    if (!is_valid(from) || !is_valid(to)) {
+      return false;
+    }
+
+    transitions_[static_cast<size_t>(from)].set(static_cast<size_t>(to));
+    return true;
+  }
+
+  /**
+   * @brief 允许 from -> to 的转移并添加切换回调
+   */
+  bool add_listener(key_type from, key_type to, value_type fn) {
+    if (!add_transition(from, to)) {
+      return false;
+    }
+
+    pairs_listener_[pair_index(from, to)].push_back(fn);
+    return true;
+  }
+
+  bool add_enter_listener(key_type k, value_type fn) {
+    if (!is_valid(k)) {
+      return false;
+    }
+
+    enter_to_listener_[static_cast<size_t>(k)].push_back(fn);
+    return true;
+  }
+
+  bool add_leave_listener(key_type k, value_type fn) {
+    if (!is_valid(k)) {
+      return false;
+    }
+
+    leave_from_listener_[static_cast<size_t>(k)].push_back(fn);
+    return true;
+  }
+
+  inline bool test(key_type from, key_type to) const noexcept {
+    return is_valid(from) && is_valid(to) && transitions_[static_cast<size_t>(from)].test(static_cast<size_t>(to));
+  }
+
+  inline const state_set_type& get_transitions(key_type from) const noexcept {
+    return transitions_[static_cast<size_t>(from)];
+  }
+
+  inline const listener_list_type& get_leave_listeners(key_type k) const noexcept {
+    return leave_from_listener_[static_cast<size_t>(k)];
+  }
+
+  inline const listener_list_type& get_enter_listeners(key_type k) const noexcept {
+    return enter_to_listener_[static_cast<size_t>(k)];
+  }
+
+  inline const listener_list_type& get_switch_listeners(key_type from, key_type to) const noexcept {
+    return pairs_listener_[pair_index(from, to)];
+  }
+
+ private:
+  static constexpr size_t pair_index(key_type from, key_type to) noexcept {
+    return static_cast<size_t>(from) * StateCount + static_cast<size_t>(to);
+  }
+
+ private:
+  state_set_type transitions_[StateCount];
+  listener_list_type leave_from_listener_[StateCount];
+  listener_list_type enter_to_listener_[StateCount];
+  std::vector<listener_list_type> pairs_listener_;
+};
+
+template <typename T, size_t StateCount, typename... TParams>
+constexpr const size_t dense_finite_state_machine_table<T, StateCount, TParams...>::state_count;
+
+/**
+ * 稠密有限状态机
+ * @brief 实例只保存当前状态和转移表指针，转移表需要在所有实例销毁前保持有效且不再修改
+ */
+template <typename T, size_t StateCount, typename... TParams>
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY dense_finite_state_machine {
+ public:
+  using table_type = dense_finite_state_machine_table<T, StateCount, TParams...>;
+  using key_type = typename table_type::key_type;
+  using value_type = typename table_type::value_type;
+
+ public:
+  explicit dense_finite_state_machine(const table_type& table) noexcept
+      : table_(&table), state_(static_cast<key_type>(0)) {}
+  dense_finite_state_machine(const table_type& table, key_type init_state) noexcept
+      : table_(&table), state_(init_state) {}
+
+  inline key_type get_state() const noexcept { return state_; }
+
+  inline const table_type& get_table() const noexcept { return *table_; }
+
+  inline bool test(key_type t) const noexcept { return table_->test(state_, t); }
+
+  bool set_state(key_type t, TParams... params) {
+    if (!table_->test(state_, t)) {
+      return false;
+    }
+
+    // 先触发离场状态回调
+    for (const value_type& fn : table_->get_leave_listeners(state_)) {
+      fn(state_, t, params...);
+    }
+
+    // 再触发进场状态回调
+    for (const value_type& fn : table_->get_enter_listeners(t)) {
+      fn(state_, t, params...);
+    }
+
+    // 最后触发切换状态回调
+    for (const value_type& fn : table_->get_switch_listeners(state_, t)) {
+      fn(state_, t, params...);
+    }
+
+    state_ = t;
+    return true;
+  }
+
+ private:
+  const table_type* table_;
+  key_type state_;
+};
+
+}  // namespace ds
+ATFRAMEWORK_UTILS_NAMESPACE_END
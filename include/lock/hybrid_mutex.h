@@ -0,0 +1,151 @@
+// Copyright 2026 atframework
+//
+// @file hybrid_mutex.h
+// @brief 自适应自旋+挂起的混合锁
+// Licensed under the MIT licenses.
+//
+// @note 无竞争时只有一次CAS；有竞争时先自旋，自旋次数根据最近几次在自旋阶段拿到锁所需的次数自适应调整
+//       (近似于最近临界区的持有时长)，超过上限后在futex(Linux)/WaitOnAddress(Windows)/std::atomic::wait上挂起。
+// @note 接口与 spin_lock 一致，可直接用于 lock_holder 和 std::lock_guard
+// @note 开启 ATFRAMEWORK_UTILS_LOCK_DISABLE_MT 时和 spin_lock 一样退化为非原子的状态标记，不会自旋或挂起
+
+#ifndef UTIL_LOCK_HYBRID_MUTEX_H
+#define UTIL_LOCK_HYBRID_MUTEX_H
+
+#pragma once
+
+#include <config/atframe_utils_build_feature.h>
+#include <config/compile_optimize.h>
+
+#include <atomic>
+#include <cstdint>
+
+#include "spin_lock.h"
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace lock {
+namespace detail {
+
+/**
+ * @brief 如果 *addr == expected 则挂起当前线程，直到被唤醒(可能虚假唤醒)
+ */
+ATFRAMEWORK_UTILS_API void park_wait(::std::atomic<uint32_t>& addr, uint32_t expected) noexcept;
+
+/**
+ * @brief 唤醒一个挂起在addr上的线程
+ */
+ATFRAMEWORK_UTILS_API void park_wake_one(::std::atomic<uint32_t>& addr) noexcept;
+
+/**
+ * @brief 唤醒所有挂起在addr上的线程
+ */
+ATFRAMEWORK_UTILS_API void park_wake_all(::std::atomic<uint32_t>& addr) noexcept;
+
+}  // namespace detail
+
+/**
+ * @brief 混合锁的竞争统计(快照)
+ */
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY hybrid_mutex_stats {
+  uint64_t contended_count;      // lock()时锁已被占用的次数
+  uint64_t spin_acquired_count;  // 在自旋阶段拿到锁的次数
+  uint64_t parked_count;         // 挂起等待的次数
+  uint32_t spin_limit;           // 当前自适应自旋上限
+};
+
+/**
+ * @brief 自适应自旋后挂起的互斥锁
+ * @note 状态机参考 Ulrich Drepper, "Futexes Are Tricky" 中的 mutex3
+ */
+class ATFRAMEWORK_UTILS_API hybrid_mutex {
+ private:
+  enum lock_state_t : uint32_t {
+    UNLOCKED = 0,
+    LOCKED = 1,
+    LOCKED_WITH_WAITERS = 2,
+  };
+
+ public:
+  enum : uint32_t {
+    DEFAULT_MAX_SPIN = 128,
+    MIN_SPIN = 8,
+  };
+
+  explicit hybrid_mutex(uint32_t max_spin = DEFAULT_MAX_SPIN) noexcept;
+
+  hybrid_mutex(const hybrid_mutex&) = delete;
+  hybrid_mutex& operator=(const hybrid_mutex&) = delete;
+
+  ATFW_UTIL_FORCEINLINE void lock() noexcept {
+    uint32_t expect = static_cast<uint32_t>(UNLOCKED);
+    ATFW_UTIL_LIKELY_IF(lock_status_.compare_exchange_strong(
+        expect, static_cast<uint32_t>(LOCKED), ::std::memory_order_acquire, ::std::memory_order_relaxed)) {
+      return;
+    }
+
+    lock_slow();
+  }
+
+  ATFW_UTIL_FORCEINLINE void unlock() noexcept {
+#if defined(ATFRAMEWORK_UTILS_LOCK_DISABLE_MT) && ATFRAMEWORK_UTILS_LOCK_DISABLE_MT
+    lock_status_.store(static_cast<uint32_t>(UNLOCKED), ::std::memory_order_release);
+#else
+    if (lock_status_.exchange(static_cast<uint32_t>(UNLOCKED), ::std::memory_order_release) ==
+        static_cast<uint32_t>(LOCKED_WITH_WAITERS)) {
+      detail::park_wake_one(lock_status_);
+    }
+#endif
+  }
+
+  ATFW_UTIL_FORCEINLINE bool is_locked() const noexcept {
+    return lock_status_.load(::std::memory_order_acquire) != static_cast<uint32_t>(UNLOCKED);
+  }
+
+  ATFW_UTIL_FORCEINLINE bool try_lock() noexcept {
+    uint32_t expect = static_cast<uint32_t>(UNLOCKED);
+    return lock_status_.compare_exchange_strong(expect, static_cast<uint32_t>(LOCKED), ::std::memory_order_acquire,
+                                                ::std::memory_order_relaxed);
+  }
+
+  ATFW_UTIL_FORCEINLINE bool try_unlock() noexcept {
+    uint32_t prev = lock_status_.exchange(static_cast<uint32_t>(UNLOCKED), ::std::memory_order_release);
+#if !(defined(ATFRAMEWORK_UTILS_LOCK_DISABLE_MT) && ATFRAMEWORK_UTILS_LOCK_DISABLE_MT)
+    if (prev == static_cast<uint32_t>(LOCKED_WITH_WAITERS)) {
+      detail::park_wake_one(lock_status_);
+    }
+#endif
+    return prev != static_cast<uint32_t>(UNLOCKED);
+  }
+
+  /**
+   * @brief 获取竞争统计，统计只在竞争路径上更新，不影响无竞争时的性能
+   */
+  hybrid_mutex_stats get_stats() const noexcept;
+
+  void reset_stats() noexcept;
+
+  ATFW_UTIL_FORCEINLINE uint32_t get_max_spin() const noexcept { return max_spin_; }
+
+ private:
+  void lock_slow() noexcept;
+
+ private:
+#if defined(ATFRAMEWORK_UTILS_LOCK_DISABLE_MT) && ATFRAMEWORK_UTILS_LOCK_DISABLE_MT
+  ATFRAMEWORK_UTILS_NAMESPACE_ID::lock::atomic_int_type<ATFRAMEWORK_UTILS_NAMESPACE_ID::lock::unsafe_int_type<uint32_t>>
+      lock_status_;
+#else
+  ::std::atomic<uint32_t> lock_status_;
+#endif
+  uint32_t max_spin_;
+  // 最近在自旋阶段拿到锁所需自旋次数的滑动平均(x8定点数)，并发更新时允许丢失
+  ::std::atomic<uint32_t> spin_estimate_;
+
+  ::std::atomic<uint64_t> contended_count_;
+  ::std::atomic<uint64_t> spin_acquired_count_;
+  ::std::atomic<uint64_t> parked_count_;
+};
+
+}  // namespace lock
+ATFRAMEWORK_UTILS_NAMESPACE_END
+
+#endif /* UTIL_LOCK_HYBRID_MUTEX_H */
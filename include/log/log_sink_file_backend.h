@@ -16,7 +16,7 @@
 #include <string>
 #include <vector>
 
-#include "lock/spin_lock.h"
+#include "lock/hybrid_mutex.h"
 #include "lock/spin_rw_lock.h"
 #include "log/log_formatter.h"
 
@@ -125,7 +125,7 @@ class log_sink_file_backend {
   time_t flush_interval_;  // 定时执行文件flush
   bool inited_;
   lock::spin_rw_lock fs_lock_;
-  lock::spin_lock init_lock_;
+  lock::hybrid_mutex init_lock_;
 
   struct file_impl_t {
     log_level auto_flush;  // 当日记级别高于或等于这个时，将会强制执行一次flush
@@ -23,6 +23,7 @@
 
 #include "log/log_formatter.h"
 #include "nostd/string_view.h"
+#include "string/compiled_format.h"
 
 ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
 namespace log {
@@ -188,6 +189,25 @@ class log_wrapper {
 #  endif
 #endif
 
+  /**
+   * @brief 使用编译期解析的格式化字符串，不依赖 fmt 或 std::format
+   * @note 缓冲区足够时直接写入日志缓冲区，不足时截断，不会重试
+   */
+  template <size_t N, class... TFMTARGS, class... TARGS>
+  ATFW_UTIL_NOINLINE_NOCLONE ATFRAMEWORK_UTILS_API_HEAD_ONLY void format_log(
+      const caller_info_t &caller,
+      const ATFRAMEWORK_UTILS_NAMESPACE_ID::string::compiled_format<N, TFMTARGS...> &fmt_text, TARGS &&...args) {
+    log_operation_t writer;
+    start_log(caller, writer);
+    if (!log_sinks_.empty() && writer.writen_size + 1 < writer.total_size) {
+      size_t left_size = writer.total_size - writer.writen_size - 1;
+      writer.writen_size +=
+          fmt_text.format_to(writer.buffer + writer.writen_size, left_size, std::forward<TARGS>(args)...);
+      *(writer.buffer + writer.writen_size) = 0;
+    }
+    finish_log(caller, writer);
+  }
+
   // 一般日志级别检查
   UTIL_FORCEINLINE bool check_level(log_level level) const { return level >= log_level_; }
 
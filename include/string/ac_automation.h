@@ -24,6 +24,7 @@
 #include <utility>
 #include <vector>
 
+#include "string/ac_automation_dfa.h"
 #include "string/utf8_char_t.h"
 
 ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
@@ -108,6 +109,16 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY actrie_skip_charset<CH, 1> {
     return 0 != (skip_code_[index] & (1 << offset));
   }
 
+  size_t count() const {
+    size_t ret = 0;
+    for (size_t i = 0; i < sizeof(skip_code_); ++i) {
+      for (uint8_t bits = skip_code_[i]; bits; bits &= static_cast<uint8_t>(bits - 1)) {
+        ++ret;
+      }
+    }
+    return ret;
+  }
+
   inline bool operator[](CH c) const { return test(c); }
 
   template <typename OCH, typename OTCTT>
@@ -143,6 +154,8 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY actrie_skip_charset {
 
   bool test(CH c) const { return skip_code_.end() != skip_code_.find(c); }
 
+  size_t count() const { return skip_code_.size(); }
+
   inline bool operator[](CH c) const { return test(c); }
 
   template <typename OCH, typename OTCTT>
@@ -637,6 +650,12 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY ac_automation {
   bool is_inited_;
   bool is_no_case_;
 
+  /**
+   * 冻结后的双数组自动机和关键字下标到叶子节点字符串的映射
+   */
+  ac_automation_dfa frozen_;
+  std::vector<const string_t *> frozen_keywords_;
+
   /**
    * 初始化字典树的失败指针
    */
@@ -648,6 +667,11 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY ac_automation {
     is_inited_ = true;
   }
 
+  void unfreeze() {
+    frozen_.reset();
+    frozen_keywords_.clear();
+  }
+
  public:
   ac_automation() : is_inited_(false), is_no_case_(false) { trie_type::create(storage_); }
   ~ac_automation() {}
@@ -668,6 +692,7 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY ac_automation {
     }
 
     is_inited_ = false;
+    unfreeze();
 
     if (is_no_case_) {
       string_t res = keyword;
@@ -688,6 +713,7 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY ac_automation {
     if (content.empty()) {
       return ret;
     }
+
     const string_t *conv_content = &content;
     string_t nocase;
     if (is_no_case_) {
@@ -729,10 +755,38 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY ac_automation {
     return ret;
   }
 
+  /**
+   * 使用冻结后的双数组自动机匹配目标串
+   * @note 匹配语义和 match 不同: 报告结束位置最早的关键字(同一结束位置取最长的)，
+   *       包括结束在更长关键字的部分匹配中间的关键字。
+   *       比如关键字为 abcd 和 bc 时，match("xabce") 没有结果，match_frozen("xabce") 会报告 bc
+   * @param content 目标字符串
+   * @return 返回的结果列表，未冻结时返回空列表
+   */
+  value_type match_frozen(const string_t &content) const {
+    value_type ret;
+    if (content.empty() || !is_frozen()) {
+      return ret;
+    }
+
+    ac_automation_dfa::value_type frozen_res;
+    frozen_.match(content, frozen_res);
+    ret.reserve(frozen_res.size());
+    for (auto &frozen_item : frozen_res) {
+      ret.push_back(match_t());
+      match_t &item = ret.back();
+      item.start = frozen_item.start;
+      item.length = frozen_item.length;
+      item.keyword = frozen_keywords_[frozen_item.keyword_index];
+    }
+    return ret;
+  }
+
   /**
    * 清空关键字列表
    */
   void reset() {
+    unfreeze();
     storage_.clear();
     trie_type::create(storage_);
   }
@@ -740,24 +794,83 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY ac_automation {
   /**
    * 设置忽略字符
    */
-  void set_skip(char_t c) { skip_charset_.set(c); }
+  void set_skip(char_t c) {
+    unfreeze();
+    skip_charset_.set(c);
+  }
 
   /**
    * 取消设置忽略字符
    */
-  void unset_skip(char_t c) { skip_charset_.unset(c); }
+  void unset_skip(char_t c) {
+    unfreeze();
+    skip_charset_.unset(c);
+  }
 
   /**
    * 设置是否忽视大小写
    * @note 必须在insert_keyword前调用
    */
-  void set_nocase(bool v) { is_no_case_ = v; }
+  void set_nocase(bool v) {
+    unfreeze();
+    is_no_case_ = v;
+  }
 
   /**
    * 获取是否忽视大小写
    */
   bool is_nocase() const { return is_no_case_; }
 
+  /**
+   * 把当前关键字编译为双数组自动机，之后可以用 match_frozen 按UTF-8字节查表匹配，不再递归
+   * @note 修改关键字、忽略字符或大小写设置后需要重新调用
+   * @note 忽略字符只支持单字节(ASCII)字符，存在其他忽略字符时返回false
+   * @note 不影响 match 的结果，match 总是使用字典树
+   * @return 成功返回true
+   */
+  bool freeze() {
+    init();
+
+    std::vector<nostd::string_view> keywords;
+    frozen_keywords_.clear();
+    for (size_t i = 0; i < storage_.size(); ++i) {
+      if (storage_[i] && storage_[i]->is_leaf()) {
+        const string_t &leaf = storage_[i]->get_leaf();
+        frozen_keywords_.push_back(&leaf);
+        keywords.push_back(nostd::string_view(leaf.data(), leaf.size()));
+      }
+    }
+
+    std::string skip_bytes;
+    for (int i = 1; i < 0x80; ++i) {
+      if (skip_charset_[char_t(static_cast<char>(i))]) {
+        skip_bytes.push_back(static_cast<char>(i));
+      }
+    }
+    if (skip_bytes.size() != skip_charset_.count()) {
+      unfreeze();
+      return false;
+    }
+
+    if (!frozen_.build(gsl::span<const nostd::string_view>(keywords.data(), keywords.size()), is_no_case_,
+                       skip_bytes)) {
+      unfreeze();
+      return false;
+    }
+
+    return true;
+  }
+
+  /**
+   * 是否已经冻结
+   */
+  inline bool is_frozen() const { return !frozen_.empty(); }
+
+  /**
+   * 获取冻结后的双数组自动机，可以在多个线程中只读共享
+   */
+  inline const ac_automation_dfa &get_frozen() const { return frozen_; }
+
   /**
    * 导出AC自动机的关系图（dot格式）
    * @param os 输出流
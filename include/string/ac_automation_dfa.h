@@ -0,0 +1,307 @@
+// Copyright 2026 atframework
+//
+// @file ac_automation_dfa.h
+// @brief 冻结后的AC自动机(双数组Trie)
+// Licensed under the MIT licenses.
+//
+// @note 按UTF-8字节转移，不依赖字符类型；匹配时每个输入字节只需要查一次双数组，失败转移使用循环而不是递归
+// @note 所有数据(头、双数组节点、关键字)都在一块连续内存中，只使用偏移而不保存指针，可以直接写入文件或映射到内存
+// @note 文件格式使用本机字节序，字节序不同时 magic 不匹配，加载失败
+// @note 根节点上使用Teddy风格的SSSE3/AVX2 nibble掩码预过滤，按16/32字节批量跳过不可能是关键字开头的位置
+// @note 匹配语义: 从左到右查找，报告结束位置最早的关键字(同一结束位置取最长的)，
+//       匹配成功后从下一个字节重新开始(结果互不重叠)
+
+#ifndef UTIL_STRING_AC_AUTOMATION_DFA_H
+#define UTIL_STRING_AC_AUTOMATION_DFA_H
+
+#pragma once
+
+#include <config/atframe_utils_build_feature.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gsl/select-gsl.h"
+#include "lock/spin_lock.h"
+#include "nostd/string_view.h"
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace thread {
+class work_stealing_pool;
+}
+
+namespace string {
+
+class ATFRAMEWORK_UTILS_API ac_automation_dfa {
+ public:
+  enum : uint32_t {
+    MAGIC = 0x41444341,  // "ACDA"
+    VERSION = 1,
+    FLAG_NOCASE = 0x01,
+    INVALID_INDEX = 0xFFFFFFFF,
+    PREFILTER_MAX_LENGTH = 3,
+  };
+
+  struct header_t {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t flags;
+    uint32_t total_size;            // 总字节数
+    uint32_t unit_count;            // 双数组长度
+    uint32_t state_count;           // 状态数(包含根节点)
+    uint32_t keyword_count;         // 关键字数量
+    uint32_t units_offset;          // unit_t[unit_count] 的偏移
+    uint32_t keyword_index_offset;  // keyword_index_t[keyword_count] 的偏移
+    uint32_t keyword_data_offset;   // 关键字原始内容的偏移
+    uint32_t prefilter_length;      // 预过滤使用的关键字前缀长度(1-3)，0表示不使用预过滤
+    uint32_t skip_bitmap[8];        // 可跳过的字节
+    uint8_t fold_map[256];          // 输入字节映射(忽略大小写时转小写)
+    // 预过滤掩码 [前缀位置][低4位/高4位][nibble]，每一位表示一组关键字前缀
+    uint8_t prefilter_masks[PREFILTER_MAX_LENGTH][2][16];
+  };
+
+  struct unit_t {
+    uint32_t base;    // 子节点位置 = base + 字节
+    uint32_t check;   // 父节点位置，空闲位置为 INVALID_INDEX
+    uint32_t fail;    // 失败转移
+    uint32_t output;  // 在此结束的最长关键字下标+1(包含失败链上的关键字)，0表示没有
+  };
+
+  struct keyword_index_t {
+    uint32_t offset;
+    uint32_t length;
+  };
+
+  struct match_t {
+    size_t start;
+    size_t length;
+    uint32_t keyword_index;
+  };
+  using value_type = std::vector<match_t>;
+
+  struct batch_chunk_t {
+    size_t begin;        // 输入下标范围 [begin, end)
+    size_t end;
+    size_t slot;         // 处理这个任务的线程使用的临时缓冲区
+    size_t slot_offset;  // 结果在临时缓冲区中的起始位置
+  };
+
+  /**
+   * @brief 批量匹配的结果，所有输入的结果按输入顺序放在同一个数组里
+   * @note 重复使用同一个对象时不需要重新分配内存，包括并行匹配时每个线程的临时缓冲区
+   */
+  struct batch_result_t {
+    value_type matches;
+    std::vector<size_t> offsets;  // 第i个输入的结果是 matches[offsets[i], offsets[i + 1])
+
+    // 并行匹配使用的临时数据
+    std::vector<batch_chunk_t> chunks;
+    std::vector<value_type> scratches;
+
+    inline size_t size() const noexcept { return offsets.empty() ? 0 : offsets.size() - 1; }
+
+    inline gsl::span<const match_t> get(size_t index) const noexcept {
+      if (index + 1 >= offsets.size()) {
+        return gsl::span<const match_t>();
+      }
+      return gsl::span<const match_t>(matches.data() + offsets[index], offsets[index + 1] - offsets[index]);
+    }
+  };
+
+  enum : size_t {
+    BATCH_CHUNK_BYTES = 16384,    // 批量匹配时每个任务至少处理的字节数
+    BATCH_CHUNK_MAX_COUNT = 256,  // 批量匹配时每个任务最多处理的输入数
+  };
+
+ public:
+  ac_automation_dfa() noexcept;
+  ~ac_automation_dfa();
+
+  ac_automation_dfa(const ac_automation_dfa &other);
+  ac_automation_dfa &operator=(const ac_automation_dfa &other);
+  ac_automation_dfa(ac_automation_dfa &&other) noexcept;
+  ac_automation_dfa &operator=(ac_automation_dfa &&other) noexcept;
+
+  /**
+   * @brief 编译关键字列表
+   * @param keywords 关键字列表，路径相同(忽略大小写后)的关键字只保留最后一个
+   * @param nocase 是否忽略ASCII大小写
+   * @param skip_bytes 匹配过程中可以跳过的字节
+   * @param enable_prefilter 是否启用预过滤，关键字前缀过于分散(掩码饱和)时会自动关闭
+   * @return 成功返回true，关键字过多导致超过32位偏移时返回false
+   */
+  bool build(gsl::span<const nostd::string_view> keywords, bool nocase = false,
+             nostd::string_view skip_bytes = nostd::string_view(), bool enable_prefilter = true);
+
+  /**
+   * @brief 直接使用外部内存中的数据(不复制)，比如 mmap 映射的文件
+   * @param data 数据地址，至少4字节对齐，调用者需要保证在 ac_automation_dfa 使用期间有效且不被修改
+   * @param size 数据长度
+   * @param verify 是否检查所有节点的合法性，不可信的数据需要检查，否则损坏的数据可能导致越界访问或死循环
+   * @return 格式或版本不匹配、数据不完整时返回false
+   */
+  bool attach(const void *data, size_t size, bool verify = true);
+
+  /**
+   * @brief 从内存中加载数据(复制一份)
+   * @param data 数据地址，不要求对齐
+   * @param size 数据长度
+   * @return 格式或版本不匹配、数据不完整或数据损坏时返回false
+   */
+  bool load(const void *data, size_t size);
+
+  /**
+   * @brief 写入文件
+   * @note 先写入同目录下的临时文件再原子替换目标文件，替换过程中目标文件始终存在，已经映射了旧文件的进程不受影响
+   */
+  bool save_file(const char *file_path) const;
+
+  void reset() noexcept;
+
+  /**
+   * @brief 匹配目标串，结果追加到output
+   * @return 本次匹配到的数量
+   */
+  size_t match(nostd::string_view content, value_type &output) const;
+
+  value_type match(nostd::string_view content) const;
+
+  /**
+   * @brief 是否包含任意关键字
+   */
+  bool contains(nostd::string_view content) const;
+
+  /**
+   * @brief 批量匹配
+   * @param contents 目标串列表
+   * @param output 输出结果，原有内容会被清空
+   * @param pool 线程池，为空时在当前线程匹配。当前线程总是会参与匹配，所以可以在 pool 的工作线程中调用
+   * @note 输入按字节数分成多个任务，每个参与的线程使用自己的临时缓冲区，最后按输入顺序合并
+   * @return 匹配到的总数
+   */
+  size_t match_batch(gsl::span<const nostd::string_view> contents, batch_result_t &output,
+                     thread::work_stealing_pool *pool = nullptr) const;
+
+  inline bool empty() const noexcept { return nullptr == data_; }
+
+  inline bool is_nocase() const noexcept { return nullptr != data_ && 0 != (get_header()->flags & FLAG_NOCASE); }
+
+  inline bool has_prefilter() const noexcept { return nullptr != data_ && 0 != get_header()->prefilter_length; }
+
+  inline size_t get_state_count() const noexcept { return nullptr == data_ ? 0 : get_header()->state_count; }
+
+  inline size_t get_keyword_count() const noexcept { return nullptr == data_ ? 0 : get_header()->keyword_count; }
+
+  nostd::string_view get_keyword(uint32_t keyword_index) const noexcept;
+
+  /**
+   * @brief 连续内存布局的数据，可以直接写入文件
+   */
+  inline const void *data() const noexcept { return data_; }
+  inline size_t size() const noexcept { return nullptr == data_ ? 0 : get_header()->total_size; }
+
+ private:
+  inline const header_t *get_header() const noexcept { return reinterpret_cast<const header_t *>(data_); }
+
+  size_t find_start(nostd::string_view content, size_t end, uint32_t keyword_index) const noexcept;
+
+  static bool verify_units(const header_t &header, const unit_t *units);
+
+ private:
+  std::vector<uint32_t> storage_;
+  const uint32_t *data_;
+};
+
+/**
+ * @brief 只读的自动机镜像，数据来自 mmap 映射的文件或者进程内构建的 ac_automation_dfa
+ * @note 同一台机器上的多个进程映射同一个文件时，物理内存只有一份
+ */
+class ATFRAMEWORK_UTILS_API ac_automation_dfa_image {
+ public:
+  using ptr_t = std::shared_ptr<const ac_automation_dfa_image>;
+
+ private:
+  struct construct_helper_t {};
+
+ public:
+  explicit ac_automation_dfa_image(construct_helper_t &) noexcept;
+  ~ac_automation_dfa_image();
+
+  ac_automation_dfa_image(const ac_automation_dfa_image &) = delete;
+  ac_automation_dfa_image &operator=(const ac_automation_dfa_image &) = delete;
+
+  /**
+   * @brief 以只读方式映射文件
+   * @param file_path 文件路径
+   * @param verify 是否检查数据合法性，参见 ac_automation_dfa::attach
+   * @param error_message 失败时输出原因，可以为空
+   * @return 失败返回空指针
+   */
+  static ptr_t open_file(const char *file_path, bool verify = true, std::string *error_message = nullptr);
+
+  /**
+   * @brief 使用进程内构建的自动机
+   */
+  static ptr_t create(ac_automation_dfa &&dfa);
+
+  inline const ac_automation_dfa &get() const noexcept { return dfa_; }
+  inline const ac_automation_dfa *operator->() const noexcept { return &dfa_; }
+
+  inline bool is_mapped() const noexcept { return nullptr != mapped_address_; }
+
+ private:
+  ac_automation_dfa dfa_;
+  void *mapped_address_;
+  size_t mapped_size_;
+#if defined(_WIN32)
+  void *file_handle_;
+  void *mapping_handle_;
+#endif
+};
+
+/**
+ * @brief 自动机热更新
+ * @note 匹配线程用 get() 拿到当前镜像的快照后在锁外匹配，更新时只在交换指针时短暂持锁，
+ *       旧镜像在最后一个使用者释放后才解除映射
+ */
+class ATFRAMEWORK_UTILS_API ac_automation_dfa_holder {
+ public:
+  ac_automation_dfa_holder() noexcept;
+  ~ac_automation_dfa_holder();
+
+  ac_automation_dfa_holder(const ac_automation_dfa_holder &) = delete;
+  ac_automation_dfa_holder &operator=(const ac_automation_dfa_holder &) = delete;
+
+  ac_automation_dfa_image::ptr_t get() const noexcept;
+
+  /**
+   * @brief 替换当前镜像
+   * @return 旧的镜像
+   */
+  ac_automation_dfa_image::ptr_t exchange(ac_automation_dfa_image::ptr_t image) noexcept;
+
+  /**
+   * @brief 映射文件并替换当前镜像，失败时保留当前镜像
+   */
+  bool reload_file(const char *file_path, bool verify = true, std::string *error_message = nullptr);
+
+  /**
+   * @brief 每次替换后加1，可以用来判断是否需要刷新缓存
+   */
+  inline uint64_t get_generation() const noexcept { return generation_.load(std::memory_order_acquire); }
+
+ private:
+  mutable lock::spin_lock lock_;
+  ac_automation_dfa_image::ptr_t image_;
+  std::atomic<uint64_t> generation_;
+};
+
+}  // namespace string
+ATFRAMEWORK_UTILS_NAMESPACE_END
+
+#endif
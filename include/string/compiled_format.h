@@ -0,0 +1,567 @@
+// Copyright 2026 atframework
+//
+// @file compiled_format.h
+// @brief 编译期解析的格式化字符串
+// Licensed under the MIT licenses.
+//
+// @note 格式字符串在构造时(constexpr)解析为字面量和参数字段，格式化时不再解析，也不依赖 fmt 或 std::format
+// @note 支持的语法是 fmt 的子集: {} {:x} {:X} {:8} {:08} {:08x}，以及转义 {{ 和 }}，只支持按顺序引用参数
+// @note 定长类型(整数、浮点数、bool、char、指针)的最大输出长度在编译期确定，字符串按实际长度计算，
+//       输出缓冲区足够时直接写入，不需要逐个字符检查边界，不足时截断
+// @note 需要声明为 constexpr 变量才能保证在编译期解析和检查错误，例如:
+//       static constexpr auto kLoginFormat = make_compiled_format<int64_t, nostd::string_view>("user {} login {}");
+
+#ifndef UTIL_STRING_COMPILED_FORMAT_H
+#define UTIL_STRING_COMPILED_FORMAT_H
+
+#pragma once
+
+#include <config/atframe_utils_build_feature.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "common/string_oprs.h"
+#include "nostd/string_view.h"
+#include "nostd/type_traits.h"
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace string {
+namespace details {
+
+enum class compiled_format_type_t : uint8_t {
+  kDefault = 0,
+  kLowerHex,
+  kUpperHex,
+};
+
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY compiled_format_field_t {
+  size_t literal_end;  // 这个参数之前的字面量在 text 中的结束位置
+  size_t width;
+  char fill;
+  compiled_format_type_t type;
+};
+
+enum : size_t {
+  COMPILED_FORMAT_MAX_WIDTH = 256,
+  COMPILED_FORMAT_NUMBER_BUFFER_SIZE = COMPILED_FORMAT_MAX_WIDTH + 64,
+};
+
+// 常量表达式里调用非constexpr函数会导致编译失败，用来在编译期报告格式错误
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline void compiled_format_error(const char *) noexcept {}
+
+// 宽度不足时补齐，数字右对齐，字符串左对齐
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline char *compiled_format_pad(char *begin, char *end,
+                                                                const compiled_format_field_t &field,
+                                                                bool right_align) noexcept {
+  size_t written = static_cast<size_t>(end - begin);
+  if (written >= field.width) {
+    return end;
+  }
+
+  size_t pad = field.width - written;
+  if (!right_align) {
+    memset(end, ' ', pad);
+    return end + pad;
+  }
+
+  // 补0时放在符号后面
+  char *digits = begin;
+  if ('0' == field.fill && written > 0 && '-' == *begin) {
+    ++digits;
+  }
+  memmove(digits + pad, digits, static_cast<size_t>(end - digits));
+  memset(digits, field.fill, pad);
+  return end + pad;
+}
+
+template <class T>
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline char *compiled_format_write_hex(char *out, T value, bool upper_case) noexcept {
+  const char *digits = upper_case ? "0123456789ABCDEF" : "0123456789abcdef";
+  char buffer[sizeof(T) * 2];
+  char *cur = buffer + sizeof(buffer);
+  do {
+    *(--cur) = digits[static_cast<size_t>(value & 0x0F)];
+    value = static_cast<T>(value >> 4);
+  } while (0 != value);
+
+  size_t len = static_cast<size_t>(buffer + sizeof(buffer) - cur);
+  memcpy(out, cur, len);
+  return out + len;
+}
+
+template <class T, class = void>
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY compiled_format_arg;
+
+template <class T>
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY
+compiled_format_arg<T, nostd::enable_if_t<std::is_integral<T>::value && !std::is_same<T, bool>::value &&
+                                          !std::is_same<T, char>::value>> {
+  using unsigned_type = typename std::make_unsigned<T>::type;
+
+  static constexpr const bool is_string = false;
+  // 符号 + 十进制数字，十六进制时不会更长
+  static constexpr const size_t max_size = static_cast<size_t>(std::numeric_limits<T>::digits10) + 2;
+
+  static inline size_t size(const T &) noexcept { return max_size; }
+
+  static inline char *write(char *out, const T &value, const compiled_format_field_t &field) noexcept {
+    if (compiled_format_type_t::kDefault == field.type) {
+      return out + int2str_helper<typename std::make_signed<T>::type>::call(out, max_size, value);
+    }
+
+    unsigned_type abs_value = static_cast<unsigned_type>(value);
+    if (std::is_signed<T>::value && value < 0) {
+      *(out++) = '-';
+      abs_value = static_cast<unsigned_type>(0 - abs_value);
+    }
+    return compiled_format_write_hex(out, abs_value, compiled_format_type_t::kUpperHex == field.type);
+  }
+};
+
+template <>
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY compiled_format_arg<bool> {
+  static constexpr const bool is_string = false;
+  static constexpr const size_t max_size = 5;
+
+  static inline size_t size(const bool &) noexcept { return max_size; }
+
+  static inline char *write(char *out, const bool &value, const compiled_format_field_t &) noexcept {
+    if (value) {
+      memcpy(out, "true", 4);
+      return out + 4;
+    }
+    memcpy(out, "false", 5);
+    return out + 5;
+  }
+};
+
+template <>
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY compiled_format_arg<char> {
+  static constexpr const bool is_string = false;
+  static constexpr const size_t max_size = 1;
+
+  static inline size_t size(const char &) noexcept { return max_size; }
+
+  static inline char *write(char *out, const char &value, const compiled_format_field_t &) noexcept {
+    *out = value;
+    return out + 1;
+  }
+};
+
+template <class T>
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY compiled_format_arg<T, nostd::enable_if_t<std::is_floating_point<T>::value>> {
+  static constexpr const bool is_string = false;
+  // 符号 + 有效数字 + 小数点 + 指数，比如 -1.7976931348623157e+308
+  static constexpr const size_t max_size = static_cast<size_t>(std::numeric_limits<double>::max_digits10) + 8;
+
+  static inline size_t size(const T &) noexcept { return max_size; }
+
+  static inline char *write(char *out, const T &value, const compiled_format_field_t &) noexcept {
+    // long double 也按 double 输出
+    using float_type = typename std::conditional<std::is_same<T, float>::value, float, double>::type;
+    return out + float2str(out, max_size, static_cast<float_type>(value));
+  }
+};
+
+template <class T>
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY compiled_format_arg<
+    T *, nostd::enable_if_t<!std::is_same<nostd::remove_cvref_t<T>, char>::value>> {
+  static constexpr const bool is_string = false;
+  static constexpr const size_t max_size = 2 + sizeof(void *) * 2;
+
+  static inline size_t size(T *const &) noexcept { return max_size; }
+
+  static inline char *write(char *out, T *const &value, const compiled_format_field_t &field) noexcept {
+    *(out++) = '0';
+    *(out++) = 'x';
+    return compiled_format_write_hex(out, reinterpret_cast<uintptr_t>(value),
+                                     compiled_format_type_t::kUpperHex == field.type);
+  }
+};
+
+template <>
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY compiled_format_arg<nostd::string_view> {
+  static constexpr const bool is_string = true;
+  static constexpr const size_t max_size = 0;  // 不定长
+
+  static inline size_t size(const nostd::string_view &value) noexcept { return value.size(); }
+
+  static inline nostd::string_view to_string_view(const nostd::string_view &value) noexcept { return value; }
+
+  static inline char *write(char *out, const nostd::string_view &value, const compiled_format_field_t &) noexcept {
+    if (!value.empty()) {
+      memcpy(out, value.data(), value.size());
+    }
+    return out + value.size();
+  }
+};
+
+template <>
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY compiled_format_arg<std::string> {
+  static constexpr const bool is_string = true;
+  static constexpr const size_t max_size = 0;
+
+  static inline size_t size(const std::string &value) noexcept { return value.size(); }
+
+  static inline nostd::string_view to_string_view(const std::string &value) noexcept { return value; }
+
+  static inline char *write(char *out, const std::string &value, const compiled_format_field_t &field) noexcept {
+    return compiled_format_arg<nostd::string_view>::write(out, value, field);
+  }
+};
+
+template <class T>
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY compiled_format_arg<
+    T *, nostd::enable_if_t<std::is_same<nostd::remove_cvref_t<T>, char>::value>> {
+  static constexpr const bool is_string = true;
+  static constexpr const size_t max_size = 0;
+
+  static inline size_t size(T *const &value) noexcept { return nullptr == value ? 0 : strlen(value); }
+
+  static inline nostd::string_view to_string_view(T *const &value) noexcept {
+    return nullptr == value ? nostd::string_view() : nostd::string_view(value);
+  }
+
+  static inline char *write(char *out, T *const &value, const compiled_format_field_t &field) noexcept {
+    if (nullptr == value) {
+      return out;
+    }
+    return compiled_format_arg<nostd::string_view>::write(out, nostd::string_view(value), field);
+  }
+};
+
+template <class T>
+using compiled_format_arg_t = compiled_format_arg<typename std::decay<T>::type>;
+
+template <class T>
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline nostd::string_view compiled_format_to_string_view(const T &value,
+                                                                                        std::true_type) noexcept {
+  return compiled_format_arg_t<T>::to_string_view(value);
+}
+
+template <class T>
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline nostd::string_view compiled_format_to_string_view(const T &,
+                                                                                        std::false_type) noexcept {
+  return nostd::string_view();
+}
+
+}  // namespace details
+
+/**
+ * @brief 编译期解析的格式化字符串
+ * @note 参数类型在声明时确定，格式化时按 const TARGS& 传入
+ */
+template <size_t N, class... TARGS>
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY compiled_format {
+ public:
+  using field_t = details::compiled_format_field_t;
+
+  enum : size_t {
+    ARG_COUNT = sizeof...(TARGS),
+  };
+
+ public:
+  constexpr explicit compiled_format(const char (&fmt_text)[N])
+      : text_{}, text_size_(0), fixed_size_(0), fields_{}, valid_(true) {
+    parse(fmt_text);
+  }
+
+  /**
+   * @brief 格式字符串是否合法，constexpr 变量格式错误时直接编译失败
+   */
+  constexpr bool valid() const noexcept { return valid_; }
+
+  /**
+   * @brief 字面量部分(转义后)的长度
+   */
+  constexpr size_t literal_size() const noexcept { return text_size_; }
+
+  /**
+   * @brief 所有参数都是定长类型时的最大输出长度
+   */
+  constexpr size_t max_size() const noexcept {
+    static_assert(!any_string(), "max_size() requires all arguments to be fixed width types");
+    return fixed_size_;
+  }
+
+  /**
+   * @brief 计算输出长度的上限(定长类型取最大长度，字符串取实际长度)
+   */
+  inline size_t max_formatted_size(const TARGS &...args) const noexcept {
+    return max_formatted_size_impl(std::index_sequence_for<TARGS...>{}, args...);
+  }
+
+  /**
+   * @brief 格式化到缓冲区，不会写入结尾的0
+   * @param output 输出缓冲区
+   * @param output_size 输出缓冲区长度
+   * @return 写入的长度，缓冲区不足时截断
+   */
+  inline size_t format_to(char *output, size_t output_size, const TARGS &...args) const noexcept {
+    if (!valid_ || nullptr == output) {
+      return 0;
+    }
+
+    // 缓冲区足够时直接写入，不需要检查边界
+    if (output_size >= max_formatted_size(args...)) {
+      return static_cast<size_t>(write_unchecked(output, std::index_sequence_for<TARGS...>{}, args...) - output);
+    }
+
+    return static_cast<size_t>(
+        write_checked(output, output + output_size, std::index_sequence_for<TARGS...>{}, args...) - output);
+  }
+
+  /**
+   * @brief 格式化并追加到output
+   * @return 追加的长度
+   */
+  inline size_t format_to(std::string &output, const TARGS &...args) const {
+    if (!valid_) {
+      return 0;
+    }
+
+    size_t offset = output.size();
+    output.resize(offset + max_formatted_size(args...));
+    size_t ret = static_cast<size_t>(
+        write_unchecked(&output[0] + offset, std::index_sequence_for<TARGS...>{}, args...) - (&output[0] + offset));
+    output.resize(offset + ret);
+    return ret;
+  }
+
+  inline std::string format(const TARGS &...args) const {
+    std::string ret;
+    format_to(ret, args...);
+    return ret;
+  }
+
+ private:
+  static constexpr bool any_string() noexcept {
+    // C++14 constexpr 不支持折叠表达式，使用数组
+    const bool is_string[] = {false, details::compiled_format_arg_t<TARGS>::is_string...};
+    for (size_t i = 0; i < sizeof(is_string) / sizeof(is_string[0]); ++i) {
+      if (is_string[i]) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  constexpr void on_error(const char *message) {
+    valid_ = false;
+    details::compiled_format_error(message);
+  }
+
+  constexpr void parse(const char (&fmt_text)[N]) {
+    const size_t max_sizes[] = {0, details::compiled_format_arg_t<TARGS>::max_size...};
+
+    // 字符串字面量最后的0不属于格式字符串
+    size_t length = N;
+    if (length > 0 && 0 == fmt_text[length - 1]) {
+      --length;
+    }
+
+    size_t field_index = 0;
+    size_t i = 0;
+    while (i < length) {
+      char c = fmt_text[i];
+      if ('}' == c) {
+        if (i + 1 < length && '}' == fmt_text[i + 1]) {
+          text_[text_size_++] = '}';
+          i += 2;
+          continue;
+        }
+        on_error("unmatched '}' in format string");
+        return;
+      }
+
+      if ('{' != c) {
+        text_[text_size_++] = c;
+        ++i;
+        continue;
+      }
+
+      if (i + 1 < length && '{' == fmt_text[i + 1]) {
+        text_[text_size_++] = '{';
+        i += 2;
+        continue;
+      }
+
+      if (field_index >= ARG_COUNT) {
+        on_error("too many replacement fields in format string");
+        return;
+      }
+
+      field_t &field = fields_[field_index];
+      field.literal_end = text_size_;
+      field.width = 0;
+      field.fill = ' ';
+      field.type = details::compiled_format_type_t::kDefault;
+
+      ++i;
+      if (i < length && ':' == fmt_text[i]) {
+        ++i;
+        if (i < length && '0' == fmt_text[i]) {
+          field.fill = '0';
+          ++i;
+        }
+        while (i < length && fmt_text[i] >= '0' && fmt_text[i] <= '9') {
+          field.width = field.width * 10 + static_cast<size_t>(fmt_text[i] - '0');
+          if (field.width > details::COMPILED_FORMAT_MAX_WIDTH) {
+            on_error("width is too large in format string");
+            return;
+          }
+          ++i;
+        }
+        if (i < length && 'x' == fmt_text[i]) {
+          field.type = details::compiled_format_type_t::kLowerHex;
+          ++i;
+        } else if (i < length && 'X' == fmt_text[i]) {
+          field.type = details::compiled_format_type_t::kUpperHex;
+          ++i;
+        } else if (i < length && 'd' == fmt_text[i]) {
+          ++i;
+        }
+      }
+
+      if (i >= length || '}' != fmt_text[i]) {
+        on_error("invalid replacement field in format string");
+        return;
+      }
+      ++i;
+
+      // 不定长类型的 max_size 为0，只累加宽度，实际长度在格式化时计算
+      size_t field_max_size = max_sizes[field_index + 1];
+      fixed_size_ += field_max_size > field.width ? field_max_size : field.width;
+      ++field_index;
+    }
+
+    if (field_index != ARG_COUNT) {
+      on_error("not enough replacement fields in format string");
+      return;
+    }
+
+    fixed_size_ += text_size_;
+  }
+
+  template <size_t... I>
+  inline size_t max_formatted_size_impl(std::index_sequence<I...>, const TARGS &...args) const noexcept {
+    size_t ret = fixed_size_;
+    using expander = int[];
+    (void)expander{0, (ret += details::compiled_format_arg_t<TARGS>::is_string
+                                  ? details::compiled_format_arg_t<TARGS>::size(args)
+                                  : 0,
+                       0)...};
+    return ret;
+  }
+
+  template <size_t I, class T>
+  inline char *write_field_unchecked(char *out, size_t &literal_pos, const T &arg) const noexcept {
+    const field_t &field = fields_[I];
+    if (field.literal_end > literal_pos) {
+      memcpy(out, text_ + literal_pos, field.literal_end - literal_pos);
+      out += field.literal_end - literal_pos;
+      literal_pos = field.literal_end;
+    }
+
+    char *end = details::compiled_format_arg_t<T>::write(out, arg, field);
+    if (field.width > 0) {
+      end = details::compiled_format_pad(out, end, field, !details::compiled_format_arg_t<T>::is_string);
+    }
+    return end;
+  }
+
+  template <size_t... I>
+  inline char *write_unchecked(char *out, std::index_sequence<I...>, const TARGS &...args) const noexcept {
+    size_t literal_pos = 0;
+    using expander = int[];
+    (void)expander{0, (out = write_field_unchecked<I>(out, literal_pos, args), 0)...};
+    if (text_size_ > literal_pos) {
+      memcpy(out, text_ + literal_pos, text_size_ - literal_pos);
+      out += text_size_ - literal_pos;
+    }
+    return out;
+  }
+
+  static inline char *append_checked(char *out, char *end, const char *data, size_t size) noexcept {
+    size_t left = static_cast<size_t>(end - out);
+    if (size > left) {
+      size = left;
+    }
+    if (size > 0) {
+      memcpy(out, data, size);
+    }
+    return out + size;
+  }
+
+  template <size_t I, class T>
+  inline char *write_field_checked(char *out, char *end, size_t &literal_pos, const T &arg) const noexcept {
+    using arg_type = details::compiled_format_arg_t<T>;
+    const field_t &field = fields_[I];
+    if (field.literal_end > literal_pos) {
+      out = append_checked(out, end, text_ + literal_pos, field.literal_end - literal_pos);
+      literal_pos = field.literal_end;
+    }
+
+    size_t field_size = arg_type::is_string ? arg_type::size(arg) : arg_type::max_size;
+    if (field_size < field.width) {
+      field_size = field.width;
+    }
+    if (field_size <= static_cast<size_t>(end - out)) {
+      return write_field_unchecked<I>(out, literal_pos, arg);
+    }
+
+    if (arg_type::is_string) {
+      // 字符串在这里一定会被截断，不需要补齐
+      nostd::string_view value =
+          details::compiled_format_to_string_view(arg, std::integral_constant<bool, arg_type::is_string>());
+      return append_checked(out, end, value.data(), value.size());
+    }
+
+    char buffer[details::COMPILED_FORMAT_NUMBER_BUFFER_SIZE];
+    char *buffer_end = arg_type::write(buffer, arg, field);
+    if (field.width > 0) {
+      buffer_end = details::compiled_format_pad(buffer, buffer_end, field, true);
+    }
+    return append_checked(out, end, buffer, static_cast<size_t>(buffer_end - buffer));
+  }
+
+  template <size_t... I>
+  inline char *write_checked(char *out, char *end, std::index_sequence<I...>, const TARGS &...args) const noexcept {
+    size_t literal_pos = 0;
+    using expander = int[];
+    (void)expander{0, (out = write_field_checked<I>(out, end, literal_pos, args), 0)...};
+    if (text_size_ > literal_pos) {
+      out = append_checked(out, end, text_ + literal_pos, text_size_ - literal_pos);
+    }
+    return out;
+  }
+
+ private:
+  char text_[N > 0 ? N : 1];
+  size_t text_size_;
+  size_t fixed_size_;  // 字面量长度 + 定长参数的最大长度 + 不定长参数的宽度
+  field_t fields_[ARG_COUNT > 0 ? static_cast<size_t>(ARG_COUNT) : 1];
+  bool valid_;
+};
+
+/**
+ * @brief 创建编译期解析的格式化字符串
+ * @note 需要赋值给 constexpr 变量才能保证在编译期解析
+ */
+template <class... TARGS, size_t N>
+ATFRAMEWORK_UTILS_API_HEAD_ONLY constexpr compiled_format<N, TARGS...> make_compiled_format(
+    const char (&fmt_text)[N]) {
+  return compiled_format<N, TARGS...>(fmt_text);
+}
+
+}  // namespace string
+ATFRAMEWORK_UTILS_NAMESPACE_END
+
+#endif
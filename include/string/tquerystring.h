@@ -14,11 +14,13 @@
 // @history
 //      2014.05.20 增加类似php的rawurlencode和urlencode函数
 //      2020.08.14 增加优先使用unordered_map
+//      2026.10.19 增加写入调用者缓冲区的 *_to 接口、精确的输出长度计算和不复制数据的 query_string_tokenizer
 
 #pragma once
 
 #include <config/atframe_utils_build_feature.h>
 
+#include <stdint.h>
 #include <cstddef>
 #include <memory>
 #include <sstream>
@@ -26,6 +28,9 @@
 #include <unordered_map>
 #include <vector>
 
+#include "gsl/select-gsl.h"
+#include "nostd/string_view.h"
+
 ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
 namespace uri {
 /**
@@ -94,6 +99,176 @@ ATFRAMEWORK_UTILS_API std::string encode_url(const char *content, std::size_t sz
  */
 ATFRAMEWORK_UTILS_API std::string decode_url(const char *uri, std::size_t sz = 0);
 
+/**
+ * @brief 编码/解码规则
+ */
+enum class uri_codec_t : uint8_t {
+  kUri = 0,       // encode_uri/decode_uri
+  kUriComponent,  // encode_uri_component/decode_uri_component
+  kRawUrl,        // raw_encode_url/raw_decode_url
+  kUrl,           // encode_url/decode_url
+};
+
+/**
+ * @brief 计算编码后的精确长度
+ * @param [in] codec   编码规则
+ * @param [in] content 待编码内容
+ * @return 编码后的长度
+ */
+ATFRAMEWORK_UTILS_API std::size_t encoded_size(uri_codec_t codec, nostd::string_view content) noexcept;
+
+/**
+ * @brief 编码到调用者的缓冲区
+ * @note 不需要转义的连续字节使用SIMD扫描后整段复制
+ * @param [in] codec       编码规则
+ * @param [out] output      输出缓冲区
+ * @param [in] output_size 输出缓冲区长度
+ * @param [in] content     待编码内容
+ * @return 编码后的长度，大于 output_size 时不写入任何数据
+ */
+ATFRAMEWORK_UTILS_API std::size_t encode_to(uri_codec_t codec, char *output, std::size_t output_size,
+                                            nostd::string_view content) noexcept;
+
+/**
+ * @brief 编码并追加到 output 尾部，只分配一次内存
+ * @param [in] codec   编码规则
+ * @param [out] output  输出内容
+ * @param [in] content 待编码内容
+ */
+ATFRAMEWORK_UTILS_API void encode_to(uri_codec_t codec, std::string &output, nostd::string_view content);
+
+/**
+ * @brief 计算解码后的精确长度
+ * @param [in] codec 解码规则
+ * @param [in] uri   待解码内容
+ * @return 解码后的长度
+ */
+ATFRAMEWORK_UTILS_API std::size_t decoded_size(uri_codec_t codec, nostd::string_view uri) noexcept;
+
+/**
+ * @brief 解码到调用者的缓冲区
+ * @param [in] codec       解码规则
+ * @param [out] output      输出缓冲区
+ * @param [in] output_size 输出缓冲区长度
+ * @param [in] uri         待解码内容
+ * @return 解码后的长度，大于 output_size 时不写入任何数据
+ */
+ATFRAMEWORK_UTILS_API std::size_t decode_to(uri_codec_t codec, char *output, std::size_t output_size,
+                                            nostd::string_view uri) noexcept;
+
+/**
+ * @brief 解码并追加到 output 尾部，只分配一次内存
+ * @param [in] codec  解码规则
+ * @param [out] output 输出内容
+ * @param [in] uri    待解码内容
+ */
+ATFRAMEWORK_UTILS_API void decode_to(uri_codec_t codec, std::string &output, nostd::string_view uri);
+
+// 各编码规则对应的 *_to 接口，语义同上
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline std::size_t encode_uri_to(char *output, std::size_t output_size,
+                                                                 nostd::string_view content) noexcept {
+  return encode_to(uri_codec_t::kUri, output, output_size, content);
+}
+
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline void encode_uri_to(std::string &output, nostd::string_view content) {
+  encode_to(uri_codec_t::kUri, output, content);
+}
+
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline std::size_t decode_uri_to(char *output, std::size_t output_size,
+                                                                 nostd::string_view uri) noexcept {
+  return decode_to(uri_codec_t::kUri, output, output_size, uri);
+}
+
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline void decode_uri_to(std::string &output, nostd::string_view uri) {
+  decode_to(uri_codec_t::kUri, output, uri);
+}
+
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline std::size_t encode_uri_component_to(char *output, std::size_t output_size,
+                                                                           nostd::string_view content) noexcept {
+  return encode_to(uri_codec_t::kUriComponent, output, output_size, content);
+}
+
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline void encode_uri_component_to(std::string &output,
+                                                                    nostd::string_view content) {
+  encode_to(uri_codec_t::kUriComponent, output, content);
+}
+
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline std::size_t decode_uri_component_to(char *output, std::size_t output_size,
+                                                                           nostd::string_view uri) noexcept {
+  return decode_to(uri_codec_t::kUriComponent, output, output_size, uri);
+}
+
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline void decode_uri_component_to(std::string &output, nostd::string_view uri) {
+  decode_to(uri_codec_t::kUriComponent, output, uri);
+}
+
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline std::size_t raw_encode_url_to(char *output, std::size_t output_size,
+                                                                     nostd::string_view content) noexcept {
+  return encode_to(uri_codec_t::kRawUrl, output, output_size, content);
+}
+
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline void raw_encode_url_to(std::string &output, nostd::string_view content) {
+  encode_to(uri_codec_t::kRawUrl, output, content);
+}
+
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline std::size_t raw_decode_url_to(char *output, std::size_t output_size,
+                                                                     nostd::string_view uri) noexcept {
+  return decode_to(uri_codec_t::kRawUrl, output, output_size, uri);
+}
+
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline void raw_decode_url_to(std::string &output, nostd::string_view uri) {
+  decode_to(uri_codec_t::kRawUrl, output, uri);
+}
+
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline std::size_t encode_url_to(char *output, std::size_t output_size,
+                                                                 nostd::string_view content) noexcept {
+  return encode_to(uri_codec_t::kUrl, output, output_size, content);
+}
+
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline void encode_url_to(std::string &output, nostd::string_view content) {
+  encode_to(uri_codec_t::kUrl, output, content);
+}
+
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline std::size_t decode_url_to(char *output, std::size_t output_size,
+                                                                 nostd::string_view uri) noexcept {
+  return decode_to(uri_codec_t::kUrl, output, output_size, uri);
+}
+
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline void decode_url_to(std::string &output, nostd::string_view uri) {
+  decode_to(uri_codec_t::kUrl, output, uri);
+}
+
+/**
+ * @brief 不复制数据的querystring分词器
+ * @note 返回的key和value都指向原始内容，并且没有解码，可以配合 decode_uri_component_to 使用。
+ *       分隔规则和 tquerystring::decode 一致: spliter 中的每个字符都是分隔符，每段的最后一个 = 分隔key和value
+ */
+class ATFRAMEWORK_UTILS_API query_string_tokenizer {
+ public:
+  struct token_t {
+    nostd::string_view record;  // 整段内容
+    nostd::string_view key;
+    nostd::string_view value;
+    bool has_value;  // 是否有 =
+  };
+
+ public:
+  explicit query_string_tokenizer(nostd::string_view content, nostd::string_view spliter = "?#&") noexcept;
+
+  /**
+   * @brief 读取下一段
+   * @note 连续的分隔符会产生空的段
+   * @return 没有更多内容时返回false
+   */
+  bool next(token_t &output) noexcept;
+
+  inline nostd::string_view get_remain() const noexcept { return content_; }
+
+ private:
+  nostd::string_view content_;
+  bool spliter_map_[256];
+};
+
 /**
  * @brief 字符串转换为任意类型
  * @param [in] str     字符串表示的数据内容
@@ -527,5 +702,97 @@ class tquerystring : public types::item_object {
    */
   ATFRAMEWORK_UTILS_API types::item_object::ptr_type create_object();
 };
+
+/**
+ * @brief 使用内存池的只读querystring DOM，解析规则和 tquerystring::decode 一致
+ * @note 节点、key和value都分配在按块增长的内存池中，clear 或析构时一次释放。
+ *       不需要解码的key和value直接引用 decode 传入的内容，所以在使用期间传入的内容必须有效
+ * @note 子节点使用链表保存，保留插入顺序。子节点较多的Object节点会在内存池中建立开放寻址的哈希索引，按key查找是O(1)的
+ */
+class ATFRAMEWORK_UTILS_API tquerystring_arena {
+ public:
+  struct node_t {
+    types::ITEM_TYPE type;     // ITEM_TYPE_STRING, ITEM_TYPE_ARRAY 或 ITEM_TYPE_OBJECT
+    nostd::string_view key;    // 在父节点中的key，数组元素为空
+    nostd::string_view value;  // ITEM_TYPE_STRING 的值
+    node_t *first_child;
+    node_t *last_child;
+    node_t *next_sibling;
+    std::size_t child_count;
+    node_t **child_index;          // 子节点哈希索引，子节点少于 CHILD_INDEX_MIN_COUNT 时为空
+    std::size_t child_index_mask;  // 哈希索引槽位数-1
+
+    /**
+     * @brief 查找子节点
+     * @return 不存在返回nullptr
+     */
+    ATFRAMEWORK_UTILS_API const node_t *get(nostd::string_view child_key) const noexcept;
+
+    /**
+     * @brief 按下标获取数组元素
+     * @return 不存在返回nullptr
+     */
+    ATFRAMEWORK_UTILS_API const node_t *at(std::size_t index) const noexcept;
+  };
+
+  enum : std::size_t {
+    DEFAULT_BLOCK_SIZE = 4096,
+    CHILD_INDEX_MIN_COUNT = 8,  // Object节点的子节点数达到这个值后建立哈希索引
+  };
+
+ public:
+  /**
+   * @param [in] block_size 内存池每块的大小，超过一半块大小的分配单独占用一块
+   * @param [in] spliter    分隔符，每个字符都是单独的分隔符
+   */
+  explicit tquerystring_arena(std::size_t block_size = DEFAULT_BLOCK_SIZE, nostd::string_view spliter = "?#&");
+  ~tquerystring_arena();
+
+  tquerystring_arena(const tquerystring_arena &) = delete;
+  tquerystring_arena &operator=(const tquerystring_arena &) = delete;
+
+  /**
+   * @breif 解码数据并追加到当前DOM
+   * @param [in] content 数据内容，使用期间必须有效
+   * @return 最后一段解码成功返回true，和 tquerystring::decode 一致
+   */
+  bool decode(nostd::string_view content);
+
+  /**
+   * @breif 清空所有节点，保留第一块内存供下次使用
+   */
+  void clear() noexcept;
+
+  inline const node_t &get_root() const noexcept { return root_; }
+
+  inline const node_t *get(nostd::string_view key) const noexcept { return root_.get(key); }
+
+  inline bool empty() const noexcept { return 0 == root_.child_count; }
+
+  inline std::size_t size() const noexcept { return root_.child_count; }
+
+  /**
+   * @breif 内存池已分配的总字节数
+   */
+  std::size_t get_allocated_size() const noexcept;
+
+ private:
+  struct block_t;
+
+  void *allocate(std::size_t sz, std::size_t align);
+  node_t *create_node(types::ITEM_TYPE type, nostd::string_view key);
+  void append_child(node_t &parent, node_t *child);
+  void rebuild_child_index(node_t &parent, std::size_t slot_count);
+  nostd::string_view decode_component(nostd::string_view raw);
+  bool decode_record(nostd::string_view record);
+  bool parse(node_t &parent, gsl::span<const nostd::string_view> keys, std::size_t index, nostd::string_view value);
+
+ private:
+  block_t *blocks_;
+  std::size_t block_size_;
+  std::string spliter_;
+  node_t root_;
+  std::vector<nostd::string_view> key_cache_;
+};
 ATFRAMEWORK_UTILS_NAMESPACE_END
 
@@ -0,0 +1,115 @@
+// Copyright 2026 atframework
+//
+// @file utf8_utils.h
+// @brief UTF-8批量处理: 校验、计数、截断和UTF-16/UTF-32互转
+// Licensed under the MIT licenses.
+//
+// @note 校验使用按nibble查表的SSSE3/AVX2算法(每16/32字节三次查表)，计数和截断使用SSE2/AVX2统计非后续字节，
+//       转码时ASCII部分批量展开/压缩，不支持SIMD时使用标量实现
+// @note 校验规则遵循 RFC 3629: 不允许过长编码、代理区(U+D800-U+DFFF)和超过U+10FFFF的码点
+// @note 计数、截断和长度计算函数不校验输入，输入不合法时结果不确定但不会越界
+
+#ifndef UTIL_STRING_UTF8_UTILS_H
+#define UTIL_STRING_UTF8_UTILS_H
+
+#pragma once
+
+#include <config/atframe_utils_build_feature.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+
+#include "nostd/string_view.h"
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace string {
+
+enum : size_t {
+  UTF_INVALID_LENGTH = static_cast<size_t>(-1),  // 输入不是合法的编码
+};
+
+/**
+ * @brief 检查是否是合法的UTF-8
+ */
+ATFRAMEWORK_UTILS_API bool utf8_validate(nostd::string_view input) noexcept;
+
+/**
+ * @brief 查找第一个不合法的UTF-8字符
+ * @return 不合法字符的开始位置，全部合法时返回 input.size()
+ */
+ATFRAMEWORK_UTILS_API size_t utf8_find_invalid(nostd::string_view input) noexcept;
+
+/**
+ * @brief 计算码点数量
+ */
+ATFRAMEWORK_UTILS_API size_t utf8_count(nostd::string_view input) noexcept;
+
+/**
+ * @brief 计算最多保留 max_code_points 个码点时的字节长度，不会截断到字符中间
+ */
+ATFRAMEWORK_UTILS_API size_t utf8_truncate_position(nostd::string_view input, size_t max_code_points) noexcept;
+
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline nostd::string_view utf8_truncate(nostd::string_view input,
+                                                                      size_t max_code_points) noexcept {
+  return input.substr(0, utf8_truncate_position(input, max_code_points));
+}
+
+/**
+ * @brief 转为UTF-16后的长度(char16_t个数)
+ */
+ATFRAMEWORK_UTILS_API size_t utf16_length_from_utf8(nostd::string_view input) noexcept;
+
+/**
+ * @brief 转为UTF-8后的长度(字节数)，未配对的代理项按3字节计算
+ */
+ATFRAMEWORK_UTILS_API size_t utf8_length_from_utf16(nostd::basic_string_view<char16_t> input) noexcept;
+
+/**
+ * @brief 转为UTF-8后的长度(字节数)，超出范围的码点按4字节计算
+ */
+ATFRAMEWORK_UTILS_API size_t utf8_length_from_utf32(nostd::basic_string_view<char32_t> input) noexcept;
+
+/**
+ * @brief UTF-8转UTF-16
+ * @param input 输入
+ * @param output 输出缓冲区
+ * @param output_size 输出缓冲区长度
+ * @return 输入不合法时返回 UTF_INVALID_LENGTH；否则返回需要的长度，大于 output_size 时不写入任何数据
+ */
+ATFRAMEWORK_UTILS_API size_t utf8_to_utf16(nostd::string_view input, char16_t *output, size_t output_size) noexcept;
+
+/**
+ * @brief UTF-8转UTF-16，追加到output
+ * @return 输入不合法时返回false，output不变
+ */
+ATFRAMEWORK_UTILS_API bool utf8_to_utf16(nostd::string_view input, std::u16string &output);
+
+/**
+ * @brief UTF-8转UTF-32，参数和返回值同 utf8_to_utf16
+ */
+ATFRAMEWORK_UTILS_API size_t utf8_to_utf32(nostd::string_view input, char32_t *output, size_t output_size) noexcept;
+
+ATFRAMEWORK_UTILS_API bool utf8_to_utf32(nostd::string_view input, std::u32string &output);
+
+/**
+ * @brief UTF-16转UTF-8，未配对的代理项视为不合法，参数和返回值同 utf8_to_utf16
+ */
+ATFRAMEWORK_UTILS_API size_t utf16_to_utf8(nostd::basic_string_view<char16_t> input, char *output,
+                                           size_t output_size) noexcept;
+
+ATFRAMEWORK_UTILS_API bool utf16_to_utf8(nostd::basic_string_view<char16_t> input, std::string &output);
+
+/**
+ * @brief UTF-32转UTF-8，代理区和超过U+10FFFF的码点视为不合法，参数和返回值同 utf8_to_utf16
+ */
+ATFRAMEWORK_UTILS_API size_t utf32_to_utf8(nostd::basic_string_view<char32_t> input, char *output,
+                                           size_t output_size) noexcept;
+
+ATFRAMEWORK_UTILS_API bool utf32_to_utf8(nostd::basic_string_view<char32_t> input, std::string &output);
+
+}  // namespace string
+ATFRAMEWORK_UTILS_NAMESPACE_END
+
+#endif
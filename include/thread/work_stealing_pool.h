@@ -0,0 +1,457 @@
+// Copyright 2026 atframework
+//
+// @file work_stealing_pool.h
+// @brief 工作窃取线程池
+// Licensed under the MIT licenses.
+//
+// @note 每个工作线程有一个 Chase-Lev 双端队列，工作线程内投递的任务进入自己队列的底部(LIFO执行，缓存友好)，
+//       空闲的工作线程从其他队列的顶部窃取；非工作线程投递的任务进入全局注入队列。
+// @note 任务使用小对象优化的 task_function 保存，小于 INLINE_SIZE 的回调不会额外分配内存，
+//       任务节点在工作线程内缓存复用。
+// @note 没有任务时工作线程先短暂自旋，然后挂起在 futex(Linux)/WaitOnAddress(Windows)/std::atomic::wait 上。
+// @note 延时任务使用 jiffies_timer，由调用者调用 tick() 驱动(和 jiffies_timer 本身的用法一致)，
+//       到期后投递到全局注入队列。
+// @note 任务不应该抛出异常，工作线程不会捕获任务中的异常。
+
+#ifndef UTIL_THREAD_WORK_STEALING_POOL_H
+#define UTIL_THREAD_WORK_STEALING_POOL_H
+
+#pragma once
+
+#include <config/atframe_utils_build_feature.h>
+#include <config/compile_optimize.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <deque>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "lock/spin_lock.h"
+#include "nostd/type_traits.h"
+#include "time/jiffies_timer.h"
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace thread {
+
+/**
+ * @brief 只能移动的 void() 回调，小对象直接保存在内部缓冲区
+ */
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY task_function {
+ public:
+  enum : size_t {
+    INLINE_SIZE = 6 * sizeof(void*),
+  };
+
+ private:
+  struct vtable_type {
+    void (*invoke)(void* storage);
+    void (*move_to)(void* dst, void* src) noexcept;
+    void (*destroy)(void* storage) noexcept;
+  };
+
+  template <class TFn>
+  struct is_inline_storage
+      : public ::std::integral_constant<bool, sizeof(TFn) <= INLINE_SIZE &&
+                                                  alignof(TFn) <= alignof(::std::max_align_t) &&
+                                                  ::std::is_nothrow_move_constructible<TFn>::value> {};
+
+  template <class TFn>
+  struct inline_vtable {
+    static void invoke(void* storage) { (*reinterpret_cast<TFn*>(storage))(); }
+    static void move_to(void* dst, void* src) noexcept {
+      new (dst) TFn(::std::move(*reinterpret_cast<TFn*>(src)));
+      reinterpret_cast<TFn*>(src)->~TFn();
+    }
+    static void destroy(void* storage) noexcept { reinterpret_cast<TFn*>(storage)->~TFn(); }
+
+    static const vtable_type* get() noexcept {
+      static const vtable_type ret = {&invoke, &move_to, &destroy};
+      return &ret;
+    }
+  };
+
+  template <class TFn>
+  struct heap_vtable {
+    static void invoke(void* storage) { (**reinterpret_cast<TFn**>(storage))(); }
+    static void move_to(void* dst, void* src) noexcept {
+      *reinterpret_cast<TFn**>(dst) = *reinterpret_cast<TFn**>(src);
+      *reinterpret_cast<TFn**>(src) = nullptr;
+    }
+    static void destroy(void* storage) noexcept { delete *reinterpret_cast<TFn**>(storage); }
+
+    static const vtable_type* get() noexcept {
+      static const vtable_type ret = {&invoke, &move_to, &destroy};
+      return &ret;
+    }
+  };
+
+ public:
+  task_function() noexcept : vtable_(nullptr) {}
+  task_function(std::nullptr_t) noexcept : vtable_(nullptr) {}  // NOLINT: runtime/explicit
+
+  template <class TFn, class = nostd::enable_if_t<!::std::is_same<nostd::remove_cvref_t<TFn>, task_function>::value &&
+                                                  !::std::is_same<nostd::remove_cvref_t<TFn>, std::nullptr_t>::value>>
+  task_function(TFn&& fn)  // NOLINT: runtime/explicit
+      : vtable_(nullptr) {
+    assign(::std::forward<TFn>(fn), is_inline_storage<nostd::remove_cvref_t<TFn>>());
+  }
+
+  task_function(task_function&& other) noexcept : vtable_(other.vtable_) {
+    if (nullptr != vtable_) {
+      vtable_->move_to(storage_, other.storage_);
+      other.vtable_ = nullptr;
+    }
+  }
+
+  task_function& operator=(task_function&& other) noexcept {
+    if (this != &other) {
+      reset();
+      if (nullptr != other.vtable_) {
+        other.vtable_->move_to(storage_, other.storage_);
+        vtable_ = other.vtable_;
+        other.vtable_ = nullptr;
+      }
+    }
+    return *this;
+  }
+
+  task_function(const task_function&) = delete;
+  task_function& operator=(const task_function&) = delete;
+
+  ~task_function() { reset(); }
+
+  ATFW_UTIL_FORCEINLINE void reset() noexcept {
+    if (nullptr != vtable_) {
+      vtable_->destroy(storage_);
+      vtable_ = nullptr;
+    }
+  }
+
+  ATFW_UTIL_FORCEINLINE explicit operator bool() const noexcept { return nullptr != vtable_; }
+
+  ATFW_UTIL_FORCEINLINE void operator()() { vtable_->invoke(storage_); }
+
+ private:
+  template <class TFn>
+  void assign(TFn&& fn, ::std::true_type) {
+    using fn_type = nostd::remove_cvref_t<TFn>;
+    new (storage_) fn_type(::std::forward<TFn>(fn));
+    vtable_ = inline_vtable<fn_type>::get();
+  }
+
+  template <class TFn>
+  void assign(TFn&& fn, ::std::false_type) {
+    using fn_type = nostd::remove_cvref_t<TFn>;
+    *reinterpret_cast<fn_type**>(storage_) = new fn_type(::std::forward<TFn>(fn));
+    vtable_ = heap_vtable<fn_type>::get();
+  }
+
+ private:
+  alignas(::std::max_align_t) unsigned char storage_[INLINE_SIZE];
+  const vtable_type* vtable_;
+};
+
+namespace detail {
+
+/**
+ * @brief Chase-Lev 工作窃取双端队列
+ * @note 只有拥有者线程可以 push/pop，其他线程只能 steal
+ * @note 内存序参考 N.M. Le et al., "Correct and Efficient Work-Stealing for Weak Memory Models" (PPoPP 2013)
+ * @note 扩容后旧的环形数组可能还在被窃取者读取，所以保留到队列析构
+ */
+template <class T>
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY chase_lev_deque {
+ private:
+  struct ring_type {
+    explicit ring_type(int64_t cap)
+        : capacity(cap), mask(cap - 1), slots(new ::std::atomic<T*>[static_cast<size_t>(cap)]) {
+      for (int64_t i = 0; i < cap; ++i) {
+        slots[i].store(nullptr, ::std::memory_order_relaxed);
+      }
+    }
+
+    ATFW_UTIL_FORCEINLINE T* get(int64_t i) const noexcept { return slots[i & mask].load(::std::memory_order_relaxed); }
+    ATFW_UTIL_FORCEINLINE void put(int64_t i, T* v) noexcept { slots[i & mask].store(v, ::std::memory_order_relaxed); }
+
+    int64_t capacity;
+    int64_t mask;
+    ::std::unique_ptr<::std::atomic<T*>[]> slots;
+  };
+
+  struct padded_index_type {
+    ::std::atomic<int64_t> value;
+    char padding[64 - sizeof(::std::atomic<int64_t>)];
+  };
+
+ public:
+  explicit chase_lev_deque(size_t init_capacity = 256) : ring_(nullptr) {
+    top_.value.store(0, ::std::memory_order_relaxed);
+    bottom_.value.store(0, ::std::memory_order_relaxed);
+    int64_t cap = 16;
+    while (cap < static_cast<int64_t>(init_capacity)) {
+      cap <<= 1;
+    }
+    rings_.emplace_back(new ring_type(cap));
+    ring_.store(rings_.back().get(), ::std::memory_order_relaxed);
+  }
+
+  chase_lev_deque(const chase_lev_deque&) = delete;
+  chase_lev_deque& operator=(const chase_lev_deque&) = delete;
+
+  void push(T* v) {
+    int64_t b = bottom_.value.load(::std::memory_order_relaxed);
+    int64_t t = top_.value.load(::std::memory_order_acquire);
+    ring_type* r = ring_.load(::std::memory_order_relaxed);
+    if (b - t > r->capacity - 1) {
+      r = grow(r, t, b);
+    }
+    r->put(b, v);
+    ::std::atomic_thread_fence(::std::memory_order_release);
+    bottom_.value.store(b + 1, ::std::memory_order_relaxed);
+  }
+
+  T* pop() noexcept {
+    int64_t b = bottom_.value.load(::std::memory_order_relaxed) - 1;
+    ring_type* r = ring_.load(::std::memory_order_relaxed);
+    bottom_.value.store(b, ::std::memory_order_relaxed);
+    ::std::atomic_thread_fence(::std::memory_order_seq_cst);
+    int64_t t = top_.value.load(::std::memory_order_relaxed);
+
+    T* ret = nullptr;
+    if (t <= b) {
+      ret = r->get(b);
+      if (t == b) {
+        // 最后一个元素，和窃取者竞争
+        if (!top_.value.compare_exchange_strong(t, t + 1, ::std::memory_order_seq_cst,
+                                                ::std::memory_order_relaxed)) {
+          ret = nullptr;
+        }
+        bottom_.value.store(b + 1, ::std::memory_order_relaxed);
+      }
+    } else {
+      bottom_.value.store(b + 1, ::std::memory_order_relaxed);
+    }
+    return ret;
+  }
+
+  T* steal() noexcept {
+    int64_t t = top_.value.load(::std::memory_order_acquire);
+    ::std::atomic_thread_fence(::std::memory_order_seq_cst);
+    int64_t b = bottom_.value.load(::std::memory_order_acquire);
+    if (t >= b) {
+      return nullptr;
+    }
+
+    ring_type* r = ring_.load(::std::memory_order_acquire);
+    T* ret = r->get(t);
+    if (!top_.value.compare_exchange_strong(t, t + 1, ::std::memory_order_seq_cst, ::std::memory_order_relaxed)) {
+      return nullptr;
+    }
+    return ret;
+  }
+
+  // 近似值，只用于判断是否需要挂起
+  ATFW_UTIL_FORCEINLINE size_t size() const noexcept {
+    int64_t b = bottom_.value.load(::std::memory_order_relaxed);
+    int64_t t = top_.value.load(::std::memory_order_relaxed);
+    return b > t ? static_cast<size_t>(b - t) : 0;
+  }
+
+  ATFW_UTIL_FORCEINLINE bool empty() const noexcept { return 0 == size(); }
+
+ private:
+  ring_type* grow(ring_type* r, int64_t t, int64_t b) {
+    rings_.emplace_back(new ring_type(r->capacity << 1));
+    ring_type* ret = rings_.back().get();
+    for (int64_t i = t; i < b; ++i) {
+      ret->put(i, r->get(i));
+    }
+    ring_.store(ret, ::std::memory_order_release);
+    return ret;
+  }
+
+ private:
+  // top_ 被窃取者修改，bottom_ 被拥有者修改，分开到不同缓存行
+  padded_index_type top_;
+  padded_index_type bottom_;
+  ::std::atomic<ring_type*> ring_;
+  ::std::vector<::std::unique_ptr<ring_type>> rings_;  // 只有拥有者线程修改
+};
+
+}  // namespace detail
+
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY work_stealing_pool_stats {
+  uint64_t executed_count;  // 已执行的任务数
+  uint64_t stolen_count;    // 从其他工作线程窃取的任务数
+  uint64_t parked_count;    // 工作线程挂起的次数
+};
+
+class ATFRAMEWORK_UTILS_API work_stealing_pool {
+ public:
+  using task_type = task_function;
+  using timer_type = time::jiffies_timer<>;
+  using parallel_for_function = void (*)(void* context, size_t slot, size_t index);
+
+  struct worker_type;
+
+  enum : size_t {
+    DEFAULT_DEQUE_CAPACITY = 256,
+    MAX_CACHED_TASK_NODES = 256,
+    SPIN_BEFORE_PARK = 64,
+  };
+
+ public:
+  /**
+   * @param worker_count 工作线程数量，0表示使用 std::thread::hardware_concurrency()
+   */
+  explicit work_stealing_pool(size_t worker_count = 0);
+
+  /**
+   * @brief 停止并等待所有工作线程退出
+   * @note 不能在本线程池的工作线程中析构(比如在任务中释放了线程池的最后一个 shared_ptr)，
+   *       工作线程无法等待自己退出，其他工作线程也仍然在访问线程池，这种情况下会输出错误并调用 std::abort()
+   */
+  ~work_stealing_pool();
+
+  work_stealing_pool(const work_stealing_pool&) = delete;
+  work_stealing_pool& operator=(const work_stealing_pool&) = delete;
+
+  /**
+   * @brief 投递任务
+   * @note 在本线程池的工作线程中调用时投递到本线程的队列，否则投递到全局注入队列
+   * @return 线程池已停止时返回false
+   */
+  bool post(task_type&& task);
+
+  template <class TFn, class = nostd::enable_if_t<!::std::is_same<nostd::remove_cvref_t<TFn>, task_type>::value>>
+  ATFW_UTIL_FORCEINLINE bool post(TFn&& fn) {
+    return post(task_type(::std::forward<TFn>(fn)));
+  }
+
+  /**
+   * @brief 初始化延时任务定时器
+   * @param init_tick 初始tick数(绝对时间)
+   * @return 0或 timer_type::error_type_t 中的错误码
+   */
+  int init_timer(time_t init_tick);
+
+  /**
+   * @brief 投递延时任务
+   * @param delta 延时tick数，语义同 jiffies_timer::add_timer
+   * @return 0或 timer_type::error_type_t 中的错误码
+   */
+  int post_delayed(time_t delta, task_type&& task);
+
+  template <class TFn, class = nostd::enable_if_t<!::std::is_same<nostd::remove_cvref_t<TFn>, task_type>::value>>
+  ATFW_UTIL_FORCEINLINE int post_delayed(time_t delta, TFn&& fn) {
+    return post_delayed(delta, task_type(::std::forward<TFn>(fn)));
+  }
+
+  /**
+   * @brief 驱动延时任务定时器，到期的任务投递到线程池
+   * @param expires 当前tick数(绝对时间)
+   * @return 错误码或投递的任务数量
+   */
+  int tick(time_t expires);
+
+  /**
+   * @brief 等待所有已投递的任务执行完(不包含未到期的延时任务)
+   * @note 在工作线程中调用时会帮忙执行任务而不是阻塞
+   */
+  void wait_idle();
+
+  /**
+   * @brief 并行执行 fn(slot, index)，index 取值 [0, count)，全部执行完后返回
+   * @note 调用线程也参与执行，所以可以在本线程池的工作线程中调用；投递失败只会降低并行度
+   * @note slot 是参与执行的线程编号，取值 [0, get_parallel_slot_count(count))，同一个 slot 只会被一个线程使用，
+   *       可以用来索引每个线程自己的临时缓冲区
+   * @note 回调不应该抛出异常
+   */
+  void parallel_for(size_t count, parallel_for_function fn, void* context);
+
+  template <class TFn>
+  ATFW_UTIL_FORCEINLINE void parallel_for(size_t count, TFn&& fn) {
+    using fn_type = typename ::std::remove_reference<TFn>::type;
+    parallel_for(count, &parallel_for_invoke<fn_type>, const_cast<void*>(static_cast<const void*>(&fn)));
+  }
+
+  /**
+   * @brief parallel_for(count, ...) 最多使用的 slot 数量
+   */
+  ATFW_UTIL_FORCEINLINE size_t get_parallel_slot_count(size_t count) const noexcept {
+    return count <= 1 ? 1 : (workers_.size() < count - 1 ? workers_.size() : count - 1) + 1;
+  }
+
+  /**
+   * @brief 停止线程池，已投递的任务会执行完，之后 post 返回false
+   * @note 在工作线程中调用时只设置停止标记，不等待工作线程退出
+   */
+  void stop();
+
+  ATFW_UTIL_FORCEINLINE size_t get_worker_count() const noexcept { return workers_.size(); }
+
+  ATFW_UTIL_FORCEINLINE size_t get_pending_count() const noexcept {
+    return pending_count_.load(::std::memory_order_acquire);
+  }
+
+  ATFW_UTIL_FORCEINLINE bool is_stopping() const noexcept { return stopping_.load(::std::memory_order_acquire); }
+
+  work_stealing_pool_stats get_stats() const noexcept;
+
+  /**
+   * @brief 当前线程所属的线程池，非工作线程返回nullptr
+   */
+  static work_stealing_pool* get_current_pool() noexcept;
+
+  /**
+   * @brief 当前线程在所属线程池中的下标，非工作线程返回-1
+   */
+  static int32_t get_current_worker_index() noexcept;
+
+ private:
+  template <class TFn>
+  static void parallel_for_invoke(void* context, size_t slot, size_t index) {
+    (*static_cast<TFn*>(context))(slot, index);
+  }
+
+  void worker_main(worker_type* self);
+  task_type* allocate_task_node(task_type&& task);
+  void release_task_node(task_type* node) noexcept;
+  void push_task_node(task_type* node);
+  task_type* pop_global() noexcept;
+  task_type* try_steal(worker_type* self) noexcept;
+  task_type* find_task(worker_type* self) noexcept;
+  void run_task(worker_type* self, task_type* node) noexcept;
+  bool has_visible_task() const noexcept;
+  void wake_one() noexcept;
+  void wake_all() noexcept;
+
+ private:
+  ::std::vector<::std::unique_ptr<worker_type>> workers_;
+
+  lock::spin_lock global_lock_;
+  ::std::deque<task_type*> global_queue_;
+  ::std::atomic<size_t> global_size_;
+
+  ::std::atomic<size_t> pending_count_;
+  ::std::atomic<bool> stopping_;
+
+  // 挂起/唤醒
+  ::std::atomic<uint32_t> wake_epoch_;
+  ::std::atomic<size_t> sleeping_count_;
+
+  lock::spin_lock timer_lock_;
+  timer_type timer_;
+};
+
+}  // namespace thread
+ATFRAMEWORK_UTILS_NAMESPACE_END
+
+#endif /* UTIL_THREAD_WORK_STEALING_POOL_H */
@@ -453,6 +453,7 @@ set(BOOST_ROOT
     ""
     CACHE STRING "Boost root directory")
 option(PROJECT_TEST_ENABLE_BOOST_UNIT_TEST "Enable boost unit test." OFF)
+option(PROJECT_TEST_ENABLE_BENCHMARK "Enable benchmark cases in unit test." OFF)
 
 option(PROJECT_ENABLE_UNITTEST "Enable unit test" OFF)
 option(PROJECT_ENABLE_SAMPLE "Enable sample" OFF)
@@ -11,6 +11,13 @@
 
 #include "algorithm/base64.h"
 
+#include "common/cpu_features.h"
+#include "config/compile_optimize.h"
+
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+#  include <immintrin.h>
+#endif
+
 #define BASE64_SIZE_T_MAX ((size_t)-1)     /* SIZE_T_MAX is not standard */
 #define BASE64_INVALID_CHARACTER (-0x002C) /**< Invalid character in input. */
 
@@ -58,6 +65,284 @@ static constexpr const unsigned char base64_dec_map_url[128] = {
     23,  24,  25,  127, 127, 127, 127, 63,  127, 26,  27,  28,  29,  30,  31,  32,  33,  34,  35,  36,  37,  38,
     39,  40,  41,  42,  43,  44,  45,  46,  47,  48,  49,  50,  51,  127, 127, 127, 127, 127};
 
+// ================ SIMD ================
+// @see http://0x80.pl/notesen/2016-01-12-sse-base64-encoding.html
+// @see http://0x80.pl/notesen/2016-01-17-sse-base64-decoding.html
+// 所有模式的前62个字符相同，只有第63和64个字符不同，查表时只需要替换这两个位置
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+ATFW_UTIL_FORCEINLINE ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("ssse3") static __m128i base64_simd_encode_lookup_sse(
+    __m128i indices, __m128i shift_lut) {
+  // 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12
+  __m128i reduced = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+  __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+  reduced = _mm_or_si128(reduced, _mm_and_si128(less, _mm_set1_epi8(13)));
+  return _mm_add_epi8(_mm_shuffle_epi8(shift_lut, reduced), indices);
+}
+
+ATFW_UTIL_FORCEINLINE ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("ssse3") static __m128i base64_simd_encode_split_sse(
+    __m128i in) {
+  // 每3字节扩展成4个16位整数的6位索引
+  in = _mm_shuffle_epi8(in, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+  __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+  __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+  __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+  __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+  return _mm_or_si128(t1, t3);
+}
+
+/**
+ * @brief SSSE3 编码，每次 12 字节输入，16 字节输出
+ * @return 已处理的输入长度(3的倍数)
+ */
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("ssse3")
+static size_t base64_encode_ssse3(unsigned char *dst, const unsigned char *src, size_t slen,
+                                  const unsigned char *enc_map) {
+  const __m128i shift_lut = _mm_setr_epi8(
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      static_cast<char>(enc_map[62] - 62), static_cast<char>(enc_map[63] - 63), 'A', 0, 0);
+
+  size_t i = 0;
+  // 每次读16字节，只使用前12字节
+  while (slen - i >= 16) {
+    __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+    __m128i out = base64_simd_encode_lookup_sse(base64_simd_encode_split_sse(in), shift_lut);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), out);
+    i += 12;
+    dst += 16;
+  }
+  return i;
+}
+
+/**
+ * @brief AVX2 编码，每次 24 字节输入，32 字节输出
+ * @return 已处理的输入长度(3的倍数)
+ */
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("avx2")
+static size_t base64_encode_avx2(unsigned char *dst, const unsigned char *src, size_t slen,
+                                 const unsigned char *enc_map) {
+  const __m256i shuffle = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10, 1, 0, 2, 1, 4, 3, 5, 4,
+                                           7, 6, 8, 7, 10, 9, 11, 10);
+  const char c62 = static_cast<char>(enc_map[62] - 62);
+  const char c63 = static_cast<char>(enc_map[63] - 63);
+  const __m256i shift_lut =
+      _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                       '0' - 52, '0' - 52, c62, c63, 'A', 0, 0, 'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                       '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, c62, c63, 'A', 0, 0);
+
+  size_t i = 0;
+  // 两个128位通道分别读取 [i, i+16) 和 [i+12, i+28)
+  while (slen - i >= 28) {
+    __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+    __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 12));
+    __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+
+    in = _mm256_shuffle_epi8(in, shuffle);
+    __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+    __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+    __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+    __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+    __m256i indices = _mm256_or_si256(t1, t3);
+
+    __m256i reduced = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+    __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+    reduced = _mm256_or_si256(reduced, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+    __m256i out = _mm256_add_epi8(_mm256_shuffle_epi8(shift_lut, reduced), indices);
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), out);
+    i += 24;
+    dst += 32;
+  }
+  return i;
+}
+
+ATFW_UTIL_FORCEINLINE ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("ssse3") static __m128i base64_simd_in_range_sse(__m128i in,
+                                                                                                     char lo, char hi) {
+  return _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8(static_cast<char>(lo - 1))),
+                       _mm_cmpgt_epi8(_mm_set1_epi8(static_cast<char>(hi + 1)), in));
+}
+
+/**
+ * @brief SSSE3 解码，每次 16 个字符输入，12 字节输出。遇到非编码字符(空白、填充、非法字符)的块时停止
+ * @note  dst 为空时只校验不输出
+ * @return 已处理的输入长度(16的倍数)
+ */
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("ssse3")
+static size_t base64_decode_ssse3(unsigned char *dst, size_t dlen, const unsigned char *src, size_t slen,
+                                  const unsigned char *enc_map) {
+  const __m128i c62 = _mm_set1_epi8(static_cast<char>(enc_map[62]));
+  const __m128i c63 = _mm_set1_epi8(static_cast<char>(enc_map[63]));
+  const __m128i c62_offset = _mm_set1_epi8(static_cast<char>(62 - enc_map[62]));
+  const __m128i c63_offset = _mm_set1_epi8(static_cast<char>(63 - enc_map[63]));
+  const __m128i pack_shuffle = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+  size_t i = 0;
+  size_t out_len = 0;
+  while (slen - i >= 16) {
+    __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+
+    // 大于127的字节是负数，不会落在任何区间里
+    __m128i upper = base64_simd_in_range_sse(in, 'A', 'Z');
+    __m128i lower = base64_simd_in_range_sse(in, 'a', 'z');
+    __m128i digit = base64_simd_in_range_sse(in, '0', '9');
+    __m128i is62 = _mm_cmpeq_epi8(in, c62);
+    __m128i is63 = _mm_cmpeq_epi8(in, c63);
+    __m128i valid = _mm_or_si128(_mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, is62)), is63);
+    if (_mm_movemask_epi8(valid) != 0xFFFF) {
+      break;
+    }
+
+    if (nullptr != dst) {
+      __m128i offset = _mm_or_si128(
+          _mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-'A')), _mm_and_si128(lower, _mm_set1_epi8(26 - 'a'))),
+          _mm_or_si128(_mm_and_si128(digit, _mm_set1_epi8(52 - '0')),
+                       _mm_or_si128(_mm_and_si128(is62, c62_offset), _mm_and_si128(is63, c63_offset))));
+      __m128i values = _mm_add_epi8(in, offset);
+
+      // [a, b, c, d] -> a << 18 | b << 12 | c << 6 | d
+      __m128i merged = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+      merged = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+      __m128i out = _mm_shuffle_epi8(merged, pack_shuffle);
+      if (out_len + 16 <= dlen) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + out_len), out);
+      } else {
+        unsigned char tail[16];
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(tail), out);
+        memcpy(dst + out_len, tail, 12);
+      }
+    }
+
+    i += 16;
+    out_len += 12;
+  }
+  return i;
+}
+
+ATFW_UTIL_FORCEINLINE ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("avx2") static __m256i base64_simd_in_range_avx2(
+    __m256i in, char lo, char hi) {
+  return _mm256_and_si256(_mm256_cmpgt_epi8(in, _mm256_set1_epi8(static_cast<char>(lo - 1))),
+                          _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(hi + 1)), in));
+}
+
+/**
+ * @brief AVX2 解码，每次 32 个字符输入，24 字节输出
+ * @return 已处理的输入长度(32的倍数)
+ */
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("avx2")
+static size_t base64_decode_avx2(unsigned char *dst, size_t dlen, const unsigned char *src, size_t slen,
+                                 const unsigned char *enc_map) {
+  const __m256i c62 = _mm256_set1_epi8(static_cast<char>(enc_map[62]));
+  const __m256i c63 = _mm256_set1_epi8(static_cast<char>(enc_map[63]));
+  const __m256i c62_offset = _mm256_set1_epi8(static_cast<char>(62 - enc_map[62]));
+  const __m256i c63_offset = _mm256_set1_epi8(static_cast<char>(63 - enc_map[63]));
+  const __m256i pack_shuffle = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1, 2, 1, 0, 6,
+                                                5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+  const __m256i pack_permute = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+
+  size_t i = 0;
+  size_t out_len = 0;
+  while (slen - i >= 32) {
+    __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+
+    __m256i upper = base64_simd_in_range_avx2(in, 'A', 'Z');
+    __m256i lower = base64_simd_in_range_avx2(in, 'a', 'z');
+    __m256i digit = base64_simd_in_range_avx2(in, '0', '9');
+    __m256i is62 = _mm256_cmpeq_epi8(in, c62);
+    __m256i is63 = _mm256_cmpeq_epi8(in, c63);
+    __m256i valid =
+        _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(upper, lower), _mm256_or_si256(digit, is62)), is63);
+    if (static_cast<uint32_t>(_mm256_movemask_epi8(valid)) != 0xFFFFFFFFu) {
+      break;
+    }
+
+    if (nullptr != dst) {
+      __m256i offset = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(upper, _mm256_set1_epi8(-'A')),
+                                                       _mm256_and_si256(lower, _mm256_set1_epi8(26 - 'a'))),
+                                       _mm256_or_si256(_mm256_and_si256(digit, _mm256_set1_epi8(52 - '0')),
+                                                       _mm256_or_si256(_mm256_and_si256(is62, c62_offset),
+                                                                       _mm256_and_si256(is63, c63_offset))));
+      __m256i values = _mm256_add_epi8(in, offset);
+
+      __m256i merged = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+      merged = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+      // 每个通道的前12字节有效，合并成连续的24字节
+      __m256i out = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(merged, pack_shuffle), pack_permute);
+      if (out_len + 32 <= dlen) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + out_len), out);
+      } else {
+        unsigned char tail[32];
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(tail), out);
+        memcpy(dst + out_len, tail, 24);
+      }
+    }
+
+    i += 32;
+    out_len += 24;
+  }
+  return i;
+}
+#endif
+
+/**
+ * @brief 使用当前CPU支持的最快实现编码尽可能多的完整块
+ * @return 已处理的输入长度(3的倍数)，输出长度为 返回值 / 3 * 4
+ */
+static size_t base64_encode_simd(unsigned char *dst, const unsigned char *src, size_t slen,
+                                 const unsigned char *enc_map) {
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+  if (slen < 16) {
+    return 0;
+  }
+
+  const platform::cpu_features &features = platform::get_cpu_features();
+  size_t ret = 0;
+  if (features.has_avx2) {
+    ret = base64_encode_avx2(dst, src, slen, enc_map);
+  }
+  if (features.has_ssse3) {
+    ret += base64_encode_ssse3(dst + ret / 3 * 4, src + ret, slen - ret, enc_map);
+  }
+  return ret;
+#else
+  (void)dst;
+  (void)src;
+  (void)slen;
+  (void)enc_map;
+  return 0;
+#endif
+}
+
+/**
+ * @brief 使用当前CPU支持的最快实现解码开头不包含空白和填充字符的部分
+ * @return 已处理的输入长度(4的倍数)，输出长度为 返回值 / 4 * 3
+ */
+static size_t base64_decode_simd(unsigned char *dst, size_t dlen, const unsigned char *src, size_t slen,
+                                 const unsigned char *enc_map) {
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+  if (slen < 16) {
+    return 0;
+  }
+
+  const platform::cpu_features &features = platform::get_cpu_features();
+  size_t ret = 0;
+  if (features.has_avx2) {
+    ret = base64_decode_avx2(dst, dlen, src, slen, enc_map);
+  }
+  if (features.has_ssse3) {
+    size_t out_len = ret / 4 * 3;
+    ret += base64_decode_ssse3(nullptr == dst ? nullptr : dst + out_len, dlen - out_len, src + ret, slen - ret,
+                               enc_map);
+  }
+  return ret;
+#else
+  (void)dst;
+  (void)dlen;
+  (void)src;
+  (void)slen;
+  (void)enc_map;
+  return 0;
+#endif
+}
+
 static inline char *get_writable_string_data(std::string &value) noexcept {
   if (value.empty()) {
     return nullptr;
@@ -69,10 +354,31 @@ static inline char *get_writable_string_data(std::string &value) noexcept {
 #endif
 }
 
+/**
+ * @brief 编码完整的3字节组，slen必须是3的倍数
+ * @return 输出结束位置
+ */
+static unsigned char *base64_encode_block(unsigned char *dst, const unsigned char *src, size_t slen,
+                                          base_enc_map_t &base64_enc_map) {
+  size_t i = base64_encode_simd(dst, src, slen, base64_enc_map);
+  unsigned char *p = dst + i / 3 * 4;
+  for (src += i; i < slen; i += 3) {
+    int C1 = *src++;
+    int C2 = *src++;
+    int C3 = *src++;
+
+    *p++ = base64_enc_map[(C1 >> 2) & 0x3F];
+    *p++ = base64_enc_map[(((C1 & 3) << 4) + (C2 >> 4)) & 0x3F];
+    *p++ = base64_enc_map[(((C2 & 15) << 2) + (C3 >> 6)) & 0x3F];
+    *p++ = base64_enc_map[C3 & 0x3F];
+  }
+  return p;
+}
+
 static int base64_encode_inner(unsigned char *dst, size_t dlen, size_t *olen, const unsigned char *src, size_t slen,
                                base_enc_map_t &base64_enc_map, unsigned char padding_char) {
   size_t i = 0, n = 0, nopadding = 0;
-  int C1 = 0, C2 = 0, C3 = 0;
+  int C1 = 0, C2 = 0;
   unsigned char *p = nullptr;
 
   if (slen == 0) {
@@ -104,16 +410,9 @@ static int base64_encode_inner(unsigned char *dst, size_t dlen, size_t *olen, co
 
   n = (slen / 3) * 3;
 
-  for (i = 0, p = dst; i < n; i += 3) {
-    C1 = *src++;
-    C2 = *src++;
-    C3 = *src++;
-
-    *p++ = base64_enc_map[(C1 >> 2) & 0x3F];
-    *p++ = base64_enc_map[(((C1 & 3) << 4) + (C2 >> 4)) & 0x3F];
-    *p++ = base64_enc_map[(((C2 & 15) << 2) + (C3 >> 6)) & 0x3F];
-    *p++ = base64_enc_map[C3 & 0x3F];
-  }
+  p = base64_encode_block(dst, src, n, base64_enc_map);
+  src += n;
+  i = n;
 
   if (i < slen) {
     C1 = *src++;
@@ -165,15 +464,19 @@ static inline int base64_encode_inner(std::string &dst, const std::string &in, b
                              padding_char);
 }
 
-static int base64_decode_inner(unsigned char *dst, size_t dlen, size_t *olen, const unsigned char *src, size_t slen,
-                               base_dec_map_t &base64_dec_map, unsigned char padding_char) {
+/**
+ * @brief 标量解码
+ * @param init_line_len 前面已经处理过的当前行长度，用于拼接在SIMD处理过的前缀之后时检查行内空白
+ */
+static int base64_decode_scalar(unsigned char *dst, size_t dlen, size_t *olen, const unsigned char *src, size_t slen,
+                                base_dec_map_t &base64_dec_map, unsigned char padding_char, size_t init_line_len) {
   size_t i = 0, n = 0;
   size_t j = 0, x = 0;
-  size_t valid_slen = 0, line_len = 0;
+  size_t valid_slen = 0, line_len = init_line_len;
   unsigned char *p = nullptr;
 
   /* First pass: check for validity and get output length */
-  for (i = n = j = valid_slen = line_len = 0; i < slen; i++) {
+  for (i = n = j = valid_slen = 0; i < slen; i++) {
     /* Skip spaces before checking for EOL */
     x = 0;
     while (i < slen && (src[i] == ' ' || src[i] == '\t')) {
@@ -273,11 +576,39 @@ static int base64_decode_inner(unsigned char *dst, size_t dlen, size_t *olen, co
   return 0;
 }
 
+static int base64_decode_inner(unsigned char *dst, size_t dlen, size_t *olen, const unsigned char *src, size_t slen,
+                               base_dec_map_t &base64_dec_map, base_enc_map_t &base64_enc_map,
+                               unsigned char padding_char) {
+  // 先校验全部输入并计算输出长度（SIMD部分只检查字符），保证返回-1或-2时不写入任何数据
+  size_t prefix_slen = base64_decode_simd(nullptr, 0, src, slen, base64_enc_map);
+  size_t prefix_olen = prefix_slen / 4 * 3;
+
+  size_t tail_olen = 0;
+  int ret = base64_decode_scalar(nullptr, 0, &tail_olen, src + prefix_slen, slen - prefix_slen, base64_dec_map,
+                                 padding_char, prefix_slen);
+  if (-2 == ret) {
+    return ret;
+  }
+
+  *olen = prefix_olen + tail_olen;
+  if (0 == *olen) {
+    return 0;
+  }
+  if (nullptr == dst || dlen < *olen) {
+    return -1;
+  }
+
+  base64_decode_simd(dst, dlen, src, prefix_slen, base64_enc_map);
+  return base64_decode_scalar(dst + prefix_olen, dlen - prefix_olen, &tail_olen, src + prefix_slen,
+                              slen - prefix_slen, base64_dec_map, padding_char, prefix_slen);
+}
+
 static inline int base64_decode_inner(std::string &dst, const unsigned char *src, size_t slen,
-                                      base_dec_map_t &base64_dec_map, unsigned char padding_char) {
+                                      base_dec_map_t &base64_dec_map, base_enc_map_t &base64_enc_map,
+                                      unsigned char padding_char) {
   size_t olen = 0;
 
-  if (-2 == base64_decode_inner(nullptr, 0, &olen, src, slen, base64_dec_map, padding_char)) {
+  if (-2 == base64_decode_inner(nullptr, 0, &olen, src, slen, base64_dec_map, base64_enc_map, padding_char)) {
     return -2;
   }
 
@@ -287,15 +618,15 @@ static inline int base64_decode_inner(std::string &dst, const unsigned char *src
 
   dst.resize(olen);
   int ret = base64_decode_inner(reinterpret_cast<unsigned char *>(get_writable_string_data(dst)), dst.size(), &olen,
-                                src, slen, base64_dec_map, padding_char);
+                                src, slen, base64_dec_map, base64_enc_map, padding_char);
   assert(0 != ret || olen == dst.size());
   return ret;
 }
 
 static inline int base64_decode_inner(std::string &dst, const std::string &in, base_dec_map_t &base64_dec_map,
-                                      unsigned char padding_char) {
+                                      base_enc_map_t &base64_enc_map, unsigned char padding_char) {
   return base64_decode_inner(dst, reinterpret_cast<const unsigned char *>(in.c_str()), in.size(), base64_dec_map,
-                             padding_char);
+                             base64_enc_map, padding_char);
 }
 
 static inline base_dec_map_t &base64_get_dec_map(base64_mode_t::type mode) {
@@ -364,16 +695,245 @@ ATFRAMEWORK_UTILS_API int base64_encode(std::string &dst, const std::string &in,
 
 ATFRAMEWORK_UTILS_API int base64_decode(unsigned char *dst, size_t dlen, size_t *olen, const unsigned char *src,
                                         size_t slen, base64_mode_t::type mode) {
-  return base64_decode_inner(dst, dlen, olen, src, slen, base64_get_dec_map(mode), base64_get_padding_char(mode));
+  return base64_decode_inner(dst, dlen, olen, src, slen, base64_get_dec_map(mode), base64_get_enc_map(mode),
+                             base64_get_padding_char(mode));
 }
 
 ATFRAMEWORK_UTILS_API int base64_decode(std::string &dst, const unsigned char *src, size_t slen,
                                         base64_mode_t::type mode) {
-  return base64_decode_inner(dst, src, slen, base64_get_dec_map(mode), base64_get_padding_char(mode));
+  return base64_decode_inner(dst, src, slen, base64_get_dec_map(mode), base64_get_enc_map(mode),
+                             base64_get_padding_char(mode));
 }
 
 ATFRAMEWORK_UTILS_API int base64_decode(std::string &dst, const std::string &in, base64_mode_t::type mode) {
-  return base64_decode_inner(dst, in, base64_get_dec_map(mode), base64_get_padding_char(mode));
+  return base64_decode_inner(dst, in, base64_get_dec_map(mode), base64_get_enc_map(mode),
+                             base64_get_padding_char(mode));
+}
+
+ATFRAMEWORK_UTILS_API base64_encoder::base64_encoder(base64_mode_t::type mode) noexcept
+    : mode_(mode), pending_len_(0) {
+  memset(pending_, 0, sizeof(pending_));
+}
+
+ATFRAMEWORK_UTILS_API int base64_encoder::update(unsigned char *dst, size_t dlen, size_t *olen,
+                                                 const unsigned char *src, size_t slen) noexcept {
+  if (nullptr == src || 0 == slen) {
+    *olen = 0;
+    return 0;
+  }
+
+  size_t need = (pending_len_ + slen) / 3 * 4;
+  if (need > dlen || (nullptr == dst && need > 0)) {
+    *olen = need;
+    return -1;
+  }
+
+  base_enc_map_t &enc_map = base64_get_enc_map(mode_);
+  unsigned char *p = dst;
+  if (pending_len_ > 0) {
+    while (pending_len_ < 3 && slen > 0) {
+      pending_[pending_len_++] = *src++;
+      --slen;
+    }
+
+    if (pending_len_ < 3) {
+      *olen = 0;
+      return 0;
+    }
+
+    p = base64_encode_block(p, pending_, 3, enc_map);
+    pending_len_ = 0;
+  }
+
+  size_t n = slen / 3 * 3;
+  p = base64_encode_block(p, src, n, enc_map);
+  for (; n < slen; ++n) {
+    pending_[pending_len_++] = src[n];
+  }
+
+  *olen = static_cast<size_t>(p - dst);
+  return 0;
+}
+
+ATFRAMEWORK_UTILS_API int base64_encoder::update(std::string &dst, const unsigned char *src, size_t slen) {
+  size_t old_size = dst.size();
+  size_t olen = (pending_len_ + slen) / 3 * 4;
+  if (0 == olen) {
+    return update(nullptr, 0, &olen, src, slen);
+  }
+
+  dst.resize(old_size + olen);
+  int ret =
+      update(reinterpret_cast<unsigned char *>(get_writable_string_data(dst)) + old_size, olen, &olen, src, slen);
+  dst.resize(old_size + (0 == ret ? olen : 0));
+  return ret;
+}
+
+ATFRAMEWORK_UTILS_API int base64_encoder::finish(unsigned char *dst, size_t dlen, size_t *olen) noexcept {
+  unsigned char padding_char = base64_get_padding_char(mode_);
+  size_t need = 0;
+  if (pending_len_ > 0) {
+    need = 0 == padding_char ? pending_len_ + 1 : 4;
+  }
+
+  if (need > dlen || (nullptr == dst && need > 0)) {
+    *olen = need;
+    return -1;
+  }
+
+  if (need > 0) {
+    base_enc_map_t &enc_map = base64_get_enc_map(mode_);
+    int C1 = pending_[0];
+    int C2 = pending_len_ > 1 ? pending_[1] : 0;
+    unsigned char *p = dst;
+    *p++ = enc_map[(C1 >> 2) & 0x3F];
+    *p++ = enc_map[(((C1 & 3) << 4) + (C2 >> 4)) & 0x3F];
+    if (pending_len_ > 1) {
+      *p++ = enc_map[((C2 & 15) << 2) & 0x3F];
+    } else if (padding_char) {
+      *p++ = padding_char;
+    }
+
+    if (padding_char) {
+      *p++ = padding_char;
+    }
+  }
+
+  *olen = need;
+  reset();
+  return 0;
+}
+
+ATFRAMEWORK_UTILS_API int base64_encoder::finish(std::string &dst) {
+  unsigned char tail[4];
+  size_t olen = 0;
+  int ret = finish(tail, sizeof(tail), &olen);
+  if (0 == ret) {
+    dst.append(reinterpret_cast<const char *>(tail), olen);
+  }
+  return ret;
+}
+
+ATFRAMEWORK_UTILS_API void base64_encoder::reset() noexcept { pending_len_ = 0; }
+
+ATFRAMEWORK_UTILS_API base64_decoder::base64_decoder(base64_mode_t::type mode) noexcept
+    : mode_(mode), pending_bits_(0), pending_len_(0), padding_len_(0) {}
+
+ATFRAMEWORK_UTILS_API int base64_decoder::update(unsigned char *dst, size_t dlen, size_t *olen,
+                                                 const unsigned char *src, size_t slen) noexcept {
+  if (nullptr == src || 0 == slen) {
+    *olen = 0;
+    return 0;
+  }
+
+  // 按不含空白的最坏情况检查，保证失败时不修改状态
+  size_t need = (pending_len_ + slen) / 4 * 3;
+  if (need > dlen || (nullptr == dst && need > 0)) {
+    *olen = need;
+    return -1;
+  }
+
+  base_dec_map_t &dec_map = base64_get_dec_map(mode_);
+  base_enc_map_t &enc_map = base64_get_enc_map(mode_);
+  unsigned char padding_char = base64_get_padding_char(mode_);
+  unsigned char *p = dst;
+
+  size_t i = 0;
+  while (i < slen) {
+    // 组边界上尝试SIMD批量解码，遇到空白或填充时退回逐字节处理
+    if (0 == pending_len_ && 0 == padding_len_ && slen - i >= 16) {
+      size_t consumed = base64_decode_simd(p, dlen - static_cast<size_t>(p - dst), src + i, slen - i, enc_map);
+      if (consumed > 0) {
+        i += consumed;
+        p += consumed / 4 * 3;
+        continue;
+      }
+    }
+
+    unsigned char c = src[i++];
+    if (c == '\r' || c == '\n' || c == ' ' || c == '\t') {
+      continue;
+    }
+
+    if (0 != padding_char && c == padding_char) {
+      // First and second char of every group can not be padding char
+      if (pending_len_ < 2 || pending_len_ + (++padding_len_) > 4) {
+        return -2;
+      }
+      continue;
+    }
+
+    if (c > 127 || dec_map[c] == 127 || 0 != padding_len_) {
+      return -2;
+    }
+
+    pending_bits_ = (pending_bits_ << 6) | (dec_map[c] & 0x3F);
+    if (++pending_len_ == 4) {
+      *p++ = static_cast<unsigned char>(pending_bits_ >> 16);
+      *p++ = static_cast<unsigned char>(pending_bits_ >> 8);
+      *p++ = static_cast<unsigned char>(pending_bits_);
+      pending_bits_ = 0;
+      pending_len_ = 0;
+    }
+  }
+
+  *olen = static_cast<size_t>(p - dst);
+  return 0;
+}
+
+ATFRAMEWORK_UTILS_API int base64_decoder::update(std::string &dst, const unsigned char *src, size_t slen) {
+  size_t old_size = dst.size();
+  size_t olen = (pending_len_ + slen) / 4 * 3;
+  if (0 == olen) {
+    return update(nullptr, 0, &olen, src, slen);
+  }
+
+  dst.resize(old_size + olen);
+  int ret =
+      update(reinterpret_cast<unsigned char *>(get_writable_string_data(dst)) + old_size, olen, &olen, src, slen);
+  dst.resize(old_size + (0 == ret ? olen : 0));
+  return ret;
+}
+
+ATFRAMEWORK_UTILS_API int base64_decoder::finish(unsigned char *dst, size_t dlen, size_t *olen) noexcept {
+  if (1 == pending_len_) {
+    *olen = 0;
+    return -2;
+  }
+
+  size_t need = pending_len_ > 0 ? pending_len_ - 1 : 0;
+  if (need > dlen || (nullptr == dst && need > 0)) {
+    *olen = need;
+    return -1;
+  }
+
+  // no padding, the tail code
+  if (2 == pending_len_) {
+    dst[0] = static_cast<unsigned char>(pending_bits_ >> 4);
+  } else if (3 == pending_len_) {
+    dst[0] = static_cast<unsigned char>(pending_bits_ >> 10);
+    dst[1] = static_cast<unsigned char>(pending_bits_ >> 2);
+  }
+
+  *olen = need;
+  reset();
+  return 0;
+}
+
+ATFRAMEWORK_UTILS_API int base64_decoder::finish(std::string &dst) {
+  unsigned char tail[2];
+  size_t olen = 0;
+  int ret = finish(tail, sizeof(tail), &olen);
+  if (0 == ret) {
+    dst.append(reinterpret_cast<const char *>(tail), olen);
+  }
+  return ret;
+}
+
+ATFRAMEWORK_UTILS_API void base64_decoder::reset() noexcept {
+  pending_bits_ = 0;
+  pending_len_ = 0;
+  padding_len_ = 0;
 }
 
 ATFRAMEWORK_UTILS_NAMESPACE_END
@@ -10,15 +10,27 @@
 
 #ifdef ATFW_UTIL_MACRO_COMPRESSION_ENABLED
 
+#  include <atomic>
+#  include <chrono>
+#  include <cmath>
 #  include <cstring>
 #  include <limits>
+#  include <memory>
+#  include <new>
+
+#  include "config/compile_optimize.h"
+#  include "lock/lock_holder.h"
+#  include "thread/work_stealing_pool.h"
 
 #  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZSTD)
+#    include <zdict.h>
 #    include <zstd.h>
+#    include <zstd_errors.h>
 #  endif
 
 #  if defined(ATFW_UTIL_MACRO_COMPRESSION_LZ4)
 #    include <lz4.h>
+#    include <lz4frame.h>
 #    include <lz4hc.h>
 #  endif
 
@@ -549,6 +561,1827 @@ ATFRAMEWORK_UTILS_API int decompress(algorithm_t type, gsl::span<const unsigned
   }
 }
 
+namespace {
+
+struct ATFW_UTIL_SYMBOL_LOCAL compressor_context {
+  int level;
+  bool lz4_high_compression;
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZSTD)
+  ZSTD_CCtx* zstd_cctx;
+  ZSTD_CDict* zstd_cdict;
+#  endif
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_LZ4)
+  LZ4_stream_t* lz4_stream;
+  LZ4_streamHC_t* lz4hc_stream;
+  LZ4F_cctx* lz4f_cctx;  // Created by the first stream_begin()
+  LZ4F_preferences_t lz4f_preferences;
+  bool lz4f_header_pending;
+#  endif
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZLIB)
+  z_stream zlib_stream;
+  bool zlib_inited;
+#  endif
+};
+
+struct ATFW_UTIL_SYMBOL_LOCAL decompressor_context {
+  bool stream_finished;
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZSTD)
+  ZSTD_DCtx* zstd_dctx;
+  ZSTD_DDict* zstd_ddict;
+#  endif
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_LZ4)
+  LZ4F_dctx* lz4f_dctx;  // Created by the first stream_begin()
+#  endif
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZLIB)
+  z_stream zlib_stream;
+  bool zlib_inited;
+#  endif
+};
+
+static void _free_compressor_context(compressor_context* ctx) noexcept {
+  if (ctx == nullptr) {
+    return;
+  }
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZSTD)
+  if (ctx->zstd_cctx != nullptr) {
+    ZSTD_freeCCtx(ctx->zstd_cctx);
+  }
+  if (ctx->zstd_cdict != nullptr) {
+    ZSTD_freeCDict(ctx->zstd_cdict);
+  }
+#  endif
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_LZ4)
+  if (ctx->lz4_stream != nullptr) {
+    LZ4_freeStream(ctx->lz4_stream);
+  }
+  if (ctx->lz4hc_stream != nullptr) {
+    LZ4_freeStreamHC(ctx->lz4hc_stream);
+  }
+  if (ctx->lz4f_cctx != nullptr) {
+    LZ4F_freeCompressionContext(ctx->lz4f_cctx);
+  }
+#  endif
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZLIB)
+  if (ctx->zlib_inited) {
+    deflateEnd(&ctx->zlib_stream);
+  }
+#  endif
+  delete ctx;
+}
+
+static void _free_decompressor_context(decompressor_context* ctx) noexcept {
+  if (ctx == nullptr) {
+    return;
+  }
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZSTD)
+  if (ctx->zstd_dctx != nullptr) {
+    ZSTD_freeDCtx(ctx->zstd_dctx);
+  }
+  if (ctx->zstd_ddict != nullptr) {
+    ZSTD_freeDDict(ctx->zstd_ddict);
+  }
+#  endif
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_LZ4)
+  if (ctx->lz4f_dctx != nullptr) {
+    LZ4F_freeDecompressionContext(ctx->lz4f_dctx);
+  }
+#  endif
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZLIB)
+  if (ctx->zlib_inited) {
+    inflateEnd(&ctx->zlib_stream);
+  }
+#  endif
+  delete ctx;
+}
+
+static int _check_algorithm(algorithm_t type) noexcept {
+  switch (type) {
+    case algorithm_t::kZstd:
+    case algorithm_t::kLz4:
+    case algorithm_t::kSnappy:
+    case algorithm_t::kZlib:
+      return is_algorithm_supported(type) ? error_code_t::kOk : error_code_t::kNotSupport;
+    case algorithm_t::kNone:
+    default:
+      return error_code_t::kInvalidParam;
+  }
+}
+
+// Make sure there are at least min_space unused bytes after used, return the unused size or 0 on failure
+static size_t _reserve_output_space(std::vector<unsigned char>& output, size_t used, size_t min_space) noexcept {
+  if (output.size() - used < min_space) {
+    // Grow geometrically, so appending many small chunks is amortized O(1)
+    size_t new_size = used + min_space;
+    if (new_size < output.size() * 2) {
+      new_size = output.size() * 2;
+    }
+    if (!_resize_output(output, new_size)) {
+      return 0;
+    }
+  }
+  return output.size() - used;
+}
+
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZLIB)
+static constexpr const size_t kZlibStreamChunkSize = 16384;
+
+// z_stream counts bytes with uInt, large buffers are fed in pieces
+static uInt _zlib_chunk_size(size_t size) noexcept {
+  if (size > static_cast<size_t>(_numeric_limits_max<uInt>())) {
+    return _numeric_limits_max<uInt>();
+  }
+  return static_cast<uInt>(size);
+}
+
+static int _zlib_stream_deflate(z_stream& zs, gsl::span<const unsigned char> input, std::vector<unsigned char>& output,
+                                size_t& used, bool finish) noexcept {
+  const unsigned char* in = input.data();
+  size_t in_left = input.size();
+  zs.avail_in = 0;
+  while (true) {
+    if (zs.avail_in == 0 && in_left > 0) {
+      zs.next_in = const_cast<Bytef*>(reinterpret_cast<const Bytef*>(in));
+      zs.avail_in = _zlib_chunk_size(in_left);
+      in += zs.avail_in;
+      in_left -= zs.avail_in;
+    }
+
+    size_t space = _reserve_output_space(output, used, kZlibStreamChunkSize);
+    if (space == 0) {
+      return error_code_t::kOperation;
+    }
+    zs.next_out = reinterpret_cast<Bytef*>(output.data() + used);
+    zs.avail_out = _zlib_chunk_size(space);
+    uInt out_chunk = zs.avail_out;
+
+    int zret = deflate(&zs, (finish && in_left == 0) ? Z_FINISH : Z_NO_FLUSH);
+    used += out_chunk - zs.avail_out;
+    if (zret == Z_STREAM_END) {
+      return error_code_t::kOk;
+    }
+    if (zret != Z_OK && zret != Z_BUF_ERROR) {
+      return error_code_t::kOperation;
+    }
+    if (!finish && zs.avail_in == 0 && in_left == 0 && zs.avail_out != 0) {
+      return error_code_t::kOk;
+    }
+  }
+}
+#  endif
+
+}  // namespace
+
+ATFRAMEWORK_UTILS_API int train_dictionary(algorithm_t type, gsl::span<const unsigned char> samples,
+                                           gsl::span<const size_t> sample_sizes, size_t max_dictionary_size,
+                                           std::vector<unsigned char>& output) noexcept {
+  output.clear();
+
+  int ret = _check_algorithm(type);
+  if (ret != error_code_t::kOk) {
+    return ret;
+  }
+  if (type != algorithm_t::kZstd) {
+    return error_code_t::kNotSupport;
+  }
+
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZSTD)
+  if (max_dictionary_size == 0 || sample_sizes.empty() ||
+      sample_sizes.size() > static_cast<size_t>(_numeric_limits_max<unsigned>())) {
+    return error_code_t::kInvalidParam;
+  }
+  size_t total_size = 0;
+  for (size_t sample_size : sample_sizes) {
+    total_size += sample_size;
+  }
+  if (total_size > samples.size()) {
+    return error_code_t::kInvalidParam;
+  }
+
+  if (!_resize_output(output, max_dictionary_size)) {
+    return error_code_t::kOperation;
+  }
+  size_t dict_size = ZDICT_trainFromBuffer(output.data(), output.size(), samples.data(), sample_sizes.data(),
+                                           static_cast<unsigned>(sample_sizes.size()));
+  if (ZDICT_isError(dict_size)) {
+    output.clear();
+    return error_code_t::kOperation;
+  }
+  output.resize(dict_size);
+  return error_code_t::kOk;
+#  else
+  return error_code_t::kNotSupport;
+#  endif
+}
+
+// ============================ compressor ============================
+
+compressor::compressor() noexcept : algorithm_(algorithm_t::kNone), context_(nullptr) {}
+
+compressor::~compressor() { close(); }
+
+compressor::compressor(compressor&& other) noexcept : algorithm_(other.algorithm_), context_(other.context_) {
+  other.algorithm_ = algorithm_t::kNone;
+  other.context_ = nullptr;
+}
+
+compressor& compressor::operator=(compressor&& other) noexcept {
+  if (this != &other) {
+    close();
+    algorithm_ = other.algorithm_;
+    context_ = other.context_;
+    other.algorithm_ = algorithm_t::kNone;
+    other.context_ = nullptr;
+  }
+  return *this;
+}
+
+int compressor::init(algorithm_t type, level_t level) noexcept { return init_internal(type, false, 0, level); }
+
+int compressor::init_with_raw_level(algorithm_t type, int raw_level) noexcept {
+  return init_internal(type, true, raw_level, level_t::kDefault);
+}
+
+int compressor::init_internal(algorithm_t type, bool use_raw_level, int raw_level, level_t level) noexcept {
+  close();
+
+  int ret = _check_algorithm(type);
+  if (ret != error_code_t::kOk) {
+    return ret;
+  }
+  if (type == algorithm_t::kSnappy && use_raw_level) {
+    return error_code_t::kNotSupport;
+  }
+
+  compressor_context* ctx = new (std::nothrow) compressor_context();
+  if (ctx == nullptr) {
+    return error_code_t::kOperation;
+  }
+
+  bool success = true;
+  switch (type) {
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZSTD)
+    case algorithm_t::kZstd:
+      ctx->level = use_raw_level ? raw_level : _map_level_zstd(level);
+      ctx->zstd_cctx = ZSTD_createCCtx();
+      success = ctx->zstd_cctx != nullptr &&
+                !ZSTD_isError(ZSTD_CCtx_setParameter(ctx->zstd_cctx, ZSTD_c_compressionLevel, ctx->level));
+      break;
+#  endif
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_LZ4)
+    case algorithm_t::kLz4: {
+      // Same rules as _compress_internal(), level 0 means LZ4_compress_default()
+      mapped_level_t mapped = _map_level_lz4(level);
+      if (use_raw_level) {
+        mapped.level = raw_level;
+        mapped.use_high_compression = raw_level >= LZ4HC_CLEVEL_MIN;
+      }
+      if (mapped.use_high_compression) {
+        ctx->level = _clamp_int(mapped.level, LZ4HC_CLEVEL_MIN, LZ4HC_CLEVEL_MAX);
+        ctx->lz4_high_compression = true;
+        ctx->lz4hc_stream = LZ4_createStreamHC();
+        success = ctx->lz4hc_stream != nullptr;
+      } else {
+        ctx->level = mapped.level <= 0 ? 0 : _clamp_int(mapped.level, 1, 12);
+        ctx->lz4_stream = LZ4_createStream();
+        success = ctx->lz4_stream != nullptr;
+      }
+      break;
+    }
+#  endif
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZLIB)
+    case algorithm_t::kZlib:
+      // deflateInit() writes the same zlib format as compress2()
+      ctx->level = use_raw_level ? raw_level : _map_level_zlib(level);
+      ctx->zlib_inited = deflateInit(&ctx->zlib_stream, ctx->level) == Z_OK;
+      success = ctx->zlib_inited;
+      break;
+#  endif
+    default:
+      break;
+  }
+
+  if (!success) {
+    _free_compressor_context(ctx);
+    return error_code_t::kOperation;
+  }
+
+  algorithm_ = type;
+  context_ = ctx;
+  return error_code_t::kOk;
+}
+
+void compressor::close() noexcept {
+  _free_compressor_context(reinterpret_cast<compressor_context*>(context_));
+  context_ = nullptr;
+  algorithm_ = algorithm_t::kNone;
+}
+
+bool compressor::is_valid() const noexcept { return context_ != nullptr; }
+
+algorithm_t compressor::get_algorithm() const noexcept { return algorithm_; }
+
+int compressor::load_dictionary(gsl::span<const unsigned char> dictionary) noexcept {
+  compressor_context* ctx = reinterpret_cast<compressor_context*>(context_);
+  if (ctx == nullptr || (dictionary.data() == nullptr && dictionary.size() > 0)) {
+    return error_code_t::kInvalidParam;
+  }
+
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZSTD)
+  if (algorithm_ == algorithm_t::kZstd) {
+    // Digested dictionary is built once here instead of on every compress()
+    ZSTD_CDict* cdict = nullptr;
+    if (!dictionary.empty()) {
+      cdict = ZSTD_createCDict(dictionary.data(), dictionary.size(), ctx->level);
+      if (cdict == nullptr) {
+        return error_code_t::kOperation;
+      }
+    }
+
+    if (ZSTD_isError(ZSTD_CCtx_refCDict(ctx->zstd_cctx, cdict))) {
+      ZSTD_freeCDict(cdict);
+      return error_code_t::kOperation;
+    }
+
+    ZSTD_freeCDict(ctx->zstd_cdict);
+    ctx->zstd_cdict = cdict;
+    return error_code_t::kOk;
+  }
+#  endif
+
+  return error_code_t::kNotSupport;
+}
+
+size_t compressor::compress_bound(size_t input_size) const noexcept {
+  if (context_ == nullptr) {
+    return 0;
+  }
+
+  switch (algorithm_) {
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZSTD)
+    case algorithm_t::kZstd:
+      return ZSTD_compressBound(input_size);
+#  endif
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_LZ4)
+    case algorithm_t::kLz4: {
+      int input_int = 0;
+      if (!_size_to_int(input_size, input_int)) {
+        return 0;
+      }
+      int bound = LZ4_compressBound(input_int);
+      return bound > 0 ? static_cast<size_t>(bound) : 0;
+    }
+#  endif
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_SNAPPY)
+    case algorithm_t::kSnappy:
+      return snappy_max_compressed_length(input_size);
+#  endif
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZLIB)
+    case algorithm_t::kZlib:
+      if (input_size > static_cast<size_t>(_numeric_limits_max<uLong>())) {
+        return 0;
+      }
+      return static_cast<size_t>(compressBound(static_cast<uLong>(input_size)));
+#  endif
+    default:
+      return 0;
+  }
+}
+
+int compressor::compress(gsl::span<const unsigned char> input, gsl::span<unsigned char> output,
+                         size_t& output_size) noexcept {
+  output_size = 0;
+  compressor_context* ctx = reinterpret_cast<compressor_context*>(context_);
+  if (ctx == nullptr) {
+    return error_code_t::kInvalidParam;
+  }
+  if ((input.data() == nullptr && input.size() > 0) || (output.data() == nullptr && output.size() > 0)) {
+    return error_code_t::kInvalidParam;
+  }
+
+  switch (algorithm_) {
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZSTD)
+    case algorithm_t::kZstd: {
+      size_t ret = ZSTD_compress2(ctx->zstd_cctx, output.data(), output.size(), input.data(), input.size());
+      if (ZSTD_isError(ret)) {
+        return ZSTD_getErrorCode(ret) == ZSTD_error_dstSize_tooSmall ? error_code_t::kBufferTooSmall
+                                                                      : error_code_t::kOperation;
+      }
+      output_size = ret;
+      return error_code_t::kOk;
+    }
+#  endif
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_LZ4)
+    case algorithm_t::kLz4: {
+      int input_size = 0;
+      if (!_size_to_int(input.size(), input_size)) {
+        return error_code_t::kInvalidParam;
+      }
+      int output_capacity = 0;
+      if (!_size_to_int(output.size(), output_capacity)) {
+        output_capacity = _numeric_limits_max<int>();
+      }
+
+      // Fast reset keeps the hash table allocation and drops the previous message, so every output is an
+      // independent block just like LZ4_compress_default()/LZ4_compress_HC()
+      int result_size = 0;
+      if (ctx->lz4_high_compression) {
+        LZ4_resetStreamHC_fast(ctx->lz4hc_stream, ctx->level);
+        result_size = LZ4_compress_HC_continue(ctx->lz4hc_stream, reinterpret_cast<const char*>(input.data()),
+                                               reinterpret_cast<char*>(output.data()), input_size, output_capacity);
+      } else {
+        LZ4_resetStream_fast(ctx->lz4_stream);
+        result_size = LZ4_compress_fast_continue(ctx->lz4_stream, reinterpret_cast<const char*>(input.data()),
+                                                 reinterpret_cast<char*>(output.data()), input_size, output_capacity,
+                                                 ctx->level <= 0 ? 1 : ctx->level);
+      }
+
+      if (result_size <= 0) {
+        return output.size() < compress_bound(input.size()) ? error_code_t::kBufferTooSmall
+                                                            : error_code_t::kOperation;
+      }
+      output_size = static_cast<size_t>(result_size);
+      return error_code_t::kOk;
+    }
+#  endif
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_SNAPPY)
+    case algorithm_t::kSnappy: {
+      size_t output_len = output.size();
+      if (output_len < snappy_max_compressed_length(input.size())) {
+        return error_code_t::kBufferTooSmall;
+      }
+      if (snappy_compress(reinterpret_cast<const char*>(input.data()), input.size(),
+                          reinterpret_cast<char*>(output.data()), &output_len) != SNAPPY_OK) {
+        return error_code_t::kOperation;
+      }
+      output_size = output_len;
+      return error_code_t::kOk;
+    }
+#  endif
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZLIB)
+    case algorithm_t::kZlib: {
+      z_stream& zs = ctx->zlib_stream;
+      if (deflateReset(&zs) != Z_OK) {
+        return error_code_t::kOperation;
+      }
+
+      size_t in_left = input.size();
+      size_t out_left = output.size();
+      zs.next_in = const_cast<Bytef*>(reinterpret_cast<const Bytef*>(input.data()));
+      zs.avail_in = 0;
+      zs.next_out = reinterpret_cast<Bytef*>(output.data());
+      zs.avail_out = 0;
+      while (true) {
+        if (zs.avail_in == 0 && in_left > 0) {
+          zs.avail_in = _zlib_chunk_size(in_left);
+          in_left -= zs.avail_in;
+        }
+        if (zs.avail_out == 0 && out_left > 0) {
+          zs.avail_out = _zlib_chunk_size(out_left);
+          out_left -= zs.avail_out;
+        }
+
+        int zret = deflate(&zs, in_left == 0 ? Z_FINISH : Z_NO_FLUSH);
+        if (zret == Z_STREAM_END) {
+          break;
+        }
+        if (zret != Z_OK && zret != Z_BUF_ERROR) {
+          return error_code_t::kOperation;
+        }
+        if (zs.avail_out == 0 && out_left == 0) {
+          return error_code_t::kBufferTooSmall;
+        }
+      }
+
+      output_size = output.size() - out_left - zs.avail_out;
+      return error_code_t::kOk;
+    }
+#  endif
+    default:
+      return error_code_t::kNotSupport;
+  }
+}
+
+int compressor::compress(gsl::span<const unsigned char> input, std::vector<unsigned char>& output) noexcept {
+  size_t bound = compress_bound(input.size());
+  if (bound == 0) {
+    output.clear();
+    return error_code_t::kInvalidParam;
+  }
+  if (!_resize_output(output, bound)) {
+    return error_code_t::kOperation;
+  }
+
+  size_t output_size = 0;
+  int ret = compress(input, gsl::span<unsigned char>(output.data(), output.size()), output_size);
+  if (ret != error_code_t::kOk) {
+    output.clear();
+    return ret;
+  }
+
+  // Shrinking never reallocates, the capacity is reused by the next call
+  output.resize(output_size);
+  return error_code_t::kOk;
+}
+
+int compressor::stream_begin() noexcept {
+  compressor_context* ctx = reinterpret_cast<compressor_context*>(context_);
+  if (ctx == nullptr) {
+    return error_code_t::kInvalidParam;
+  }
+
+  switch (algorithm_) {
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZSTD)
+    case algorithm_t::kZstd:
+      // Session reset keeps parameters and the loaded dictionary
+      if (ZSTD_isError(ZSTD_CCtx_reset(ctx->zstd_cctx, ZSTD_reset_session_only))) {
+        return error_code_t::kOperation;
+      }
+      return error_code_t::kOk;
+#  endif
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_LZ4)
+    case algorithm_t::kLz4:
+      if (ctx->lz4f_cctx == nullptr && LZ4F_isError(LZ4F_createCompressionContext(&ctx->lz4f_cctx, LZ4F_VERSION))) {
+        ctx->lz4f_cctx = nullptr;
+        return error_code_t::kOperation;
+      }
+      memset(&ctx->lz4f_preferences, 0, sizeof(ctx->lz4f_preferences));
+      // LZ4F uses negative levels for fast acceleration
+      if (ctx->lz4_high_compression) {
+        ctx->lz4f_preferences.compressionLevel = ctx->level;
+      } else if (ctx->level > 1) {
+        ctx->lz4f_preferences.compressionLevel = -ctx->level;
+      }
+      // Frame header is written by the first stream_update() or stream_end()
+      ctx->lz4f_header_pending = true;
+      return error_code_t::kOk;
+#  endif
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZLIB)
+    case algorithm_t::kZlib:
+      if (deflateReset(&ctx->zlib_stream) != Z_OK) {
+        return error_code_t::kOperation;
+      }
+      return error_code_t::kOk;
+#  endif
+    default:
+      return error_code_t::kNotSupport;
+  }
+}
+
+int compressor::stream_update(gsl::span<const unsigned char> input, std::vector<unsigned char>& output) noexcept {
+  compressor_context* ctx = reinterpret_cast<compressor_context*>(context_);
+  if (ctx == nullptr || (input.data() == nullptr && input.size() > 0)) {
+    return error_code_t::kInvalidParam;
+  }
+
+  size_t used = output.size();
+  int ret = error_code_t::kNotSupport;
+  switch (algorithm_) {
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZSTD)
+    case algorithm_t::kZstd: {
+      ZSTD_inBuffer in_buffer = {input.data(), input.size(), 0};
+      ret = error_code_t::kOk;
+      while (in_buffer.pos < in_buffer.size) {
+        size_t space = _reserve_output_space(output, used, ZSTD_CStreamOutSize());
+        if (space == 0) {
+          ret = error_code_t::kOperation;
+          break;
+        }
+        ZSTD_outBuffer out_buffer = {output.data() + used, space, 0};
+        size_t zret = ZSTD_compressStream2(ctx->zstd_cctx, &out_buffer, &in_buffer, ZSTD_e_continue);
+        used += out_buffer.pos;
+        if (ZSTD_isError(zret)) {
+          ret = error_code_t::kOperation;
+          break;
+        }
+      }
+      break;
+    }
+#  endif
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_LZ4)
+    case algorithm_t::kLz4: {
+      if (ctx->lz4f_cctx == nullptr) {
+        ret = error_code_t::kInvalidParam;
+        break;
+      }
+
+      size_t bound = LZ4F_HEADER_SIZE_MAX + LZ4F_compressBound(input.size(), &ctx->lz4f_preferences);
+      size_t space = _reserve_output_space(output, used, bound);
+      if (space == 0) {
+        ret = error_code_t::kOperation;
+        break;
+      }
+      if (ctx->lz4f_header_pending) {
+        size_t header_size = LZ4F_compressBegin(ctx->lz4f_cctx, output.data() + used, space, &ctx->lz4f_preferences);
+        if (LZ4F_isError(header_size)) {
+          ret = error_code_t::kOperation;
+          break;
+        }
+        ctx->lz4f_header_pending = false;
+        used += header_size;
+        space -= header_size;
+      }
+      size_t lret =
+          LZ4F_compressUpdate(ctx->lz4f_cctx, output.data() + used, space, input.data(), input.size(), nullptr);
+      if (LZ4F_isError(lret)) {
+        ret = error_code_t::kOperation;
+        break;
+      }
+      used += lret;
+      ret = error_code_t::kOk;
+      break;
+    }
+#  endif
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZLIB)
+    case algorithm_t::kZlib:
+      ret = _zlib_stream_deflate(ctx->zlib_stream, input, output, used, false);
+      break;
+#  endif
+    default:
+      break;
+  }
+
+  output.resize(used);
+  return ret;
+}
+
+int compressor::stream_end(std::vector<unsigned char>& output) noexcept {
+  compressor_context* ctx = reinterpret_cast<compressor_context*>(context_);
+  if (ctx == nullptr) {
+    return error_code_t::kInvalidParam;
+  }
+
+  size_t used = output.size();
+  int ret = error_code_t::kNotSupport;
+  switch (algorithm_) {
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZSTD)
+    case algorithm_t::kZstd: {
+      ZSTD_inBuffer in_buffer = {nullptr, 0, 0};
+      ret = error_code_t::kOk;
+      while (true) {
+        size_t space = _reserve_output_space(output, used, ZSTD_CStreamOutSize());
+        if (space == 0) {
+          ret = error_code_t::kOperation;
+          break;
+        }
+        ZSTD_outBuffer out_buffer = {output.data() + used, space, 0};
+        size_t remaining = ZSTD_compressStream2(ctx->zstd_cctx, &out_buffer, &in_buffer, ZSTD_e_end);
+        used += out_buffer.pos;
+        if (ZSTD_isError(remaining)) {
+          ret = error_code_t::kOperation;
+          break;
+        }
+        if (remaining == 0) {
+          break;
+        }
+      }
+      break;
+    }
+#  endif
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_LZ4)
+    case algorithm_t::kLz4: {
+      if (ctx->lz4f_cctx == nullptr) {
+        ret = error_code_t::kInvalidParam;
+        break;
+      }
+
+      size_t space =
+          _reserve_output_space(output, used, LZ4F_HEADER_SIZE_MAX + LZ4F_compressBound(0, &ctx->lz4f_preferences));
+      if (space == 0) {
+        ret = error_code_t::kOperation;
+        break;
+      }
+      if (ctx->lz4f_header_pending) {
+        size_t header_size = LZ4F_compressBegin(ctx->lz4f_cctx, output.data() + used, space, &ctx->lz4f_preferences);
+        if (LZ4F_isError(header_size)) {
+          ret = error_code_t::kOperation;
+          break;
+        }
+        ctx->lz4f_header_pending = false;
+        used += header_size;
+        space -= header_size;
+      }
+      size_t lret = LZ4F_compressEnd(ctx->lz4f_cctx, output.data() + used, space, nullptr);
+      if (LZ4F_isError(lret)) {
+        ret = error_code_t::kOperation;
+        break;
+      }
+      used += lret;
+      ret = error_code_t::kOk;
+      break;
+    }
+#  endif
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZLIB)
+    case algorithm_t::kZlib:
+      ret = _zlib_stream_deflate(ctx->zlib_stream, gsl::span<const unsigned char>(), output, used, true);
+      break;
+#  endif
+    default:
+      break;
+  }
+
+  output.resize(used);
+  return ret;
+}
+
+// ============================ decompressor ============================
+
+decompressor::decompressor() noexcept : algorithm_(algorithm_t::kNone), context_(nullptr) {}
+
+decompressor::~decompressor() { close(); }
+
+decompressor::decompressor(decompressor&& other) noexcept : algorithm_(other.algorithm_), context_(other.context_) {
+  other.algorithm_ = algorithm_t::kNone;
+  other.context_ = nullptr;
+}
+
+decompressor& decompressor::operator=(decompressor&& other) noexcept {
+  if (this != &other) {
+    close();
+    algorithm_ = other.algorithm_;
+    context_ = other.context_;
+    other.algorithm_ = algorithm_t::kNone;
+    other.context_ = nullptr;
+  }
+  return *this;
+}
+
+int decompressor::init(algorithm_t type) noexcept {
+  close();
+
+  int ret = _check_algorithm(type);
+  if (ret != error_code_t::kOk) {
+    return ret;
+  }
+
+  decompressor_context* ctx = new (std::nothrow) decompressor_context();
+  if (ctx == nullptr) {
+    return error_code_t::kOperation;
+  }
+
+  bool success = true;
+  switch (type) {
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZSTD)
+    case algorithm_t::kZstd:
+      ctx->zstd_dctx = ZSTD_createDCtx();
+      success = ctx->zstd_dctx != nullptr;
+      break;
+#  endif
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZLIB)
+    case algorithm_t::kZlib:
+      ctx->zlib_inited = inflateInit(&ctx->zlib_stream) == Z_OK;
+      success = ctx->zlib_inited;
+      break;
+#  endif
+    default:
+      // Raw LZ4 block and snappy decoding are stateless
+      break;
+  }
+
+  if (!success) {
+    _free_decompressor_context(ctx);
+    return error_code_t::kOperation;
+  }
+
+  algorithm_ = type;
+  context_ = ctx;
+  return error_code_t::kOk;
+}
+
+void decompressor::close() noexcept {
+  _free_decompressor_context(reinterpret_cast<decompressor_context*>(context_));
+  context_ = nullptr;
+  algorithm_ = algorithm_t::kNone;
+}
+
+bool decompressor::is_valid() const noexcept { return context_ != nullptr; }
+
+algorithm_t decompressor::get_algorithm() const noexcept { return algorithm_; }
+
+int decompressor::load_dictionary(gsl::span<const unsigned char> dictionary) noexcept {
+  decompressor_context* ctx = reinterpret_cast<decompressor_context*>(context_);
+  if (ctx == nullptr || (dictionary.data() == nullptr && dictionary.size() > 0)) {
+    return error_code_t::kInvalidParam;
+  }
+
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZSTD)
+  if (algorithm_ == algorithm_t::kZstd) {
+    ZSTD_DDict* ddict = nullptr;
+    if (!dictionary.empty()) {
+      ddict = ZSTD_createDDict(dictionary.data(), dictionary.size());
+      if (ddict == nullptr) {
+        return error_code_t::kOperation;
+      }
+    }
+
+    if (ZSTD_isError(ZSTD_DCtx_refDDict(ctx->zstd_dctx, ddict))) {
+      ZSTD_freeDDict(ddict);
+      return error_code_t::kOperation;
+    }
+
+    ZSTD_freeDDict(ctx->zstd_ddict);
+    ctx->zstd_ddict = ddict;
+    return error_code_t::kOk;
+  }
+#  endif
+
+  return error_code_t::kNotSupport;
+}
+
+int decompressor::decompress(gsl::span<const unsigned char> input, gsl::span<unsigned char> output,
+                             size_t& output_size) noexcept {
+  output_size = 0;
+  decompressor_context* ctx = reinterpret_cast<decompressor_context*>(context_);
+  if (ctx == nullptr) {
+    return error_code_t::kInvalidParam;
+  }
+  if ((input.data() == nullptr && input.size() > 0) || (output.data() == nullptr && output.size() > 0)) {
+    return error_code_t::kInvalidParam;
+  }
+
+  switch (algorithm_) {
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZSTD)
+    case algorithm_t::kZstd: {
+      // ZSTD_decompressDCtx() uses the dictionary referenced by ZSTD_DCtx_refDDict()
+      size_t ret = ZSTD_decompressDCtx(ctx->zstd_dctx, output.data(), output.size(), input.data(), input.size());
+      if (ZSTD_isError(ret)) {
+        return ZSTD_getErrorCode(ret) == ZSTD_error_dstSize_tooSmall ? error_code_t::kBufferTooSmall
+                                                                      : error_code_t::kOperation;
+      }
+      output_size = ret;
+      return error_code_t::kOk;
+    }
+#  endif
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_LZ4)
+    case algorithm_t::kLz4: {
+      int input_size = 0;
+      if (!_size_to_int(input.size(), input_size)) {
+        return error_code_t::kInvalidParam;
+      }
+      int output_capacity = 0;
+      if (!_size_to_int(output.size(), output_capacity)) {
+        output_capacity = _numeric_limits_max<int>();
+      }
+      int ret = LZ4_decompress_safe(reinterpret_cast<const char*>(input.data()), reinterpret_cast<char*>(output.data()),
+                                    input_size, output_capacity);
+      if (ret < 0) {
+        return error_code_t::kOperation;
+      }
+      output_size = static_cast<size_t>(ret);
+      return error_code_t::kOk;
+    }
+#  endif
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_SNAPPY)
+    case algorithm_t::kSnappy: {
+      size_t expect_size = 0;
+      if (snappy_uncompressed_length(reinterpret_cast<const char*>(input.data()), input.size(), &expect_size) !=
+          SNAPPY_OK) {
+        return error_code_t::kOperation;
+      }
+      if (expect_size > output.size()) {
+        return error_code_t::kBufferTooSmall;
+      }
+      if (snappy_uncompress(reinterpret_cast<const char*>(input.data()), input.size(),
+                            reinterpret_cast<char*>(output.data()), &expect_size) != SNAPPY_OK) {
+        return error_code_t::kOperation;
+      }
+      output_size = expect_size;
+      return error_code_t::kOk;
+    }
+#  endif
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZLIB)
+    case algorithm_t::kZlib: {
+      z_stream& zs = ctx->zlib_stream;
+      if (inflateReset(&zs) != Z_OK) {
+        return error_code_t::kOperation;
+      }
+
+      size_t in_left = input.size();
+      size_t out_left = output.size();
+      zs.next_in = const_cast<Bytef*>(reinterpret_cast<const Bytef*>(input.data()));
+      zs.avail_in = 0;
+      zs.next_out = reinterpret_cast<Bytef*>(output.data());
+      zs.avail_out = 0;
+      while (true) {
+        if (zs.avail_in == 0 && in_left > 0) {
+          zs.avail_in = _zlib_chunk_size(in_left);
+          in_left -= zs.avail_in;
+        }
+        if (zs.avail_out == 0 && out_left > 0) {
+          zs.avail_out = _zlib_chunk_size(out_left);
+          out_left -= zs.avail_out;
+        }
+
+        int zret = inflate(&zs, Z_NO_FLUSH);
+        if (zret == Z_STREAM_END) {
+          break;
+        }
+        if (zret != Z_OK && zret != Z_BUF_ERROR) {
+          return error_code_t::kOperation;
+        }
+        if (zs.avail_out == 0 && out_left == 0) {
+          return error_code_t::kBufferTooSmall;
+        }
+        if (zret == Z_BUF_ERROR && zs.avail_in == 0 && in_left == 0) {
+          // Truncated input
+          return error_code_t::kOperation;
+        }
+      }
+
+      output_size = output.size() - out_left - zs.avail_out;
+      return error_code_t::kOk;
+    }
+#  endif
+    default:
+      return error_code_t::kNotSupport;
+  }
+}
+
+int decompressor::decompress(gsl::span<const unsigned char> input, size_t original_size,
+                             std::vector<unsigned char>& output) noexcept {
+  if (context_ == nullptr || (input.data() == nullptr && input.size() > 0)) {
+    output.clear();
+    return error_code_t::kInvalidParam;
+  }
+
+  // Same size rules as compression::decompress()
+  size_t expect_size = original_size;
+  if (expect_size == 0) {
+    switch (algorithm_) {
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZSTD)
+      case algorithm_t::kZstd: {
+        unsigned long long frame_size = ZSTD_getFrameContentSize(input.data(), input.size());
+        if (frame_size == ZSTD_CONTENTSIZE_ERROR || frame_size == ZSTD_CONTENTSIZE_UNKNOWN) {
+          output.clear();
+          return error_code_t::kInvalidParam;
+        }
+        expect_size = static_cast<size_t>(frame_size);
+        break;
+      }
+#  endif
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_SNAPPY)
+      case algorithm_t::kSnappy:
+        if (snappy_uncompressed_length(reinterpret_cast<const char*>(input.data()), input.size(), &expect_size) !=
+            SNAPPY_OK) {
+          output.clear();
+          return error_code_t::kInvalidParam;
+        }
+        break;
+#  endif
+      default:
+        output.clear();
+        return error_code_t::kInvalidParam;
+    }
+  }
+
+  if (!_resize_output(output, expect_size)) {
+    return error_code_t::kOperation;
+  }
+
+  size_t output_size = 0;
+  int ret = decompress(input, gsl::span<unsigned char>(output.data(), output.size()), output_size);
+  if (ret == error_code_t::kOk && algorithm_ == algorithm_t::kLz4 && output_size != expect_size) {
+    ret = error_code_t::kOperation;
+  }
+  if (ret != error_code_t::kOk) {
+    output.clear();
+    return ret;
+  }
+
+  output.resize(output_size);
+  return error_code_t::kOk;
+}
+
+int decompressor::stream_begin() noexcept {
+  decompressor_context* ctx = reinterpret_cast<decompressor_context*>(context_);
+  if (ctx == nullptr) {
+    return error_code_t::kInvalidParam;
+  }
+
+  ctx->stream_finished = false;
+  switch (algorithm_) {
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZSTD)
+    case algorithm_t::kZstd:
+      if (ZSTD_isError(ZSTD_DCtx_reset(ctx->zstd_dctx, ZSTD_reset_session_only))) {
+        return error_code_t::kOperation;
+      }
+      return error_code_t::kOk;
+#  endif
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_LZ4)
+    case algorithm_t::kLz4:
+      if (ctx->lz4f_dctx == nullptr) {
+        if (LZ4F_isError(LZ4F_createDecompressionContext(&ctx->lz4f_dctx, LZ4F_VERSION))) {
+          ctx->lz4f_dctx = nullptr;
+          return error_code_t::kOperation;
+        }
+      } else {
+        LZ4F_resetDecompressionContext(ctx->lz4f_dctx);
+      }
+      return error_code_t::kOk;
+#  endif
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZLIB)
+    case algorithm_t::kZlib:
+      if (inflateReset(&ctx->zlib_stream) != Z_OK) {
+        return error_code_t::kOperation;
+      }
+      return error_code_t::kOk;
+#  endif
+    default:
+      return error_code_t::kNotSupport;
+  }
+}
+
+int decompressor::stream_update(gsl::span<const unsigned char> input, std::vector<unsigned char>& output) noexcept {
+  decompressor_context* ctx = reinterpret_cast<decompressor_context*>(context_);
+  if (ctx == nullptr || (input.data() == nullptr && input.size() > 0)) {
+    return error_code_t::kInvalidParam;
+  }
+  if (ctx->stream_finished) {
+    return error_code_t::kOk;
+  }
+
+  size_t used = output.size();
+  int ret = error_code_t::kNotSupport;
+  switch (algorithm_) {
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZSTD)
+    case algorithm_t::kZstd: {
+      ZSTD_inBuffer in_buffer = {input.data(), input.size(), 0};
+      ret = error_code_t::kOk;
+      while (true) {
+        size_t space = _reserve_output_space(output, used, ZSTD_DStreamOutSize());
+        if (space == 0) {
+          ret = error_code_t::kOperation;
+          break;
+        }
+        ZSTD_outBuffer out_buffer = {output.data() + used, space, 0};
+        size_t zret = ZSTD_decompressStream(ctx->zstd_dctx, &out_buffer, &in_buffer);
+        used += out_buffer.pos;
+        if (ZSTD_isError(zret)) {
+          ret = error_code_t::kOperation;
+          break;
+        }
+        if (zret == 0) {
+          ctx->stream_finished = true;
+          break;
+        }
+        // Output not full means everything decodable from the input so far has been flushed
+        if (in_buffer.pos == in_buffer.size && out_buffer.pos < out_buffer.size) {
+          break;
+        }
+      }
+      break;
+    }
+#  endif
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_LZ4)
+    case algorithm_t::kLz4: {
+      if (ctx->lz4f_dctx == nullptr) {
+        ret = error_code_t::kInvalidParam;
+        break;
+      }
+
+      const unsigned char* in = input.data();
+      size_t in_left = input.size();
+      ret = error_code_t::kOk;
+      while (true) {
+        // 64KB is the default LZ4F block size
+        size_t space = _reserve_output_space(output, used, 65536);
+        if (space == 0) {
+          ret = error_code_t::kOperation;
+          break;
+        }
+        size_t out_size = space;
+        size_t in_size = in_left;
+        size_t hint = LZ4F_decompress(ctx->lz4f_dctx, output.data() + used, &out_size, in, &in_size, nullptr);
+        if (LZ4F_isError(hint)) {
+          ret = error_code_t::kOperation;
+          break;
+        }
+        in += in_size;
+        in_left -= in_size;
+        used += out_size;
+        if (hint == 0) {
+          ctx->stream_finished = true;
+          break;
+        }
+        if (in_left == 0 && out_size < space) {
+          break;
+        }
+      }
+      break;
+    }
+#  endif
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZLIB)
+    case algorithm_t::kZlib: {
+      z_stream& zs = ctx->zlib_stream;
+      const unsigned char* in = input.data();
+      size_t in_left = input.size();
+      zs.avail_in = 0;
+      ret = error_code_t::kOk;
+      while (true) {
+        if (zs.avail_in == 0 && in_left > 0) {
+          zs.next_in = const_cast<Bytef*>(reinterpret_cast<const Bytef*>(in));
+          zs.avail_in = _zlib_chunk_size(in_left);
+          in += zs.avail_in;
+          in_left -= zs.avail_in;
+        }
+
+        size_t space = _reserve_output_space(output, used, kZlibStreamChunkSize);
+        if (space == 0) {
+          ret = error_code_t::kOperation;
+          break;
+        }
+        zs.next_out = reinterpret_cast<Bytef*>(output.data() + used);
+        zs.avail_out = _zlib_chunk_size(space);
+        uInt out_chunk = zs.avail_out;
+
+        int zret = inflate(&zs, Z_NO_FLUSH);
+        used += out_chunk - zs.avail_out;
+        if (zret == Z_STREAM_END) {
+          ctx->stream_finished = true;
+          break;
+        }
+        if (zret != Z_OK && zret != Z_BUF_ERROR) {
+          ret = error_code_t::kOperation;
+          break;
+        }
+        if (zs.avail_in == 0 && in_left == 0 && zs.avail_out != 0) {
+          break;
+        }
+      }
+      break;
+    }
+#  endif
+    default:
+      break;
+  }
+
+  output.resize(used);
+  return ret;
+}
+
+bool decompressor::is_stream_finished() const noexcept {
+  const decompressor_context* ctx = reinterpret_cast<const decompressor_context*>(context_);
+  return ctx != nullptr && ctx->stream_finished;
+}
+
+int compressor::set_worker_count(size_t worker_count) noexcept {
+  compressor_context* ctx = reinterpret_cast<compressor_context*>(context_);
+  if (ctx == nullptr) {
+    return error_code_t::kInvalidParam;
+  }
+
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZSTD)
+  if (algorithm_ == algorithm_t::kZstd) {
+    int workers = 0;
+    if (!_size_to_int(worker_count, workers)) {
+      return error_code_t::kInvalidParam;
+    }
+    // libzstd without ZSTD_MULTITHREAD rejects any nbWorkers other than 0
+    if (ZSTD_isError(ZSTD_CCtx_setParameter(ctx->zstd_cctx, ZSTD_c_nbWorkers, workers))) {
+      return error_code_t::kNotSupport;
+    }
+    return error_code_t::kOk;
+  }
+#  endif
+
+  return worker_count == 0 ? error_code_t::kOk : error_code_t::kNotSupport;
+}
+
+// ============================ block container ============================
+
+namespace {
+
+static constexpr const unsigned char kBlockContainerMagic[4] = {'A', 'T', 'C', 'B'};
+static constexpr const unsigned char kBlockContainerVersion = 1;
+static constexpr const size_t kBlockContainerHeaderSize = 32;
+static constexpr const size_t kBlockContainerIndexEntrySize = 16;
+static constexpr const size_t kBlockContainerDefaultBlockSize = 1 << 20;
+// Keep block sizes inside the int range of LZ4 and the uInt range of zlib
+static constexpr const size_t kBlockContainerMaxBlockSize = static_cast<size_t>(1) << 30;
+
+static void _write_le32(unsigned char* output, uint32_t value) noexcept {
+  for (size_t i = 0; i < 4; ++i) {
+    output[i] = static_cast<unsigned char>(value >> (i * 8));
+  }
+}
+
+static void _write_le64(unsigned char* output, uint64_t value) noexcept {
+  for (size_t i = 0; i < 8; ++i) {
+    output[i] = static_cast<unsigned char>(value >> (i * 8));
+  }
+}
+
+static uint32_t _read_le32(const unsigned char* input) noexcept {
+  uint32_t ret = 0;
+  for (size_t i = 0; i < 4; ++i) {
+    ret |= static_cast<uint32_t>(input[i]) << (i * 8);
+  }
+  return ret;
+}
+
+static uint64_t _read_le64(const unsigned char* input) noexcept {
+  uint64_t ret = 0;
+  for (size_t i = 0; i < 8; ++i) {
+    ret |= static_cast<uint64_t>(input[i]) << (i * 8);
+  }
+  return ret;
+}
+
+// Every thread taking part in parallel_for uses its own context, indexed by the slot
+template <class TWorker>
+static int _parallel_for_blocks(thread::work_stealing_pool* pool, size_t block_count, TWorker& worker) noexcept {
+  using context_type = typename TWorker::context_type;
+  if (pool == nullptr || block_count <= 1) {
+    context_type context;
+    for (size_t i = 0; i < block_count; ++i) {
+      int ret = worker(context, i);
+      if (ret != error_code_t::kOk) {
+        return ret;
+      }
+    }
+    return error_code_t::kOk;
+  }
+
+  std::unique_ptr<context_type[]> contexts;
+  std::atomic<int> result{error_code_t::kOk};
+#  if defined(ATFRAMEWORK_UTILS_ENABLE_EXCEPTION) && ATFRAMEWORK_UTILS_ENABLE_EXCEPTION
+  try {
+#  endif
+    contexts.reset(new context_type[pool->get_parallel_slot_count(block_count)]);
+    pool->parallel_for(block_count, [&worker, &contexts, &result](size_t slot, size_t index) {
+      if (result.load(std::memory_order_relaxed) != error_code_t::kOk) {
+        return;
+      }
+      int ret = worker(contexts[slot], index);
+      if (ret != error_code_t::kOk) {
+        int expected = error_code_t::kOk;
+        result.compare_exchange_strong(expected, ret, std::memory_order_relaxed);
+      }
+    });
+#  if defined(ATFRAMEWORK_UTILS_ENABLE_EXCEPTION) && ATFRAMEWORK_UTILS_ENABLE_EXCEPTION
+  } catch (...) {
+    return error_code_t::kOperation;
+  }
+#  endif
+  return result.load(std::memory_order_relaxed);
+}
+
+struct ATFW_UTIL_SYMBOL_LOCAL compress_block_worker {
+  using context_type = compressor;
+
+  algorithm_t algorithm;
+  level_t level;
+  const unsigned char* input;
+  size_t input_size;
+  size_t block_size;
+  unsigned char* slots;
+  size_t slot_size;
+  size_t* compressed_sizes;
+
+  int operator()(compressor& context, size_t index) const noexcept {
+    if (!context.is_valid()) {
+      int ret = context.init(algorithm, level);
+      if (ret != error_code_t::kOk) {
+        return ret;
+      }
+    }
+
+    size_t offset = index * block_size;
+    size_t length = input_size - offset < block_size ? input_size - offset : block_size;
+    return context.compress(gsl::span<const unsigned char>(input + offset, length),
+                            gsl::span<unsigned char>(slots + index * slot_size, slot_size), compressed_sizes[index]);
+  }
+};
+
+struct ATFW_UTIL_SYMBOL_LOCAL decompress_block_worker {
+  using context_type = decompressor;
+
+  algorithm_t algorithm;
+  const unsigned char* container;
+  const block_info* blocks;
+  unsigned char* output;
+
+  int operator()(decompressor& context, size_t index) const noexcept {
+    if (!context.is_valid()) {
+      int ret = context.init(algorithm);
+      if (ret != error_code_t::kOk) {
+        return ret;
+      }
+    }
+
+    const block_info& block = blocks[index];
+    size_t output_size = 0;
+    int ret = context.decompress(gsl::span<const unsigned char>(container + block.compressed_offset,
+                                                                block.compressed_size),
+                                 gsl::span<unsigned char>(output + block.original_offset, block.original_size),
+                                 output_size);
+    if (ret == error_code_t::kOk && output_size != block.original_size) {
+      return error_code_t::kBadFormat;
+    }
+    return ret;
+  }
+};
+
+}  // namespace
+
+ATFRAMEWORK_UTILS_API int compress_blocks(algorithm_t type, gsl::span<const unsigned char> input,
+                                          std::vector<unsigned char>& output, level_t level, size_t block_size,
+                                          thread::work_stealing_pool* pool) noexcept {
+  output.clear();
+  if (input.data() == nullptr && input.size() > 0) {
+    return error_code_t::kInvalidParam;
+  }
+  if (block_size == 0) {
+    block_size = kBlockContainerDefaultBlockSize;
+  }
+  if (block_size > kBlockContainerMaxBlockSize) {
+    return error_code_t::kInvalidParam;
+  }
+
+  // Compressor of the calling thread also validates algorithm and gives the bound of each block
+  compressor bound_checker;
+  int ret = bound_checker.init(type, level);
+  if (ret != error_code_t::kOk) {
+    return ret;
+  }
+
+  size_t block_count = (input.size() + block_size - 1) / block_size;
+  size_t slot_size = bound_checker.compress_bound(block_size < input.size() ? block_size : input.size());
+  size_t data_offset = kBlockContainerHeaderSize + block_count * kBlockContainerIndexEntrySize;
+  if (block_count > 0 && (slot_size == 0 || slot_size > (_numeric_limits_max<size_t>() - data_offset) / block_count)) {
+    return error_code_t::kInvalidParam;
+  }
+  bound_checker.close();
+
+  std::vector<size_t> compressed_sizes;
+  if (!_resize_output(output, data_offset + block_count * slot_size)) {
+    return error_code_t::kOperation;
+  }
+#  if defined(ATFRAMEWORK_UTILS_ENABLE_EXCEPTION) && ATFRAMEWORK_UTILS_ENABLE_EXCEPTION
+  try {
+#  endif
+    compressed_sizes.resize(block_count, 0);
+#  if defined(ATFRAMEWORK_UTILS_ENABLE_EXCEPTION) && ATFRAMEWORK_UTILS_ENABLE_EXCEPTION
+  } catch (...) {
+    output.clear();
+    return error_code_t::kOperation;
+  }
+#  endif
+
+  // Every block is compressed into its own slot and then compacted, so workers never share output memory
+  if (block_count > 0) {
+    compress_block_worker worker;
+    worker.algorithm = type;
+    worker.level = level;
+    worker.input = input.data();
+    worker.input_size = input.size();
+    worker.block_size = block_size;
+    worker.slots = output.data() + data_offset;
+    worker.slot_size = slot_size;
+    worker.compressed_sizes = compressed_sizes.data();
+    ret = _parallel_for_blocks(pool, block_count, worker);
+    if (ret != error_code_t::kOk) {
+      output.clear();
+      return ret;
+    }
+  }
+
+  unsigned char* header = output.data();
+  memcpy(header, kBlockContainerMagic, sizeof(kBlockContainerMagic));
+  header[4] = kBlockContainerVersion;
+  header[5] = 0;
+  header[6] = 0;
+  header[7] = 0;
+  _write_le32(header + 8, static_cast<uint32_t>(type));
+  _write_le32(header + 12, static_cast<uint32_t>(block_size));
+  _write_le64(header + 16, static_cast<uint64_t>(block_count));
+  _write_le64(header + 24, static_cast<uint64_t>(input.size()));
+
+  size_t compressed_offset = 0;
+  for (size_t i = 0; i < block_count; ++i) {
+    size_t original_size = input.size() - i * block_size < block_size ? input.size() - i * block_size : block_size;
+    unsigned char* entry = output.data() + kBlockContainerHeaderSize + i * kBlockContainerIndexEntrySize;
+    _write_le64(entry, static_cast<uint64_t>(compressed_offset));
+    _write_le32(entry + 8, static_cast<uint32_t>(compressed_sizes[i]));
+    _write_le32(entry + 12, static_cast<uint32_t>(original_size));
+
+    // Destination is never after source, memmove keeps the order
+    if (compressed_offset != i * slot_size) {
+      memmove(output.data() + data_offset + compressed_offset, output.data() + data_offset + i * slot_size,
+              compressed_sizes[i]);
+    }
+    compressed_offset += compressed_sizes[i];
+  }
+
+  output.resize(data_offset + compressed_offset);
+  return error_code_t::kOk;
+}
+
+ATFRAMEWORK_UTILS_API int decompress_blocks(gsl::span<const unsigned char> input, std::vector<unsigned char>& output,
+                                            thread::work_stealing_pool* pool, size_t max_output_size) noexcept {
+  output.clear();
+
+  block_container_reader reader;
+  int ret = reader.open(input);
+  if (ret != error_code_t::kOk) {
+    return ret;
+  }
+
+  // 头部的原始长度不可信，分配输出缓冲区前先检查调用方的上限
+  const block_container_info& info = reader.get_info();
+  if (max_output_size != 0 && info.original_size > max_output_size) {
+    return error_code_t::kBufferTooSmall;
+  }
+  std::vector<block_info> blocks;
+#  if defined(ATFRAMEWORK_UTILS_ENABLE_EXCEPTION) && ATFRAMEWORK_UTILS_ENABLE_EXCEPTION
+  try {
+#  endif
+    blocks.resize(info.block_count);
+#  if defined(ATFRAMEWORK_UTILS_ENABLE_EXCEPTION) && ATFRAMEWORK_UTILS_ENABLE_EXCEPTION
+  } catch (...) {
+    return error_code_t::kOperation;
+  }
+#  endif
+  for (size_t i = 0; i < info.block_count; ++i) {
+    reader.get_block_info(i, blocks[i]);
+  }
+
+  if (!_resize_output(output, info.original_size)) {
+    return error_code_t::kOperation;
+  }
+  if (info.block_count == 0) {
+    return error_code_t::kOk;
+  }
+
+  decompress_block_worker worker;
+  worker.algorithm = info.algorithm;
+  worker.container = input.data();
+  worker.blocks = blocks.data();
+  worker.output = output.data();
+  ret = _parallel_for_blocks(pool, info.block_count, worker);
+  if (ret != error_code_t::kOk) {
+    output.clear();
+  }
+  return ret;
+}
+
+block_container_reader::block_container_reader() noexcept : data_offset_(0), info_{algorithm_t::kNone, 0, 0, 0} {}
+
+int block_container_reader::open(gsl::span<const unsigned char> container) noexcept {
+  close();
+
+  if (container.data() == nullptr || container.size() < kBlockContainerHeaderSize) {
+    return error_code_t::kBadFormat;
+  }
+  const unsigned char* header = container.data();
+  if (0 != memcmp(header, kBlockContainerMagic, sizeof(kBlockContainerMagic)) ||
+      header[4] != kBlockContainerVersion) {
+    return error_code_t::kBadFormat;
+  }
+
+  uint64_t block_size = _read_le32(header + 12);
+  uint64_t block_count = _read_le64(header + 16);
+  uint64_t original_size = _read_le64(header + 24);
+  algorithm_t algorithm = static_cast<algorithm_t>(_read_le32(header + 8));
+  if (block_size == 0 || block_size > kBlockContainerMaxBlockSize || original_size > _numeric_limits_max<size_t>()) {
+    return error_code_t::kBadFormat;
+  }
+  // original_size可能接近uint64上限，不能用 (original_size + block_size - 1) / block_size
+  if (block_count != original_size / block_size + (original_size % block_size != 0 ? 1 : 0)) {
+    return error_code_t::kBadFormat;
+  }
+  if (block_count > (container.size() - kBlockContainerHeaderSize) / kBlockContainerIndexEntrySize) {
+    return error_code_t::kBadFormat;
+  }
+
+  size_t data_offset = kBlockContainerHeaderSize + static_cast<size_t>(block_count) * kBlockContainerIndexEntrySize;
+  size_t data_size = container.size() - data_offset;
+  for (size_t i = 0; i < block_count; ++i) {
+    const unsigned char* entry = container.data() + kBlockContainerHeaderSize + i * kBlockContainerIndexEntrySize;
+    uint64_t compressed_offset = _read_le64(entry);
+    uint64_t compressed_size = _read_le32(entry + 8);
+    uint64_t block_original_size = _read_le32(entry + 12);
+    uint64_t expect_original_size = original_size - i * block_size < block_size ? original_size - i * block_size
+                                                                                  : block_size;
+    if (compressed_offset > data_size || compressed_size > data_size - compressed_offset ||
+        block_original_size != expect_original_size) {
+      return error_code_t::kBadFormat;
+    }
+  }
+
+  int ret = decompressor_.init(algorithm);
+  if (ret != error_code_t::kOk) {
+    return ret == error_code_t::kInvalidParam ? error_code_t::kBadFormat : ret;
+  }
+
+  container_ = container;
+  data_offset_ = data_offset;
+  info_.algorithm = algorithm;
+  info_.block_size = static_cast<size_t>(block_size);
+  info_.block_count = static_cast<size_t>(block_count);
+  info_.original_size = static_cast<size_t>(original_size);
+  return error_code_t::kOk;
+}
+
+void block_container_reader::close() noexcept {
+  container_ = gsl::span<const unsigned char>();
+  data_offset_ = 0;
+  info_.algorithm = algorithm_t::kNone;
+  info_.block_size = 0;
+  info_.block_count = 0;
+  info_.original_size = 0;
+  decompressor_.close();
+}
+
+bool block_container_reader::is_valid() const noexcept { return decompressor_.is_valid(); }
+
+const block_container_info& block_container_reader::get_info() const noexcept { return info_; }
+
+int block_container_reader::get_block_info(size_t index, block_info& output) const noexcept {
+  if (index >= info_.block_count) {
+    return error_code_t::kInvalidParam;
+  }
+
+  // Index has been validated by open()
+  const unsigned char* entry = container_.data() + kBlockContainerHeaderSize + index * kBlockContainerIndexEntrySize;
+  output.original_offset = index * info_.block_size;
+  output.original_size = static_cast<size_t>(_read_le32(entry + 12));
+  output.compressed_offset = data_offset_ + static_cast<size_t>(_read_le64(entry));
+  output.compressed_size = static_cast<size_t>(_read_le32(entry + 8));
+  return error_code_t::kOk;
+}
+
+size_t block_container_reader::find_block(size_t original_offset) const noexcept {
+  if (original_offset >= info_.original_size) {
+    return info_.block_count;
+  }
+  return original_offset / info_.block_size;
+}
+
+int block_container_reader::decompress_block(size_t index, std::vector<unsigned char>& output) noexcept {
+  block_info block;
+  int ret = get_block_info(index, block);
+  if (ret != error_code_t::kOk) {
+    output.clear();
+    return ret;
+  }
+  if (!_resize_output(output, block.original_size)) {
+    return error_code_t::kOperation;
+  }
+
+  size_t output_size = 0;
+  ret = decompress_block(index, gsl::span<unsigned char>(output.data(), output.size()), output_size);
+  if (ret != error_code_t::kOk) {
+    output.clear();
+  }
+  return ret;
+}
+
+int block_container_reader::decompress_block(size_t index, gsl::span<unsigned char> output,
+                                             size_t& output_size) noexcept {
+  output_size = 0;
+  block_info block;
+  int ret = get_block_info(index, block);
+  if (ret != error_code_t::kOk) {
+    return ret;
+  }
+  if (output.size() < block.original_size) {
+    return error_code_t::kBufferTooSmall;
+  }
+
+  ret = decompressor_.decompress(container_.subspan(block.compressed_offset, block.compressed_size),
+                                 output.subspan(0, block.original_size), output_size);
+  if (ret == error_code_t::kOk && output_size != block.original_size) {
+    output_size = 0;
+    return error_code_t::kBadFormat;
+  }
+  return ret;
+}
+
+// ============================ adaptive policy ============================
+
+ATFRAMEWORK_UTILS_API double estimate_entropy(gsl::span<const unsigned char> input, size_t sample_size) noexcept {
+  if (input.data() == nullptr || input.empty() || sample_size == 0) {
+    return 0.0;
+  }
+
+  uint32_t histogram[256] = {0};
+  size_t sampled = 0;
+  if (input.size() <= sample_size) {
+    for (unsigned char c : input) {
+      ++histogram[c];
+    }
+    sampled = input.size();
+  } else {
+    // Several chunks spread over the payload, headers and padding do not dominate the estimation
+    const size_t chunk_count = sample_size >= 1024 ? 4 : 1;
+    const size_t chunk_size = sample_size / chunk_count;
+    for (size_t i = 0; i < chunk_count; ++i) {
+      size_t offset = chunk_count > 1 ? (input.size() - chunk_size) / (chunk_count - 1) * i : 0;
+      const unsigned char* chunk = input.data() + offset;
+      for (size_t j = 0; j < chunk_size; ++j) {
+        ++histogram[chunk[j]];
+      }
+      sampled += chunk_size;
+    }
+  }
+
+  double entropy = 0.0;
+  size_t used_symbols = 0;
+  const double total = static_cast<double>(sampled);
+  for (uint32_t count : histogram) {
+    if (count == 0) {
+      continue;
+    }
+    ++used_symbols;
+    double p = static_cast<double>(count) / total;
+    entropy -= p * std::log2(p);
+  }
+
+  // Miller-Madow correction, small samples of random data underestimate the entropy
+  entropy += static_cast<double>(used_symbols - 1) / (2.0 * total * 0.6931471805599453);
+  return entropy > 8.0 ? 8.0 : entropy;
+}
+
+adaptive_policy::adaptive_policy() : adaptive_policy(adaptive_policy_options()) {}
+
+adaptive_policy::adaptive_policy(const adaptive_policy_options& options) : options_(options) {
+  if (options_.candidates.empty()) {
+    for (algorithm_t algorithm : get_supported_algorithms()) {
+      if (algorithm == algorithm_t::kSnappy) {
+        // Snappy has no levels
+        options_.candidates.push_back(adaptive_candidate{algorithm, level_t::kDefault});
+        continue;
+      }
+      options_.candidates.push_back(adaptive_candidate{algorithm, level_t::kFast});
+      options_.candidates.push_back(adaptive_candidate{algorithm, level_t::kBalanced});
+    }
+  }
+
+  adaptive_policy_stats empty_stats;
+  empty_stats.sample_count = 0;
+  empty_stats.compression_ratio = 1.0;
+  empty_stats.nanoseconds_per_byte = 0.0;
+  stats_.resize(options_.candidates.size() * kSizeBucketCount, empty_stats);
+  for (size_t i = 0; i < kSizeBucketCount; ++i) {
+    buckets_[i].decision_count = 0;
+    buckets_[i].explore_cursor = 0;
+  }
+}
+
+adaptive_decision adaptive_policy::choose(gsl::span<const unsigned char> input) noexcept {
+  adaptive_decision ret;
+  ret.skip = true;
+  ret.candidate_index = 0;
+  ret.algorithm = algorithm_t::kNone;
+  ret.level = level_t::kDefault;
+  ret.size_bucket = get_size_bucket(input.size());
+  ret.entropy = -1.0;
+
+  const size_t candidate_count = options_.candidates.size();
+  if (candidate_count == 0 || input.size() < options_.min_input_size) {
+    return ret;
+  }
+
+  // Sampling is much cheaper than compressing data which will not shrink
+  ret.entropy = estimate_entropy(input, options_.entropy_sample_size);
+  if (ret.entropy > options_.max_entropy) {
+    return ret;
+  }
+
+  lock::lock_holder<lock::spin_lock> holder(lock_);
+  bucket_state& bucket = buckets_[ret.size_bucket];
+  const adaptive_policy_stats* stats = &stats_[ret.size_bucket * candidate_count];
+  ++bucket.decision_count;
+
+  size_t selected = candidate_count;
+  bool force_compress = false;
+  for (size_t i = 0; i < candidate_count; ++i) {
+    if (stats[i].sample_count < kWarmupSamples) {
+      selected = i;
+      force_compress = true;
+      break;
+    }
+  }
+
+  if (selected >= candidate_count && options_.explore_interval > 0 &&
+      bucket.decision_count % options_.explore_interval == 0) {
+    selected = (bucket.explore_cursor++) % candidate_count;
+    force_compress = true;
+  }
+
+  if (selected >= candidate_count) {
+    size_t best_in_budget = candidate_count;
+    size_t fastest = 0;
+    for (size_t i = 0; i < candidate_count; ++i) {
+      if (stats[i].nanoseconds_per_byte < stats[fastest].nanoseconds_per_byte) {
+        fastest = i;
+      }
+      if (options_.cpu_budget_ns_per_byte > 0 && stats[i].nanoseconds_per_byte > options_.cpu_budget_ns_per_byte) {
+        continue;
+      }
+      if (best_in_budget >= candidate_count || stats[i].compression_ratio < stats[best_in_budget].compression_ratio ||
+          (stats[i].compression_ratio == stats[best_in_budget].compression_ratio &&
+           stats[i].nanoseconds_per_byte < stats[best_in_budget].nanoseconds_per_byte)) {
+        best_in_budget = i;
+      }
+    }
+    selected = best_in_budget < candidate_count ? best_in_budget : fastest;
+  }
+
+  if (!force_compress && 1.0 - stats[selected].compression_ratio < options_.min_saving_ratio) {
+    return ret;
+  }
+
+  ret.skip = false;
+  ret.candidate_index = selected;
+  ret.algorithm = options_.candidates[selected].algorithm;
+  ret.level = options_.candidates[selected].level;
+  return ret;
+}
+
+void adaptive_policy::report(const adaptive_decision& decision, size_t input_size, size_t output_size,
+                             uint64_t cpu_time_ns) noexcept {
+  if (decision.skip || input_size == 0 || decision.candidate_index >= options_.candidates.size() ||
+      decision.size_bucket >= kSizeBucketCount) {
+    return;
+  }
+
+  double ratio = static_cast<double>(output_size) / static_cast<double>(input_size);
+  double ns_per_byte = static_cast<double>(cpu_time_ns) / static_cast<double>(input_size);
+
+  lock::lock_holder<lock::spin_lock> holder(lock_);
+  adaptive_policy_stats& stats = stats_[decision.size_bucket * options_.candidates.size() + decision.candidate_index];
+  if (stats.sample_count == 0) {
+    stats.compression_ratio = ratio;
+    stats.nanoseconds_per_byte = ns_per_byte;
+  } else {
+    // Exponential moving average with weight 1/8, follows payload changes within a few dozens of samples
+    stats.compression_ratio += (ratio - stats.compression_ratio) / 8.0;
+    stats.nanoseconds_per_byte += (ns_per_byte - stats.nanoseconds_per_byte) / 8.0;
+  }
+  ++stats.sample_count;
+}
+
+int adaptive_policy::compress(gsl::span<const unsigned char> input, std::vector<unsigned char>& output,
+                              adaptive_decision& decision) noexcept {
+  output.clear();
+  if (input.data() == nullptr && input.size() > 0) {
+    return error_code_t::kInvalidParam;
+  }
+
+  decision = choose(input);
+  if (decision.skip) {
+    return error_code_t::kOk;
+  }
+
+  std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+  int ret = compression::compress(decision.algorithm, input, output, decision.level);
+  std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+  if (ret != error_code_t::kOk) {
+    output.clear();
+    return ret;
+  }
+
+  report(decision, input.size(), output.size(),
+         static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count()));
+
+  if (static_cast<double>(output.size()) > static_cast<double>(input.size()) * (1.0 - options_.min_saving_ratio)) {
+    output.clear();
+    decision.skip = true;
+    decision.algorithm = algorithm_t::kNone;
+  }
+  return error_code_t::kOk;
+}
+
+const std::vector<adaptive_candidate>& adaptive_policy::get_candidates() const noexcept {
+  return options_.candidates;
+}
+
+const adaptive_policy_options& adaptive_policy::get_options() const noexcept { return options_; }
+
+adaptive_policy_stats adaptive_policy::get_stats(size_t candidate_index, size_t size_bucket) const noexcept {
+  adaptive_policy_stats ret;
+  ret.sample_count = 0;
+  ret.compression_ratio = 1.0;
+  ret.nanoseconds_per_byte = 0.0;
+  if (candidate_index >= options_.candidates.size() || size_bucket >= kSizeBucketCount) {
+    return ret;
+  }
+
+  lock::lock_holder<lock::spin_lock> holder(lock_);
+  return stats_[size_bucket * options_.candidates.size() + candidate_index];
+}
+
+size_t adaptive_policy::get_size_bucket(size_t input_size) noexcept {
+  size_t bucket = 0;
+  size_t limit = 256;
+  while (bucket + 1 < kSizeBucketCount && input_size >= limit) {
+    ++bucket;
+    limit <<= 2;
+  }
+  return bucket;
+}
+
 }  // namespace compression
 ATFRAMEWORK_UTILS_NAMESPACE_END
 
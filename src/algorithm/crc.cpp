@@ -7,9 +7,18 @@
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <memory>
 
 #include "algorithm/crc.h"
 
+#include "algorithm/bit.h"
+#include "common/cpu_features.h"
+#include "config/compile_optimize.h"
+
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+#  include <immintrin.h>
+#endif
+
 ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
 namespace {
 
@@ -174,45 +183,447 @@ static constexpr const uint64_t crc64_tab[256] = {
     UINT64_C(0x29b7d047efec8728),
 };
 
+static constexpr const uint16_t crc16_poly = 0x1021;
+static constexpr const uint32_t crc32_poly_reflected = 0xedb88320;
+// CRC32C(Castagnoli)，和 SSE4.2 的 crc32 指令一致
+static constexpr const uint32_t crc32c_poly_reflected = 0x82f63b78;
+static constexpr const uint64_t crc64_poly_reflected = UINT64_C(0x95ac9329ac4bc9b5);
+
+enum crc_slice_consts : size_t {
+  CRC_SLICE_MAX = 16,
+  CRC16_SLICE_MAX = 8,
+  // 小于这个长度时多表查询的收益低于额外的缓存占用
+  CRC_SLICE_MIN_LENGTH = 16,
+  // PCLMULQDQ 一次折叠 4*16 字节
+  CRC_FOLD_MIN_LENGTH = 64,
+};
+
+// PCLMULQDQ 折叠常量，[0] 乘低64位(消息中靠前的部分)，[1] 乘高64位
+struct crc_fold_constants {
+  uint64_t fold_512[2];
+  uint64_t fold_128[2];
+};
+
+struct crc_slice_tables {
+  uint16_t crc16[CRC16_SLICE_MAX][256];
+  uint32_t crc32[CRC_SLICE_MAX][256];
+  uint32_t crc32c[CRC_SLICE_MAX][256];
+  uint64_t crc64[CRC_SLICE_MAX][256];
+
+  crc_fold_constants crc32_fold;
+  crc_fold_constants crc64_fold;
+
+  bool has_pclmul;
+  bool has_sse42;
+};
+
+// 反射多项式下的 x^n mod P，结果左对齐到64位(系数 x^j 在第 63-j 位)，用于 PCLMULQDQ 折叠
+template <class T>
+static uint64_t crc_reflected_xnmodp_aligned(size_t n, T poly) {
+  T r = static_cast<T>(static_cast<T>(1) << (sizeof(T) * 8 - 1));
+  for (size_t i = 0; i < n; ++i) {
+    r = (r & 1) ? static_cast<T>((r >> 1) ^ poly) : static_cast<T>(r >> 1);
+  }
+  return static_cast<uint64_t>(r) << (64 - sizeof(T) * 8);
+}
+
+template <class T>
+static void crc_fill_fold_constants(crc_fold_constants &out, T poly) {
+  // 128位块 X = H*x^64 + L 向后移动 D 位: H*x^(D+64) + L*x^D，PCLMULQDQ 的反射乘积会多乘一个 x，所以常量要除以 x
+  out.fold_512[0] = crc_reflected_xnmodp_aligned<T>(512 + 64 - 1, poly);
+  out.fold_512[1] = crc_reflected_xnmodp_aligned<T>(512 - 1, poly);
+  out.fold_128[0] = crc_reflected_xnmodp_aligned<T>(128 + 64 - 1, poly);
+  out.fold_128[1] = crc_reflected_xnmodp_aligned<T>(128 - 1, poly);
+}
+
+// T[k][b] = 字节 b 后面跟 k 个0字节的CRC
+template <class T, size_t N>
+static void crc_fill_reflected_slice_tables(T (&tables)[N][256]) {
+  for (size_t k = 1; k < N; ++k) {
+    for (size_t b = 0; b < 256; ++b) {
+      T prev = tables[k - 1][b];
+      tables[k][b] = static_cast<T>((prev >> 8) ^ tables[0][prev & 0xff]);
+    }
+  }
+}
+
+static crc_slice_tables *create_crc_slice_tables() {
+  crc_slice_tables *ret = new crc_slice_tables();
+
+  for (size_t b = 0; b < 256; ++b) {
+    ret->crc16[0][b] = crc16_tab[b];
+    ret->crc32[0][b] = crc32_tab[b];
+    ret->crc64[0][b] = crc64_tab[b];
+
+    uint32_t c = static_cast<uint32_t>(b);
+    for (int i = 0; i < 8; ++i) {
+      c = (c & 1) ? (c >> 1) ^ crc32c_poly_reflected : (c >> 1);
+    }
+    ret->crc32c[0][b] = c;
+  }
+
+  for (size_t k = 1; k < CRC16_SLICE_MAX; ++k) {
+    for (size_t b = 0; b < 256; ++b) {
+      uint16_t prev = ret->crc16[k - 1][b];
+      ret->crc16[k][b] = static_cast<uint16_t>(static_cast<uint16_t>(prev << 8) ^ ret->crc16[0][prev >> 8]);
+    }
+  }
+  crc_fill_reflected_slice_tables(ret->crc32);
+  crc_fill_reflected_slice_tables(ret->crc32c);
+  crc_fill_reflected_slice_tables(ret->crc64);
+
+  crc_fill_fold_constants<uint32_t>(ret->crc32_fold, crc32_poly_reflected);
+  crc_fill_fold_constants<uint64_t>(ret->crc64_fold, crc64_poly_reflected);
+
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+  const platform::cpu_features &features = platform::get_cpu_features();
+  ret->has_pclmul = features.has_pclmulqdq && features.has_sse41;
+  ret->has_sse42 = features.has_sse42;
+#else
+  ret->has_pclmul = false;
+  ret->has_sse42 = false;
+#endif
+  return ret;
+}
+
+static const crc_slice_tables &get_crc_slice_tables() {
+  static std::unique_ptr<crc_slice_tables> ret(create_crc_slice_tables());
+  return *ret;
+}
+
+// ---------------- 单字节查表 ----------------
+static inline uint16_t crc16_byte_table(const unsigned char *s, size_t l, uint16_t crc) {
+  for (size_t j = 0; j < l; ++j) {
+    crc = static_cast<uint16_t>(crc << 8) ^ crc16_tab[((crc >> 8) ^ static_cast<uint16_t>(s[j])) & 0x00FF];
+  }
+  return crc;
+}
+
+template <class T>
+static inline T crc_reflected_byte_table(const T *table, const unsigned char *s, size_t l, T crc) {
+  for (size_t j = 0; j < l; ++j) {
+    crc = table[static_cast<unsigned char>(crc) ^ s[j]] ^ static_cast<T>(crc >> 8);
+  }
+  return crc;
+}
+
+// ---------------- slice-by-N ----------------
+template <size_t N>
+static uint16_t crc16_slice(const crc_slice_tables &tables, const unsigned char *s, size_t l, uint16_t crc) {
+  while (l >= N) {
+    uint16_t ret = tables.crc16[N - 1][s[0] ^ (crc >> 8)] ^ tables.crc16[N - 2][s[1] ^ (crc & 0xff)];
+    for (size_t i = 2; i < N; ++i) {
+      ret ^= tables.crc16[N - 1 - i][s[i]];
+    }
+    crc = ret;
+    s += N;
+    l -= N;
+  }
+  return crc16_byte_table(s, l, crc);
+}
+
+ATFW_UTIL_FORCEINLINE static uint32_t crc_load_le(const unsigned char *s, uint32_t *) noexcept {
+  return bit::read_le_uint32(s);
+}
+
+ATFW_UTIL_FORCEINLINE static uint64_t crc_load_le(const unsigned char *s, uint64_t *) noexcept {
+  return bit::read_le_uint64(s);
+}
+
+template <class T, size_t N>
+static T crc_reflected_slice(const T (&tables)[CRC_SLICE_MAX][256], const unsigned char *s, size_t l, T crc) {
+  static_assert(N >= sizeof(T) && N <= CRC_SLICE_MAX, "invalid slice size");
+  while (l >= N) {
+    // 当前CRC异或到块的前 sizeof(T) 个字节，块内第 i 个字节使用 T[N - 1 - i]
+    T head = static_cast<T>(crc_load_le(s, static_cast<T *>(nullptr)) ^ crc);
+    T ret = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+      ret ^= tables[N - 1 - i][static_cast<unsigned char>(head >> (i * 8))];
+    }
+    for (size_t i = sizeof(T); i < N; ++i) {
+      ret ^= tables[N - 1 - i][s[i]];
+    }
+    crc = ret;
+    s += N;
+    l -= N;
+  }
+  return crc_reflected_byte_table(tables[0], s, l, crc);
+}
+
+// ---------------- 硬件加速 ----------------
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+ATFW_UTIL_FORCEINLINE ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("pclmul,sse4.1") static __m128i crc_pclmul_fold(__m128i x, __m128i k,
+                                                                                            __m128i data) {
+  return _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x00), _mm_clmulepi64_si128(x, k, 0x11)), data);
+}
+
+/**
+ * @brief 使用 PCLMULQDQ 把 l(>=64) 字节折叠成16字节，剩余部分的CRC等价于 CRC(0, out[16] + 未处理的数据)
+ * @return 已处理的字节数
+ */
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("pclmul,sse4.1")
+static size_t crc_pclmul_fold_blocks(const crc_fold_constants &k, const unsigned char *s, size_t l, uint64_t crc,
+                                     unsigned char out[16]) {
+  const __m128i k512 =
+      _mm_set_epi64x(static_cast<long long>(k.fold_512[1]), static_cast<long long>(k.fold_512[0]));  // NOLINT
+  const __m128i k128 =
+      _mm_set_epi64x(static_cast<long long>(k.fold_128[1]), static_cast<long long>(k.fold_128[0]));  // NOLINT
+
+  // 初始CRC异或到消息开头
+  __m128i x0 = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(s)),
+                             _mm_set_epi64x(0, static_cast<long long>(crc)));  // NOLINT
+  __m128i x1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + 16));
+  __m128i x2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + 32));
+  __m128i x3 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + 48));
+  size_t offset = 64;
+
+  while (l - offset >= 64) {
+    x0 = crc_pclmul_fold(x0, k512, _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + offset)));
+    x1 = crc_pclmul_fold(x1, k512, _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + offset + 16)));
+    x2 = crc_pclmul_fold(x2, k512, _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + offset + 32)));
+    x3 = crc_pclmul_fold(x3, k512, _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + offset + 48)));
+    offset += 64;
+  }
+
+  __m128i x = crc_pclmul_fold(x0, k128, x1);
+  x = crc_pclmul_fold(x, k128, x2);
+  x = crc_pclmul_fold(x, k128, x3);
+  while (l - offset >= 16) {
+    x = crc_pclmul_fold(x, k128, _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + offset)));
+    offset += 16;
+  }
+
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(out), x);
+  return offset;
+}
+
+template <class T>
+static T crc_reflected_pclmul(const crc_fold_constants &k, const T (&tables)[CRC_SLICE_MAX][256],
+                              const unsigned char *s, size_t l, T crc) {
+  unsigned char folded[16];
+  size_t offset = crc_pclmul_fold_blocks(k, s, l, static_cast<uint64_t>(crc), folded);
+  // 最后的 16 字节和不足 16 字节的尾部直接查表，不需要 Barrett 归约
+  crc = crc_reflected_slice<T, 16>(tables, folded, 16, 0);
+  return crc_reflected_slice<T, 16>(tables, s + offset, l - offset, crc);
+}
+
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("sse4.2")
+static uint32_t crc32c_sse42(const unsigned char *s, size_t l, uint32_t crc) {
+#  if defined(ATFW_UTIL_MACRO_ARCH_X86_64)
+  uint64_t crc64_val = crc;
+  while (l >= 8) {
+    crc64_val = _mm_crc32_u64(crc64_val, bit::read_le_uint64(s));
+    s += 8;
+    l -= 8;
+  }
+  crc = static_cast<uint32_t>(crc64_val);
+#  endif
+  while (l >= 4) {
+    crc = _mm_crc32_u32(crc, bit::read_le_uint32(s));
+    s += 4;
+    l -= 4;
+  }
+  while (l > 0) {
+    crc = _mm_crc32_u8(crc, *s);
+    ++s;
+    --l;
+  }
+  return crc;
+}
+#endif
+
+// ---------------- 组合 ----------------
+// 反射多项式下的 a*b mod P
+template <class T>
+static T crc_reflected_multmodp(T a, T b, T poly) {
+  T ret = 0;
+  for (T m = static_cast<T>(static_cast<T>(1) << (sizeof(T) * 8 - 1)); m != 0 && a != 0; m >>= 1) {
+    if (a & m) {
+      ret ^= b;
+      a ^= m;
+    }
+    b = (b & 1) ? static_cast<T>((b >> 1) ^ poly) : static_cast<T>(b >> 1);
+  }
+  return ret;
+}
+
+// crc * x^(8*len) mod P
+template <class T>
+static T crc_reflected_shift(T crc, size_t len, T poly) {
+  // x^8
+  T base = static_cast<T>(static_cast<T>(1) << (sizeof(T) * 8 - 1 - 8));
+  while (len > 0 && crc != 0) {
+    if (len & 1) {
+      crc = crc_reflected_multmodp(crc, base, poly);
+    }
+    base = crc_reflected_multmodp(base, base, poly);
+    len >>= 1;
+  }
+  return crc;
+}
+
+static uint16_t crc16_multmodp(uint16_t a, uint16_t b) {
+  uint16_t ret = 0;
+  for (int i = 15; i >= 0; --i) {
+    ret = (ret & 0x8000) ? static_cast<uint16_t>(static_cast<uint16_t>(ret << 1) ^ crc16_poly)
+                         : static_cast<uint16_t>(ret << 1);
+    if (a & (1 << i)) {
+      ret ^= b;
+    }
+  }
+  return ret;
+}
+
+static uint16_t crc16_shift(uint16_t crc, size_t len) {
+  uint16_t base = static_cast<uint16_t>(1 << 8);
+  while (len > 0 && crc != 0) {
+    if (len & 1) {
+      crc = crc16_multmodp(crc, base);
+    }
+    base = crc16_multmodp(base, base);
+    len >>= 1;
+  }
+  return crc;
+}
+
+static crc_engine_t crc_select_engine(crc_engine_t engine, size_t l, bool has_hardware, size_t hardware_min_length) {
+  if (crc_engine_t::kAuto == engine) {
+    if (has_hardware && l >= hardware_min_length) {
+      return crc_engine_t::kHardware;
+    }
+    return l >= CRC_SLICE_MIN_LENGTH ? crc_engine_t::kSlice16 : crc_engine_t::kByteTable;
+  }
+
+  if (crc_engine_t::kHardware == engine && (!has_hardware || l < hardware_min_length)) {
+    return crc_engine_t::kSlice16;
+  }
+  return engine;
+}
+
 }  // namespace
 
 ATFRAMEWORK_UTILS_API uint16_t crc16(const unsigned char *s, size_t l, uint16_t init_val) {
+  return crc16_with_engine(crc_engine_t::kAuto, s, l, init_val);
+}
+
+ATFRAMEWORK_UTILS_API uint32_t crc32(const unsigned char *s, size_t l, uint32_t init_val) {
+  return crc32_with_engine(crc_engine_t::kAuto, s, l, init_val);
+}
+
+ATFRAMEWORK_UTILS_API uint32_t crc32c(const unsigned char *s, size_t l, uint32_t init_val) {
+  return crc32c_with_engine(crc_engine_t::kAuto, s, l, init_val);
+}
+
+ATFRAMEWORK_UTILS_API uint64_t crc64(const unsigned char *s, size_t l, uint64_t init_val) {
+  return crc64_with_engine(crc_engine_t::kAuto, s, l, init_val);
+}
+
+ATFRAMEWORK_UTILS_API uint16_t crc16_with_engine(crc_engine_t engine, const unsigned char *s, size_t l,
+                                                 uint16_t init_val) {
   if (s == nullptr) {
     return init_val;
   }
-  size_t j = 0;
-  for (j = 0; j < l; ++j) {
-    unsigned char byte = s[j];
-    init_val =
-        static_cast<uint16_t>(init_val << 8) ^ crc16_tab[((init_val >> 8) ^ static_cast<uint16_t>(byte)) & 0x00FF];
+
+  engine = crc_select_engine(engine, l, false, 0);
+  if (crc_engine_t::kByteTable == engine) {
+    return crc16_byte_table(s, l, init_val);
   }
-  return init_val;
+
+  // crc16 只有 slice-by-8
+  return crc16_slice<CRC16_SLICE_MAX>(get_crc_slice_tables(), s, l, init_val);
 }
 
-ATFRAMEWORK_UTILS_API uint32_t crc32(const unsigned char *s, size_t l, uint32_t init_val) {
+ATFRAMEWORK_UTILS_API uint32_t crc32_with_engine(crc_engine_t engine, const unsigned char *s, size_t l,
+                                                 uint32_t init_val) {
   if (s == nullptr) {
     return init_val;
   }
-  size_t j = 0;
-  for (j = 0; j < l; ++j) {
-    unsigned char byte = s[j];
-    init_val = crc32_tab[static_cast<unsigned char>(init_val) ^ static_cast<uint32_t>(byte)] ^ (init_val >> 8);
+
+  if (crc_engine_t::kByteTable == engine || (crc_engine_t::kAuto == engine && l < CRC_SLICE_MIN_LENGTH)) {
+    return crc_reflected_byte_table(crc32_tab, s, l, init_val);
   }
 
-  return init_val;
+  const crc_slice_tables &tables = get_crc_slice_tables();
+  switch (crc_select_engine(engine, l, tables.has_pclmul, CRC_FOLD_MIN_LENGTH)) {
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+    case crc_engine_t::kHardware:
+      return crc_reflected_pclmul(tables.crc32_fold, tables.crc32, s, l, init_val);
+#endif
+    case crc_engine_t::kSlice8:
+      return crc_reflected_slice<uint32_t, 8>(tables.crc32, s, l, init_val);
+    case crc_engine_t::kByteTable:
+      return crc_reflected_byte_table(crc32_tab, s, l, init_val);
+    default:
+      return crc_reflected_slice<uint32_t, 16>(tables.crc32, s, l, init_val);
+  }
 }
 
-ATFRAMEWORK_UTILS_API uint64_t crc64(const unsigned char *s, size_t l, uint64_t init_val) {
+ATFRAMEWORK_UTILS_API uint32_t crc32c_with_engine(crc_engine_t engine, const unsigned char *s, size_t l,
+                                                  uint32_t init_val) {
+  if (s == nullptr) {
+    return init_val;
+  }
+
+  const crc_slice_tables &tables = get_crc_slice_tables();
+  switch (crc_select_engine(engine, l, tables.has_sse42, 0)) {
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+    case crc_engine_t::kHardware:
+      return crc32c_sse42(s, l, init_val);
+#endif
+    case crc_engine_t::kSlice8:
+      return crc_reflected_slice<uint32_t, 8>(tables.crc32c, s, l, init_val);
+    case crc_engine_t::kByteTable:
+      return crc_reflected_byte_table(tables.crc32c[0], s, l, init_val);
+    default:
+      return crc_reflected_slice<uint32_t, 16>(tables.crc32c, s, l, init_val);
+  }
+}
+
+ATFRAMEWORK_UTILS_API uint64_t crc64_with_engine(crc_engine_t engine, const unsigned char *s, size_t l,
+                                                 uint64_t init_val) {
   if (s == nullptr) {
     return init_val;
   }
-  size_t j = 0;
-  for (j = 0; j < l; ++j) {
-    unsigned char byte = s[j];
-    init_val = crc64_tab[static_cast<unsigned char>(init_val) ^ static_cast<uint64_t>(byte)] ^ (init_val >> 8);
+
+  if (crc_engine_t::kByteTable == engine || (crc_engine_t::kAuto == engine && l < CRC_SLICE_MIN_LENGTH)) {
+    return crc_reflected_byte_table(crc64_tab, s, l, init_val);
+  }
+
+  const crc_slice_tables &tables = get_crc_slice_tables();
+  switch (crc_select_engine(engine, l, tables.has_pclmul, CRC_FOLD_MIN_LENGTH)) {
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+    case crc_engine_t::kHardware:
+      return crc_reflected_pclmul(tables.crc64_fold, tables.crc64, s, l, init_val);
+#endif
+    case crc_engine_t::kSlice8:
+      return crc_reflected_slice<uint64_t, 8>(tables.crc64, s, l, init_val);
+    case crc_engine_t::kByteTable:
+      return crc_reflected_byte_table(crc64_tab, s, l, init_val);
+    default:
+      return crc_reflected_slice<uint64_t, 16>(tables.crc64, s, l, init_val);
   }
+}
+
+ATFRAMEWORK_UTILS_API bool crc32_has_hardware_engine() { return get_crc_slice_tables().has_pclmul; }
+
+ATFRAMEWORK_UTILS_API bool crc32c_has_hardware_engine() { return get_crc_slice_tables().has_sse42; }
+
+ATFRAMEWORK_UTILS_API bool crc64_has_hardware_engine() { return get_crc_slice_tables().has_pclmul; }
+
+ATFRAMEWORK_UTILS_API uint16_t crc16_combine(uint16_t crc1, uint16_t crc2, size_t len2, uint16_t init_val) {
+  return static_cast<uint16_t>(crc16_shift(static_cast<uint16_t>(crc1 ^ init_val), len2) ^ crc2);
+}
+
+ATFRAMEWORK_UTILS_API uint32_t crc32_combine(uint32_t crc1, uint32_t crc2, size_t len2, uint32_t init_val) {
+  return crc_reflected_shift<uint32_t>(crc1 ^ init_val, len2, crc32_poly_reflected) ^ crc2;
+}
+
+ATFRAMEWORK_UTILS_API uint32_t crc32c_combine(uint32_t crc1, uint32_t crc2, size_t len2, uint32_t init_val) {
+  return crc_reflected_shift<uint32_t>(crc1 ^ init_val, len2, crc32c_poly_reflected) ^ crc2;
+}
 
-  return init_val;
+ATFRAMEWORK_UTILS_API uint64_t crc64_combine(uint64_t crc1, uint64_t crc2, size_t len2, uint64_t init_val) {
+  return crc_reflected_shift<uint64_t>(crc1 ^ init_val, len2, crc64_poly_reflected) ^ crc2;
 }
 ATFRAMEWORK_UTILS_NAMESPACE_END
 
@@ -18,6 +18,7 @@
 
 #include <cstdint>
 #include <cstring>
+#include <limits>
 #include <string>
 #include <utility>
 #include <vector>
@@ -1752,6 +1753,259 @@ ATFRAMEWORK_UTILS_API int cipher::decrypt_aead(const unsigned char *input, size_
   }
 }
 
+namespace {
+#  if defined(ATFRAMEWORK_UTILS_CRYPTO_USE_OPENSSL) || defined(ATFRAMEWORK_UTILS_CRYPTO_USE_LIBRESSL) || \
+      defined(ATFRAMEWORK_UTILS_CRYPTO_USE_BORINGSSL)
+static int aead_batch_process_packet(cipher &ci, cipher::cipher_evp_t *ctx, uint32_t flags, bool is_encrypt,
+                                     const unsigned char *nonce, cipher::aead_packet_t &packet, size_t tag_len) {
+  // Only reset nonce here, key schedule of ctx is kept
+  if (!EVP_CipherInit_ex(ctx, nullptr, nullptr, nullptr, nonce, -1)) {
+    return setup_errorno(ci, static_cast<int64_t>(ERR_peek_error()), cipher::error_code_t::kCipherOperationSetIv);
+  }
+
+  if (!is_encrypt && tag_len > 0) {
+    if (!EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_SET_TAG, static_cast<int>(tag_len), packet.tag.data())) {
+      return setup_errorno(ci, static_cast<int64_t>(ERR_peek_error()), cipher::error_code_t::kCipherOperation);
+    }
+  }
+
+  int outl = 0;
+  if (0 != (flags & EN_CIFT_AEAD_SET_LENGTH_BEFORE)) {
+    if (!EVP_CipherUpdate(ctx, nullptr, &outl, nullptr, static_cast<int>(packet.data.size()))) {
+      return setup_errorno(ci, static_cast<int64_t>(ERR_peek_error()), cipher::error_code_t::kCipherOperation);
+    }
+  }
+
+  if (!packet.ad.empty()) {
+    if (!EVP_CipherUpdate(ctx, nullptr, &outl, packet.ad.data(), static_cast<int>(packet.ad.size()))) {
+      return setup_errorno(ci, static_cast<int64_t>(ERR_peek_error()), cipher::error_code_t::kCipherOperation);
+    }
+  }
+
+  // AEAD modes are stream modes, so the whole packet is produced by update and can be processed in place
+  outl = 0;
+  if (!packet.data.empty()) {
+    if (!EVP_CipherUpdate(ctx, packet.data.data(), &outl, packet.data.data(), static_cast<int>(packet.data.size())) ||
+        static_cast<size_t>(outl) != packet.data.size()) {
+      return setup_errorno(ci, static_cast<int64_t>(ERR_peek_error()), cipher::error_code_t::kCipherOperation);
+    }
+  }
+
+  if (0 == (flags & EN_CIFT_NO_FINISH)) {
+    unsigned char final_block[EVP_MAX_BLOCK_LENGTH];
+    int finish_olen = 0;
+    if (!EVP_CipherFinal_ex(ctx, final_block, &finish_olen) || 0 != finish_olen) {
+      return setup_errorno(ci, static_cast<int64_t>(ERR_peek_error()), cipher::error_code_t::kCipherOperation);
+    }
+  }
+
+  if (is_encrypt && tag_len > 0) {
+    if (!EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_GET_TAG, static_cast<int>(tag_len), packet.tag.data())) {
+      return setup_errorno(ci, static_cast<int64_t>(ERR_peek_error()), cipher::error_code_t::kCipherOperation);
+    }
+  }
+
+  return static_cast<int>(cipher::error_code_t::kOk);
+}
+#  elif defined(ATFRAMEWORK_UTILS_CRYPTO_USE_MBEDTLS)
+static int aead_batch_process_packet(cipher &ci, cipher::cipher_evp_t *ctx, uint32_t /*flags*/, bool is_encrypt,
+                                     const unsigned char *nonce, size_t nonce_len, cipher::aead_packet_t &packet,
+                                     size_t tag_len) {
+  int res = mbedtls_cipher_set_iv(ctx, nonce, nonce_len);
+  if (0 == res) {
+    res = mbedtls_cipher_reset(ctx);
+  }
+  if (0 == res && !packet.ad.empty()) {
+    res = mbedtls_cipher_update_ad(ctx, packet.ad.data(), packet.ad.size());
+  }
+
+  size_t outl = 0;
+  if (0 == res && !packet.data.empty()) {
+    res = mbedtls_cipher_update(ctx, packet.data.data(), packet.data.size(), packet.data.data(), &outl);
+    if (0 == res && outl != packet.data.size()) {
+      res = -1;
+    }
+  }
+
+  if (0 == res) {
+    unsigned char final_block[MBEDTLS_MAX_BLOCK_LENGTH];
+    size_t finish_olen = 0;
+    res = mbedtls_cipher_finish(ctx, final_block, &finish_olen);
+    if (0 == res && 0 != finish_olen) {
+      res = -1;
+    }
+  }
+
+  if (0 == res && tag_len > 0) {
+    if (is_encrypt) {
+      res = mbedtls_cipher_write_tag(ctx, packet.tag.data(), tag_len);
+    } else {
+      res = mbedtls_cipher_check_tag(ctx, packet.tag.data(), tag_len);
+    }
+  }
+
+  if (0 != res) {
+    return setup_errorno(ci, res, cipher::error_code_t::kCipherOperation);
+  }
+  return static_cast<int>(cipher::error_code_t::kOk);
+}
+#  endif
+}  // namespace
+
+ATFRAMEWORK_UTILS_API int cipher::encrypt_aead_batch(gsl::span<aead_packet_t> packets, size_t *processed) {
+  return aead_batch(packets, true, processed);
+}
+
+ATFRAMEWORK_UTILS_API int cipher::decrypt_aead_batch(gsl::span<aead_packet_t> packets, size_t *processed) {
+  return aead_batch(packets, false, processed);
+}
+
+int cipher::aead_batch(gsl::span<aead_packet_t> packets, bool is_encrypt, size_t *processed) {
+  if (nullptr != processed) {
+    *processed = 0;
+  }
+
+  if (nullptr == interface_ || interface_->method == EN_CIMT_INVALID) {
+    return setup_errorno(*this, 0, error_code_t::kNotInited);
+  }
+
+  if (!is_aead()) {
+    return static_cast<int>(error_code_t::kMustNotCallAeadApi);
+  }
+
+  const size_t tag_len = static_cast<size_t>(tag_length_);
+  for (const aead_packet_t &packet : packets) {
+    if (packet.tag.size() < tag_len || (!packet.data.empty() && nullptr == packet.data.data()) ||
+        static_cast<uint64_t>(packet.data.size()) > static_cast<uint64_t>(std::numeric_limits<int>::max()) ||
+        static_cast<uint64_t>(packet.ad.size()) > static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+      return setup_errorno(*this, -1, error_code_t::kInvalidParam);
+    }
+  }
+
+  if (packets.empty()) {
+    return static_cast<int>(error_code_t::kOk);
+  }
+
+  if (interface_->method >= EN_CIMT_CIPHER && 0 == (interface_->flags & EN_CIFT_VARIABLE_IV_LEN) &&
+      iv_.size() < get_iv_size()) {
+    if (0 != get_iv_size()) {
+      iv_.resize(get_iv_size(), 0);
+    }
+  }
+
+  // Nonces are derived from the current iv as a big-endian counter
+  if (iv_.empty()) {
+    return setup_errorno(*this, -1, error_code_t::kInvalidParam);
+  }
+  std::vector<unsigned char> nonce = iv_;
+
+  size_t done = 0;
+  int ret = static_cast<int>(error_code_t::kOk);
+  switch (interface_->method) {
+    case EN_CIMT_CIPHER: {
+      cipher_evp_t *ctx = is_encrypt ? cipher_context_.enc : cipher_context_.dec;
+      if (nullptr == ctx) {
+        return setup_errorno(*this, 0, error_code_t::kCipherDisabled);
+      }
+
+#  if defined(ATFRAMEWORK_UTILS_CRYPTO_USE_OPENSSL) || defined(ATFRAMEWORK_UTILS_CRYPTO_USE_LIBRESSL) || \
+      defined(ATFRAMEWORK_UTILS_CRYPTO_USE_BORINGSSL)
+      // All nonces have the same length, so only set it once for the whole batch
+      if (0 != (interface_->flags & EN_CIFT_VARIABLE_IV_LEN)) {
+        if (!EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_SET_IVLEN, static_cast<int>(nonce.size()), nullptr)) {
+          return setup_errorno(*this, static_cast<int64_t>(ERR_peek_error()), error_code_t::kCipherOperationSetIv);
+        }
+      }
+
+      for (; done < packets.size(); ++done) {
+        ret = aead_batch_process_packet(*this, ctx, interface_->flags, is_encrypt, nonce.data(), packets[done],
+                                        tag_len);
+        if (static_cast<int>(error_code_t::kOk) != ret) {
+          break;
+        }
+        increment_iv_be(nonce, 1);
+      }
+#  elif defined(ATFRAMEWORK_UTILS_CRYPTO_USE_MBEDTLS)
+      for (; done < packets.size(); ++done) {
+        ret = aead_batch_process_packet(*this, ctx, interface_->flags, is_encrypt, nonce.data(), nonce.size(),
+                                        packets[done], tag_len);
+        if (static_cast<int>(error_code_t::kOk) != ret) {
+          break;
+        }
+        increment_iv_be(nonce, 1);
+      }
+#  else
+      ret = setup_errorno(*this, -1, error_code_t::kCipherNotSupport);
+#  endif
+      break;
+    }
+
+#  if defined(ATFRAMEWORK_UTILS_CRYPTO_USE_LIBSODIUM) && ATFRAMEWORK_UTILS_CRYPTO_USE_LIBSODIUM
+    case EN_CIMT_LIBSODIUM_CHACHA20_POLY1305:
+    case EN_CIMT_LIBSODIUM_CHACHA20_POLY1305_IETF:
+#    ifdef crypto_aead_xchacha20poly1305_ietf_KEYBYTES
+    case EN_CIMT_LIBSODIUM_XCHACHA20_POLY1305_IETF:
+#    endif
+    {
+      using encrypt_fn_t = decltype(&crypto_aead_chacha20poly1305_ietf_encrypt_detached);
+      using decrypt_fn_t = decltype(&crypto_aead_chacha20poly1305_ietf_decrypt_detached);
+      encrypt_fn_t encrypt_fn = crypto_aead_chacha20poly1305_ietf_encrypt_detached;
+      decrypt_fn_t decrypt_fn = crypto_aead_chacha20poly1305_ietf_decrypt_detached;
+      size_t abytes = crypto_aead_chacha20poly1305_IETF_ABYTES;
+      if (interface_->method == EN_CIMT_LIBSODIUM_CHACHA20_POLY1305) {
+        encrypt_fn = crypto_aead_chacha20poly1305_encrypt_detached;
+        decrypt_fn = crypto_aead_chacha20poly1305_decrypt_detached;
+        abytes = crypto_aead_chacha20poly1305_ABYTES;
+      }
+#    ifdef crypto_aead_xchacha20poly1305_ietf_KEYBYTES
+      if (interface_->method == EN_CIMT_LIBSODIUM_XCHACHA20_POLY1305_IETF) {
+        encrypt_fn = crypto_aead_xchacha20poly1305_ietf_encrypt_detached;
+        decrypt_fn = crypto_aead_xchacha20poly1305_ietf_decrypt_detached;
+        abytes = crypto_aead_xchacha20poly1305_ietf_ABYTES;
+      }
+#    endif
+      if (abytes > tag_len) {
+        return static_cast<int>(error_code_t::kLibsodiumOperationTagLen);
+      }
+
+      // libsodium allows the message and ciphertext to overlap exactly
+      for (; done < packets.size(); ++done) {
+        aead_packet_t &packet = packets[done];
+        if (is_encrypt) {
+          unsigned long long maclen = tag_len;  // NOLINT: runtime/int
+          last_errorno_ =
+              encrypt_fn(packet.data.data(), packet.tag.data(), &maclen, packet.data.data(), packet.data.size(),
+                         packet.ad.data(), packet.ad.size(), nullptr, nonce.data(), libsodium_context_.key);
+        } else {
+          last_errorno_ = decrypt_fn(packet.data.data(), nullptr, packet.data.data(), packet.data.size(),
+                                     packet.tag.data(), packet.ad.data(), packet.ad.size(), nonce.data(),
+                                     libsodium_context_.key);
+        }
+        if (last_errorno_ != 0) {
+          ret = static_cast<int>(error_code_t::kLibsodiumOperation);
+          break;
+        }
+        increment_iv_be(nonce, 1);
+      }
+      break;
+    }
+#  endif
+
+    default:
+      return setup_errorno(*this, -1, error_code_t::kNotInited);
+  }
+
+  if (nullptr != processed) {
+    *processed = done;
+  }
+  // Roll iv once for the whole batch, the result is the same as rolling after every packet
+  if (iv_is_set_ && IV_ROLL_AEAD_INC1_BE == iv_roll_policy_) {
+    increment_iv_be(iv_, static_cast<uint64_t>(done));
+  }
+
+  return ret;
+}
+
 ATFRAMEWORK_UTILS_API const cipher::cipher_kt_t *cipher::get_cipher_by_name(const char *name) {
   const cipher_interface_info_t *interface = get_cipher_interface_by_name(name);
 
@@ -43,8 +43,11 @@
 #include <design_pattern/nomovable.h>
 #include <design_pattern/noncopyable.h>
 
+#include <thread/work_stealing_pool.h>
+
 #include <cassert>
 #include <cstring>
+#include <mutex>
 
 #ifdef CRYPTO_DH_ENABLED
 
@@ -643,6 +646,43 @@ struct dh::shared_context::dh_param_t {
 
 struct dh::shared_context::random_engine_t {};
 
+struct dh::shared_context::key_pool_t {
+  // keygen_ctx in dh_param_t is also protected by this lock after key pool is enabled
+  std::mutex lock;
+  std::vector<EVP_PKEY *> keys;
+  size_t low_watermark;
+  size_t high_watermark;
+  thread::work_stealing_pool *worker;
+  bool refill_pending;
+  bool refilling;
+  // 参数或曲线变化时递增，用于丢弃后台生成的旧密钥
+  uint64_t generation;
+  uint64_t hit_count;
+  uint64_t miss_count;
+  uint64_t generated_count;
+
+  key_pool_t()
+      : low_watermark(0),
+        high_watermark(0),
+        worker(nullptr),
+        refill_pending(false),
+        refilling(false),
+        generation(0),
+        hit_count(0),
+        miss_count(0),
+        generated_count(0) {}
+
+  ~key_pool_t() { clear(); }
+
+  void clear() {
+    for (auto &key : keys) {
+      EVP_PKEY_free(key);
+    }
+    keys.clear();
+    ++generation;
+  }
+};
+
 #  elif defined(ATFRAMEWORK_UTILS_CRYPTO_USE_MBEDTLS)
 struct dh::dh_context_t {
   union {
@@ -665,6 +705,8 @@ struct dh::shared_context::random_engine_t {
   mbedtls_ctr_drbg_context ctr_drbg;
   mbedtls_entropy_context entropy;
 };
+
+struct dh::shared_context::key_pool_t {};
 #  endif
 
 namespace details {
@@ -975,6 +1017,14 @@ static EVP_PKEY_CTX *initialize_pkey_ctx_by_pkey(EVP_PKEY *params_key, bool init
 
   return ret;
 }
+
+static void replace_keygen_ctx(dh::shared_context::dh_param_t &param, dh::shared_context::key_pool_t &pool,
+                               EVP_PKEY_CTX *keygen_ctx) {
+  std::lock_guard<std::mutex> lock_guard{pool.lock};
+  pool.clear();
+  reset(param.keygen_ctx);
+  param.keygen_ctx = keygen_ctx;
+}
 #  endif
 }  // namespace
 }  // namespace details
@@ -984,7 +1034,8 @@ ATFRAMEWORK_UTILS_API dh::shared_context::shared_context()
     : flags_(static_cast<uint32_t>(flags_t::kNone)),
       method_(method_t::kInvalid),
       dh_param_(gsl::make_unique<dh_param_t>()),
-      random_engine_(gsl::make_unique<random_engine_t>()) {
+      random_engine_(gsl::make_unique<random_engine_t>()),
+      key_pool_(gsl::make_unique<key_pool_t>()) {
 #  if defined(ATFRAMEWORK_UTILS_CRYPTO_USE_MBEDTLS)
   std::memset(static_cast<void *>(random_engine_.get()), 0, sizeof(random_engine_t));
 #  endif
@@ -994,7 +1045,8 @@ ATFRAMEWORK_UTILS_API dh::shared_context::shared_context(creator_helper &)
     : flags_(static_cast<uint32_t>(flags_t::kNone)),
       method_(method_t::kInvalid),
       dh_param_(gsl::make_unique<dh_param_t>()),
-      random_engine_(gsl::make_unique<random_engine_t>()) {
+      random_engine_(gsl::make_unique<random_engine_t>()),
+      key_pool_(gsl::make_unique<key_pool_t>()) {
 #  if defined(ATFRAMEWORK_UTILS_CRYPTO_USE_MBEDTLS)
   std::memset(static_cast<void *>(random_engine_.get()), 0, sizeof(random_engine_t));
 #  endif
@@ -1137,8 +1189,8 @@ ATFRAMEWORK_UTILS_API dh::error_code_t dh::shared_context::init(nostd::string_vi
         }
 #      endif
 
-        details::reset(dh_param_->keygen_ctx);
-        dh_param_->keygen_ctx = details::initialize_pkey_ctx_by_pkey(params_key.get(), true, false);
+        details::replace_keygen_ctx(*dh_param_, *key_pool_,
+                                    details::initialize_pkey_ctx_by_pkey(params_key.get(), true, false));
       } while (false);
 
       if (error_code_t::kOk != ret) {
@@ -1197,11 +1249,12 @@ ATFRAMEWORK_UTILS_API dh::error_code_t dh::shared_context::init(nostd::string_vi
             EVP_R_OPERATION_NOT_SUPPORTED_FOR_THIS_KEYTYPE != ERR_GET_REASON(ERR_peek_error())) {
           break;
         }
-        details::reset(dh_param_->keygen_ctx);
         if (nullptr == paramgen_ctx.get()) {
-          dh_param_->keygen_ctx = details::initialize_pkey_ctx_by_group_id(dh_param_->group_id, true, false);
+          details::replace_keygen_ctx(*dh_param_, *key_pool_,
+                                      details::initialize_pkey_ctx_by_group_id(dh_param_->group_id, true, false));
         } else {
-          dh_param_->keygen_ctx = details::initialize_pkey_ctx_by_pkey(params_key.get(), true, false);
+          details::replace_keygen_ctx(*dh_param_, *key_pool_,
+                                      details::initialize_pkey_ctx_by_pkey(params_key.get(), true, false));
         }
       } while (false);
 #  elif defined(ATFRAMEWORK_UTILS_CRYPTO_USE_MBEDTLS)
@@ -1300,7 +1353,7 @@ ATFRAMEWORK_UTILS_API void dh::shared_context::reset() {
 #  if defined(ATFRAMEWORK_UTILS_CRYPTO_USE_OPENSSL) || defined(ATFRAMEWORK_UTILS_CRYPTO_USE_LIBRESSL) || \
       defined(ATFRAMEWORK_UTILS_CRYPTO_USE_BORINGSSL)
   details::reset(dh_param_->param);
-  details::reset(dh_param_->keygen_ctx);
+  details::replace_keygen_ctx(*dh_param_, *key_pool_, nullptr);
 #  elif defined(ATFRAMEWORK_UTILS_CRYPTO_USE_MBEDTLS)
   mbedtls_ctr_drbg_free(&random_engine_->ctr_drbg);
   mbedtls_entropy_free(&random_engine_->entropy);
@@ -1357,6 +1410,11 @@ ATFRAMEWORK_UTILS_API dh::error_code_t dh::shared_context::try_reset_ecp_id(int
     return error_code_t::kAlgorithmMismatch;
   }
 
+  // Keep keygen context and key pool when the curve is not changed
+  if (0 != dh_param_->group_id && nullptr != dh_param_->keygen_ctx) {
+    return error_code_t::kOk;
+  }
+
   dh_param_->group_id = group_id;
   details::openssl_raii<EVP_PKEY_CTX> paramgen_ctx{
       details::initialize_pkey_ctx_by_group_id(dh_param_->group_id, false, true)};
@@ -1372,11 +1430,12 @@ ATFRAMEWORK_UTILS_API dh::error_code_t dh::shared_context::try_reset_ecp_id(int
       EVP_R_OPERATION_NOT_SUPPORTED_FOR_THIS_KEYTYPE != ERR_GET_REASON(ERR_peek_error())) {
     return error_code_t::kMalloc;
   }
-  details::reset(dh_param_->keygen_ctx);
   if (nullptr == params_key.get()) {
-    dh_param_->keygen_ctx = details::initialize_pkey_ctx_by_group_id(dh_param_->group_id, true, false);
+    details::replace_keygen_ctx(*dh_param_, *key_pool_,
+                                details::initialize_pkey_ctx_by_group_id(dh_param_->group_id, true, false));
   } else {
-    dh_param_->keygen_ctx = details::initialize_pkey_ctx_by_pkey(params_key.get(), true, false);
+    details::replace_keygen_ctx(*dh_param_, *key_pool_,
+                                details::initialize_pkey_ctx_by_pkey(params_key.get(), true, false));
   }
 
   return error_code_t::kOk;
@@ -1407,8 +1466,8 @@ ATFRAMEWORK_UTILS_API dh::error_code_t dh::shared_context::try_reset_dh_params(B
     return error_code_t::kInitDhReadKey;
   }
 
-  details::reset(dh_param_->keygen_ctx);
-  dh_param_->keygen_ctx = details::initialize_pkey_ctx_by_pkey(params_key.get(), true, false);
+  details::replace_keygen_ctx(*dh_param_, *key_pool_,
+                              details::initialize_pkey_ctx_by_pkey(params_key.get(), true, false));
   if (dh_param_->keygen_ctx == nullptr || EVP_PKEY_param_check_quick(dh_param_->keygen_ctx) != 1) {
     return error_code_t::kInitDhReadParam;
   }
@@ -1438,8 +1497,8 @@ ATFRAMEWORK_UTILS_API dh::error_code_t dh::shared_context::try_reset_dh_params(B
     return error_code_t::kOperation;
   }
   details::reset(dh);
-  details::reset(dh_param_->keygen_ctx);
-  dh_param_->keygen_ctx = details::initialize_pkey_ctx_by_pkey(params_key.get(), true, false);
+  details::replace_keygen_ctx(*dh_param_, *key_pool_,
+                              details::initialize_pkey_ctx_by_pkey(params_key.get(), true, false));
   if (dh_param_->keygen_ctx == nullptr) {
     return error_code_t::kInitDhReadParam;
   }
@@ -1447,7 +1506,189 @@ ATFRAMEWORK_UTILS_API dh::error_code_t dh::shared_context::try_reset_dh_params(B
   return ret;
 }
 #    endif
+
+ATFRAMEWORK_UTILS_API dh::error_code_t dh::shared_context::acquire_key_pair(EVP_PKEY *&output) {
+  output = nullptr;
+  bool need_refill = false;
+  {
+    std::lock_guard<std::mutex> lock_guard{key_pool_->lock};
+    if (!key_pool_->keys.empty()) {
+      output = key_pool_->keys.back();
+      key_pool_->keys.pop_back();
+      ++key_pool_->hit_count;
+    } else {
+      if (nullptr == dh_param_->keygen_ctx) {
+        return error_code_t::kNotInited;
+      }
+
+      if (key_pool_->high_watermark > 0) {
+        ++key_pool_->miss_count;
+      }
+      if (EVP_PKEY_keygen(dh_param_->keygen_ctx, &output) <= 0) {
+        details::reset(output);
+      }
+    }
+
+    need_refill = nullptr != key_pool_->worker && key_pool_->keys.size() < key_pool_->low_watermark;
+  }
+
+  if (need_refill) {
+    schedule_key_pool_refill();
+  }
+
+  if (nullptr == output) {
+    return error_code_t::kInitDhGenerateKey;
+  }
+  return error_code_t::kOk;
+}
+
+void dh::shared_context::schedule_key_pool_refill() {
+  thread::work_stealing_pool *worker;
+  {
+    std::lock_guard<std::mutex> lock_guard{key_pool_->lock};
+    if (nullptr == key_pool_->worker || key_pool_->refill_pending || key_pool_->refilling ||
+        key_pool_->keys.size() >= key_pool_->low_watermark) {
+      return;
+    }
+    key_pool_->refill_pending = true;
+    worker = key_pool_->worker;
+  }
+
+  std::weak_ptr<shared_context> self = shared_from_this();
+  bool posted = worker->post([self]() {
+    ptr_t shared_context_ptr = self.lock();
+    if (!shared_context_ptr) {
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock_guard{shared_context_ptr->key_pool_->lock};
+      shared_context_ptr->key_pool_->refill_pending = false;
+    }
+    shared_context_ptr->refill_key_pool(0);
+  });
+
+  if (!posted) {
+    std::lock_guard<std::mutex> lock_guard{key_pool_->lock};
+    key_pool_->refill_pending = false;
+  }
+}
+#  endif
+
+ATFRAMEWORK_UTILS_API dh::error_code_t dh::shared_context::set_key_pool(size_t low_watermark, size_t high_watermark,
+                                                                        thread::work_stealing_pool *worker) {
+#  if defined(ATFRAMEWORK_UTILS_CRYPTO_USE_OPENSSL) || defined(ATFRAMEWORK_UTILS_CRYPTO_USE_LIBRESSL) || \
+      defined(ATFRAMEWORK_UTILS_CRYPTO_USE_BORINGSSL)
+  if (low_watermark > high_watermark) {
+    return error_code_t::kInvalidParam;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock_guard{key_pool_->lock};
+    key_pool_->low_watermark = low_watermark;
+    key_pool_->high_watermark = high_watermark;
+    key_pool_->worker = worker;
+
+    while (key_pool_->keys.size() > high_watermark) {
+      EVP_PKEY_free(key_pool_->keys.back());
+      key_pool_->keys.pop_back();
+    }
+    key_pool_->keys.reserve(high_watermark);
+  }
+
+  schedule_key_pool_refill();
+  return error_code_t::kOk;
+#  else
+  (void)low_watermark;
+  (void)high_watermark;
+  (void)worker;
+  return error_code_t::kNotSupport;
 #  endif
+}
+
+ATFRAMEWORK_UTILS_API size_t dh::shared_context::refill_key_pool(size_t max_count) {
+#  if defined(ATFRAMEWORK_UTILS_CRYPTO_USE_OPENSSL) || defined(ATFRAMEWORK_UTILS_CRYPTO_USE_LIBRESSL) || \
+      defined(ATFRAMEWORK_UTILS_CRYPTO_USE_BORINGSSL)
+  // 在锁外使用独立的keygen上下文生成密钥，避免阻塞握手线程
+  details::openssl_raii<EVP_PKEY_CTX> keygen_ctx{nullptr};
+  uint64_t generation;
+  {
+    std::lock_guard<std::mutex> lock_guard{key_pool_->lock};
+    if (key_pool_->refilling || nullptr == dh_param_->keygen_ctx ||
+        key_pool_->keys.size() >= key_pool_->high_watermark) {
+      return 0;
+    }
+
+    // EVP_PKEY_CTX_dup() do not support keygen context of providers, so create a new one from the same parameters
+    EVP_PKEY *params_key = EVP_PKEY_CTX_get0_pkey(dh_param_->keygen_ctx);
+    if (nullptr == params_key) {
+      keygen_ctx.ref() = details::initialize_pkey_ctx_by_group_id(dh_param_->group_id, true, false);
+    } else {
+      keygen_ctx.ref() = details::initialize_pkey_ctx_by_pkey(params_key, true, false);
+    }
+    if (nullptr == keygen_ctx.get()) {
+      return 0;
+    }
+    key_pool_->refilling = true;
+    generation = key_pool_->generation;
+  }
+
+  size_t ret = 0;
+  while (0 == max_count || ret < max_count) {
+    EVP_PKEY *key = nullptr;
+    if (EVP_PKEY_keygen(keygen_ctx.get(), &key) <= 0 || nullptr == key) {
+      details::reset(key);
+      break;
+    }
+
+    std::lock_guard<std::mutex> lock_guard{key_pool_->lock};
+    if (generation != key_pool_->generation || key_pool_->keys.size() >= key_pool_->high_watermark) {
+      details::reset(key);
+      break;
+    }
+
+    key_pool_->keys.push_back(key);
+    ++key_pool_->generated_count;
+    ++ret;
+    if (key_pool_->keys.size() >= key_pool_->high_watermark) {
+      break;
+    }
+  }
+
+  // 生成期间取走的密钥不会触发新的补充任务，结束后需要再检查一次低水位。生成失败时不重试，避免空转
+  bool need_refill;
+  {
+    std::lock_guard<std::mutex> lock_guard{key_pool_->lock};
+    key_pool_->refilling = false;
+    need_refill = 0 != ret && nullptr != key_pool_->worker && key_pool_->keys.size() < key_pool_->low_watermark;
+  }
+  if (need_refill) {
+    schedule_key_pool_refill();
+  }
+  return ret;
+#  else
+  (void)max_count;
+  return 0;
+#  endif
+}
+
+ATFRAMEWORK_UTILS_API dh::key_pool_stats_t dh::shared_context::get_key_pool_stats() const {
+  key_pool_stats_t ret;
+#  if defined(ATFRAMEWORK_UTILS_CRYPTO_USE_OPENSSL) || defined(ATFRAMEWORK_UTILS_CRYPTO_USE_LIBRESSL) || \
+      defined(ATFRAMEWORK_UTILS_CRYPTO_USE_BORINGSSL)
+  std::lock_guard<std::mutex> lock_guard{key_pool_->lock};
+  ret.cached_count = key_pool_->keys.size();
+  ret.hit_count = key_pool_->hit_count;
+  ret.miss_count = key_pool_->miss_count;
+  ret.generated_count = key_pool_->generated_count;
+#  else
+  ret.cached_count = 0;
+  ret.hit_count = 0;
+  ret.miss_count = 0;
+  ret.generated_count = 0;
+#  endif
+  return ret;
+}
 
 // --------------- shared context ---------------
 
@@ -1615,7 +1856,7 @@ ATFRAMEWORK_UTILS_API dh::error_code_t dh::make_params(std::vector<unsigned char
         }
 
         details::reset(dh_context_->openssl_dh_pkey_);
-        if (EVP_PKEY_keygen(shared_context_->get_dh_parameter().keygen_ctx, &dh_context_->openssl_dh_pkey_) <= 0) {
+        if (error_code_t::kOk != shared_context_->acquire_key_pair(dh_context_->openssl_dh_pkey_)) {
           ret = details::setup_errorno(*this, static_cast<int>(ERR_peek_error()), error_code_t::kInitDhparam);
         }
 
@@ -1742,7 +1983,7 @@ ATFRAMEWORK_UTILS_API dh::error_code_t dh::make_params(std::vector<unsigned char
         }
 
         details::reset(dh_context_->openssl_ecdh_pkey_);
-        if (EVP_PKEY_keygen(shared_context_->get_dh_parameter().keygen_ctx, &dh_context_->openssl_ecdh_pkey_) <= 0) {
+        if (error_code_t::kOk != shared_context_->acquire_key_pair(dh_context_->openssl_ecdh_pkey_)) {
           ret = details::setup_errorno(*this, static_cast<int>(ERR_peek_error()), error_code_t::kInitDhparam);
         }
 
@@ -1893,7 +2134,7 @@ ATFRAMEWORK_UTILS_API dh::error_code_t dh::read_params(const unsigned char *inpu
       }
 
       details::reset(dh_context_->openssl_ecdh_pkey_);
-      if (EVP_PKEY_keygen(shared_context_->get_dh_parameter().keygen_ctx, &dh_context_->openssl_ecdh_pkey_) <= 0) {
+      if (error_code_t::kOk != shared_context_->acquire_key_pair(dh_context_->openssl_ecdh_pkey_)) {
         details::reset(dh_context_->openssl_ecdh_pkey_);
         ret = details::setup_errorno(*this, static_cast<int>(ERR_peek_error()), error_code_t::kInitDhGenerateKey);
         break;
@@ -1904,6 +2145,7 @@ ATFRAMEWORK_UTILS_API dh::error_code_t dh::read_params(const unsigned char *inpu
       }
 
       if (nullptr == dh_context_->openssl_ecdh_peer_key_) {
+        std::lock_guard<std::mutex> lock_guard{shared_context_->key_pool_->lock};
         EVP_PKEY_keygen(shared_context_->get_dh_parameter().keygen_ctx, &dh_context_->openssl_ecdh_peer_key_);
       }
       if (nullptr == dh_context_->openssl_ecdh_peer_key_) {
@@ -2114,9 +2356,17 @@ ATFRAMEWORK_UTILS_API dh::error_code_t dh::read_public(const unsigned char *inpu
       }
 
       details::reset(dh_context_->openssl_dh_peer_key_);
-      if (!EVP_PKEY_fromdata_init(shared_context_->get_dh_parameter().keygen_ctx) ||
-          !EVP_PKEY_fromdata(shared_context_->get_dh_parameter().keygen_ctx, &dh_context_->openssl_dh_peer_key_,
-                             EVP_PKEY_KEYPAIR, ossl_params.get())) {
+      bool import_peer_key;
+      {
+        // keygen_ctx is shared with key pool, switch it back to keygen operation after import
+        std::lock_guard<std::mutex> lock_guard{shared_context_->key_pool_->lock};
+        EVP_PKEY_CTX *keygen_ctx = shared_context_->get_dh_parameter().keygen_ctx;
+        import_peer_key = EVP_PKEY_fromdata_init(keygen_ctx) > 0 &&
+                          EVP_PKEY_fromdata(keygen_ctx, &dh_context_->openssl_dh_peer_key_, EVP_PKEY_KEYPAIR,
+                                            ossl_params.get()) > 0;
+        EVP_PKEY_keygen_init(keygen_ctx);
+      }
+      if (!import_peer_key) {
         ret = error_code_t::kInitDhReadKey;
         break;
       }
@@ -2137,6 +2387,7 @@ ATFRAMEWORK_UTILS_API dh::error_code_t dh::read_public(const unsigned char *inpu
       // }
 #      else
       if (nullptr == dh_context_->openssl_dh_peer_key_) {
+        std::lock_guard<std::mutex> lock_guard{shared_context_->key_pool_->lock};
         EVP_PKEY_keygen(shared_context_->get_dh_parameter().keygen_ctx, &dh_context_->openssl_dh_peer_key_);
       }
       if (nullptr == dh_context_->openssl_dh_peer_key_) {
@@ -2181,6 +2432,7 @@ ATFRAMEWORK_UTILS_API dh::error_code_t dh::read_public(const unsigned char *inpu
       }
 
       if (nullptr == dh_context_->openssl_ecdh_peer_key_) {
+        std::lock_guard<std::mutex> lock_guard{shared_context_->key_pool_->lock};
         EVP_PKEY_keygen(shared_context_->get_dh_parameter().keygen_ctx, &dh_context_->openssl_ecdh_peer_key_);
       }
       if (nullptr == dh_context_->openssl_ecdh_peer_key_) {
@@ -2383,6 +2635,28 @@ ATFRAMEWORK_UTILS_API dh::error_code_t dh::calc_secret(std::vector<unsigned char
   return ret;
 }
 
+ATFRAMEWORK_UTILS_API dh::error_code_t dh::calc_secret_async(thread::work_stealing_pool &worker,
+                                                             calc_secret_callback_t callback) {
+  if (!shared_context_) {
+    return details::setup_errorno(*this, 0, error_code_t::kNotInited);
+  }
+
+  if (!callback) {
+    return details::setup_errorno(*this, 0, error_code_t::kInvalidParam);
+  }
+
+  dh *self = this;
+  if (!worker.post([self, callback]() {
+        std::vector<unsigned char> output;
+        error_code_t ret = self->calc_secret(output);
+        callback(*self, ret, output);
+      })) {
+    return details::setup_errorno(*this, 0, error_code_t::kOperation);
+  }
+
+  return details::setup_errorno(*this, 0, error_code_t::kOk);
+}
+
 ATFRAMEWORK_UTILS_API const std::vector<std::string> &dh::get_all_curve_names() {
   static std::vector<std::string> ret;
   if (ret.empty()) {
@@ -2520,7 +2794,7 @@ dh::error_code_t dh::check_or_setup_dh_pg_gy(BIGNUM *&DH_p, BIGNUM *&DH_g, BIGNU
     }
 
     details::reset(dh_context_->openssl_dh_pkey_);
-    if (EVP_PKEY_keygen(shared_context_->get_dh_parameter().keygen_ctx, &dh_context_->openssl_dh_pkey_) <= 0) {
+    if (error_code_t::kOk != shared_context_->acquire_key_pair(dh_context_->openssl_dh_pkey_)) {
       details::reset(dh_context_->openssl_dh_pkey_);
       ret = details::setup_errorno(*this, static_cast<int>(ERR_peek_error()), error_code_t::kInitDhGenerateKey);
       break;
@@ -2549,9 +2823,17 @@ dh::error_code_t dh::check_or_setup_dh_pg_gy(BIGNUM *&DH_p, BIGNUM *&DH_g, BIGNU
       }
 
       details::reset(dh_context_->openssl_dh_peer_key_);
-      if (!EVP_PKEY_fromdata_init(shared_context_->get_dh_parameter().keygen_ctx) ||
-          !EVP_PKEY_fromdata(shared_context_->get_dh_parameter().keygen_ctx, &dh_context_->openssl_dh_peer_key_,
-                             EVP_PKEY_KEYPAIR, ossl_params.get())) {
+      bool import_peer_key;
+      {
+        // keygen_ctx is shared with key pool, switch it back to keygen operation after import
+        std::lock_guard<std::mutex> lock_guard{shared_context_->key_pool_->lock};
+        EVP_PKEY_CTX *keygen_ctx = shared_context_->get_dh_parameter().keygen_ctx;
+        import_peer_key = EVP_PKEY_fromdata_init(keygen_ctx) > 0 &&
+                          EVP_PKEY_fromdata(keygen_ctx, &dh_context_->openssl_dh_peer_key_, EVP_PKEY_KEYPAIR,
+                                            ossl_params.get()) > 0;
+        EVP_PKEY_keygen_init(keygen_ctx);
+      }
+      if (!import_peer_key) {
         ret = error_code_t::kInitDhReadKey;
         break;
       }
@@ -2586,6 +2868,7 @@ dh::error_code_t dh::check_or_setup_dh_pg_gy(BIGNUM *&DH_p, BIGNUM *&DH_g, BIGNU
 
 #      else
       if (nullptr == dh_context_->openssl_dh_peer_key_) {
+        std::lock_guard<std::mutex> lock_guard{shared_context_->key_pool_->lock};
         EVP_PKEY_keygen(shared_context_->get_dh_parameter().keygen_ctx, &dh_context_->openssl_dh_peer_key_);
       }
       if (nullptr == dh_context_->openssl_dh_peer_key_) {
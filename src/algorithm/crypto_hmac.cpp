@@ -11,6 +11,7 @@
 #ifdef ATFW_UTIL_MACRO_CRYPTO_HMAC_ENABLED
 
 #  include <common/string_oprs.h>
+#  include <std/thread.h>
 
 #  include <cstring>
 #  include <string>
@@ -483,6 +484,98 @@ ATFRAMEWORK_UTILS_API hmac_error_code_t hmac::close() {
   return hmac_error_code_t::kOk;
 }
 
+ATFRAMEWORK_UTILS_API hmac_error_code_t hmac::reset() {
+  if (context_ == nullptr) {
+    return hmac_error_code_t::kNotInitialized;
+  }
+
+#  if defined(ATFRAMEWORK_UTILS_CRYPTO_USE_OPENSSL) || defined(ATFRAMEWORK_UTILS_CRYPTO_USE_LIBRESSL) || \
+      defined(ATFRAMEWORK_UTILS_CRYPTO_USE_BORINGSSL)
+
+#    if ATFW_CRYPTO_HMAC_USE_EVP_MAC
+  // A NULL key reuses the key set by the previous EVP_MAC_init
+  details::hmac_evp_mac_context* ctx = static_cast<details::hmac_evp_mac_context*>(context_);
+  if (EVP_MAC_init(ctx->ctx, nullptr, 0, nullptr) != 1) {
+    last_errno_ = static_cast<int64_t>(ERR_peek_error());
+    return hmac_error_code_t::kOperation;
+  }
+#    else
+  // A NULL key and md reuse the existing key and digest
+  details::hmac_legacy_context* ctx = static_cast<details::hmac_legacy_context*>(context_);
+#      if ATFW_CRYPTO_HMAC_CTX_NEW
+  if (HMAC_Init_ex(ctx->ctx, nullptr, 0, nullptr, nullptr) != 1) {
+#      else
+  if (HMAC_Init_ex(&ctx->ctx, nullptr, 0, nullptr, nullptr) != 1) {
+#      endif
+    last_errno_ = static_cast<int64_t>(ERR_peek_error());
+    return hmac_error_code_t::kOperation;
+  }
+#    endif
+
+#  elif defined(ATFRAMEWORK_UTILS_CRYPTO_USE_MBEDTLS)
+  details::hmac_mbedtls_context* ctx = static_cast<details::hmac_mbedtls_context*>(context_);
+  int ret = mbedtls_md_hmac_reset(&ctx->ctx);
+  if (ret != 0) {
+    last_errno_ = ret;
+    return hmac_error_code_t::kOperation;
+  }
+#  endif
+
+  return hmac_error_code_t::kOk;
+}
+
+ATFRAMEWORK_UTILS_API hmac_error_code_t hmac::rekey(const unsigned char* key, size_t key_len) {
+  if (context_ == nullptr) {
+    return hmac_error_code_t::kNotInitialized;
+  }
+
+  if (key == nullptr && key_len > 0) {
+    return hmac_error_code_t::kInvalidParam;
+  }
+
+  // Backends treat a NULL key as "keep the current key", so an empty key must still be a valid pointer
+  static const unsigned char empty_key[1] = {0};
+  if (key == nullptr) {
+    key = empty_key;
+  }
+
+#  if defined(ATFRAMEWORK_UTILS_CRYPTO_USE_OPENSSL) || defined(ATFRAMEWORK_UTILS_CRYPTO_USE_LIBRESSL) || \
+      defined(ATFRAMEWORK_UTILS_CRYPTO_USE_BORINGSSL)
+
+#    if ATFW_CRYPTO_HMAC_USE_EVP_MAC
+  details::hmac_evp_mac_context* ctx = static_cast<details::hmac_evp_mac_context*>(context_);
+  if (EVP_MAC_init(ctx->ctx, key, key_len, nullptr) != 1) {
+    last_errno_ = static_cast<int64_t>(ERR_peek_error());
+    return hmac_error_code_t::kOperation;
+  }
+#    else
+  details::hmac_legacy_context* ctx = static_cast<details::hmac_legacy_context*>(context_);
+#      if ATFW_CRYPTO_HMAC_CTX_NEW
+  if (HMAC_Init_ex(ctx->ctx, key, static_cast<int>(key_len), nullptr, nullptr) != 1) {
+#      else
+  if (HMAC_Init_ex(&ctx->ctx, key, static_cast<int>(key_len), nullptr, nullptr) != 1) {
+#      endif
+    last_errno_ = static_cast<int64_t>(ERR_peek_error());
+    return hmac_error_code_t::kOperation;
+  }
+#    endif
+
+#  elif defined(ATFRAMEWORK_UTILS_CRYPTO_USE_MBEDTLS)
+  details::hmac_mbedtls_context* ctx = static_cast<details::hmac_mbedtls_context*>(context_);
+  int ret = mbedtls_md_hmac_starts(&ctx->ctx, key, key_len);
+  if (ret != 0) {
+    last_errno_ = ret;
+    return hmac_error_code_t::kOperation;
+  }
+#  endif
+
+  return hmac_error_code_t::kOk;
+}
+
+ATFRAMEWORK_UTILS_API hmac_error_code_t hmac::rekey(gsl::span<const unsigned char> key) {
+  return rekey(key.data(), key.size());
+}
+
 ATFRAMEWORK_UTILS_API hmac_error_code_t hmac::update(const unsigned char* input, size_t input_len) {
   if (context_ == nullptr) {
     return hmac_error_code_t::kNotInitialized;
@@ -607,6 +700,8 @@ ATFRAMEWORK_UTILS_API size_t hmac::get_output_length() const noexcept {
 
 ATFRAMEWORK_UTILS_API bool hmac::is_valid() const noexcept { return context_ != nullptr; }
 
+ATFRAMEWORK_UTILS_API digest_type_t hmac::get_digest_type() const noexcept { return digest_type_; }
+
 ATFRAMEWORK_UTILS_API int64_t hmac::get_last_errno() const noexcept { return last_errno_; }
 
 ATFRAMEWORK_UTILS_API void hmac::set_last_errno(int64_t e) noexcept { last_errno_ = e; }
@@ -745,6 +840,93 @@ ATFRAMEWORK_UTILS_API std::string hmac::compute_to_hex(digest_type_t type, gsl::
   return compute_to_hex(type, key.data(), key.size(), input.data(), input.size(), uppercase);
 }
 
+namespace details {
+namespace {
+#  if !(defined(ATFRAMEWORK_UTILS_THREAD_TLS_USE_PTHREAD) && ATFRAMEWORK_UTILS_THREAD_TLS_USE_PTHREAD) && \
+      defined(THREAD_TLS_ENABLED) && 1 == THREAD_TLS_ENABLED
+struct hmac_thread_cache_t {
+  hmac contexts[static_cast<size_t>(digest_type_t::kMd5) + 1];
+};
+#  endif
+
+// Only the allocated context is cached, the key is set again by every batch
+static hmac* get_thread_cached_hmac(digest_type_t type, hmac& fallback) {
+#  if !(defined(ATFRAMEWORK_UTILS_THREAD_TLS_USE_PTHREAD) && ATFRAMEWORK_UTILS_THREAD_TLS_USE_PTHREAD) && \
+      defined(THREAD_TLS_ENABLED) && 1 == THREAD_TLS_ENABLED
+  static THREAD_TLS hmac_thread_cache_t cache;
+  return &cache.contexts[static_cast<size_t>(type)];
+#  else
+  (void)type;
+  return &fallback;
+#  endif
+}
+}  // namespace
+}  // namespace details
+
+ATFRAMEWORK_UTILS_API hmac_error_code_t hmac::compute_batch(digest_type_t type, const unsigned char* key,
+                                                            size_t key_len, const unsigned char* const* inputs,
+                                                            const size_t* input_lengths, size_t count,
+                                                            unsigned char* output, size_t output_len) {
+  if (key == nullptr && key_len > 0) {
+    return hmac_error_code_t::kInvalidParam;
+  }
+
+  size_t digest_len = get_digest_output_length(type);
+  if (digest_len == 0) {
+    return hmac_error_code_t::kDigestNotSupport;
+  }
+
+  if (count == 0) {
+    return hmac_error_code_t::kOk;
+  }
+
+  if (inputs == nullptr || input_lengths == nullptr || output == nullptr) {
+    return hmac_error_code_t::kInvalidParam;
+  }
+
+  if (output_len / digest_len < count) {
+    return hmac_error_code_t::kOutputBufferTooSmall;
+  }
+
+  hmac fallback;
+  hmac* ctx = details::get_thread_cached_hmac(type, fallback);
+  hmac_error_code_t ret;
+  if (ctx->is_valid()) {
+    ret = ctx->rekey(key, key_len);
+  } else {
+    ret = ctx->init(type, key, key_len);
+  }
+  if (ret != hmac_error_code_t::kOk) {
+    ctx->close();
+    return ret;
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    if (i > 0) {
+      ret = ctx->reset();
+      if (ret != hmac_error_code_t::kOk) {
+        break;
+      }
+    }
+
+    ret = ctx->update(inputs[i], input_lengths[i]);
+    if (ret != hmac_error_code_t::kOk) {
+      break;
+    }
+
+    size_t final_len = digest_len;
+    ret = ctx->final(output + i * digest_len, &final_len);
+    if (ret != hmac_error_code_t::kOk) {
+      break;
+    }
+  }
+
+  if (ret != hmac_error_code_t::kOk) {
+    ctx->close();
+  }
+  return ret;
+}
+
 // ============================================================================
 // HKDF class implementation
 // ============================================================================
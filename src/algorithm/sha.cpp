@@ -9,8 +9,10 @@
 #include <cstring>
 #include <string>
 
+#include <common/cpu_features.h>
 #include <common/string_oprs.h>
 #include <config/compile_optimize.h>
+#include <std/thread.h>
 
 #include <algorithm/sha.h>
 
@@ -19,6 +21,8 @@
 #  define UTIL_HASH_IMPLEMENT_SHA_USING_OPENSSL 1
 #elif defined(ATFRAMEWORK_UTILS_CRYPTO_USE_MBEDTLS)
 #  define UTIL_HASH_IMPLEMENT_SHA_USING_MBEDTLS 1
+#elif defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+#  include <immintrin.h>
 #endif
 
 ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
@@ -40,6 +44,7 @@ static inline char *get_writable_string_data(std::string &value) noexcept {
 struct ATFW_UTIL_SYMBOL_LOCAL sha_internal_data {
   unsigned char output[EVP_MAX_MD_SIZE];
   EVP_MD_CTX *ctx;
+  const EVP_MD *md;
 };
 
 static inline sha_internal_data *into_internal_type(void *in) { return reinterpret_cast<sha_internal_data *>(in); }
@@ -104,6 +109,7 @@ static inline sha_internal_data *malloc_internal_type(ATFRAMEWORK_UTILS_NAMESPAC
     return nullptr;
   }
 
+  ret->md = md;
   if (1 != EVP_DigestInit_ex(ret->ctx, md, nullptr)) {
     free_internal_type(ret, t);
     return nullptr;
@@ -112,6 +118,17 @@ static inline sha_internal_data *malloc_internal_type(ATFRAMEWORK_UTILS_NAMESPAC
   return ret;
 }
 
+static inline bool reset_internal_type(void *in, ATFRAMEWORK_UTILS_NAMESPACE_ID::hash::sha::type) {
+  sha_internal_data *obj = into_internal_type(in);
+#  if defined(OPENSSL_VERSION_NUMBER) && OPENSSL_VERSION_NUMBER >= 0x30000000L && \
+      !defined(LIBRESSL_VERSION_NUMBER) && !defined(OPENSSL_IS_BORINGSSL)
+  // 传空的 type 复用已经 fetch 过的摘要算法，避免 OpenSSL 3.x 每次 init 都隐式 fetch
+  return 1 == EVP_DigestInit_ex2(obj->ctx, nullptr, nullptr);
+#  else
+  return 1 == EVP_DigestInit_ex(obj->ctx, obj->md, nullptr);
+#  endif
+}
+
 static inline unsigned char *get_output_buffer(void *in) {
   if (in == nullptr) {
     return nullptr;
@@ -224,6 +241,45 @@ static inline sha_internal_data *malloc_internal_type(ATFRAMEWORK_UTILS_NAMESPAC
   return ret;
 }
 
+static inline bool reset_internal_type(void *in, ATFRAMEWORK_UTILS_NAMESPACE_ID::hash::sha::type t) {
+  sha_internal_data *obj = into_internal_type(in);
+  switch (t) {
+    case ATFRAMEWORK_UTILS_NAMESPACE_ID::hash::sha::EN_ALGORITHM_SHA1:
+#  if MBEDTLS_VERSION_MAJOR >= 3
+      return 0 == mbedtls_sha1_starts(&obj->sha1_context);
+#  else
+      return 0 == mbedtls_sha1_starts_ret(&obj->sha1_context);
+#  endif
+    case ATFRAMEWORK_UTILS_NAMESPACE_ID::hash::sha::EN_ALGORITHM_SHA224:
+#  if MBEDTLS_VERSION_MAJOR >= 3
+      return 0 == mbedtls_sha256_starts(&obj->sha224_context, 1);
+#  else
+      return 0 == mbedtls_sha256_starts_ret(&obj->sha224_context, 1);
+#  endif
+    case ATFRAMEWORK_UTILS_NAMESPACE_ID::hash::sha::EN_ALGORITHM_SHA256:
+#  if MBEDTLS_VERSION_MAJOR >= 3
+      return 0 == mbedtls_sha256_starts(&obj->sha256_context, 0);
+#  else
+      return 0 == mbedtls_sha256_starts_ret(&obj->sha256_context, 0);
+#  endif
+    case ATFRAMEWORK_UTILS_NAMESPACE_ID::hash::sha::EN_ALGORITHM_SHA384:
+#  if MBEDTLS_VERSION_MAJOR >= 3
+      return 0 == mbedtls_sha512_starts(&obj->sha384_context, 1);
+#  else
+      return 0 == mbedtls_sha512_starts_ret(&obj->sha384_context, 1);
+#  endif
+    case ATFRAMEWORK_UTILS_NAMESPACE_ID::hash::sha::EN_ALGORITHM_SHA512:
+#  if MBEDTLS_VERSION_MAJOR >= 3
+      return 0 == mbedtls_sha512_starts(&obj->sha512_context, 0);
+#  else
+      return 0 == mbedtls_sha512_starts_ret(&obj->sha512_context, 0);
+#  endif
+    default:
+      break;
+  }
+  return false;
+}
+
 static inline unsigned char *get_output_buffer(void *in) {
   if (in == nullptr) {
     return nullptr;
@@ -404,12 +460,8 @@ static void internal_sha512_starts_ret(sha512_context_t &ctx, bool is384) {
   }
 }
 
-static sha_internal_data *malloc_internal_type(ATFRAMEWORK_UTILS_NAMESPACE_ID::hash::sha::type t) {
-  sha_internal_data *ret = reinterpret_cast<sha_internal_data *>(malloc(sizeof(sha_internal_data)));
-  if (ret == nullptr) {
-    return nullptr;
-  }
-
+static bool reset_internal_type(void *in, ATFRAMEWORK_UTILS_NAMESPACE_ID::hash::sha::type t) {
+  sha_internal_data *ret = into_internal_type(in);
   switch (t) {
     case ATFRAMEWORK_UTILS_NAMESPACE_ID::hash::sha::EN_ALGORITHM_SHA1:
       memset(&ret->sha1_context, 0, sizeof(ret->sha1_context));
@@ -432,9 +484,19 @@ static sha_internal_data *malloc_internal_type(ATFRAMEWORK_UTILS_NAMESPACE_ID::h
       internal_sha512_starts_ret(ret->sha512_context, false);
       break;
     default:
-      break;
+      return false;
+  }
+
+  return true;
+}
+
+static sha_internal_data *malloc_internal_type(ATFRAMEWORK_UTILS_NAMESPACE_ID::hash::sha::type t) {
+  sha_internal_data *ret = reinterpret_cast<sha_internal_data *>(malloc(sizeof(sha_internal_data)));
+  if (ret == nullptr) {
+    return nullptr;
   }
 
+  reset_internal_type(ret, t);
   return ret;
 }
 
@@ -691,22 +753,23 @@ static void internal_sha1_finish(sha1_context_t &ctx, unsigned char output[20])
   PUT_UINT32_BE(ctx.state[4], output, 16);
 }
 
+static constexpr const uint32_t kSha256RoundConstants[64] = {
+    0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+    0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+    0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+    0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+    0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+    0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+    0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+    0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2,
+};
+
 static void internal_sha256_process(sha256_context_t &ctx, const unsigned char data[64]) {
+  const uint32_t *K = kSha256RoundConstants;
   uint32_t temp1, temp2, W[64];
   uint32_t A[8];
   unsigned int i;
 
-  static constexpr const uint32_t K[] = {
-      0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
-      0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
-      0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
-      0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
-      0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
-      0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
-      0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
-      0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2,
-  };
-
 #  define SHR(x, n) (((x) & 0xFFFFFFFF) >> (n))
 #  define ROTR(x, n) (SHR(x, n) | ((x) << (32 - (n))))
 
@@ -1056,6 +1119,221 @@ static void internal_sha512_finish(sha512_context_t &ctx, unsigned char output[6
     PUT_UINT64_BE(ctx.state[7], output, 56);
   }
 }
+#  if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+/*
+ * 多缓冲区SHA-256: 每条消息占AVX2寄存器的一个32位通道，一次处理8个分组
+ * 状态按 state[字][通道] 转置保存，通道上的消息结束后立刻换入下一条消息
+ */
+enum : size_t {
+  SHA256_MULTI_BUFFER_LANES = 8,
+  // 没有待处理的消息且活跃通道不超过这个数量时，剩下的分组改用标量实现，避免空跑
+  SHA256_MULTI_BUFFER_SCALAR_THRESHOLD = 2,
+};
+
+struct sha256_multi_buffer_lane_t {
+  const unsigned char *input;
+  size_t message_index;
+  size_t next_block;
+  size_t full_blocks;
+  size_t total_blocks;
+  unsigned char tail[128];  // 最后不足一个分组的数据加上填充，占1到2个分组
+  bool active;
+};
+
+static void internal_sha256_multi_buffer_setup_lane(sha256_multi_buffer_lane_t &lane,
+                                                    uint32_t state[8][SHA256_MULTI_BUFFER_LANES], size_t lane_index,
+                                                    size_t message_index, const void *input, size_t ilen,
+                                                    bool is224) {
+  lane.input = reinterpret_cast<const unsigned char *>(input);
+  lane.message_index = message_index;
+  lane.next_block = 0;
+  lane.full_blocks = ilen >> 6;
+  lane.active = true;
+
+  size_t rest = ilen & 0x3F;
+  size_t tail_blocks = rest + 9 <= 64 ? 1 : 2;
+  if (rest > 0) {
+    memcpy(lane.tail, lane.input + (lane.full_blocks << 6), rest);
+  }
+  lane.tail[rest] = 0x80;
+  memset(lane.tail + rest + 1, 0, (tail_blocks << 6) - rest - 9);
+
+  uint32_t high = static_cast<uint32_t>(static_cast<uint64_t>(ilen) >> 29);
+  uint32_t low = static_cast<uint32_t>(static_cast<uint64_t>(ilen) << 3);
+  PUT_UINT32_BE(high, lane.tail, (tail_blocks << 6) - 8);
+  PUT_UINT32_BE(low, lane.tail, (tail_blocks << 6) - 4);
+  lane.total_blocks = lane.full_blocks + tail_blocks;
+
+  sha256_context_t init_ctx;
+  internal_sha256_start(init_ctx, is224);
+  for (size_t i = 0; i < 8; ++i) {
+    state[i][lane_index] = init_ctx.state[i];
+  }
+}
+
+static inline const unsigned char *internal_sha256_multi_buffer_lane_block(const sha256_multi_buffer_lane_t &lane) {
+  if (lane.next_block < lane.full_blocks) {
+    return lane.input + (lane.next_block << 6);
+  }
+  return lane.tail + ((lane.next_block - lane.full_blocks) << 6);
+}
+
+static void internal_sha256_multi_buffer_output(const uint32_t state[8][SHA256_MULTI_BUFFER_LANES], size_t lane_index,
+                                                bool is224, unsigned char *output) {
+  size_t words = is224 ? 7 : 8;
+  for (size_t i = 0; i < words; ++i) {
+    PUT_UINT32_BE(state[i][lane_index], output, i << 2);
+  }
+}
+
+static void internal_sha256_multi_buffer_finish_lane(sha256_multi_buffer_lane_t &lane,
+                                                     const uint32_t state[8][SHA256_MULTI_BUFFER_LANES],
+                                                     size_t lane_index, bool is224, unsigned char *output) {
+  sha256_context_t ctx;
+  ctx.is224 = is224 ? 1 : 0;
+  for (size_t i = 0; i < 8; ++i) {
+    ctx.state[i] = state[i][lane_index];
+  }
+
+  for (; lane.next_block < lane.total_blocks; ++lane.next_block) {
+    internal_sha256_process(ctx, internal_sha256_multi_buffer_lane_block(lane));
+  }
+
+  size_t words = is224 ? 7 : 8;
+  for (size_t i = 0; i < words; ++i) {
+    PUT_UINT32_BE(ctx.state[i], output, i << 2);
+  }
+  lane.active = false;
+}
+
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("avx2")
+static void internal_sha256_process_x8(uint32_t state[8][SHA256_MULTI_BUFFER_LANES],
+                                       const unsigned char *const blocks[SHA256_MULTI_BUFFER_LANES]) {
+  const __m256i bswap_mask = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12, 3, 2, 1, 0, 7, 6,
+                                              5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+  __m256i W[16];
+  for (size_t t = 0; t < 16; ++t) {
+    uint32_t words[SHA256_MULTI_BUFFER_LANES];
+    for (size_t lane = 0; lane < SHA256_MULTI_BUFFER_LANES; ++lane) {
+      memcpy(&words[lane], blocks[lane] + (t << 2), sizeof(uint32_t));
+    }
+    W[t] = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(words)), bswap_mask);
+  }
+
+#    define MB_ROTR(x, n) _mm256_or_si256(_mm256_srli_epi32((x), (n)), _mm256_slli_epi32((x), 32 - (n)))
+#    define MB_S0(x) _mm256_xor_si256(_mm256_xor_si256(MB_ROTR(x, 7), MB_ROTR(x, 18)), _mm256_srli_epi32((x), 3))
+#    define MB_S1(x) _mm256_xor_si256(_mm256_xor_si256(MB_ROTR(x, 17), MB_ROTR(x, 19)), _mm256_srli_epi32((x), 10))
+#    define MB_S2(x) _mm256_xor_si256(_mm256_xor_si256(MB_ROTR(x, 2), MB_ROTR(x, 13)), MB_ROTR(x, 22))
+#    define MB_S3(x) _mm256_xor_si256(_mm256_xor_si256(MB_ROTR(x, 6), MB_ROTR(x, 11)), MB_ROTR(x, 25))
+
+  __m256i A[8];
+  for (size_t i = 0; i < 8; ++i) {
+    A[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(state[i]));
+  }
+
+  __m256i a = A[0], b = A[1], c = A[2], d = A[3], e = A[4], f = A[5], g = A[6], h = A[7];
+  for (size_t t = 0; t < 64; ++t) {
+    __m256i w;
+    if (t < 16) {
+      w = W[t];
+    } else {
+      w = _mm256_add_epi32(_mm256_add_epi32(MB_S1(W[(t - 2) & 15]), W[(t - 7) & 15]),
+                           _mm256_add_epi32(MB_S0(W[(t - 15) & 15]), W[t & 15]));
+      W[t & 15] = w;
+    }
+
+    __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+    __m256i maj = _mm256_or_si256(_mm256_and_si256(_mm256_or_si256(a, b), c), _mm256_and_si256(a, b));
+    __m256i temp1 = _mm256_add_epi32(_mm256_add_epi32(h, MB_S3(e)),
+                                     _mm256_add_epi32(_mm256_add_epi32(ch, w),
+                                                      _mm256_set1_epi32(static_cast<int>(kSha256RoundConstants[t]))));
+    __m256i temp2 = _mm256_add_epi32(MB_S2(a), maj);
+    h = g;
+    g = f;
+    f = e;
+    e = _mm256_add_epi32(d, temp1);
+    d = c;
+    c = b;
+    b = a;
+    a = _mm256_add_epi32(temp1, temp2);
+  }
+
+  A[0] = _mm256_add_epi32(A[0], a);
+  A[1] = _mm256_add_epi32(A[1], b);
+  A[2] = _mm256_add_epi32(A[2], c);
+  A[3] = _mm256_add_epi32(A[3], d);
+  A[4] = _mm256_add_epi32(A[4], e);
+  A[5] = _mm256_add_epi32(A[5], f);
+  A[6] = _mm256_add_epi32(A[6], g);
+  A[7] = _mm256_add_epi32(A[7], h);
+  for (size_t i = 0; i < 8; ++i) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(state[i]), A[i]);
+  }
+
+#    undef MB_S3
+#    undef MB_S2
+#    undef MB_S1
+#    undef MB_S0
+#    undef MB_ROTR
+}
+
+static void internal_sha256_hash_batch_x8(const void *const *inputs, const size_t *input_lengths, size_t count,
+                                          unsigned char *outputs, bool is224) {
+  static const unsigned char idle_block[64] = {0};
+  const size_t output_length = is224 ? 28 : 32;
+
+  sha256_multi_buffer_lane_t lanes[SHA256_MULTI_BUFFER_LANES];
+  uint32_t state[8][SHA256_MULTI_BUFFER_LANES];
+  const unsigned char *blocks[SHA256_MULTI_BUFFER_LANES];
+  memset(state, 0, sizeof(state));
+
+  size_t next_message = 0;
+  size_t active_lanes = 0;
+  for (size_t l = 0; l < SHA256_MULTI_BUFFER_LANES; ++l) {
+    if (next_message < count) {
+      internal_sha256_multi_buffer_setup_lane(lanes[l], state, l, next_message, inputs[next_message],
+                                              input_lengths[next_message], is224);
+      ++next_message;
+      ++active_lanes;
+    } else {
+      lanes[l].active = false;
+    }
+  }
+
+  while (active_lanes > 0) {
+    if (next_message >= count && active_lanes <= SHA256_MULTI_BUFFER_SCALAR_THRESHOLD) {
+      for (size_t l = 0; l < SHA256_MULTI_BUFFER_LANES; ++l) {
+        if (lanes[l].active) {
+          internal_sha256_multi_buffer_finish_lane(lanes[l], state, l, is224,
+                                                   outputs + lanes[l].message_index * output_length);
+        }
+      }
+      break;
+    }
+
+    for (size_t l = 0; l < SHA256_MULTI_BUFFER_LANES; ++l) {
+      blocks[l] = lanes[l].active ? internal_sha256_multi_buffer_lane_block(lanes[l]) : idle_block;
+    }
+    internal_sha256_process_x8(state, blocks);
+
+    for (size_t l = 0; l < SHA256_MULTI_BUFFER_LANES; ++l) {
+      if (!lanes[l].active || ++lanes[l].next_block < lanes[l].total_blocks) {
+        continue;
+      }
+
+      internal_sha256_multi_buffer_output(state, l, is224, outputs + lanes[l].message_index * output_length);
+      if (next_message < count) {
+        internal_sha256_multi_buffer_setup_lane(lanes[l], state, l, next_message, inputs[next_message],
+                                                input_lengths[next_message], is224);
+        ++next_message;
+      } else {
+        lanes[l].active = false;
+        --active_lanes;
+      }
+    }
+  }
+}
+#  endif
 #endif
 }  // namespace
 
@@ -1093,6 +1371,14 @@ ATFRAMEWORK_UTILS_API void sha::close() {
   private_raw_data_ = nullptr;
 }
 
+ATFRAMEWORK_UTILS_API bool sha::reset() {
+  if (hash_type_ == EN_ALGORITHM_UNINITED || private_raw_data_ == nullptr) {
+    return false;
+  }
+
+  return reset_internal_type(private_raw_data_, hash_type_);
+}
+
 ATFRAMEWORK_UTILS_API void sha::swap(sha &other) noexcept {
   using std::swap;
   swap(hash_type_, other.hash_type_);
@@ -1304,46 +1590,127 @@ ATFRAMEWORK_UTILS_API std::string sha::get_output_base64(ATFRAMEWORK_UTILS_NAMES
   return ret;
 }
 
+namespace {
+#if !(defined(ATFRAMEWORK_UTILS_THREAD_TLS_USE_PTHREAD) && ATFRAMEWORK_UTILS_THREAD_TLS_USE_PTHREAD) && \
+    defined(THREAD_TLS_ENABLED) && 1 == THREAD_TLS_ENABLED
+struct sha_thread_cache_t {
+  sha contexts[sha::EN_ALGORITHM_SHA512 + 1];
+};
+#endif
+
+/**
+ * @brief 获取当前线程缓存的上下文并重置，不支持TLS时使用调用者提供的 fallback
+ */
+static sha *get_thread_cached_context(sha::type t, sha &fallback) {
+  sha *ret = &fallback;
+#if !(defined(ATFRAMEWORK_UTILS_THREAD_TLS_USE_PTHREAD) && ATFRAMEWORK_UTILS_THREAD_TLS_USE_PTHREAD) && \
+    defined(THREAD_TLS_ENABLED) && 1 == THREAD_TLS_ENABLED
+  if (t > sha::EN_ALGORITHM_UNINITED && t <= sha::EN_ALGORITHM_SHA512) {
+    static THREAD_TLS sha_thread_cache_t cache;
+    ret = &cache.contexts[t];
+  }
+#endif
+
+  if (ret->get_type() == t && ret->reset()) {
+    return ret;
+  }
+
+  if (false == ret->init(t)) {
+    return nullptr;
+  }
+  return ret;
+}
+}  // namespace
+
 ATFRAMEWORK_UTILS_API std::string sha::hash_to_binary(type t, const void *in, size_t inlen) {
-  sha obj;
+  sha fallback;
   std::string ret;
 
-  if (false == obj.init(t)) {
+  sha *obj = get_thread_cached_context(t, fallback);
+  if (obj == nullptr) {
     return ret;
   }
 
-  obj.update(reinterpret_cast<const unsigned char *>(in), inlen);
-  obj.final();
-  ret.assign(reinterpret_cast<const char *>(obj.get_output()), obj.get_output_length());
+  obj->update(reinterpret_cast<const unsigned char *>(in), inlen);
+  obj->final();
+  ret.assign(reinterpret_cast<const char *>(obj->get_output()), obj->get_output_length());
 
   return ret;
 }
 
 ATFRAMEWORK_UTILS_API std::string sha::hash_to_hex(type t, const void *in, size_t inlen, bool is_uppercase) {
-  sha obj;
+  sha fallback;
 
-  if (false == obj.init(t)) {
+  sha *obj = get_thread_cached_context(t, fallback);
+  if (obj == nullptr) {
     return {};
   }
 
-  obj.update(reinterpret_cast<const unsigned char *>(in), inlen);
-  obj.final();
+  obj->update(reinterpret_cast<const unsigned char *>(in), inlen);
+  obj->final();
 
-  return obj.get_output_hex(is_uppercase);
+  return obj->get_output_hex(is_uppercase);
 }
 
 ATFRAMEWORK_UTILS_API std::string sha::hash_to_base64(type t, const void *in, size_t inlen,
                                                       ATFRAMEWORK_UTILS_NAMESPACE_ID::base64_mode_t::type bt) {
-  sha obj;
+  sha fallback;
 
-  if (false == obj.init(t)) {
+  sha *obj = get_thread_cached_context(t, fallback);
+  if (obj == nullptr) {
     return {};
   }
 
-  obj.update(reinterpret_cast<const unsigned char *>(in), inlen);
-  obj.final();
+  obj->update(reinterpret_cast<const unsigned char *>(in), inlen);
+  obj->final();
+
+  return obj->get_output_base64(bt);
+}
 
-  return obj.get_output_base64(bt);
+ATFRAMEWORK_UTILS_API bool sha::hash_batch(type t, const void *const *inputs, const size_t *input_lengths,
+                                           size_t count, unsigned char *outputs, size_t output_size) {
+  if (count == 0) {
+    return true;
+  }
+
+  if (inputs == nullptr || input_lengths == nullptr || outputs == nullptr) {
+    return false;
+  }
+
+  size_t output_length = get_output_length(t);
+  if (output_length == 0 || output_size / output_length < count) {
+    return false;
+  }
+
+#if !(defined(UTIL_HASH_IMPLEMENT_SHA_USING_OPENSSL) && UTIL_HASH_IMPLEMENT_SHA_USING_OPENSSL) &&   \
+    !(defined(UTIL_HASH_IMPLEMENT_SHA_USING_MBEDTLS) && UTIL_HASH_IMPLEMENT_SHA_USING_MBEDTLS) && \
+    defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+  if ((t == EN_ALGORITHM_SHA224 || t == EN_ALGORITHM_SHA256) && count > SHA256_MULTI_BUFFER_SCALAR_THRESHOLD &&
+      platform::get_cpu_features().has_avx2) {
+    internal_sha256_hash_batch_x8(inputs, input_lengths, count, outputs, t == EN_ALGORITHM_SHA224);
+    return true;
+  }
+#endif
+
+  sha fallback;
+  sha *obj = get_thread_cached_context(t, fallback);
+  if (obj == nullptr) {
+    return false;
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    if (i > 0 && false == obj->reset()) {
+      return false;
+    }
+
+    if (false == obj->update(reinterpret_cast<const unsigned char *>(inputs[i]), input_lengths[i]) ||
+        false == obj->final()) {
+      return false;
+    }
+    memcpy(outputs + i * output_length, obj->get_output(), output_length);
+  }
+
+  return true;
 }
 }  // namespace hash
 ATFRAMEWORK_UTILS_NAMESPACE_END
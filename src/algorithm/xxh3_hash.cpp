@@ -0,0 +1,618 @@
+// Copyright 2026 atframework
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <config/atframe_utils_build_feature.h>
+#include <config/compile_optimize.h>
+
+#include "algorithm/bit.h"
+#include "algorithm/xxh3_hash.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+#  include <intrin.h>
+#endif
+
+// SSE2 是 x86_64 的基础指令集，不需要运行时检测
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define ATFW_UTIL_XXH3_HASH_USE_SSE2 1
+#  include <emmintrin.h>
+#endif
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace hash {
+
+namespace {
+static constexpr const uint32_t kXxhPrime32_1 = 0x9E3779B1U;
+static constexpr const uint32_t kXxhPrime32_2 = 0x85EBCA77U;
+static constexpr const uint32_t kXxhPrime32_3 = 0xC2B2AE3DU;
+static constexpr const uint64_t kXxhPrime64_1 = 0x9E3779B185EBCA87ULL;
+static constexpr const uint64_t kXxhPrime64_2 = 0xC2B2AE3D27D4EB4FULL;
+static constexpr const uint64_t kXxhPrime64_3 = 0x165667B19E3779F9ULL;
+static constexpr const uint64_t kXxhPrime64_4 = 0x85EBCA77C2B2AE63ULL;
+static constexpr const uint64_t kXxhPrime64_5 = 0x27D4EB2F165667C5ULL;
+static constexpr const uint64_t kXxhPrimeMx1 = 0x165667919E3779F9ULL;
+static constexpr const uint64_t kXxhPrimeMx2 = 0x9FB21C651E98DF25ULL;
+
+static constexpr const size_t kXxh3StripeLen = 64;
+static constexpr const size_t kXxh3SecretConsumeRate = 8;
+static constexpr const size_t kXxh3SecretSizeMin = 136;
+static constexpr const size_t kXxh3MidSizeMax = 240;
+static constexpr const size_t kXxh3MidSizeStartOffset = 3;
+static constexpr const size_t kXxh3MidSizeLastOffset = 17;
+static constexpr const size_t kXxh3SecretLastAccStart = 7;
+static constexpr const size_t kXxh3SecretMergeAccsStart = 11;
+
+static constexpr const size_t kXxh3SecretLimit = xxh3_state::SECRET_SIZE - kXxh3StripeLen;
+static constexpr const size_t kXxh3StripesPerBlock = kXxh3SecretLimit / kXxh3SecretConsumeRate;
+static constexpr const size_t kXxh3BufferStripes = xxh3_state::BUFFER_SIZE / kXxh3StripeLen;
+
+static const unsigned char kXxh3Secret[xxh3_state::SECRET_SIZE] = {
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c, 0xde, 0xd4, 0x6d,
+    0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f, 0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0,
+    0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21, 0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0,
+    0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c, 0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b,
+    0x1b, 0x53, 0x2e, 0xa3, 0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac,
+    0xd8, 0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d, 0x8a, 0x51,
+    0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64, 0xea, 0xc5, 0xac, 0x83, 0x34,
+    0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb, 0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49,
+    0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e, 0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8,
+    0xd1, 0x7a, 0xd0, 0x31, 0xce, 0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b,
+    0x40, 0x7e,
+};
+
+ATFW_UTIL_FORCEINLINE static uint32_t xxh_read32(const unsigned char *p) noexcept { return bit::read_le_uint32(p); }
+
+ATFW_UTIL_FORCEINLINE static uint64_t xxh_read64(const unsigned char *p) noexcept { return bit::read_le_uint64(p); }
+
+ATFW_UTIL_FORCEINLINE static uint32_t xxh_swap32(uint32_t x) noexcept {
+  return ((x << 24) & 0xff000000U) | ((x << 8) & 0x00ff0000U) | ((x >> 8) & 0x0000ff00U) | ((x >> 24) & 0x000000ffU);
+}
+
+ATFW_UTIL_FORCEINLINE static uint64_t xxh_swap64(uint64_t x) noexcept {
+  return (static_cast<uint64_t>(xxh_swap32(static_cast<uint32_t>(x))) << 32) |
+         static_cast<uint64_t>(xxh_swap32(static_cast<uint32_t>(x >> 32)));
+}
+
+ATFW_UTIL_FORCEINLINE static uint64_t xxh_rotl64(uint64_t x, int r) noexcept { return (x << r) | (x >> (64 - r)); }
+
+ATFW_UTIL_FORCEINLINE static uint32_t xxh_rotl32(uint32_t x, int r) noexcept { return (x << r) | (x >> (32 - r)); }
+
+ATFW_UTIL_FORCEINLINE static uint64_t xxh_xorshift64(uint64_t v, int shift) noexcept { return v ^ (v >> shift); }
+
+ATFW_UTIL_FORCEINLINE static xxh3_hash128_t xxh_mul64to128(uint64_t lhs, uint64_t rhs) noexcept {
+  xxh3_hash128_t ret;
+#if defined(__SIZEOF_INT128__)
+  __uint128_t product = static_cast<__uint128_t>(lhs) * rhs;
+  ret.low64 = static_cast<uint64_t>(product);
+  ret.high64 = static_cast<uint64_t>(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+  ret.low64 = _umul128(lhs, rhs, &ret.high64);
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+  ret.low64 = lhs * rhs;
+  ret.high64 = __umulh(lhs, rhs);
+#else
+  uint64_t lo_lo = (lhs & 0xFFFFFFFFULL) * (rhs & 0xFFFFFFFFULL);
+  uint64_t hi_lo = (lhs >> 32) * (rhs & 0xFFFFFFFFULL);
+  uint64_t lo_hi = (lhs & 0xFFFFFFFFULL) * (rhs >> 32);
+  uint64_t hi_hi = (lhs >> 32) * (rhs >> 32);
+  uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFULL) + lo_hi;
+  ret.high64 = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+  ret.low64 = (cross << 32) | (lo_lo & 0xFFFFFFFFULL);
+#endif
+  return ret;
+}
+
+ATFW_UTIL_FORCEINLINE static uint64_t xxh_mul128_fold64(uint64_t lhs, uint64_t rhs) noexcept {
+  xxh3_hash128_t product = xxh_mul64to128(lhs, rhs);
+  return product.low64 ^ product.high64;
+}
+
+ATFW_UTIL_FORCEINLINE static uint64_t xxh64_avalanche(uint64_t h) noexcept {
+  h ^= h >> 33;
+  h *= kXxhPrime64_2;
+  h ^= h >> 29;
+  h *= kXxhPrime64_3;
+  h ^= h >> 32;
+  return h;
+}
+
+ATFW_UTIL_FORCEINLINE static uint64_t xxh3_avalanche(uint64_t h) noexcept {
+  h = xxh_xorshift64(h, 37);
+  h *= kXxhPrimeMx1;
+  h = xxh_xorshift64(h, 32);
+  return h;
+}
+
+ATFW_UTIL_FORCEINLINE static uint64_t xxh3_rrmxmx(uint64_t h, uint64_t len) noexcept {
+  h ^= xxh_rotl64(h, 49) ^ xxh_rotl64(h, 24);
+  h *= kXxhPrimeMx2;
+  h ^= (h >> 35) + len;
+  h *= kXxhPrimeMx2;
+  return xxh_xorshift64(h, 28);
+}
+
+ATFW_UTIL_FORCEINLINE static uint64_t xxh3_mix16(const unsigned char *input, const unsigned char *secret,
+                                                 uint64_t seed) noexcept {
+  uint64_t input_lo = xxh_read64(input);
+  uint64_t input_hi = xxh_read64(input + 8);
+  return xxh_mul128_fold64(input_lo ^ (xxh_read64(secret) + seed), input_hi ^ (xxh_read64(secret + 8) - seed));
+}
+
+// ================ 64位短数据 ================
+static uint64_t xxh3_len_0to16_64(const unsigned char *input, size_t len, const unsigned char *secret,
+                                  uint64_t seed) noexcept {
+  if (len > 8) {
+    uint64_t bitflip1 = (xxh_read64(secret + 24) ^ xxh_read64(secret + 32)) + seed;
+    uint64_t bitflip2 = (xxh_read64(secret + 40) ^ xxh_read64(secret + 48)) - seed;
+    uint64_t input_lo = xxh_read64(input) ^ bitflip1;
+    uint64_t input_hi = xxh_read64(input + len - 8) ^ bitflip2;
+    uint64_t acc = len + xxh_swap64(input_lo) + input_hi + xxh_mul128_fold64(input_lo, input_hi);
+    return xxh3_avalanche(acc);
+  }
+
+  if (len >= 4) {
+    seed ^= static_cast<uint64_t>(xxh_swap32(static_cast<uint32_t>(seed))) << 32;
+    uint32_t input1 = xxh_read32(input);
+    uint32_t input2 = xxh_read32(input + len - 4);
+    uint64_t bitflip = (xxh_read64(secret + 8) ^ xxh_read64(secret + 16)) - seed;
+    uint64_t input64 = input2 + (static_cast<uint64_t>(input1) << 32);
+    return xxh3_rrmxmx(input64 ^ bitflip, len);
+  }
+
+  if (len > 0) {
+    uint32_t combined = (static_cast<uint32_t>(input[0]) << 16) | (static_cast<uint32_t>(input[len >> 1]) << 24) |
+                        static_cast<uint32_t>(input[len - 1]) | (static_cast<uint32_t>(len) << 8);
+    uint64_t bitflip = (xxh_read32(secret) ^ xxh_read32(secret + 4)) + seed;
+    return xxh64_avalanche(static_cast<uint64_t>(combined) ^ bitflip);
+  }
+
+  return xxh64_avalanche(seed ^ (xxh_read64(secret + 56) ^ xxh_read64(secret + 64)));
+}
+
+static uint64_t xxh3_len_17to128_64(const unsigned char *input, size_t len, const unsigned char *secret,
+                                    uint64_t seed) noexcept {
+  uint64_t acc = len * kXxhPrime64_1;
+  if (len > 32) {
+    if (len > 64) {
+      if (len > 96) {
+        acc += xxh3_mix16(input + 48, secret + 96, seed);
+        acc += xxh3_mix16(input + len - 64, secret + 112, seed);
+      }
+      acc += xxh3_mix16(input + 32, secret + 64, seed);
+      acc += xxh3_mix16(input + len - 48, secret + 80, seed);
+    }
+    acc += xxh3_mix16(input + 16, secret + 32, seed);
+    acc += xxh3_mix16(input + len - 32, secret + 48, seed);
+  }
+  acc += xxh3_mix16(input, secret, seed);
+  acc += xxh3_mix16(input + len - 16, secret + 16, seed);
+  return xxh3_avalanche(acc);
+}
+
+static uint64_t xxh3_len_129to240_64(const unsigned char *input, size_t len, const unsigned char *secret,
+                                     uint64_t seed) noexcept {
+  uint64_t acc = len * kXxhPrime64_1;
+  size_t rounds = len / 16;
+  for (size_t i = 0; i < 8; ++i) {
+    acc += xxh3_mix16(input + 16 * i, secret + 16 * i, seed);
+  }
+  acc = xxh3_avalanche(acc);
+
+  uint64_t acc_end = xxh3_mix16(input + len - 16, secret + kXxh3SecretSizeMin - kXxh3MidSizeLastOffset, seed);
+  for (size_t i = 8; i < rounds; ++i) {
+    acc_end += xxh3_mix16(input + 16 * i, secret + 16 * (i - 8) + kXxh3MidSizeStartOffset, seed);
+  }
+  return xxh3_avalanche(acc + acc_end);
+}
+
+// ================ 128位短数据 ================
+static xxh3_hash128_t xxh3_len_0to16_128(const unsigned char *input, size_t len, const unsigned char *secret,
+                                         uint64_t seed) noexcept {
+  xxh3_hash128_t ret;
+  if (len > 8) {
+    uint64_t bitflipl = (xxh_read64(secret + 32) ^ xxh_read64(secret + 40)) - seed;
+    uint64_t bitfliph = (xxh_read64(secret + 48) ^ xxh_read64(secret + 56)) + seed;
+    uint64_t input_lo = xxh_read64(input);
+    uint64_t input_hi = xxh_read64(input + len - 8);
+    xxh3_hash128_t m128 = xxh_mul64to128(input_lo ^ input_hi ^ bitflipl, kXxhPrime64_1);
+    m128.low64 += static_cast<uint64_t>(len - 1) << 54;
+    input_hi ^= bitfliph;
+    m128.high64 += input_hi + static_cast<uint64_t>(static_cast<uint32_t>(input_hi)) * (kXxhPrime32_2 - 1);
+    m128.low64 ^= xxh_swap64(m128.high64);
+
+    ret = xxh_mul64to128(m128.low64, kXxhPrime64_2);
+    ret.high64 += m128.high64 * kXxhPrime64_2;
+    ret.low64 = xxh3_avalanche(ret.low64);
+    ret.high64 = xxh3_avalanche(ret.high64);
+    return ret;
+  }
+
+  if (len >= 4) {
+    seed ^= static_cast<uint64_t>(xxh_swap32(static_cast<uint32_t>(seed))) << 32;
+    uint32_t input_lo = xxh_read32(input);
+    uint32_t input_hi = xxh_read32(input + len - 4);
+    uint64_t input64 = input_lo + (static_cast<uint64_t>(input_hi) << 32);
+    uint64_t bitflip = (xxh_read64(secret + 16) ^ xxh_read64(secret + 24)) + seed;
+
+    // len左移保证乘数是奇数
+    ret = xxh_mul64to128(input64 ^ bitflip, kXxhPrime64_1 + (len << 2));
+    ret.high64 += (ret.low64 << 1);
+    ret.low64 ^= (ret.high64 >> 3);
+    ret.low64 = xxh_xorshift64(ret.low64, 35);
+    ret.low64 *= kXxhPrimeMx2;
+    ret.low64 = xxh_xorshift64(ret.low64, 28);
+    ret.high64 = xxh3_avalanche(ret.high64);
+    return ret;
+  }
+
+  if (len > 0) {
+    uint32_t combinedl = (static_cast<uint32_t>(input[0]) << 16) | (static_cast<uint32_t>(input[len >> 1]) << 24) |
+                         static_cast<uint32_t>(input[len - 1]) | (static_cast<uint32_t>(len) << 8);
+    uint32_t combinedh = xxh_rotl32(xxh_swap32(combinedl), 13);
+    uint64_t bitflipl = (xxh_read32(secret) ^ xxh_read32(secret + 4)) + seed;
+    uint64_t bitfliph = (xxh_read32(secret + 8) ^ xxh_read32(secret + 12)) - seed;
+    ret.low64 = xxh64_avalanche(static_cast<uint64_t>(combinedl) ^ bitflipl);
+    ret.high64 = xxh64_avalanche(static_cast<uint64_t>(combinedh) ^ bitfliph);
+    return ret;
+  }
+
+  ret.low64 = xxh64_avalanche(seed ^ (xxh_read64(secret + 64) ^ xxh_read64(secret + 72)));
+  ret.high64 = xxh64_avalanche(seed ^ (xxh_read64(secret + 80) ^ xxh_read64(secret + 88)));
+  return ret;
+}
+
+ATFW_UTIL_FORCEINLINE static void xxh3_mix32_128(xxh3_hash128_t &acc, const unsigned char *input1,
+                                                 const unsigned char *input2, const unsigned char *secret,
+                                                 uint64_t seed) noexcept {
+  acc.low64 += xxh3_mix16(input1, secret, seed);
+  acc.low64 ^= xxh_read64(input2) + xxh_read64(input2 + 8);
+  acc.high64 += xxh3_mix16(input2, secret + 16, seed);
+  acc.high64 ^= xxh_read64(input1) + xxh_read64(input1 + 8);
+}
+
+ATFW_UTIL_FORCEINLINE static xxh3_hash128_t xxh3_finalize_mid_128(const xxh3_hash128_t &acc, size_t len,
+                                                                  uint64_t seed) noexcept {
+  xxh3_hash128_t ret;
+  ret.low64 = xxh3_avalanche(acc.low64 + acc.high64);
+  ret.high64 = (acc.low64 * kXxhPrime64_1) + (acc.high64 * kXxhPrime64_4) + ((len - seed) * kXxhPrime64_2);
+  ret.high64 = static_cast<uint64_t>(0) - xxh3_avalanche(ret.high64);
+  return ret;
+}
+
+static xxh3_hash128_t xxh3_len_17to128_128(const unsigned char *input, size_t len, const unsigned char *secret,
+                                           uint64_t seed) noexcept {
+  xxh3_hash128_t acc;
+  acc.low64 = len * kXxhPrime64_1;
+  acc.high64 = 0;
+  if (len > 32) {
+    if (len > 64) {
+      if (len > 96) {
+        xxh3_mix32_128(acc, input + 48, input + len - 64, secret + 96, seed);
+      }
+      xxh3_mix32_128(acc, input + 32, input + len - 48, secret + 64, seed);
+    }
+    xxh3_mix32_128(acc, input + 16, input + len - 32, secret + 32, seed);
+  }
+  xxh3_mix32_128(acc, input, input + len - 16, secret, seed);
+  return xxh3_finalize_mid_128(acc, len, seed);
+}
+
+static xxh3_hash128_t xxh3_len_129to240_128(const unsigned char *input, size_t len, const unsigned char *secret,
+                                            uint64_t seed) noexcept {
+  xxh3_hash128_t acc;
+  acc.low64 = len * kXxhPrime64_1;
+  acc.high64 = 0;
+  for (size_t i = 32; i < 160; i += 32) {
+    xxh3_mix32_128(acc, input + i - 32, input + i - 16, secret + i - 32, seed);
+  }
+  acc.low64 = xxh3_avalanche(acc.low64);
+  acc.high64 = xxh3_avalanche(acc.high64);
+
+  for (size_t i = 160; i <= len; i += 32) {
+    xxh3_mix32_128(acc, input + i - 32, input + i - 16, secret + kXxh3MidSizeStartOffset + i - 160, seed);
+  }
+  // last bytes
+  xxh3_mix32_128(acc, input + len - 16, input + len - 32,
+                 secret + kXxh3SecretSizeMin - kXxh3MidSizeLastOffset - 16, static_cast<uint64_t>(0) - seed);
+  return xxh3_finalize_mid_128(acc, len, seed);
+}
+
+// ================ 长数据 ================
+ATFW_UTIL_FORCEINLINE static void xxh3_init_acc(uint64_t *acc) noexcept {
+  acc[0] = kXxhPrime32_3;
+  acc[1] = kXxhPrime64_1;
+  acc[2] = kXxhPrime64_2;
+  acc[3] = kXxhPrime64_3;
+  acc[4] = kXxhPrime64_4;
+  acc[5] = kXxhPrime32_2;
+  acc[6] = kXxhPrime64_5;
+  acc[7] = kXxhPrime32_1;
+}
+
+static void xxh3_init_secret(unsigned char *secret, uint64_t seed) noexcept {
+  for (size_t i = 0; i < xxh3_state::SECRET_SIZE; i += 16) {
+    bit::write_le_uint64(secret + i, xxh_read64(kXxh3Secret + i) + seed);
+    bit::write_le_uint64(secret + i + 8, xxh_read64(kXxh3Secret + i + 8) - seed);
+  }
+}
+
+ATFW_UTIL_FORCEINLINE static void xxh3_accumulate_stripe(uint64_t *acc, const unsigned char *input,
+                                                         const unsigned char *secret) noexcept {
+  for (size_t i = 0; i < xxh3_state::ACCUMULATOR_COUNT; ++i) {
+    uint64_t data_val = xxh_read64(input + i * 8);
+    uint64_t data_key = data_val ^ xxh_read64(secret + i * 8);
+    // swap adjacent lanes
+    acc[i ^ 1] += data_val;
+    acc[i] += (data_key & 0xFFFFFFFFULL) * (data_key >> 32);
+  }
+}
+
+#if defined(ATFW_UTIL_XXH3_HASH_USE_SSE2)
+ATFW_UTIL_FORCEINLINE static void xxh3_accumulate(uint64_t *acc, const unsigned char *input,
+                                                  const unsigned char *secret, size_t stripes) noexcept {
+  __m128i xacc[4];
+  for (size_t i = 0; i < 4; ++i) {
+    xacc[i] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(acc) + i);
+  }
+
+  for (size_t n = 0; n < stripes; ++n) {
+    const __m128i *xinput = reinterpret_cast<const __m128i *>(input + n * kXxh3StripeLen);
+    const __m128i *xsecret = reinterpret_cast<const __m128i *>(secret + n * kXxh3SecretConsumeRate);
+    for (size_t i = 0; i < 4; ++i) {
+      __m128i data_vec = _mm_loadu_si128(xinput + i);
+      __m128i data_key = _mm_xor_si128(data_vec, _mm_loadu_si128(xsecret + i));
+      // 每个64位通道的低32位乘以高32位
+      __m128i product = _mm_mul_epu32(data_key, _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1)));
+      // swap adjacent lanes
+      __m128i data_swap = _mm_shuffle_epi32(data_vec, _MM_SHUFFLE(1, 0, 3, 2));
+      xacc[i] = _mm_add_epi64(product, _mm_add_epi64(xacc[i], data_swap));
+    }
+  }
+
+  for (size_t i = 0; i < 4; ++i) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(acc) + i, xacc[i]);
+  }
+}
+
+ATFW_UTIL_FORCEINLINE static void xxh3_scramble(uint64_t *acc, const unsigned char *secret) noexcept {
+  const __m128i prime32 = _mm_set1_epi32(static_cast<int>(kXxhPrime32_1));
+  for (size_t i = 0; i < 4; ++i) {
+    __m128i acc_vec = _mm_loadu_si128(reinterpret_cast<const __m128i *>(acc) + i);
+    acc_vec = _mm_xor_si128(acc_vec, _mm_srli_epi64(acc_vec, 47));
+    acc_vec = _mm_xor_si128(acc_vec, _mm_loadu_si128(reinterpret_cast<const __m128i *>(secret) + i));
+
+    // 64位乘以32位常量，拆成低32位和高32位两次乘法
+    __m128i product_lo = _mm_mul_epu32(acc_vec, prime32);
+    __m128i product_hi = _mm_mul_epu32(_mm_shuffle_epi32(acc_vec, _MM_SHUFFLE(0, 3, 0, 1)), prime32);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(acc) + i,
+                     _mm_add_epi64(product_lo, _mm_slli_epi64(product_hi, 32)));
+  }
+}
+#else
+ATFW_UTIL_FORCEINLINE static void xxh3_accumulate(uint64_t *acc, const unsigned char *input,
+                                                  const unsigned char *secret, size_t stripes) noexcept {
+  // 累加器放在局部变量里，避免和 unsigned char 类型的输入产生别名导致每次都要写回内存
+  uint64_t local_acc[xxh3_state::ACCUMULATOR_COUNT];
+  memcpy(local_acc, acc, sizeof(local_acc));
+  for (size_t n = 0; n < stripes; ++n) {
+    xxh3_accumulate_stripe(local_acc, input + n * kXxh3StripeLen, secret + n * kXxh3SecretConsumeRate);
+  }
+  memcpy(acc, local_acc, sizeof(local_acc));
+}
+
+ATFW_UTIL_FORCEINLINE static void xxh3_scramble(uint64_t *acc, const unsigned char *secret) noexcept {
+  for (size_t i = 0; i < xxh3_state::ACCUMULATOR_COUNT; ++i) {
+    uint64_t value = xxh_xorshift64(acc[i], 47);
+    value ^= xxh_read64(secret + i * 8);
+    value *= kXxhPrime32_1;
+    acc[i] = value;
+  }
+}
+#endif
+
+static uint64_t xxh3_merge_accs(const uint64_t *acc, const unsigned char *secret, uint64_t start) noexcept {
+  uint64_t ret = start;
+  for (size_t i = 0; i < 4; ++i) {
+    ret += xxh_mul128_fold64(acc[2 * i] ^ xxh_read64(secret + 16 * i),
+                             acc[2 * i + 1] ^ xxh_read64(secret + 16 * i + 8));
+  }
+  return xxh3_avalanche(ret);
+}
+
+static void xxh3_hash_long(uint64_t *acc, const unsigned char *input, size_t len,
+                           const unsigned char *secret) noexcept {
+  const size_t block_len = kXxh3StripeLen * kXxh3StripesPerBlock;
+  const size_t blocks = (len - 1) / block_len;
+
+  xxh3_init_acc(acc);
+  for (size_t n = 0; n < blocks; ++n) {
+    xxh3_accumulate(acc, input + n * block_len, secret, kXxh3StripesPerBlock);
+    xxh3_scramble(acc, secret + kXxh3SecretLimit);
+  }
+
+  // last partial block
+  size_t stripes = ((len - 1) - (block_len * blocks)) / kXxh3StripeLen;
+  xxh3_accumulate(acc, input + blocks * block_len, secret, stripes);
+
+  // last stripe
+  xxh3_accumulate_stripe(acc, input + len - kXxh3StripeLen, secret + kXxh3SecretLimit - kXxh3SecretLastAccStart);
+}
+
+ATFW_UTIL_FORCEINLINE static uint64_t xxh3_finalize_long_64(const uint64_t *acc, const unsigned char *secret,
+                                                            uint64_t len) noexcept {
+  return xxh3_merge_accs(acc, secret + kXxh3SecretMergeAccsStart, len * kXxhPrime64_1);
+}
+
+ATFW_UTIL_FORCEINLINE static xxh3_hash128_t xxh3_finalize_long_128(const uint64_t *acc, const unsigned char *secret,
+                                                                   uint64_t len) noexcept {
+  xxh3_hash128_t ret;
+  ret.low64 = xxh3_merge_accs(acc, secret + kXxh3SecretMergeAccsStart, len * kXxhPrime64_1);
+  const size_t high_secret_offset =
+      xxh3_state::SECRET_SIZE - sizeof(uint64_t) * xxh3_state::ACCUMULATOR_COUNT - kXxh3SecretMergeAccsStart;
+  ret.high64 = xxh3_merge_accs(acc, secret + high_secret_offset, ~(len * kXxhPrime64_2));
+  return ret;
+}
+
+/**
+ * @brief 处理若干完整的条带，跨过块边界时打乱累加器
+ * @return 输入结束位置
+ */
+static const unsigned char *xxh3_consume_stripes(uint64_t *acc, size_t &stripes_so_far, const unsigned char *input,
+                                                 size_t stripes, const unsigned char *secret) noexcept {
+  while (stripes > 0) {
+    size_t stripes_this_block = kXxh3StripesPerBlock - stripes_so_far;
+    if (stripes < stripes_this_block) {
+      xxh3_accumulate(acc, input, secret + stripes_so_far * kXxh3SecretConsumeRate, stripes);
+      stripes_so_far += stripes;
+      return input + stripes * kXxh3StripeLen;
+    }
+
+    xxh3_accumulate(acc, input, secret + stripes_so_far * kXxh3SecretConsumeRate, stripes_this_block);
+    xxh3_scramble(acc, secret + kXxh3SecretLimit);
+    stripes_so_far = 0;
+    input += stripes_this_block * kXxh3StripeLen;
+    stripes -= stripes_this_block;
+  }
+  return input;
+}
+}  // namespace
+
+ATFRAMEWORK_UTILS_API uint64_t xxh3_64(const void *data, size_t len, uint64_t seed) noexcept {
+  const unsigned char *input = reinterpret_cast<const unsigned char *>(data);
+  if (len <= 16) {
+    return xxh3_len_0to16_64(input, len, kXxh3Secret, seed);
+  }
+  if (len <= 128) {
+    return xxh3_len_17to128_64(input, len, kXxh3Secret, seed);
+  }
+  if (len <= kXxh3MidSizeMax) {
+    return xxh3_len_129to240_64(input, len, kXxh3Secret, seed);
+  }
+
+  uint64_t acc[xxh3_state::ACCUMULATOR_COUNT];
+  if (0 == seed) {
+    xxh3_hash_long(acc, input, len, kXxh3Secret);
+    return xxh3_finalize_long_64(acc, kXxh3Secret, len);
+  }
+
+  unsigned char secret[xxh3_state::SECRET_SIZE];
+  xxh3_init_secret(secret, seed);
+  xxh3_hash_long(acc, input, len, secret);
+  return xxh3_finalize_long_64(acc, secret, len);
+}
+
+ATFRAMEWORK_UTILS_API xxh3_hash128_t xxh3_128(const void *data, size_t len, uint64_t seed) noexcept {
+  const unsigned char *input = reinterpret_cast<const unsigned char *>(data);
+  if (len <= 16) {
+    return xxh3_len_0to16_128(input, len, kXxh3Secret, seed);
+  }
+  if (len <= 128) {
+    return xxh3_len_17to128_128(input, len, kXxh3Secret, seed);
+  }
+  if (len <= kXxh3MidSizeMax) {
+    return xxh3_len_129to240_128(input, len, kXxh3Secret, seed);
+  }
+
+  uint64_t acc[xxh3_state::ACCUMULATOR_COUNT];
+  if (0 == seed) {
+    xxh3_hash_long(acc, input, len, kXxh3Secret);
+    return xxh3_finalize_long_128(acc, kXxh3Secret, len);
+  }
+
+  unsigned char secret[xxh3_state::SECRET_SIZE];
+  xxh3_init_secret(secret, seed);
+  xxh3_hash_long(acc, input, len, secret);
+  return xxh3_finalize_long_128(acc, secret, len);
+}
+
+ATFRAMEWORK_UTILS_API xxh3_state::xxh3_state(uint64_t seed) noexcept { reset(seed); }
+
+ATFRAMEWORK_UTILS_API void xxh3_state::reset(uint64_t seed) noexcept {
+  xxh3_init_acc(acc_);
+  xxh3_init_secret(secret_, seed);
+  buffered_size_ = 0;
+  stripes_so_far_ = 0;
+  total_len_ = 0;
+  seed_ = seed;
+}
+
+ATFRAMEWORK_UTILS_API void xxh3_state::update(const void *data, size_t len) noexcept {
+  if (nullptr == data || 0 == len) {
+    return;
+  }
+
+  const unsigned char *input = reinterpret_cast<const unsigned char *>(data);
+  const unsigned char *end = input + len;
+  total_len_ += len;
+
+  // 数据不足时只缓存，保证缓冲区里至少保留一个字节给 digest 处理最后一个条带
+  if (len <= BUFFER_SIZE - buffered_size_) {
+    memcpy(buffer_ + buffered_size_, input, len);
+    buffered_size_ += len;
+    return;
+  }
+
+  if (buffered_size_ > 0) {
+    size_t load_size = BUFFER_SIZE - buffered_size_;
+    memcpy(buffer_ + buffered_size_, input, load_size);
+    input += load_size;
+    xxh3_consume_stripes(acc_, stripes_so_far_, buffer_, kXxh3BufferStripes, secret_);
+    buffered_size_ = 0;
+  }
+
+  if (static_cast<size_t>(end - input) > BUFFER_SIZE) {
+    size_t stripes = static_cast<size_t>(end - 1 - input) / kXxh3StripeLen;
+    input = xxh3_consume_stripes(acc_, stripes_so_far_, input, stripes, secret_);
+    // 保存最后一个完整条带，剩余数据不足一个条带时 digest 需要用到
+    memcpy(buffer_ + BUFFER_SIZE - kXxh3StripeLen, input - kXxh3StripeLen, kXxh3StripeLen);
+  }
+
+  buffered_size_ = static_cast<size_t>(end - input);
+  memcpy(buffer_, input, buffered_size_);
+}
+
+ATFRAMEWORK_UTILS_API uint64_t xxh3_state::digest64() const noexcept {
+  if (total_len_ > kXxh3MidSizeMax) {
+    uint64_t acc[ACCUMULATOR_COUNT];
+    digest_long(acc);
+    return xxh3_finalize_long_64(acc, secret_, total_len_);
+  }
+
+  return xxh3_64(buffer_, static_cast<size_t>(total_len_), seed_);
+}
+
+ATFRAMEWORK_UTILS_API xxh3_hash128_t xxh3_state::digest128() const noexcept {
+  if (total_len_ > kXxh3MidSizeMax) {
+    uint64_t acc[ACCUMULATOR_COUNT];
+    digest_long(acc);
+    return xxh3_finalize_long_128(acc, secret_, total_len_);
+  }
+
+  return xxh3_128(buffer_, static_cast<size_t>(total_len_), seed_);
+}
+
+void xxh3_state::digest_long(uint64_t *acc) const noexcept {
+  unsigned char last_stripe[kXxh3StripeLen];
+  const unsigned char *last_stripe_ptr;
+  memcpy(acc, acc_, sizeof(acc_));
+
+  if (buffered_size_ >= kXxh3StripeLen) {
+    size_t stripes = (buffered_size_ - 1) / kXxh3StripeLen;
+    size_t stripes_so_far = stripes_so_far_;
+    xxh3_consume_stripes(acc, stripes_so_far, buffer_, stripes, secret_);
+    last_stripe_ptr = buffer_ + buffered_size_ - kXxh3StripeLen;
+  } else {
+    // 最后一个条带的前半部分来自上一次处理的数据
+    size_t catchup_size = kXxh3StripeLen - buffered_size_;
+    memcpy(last_stripe, buffer_ + BUFFER_SIZE - catchup_size, catchup_size);
+    memcpy(last_stripe + catchup_size, buffer_, buffered_size_);
+    last_stripe_ptr = last_stripe;
+  }
+
+  xxh3_accumulate_stripe(acc, last_stripe_ptr, secret_ + kXxh3SecretLimit - kXxh3SecretLastAccStart);
+}
+
+}  // namespace hash
+ATFRAMEWORK_UTILS_NAMESPACE_END
@@ -3,16 +3,24 @@
 // Namespace/API macros are provided by the public header and intentionally used through it here.
 // NOLINTBEGIN(misc-include-cleaner)
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <limits>
+#include <vector>
 
 #include "config/compile_optimize.h"
 
 #include "algorithm/xxtea.h"
 
+#include "common/cpu_features.h"
+
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+#  include <immintrin.h>
+#endif
+
 #define XXTEA_DELTA 0x9e3779b9
 #define XXTEA_MX (((z >> 5 ^ y << 2) + (y >> 3 ^ z << 4)) ^ ((sum ^ y) + (key->data[(p & 3) ^ e] ^ z)))
 /*
@@ -53,6 +61,243 @@ template <typename Ty>
 struct ATFW_UTIL_SYMBOL_LOCAL xxtea_check_length_delegate {
   static constexpr const bool value = sizeof(Ty) > sizeof(uint32_t);
 };
+
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+// ================ SIMD ================
+// 多个长度相同的buffer按 [word][lane] 交错存放，每个lane独立计算，结果和标量实现完全一致
+ATFW_UTIL_FORCEINLINE ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("sse2") static __m128i xxtea_simd_mx_sse2(
+    __m128i z, __m128i y, __m128i sum, __m128i k) {
+  __m128i l = _mm_add_epi32(_mm_xor_si128(_mm_srli_epi32(z, 5), _mm_slli_epi32(y, 2)),
+                            _mm_xor_si128(_mm_srli_epi32(y, 3), _mm_slli_epi32(z, 4)));
+  __m128i r = _mm_add_epi32(_mm_xor_si128(sum, y), _mm_xor_si128(k, z));
+  return _mm_xor_si128(l, r);
+}
+
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("sse2")
+static void xxtea_encrypt_lanes_sse2(const xxtea_key *key, uint32_t *w, uint32_t n) {
+  const size_t lanes = 4;
+  uint32_t rounds = 6 + (52 / n);
+  uint32_t sum = 0;
+  __m128i z = _mm_loadu_si128(reinterpret_cast<const __m128i *>(w + (n - 1) * lanes));
+  do {
+    sum += XXTEA_DELTA;
+    uint32_t e = (sum >> 2) & 3;
+    __m128i vsum = _mm_set1_epi32(static_cast<int>(sum));
+    __m128i k[4];
+    for (uint32_t i = 0; i < 4; ++i) {
+      k[i] = _mm_set1_epi32(static_cast<int>(key->data[i ^ e]));
+    }
+
+    __m128i y;
+    uint32_t p = 0;
+    for (; p < n - 1; ++p) {
+      y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(w + (p + 1) * lanes));
+      __m128i *v = reinterpret_cast<__m128i *>(w + p * lanes);
+      z = _mm_add_epi32(_mm_loadu_si128(v), xxtea_simd_mx_sse2(z, y, vsum, k[p & 3]));
+      _mm_storeu_si128(v, z);
+    }
+    y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(w));
+    __m128i *v = reinterpret_cast<__m128i *>(w + p * lanes);
+    z = _mm_add_epi32(_mm_loadu_si128(v), xxtea_simd_mx_sse2(z, y, vsum, k[p & 3]));
+    _mm_storeu_si128(v, z);
+  } while (--rounds);
+}
+
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("sse2")
+static void xxtea_decrypt_lanes_sse2(const xxtea_key *key, uint32_t *w, uint32_t n) {
+  const size_t lanes = 4;
+  uint32_t rounds = 6 + (52 / n);
+  uint32_t sum = rounds * XXTEA_DELTA;
+  __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(w));
+  do {
+    uint32_t e = (sum >> 2) & 3;
+    __m128i vsum = _mm_set1_epi32(static_cast<int>(sum));
+    __m128i k[4];
+    for (uint32_t i = 0; i < 4; ++i) {
+      k[i] = _mm_set1_epi32(static_cast<int>(key->data[i ^ e]));
+    }
+
+    __m128i z;
+    for (uint32_t p = n - 1; p > 0; --p) {
+      z = _mm_loadu_si128(reinterpret_cast<const __m128i *>(w + (p - 1) * lanes));
+      __m128i *v = reinterpret_cast<__m128i *>(w + p * lanes);
+      y = _mm_sub_epi32(_mm_loadu_si128(v), xxtea_simd_mx_sse2(z, y, vsum, k[p & 3]));
+      _mm_storeu_si128(v, y);
+    }
+    z = _mm_loadu_si128(reinterpret_cast<const __m128i *>(w + (n - 1) * lanes));
+    __m128i *v = reinterpret_cast<__m128i *>(w);
+    y = _mm_sub_epi32(_mm_loadu_si128(v), xxtea_simd_mx_sse2(z, y, vsum, k[0]));
+    _mm_storeu_si128(v, y);
+    sum -= XXTEA_DELTA;
+  } while (--rounds);
+}
+
+ATFW_UTIL_FORCEINLINE ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("avx2") static __m256i xxtea_simd_mx_avx2(
+    __m256i z, __m256i y, __m256i sum, __m256i k) {
+  __m256i l = _mm256_add_epi32(_mm256_xor_si256(_mm256_srli_epi32(z, 5), _mm256_slli_epi32(y, 2)),
+                               _mm256_xor_si256(_mm256_srli_epi32(y, 3), _mm256_slli_epi32(z, 4)));
+  __m256i r = _mm256_add_epi32(_mm256_xor_si256(sum, y), _mm256_xor_si256(k, z));
+  return _mm256_xor_si256(l, r);
+}
+
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("avx2")
+static void xxtea_encrypt_lanes_avx2(const xxtea_key *key, uint32_t *w, uint32_t n) {
+  const size_t lanes = 8;
+  uint32_t rounds = 6 + (52 / n);
+  uint32_t sum = 0;
+  __m256i z = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(w + (n - 1) * lanes));
+  do {
+    sum += XXTEA_DELTA;
+    uint32_t e = (sum >> 2) & 3;
+    __m256i vsum = _mm256_set1_epi32(static_cast<int>(sum));
+    __m256i k[4];
+    for (uint32_t i = 0; i < 4; ++i) {
+      k[i] = _mm256_set1_epi32(static_cast<int>(key->data[i ^ e]));
+    }
+
+    __m256i y;
+    uint32_t p = 0;
+    for (; p < n - 1; ++p) {
+      y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(w + (p + 1) * lanes));
+      __m256i *v = reinterpret_cast<__m256i *>(w + p * lanes);
+      z = _mm256_add_epi32(_mm256_loadu_si256(v), xxtea_simd_mx_avx2(z, y, vsum, k[p & 3]));
+      _mm256_storeu_si256(v, z);
+    }
+    y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(w));
+    __m256i *v = reinterpret_cast<__m256i *>(w + p * lanes);
+    z = _mm256_add_epi32(_mm256_loadu_si256(v), xxtea_simd_mx_avx2(z, y, vsum, k[p & 3]));
+    _mm256_storeu_si256(v, z);
+  } while (--rounds);
+}
+
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("avx2")
+static void xxtea_decrypt_lanes_avx2(const xxtea_key *key, uint32_t *w, uint32_t n) {
+  const size_t lanes = 8;
+  uint32_t rounds = 6 + (52 / n);
+  uint32_t sum = rounds * XXTEA_DELTA;
+  __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(w));
+  do {
+    uint32_t e = (sum >> 2) & 3;
+    __m256i vsum = _mm256_set1_epi32(static_cast<int>(sum));
+    __m256i k[4];
+    for (uint32_t i = 0; i < 4; ++i) {
+      k[i] = _mm256_set1_epi32(static_cast<int>(key->data[i ^ e]));
+    }
+
+    __m256i z;
+    for (uint32_t p = n - 1; p > 0; --p) {
+      z = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(w + (p - 1) * lanes));
+      __m256i *v = reinterpret_cast<__m256i *>(w + p * lanes);
+      y = _mm256_sub_epi32(_mm256_loadu_si256(v), xxtea_simd_mx_avx2(z, y, vsum, k[p & 3]));
+      _mm256_storeu_si256(v, y);
+    }
+    z = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(w + (n - 1) * lanes));
+    __m256i *v = reinterpret_cast<__m256i *>(w);
+    y = _mm256_sub_epi32(_mm256_loadu_si256(v), xxtea_simd_mx_avx2(z, y, vsum, k[0]));
+    _mm256_storeu_si256(v, y);
+    sum -= XXTEA_DELTA;
+  } while (--rounds);
+}
+
+using xxtea_lanes_fn_t = void (*)(const xxtea_key *, uint32_t *, uint32_t);
+#endif
+
+static void xxtea_check_multi_lengths(const size_t *lens, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    if (lens[i] & 0x03) {
+      std::abort();
+    }
+
+    if (xxtea_check_length<xxtea_check_length_delegate<size_t>::value>::check_protect(lens[i])) {
+      std::abort();
+    }
+  }
+}
+
+static void xxtea_process_multi(const xxtea_key *key, void *const *buffers, const size_t *lens, size_t count,
+                                bool is_encrypt) {
+  if (nullptr == key || nullptr == buffers || nullptr == lens || 0 == count) {
+    return;
+  }
+
+  xxtea_check_multi_lengths(lens, count);
+
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+  const platform::cpu_features &features = platform::get_cpu_features();
+  if (count > 1 && features.has_sse2) {
+    // 按长度分组，长度相同的buffer才能放在同一组lane里
+    std::vector<size_t> order;
+    order.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+      if (nullptr != buffers[i] && 0 != lens[i]) {
+        order.push_back(i);
+      }
+    }
+    std::stable_sort(order.begin(), order.end(), [lens](size_t l, size_t r) { return lens[l] < lens[r]; });
+
+    std::vector<uint32_t> lanes_buffer;
+    size_t group_begin = 0;
+    while (group_begin < order.size()) {
+      size_t group_end = group_begin + 1;
+      const size_t len = lens[order[group_begin]];
+      while (group_end < order.size() && lens[order[group_end]] == len) {
+        ++group_end;
+      }
+
+      const uint32_t n = static_cast<uint32_t>(len >> 2);
+      while (group_begin < group_end) {
+        const size_t left = group_end - group_begin;
+        if (1 == left) {
+          if (is_encrypt) {
+            ATFRAMEWORK_UTILS_NAMESPACE_ID::xxtea_encrypt(key, buffers[order[group_begin]], len);
+          } else {
+            ATFRAMEWORK_UTILS_NAMESPACE_ID::xxtea_decrypt(key, buffers[order[group_begin]], len);
+          }
+          ++group_begin;
+          continue;
+        }
+
+        size_t lanes = 4;
+        xxtea_lanes_fn_t fn = is_encrypt ? xxtea_encrypt_lanes_sse2 : xxtea_decrypt_lanes_sse2;
+        if (features.has_avx2 && left > 4) {
+          lanes = 8;
+          fn = is_encrypt ? xxtea_encrypt_lanes_avx2 : xxtea_decrypt_lanes_avx2;
+        }
+        const size_t used_lanes = left < lanes ? left : lanes;
+
+        // 未使用的lane填0，计算后丢弃
+        lanes_buffer.assign(static_cast<size_t>(n) * lanes, 0);
+        for (size_t l = 0; l < used_lanes; ++l) {
+          const uint32_t *v = reinterpret_cast<const uint32_t *>(buffers[order[group_begin + l]]);
+          for (uint32_t p = 0; p < n; ++p) {
+            lanes_buffer[p * lanes + l] = v[p];
+          }
+        }
+
+        fn(key, lanes_buffer.data(), n);
+
+        for (size_t l = 0; l < used_lanes; ++l) {
+          uint32_t *v = reinterpret_cast<uint32_t *>(buffers[order[group_begin + l]]);
+          for (uint32_t p = 0; p < n; ++p) {
+            v[p] = lanes_buffer[p * lanes + l];
+          }
+        }
+
+        group_begin += used_lanes;
+      }
+    }
+    return;
+  }
+#endif
+
+  for (size_t i = 0; i < count; ++i) {
+    if (is_encrypt) {
+      ATFRAMEWORK_UTILS_NAMESPACE_ID::xxtea_encrypt(key, buffers[i], lens[i]);
+    } else {
+      ATFRAMEWORK_UTILS_NAMESPACE_ID::xxtea_decrypt(key, buffers[i], lens[i]);
+    }
+  }
+}
 }  // namespace
 
 ATFRAMEWORK_UTILS_API void xxtea_setup(xxtea_key *k, const unsigned char filled[4 * sizeof(uint32_t)]) {
@@ -196,6 +441,16 @@ ATFRAMEWORK_UTILS_API void xxtea_decrypt(const xxtea_key *key, const void *input
     *olen = 0;
   }
 }
+
+ATFRAMEWORK_UTILS_API void xxtea_encrypt_multi(const xxtea_key *key, void *const *buffers, const size_t *lens,
+                                               size_t count) {
+  xxtea_process_multi(key, buffers, lens, count, true);
+}
+
+ATFRAMEWORK_UTILS_API void xxtea_decrypt_multi(const xxtea_key *key, void *const *buffers, const size_t *lens,
+                                               size_t count) {
+  xxtea_process_multi(key, buffers, lens, count, false);
+}
 ATFRAMEWORK_UTILS_NAMESPACE_END
 
 // NOLINTEND(misc-include-cleaner)
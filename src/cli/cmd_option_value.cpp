@@ -72,15 +72,12 @@ ATFRAMEWORK_UTILS_API int64_t cmd_option_value::to_int64() const { return to<int
 ATFRAMEWORK_UTILS_API uint64_t cmd_option_value::to_uint64() const { return to<uint64_t>(); }
 
 ATFRAMEWORK_UTILS_API bool cmd_option_value::to_logic_bool() const {
-  std::string lowercase_content = data_;
-  std::transform(lowercase_content.begin(), lowercase_content.end(), lowercase_content.begin(), string::tolower<char>);
-
-  if (lowercase_content.empty()) {
+  if (data_.empty()) {
     return false;
   }
 
-  if ("no" == lowercase_content || "false" == lowercase_content || "disabled" == lowercase_content ||
-      "disable" == lowercase_content || "0" == lowercase_content) {
+  if (string::ascii_iequals(data_, "no") || string::ascii_iequals(data_, "false") ||
+      string::ascii_iequals(data_, "disabled") || string::ascii_iequals(data_, "disable") || "0" == data_) {
     return false;
   }
 
@@ -0,0 +1,98 @@
+// Copyright 2026 atframework
+
+#include "common/cpu_features.h"
+
+#include <cstring>
+
+#if defined(ATFW_UTIL_MACRO_ARCH_X86)
+#  if defined(_MSC_VER)
+#    include <intrin.h>
+#  elif defined(__GNUC__) || defined(__clang__)
+#    include <cpuid.h>
+#  endif
+#endif
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace platform {
+
+namespace {
+#if defined(ATFW_UTIL_MACRO_ARCH_X86) && (defined(_MSC_VER) || defined(__GNUC__) || defined(__clang__))
+static void cpu_features_cpuid(uint32_t leaf, uint32_t subleaf, uint32_t out[4]) noexcept {
+#  if defined(_MSC_VER)
+  int regs[4];
+  __cpuidex(regs, static_cast<int>(leaf), static_cast<int>(subleaf));
+  for (int i = 0; i < 4; ++i) {
+    out[i] = static_cast<uint32_t>(regs[i]);
+  }
+#  else
+  unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+  __cpuid_count(leaf, subleaf, eax, ebx, ecx, edx);
+  out[0] = eax;
+  out[1] = ebx;
+  out[2] = ecx;
+  out[3] = edx;
+#  endif
+}
+
+static uint64_t cpu_features_xgetbv() noexcept {
+#  if defined(_MSC_VER)
+  return static_cast<uint64_t>(_xgetbv(0));
+#  else
+  uint32_t eax = 0, edx = 0;
+  __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return (static_cast<uint64_t>(edx) << 32) | eax;
+#  endif
+}
+
+static cpu_features detect_cpu_features() noexcept {
+  cpu_features ret;
+  memset(&ret, 0, sizeof(ret));
+
+  uint32_t regs[4] = {0, 0, 0, 0};
+  cpu_features_cpuid(0, 0, regs);
+  uint32_t max_leaf = regs[0];
+  if (max_leaf < 1) {
+    return ret;
+  }
+
+  cpu_features_cpuid(1, 0, regs);
+  ret.has_sse2 = !!(regs[3] & (1u << 26));
+  ret.has_ssse3 = !!(regs[2] & (1u << 9));
+  ret.has_sse41 = !!(regs[2] & (1u << 19));
+  ret.has_sse42 = !!(regs[2] & (1u << 20));
+  ret.has_pclmulqdq = !!(regs[2] & (1u << 1));
+  ret.has_aesni = !!(regs[2] & (1u << 25));
+  ret.has_popcnt = !!(regs[2] & (1u << 23));
+
+  // 操作系统需要开启 XSAVE 并保存 XMM/YMM 状态
+  bool os_avx = false;
+  if ((regs[2] & (1u << 27)) && (regs[2] & (1u << 28))) {
+    os_avx = (cpu_features_xgetbv() & 0x06) == 0x06;
+  }
+  ret.has_avx = os_avx;
+
+  if (max_leaf >= 7) {
+    cpu_features_cpuid(7, 0, regs);
+    ret.has_avx2 = os_avx && !!(regs[1] & (1u << 5));
+    ret.has_bmi1 = !!(regs[1] & (1u << 3));
+    ret.has_bmi2 = !!(regs[1] & (1u << 8));
+  }
+
+  return ret;
+}
+#else
+static cpu_features detect_cpu_features() noexcept {
+  cpu_features ret;
+  memset(&ret, 0, sizeof(ret));
+  return ret;
+}
+#endif
+}  // namespace
+
+ATFRAMEWORK_UTILS_API const cpu_features& get_cpu_features() noexcept {
+  static cpu_features ret = detect_cpu_features();
+  return ret;
+}
+
+}  // namespace platform
+ATFRAMEWORK_UTILS_NAMESPACE_END
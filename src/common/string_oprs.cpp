@@ -1,10 +1,563 @@
 // Copyright 2026 atframework
 
 #include <common/string_oprs.h>
+
+#include <common/cpu_features.h>
+
+#include <cstdio>
 #include <sstream>
 
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+#  include <immintrin.h>
+#endif
+
+#if (defined(__cplusplus) && __cplusplus >= 201703L) || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#  if defined(__has_include)
+#    if __has_include(<charconv>)
+#      include <charconv>
+#    endif
+#  endif
+#endif
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#  define ATFW_UTIL_STRING_OPRS_FLOAT_CHARCONV 1
+#endif
+
 ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
 namespace string {
+namespace {
+static inline double _strtof(const char *str, char **end, double *) { return strtod(str, end); }
+
+static inline float _strtof(const char *str, char **end, float *) { return strtof(str, end); }
+
+template <class T>
+static size_t _float2str(char *str, size_t strsz, T in) noexcept {
+  if (nullptr == str || 0 == strsz) {
+    return 0;
+  }
+
+#if defined(ATFW_UTIL_STRING_OPRS_FLOAT_CHARCONV)
+  std::to_chars_result res = std::to_chars(str, str + strsz, in);
+  if (res.ec != std::errc()) {
+    return 0;
+  }
+  size_t ret = static_cast<size_t>(res.ptr - str);
+#else
+  char buffer[64];
+  int len = 0;
+  for (int precision = std::numeric_limits<T>::digits10; precision <= std::numeric_limits<T>::max_digits10;
+       ++precision) {
+    len = UTIL_STRFUNC_SNPRINTF(buffer, sizeof(buffer), "%.*g", precision, static_cast<double>(in));
+    if (len <= 0 || static_cast<size_t>(len) >= sizeof(buffer)) {
+      return 0;
+    }
+    if (_strtof(buffer, nullptr, static_cast<T *>(nullptr)) == in) {
+      break;
+    }
+  }
+
+  size_t ret = static_cast<size_t>(len);
+  if (ret > strsz) {
+    return 0;
+  }
+  memcpy(str, buffer, ret);
+#endif
+
+  if (ret < strsz) {
+    str[ret] = 0;
+  }
+  return ret;
+}
+
+template <class T>
+static const char *_str2float(T &out, const char *str, size_t strsz) noexcept {
+  out = static_cast<T>(0);
+  if (nullptr == str) {
+    return str;
+  }
+
+  if (0 == strsz) {
+    strsz = strlen(str);
+  }
+  const char *begin = str;
+  const char *end = str + strsz;
+  while (begin < end && is_space(*begin)) {
+    ++begin;
+  }
+  // std::from_chars 不接受正号
+  if (begin + 1 < end && '+' == *begin && '-' != begin[1]) {
+    ++begin;
+  }
+
+#if defined(ATFW_UTIL_STRING_OPRS_FLOAT_CHARCONV)
+  T value = static_cast<T>(0);
+  std::from_chars_result res = std::from_chars(begin, end, value);
+  if (res.ec == std::errc()) {
+    out = value;
+    return res.ptr;
+  }
+  if (res.ec != std::errc::result_out_of_range) {
+    return str;
+  }
+  // 超出范围时和 strtod 一样输出0或者无穷大，所以走下面的分支
+#endif
+
+  char buffer[128];
+  size_t len = static_cast<size_t>(end - begin);
+  if (len >= sizeof(buffer)) {
+    len = sizeof(buffer) - 1;
+  }
+  memcpy(buffer, begin, len);
+  buffer[len] = 0;
+
+  char *parse_end = nullptr;
+  T parsed = _strtof(buffer, &parse_end, static_cast<T *>(nullptr));
+  if (parse_end == buffer) {
+    return str;
+  }
+  out = parsed;
+  return begin + (parse_end - buffer);
+}
+
+// ============ ASCII大小写和切分 - 标量实现 ============
+
+static inline unsigned char _ascii_tolower(unsigned char c) noexcept {
+  return static_cast<unsigned char>(static_cast<unsigned char>(c - 'A') < 26 ? (c | 0x20) : c);
+}
+
+static inline unsigned char _ascii_toupper(unsigned char c) noexcept {
+  return static_cast<unsigned char>(static_cast<unsigned char>(c - 'a') < 26 ? (c & 0xDF) : c);
+}
+
+static void _ascii_tolower_scalar(char *out, const char *in, size_t from, size_t sz) noexcept {
+  for (size_t i = from; i < sz; ++i) {
+    out[i] = static_cast<char>(_ascii_tolower(static_cast<unsigned char>(in[i])));
+  }
+}
+
+static void _ascii_toupper_scalar(char *out, const char *in, size_t from, size_t sz) noexcept {
+  for (size_t i = from; i < sz; ++i) {
+    out[i] = static_cast<char>(_ascii_toupper(static_cast<unsigned char>(in[i])));
+  }
+}
+
+static bool _ascii_iequals_scalar(const char *l, const char *r, size_t sz) noexcept {
+  for (size_t i = 0; i < sz; ++i) {
+    if (_ascii_tolower(static_cast<unsigned char>(l[i])) != _ascii_tolower(static_cast<unsigned char>(r[i]))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// 调用者保证 nsz > 0
+static size_t _ascii_ifind_scalar(const char *h, size_t from, size_t hsz, const char *n, size_t nsz) noexcept {
+  unsigned char first = _ascii_tolower(static_cast<unsigned char>(n[0]));
+  for (size_t i = from; i + nsz <= hsz; ++i) {
+    if (_ascii_tolower(static_cast<unsigned char>(h[i])) == first && _ascii_iequals_scalar(h + i + 1, n + 1, nsz - 1)) {
+      return i;
+    }
+  }
+  return nostd::string_view::npos;
+}
+
+struct _split_context_t {
+  const char *input;
+  nostd::string_view *output;
+  size_t output_size;
+  size_t count;
+  size_t token_begin;
+  bool skip_empty;
+};
+
+static inline void _split_emit(_split_context_t &ctx, size_t end) noexcept {
+  if (!ctx.skip_empty || end > ctx.token_begin) {
+    if (ctx.count < ctx.output_size) {
+      ctx.output[ctx.count] = nostd::string_view(ctx.input + ctx.token_begin, end - ctx.token_begin);
+    }
+    ++ctx.count;
+  }
+  ctx.token_begin = end + 1;
+}
+
+static void _split_scalar(_split_context_t &ctx, size_t from, size_t sz, const bool *delimiter_table) noexcept {
+  const unsigned char *s = reinterpret_cast<const unsigned char *>(ctx.input);
+  for (size_t i = from; i < sz; ++i) {
+    if (delimiter_table[s[i]]) {
+      _split_emit(ctx, i);
+    }
+  }
+}
+
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+// ============ ASCII大小写和切分 - SSE2/AVX2 实现 ============
+
+// [first, first + 26) 平移到 [-128, -102)，一次有符号比较就能得到字母的掩码，字母位置输出0x20
+ATFW_UTIL_FORCEINLINE ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("sse2") static __m128i _ascii_case_mask_sse2(
+    __m128i v, char first) noexcept {
+  __m128i shifted = _mm_sub_epi8(v, _mm_set1_epi8(static_cast<char>(first - 128)));
+  return _mm_and_si128(_mm_cmplt_epi8(shifted, _mm_set1_epi8(-128 + 26)), _mm_set1_epi8(0x20));
+}
+
+ATFW_UTIL_FORCEINLINE ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("sse2") static __m128i _ascii_fold_sse2(
+    const char *s) noexcept {
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s));
+  return _mm_or_si128(v, _ascii_case_mask_sse2(v, 'A'));
+}
+
+ATFW_UTIL_FORCEINLINE ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("avx2") static __m256i _ascii_case_mask_avx2(
+    __m256i v, char first) noexcept {
+  __m256i shifted = _mm256_sub_epi8(v, _mm256_set1_epi8(static_cast<char>(first - 128)));
+  return _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(-128 + 26), shifted), _mm256_set1_epi8(0x20));
+}
+
+ATFW_UTIL_FORCEINLINE ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("avx2") static __m256i _ascii_fold_avx2(
+    const char *s) noexcept {
+  __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s));
+  return _mm256_or_si256(v, _ascii_case_mask_avx2(v, 'A'));
+}
+
+// 末尾不足一个块时和前一个块重叠处理，大小写转换是幂等的，重复处理不影响结果
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("sse2")
+static void _ascii_tolower_sse2(char *out, const char *in, size_t sz) noexcept {
+  if (sz < 16) {
+    _ascii_tolower_scalar(out, in, 0, sz);
+    return;
+  }
+  for (size_t i = 0; i + 16 <= sz; i += 16) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _ascii_fold_sse2(in + i));
+  }
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(out + sz - 16), _ascii_fold_sse2(in + sz - 16));
+}
+
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("avx2")
+static void _ascii_tolower_avx2(char *out, const char *in, size_t sz) noexcept {
+  if (sz < 32) {
+    _ascii_tolower_sse2(out, in, sz);
+    return;
+  }
+  for (size_t i = 0; i + 32 <= sz; i += 32) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), _ascii_fold_avx2(in + i));
+  }
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + sz - 32), _ascii_fold_avx2(in + sz - 32));
+}
+
+ATFW_UTIL_FORCEINLINE ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("sse2") static void _ascii_toupper_block_sse2(
+    char *out, const char *in) noexcept {
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_xor_si128(v, _ascii_case_mask_sse2(v, 'a')));
+}
+
+ATFW_UTIL_FORCEINLINE ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("avx2") static void _ascii_toupper_block_avx2(
+    char *out, const char *in) noexcept {
+  __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in));
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), _mm256_xor_si256(v, _ascii_case_mask_avx2(v, 'a')));
+}
+
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("sse2")
+static void _ascii_toupper_sse2(char *out, const char *in, size_t sz) noexcept {
+  if (sz < 16) {
+    _ascii_toupper_scalar(out, in, 0, sz);
+    return;
+  }
+  for (size_t i = 0; i + 16 <= sz; i += 16) {
+    _ascii_toupper_block_sse2(out + i, in + i);
+  }
+  _ascii_toupper_block_sse2(out + sz - 16, in + sz - 16);
+}
+
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("avx2")
+static void _ascii_toupper_avx2(char *out, const char *in, size_t sz) noexcept {
+  if (sz < 32) {
+    _ascii_toupper_sse2(out, in, sz);
+    return;
+  }
+  for (size_t i = 0; i + 32 <= sz; i += 32) {
+    _ascii_toupper_block_avx2(out + i, in + i);
+  }
+  _ascii_toupper_block_avx2(out + sz - 32, in + sz - 32);
+}
+
+ATFW_UTIL_FORCEINLINE ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("sse2") static bool _ascii_iequals_block_sse2(
+    const char *l, const char *r) noexcept {
+  return 0xFFFF == _mm_movemask_epi8(_mm_cmpeq_epi8(_ascii_fold_sse2(l), _ascii_fold_sse2(r)));
+}
+
+ATFW_UTIL_FORCEINLINE ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("avx2") static bool _ascii_iequals_block_avx2(
+    const char *l, const char *r) noexcept {
+  return -1 == _mm256_movemask_epi8(_mm256_cmpeq_epi8(_ascii_fold_avx2(l), _ascii_fold_avx2(r)));
+}
+
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("sse2")
+static bool _ascii_iequals_sse2(const char *l, const char *r, size_t sz) noexcept {
+  if (sz < 16) {
+    return _ascii_iequals_scalar(l, r, sz);
+  }
+  for (size_t i = 0; i + 16 <= sz; i += 16) {
+    if (!_ascii_iequals_block_sse2(l + i, r + i)) {
+      return false;
+    }
+  }
+  return _ascii_iequals_block_sse2(l + sz - 16, r + sz - 16);
+}
+
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("avx2")
+static bool _ascii_iequals_avx2(const char *l, const char *r, size_t sz) noexcept {
+  if (sz < 32) {
+    return _ascii_iequals_sse2(l, r, sz);
+  }
+  for (size_t i = 0; i + 32 <= sz; i += 32) {
+    if (!_ascii_iequals_block_avx2(l + i, r + i)) {
+      return false;
+    }
+  }
+  return _ascii_iequals_block_avx2(l + sz - 32, r + sz - 32);
+}
+
+// 同时比较子串的首字符和尾字符，两个都匹配的位置才需要比较中间部分
+ATFW_UTIL_FORCEINLINE ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("sse2") static size_t _ascii_ifind_block_sse2(
+    const char *h, size_t i, const char *n, size_t nsz, __m128i first, __m128i last) noexcept {
+  __m128i match = _mm_and_si128(_mm_cmpeq_epi8(_ascii_fold_sse2(h + i), first),
+                                _mm_cmpeq_epi8(_ascii_fold_sse2(h + i + nsz - 1), last));
+  uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(match));
+  while (0 != mask) {
+    size_t offset = i + static_cast<size_t>(bit::countr_zero(mask));
+    if (nsz <= 2 || _ascii_iequals_sse2(h + offset + 1, n + 1, nsz - 2)) {
+      return offset;
+    }
+    mask &= mask - 1;
+  }
+  return nostd::string_view::npos;
+}
+
+ATFW_UTIL_FORCEINLINE ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("avx2") static size_t _ascii_ifind_block_avx2(
+    const char *h, size_t i, const char *n, size_t nsz, __m256i first, __m256i last) noexcept {
+  __m256i match = _mm256_and_si256(_mm256_cmpeq_epi8(_ascii_fold_avx2(h + i), first),
+                                   _mm256_cmpeq_epi8(_ascii_fold_avx2(h + i + nsz - 1), last));
+  uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(match));
+  while (0 != mask) {
+    size_t offset = i + static_cast<size_t>(bit::countr_zero(mask));
+    if (nsz <= 2 || _ascii_iequals_avx2(h + offset + 1, n + 1, nsz - 2)) {
+      return offset;
+    }
+    mask &= mask - 1;
+  }
+  return nostd::string_view::npos;
+}
+
+// 调用者保证 from + nsz <= hsz，末尾的块和前一个块重叠时，重叠部分已经确认不匹配，所以找到的仍然是第一个匹配位置
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("sse2")
+static size_t _ascii_ifind_sse2(const char *h, size_t from, size_t hsz, const char *n, size_t nsz) noexcept {
+  __m128i first = _mm_set1_epi8(static_cast<char>(_ascii_tolower(static_cast<unsigned char>(n[0]))));
+  __m128i last = _mm_set1_epi8(static_cast<char>(_ascii_tolower(static_cast<unsigned char>(n[nsz - 1]))));
+  size_t end = hsz - nsz + 1;
+  size_t i = from;
+  for (; i + 16 <= end; i += 16) {
+    size_t ret = _ascii_ifind_block_sse2(h, i, n, nsz, first, last);
+    if (nostd::string_view::npos != ret) {
+      return ret;
+    }
+  }
+  if (i < end && end >= from + 16) {
+    return _ascii_ifind_block_sse2(h, end - 16, n, nsz, first, last);
+  }
+  return _ascii_ifind_scalar(h, i, hsz, n, nsz);
+}
+
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("avx2")
+static size_t _ascii_ifind_avx2(const char *h, size_t from, size_t hsz, const char *n, size_t nsz) noexcept {
+  __m256i first = _mm256_set1_epi8(static_cast<char>(_ascii_tolower(static_cast<unsigned char>(n[0]))));
+  __m256i last = _mm256_set1_epi8(static_cast<char>(_ascii_tolower(static_cast<unsigned char>(n[nsz - 1]))));
+  size_t end = hsz - nsz + 1;
+  size_t i = from;
+  for (; i + 32 <= end; i += 32) {
+    size_t ret = _ascii_ifind_block_avx2(h, i, n, nsz, first, last);
+    if (nostd::string_view::npos != ret) {
+      return ret;
+    }
+  }
+  if (i < end && end >= from + 32) {
+    return _ascii_ifind_block_avx2(h, end - 32, n, nsz, first, last);
+  }
+  return _ascii_ifind_sse2(h, i, hsz, n, nsz);
+}
+
+// 每个分隔符比较一次后合并掩码，返回已经处理的长度
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("sse2")
+static size_t _split_sse2(_split_context_t &ctx, size_t sz, const char *delimiters, size_t delimiter_count) noexcept {
+  __m128i delimiter_vectors[16];
+  for (size_t d = 0; d < delimiter_count; ++d) {
+    delimiter_vectors[d] = _mm_set1_epi8(delimiters[d]);
+  }
+
+  size_t i = 0;
+  for (; i + 16 <= sz; i += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ctx.input + i));
+    __m128i hit = _mm_cmpeq_epi8(v, delimiter_vectors[0]);
+    for (size_t d = 1; d < delimiter_count; ++d) {
+      hit = _mm_or_si128(hit, _mm_cmpeq_epi8(v, delimiter_vectors[d]));
+    }
+    uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(hit));
+    while (0 != mask) {
+      _split_emit(ctx, i + static_cast<size_t>(bit::countr_zero(mask)));
+      mask &= mask - 1;
+    }
+  }
+  return i;
+}
+
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("avx2")
+static size_t _split_avx2(_split_context_t &ctx, size_t sz, const char *delimiters, size_t delimiter_count) noexcept {
+  __m256i delimiter_vectors[16];
+  for (size_t d = 0; d < delimiter_count; ++d) {
+    delimiter_vectors[d] = _mm256_set1_epi8(delimiters[d]);
+  }
+
+  size_t i = 0;
+  for (; i + 32 <= sz; i += 32) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ctx.input + i));
+    __m256i hit = _mm256_cmpeq_epi8(v, delimiter_vectors[0]);
+    for (size_t d = 1; d < delimiter_count; ++d) {
+      hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(v, delimiter_vectors[d]));
+    }
+    uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(hit));
+    while (0 != mask) {
+      _split_emit(ctx, i + static_cast<size_t>(bit::countr_zero(mask)));
+      mask &= mask - 1;
+    }
+  }
+  return i;
+}
+#endif
+}  // namespace
+
+ATFRAMEWORK_UTILS_API size_t float2str(char *str, size_t strsz, double in) noexcept {
+  return _float2str(str, strsz, in);
+}
+
+ATFRAMEWORK_UTILS_API size_t float2str(char *str, size_t strsz, float in) noexcept {
+  return _float2str(str, strsz, in);
+}
+
+ATFRAMEWORK_UTILS_API const char *str2float(double &out, const char *str, size_t strsz) noexcept {
+  return _str2float(out, str, strsz);
+}
+
+ATFRAMEWORK_UTILS_API const char *str2float(float &out, const char *str, size_t strsz) noexcept {
+  return _str2float(out, str, strsz);
+}
+
+ATFRAMEWORK_UTILS_API void ascii_tolower(char *out, const char *in, size_t sz) noexcept {
+  if (nullptr == out || nullptr == in) {
+    return;
+  }
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+  static const bool has_avx2 = platform::get_cpu_features().has_avx2;
+  static const bool has_sse2 = platform::get_cpu_features().has_sse2;
+  if (has_avx2) {
+    _ascii_tolower_avx2(out, in, sz);
+    return;
+  }
+  if (has_sse2) {
+    _ascii_tolower_sse2(out, in, sz);
+    return;
+  }
+#endif
+  _ascii_tolower_scalar(out, in, 0, sz);
+}
+
+ATFRAMEWORK_UTILS_API void ascii_toupper(char *out, const char *in, size_t sz) noexcept {
+  if (nullptr == out || nullptr == in) {
+    return;
+  }
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+  static const bool has_avx2 = platform::get_cpu_features().has_avx2;
+  static const bool has_sse2 = platform::get_cpu_features().has_sse2;
+  if (has_avx2) {
+    _ascii_toupper_avx2(out, in, sz);
+    return;
+  }
+  if (has_sse2) {
+    _ascii_toupper_sse2(out, in, sz);
+    return;
+  }
+#endif
+  _ascii_toupper_scalar(out, in, 0, sz);
+}
+
+ATFRAMEWORK_UTILS_API bool ascii_iequals(nostd::string_view l, nostd::string_view r) noexcept {
+  if (l.size() != r.size()) {
+    return false;
+  }
+  if (l.empty() || l.data() == r.data()) {
+    return true;
+  }
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+  static const bool has_avx2 = platform::get_cpu_features().has_avx2;
+  static const bool has_sse2 = platform::get_cpu_features().has_sse2;
+  if (has_avx2) {
+    return _ascii_iequals_avx2(l.data(), r.data(), l.size());
+  }
+  if (has_sse2) {
+    return _ascii_iequals_sse2(l.data(), r.data(), l.size());
+  }
+#endif
+  return _ascii_iequals_scalar(l.data(), r.data(), l.size());
+}
+
+ATFRAMEWORK_UTILS_API size_t ascii_ifind(nostd::string_view haystack, nostd::string_view needle, size_t pos) noexcept {
+  if (pos > haystack.size() || needle.size() > haystack.size() - pos) {
+    return nostd::string_view::npos;
+  }
+  if (needle.empty()) {
+    return pos;
+  }
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+  static const bool has_avx2 = platform::get_cpu_features().has_avx2;
+  static const bool has_sse2 = platform::get_cpu_features().has_sse2;
+  if (has_avx2) {
+    return _ascii_ifind_avx2(haystack.data(), pos, haystack.size(), needle.data(), needle.size());
+  }
+  if (has_sse2) {
+    return _ascii_ifind_sse2(haystack.data(), pos, haystack.size(), needle.data(), needle.size());
+  }
+#endif
+  return _ascii_ifind_scalar(haystack.data(), pos, haystack.size(), needle.data(), needle.size());
+}
+
+ATFRAMEWORK_UTILS_API size_t split(nostd::string_view input, nostd::string_view delimiters,
+                                   gsl::span<nostd::string_view> output, bool skip_empty) noexcept {
+  _split_context_t ctx;
+  ctx.input = input.data();
+  ctx.output = output.data();
+  ctx.output_size = static_cast<size_t>(output.size());
+  ctx.count = 0;
+  ctx.token_begin = 0;
+  ctx.skip_empty = skip_empty;
+
+  bool delimiter_table[256];
+  memset(delimiter_table, 0, sizeof(delimiter_table));
+  for (char c : delimiters) {
+    delimiter_table[static_cast<unsigned char>(c)] = true;
+  }
+
+  size_t processed = 0;
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+  if (!delimiters.empty() && delimiters.size() <= 16) {
+    static const bool has_avx2 = platform::get_cpu_features().has_avx2;
+    static const bool has_sse2 = platform::get_cpu_features().has_sse2;
+    if (has_avx2) {
+      processed = _split_avx2(ctx, input.size(), delimiters.data(), delimiters.size());
+    } else if (has_sse2) {
+      processed = _split_sse2(ctx, input.size(), delimiters.data(), delimiters.size());
+    }
+  }
+#endif
+  _split_scalar(ctx, processed, input.size(), delimiter_table);
+  _split_emit(ctx, input.size());
+  return ctx.count;
+}
+
 ATFRAMEWORK_UTILS_API gsl::string_view trim_string(gsl::string_view input, bool trim_left, bool trim_right) {
   if (input.empty()) {
     return input;
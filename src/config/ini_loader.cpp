@@ -10,6 +10,8 @@
 #include <fstream>
 #include <string>
 
+#include "common/string_oprs.h"
+
 ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
 namespace config {
 // ================= 词法状态机 =================
@@ -272,9 +274,17 @@ ATFRAMEWORK_UTILS_API long long ini_value::as_longlong(size_t index) const {
   return detail::str2int<long long>(as_cpp_string(index).c_str());
 }
 
-ATFRAMEWORK_UTILS_API double ini_value::as_double(size_t index) const { return as<double>(index); }
+ATFRAMEWORK_UTILS_API double ini_value::as_double(size_t index) const {
+  double ret;
+  ATFRAMEWORK_UTILS_NAMESPACE_ID::string::str2float(ret, as_cpp_string(index));
+  return ret;
+}
 
-ATFRAMEWORK_UTILS_API float ini_value::as_float(size_t index) const { return as<float>(index); }
+ATFRAMEWORK_UTILS_API float ini_value::as_float(size_t index) const {
+  float ret;
+  ATFRAMEWORK_UTILS_NAMESPACE_ID::string::str2float(ret, as_cpp_string(index));
+  return ret;
+}
 
 ATFRAMEWORK_UTILS_API const char *ini_value::as_string(size_t index) const { return as_cpp_string(index).c_str(); }
 
@@ -892,11 +902,12 @@ ATFRAMEWORK_UTILS_API void ini_loader::dump_to(ATFRAMEWORK_UTILS_NAMESPACE_ID::n
     return;
   }
 
-  std::string trans = cur_node.as_cpp_string(index);
-  std::transform(trans.begin(), trans.end(), trans.begin(), detail::tolower<char>);
+  const std::string &trans = cur_node.as_cpp_string(index);
   val = true;
 
-  if ("0" == trans || "false" == trans || "no" == trans || "disable" == trans || "disabled" == trans || "" == trans) {
+  using ATFRAMEWORK_UTILS_NAMESPACE_ID::string::ascii_iequals;
+  if (trans.empty() || "0" == trans || ascii_iequals(trans, "false") || ascii_iequals(trans, "no") ||
+      ascii_iequals(trans, "disable") || ascii_iequals(trans, "disabled")) {
     val = false;
   }
 }
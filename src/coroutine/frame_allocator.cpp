@@ -0,0 +1,121 @@
+// Copyright 2026 atframework
+//
+// Licensed under the MIT licenses.
+
+#include "coroutine/task.h"
+
+#include <new>
+
+#include "std/thread.h"
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace coroutine {
+
+namespace {
+struct frame_free_node {
+  frame_free_node* next;
+};
+
+struct frame_thread_cache {
+  frame_free_node* free_list[frame_allocator::SIZE_CLASS_COUNT];
+  size_t free_count[frame_allocator::SIZE_CLASS_COUNT];
+  frame_allocator_stats stats;
+
+  frame_thread_cache() noexcept {
+    for (size_t i = 0; i < frame_allocator::SIZE_CLASS_COUNT; ++i) {
+      free_list[i] = nullptr;
+      free_count[i] = 0;
+    }
+    stats.allocate_count = 0;
+    stats.cache_hit_count = 0;
+    stats.cached_block_count = 0;
+  }
+
+  ~frame_thread_cache() { release(); }
+
+  void release() noexcept {
+    for (size_t i = 0; i < frame_allocator::SIZE_CLASS_COUNT; ++i) {
+      while (nullptr != free_list[i]) {
+        frame_free_node* node = free_list[i];
+        free_list[i] = node->next;
+        ::operator delete(static_cast<void*>(node));
+      }
+      free_count[i] = 0;
+    }
+    stats.cached_block_count = 0;
+  }
+};
+
+// 线程结束时需要释放缓存块，使用带析构的 thread_local(协程要求C++20，不需要兼容 THREAD_TLS 的降级实现)
+static frame_thread_cache& get_thread_cache() noexcept {
+  static thread_local frame_thread_cache ret;
+  return ret;
+}
+
+static inline size_t get_size_class(size_t size) noexcept {
+  return (size + frame_allocator::SIZE_CLASS_GRANULARITY - 1) / frame_allocator::SIZE_CLASS_GRANULARITY - 1;
+}
+}  // namespace
+
+ATFRAMEWORK_UTILS_API void* frame_allocator::allocate(size_t size) {
+  if (0 == size) {
+    size = 1;
+  }
+
+  if (size > MAX_CACHED_SIZE) {
+    return ::operator new(size);
+  }
+
+  frame_thread_cache& cache = get_thread_cache();
+  size_t index = get_size_class(size);
+  ++cache.stats.allocate_count;
+
+  frame_free_node* node = cache.free_list[index];
+  if (nullptr != node) {
+    cache.free_list[index] = node->next;
+    --cache.free_count[index];
+    --cache.stats.cached_block_count;
+    ++cache.stats.cache_hit_count;
+    return static_cast<void*>(node);
+  }
+
+  // 按整级大小分配，释放后可被同级的任意大小复用
+  return ::operator new((index + 1) * SIZE_CLASS_GRANULARITY);
+}
+
+ATFRAMEWORK_UTILS_API void frame_allocator::deallocate(void* ptr, size_t size) noexcept {
+  if (nullptr == ptr) {
+    return;
+  }
+
+  if (0 == size) {
+    size = 1;
+  }
+
+  if (size > MAX_CACHED_SIZE) {
+    ::operator delete(ptr);
+    return;
+  }
+
+  frame_thread_cache& cache = get_thread_cache();
+  size_t index = get_size_class(size);
+  if (cache.free_count[index] >= MAX_CACHED_BLOCKS_PER_CLASS) {
+    ::operator delete(ptr);
+    return;
+  }
+
+  frame_free_node* node = static_cast<frame_free_node*>(ptr);
+  node->next = cache.free_list[index];
+  cache.free_list[index] = node;
+  ++cache.free_count[index];
+  ++cache.stats.cached_block_count;
+}
+
+ATFRAMEWORK_UTILS_API frame_allocator_stats frame_allocator::get_thread_stats() noexcept {
+  return get_thread_cache().stats;
+}
+
+ATFRAMEWORK_UTILS_API void frame_allocator::release_thread_cache() noexcept { get_thread_cache().release(); }
+
+}  // namespace coroutine
+ATFRAMEWORK_UTILS_NAMESPACE_END
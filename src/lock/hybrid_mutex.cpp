@@ -0,0 +1,140 @@
+// Copyright 2026 atframework
+//
+// Licensed under the MIT licenses.
+
+#include "lock/hybrid_mutex.h"
+
+#if defined(__linux__)
+#  include <climits>
+#  include <linux/futex.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#  define ATFW_UTIL_LOCK_HYBRID_MUTEX_USE_FUTEX 1
+#elif defined(_MSC_VER) && defined(_WIN32)
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  include <Windows.h>
+#  pragma comment(lib, "Synchronization.lib")
+#  define ATFW_UTIL_LOCK_HYBRID_MUTEX_USE_WAIT_ON_ADDRESS 1
+#elif defined(__cpp_lib_atomic_wait) && __cpp_lib_atomic_wait >= 201907L
+#  define ATFW_UTIL_LOCK_HYBRID_MUTEX_USE_ATOMIC_WAIT 1
+#endif
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace lock {
+namespace detail {
+
+ATFRAMEWORK_UTILS_API void park_wait(::std::atomic<uint32_t>& addr, uint32_t expected) noexcept {
+#if defined(ATFW_UTIL_LOCK_HYBRID_MUTEX_USE_FUTEX)
+  // EAGAIN(值已变化)和EINTR都直接返回，由调用者重新检查状态
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(&addr), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#elif defined(ATFW_UTIL_LOCK_HYBRID_MUTEX_USE_WAIT_ON_ADDRESS)
+  WaitOnAddress(reinterpret_cast<volatile VOID*>(&addr), &expected, sizeof(expected), INFINITE);
+#elif defined(ATFW_UTIL_LOCK_HYBRID_MUTEX_USE_ATOMIC_WAIT)
+  addr.wait(expected, ::std::memory_order_relaxed);
+#else
+  // 没有可用的挂起原语时退化为短暂睡眠，调用者会重新检查状态
+  if (addr.load(::std::memory_order_relaxed) == expected) {
+    thread_sleep();
+  }
+#endif
+}
+
+ATFRAMEWORK_UTILS_API void park_wake_one(::std::atomic<uint32_t>& addr) noexcept {
+#if defined(ATFW_UTIL_LOCK_HYBRID_MUTEX_USE_FUTEX)
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(&addr), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#elif defined(ATFW_UTIL_LOCK_HYBRID_MUTEX_USE_WAIT_ON_ADDRESS)
+  WakeByAddressSingle(reinterpret_cast<PVOID>(&addr));
+#elif defined(ATFW_UTIL_LOCK_HYBRID_MUTEX_USE_ATOMIC_WAIT)
+  addr.notify_one();
+#else
+  (void)addr;
+#endif
+}
+
+ATFRAMEWORK_UTILS_API void park_wake_all(::std::atomic<uint32_t>& addr) noexcept {
+#if defined(ATFW_UTIL_LOCK_HYBRID_MUTEX_USE_FUTEX)
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(&addr), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#elif defined(ATFW_UTIL_LOCK_HYBRID_MUTEX_USE_WAIT_ON_ADDRESS)
+  WakeByAddressAll(reinterpret_cast<PVOID>(&addr));
+#elif defined(ATFW_UTIL_LOCK_HYBRID_MUTEX_USE_ATOMIC_WAIT)
+  addr.notify_all();
+#else
+  (void)addr;
+#endif
+}
+
+}  // namespace detail
+
+ATFRAMEWORK_UTILS_API hybrid_mutex::hybrid_mutex(uint32_t max_spin) noexcept
+    : lock_status_(static_cast<uint32_t>(UNLOCKED)),
+      max_spin_(max_spin),
+      spin_estimate_(0),
+      contended_count_(0),
+      spin_acquired_count_(0),
+      parked_count_(0) {}
+
+ATFRAMEWORK_UTILS_API hybrid_mutex_stats hybrid_mutex::get_stats() const noexcept {
+  hybrid_mutex_stats ret;
+  ret.contended_count = contended_count_.load(::std::memory_order_relaxed);
+  ret.spin_acquired_count = spin_acquired_count_.load(::std::memory_order_relaxed);
+  ret.parked_count = parked_count_.load(::std::memory_order_relaxed);
+
+  uint32_t spin_limit = ((spin_estimate_.load(::std::memory_order_relaxed) >> 3) << 1) + MIN_SPIN;
+  ret.spin_limit = spin_limit < max_spin_ ? spin_limit : max_spin_;
+  return ret;
+}
+
+ATFRAMEWORK_UTILS_API void hybrid_mutex::reset_stats() noexcept {
+  contended_count_.store(0, ::std::memory_order_relaxed);
+  spin_acquired_count_.store(0, ::std::memory_order_relaxed);
+  parked_count_.store(0, ::std::memory_order_relaxed);
+}
+
+ATFRAMEWORK_UTILS_API void hybrid_mutex::lock_slow() noexcept {
+  contended_count_.fetch_add(1, ::std::memory_order_relaxed);
+
+#if defined(ATFRAMEWORK_UTILS_LOCK_DISABLE_MT) && ATFRAMEWORK_UTILS_LOCK_DISABLE_MT
+  // 单线程模式下只可能是重复加锁，和 spin_lock 不同，这里不死等，直接标记为已加锁
+  lock_status_.store(static_cast<uint32_t>(LOCKED), ::std::memory_order_relaxed);
+#else
+
+  // 自旋上限为最近平均自旋次数的2倍，临界区短时多自旋，临界区长(比如IO)时尽快挂起
+  uint32_t estimate = spin_estimate_.load(::std::memory_order_relaxed);
+  uint32_t spin_limit = ((estimate >> 3) << 1) + MIN_SPIN;
+  if (spin_limit > max_spin_) {
+    spin_limit = max_spin_;
+  }
+
+  for (uint32_t i = 0; i < spin_limit; ++i) {
+    detail::spin_pause();
+    if (lock_status_.load(::std::memory_order_relaxed) != static_cast<uint32_t>(UNLOCKED)) {
+      continue;
+    }
+
+    uint32_t expect = static_cast<uint32_t>(UNLOCKED);
+    if (lock_status_.compare_exchange_weak(expect, static_cast<uint32_t>(LOCKED), ::std::memory_order_acquire,
+                                           ::std::memory_order_relaxed)) {
+      // EWMA(1/8): estimate = estimate * 7/8 + i
+      spin_estimate_.store(estimate - (estimate >> 3) + i + 1, ::std::memory_order_relaxed);
+      spin_acquired_count_.fetch_add(1, ::std::memory_order_relaxed);
+      return;
+    }
+  }
+
+  // 自旋失败说明临界区比自旋预算长，衰减估计值让后续更快进入挂起
+  spin_estimate_.store(estimate - (estimate >> 3), ::std::memory_order_relaxed);
+
+  // 标记有等待者，unlock时负责唤醒
+  uint32_t prev = lock_status_.exchange(static_cast<uint32_t>(LOCKED_WITH_WAITERS), ::std::memory_order_acquire);
+  while (prev != static_cast<uint32_t>(UNLOCKED)) {
+    parked_count_.fetch_add(1, ::std::memory_order_relaxed);
+    detail::park_wait(lock_status_, static_cast<uint32_t>(LOCKED_WITH_WAITERS));
+    prev = lock_status_.exchange(static_cast<uint32_t>(LOCKED_WITH_WAITERS), ::std::memory_order_acquire);
+  }
+#endif
+}
+
+}  // namespace lock
+ATFRAMEWORK_UTILS_NAMESPACE_END
@@ -99,7 +99,7 @@ ATFRAMEWORK_UTILS_API void log_sink_file_backend::set_file_pattern(const std::st
 
   {
     // 改这个成员也要加锁。stl是非线程安全的
-    lock::lock_holder<lock::spin_lock> lkholder(init_lock_);
+    lock::lock_holder<lock::hybrid_mutex> lkholder(init_lock_);
 
     // 计算检查周期，考虑到某些地区有夏令时，所以最大是小时。Unix时间戳会抹平闰秒，所以可以不考虑闰秒
     check_interval_ = 0;
@@ -223,7 +223,7 @@ ATFRAMEWORK_UTILS_API ATFW_UTIL_SANITIZER_NO_THREAD void log_sink_file_backend::
     return;
   }
   // 双检锁，初始化加锁
-  lock::lock_holder<lock::spin_lock> lkholder(init_lock_);
+  lock::lock_holder<lock::hybrid_mutex> lkholder(init_lock_);
   if (inited_) {
     return;
   }
@@ -683,7 +683,9 @@ ATFRAMEWORK_UTILS_API void http_request::finish_req_rsp() {
   }
 
   if (on_complete_fn_) {
-    on_complete_fn_(*this);
+    // 回调中可能会重新设置 on_complete，执行副本避免销毁正在执行的回调
+    on_complete_fn_t complete_fn = on_complete_fn_;
+    complete_fn(*this);
   }
 }
 
@@ -0,0 +1,1163 @@
+// Copyright 2026 atframework
+//
+// Licensed under the MIT licenses.
+
+#include "string/ac_automation_dfa.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <utility>
+
+#include "algorithm/bit.h"
+#include "common/cpu_features.h"
+#include "common/file_system.h"
+#include "lock/lock_holder.h"
+#include "thread/work_stealing_pool.h"
+
+#if defined(_WIN32)
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  include <Windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+#  include <immintrin.h>
+#endif
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace string {
+
+namespace {
+struct ac_automation_dfa_build_node_t {
+  // 按字节有序
+  std::vector<std::pair<uint8_t, uint32_t>> children;
+  uint32_t keyword;  // 关键字下标+1
+
+  ac_automation_dfa_build_node_t() : keyword(0) {}
+};
+
+/**
+ * @brief 双数组构建器
+ * @note 空闲位置用有序双向链表串起来，查找base时只遍历空闲位置；
+ *       一个空闲位置尝试多次都放不下子节点时移出链表，避免构建时间随节点数平方增长
+ */
+class ac_automation_dfa_builder {
+ public:
+  using unit_t = ac_automation_dfa::unit_t;
+
+  enum : uint32_t {
+    kNone = ac_automation_dfa::INVALID_INDEX,
+    kAlphabetSize = 256,
+  };
+
+  enum : uint8_t {
+    kMaxAttempts = 16,
+    kNotListed = 0xFF,
+  };
+
+  ac_automation_dfa_builder() : free_head_(kNone), free_tail_(kNone) {
+    extend(kAlphabetSize);
+    // 根节点
+    unlink(0);
+  }
+
+  inline std::vector<unit_t> &get_units() noexcept { return units_; }
+
+  uint32_t find_base(const std::vector<std::pair<uint8_t, uint32_t>> &children) {
+    uint32_t first_byte = children.front().first;
+    uint32_t pos = free_head_;
+    while (true) {
+      if (kNone == pos || pos < first_byte) {
+        if (kNone == pos) {
+          pos = static_cast<uint32_t>(units_.size());
+          extend(units_.size() + kAlphabetSize);
+        } else {
+          pos = next_free_[pos];
+        }
+        continue;
+      }
+
+      uint32_t base = pos - first_byte;
+      // 保证 base + 任意字节 都不越界，匹配时不需要检查边界
+      if (static_cast<size_t>(base) + kAlphabetSize > units_.size()) {
+        extend(static_cast<size_t>(base) + kAlphabetSize);
+      }
+
+      bool ok = true;
+      for (size_t i = 1; i < children.size(); ++i) {
+        if (kNone != units_[base + children[i].first].check) {
+          ok = false;
+          break;
+        }
+      }
+      if (ok) {
+        return base;
+      }
+
+      uint32_t next = next_free_[pos];
+      if (++attempts_[pos] >= kMaxAttempts) {
+        unlink(pos);
+      }
+      pos = next;
+    }
+  }
+
+  void occupy(uint32_t pos, uint32_t parent) {
+    if (kNotListed != attempts_[pos]) {
+      unlink(pos);
+    }
+    units_[pos].check = parent;
+  }
+
+ private:
+  void extend(size_t new_size) {
+    size_t old_size = units_.size();
+    if (new_size <= old_size) {
+      return;
+    }
+
+    unit_t empty_unit;
+    empty_unit.base = 0;
+    empty_unit.check = kNone;
+    empty_unit.fail = 0;
+    empty_unit.output = 0;
+    units_.resize(new_size, empty_unit);
+    next_free_.resize(new_size, kNone);
+    prev_free_.resize(new_size, kNone);
+    attempts_.resize(new_size, 0);
+
+    for (size_t i = old_size; i < new_size; ++i) {
+      uint32_t pos = static_cast<uint32_t>(i);
+      prev_free_[pos] = free_tail_;
+      next_free_[pos] = kNone;
+      if (kNone == free_tail_) {
+        free_head_ = pos;
+      } else {
+        next_free_[free_tail_] = pos;
+      }
+      free_tail_ = pos;
+    }
+  }
+
+  void unlink(uint32_t pos) {
+    uint32_t prev = prev_free_[pos];
+    uint32_t next = next_free_[pos];
+    if (kNone == prev) {
+      free_head_ = next;
+    } else {
+      next_free_[prev] = next;
+    }
+    if (kNone == next) {
+      free_tail_ = prev;
+    } else {
+      prev_free_[next] = prev;
+    }
+    attempts_[pos] = kNotListed;
+  }
+
+ private:
+  std::vector<unit_t> units_;
+  std::vector<uint32_t> next_free_;
+  std::vector<uint32_t> prev_free_;
+  std::vector<uint8_t> attempts_;
+  uint32_t free_head_;
+  uint32_t free_tail_;
+};
+
+static inline size_t ac_automation_dfa_align(size_t sz, size_t align) { return (sz + align - 1) / align * align; }
+
+static inline bool ac_automation_dfa_test_skip(const uint32_t *skip_bitmap, uint8_t c) {
+  return 0 != (skip_bitmap[c >> 5] & (static_cast<uint32_t>(1) << (c & 0x1F)));
+}
+
+// ================ Teddy prefilter ================
+// 关键字前缀按字典序分成8组，每组占掩码的一位。输入字节的低4位和高4位分别查表，
+// 前缀每个位置的结果按位与，非0表示该位置可能是某个关键字的开头(只会误报，不会漏报)
+using ac_automation_dfa_prefilter_masks_t = uint8_t[ac_automation_dfa::PREFILTER_MAX_LENGTH][2][16];
+
+static uint32_t ac_automation_dfa_build_prefilter(gsl::span<const nostd::string_view> keywords,
+                                                  const uint8_t *fold_map, bool has_skip,
+                                                  ac_automation_dfa_prefilter_masks_t &masks) {
+  memset(masks, 0, sizeof(masks));
+
+  size_t prefix_length = has_skip ? 1 : static_cast<size_t>(ac_automation_dfa::PREFILTER_MAX_LENGTH);
+  bool has_keyword = false;
+  for (auto &keyword : keywords) {
+    if (!keyword.empty()) {
+      has_keyword = true;
+      prefix_length = (std::min)(prefix_length, keyword.size());
+    }
+  }
+  if (!has_keyword) {
+    return 0;
+  }
+
+  std::vector<std::string> prefixes;
+  prefixes.reserve(keywords.size());
+  for (auto &keyword : keywords) {
+    if (keyword.empty()) {
+      continue;
+    }
+    std::string prefix;
+    for (size_t i = 0; i < prefix_length; ++i) {
+      prefix.push_back(static_cast<char>(fold_map[static_cast<uint8_t>(keyword[i])]));
+    }
+    prefixes.push_back(prefix);
+  }
+  std::sort(prefixes.begin(), prefixes.end());
+  prefixes.erase(std::unique(prefixes.begin(), prefixes.end()), prefixes.end());
+
+  // 忽略大小写时，一个前缀字节对应多个输入字节
+  std::vector<uint8_t> input_bytes[256];
+  for (size_t i = 0; i < 256; ++i) {
+    input_bytes[fold_map[i]].push_back(static_cast<uint8_t>(i));
+  }
+
+  for (size_t i = 0; i < prefixes.size(); ++i) {
+    uint8_t bucket_bit = static_cast<uint8_t>(1 << (i * 8 / prefixes.size()));
+    for (size_t k = 0; k < prefix_length; ++k) {
+      for (uint8_t c : input_bytes[static_cast<uint8_t>(prefixes[i][k])]) {
+        masks[k][0][c & 0x0F] |= bucket_bit;
+        masks[k][1][c >> 4] |= bucket_bit;
+      }
+    }
+  }
+
+  // 按均匀分布估算候选位置的比例，掩码饱和时预过滤没有收益
+  double candidate_rate = 0.0;
+  for (int bucket = 0; bucket < 8; ++bucket) {
+    double bucket_rate = 1.0;
+    for (size_t k = 0; k < prefix_length; ++k) {
+      size_t count = 0;
+      for (size_t c = 0; c < 256; ++c) {
+        if (0 != (masks[k][0][c & 0x0F] & masks[k][1][c >> 4] & (1 << bucket))) {
+          ++count;
+        }
+      }
+      bucket_rate *= static_cast<double>(count) / 256.0;
+    }
+    candidate_rate += bucket_rate;
+  }
+  if (candidate_rate > 0.25) {
+    memset(masks, 0, sizeof(masks));
+    return 0;
+  }
+
+  return static_cast<uint32_t>(prefix_length);
+}
+
+// 返回第一个可能是关键字开头的位置，没有时返回 input_size
+using ac_automation_dfa_prefilter_fn_t = size_t (*)(const ac_automation_dfa::header_t &header, const uint8_t *input,
+                                                    size_t input_size, size_t from);
+
+static size_t ac_automation_dfa_prefilter_scalar(const ac_automation_dfa::header_t &header, const uint8_t *input,
+                                                 size_t input_size, size_t from) {
+  const size_t prefix_length = header.prefilter_length;
+  if (input_size < prefix_length) {
+    return input_size;
+  }
+
+  for (size_t i = from; i + prefix_length <= input_size; ++i) {
+    uint8_t result = 0xFF;
+    for (size_t k = 0; k < prefix_length; ++k) {
+      uint8_t c = input[i + k];
+      result &= header.prefilter_masks[k][0][c & 0x0F] & header.prefilter_masks[k][1][c >> 4];
+    }
+    if (0 != result) {
+      return i;
+    }
+  }
+
+  return input_size;
+}
+
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+ATFW_UTIL_FORCEINLINE ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("ssse3") static __m128i ac_automation_dfa_teddy_ssse3(
+    const uint8_t *input, __m128i low_mask, __m128i high_mask) {
+  const __m128i nibble_mask = _mm_set1_epi8(0x0F);
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input));
+  __m128i low = _mm_shuffle_epi8(low_mask, _mm_and_si128(v, nibble_mask));
+  __m128i high = _mm_shuffle_epi8(high_mask, _mm_and_si128(_mm_srli_epi16(v, 4), nibble_mask));
+  return _mm_and_si128(low, high);
+}
+
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("ssse3")
+static size_t ac_automation_dfa_prefilter_ssse3(const ac_automation_dfa::header_t &header, const uint8_t *input,
+                                                size_t input_size, size_t from) {
+  const size_t prefix_length = header.prefilter_length;
+  __m128i masks[ac_automation_dfa::PREFILTER_MAX_LENGTH][2];
+  for (size_t k = 0; k < prefix_length; ++k) {
+    masks[k][0] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(header.prefilter_masks[k][0]));
+    masks[k][1] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(header.prefilter_masks[k][1]));
+  }
+
+  const __m128i zero = _mm_setzero_si128();
+  size_t i = from;
+  for (; i + 16 + prefix_length - 1 <= input_size; i += 16) {
+    __m128i result = ac_automation_dfa_teddy_ssse3(input + i, masks[0][0], masks[0][1]);
+    for (size_t k = 1; k < prefix_length; ++k) {
+      result = _mm_and_si128(result, ac_automation_dfa_teddy_ssse3(input + i + k, masks[k][0], masks[k][1]));
+    }
+
+    uint32_t candidates = static_cast<uint32_t>(~_mm_movemask_epi8(_mm_cmpeq_epi8(result, zero))) & 0xFFFFU;
+    if (0 != candidates) {
+      return i + static_cast<size_t>(bit::countr_zero(candidates));
+    }
+  }
+
+  return ac_automation_dfa_prefilter_scalar(header, input, input_size, i);
+}
+
+ATFW_UTIL_FORCEINLINE ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("avx2") static __m256i ac_automation_dfa_teddy_avx2(
+    const uint8_t *input, __m256i low_mask, __m256i high_mask) {
+  const __m256i nibble_mask = _mm256_set1_epi8(0x0F);
+  __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input));
+  __m256i low = _mm256_shuffle_epi8(low_mask, _mm256_and_si256(v, nibble_mask));
+  __m256i high = _mm256_shuffle_epi8(high_mask, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble_mask));
+  return _mm256_and_si256(low, high);
+}
+
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("avx2")
+static size_t ac_automation_dfa_prefilter_avx2(const ac_automation_dfa::header_t &header, const uint8_t *input,
+                                               size_t input_size, size_t from) {
+  const size_t prefix_length = header.prefilter_length;
+  // vpshufb 按128位分别查表，两半都放同一份掩码
+  __m256i masks[ac_automation_dfa::PREFILTER_MAX_LENGTH][2];
+  for (size_t k = 0; k < prefix_length; ++k) {
+    masks[k][0] = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(header.prefilter_masks[k][0])));
+    masks[k][1] = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(header.prefilter_masks[k][1])));
+  }
+
+  const __m256i zero = _mm256_setzero_si256();
+  size_t i = from;
+  for (; i + 32 + prefix_length - 1 <= input_size; i += 32) {
+    __m256i result = ac_automation_dfa_teddy_avx2(input + i, masks[0][0], masks[0][1]);
+    for (size_t k = 1; k < prefix_length; ++k) {
+      result = _mm256_and_si256(result, ac_automation_dfa_teddy_avx2(input + i + k, masks[k][0], masks[k][1]));
+    }
+
+    uint32_t candidates = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(result, zero)));
+    if (0 != candidates) {
+      return i + static_cast<size_t>(bit::countr_zero(candidates));
+    }
+  }
+
+  return ac_automation_dfa_prefilter_scalar(header, input, input_size, i);
+}
+#endif
+
+static ac_automation_dfa_prefilter_fn_t ac_automation_dfa_select_prefilter() {
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+  const platform::cpu_features &features = platform::get_cpu_features();
+  if (features.has_avx2) {
+    return ac_automation_dfa_prefilter_avx2;
+  }
+  if (features.has_ssse3) {
+    return ac_automation_dfa_prefilter_ssse3;
+  }
+#endif
+  return ac_automation_dfa_prefilter_scalar;
+}
+
+/**
+ * @brief 根节点上的预过滤状态
+ * @note 候选位置过于密集(平均间隔小于8字节)时，批量扫描没有收益，本次匹配退回逐字节查表
+ */
+struct ac_automation_dfa_prefilter_context_t {
+  ac_automation_dfa_prefilter_fn_t fn;
+  size_t candidate_count;
+
+  explicit ac_automation_dfa_prefilter_context_t(const ac_automation_dfa::header_t &header)
+      : fn(0 == header.prefilter_length ? nullptr : ac_automation_dfa_select_prefilter()), candidate_count(0) {}
+
+  inline size_t next(const ac_automation_dfa::header_t &header, const uint8_t *input, size_t input_size,
+                     size_t from) {
+    if (nullptr == fn) {
+      return from;
+    }
+
+    size_t ret = (*fn)(header, input, input_size, from);
+    if (++candidate_count >= 64 && ret < candidate_count * 8) {
+      fn = nullptr;
+    }
+    return ret;
+  }
+};
+}  // namespace
+
+ac_automation_dfa::ac_automation_dfa() noexcept : data_(nullptr) {}
+
+ac_automation_dfa::~ac_automation_dfa() {}
+
+ac_automation_dfa::ac_automation_dfa(const ac_automation_dfa &other) : data_(nullptr) { *this = other; }
+
+ac_automation_dfa &ac_automation_dfa::operator=(const ac_automation_dfa &other) {
+  if (this == &other) {
+    return *this;
+  }
+
+  storage_ = other.storage_;
+  if (nullptr != other.data_ && other.data_ == other.storage_.data()) {
+    data_ = storage_.data();
+  } else {
+    data_ = other.data_;
+  }
+  return *this;
+}
+
+ac_automation_dfa::ac_automation_dfa(ac_automation_dfa &&other) noexcept : data_(nullptr) {
+  *this = std::move(other);
+}
+
+ac_automation_dfa &ac_automation_dfa::operator=(ac_automation_dfa &&other) noexcept {
+  if (this == &other) {
+    return *this;
+  }
+
+  // vector移动后缓冲区地址不变
+  storage_ = std::move(other.storage_);
+  data_ = other.data_;
+  other.storage_.clear();
+  other.data_ = nullptr;
+  return *this;
+}
+
+bool ac_automation_dfa::build(gsl::span<const nostd::string_view> keywords, bool nocase,
+                              nostd::string_view skip_bytes, bool enable_prefilter) {
+  reset();
+
+  uint8_t fold_map[256];
+  for (size_t i = 0; i < 256; ++i) {
+    fold_map[i] = static_cast<uint8_t>(i);
+    if (nocase && i >= 'A' && i <= 'Z') {
+      fold_map[i] = static_cast<uint8_t>(i - 'A' + 'a');
+    }
+  }
+
+  if (keywords.size() >= std::numeric_limits<uint32_t>::max()) {
+    return false;
+  }
+
+  // 先构建普通的字典树
+  std::vector<ac_automation_dfa_build_node_t> nodes;
+  nodes.resize(1);
+  size_t keyword_data_size = 0;
+  for (size_t i = 0; i < keywords.size(); ++i) {
+    keyword_data_size += keywords[i].size();
+    if (keywords[i].empty()) {
+      continue;
+    }
+
+    uint32_t current = 0;
+    for (size_t j = 0; j < keywords[i].size(); ++j) {
+      uint8_t c = fold_map[static_cast<uint8_t>(keywords[i][j])];
+      std::vector<std::pair<uint8_t, uint32_t>> &children = nodes[current].children;
+      auto iter = std::lower_bound(
+          children.begin(), children.end(), c,
+          [](const std::pair<uint8_t, uint32_t> &l, uint8_t r) -> bool { return l.first < r; });
+      if (iter != children.end() && iter->first == c) {
+        current = iter->second;
+        continue;
+      }
+
+      uint32_t next = static_cast<uint32_t>(nodes.size());
+      children.insert(iter, std::make_pair(c, next));
+      nodes.resize(nodes.size() + 1);
+      current = next;
+    }
+    nodes[current].keyword = static_cast<uint32_t>(i + 1);
+  }
+
+  // BFS分配双数组位置
+  ac_automation_dfa_builder builder;
+  std::vector<std::pair<uint32_t, uint32_t>> bfs_order;  // (node, position)
+  bfs_order.reserve(nodes.size());
+  bfs_order.push_back(std::make_pair(0, 0));
+  for (size_t i = 0; i < bfs_order.size(); ++i) {
+    const ac_automation_dfa_build_node_t &node = nodes[bfs_order[i].first];
+    uint32_t pos = bfs_order[i].second;
+    if (node.children.empty()) {
+      continue;
+    }
+
+    uint32_t base = builder.find_base(node.children);
+    builder.get_units()[pos].base = base;
+    for (auto &child : node.children) {
+      uint32_t child_pos = base + child.first;
+      builder.occupy(child_pos, pos);
+      builder.get_units()[child_pos].output = nodes[child.second].keyword;
+      bfs_order.push_back(std::make_pair(child.second, child_pos));
+    }
+  }
+
+  // BFS顺序设置失败节点，并把失败链上的关键字合并到output
+  std::vector<unit_t> &units = builder.get_units();
+  for (size_t i = 1; i < bfs_order.size(); ++i) {
+    uint32_t pos = bfs_order[i].second;
+    uint32_t parent = units[pos].check;
+    uint32_t c = pos - units[parent].base;
+    uint32_t fail = 0;
+    if (0 != parent) {
+      for (uint32_t f = units[parent].fail;; f = units[f].fail) {
+        uint32_t next = units[f].base + c;
+        if (units[next].check == f) {
+          fail = next;
+          break;
+        }
+        if (0 == f) {
+          break;
+        }
+      }
+    }
+
+    units[pos].fail = fail;
+    if (0 == units[pos].output) {
+      units[pos].output = units[fail].output;
+    }
+  }
+
+  ac_automation_dfa_prefilter_masks_t prefilter_masks;
+  uint32_t prefilter_length = 0;
+  if (enable_prefilter) {
+    prefilter_length = ac_automation_dfa_build_prefilter(keywords, fold_map, !skip_bytes.empty(), prefilter_masks);
+  } else {
+    memset(prefilter_masks, 0, sizeof(prefilter_masks));
+  }
+
+  // 输出到连续内存
+  size_t units_offset = ac_automation_dfa_align(sizeof(header_t), 64);
+  size_t keyword_index_offset = units_offset + units.size() * sizeof(unit_t);
+  size_t keyword_data_offset = keyword_index_offset + keywords.size() * sizeof(keyword_index_t);
+  size_t total_size = ac_automation_dfa_align(keyword_data_offset + keyword_data_size, sizeof(uint32_t));
+  if (total_size > std::numeric_limits<uint32_t>::max()) {
+    return false;
+  }
+
+  storage_.assign(total_size / sizeof(uint32_t), 0);
+  unsigned char *buffer = reinterpret_cast<unsigned char *>(storage_.data());
+
+  header_t *header = reinterpret_cast<header_t *>(buffer);
+  header->magic = MAGIC;
+  header->version = VERSION;
+  header->flags = nocase ? static_cast<uint32_t>(FLAG_NOCASE) : 0;
+  header->total_size = static_cast<uint32_t>(total_size);
+  header->unit_count = static_cast<uint32_t>(units.size());
+  header->state_count = static_cast<uint32_t>(bfs_order.size());
+  header->keyword_count = static_cast<uint32_t>(keywords.size());
+  header->units_offset = static_cast<uint32_t>(units_offset);
+  header->keyword_index_offset = static_cast<uint32_t>(keyword_index_offset);
+  header->keyword_data_offset = static_cast<uint32_t>(keyword_data_offset);
+  for (size_t i = 0; i < skip_bytes.size(); ++i) {
+    uint8_t c = static_cast<uint8_t>(skip_bytes[i]);
+    header->skip_bitmap[c >> 5] |= static_cast<uint32_t>(1) << (c & 0x1F);
+  }
+  memcpy(header->fold_map, fold_map, sizeof(fold_map));
+  header->prefilter_length = prefilter_length;
+  memcpy(header->prefilter_masks, prefilter_masks, sizeof(prefilter_masks));
+
+  memcpy(buffer + units_offset, units.data(), units.size() * sizeof(unit_t));
+
+  keyword_index_t *keyword_index = reinterpret_cast<keyword_index_t *>(buffer + keyword_index_offset);
+  size_t keyword_offset = 0;
+  for (size_t i = 0; i < keywords.size(); ++i) {
+    keyword_index[i].offset = static_cast<uint32_t>(keyword_offset);
+    keyword_index[i].length = static_cast<uint32_t>(keywords[i].size());
+    if (!keywords[i].empty()) {
+      memcpy(buffer + keyword_data_offset + keyword_offset, keywords[i].data(), keywords[i].size());
+    }
+    keyword_offset += keywords[i].size();
+  }
+
+  data_ = storage_.data();
+  return true;
+}
+
+bool ac_automation_dfa::attach(const void *data, size_t size, bool verify) {
+  reset();
+
+  if (nullptr == data || size < sizeof(header_t) || 0 != reinterpret_cast<uintptr_t>(data) % sizeof(uint32_t)) {
+    return false;
+  }
+
+  const header_t *header = reinterpret_cast<const header_t *>(data);
+  if (MAGIC != header->magic || VERSION != header->version ||
+      0 != (header->flags & ~static_cast<uint32_t>(FLAG_NOCASE))) {
+    return false;
+  }
+
+  size_t total_size = header->total_size;
+  if (total_size > size || total_size < sizeof(header_t) || 0 != total_size % sizeof(uint32_t)) {
+    return false;
+  }
+  if (header->prefilter_length > PREFILTER_MAX_LENGTH) {
+    return false;
+  }
+
+  // 每段数据都必须在总长度范围内并且对齐，根节点的 base + 任意字节 也必须在双数组内
+  if (header->unit_count < 256 || header->state_count > header->unit_count ||
+      0 != header->units_offset % sizeof(uint32_t) || header->units_offset < sizeof(header_t) ||
+      header->units_offset > total_size ||
+      (total_size - header->units_offset) / sizeof(unit_t) < header->unit_count) {
+    return false;
+  }
+  if (0 != header->keyword_index_offset % sizeof(uint32_t) || header->keyword_index_offset < sizeof(header_t) ||
+      header->keyword_index_offset > total_size ||
+      (total_size - header->keyword_index_offset) / sizeof(keyword_index_t) < header->keyword_count) {
+    return false;
+  }
+  if (header->keyword_data_offset < sizeof(header_t) || header->keyword_data_offset > total_size) {
+    return false;
+  }
+
+  const unsigned char *buffer = reinterpret_cast<const unsigned char *>(data);
+  const keyword_index_t *keyword_index =
+      reinterpret_cast<const keyword_index_t *>(buffer + header->keyword_index_offset);
+  size_t keyword_data_size = total_size - header->keyword_data_offset;
+  for (uint32_t i = 0; i < header->keyword_count; ++i) {
+    if (keyword_index[i].offset > keyword_data_size ||
+        keyword_index[i].length > keyword_data_size - keyword_index[i].offset) {
+      return false;
+    }
+  }
+
+  if (verify && !verify_units(*header, reinterpret_cast<const unit_t *>(buffer + header->units_offset))) {
+    return false;
+  }
+
+  data_ = reinterpret_cast<const uint32_t *>(data);
+  return true;
+}
+
+bool ac_automation_dfa::load(const void *data, size_t size) {
+  reset();
+
+  if (nullptr == data || size < sizeof(header_t)) {
+    return false;
+  }
+
+  // 复制到对齐的缓冲区后再检查
+  size_t total_size = reinterpret_cast<const header_t *>(data)->total_size;
+  if (total_size > size || total_size < sizeof(header_t)) {
+    return false;
+  }
+
+  std::vector<uint32_t> storage;
+  storage.resize((total_size + sizeof(uint32_t) - 1) / sizeof(uint32_t), 0);
+  memcpy(storage.data(), data, total_size);
+  if (!attach(storage.data(), total_size, true)) {
+    return false;
+  }
+
+  storage_.swap(storage);
+  data_ = storage_.data();
+  return true;
+}
+
+bool ac_automation_dfa::save_file(const char *file_path) const {
+  if (nullptr == data_ || nullptr == file_path) {
+    return false;
+  }
+
+  // 临时文件名带上进程号和序号，多个进程或线程同时写同一个文件时互不覆盖
+  static std::atomic<uint64_t> tmp_file_sequence{0};
+#if defined(_WIN32)
+  uint64_t pid = static_cast<uint64_t>(::GetCurrentProcessId());
+#else
+  uint64_t pid = static_cast<uint64_t>(::getpid());
+#endif
+  std::string tmp_path = file_path;
+  tmp_path += ".";
+  tmp_path += std::to_string(pid);
+  tmp_path += ".";
+  tmp_path += std::to_string(tmp_file_sequence.fetch_add(1, std::memory_order_relaxed));
+  tmp_path += ".tmp";
+  FILE *f = nullptr;
+  UTIL_FS_OPEN(error_code, f, tmp_path.c_str(), "wb");
+  if (nullptr == f) {
+    return false;
+  }
+
+  bool ret = fwrite(data_, 1, size(), f) == size();
+  ret = (0 == fflush(f)) && ret;
+  UTIL_FS_CLOSE(f);
+  if (!ret) {
+    file_system::remove(tmp_path.c_str());
+    return false;
+  }
+
+  // Windows上rename不能覆盖已存在的文件，使用MoveFileEx原子替换；POSIX上rename本身就是原子替换
+#if defined(_WIN32)
+  bool renamed = FALSE != ::MoveFileExA(tmp_path.c_str(), file_path, MOVEFILE_REPLACE_EXISTING);
+#else
+  bool renamed = file_system::rename(tmp_path.c_str(), file_path);
+#endif
+  if (!renamed) {
+    file_system::remove(tmp_path.c_str());
+  }
+  return renamed;
+}
+
+bool ac_automation_dfa::verify_units(const header_t &header, const unit_t *units) {
+  // 已使用的节点转移后不越界；失败节点的深度必须小于自身，保证失败转移的循环能结束
+  const uint32_t unit_count = header.unit_count;
+  const uint32_t visiting = INVALID_INDEX - 1;
+  std::vector<uint32_t> depth;
+  depth.resize(unit_count, INVALID_INDEX);
+  depth[0] = 0;
+
+  std::vector<uint32_t> path;
+  for (uint32_t i = 0; i < unit_count; ++i) {
+    if (0 != i && INVALID_INDEX == units[i].check) {
+      continue;
+    }
+    if (static_cast<size_t>(units[i].base) + 256 > unit_count || units[i].fail >= unit_count ||
+        units[i].output > header.keyword_count) {
+      return false;
+    }
+
+    // 沿父节点向上找到已知深度的节点
+    path.clear();
+    uint32_t pos = i;
+    while (INVALID_INDEX == depth[pos]) {
+      depth[pos] = visiting;
+      path.push_back(pos);
+      pos = units[pos].check;
+      if (pos >= unit_count || (0 != pos && INVALID_INDEX == units[pos].check)) {
+        return false;
+      }
+    }
+    // 父节点链有环
+    if (visiting == depth[pos]) {
+      return false;
+    }
+    for (size_t j = path.size(); j > 0; --j) {
+      depth[path[j - 1]] = depth[pos] + 1;
+      pos = path[j - 1];
+    }
+  }
+
+  for (uint32_t i = 1; i < unit_count; ++i) {
+    if (INVALID_INDEX == units[i].check) {
+      continue;
+    }
+    // 子节点必须由父节点的 base 转移得到
+    if (units[units[i].check].base > i || i - units[units[i].check].base >= 256) {
+      return false;
+    }
+    uint32_t fail = units[i].fail;
+    if ((0 != fail && INVALID_INDEX == units[fail].check) || depth[fail] >= depth[i]) {
+      return false;
+    }
+  }
+
+  return 0 == units[0].fail;
+}
+
+void ac_automation_dfa::reset() noexcept {
+  storage_.clear();
+  data_ = nullptr;
+}
+
+size_t ac_automation_dfa::match(nostd::string_view content, value_type &output) const {
+  if (nullptr == data_ || content.empty()) {
+    return 0;
+  }
+
+  const header_t *header = get_header();
+  const unit_t *units = reinterpret_cast<const unit_t *>(reinterpret_cast<const unsigned char *>(data_) +
+                                                         header->units_offset);
+  const keyword_index_t *keyword_index = reinterpret_cast<const keyword_index_t *>(
+      reinterpret_cast<const unsigned char *>(data_) + header->keyword_index_offset);
+
+  size_t ret = 0;
+  uint32_t state = 0;
+  bool has_skip = false;
+  const uint8_t *input = reinterpret_cast<const uint8_t *>(content.data());
+  ac_automation_dfa_prefilter_context_t prefilter(*header);
+  for (size_t i = 0; i < content.size(); ++i) {
+    // 在根节点时，关键字只可能从预过滤的候选位置开始
+    if (0 == state) {
+      i = prefilter.next(*header, input, content.size(), i);
+      if (i >= content.size()) {
+        break;
+      }
+    }
+
+    uint8_t c = header->fold_map[input[i]];
+    bool skipped = false;
+    while (true) {
+      uint32_t next = units[state].base + c;
+      if (units[next].check == state) {
+        state = next;
+        break;
+      }
+      if (0 == state) {
+        break;
+      }
+      // 没有后续转移时才忽略字符
+      if (ac_automation_dfa_test_skip(header->skip_bitmap, c)) {
+        skipped = true;
+        break;
+      }
+      state = units[state].fail;
+    }
+
+    if (skipped) {
+      has_skip = true;
+      continue;
+    }
+    if (0 == state) {
+      has_skip = false;
+      continue;
+    }
+
+    uint32_t out = units[state].output;
+    if (0 == out) {
+      continue;
+    }
+
+    match_t item;
+    item.keyword_index = out - 1;
+    size_t end = i + 1;
+    if (has_skip) {
+      item.start = find_start(content, end, item.keyword_index);
+    } else {
+      item.start = end - keyword_index[item.keyword_index].length;
+    }
+    item.length = end - item.start;
+    output.push_back(item);
+    ++ret;
+
+    state = 0;
+    has_skip = false;
+  }
+
+  return ret;
+}
+
+ac_automation_dfa::value_type ac_automation_dfa::match(nostd::string_view content) const {
+  value_type ret;
+  match(content, ret);
+  return ret;
+}
+
+bool ac_automation_dfa::contains(nostd::string_view content) const {
+  if (nullptr == data_ || content.empty()) {
+    return false;
+  }
+
+  const header_t *header = get_header();
+  const unit_t *units = reinterpret_cast<const unit_t *>(reinterpret_cast<const unsigned char *>(data_) +
+                                                         header->units_offset);
+  uint32_t state = 0;
+  const uint8_t *input = reinterpret_cast<const uint8_t *>(content.data());
+  ac_automation_dfa_prefilter_context_t prefilter(*header);
+  for (size_t i = 0; i < content.size(); ++i) {
+    if (0 == state) {
+      i = prefilter.next(*header, input, content.size(), i);
+      if (i >= content.size()) {
+        break;
+      }
+    }
+
+    uint8_t c = header->fold_map[input[i]];
+    while (true) {
+      uint32_t next = units[state].base + c;
+      if (units[next].check == state) {
+        state = next;
+        break;
+      }
+      if (0 == state || ac_automation_dfa_test_skip(header->skip_bitmap, c)) {
+        break;
+      }
+      state = units[state].fail;
+    }
+
+    if (0 != units[state].output) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+size_t ac_automation_dfa::match_batch(gsl::span<const nostd::string_view> contents, batch_result_t &output,
+                                      thread::work_stealing_pool *pool) const {
+  output.matches.clear();
+  output.offsets.assign(contents.size() + 1, 0);
+  output.chunks.clear();
+  if (nullptr == data_ || contents.empty()) {
+    return 0;
+  }
+
+  size_t chunk_bytes = 0;
+  size_t chunk_begin = 0;
+  for (size_t i = 0; i < contents.size(); ++i) {
+    chunk_bytes += contents[i].size();
+    if (chunk_bytes >= BATCH_CHUNK_BYTES || i + 1 - chunk_begin >= BATCH_CHUNK_MAX_COUNT ||
+        i + 1 == contents.size()) {
+      batch_chunk_t chunk;
+      chunk.begin = chunk_begin;
+      chunk.end = i + 1;
+      chunk.slot = 0;
+      chunk.slot_offset = 0;
+      output.chunks.push_back(chunk);
+      chunk_begin = i + 1;
+      chunk_bytes = 0;
+    }
+  }
+
+  // 只有一个任务时直接写到输出，不需要合并
+  size_t *counts = output.offsets.data() + 1;
+  if (nullptr == pool || output.chunks.size() <= 1) {
+    for (size_t i = 0; i < contents.size(); ++i) {
+      counts[i] = match(contents[i], output.matches);
+    }
+    for (size_t i = 0; i < contents.size(); ++i) {
+      output.offsets[i + 1] += output.offsets[i];
+    }
+    return output.matches.size();
+  }
+
+  // 临时缓冲区保留在 output 里，重复使用时保留上次的容量
+  size_t slot_count = pool->get_parallel_slot_count(output.chunks.size());
+  if (output.scratches.size() < slot_count) {
+    output.scratches.resize(slot_count);
+  }
+  for (auto &scratch : output.scratches) {
+    scratch.clear();
+  }
+
+  pool->parallel_for(output.chunks.size(), [this, &contents, &output, counts](size_t slot, size_t index) {
+    value_type &scratch = output.scratches[slot];
+    batch_chunk_t &chunk = output.chunks[index];
+    chunk.slot = slot;
+    chunk.slot_offset = scratch.size();
+    for (size_t i = chunk.begin; i < chunk.end; ++i) {
+      counts[i] = match(contents[i], scratch);
+    }
+  });
+
+  for (size_t i = 0; i < contents.size(); ++i) {
+    output.offsets[i + 1] += output.offsets[i];
+  }
+  output.matches.resize(output.offsets.back());
+  for (auto &chunk : output.chunks) {
+    size_t count = output.offsets[chunk.end] - output.offsets[chunk.begin];
+    if (count > 0) {
+      memcpy(output.matches.data() + output.offsets[chunk.begin],
+             output.scratches[chunk.slot].data() + chunk.slot_offset, count * sizeof(match_t));
+    }
+  }
+
+  return output.matches.size();
+}
+
+nostd::string_view ac_automation_dfa::get_keyword(uint32_t keyword_index) const noexcept {
+  if (nullptr == data_ || keyword_index >= get_header()->keyword_count) {
+    return nostd::string_view();
+  }
+
+  const header_t *header = get_header();
+  const unsigned char *buffer = reinterpret_cast<const unsigned char *>(data_);
+  const keyword_index_t *index = reinterpret_cast<const keyword_index_t *>(buffer + header->keyword_index_offset);
+  return nostd::string_view(
+      reinterpret_cast<const char *>(buffer + header->keyword_data_offset + index[keyword_index].offset),
+      index[keyword_index].length);
+}
+
+size_t ac_automation_dfa::find_start(nostd::string_view content, size_t end, uint32_t keyword_index) const noexcept {
+  const header_t *header = get_header();
+  nostd::string_view keyword = get_keyword(keyword_index);
+  if (keyword.empty() || end > content.size()) {
+    return end;
+  }
+
+  // 从结束位置往前匹配关键字，跳过忽略字符
+  size_t keyword_pos = keyword.size();
+  for (size_t i = end; i > 0; --i) {
+    uint8_t c = header->fold_map[static_cast<uint8_t>(content[i - 1])];
+    if (c == header->fold_map[static_cast<uint8_t>(keyword[keyword_pos - 1])]) {
+      if (0 == --keyword_pos) {
+        return i - 1;
+      }
+      continue;
+    }
+
+    if (!ac_automation_dfa_test_skip(header->skip_bitmap, c)) {
+      return i;
+    }
+  }
+
+  return 0;
+}
+
+ac_automation_dfa_image::ac_automation_dfa_image(construct_helper_t &) noexcept
+    : mapped_address_(nullptr),
+      mapped_size_(0)
+#if defined(_WIN32)
+      ,
+      file_handle_(nullptr),
+      mapping_handle_(nullptr)
+#endif
+{
+}
+
+ac_automation_dfa_image::~ac_automation_dfa_image() {
+  dfa_.reset();
+
+#if defined(_WIN32)
+  if (nullptr != mapped_address_) {
+    UnmapViewOfFile(mapped_address_);
+  }
+  if (nullptr != mapping_handle_) {
+    CloseHandle(mapping_handle_);
+  }
+  if (nullptr != file_handle_) {
+    CloseHandle(file_handle_);
+  }
+#else
+  if (nullptr != mapped_address_) {
+    munmap(mapped_address_, mapped_size_);
+  }
+#endif
+}
+
+ac_automation_dfa_image::ptr_t ac_automation_dfa_image::open_file(const char *file_path, bool verify,
+                                                                  std::string *error_message) {
+  construct_helper_t helper;
+  std::shared_ptr<ac_automation_dfa_image> ret = std::make_shared<ac_automation_dfa_image>(helper);
+  if (nullptr == file_path) {
+    if (nullptr != error_message) {
+      *error_message = "file path is empty";
+    }
+    return nullptr;
+  }
+
+#if defined(_WIN32)
+  HANDLE file_handle = CreateFileA(file_path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                                   OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (INVALID_HANDLE_VALUE == file_handle) {
+    if (nullptr != error_message) {
+      *error_message = "open file failed";
+    }
+    return nullptr;
+  }
+  ret->file_handle_ = file_handle;
+
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file_handle, &file_size) || file_size.QuadPart <= 0 ||
+      static_cast<unsigned long long>(file_size.QuadPart) > std::numeric_limits<uint32_t>::max()) {
+    if (nullptr != error_message) {
+      *error_message = "invalid file size";
+    }
+    return nullptr;
+  }
+
+  HANDLE mapping_handle = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (nullptr == mapping_handle) {
+    if (nullptr != error_message) {
+      *error_message = "create file mapping failed";
+    }
+    return nullptr;
+  }
+  ret->mapping_handle_ = mapping_handle;
+
+  ret->mapped_address_ = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+  ret->mapped_size_ = static_cast<size_t>(file_size.QuadPart);
+#else
+  int fd = ::open(file_path, O_RDONLY);
+  if (fd < 0) {
+    if (nullptr != error_message) {
+      *error_message = "open file failed";
+    }
+    return nullptr;
+  }
+
+  struct stat file_stat;
+  if (0 != fstat(fd, &file_stat) || file_stat.st_size <= 0 ||
+      static_cast<unsigned long long>(file_stat.st_size) > std::numeric_limits<uint32_t>::max()) {
+    ::close(fd);
+    if (nullptr != error_message) {
+      *error_message = "invalid file size";
+    }
+    return nullptr;
+  }
+
+  // 映射建立后就可以关闭文件，文件被替换(rename)后旧的映射仍然有效
+  void *address = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (MAP_FAILED != address) {
+    ret->mapped_address_ = address;
+    ret->mapped_size_ = static_cast<size_t>(file_stat.st_size);
+  }
+#endif
+
+  if (nullptr == ret->mapped_address_) {
+    if (nullptr != error_message) {
+      *error_message = "map file failed";
+    }
+    return nullptr;
+  }
+
+  if (!ret->dfa_.attach(ret->mapped_address_, ret->mapped_size_, verify)) {
+    if (nullptr != error_message) {
+      *error_message = "invalid data or version";
+    }
+    return nullptr;
+  }
+
+  return ret;
+}
+
+ac_automation_dfa_image::ptr_t ac_automation_dfa_image::create(ac_automation_dfa &&dfa) {
+  construct_helper_t helper;
+  std::shared_ptr<ac_automation_dfa_image> ret = std::make_shared<ac_automation_dfa_image>(helper);
+  ret->dfa_ = std::move(dfa);
+  return ret;
+}
+
+ac_automation_dfa_holder::ac_automation_dfa_holder() noexcept : generation_(0) {}
+
+ac_automation_dfa_holder::~ac_automation_dfa_holder() {}
+
+ac_automation_dfa_image::ptr_t ac_automation_dfa_holder::get() const noexcept {
+  lock::lock_holder<lock::spin_lock> lock_guard(lock_);
+  return image_;
+}
+
+ac_automation_dfa_image::ptr_t ac_automation_dfa_holder::exchange(ac_automation_dfa_image::ptr_t image) noexcept {
+  {
+    lock::lock_holder<lock::spin_lock> lock_guard(lock_);
+    image_.swap(image);
+  }
+  generation_.fetch_add(1, std::memory_order_acq_rel);
+
+  // 旧镜像在锁外返回，解除映射不会阻塞匹配线程
+  return image;
+}
+
+bool ac_automation_dfa_holder::reload_file(const char *file_path, bool verify, std::string *error_message) {
+  ac_automation_dfa_image::ptr_t image = ac_automation_dfa_image::open_file(file_path, verify, error_message);
+  if (!image) {
+    return false;
+  }
+
+  exchange(std::move(image));
+  return true;
+}
+
+}  // namespace string
+ATFRAMEWORK_UTILS_NAMESPACE_END
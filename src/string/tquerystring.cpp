@@ -7,187 +7,465 @@
 
 #include "string/tquerystring.h"
 
+#include "algorithm/xxh3_hash.h"
+
+#include "algorithm/bit.h"
+#include "common/cpu_features.h"
+
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+#  include <immintrin.h>
+#endif
+
 ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
 namespace uri {
-using uri_map_type = bool[256];
+namespace {
+/**
+ * @brief 字节分类表
+ * @note nibble_masks 用于SIMD查表: 低4位查出高4位(0-7)的位图，高4位为8-15的字节都不在集合中
+ */
+struct uri_byte_set_t {
+  bool contains[256];
+  uint8_t nibble_masks[16];
+
+  void add(unsigned char c) noexcept {
+    contains[c] = true;
+    if (c < 0x80) {
+      nibble_masks[c & 0x0F] |= static_cast<uint8_t>(1 << (c >> 4));
+    }
+  }
+
+  void add(const char *chars) noexcept {
+    for (; *chars; ++chars) {
+      add(static_cast<unsigned char>(*chars));
+    }
+  }
+};
 
-static uri_map_type g_raw_url_map = {false};
-static uri_map_type g_uri_map = {false};
-static uri_map_type g_uri_component_map = {false};
+struct uri_codec_table_t {
+  // 不需要转义的字节，下标为 uri_codec_t
+  uri_byte_set_t safe[4];
+  unsigned char hex_value[256];
+  char hex_char[16];
+
+  uri_codec_table_t() noexcept {
+    memset(safe, 0, sizeof(safe));
+    memset(hex_value, 0, sizeof(hex_value));
+
+    for (size_t i = 0; i < 4; ++i) {
+      // RFC 3986
+      for (int c = 0; c < 26; ++c) {
+        safe[i].add(static_cast<unsigned char>('a' + c));
+        safe[i].add(static_cast<unsigned char>('A' + c));
+      }
+      for (int c = 0; c < 10; ++c) {
+        safe[i].add(static_cast<unsigned char>('0' + c));
+      }
+      safe[i].add("-_.");
+    }
 
-// RFC 3986
-static void _init_raw_url_map(uri_map_type &uri_map) {
-  if (uri_map[static_cast<unsigned char>('0')]) return;
+    safe[static_cast<size_t>(uri_codec_t::kUriComponent)].add("!~*'()");
+    safe[static_cast<size_t>(uri_codec_t::kUri)].add("!~*'()");
+    safe[static_cast<size_t>(uri_codec_t::kUri)].add(";/?:@&=+$,#");
 
-  for (int i = 0; i < 26; ++i) {
-    uri_map['a' + i] = uri_map['A' + i] = true;
+    for (int i = 0; i < 10; i++) {
+      hex_char[i] = static_cast<char>('0' + i);
+      hex_value['0' + i] = static_cast<unsigned char>(i);
+    }
+    for (int i = 10; i < 16; i++) {
+      hex_char[i] = static_cast<char>('A' - 10 + i);
+      hex_value['A' - 10 + i] = hex_value['a' - 10 + i] = static_cast<unsigned char>(i);
+    }
   }
+};
+
+static const uri_codec_table_t &_get_uri_codec_table() noexcept {
+  static uri_codec_table_t ret;
+  return ret;
+}
 
-  for (int i = 0; i < 10; ++i) {
-    uri_map['0' + i] = true;
+// 返回从 from 开始第一个不在 set 中的字节位置，没有时返回 sz
+static size_t _find_first_not_of_scalar(const uri_byte_set_t &set, const unsigned char *data, size_t from,
+                                        size_t sz) noexcept {
+  for (; from < sz; ++from) {
+    if (!set.contains[data[from]]) {
+      break;
+    }
   }
+  return from;
+}
 
-  // -_.
-  const unsigned char spec_chars[] = "-_.";
-  for (int i = 0; spec_chars[i]; ++i) {
-    uri_map[spec_chars[i]] = true;
+// 返回从 from 开始第一个等于 c1 或 c2 的字节位置，没有时返回 sz
+static size_t _find_first_of_scalar(unsigned char c1, unsigned char c2, const unsigned char *data, size_t from,
+                                    size_t sz) noexcept {
+  for (; from < sz; ++from) {
+    if (data[from] == c1 || data[from] == c2) {
+      break;
+    }
   }
+  return from;
 }
 
-static void _init_uri_component_map(uri_map_type &uri_map) {
-  if (uri_map[static_cast<unsigned char>('0')]) return;
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("ssse3")
+static size_t _find_first_not_of_ssse3(const uri_byte_set_t &set, const unsigned char *data, size_t from,
+                                       size_t sz) noexcept {
+  const __m128i low_table = _mm_loadu_si128(reinterpret_cast<const __m128i *>(set.nibble_masks));
+  // 高4位为8-15时位图为0
+  const __m128i high_table = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, static_cast<char>(-128), 0, 0, 0, 0, 0, 0, 0, 0);
+  const __m128i nibble_mask = _mm_set1_epi8(0x0F);
+  const __m128i zero = _mm_setzero_si128();
+
+  for (; from + 16 <= sz; from += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + from));
+    __m128i low = _mm_shuffle_epi8(low_table, _mm_and_si128(v, nibble_mask));
+    __m128i high = _mm_shuffle_epi8(high_table, _mm_and_si128(_mm_srli_epi16(v, 4), nibble_mask));
+    uint32_t unsafe = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(low, high), zero)));
+    if (0 != unsafe) {
+      return from + static_cast<size_t>(bit::countr_zero(unsafe));
+    }
+  }
 
-  _init_raw_url_map(uri_map);
+  return _find_first_not_of_scalar(set, data, from, sz);
+}
 
-  // -_.!~*'()
-  const unsigned char spec_chars[] = "!~*'()";
-  for (int i = 0; spec_chars[i]; ++i) {
-    uri_map[spec_chars[i]] = true;
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("ssse3")
+static size_t _find_first_of_ssse3(unsigned char c1, unsigned char c2, const unsigned char *data, size_t from,
+                                   size_t sz) noexcept {
+  const __m128i v1 = _mm_set1_epi8(static_cast<char>(c1));
+  const __m128i v2 = _mm_set1_epi8(static_cast<char>(c2));
+
+  for (; from + 16 <= sz; from += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + from));
+    __m128i matched = _mm_or_si128(_mm_cmpeq_epi8(v, v1), _mm_cmpeq_epi8(v, v2));
+    uint32_t found = static_cast<uint32_t>(_mm_movemask_epi8(matched));
+    if (0 != found) {
+      return from + static_cast<size_t>(bit::countr_zero(found));
+    }
   }
-}
 
-static void _init_uri_map(uri_map_type &uri_map) {
-  if (uri_map[static_cast<unsigned char>('0')]) return;
+  return _find_first_of_scalar(c1, c2, data, from, sz);
+}
+#endif
+
+static size_t _find_first_not_of(const uri_byte_set_t &set, const unsigned char *data, size_t from,
+                                 size_t sz) noexcept {
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+  static const bool has_ssse3 = platform::get_cpu_features().has_ssse3;
+  if (has_ssse3) {
+    return _find_first_not_of_ssse3(set, data, from, sz);
+  }
+#endif
+  return _find_first_not_of_scalar(set, data, from, sz);
+}
 
-  _init_uri_component_map(uri_map);
-  // ;/?:@&=+$,#
-  const unsigned char spec_chars[] = ";/?:@&=+$,#";
-  for (int i = 0; spec_chars[i]; ++i) {
-    uri_map[spec_chars[i]] = true;
+static size_t _find_first_of(unsigned char c1, unsigned char c2, const unsigned char *data, size_t from,
+                             size_t sz) noexcept {
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+  static const bool has_ssse3 = platform::get_cpu_features().has_ssse3;
+  if (has_ssse3) {
+    return _find_first_of_ssse3(c1, c2, data, from, sz);
   }
+#endif
+  return _find_first_of_scalar(c1, c2, data, from, sz);
 }
 
-static std::string _encode_uri(uri_map_type &uri_map, const char *data, size_t sz, bool like_php) {
-  std::string ret;
-  ret.reserve(sz);
+static size_t _encoded_size(uri_codec_t codec, const unsigned char *data, size_t sz) noexcept {
+  const uri_codec_table_t &table = _get_uri_codec_table();
+  const uri_byte_set_t &safe = table.safe[static_cast<size_t>(codec)];
+  size_t ret = sz;
+  for (size_t i = _find_first_not_of(safe, data, 0, sz); i < sz; i = _find_first_not_of(safe, data, i + 1, sz)) {
+    if (uri_codec_t::kUrl != codec || ' ' != data[i]) {
+      ret += 2;
+    }
+  }
+  return ret;
+}
 
-  while (sz--) {
-    unsigned char data_uc = static_cast<unsigned char>(*data);
+// output 必须有 _encoded_size 的长度
+static void _encode_uri(uri_codec_t codec, char *output, const unsigned char *data, size_t sz) noexcept {
+  const uri_codec_table_t &table = _get_uri_codec_table();
+  const uri_byte_set_t &safe = table.safe[static_cast<size_t>(codec)];
+
+  size_t i = 0;
+  while (i < sz) {
+    // 不需要转义的部分整段复制
+    size_t safe_end = _find_first_not_of(safe, data, i, sz);
+    if (safe_end > i) {
+      memcpy(output, data + i, safe_end - i);
+      output += safe_end - i;
+    }
+    if (safe_end >= sz) {
+      break;
+    }
 
-    if (uri_map[data_uc]) {
-      ret += *data;
-    } else if (like_php && ' ' == data_uc) {
-      ret += '+';
+    unsigned char c = data[safe_end];
+    if (uri_codec_t::kUrl == codec && ' ' == c) {
+      *output++ = '+';
     } else {
-      ret += '%';
-      static char hex_char_map[16] = {0};
-      // 初始化16进制表
-      if (0 == hex_char_map[0]) {
-        for (int i = 0; i < 10; i++) {
-          hex_char_map[i] = static_cast<char>('0' + i);
-        }
-
-        for (int i = 10; i < 16; i++) {
-          hex_char_map[i] = static_cast<char>('A' - 10 + i);
-        }
-      }
-
+      *output++ = '%';
       // 转义前4位
-      ret += hex_char_map[data_uc >> 4];
+      *output++ = table.hex_char[c >> 4];
       // 转义后4位
-      ret += hex_char_map[data_uc & 0x0F];
+      *output++ = table.hex_char[c & 0x0F];
     }
-
-    ++data;
+    i = safe_end + 1;
   }
-
-  return ret;
 }
 
-static std::string _decode_uri(const char *data, size_t sz, bool like_php) {
-  std::string ret;
-
-  sz = sz ? sz : strlen(data);
-  static unsigned char hex_char_map[256] = {0};
+static unsigned char _decode_special_char(uri_codec_t codec) noexcept {
+  // 只有 application/x-www-form-urlencoded 把 + 解码为空格
+  return uri_codec_t::kUrl == codec ? static_cast<unsigned char>('+') : static_cast<unsigned char>('%');
+}
 
-  // 初始化字符表
-  if (0 == hex_char_map[static_cast<unsigned char>('A')]) {
-    for (int i = 0; i < 10; i++) {
-      hex_char_map['0' + i] = static_cast<unsigned char>(i);
+static size_t _decoded_size(uri_codec_t codec, const unsigned char *data, size_t sz) noexcept {
+  size_t ret = sz;
+  unsigned char special = _decode_special_char(codec);
+  for (size_t i = _find_first_of('%', special, data, 0, sz); i < sz; i = _find_first_of('%', special, data, i, sz)) {
+    // %后不足2个字符时保持原样
+    if ('%' == data[i] && i + 2 < sz) {
+      ret -= 2;
+      i += 3;
+    } else {
+      ++i;
     }
+  }
+  return ret;
+}
 
-    for (int i = 10; i < 16; i++) {
-      hex_char_map['A' - 10 + i] = hex_char_map['a' - 10 + i] = static_cast<unsigned char>(i);
+// output 必须有 _decoded_size 的长度
+static void _decode_uri(uri_codec_t codec, char *output, const unsigned char *data, size_t sz) noexcept {
+  const uri_codec_table_t &table = _get_uri_codec_table();
+  unsigned char special = _decode_special_char(codec);
+
+  size_t i = 0;
+  while (i < sz) {
+    size_t plain_end = _find_first_of('%', special, data, i, sz);
+    if (plain_end > i) {
+      memcpy(output, data + i, plain_end - i);
+      output += plain_end - i;
+    }
+    if (plain_end >= sz) {
+      break;
     }
-  }
 
-  while (sz--) {
-    if (like_php && '+' == *data) {
-      ret += ' ';
-    } else if (*data != '%' || sz < 2) {
-      ret += *data;
+    if ('%' != data[plain_end]) {
+      *output++ = ' ';
+      i = plain_end + 1;
+    } else if (plain_end + 2 >= sz) {
+      *output++ = '%';
+      i = plain_end + 1;
     } else {
-      const unsigned char high_c = static_cast<unsigned char>(data[1]);
-      const unsigned char low_c = static_cast<unsigned char>(data[2]);
-      ret += static_cast<char>((hex_char_map[high_c] << 4) + hex_char_map[low_c]);
-      data += 2;
-      sz -= 2;
+      *output++ = static_cast<char>((table.hex_value[data[plain_end + 1]] << 4) + table.hex_value[data[plain_end + 2]]);
+      i = plain_end + 3;
     }
-
-    ++data;
   }
+}
 
+static std::string _encode_uri(uri_codec_t codec, const char *data, size_t sz) {
+  std::string ret;
+  encode_to(codec, ret, nostd::string_view(data, sz ? sz : strlen(data)));
   return ret;
 }
 
-ATFRAMEWORK_UTILS_API std::string encode_uri(const char *content, size_t sz) {
-  _init_uri_map(g_uri_map);
-  sz = sz ? sz : strlen(content);
+static std::string _decode_uri(uri_codec_t codec, const char *data, size_t sz) {
+  std::string ret;
+  decode_to(codec, ret, nostd::string_view(data, sz ? sz : strlen(data)));
+  return ret;
+}
+}  // namespace
 
-  return _encode_uri(g_uri_map, content, sz, false);
+ATFRAMEWORK_UTILS_API std::string encode_uri(const char *content, size_t sz) {
+  return _encode_uri(uri_codec_t::kUri, content, sz);
 }
 
 ATFRAMEWORK_UTILS_API std::string decode_uri(const char *uri, size_t sz) {
-  sz = sz ? sz : strlen(uri);
-  return _decode_uri(uri, sz, false);
+  return _decode_uri(uri_codec_t::kUri, uri, sz);
 }
 
 ATFRAMEWORK_UTILS_API std::string encode_uri_component(const char *content, size_t sz) {
-  _init_uri_component_map(g_uri_component_map);
-  sz = sz ? sz : strlen(content);
-
-  return _encode_uri(g_uri_component_map, content, sz, false);
+  return _encode_uri(uri_codec_t::kUriComponent, content, sz);
 }
 
 ATFRAMEWORK_UTILS_API std::string decode_uri_component(const char *uri, size_t sz) {
-  sz = sz ? sz : strlen(uri);
-  return _decode_uri(uri, sz, false);
+  return _decode_uri(uri_codec_t::kUriComponent, uri, sz);
 }
 
 // ==== RFC 3986 ====
 ATFRAMEWORK_UTILS_API std::string raw_encode_url(const char *content, size_t sz) {
-  _init_raw_url_map(g_raw_url_map);
-  sz = sz ? sz : strlen(content);
-
-  return _encode_uri(g_raw_url_map, content, sz, false);
+  return _encode_uri(uri_codec_t::kRawUrl, content, sz);
 }
 
 ATFRAMEWORK_UTILS_API std::string raw_decode_url(const char *uri, size_t sz) {
-  sz = sz ? sz : strlen(uri);
-  return _decode_uri(uri, sz, false);
+  return _decode_uri(uri_codec_t::kRawUrl, uri, sz);
 }
 
 // ==== application/x-www-form-urlencoded ====
 ATFRAMEWORK_UTILS_API std::string encode_url(const char *content, size_t sz) {
-  _init_raw_url_map(g_raw_url_map);
-  sz = sz ? sz : strlen(content);
-
-  return _encode_uri(g_raw_url_map, content, sz, true);
+  return _encode_uri(uri_codec_t::kUrl, content, sz);
 }
 
 ATFRAMEWORK_UTILS_API std::string decode_url(const char *uri, size_t sz) {
-  sz = sz ? sz : strlen(uri);
-  return _decode_uri(uri, sz, true);
+  return _decode_uri(uri_codec_t::kUrl, uri, sz);
+}
+
+ATFRAMEWORK_UTILS_API size_t encoded_size(uri_codec_t codec, nostd::string_view content) noexcept {
+  return _encoded_size(codec, reinterpret_cast<const unsigned char *>(content.data()), content.size());
+}
+
+ATFRAMEWORK_UTILS_API size_t encode_to(uri_codec_t codec, char *output, size_t output_size,
+                                       nostd::string_view content) noexcept {
+  const unsigned char *data = reinterpret_cast<const unsigned char *>(content.data());
+  size_t ret = _encoded_size(codec, data, content.size());
+  if (nullptr != output && ret <= output_size) {
+    _encode_uri(codec, output, data, content.size());
+  }
+  return ret;
+}
+
+ATFRAMEWORK_UTILS_API void encode_to(uri_codec_t codec, std::string &output, nostd::string_view content) {
+  const unsigned char *data = reinterpret_cast<const unsigned char *>(content.data());
+  size_t offset = output.size();
+  output.resize(offset + _encoded_size(codec, data, content.size()));
+  _encode_uri(codec, &output[0] + offset, data, content.size());
+}
+
+ATFRAMEWORK_UTILS_API size_t decoded_size(uri_codec_t codec, nostd::string_view uri) noexcept {
+  return _decoded_size(codec, reinterpret_cast<const unsigned char *>(uri.data()), uri.size());
+}
+
+ATFRAMEWORK_UTILS_API size_t decode_to(uri_codec_t codec, char *output, size_t output_size,
+                                       nostd::string_view uri) noexcept {
+  const unsigned char *data = reinterpret_cast<const unsigned char *>(uri.data());
+  size_t ret = _decoded_size(codec, data, uri.size());
+  if (nullptr != output && ret <= output_size) {
+    _decode_uri(codec, output, data, uri.size());
+  }
+  return ret;
+}
+
+ATFRAMEWORK_UTILS_API void decode_to(uri_codec_t codec, std::string &output, nostd::string_view uri) {
+  const unsigned char *data = reinterpret_cast<const unsigned char *>(uri.data());
+  size_t offset = output.size();
+  output.resize(offset + _decoded_size(codec, data, uri.size()));
+  _decode_uri(codec, &output[0] + offset, data, uri.size());
+}
+
+ATFRAMEWORK_UTILS_API query_string_tokenizer::query_string_tokenizer(nostd::string_view content,
+                                                                     nostd::string_view spliter) noexcept
+    : content_(content) {
+  memset(spliter_map_, 0, sizeof(spliter_map_));
+  for (size_t i = 0; i < spliter.size(); ++i) {
+    spliter_map_[static_cast<unsigned char>(spliter[i])] = true;
+  }
+}
+
+ATFRAMEWORK_UTILS_API bool query_string_tokenizer::next(token_t &output) noexcept {
+  if (content_.empty()) {
+    return false;
+  }
+
+  size_t len = 0;
+  while (len < content_.size() && !spliter_map_[static_cast<unsigned char>(content_[len])]) {
+    ++len;
+  }
+
+  output.record = content_.substr(0, len);
+  content_ = content_.substr(len < content_.size() ? len + 1 : len);
+
+  size_t value_start = output.record.rfind('=');
+  if (value_start == nostd::string_view::npos) {
+    output.key = output.record;
+    output.value = nostd::string_view();
+    output.has_value = false;
+  } else {
+    output.key = output.record.substr(0, value_start);
+    output.value = output.record.substr(value_start + 1);
+    output.has_value = true;
+  }
+  return true;
 }
 }  // namespace uri
 
 namespace types {
+namespace {
+static bool _parse_item_view(item_impl &item, gsl::span<const nostd::string_view> keys, size_t index,
+                             nostd::string_view value);
+
+static bool _parse_object_view(item_object &item, gsl::span<const nostd::string_view> keys, size_t index,
+                               nostd::string_view value) {
+  if (index >= keys.size()) {
+    return false;
+  }
+
+  std::string key(keys[index].data(), keys[index].size());
+  item_object::data_iterator iter = item.data_.find(key);
+  if (iter == item.data_.end()) {
+    item_impl::ptr_type ptr;
+    // 最后一级，字符串类型
+    if (index + 1 == keys.size()) {
+      ptr = std::static_pointer_cast<item_impl>(item_string::create());
+    }
+    // 倒数第二级，且最后一级key为空，数组类型
+    else if (index + 2 == keys.size() && keys[keys.size() - 1].size() == 0) {
+      ptr = std::static_pointer_cast<item_impl>(item_array::create());
+    }
+    // Object类型
+    else {
+      ptr = std::static_pointer_cast<item_impl>(item_object::create());
+    }
+
+    item.data_.insert(std::make_pair(std::move(key), ptr));
+    return _parse_item_view(*ptr, keys, index + 1, value);
+  } else {
+    return _parse_item_view(*iter->second, keys, index + 1, value);
+  }
+}
+
+// 内置类型直接使用 string_view 解码，不需要复制key列表。其他类型转换为 std::vector<std::string> 后调用 parse
+static bool _parse_item_view(item_impl &item, gsl::span<const nostd::string_view> keys, size_t index,
+                             nostd::string_view value) {
+  if (item_object *object = dynamic_cast<item_object *>(&item)) {
+    return _parse_object_view(*object, keys, index, value);
+  }
+
+  if (item_array *array = dynamic_cast<item_array *>(&item)) {
+    if (index + 1 != keys.size() || keys[index].size()) {
+      return false;
+    }
+
+    array->append(std::string(value.data(), value.size()));
+    return true;
+  }
+
+  if (item_string *str = dynamic_cast<item_string *>(&item)) {
+    str->get().assign(value.data(), value.size());
+    return true;
+  }
+
+  std::vector<std::string> input_keys;
+  input_keys.reserve(keys.size());
+  for (auto &key : keys) {
+    input_keys.push_back(std::string(key.data(), key.size()));
+  }
+  return item.parse(input_keys, index, std::string(value.data(), value.size()));
+}
+}  // namespace
+
 ATFRAMEWORK_UTILS_API item_impl::~item_impl() {}
 
 ATFRAMEWORK_UTILS_API void item_impl::append_to(std::string &target, const std::string &key,
                                                 const std::string &value) const {
-  target += uri::encode_uri_component(key.c_str(), key.size()) + "=" +
-            uri::encode_uri_component(value.c_str(), value.size()) + "&";
+  // 预先计算好长度，整条记录只扩容一次
+  size_t key_size = uri::encoded_size(uri::uri_codec_t::kUriComponent, key);
+  size_t value_size = uri::encoded_size(uri::uri_codec_t::kUriComponent, value);
+  size_t offset = target.size();
+  target.resize(offset + key_size + value_size + 2);
+
+  char *output = &target[0] + offset;
+  uri::encode_to(uri::uri_codec_t::kUriComponent, output, key_size, key);
+  output[key_size] = '=';
+  uri::encode_to(uri::uri_codec_t::kUriComponent, output + key_size + 1, value_size, value);
+  output[key_size + value_size + 1] = '&';
 }
 
 // 字符串类型
@@ -464,75 +742,70 @@ ATFRAMEWORK_UTILS_API std::string tquerystring::to_string(const char *prefix) co
 }
 
 ATFRAMEWORK_UTILS_API bool tquerystring::decode(const char *content, size_t sz) {
-  bool decl_map[256] = {false}, ret = true;
-  size_t len = 0, is_decl;
+  bool ret = true;
   sz = sz ? sz : strlen(content);
 
-  for (size_t i = 0; i < spliter_.size(); ++i) {
-    decl_map[static_cast<unsigned char>(spliter_[i])] = true;
-  }
-
-  while (sz) {
-    for (is_decl = 0, len = 0; len < sz; ++len) {
-      if (decl_map[static_cast<unsigned char>(*(content + len))]) {
-        is_decl = 1;
-        break;
-      }
-    }
-
-    ret = decode_record(content, len);
-
-    content += len + is_decl;
-    sz -= len + is_decl;
+  uri::query_string_tokenizer tokenizer(nostd::string_view(content, sz), spliter_);
+  uri::query_string_tokenizer::token_t token;
+  while (tokenizer.next(token)) {
+    ret = decode_record(token.record.data(), token.record.size());
   }
 
   return ret;
 }
 
 ATFRAMEWORK_UTILS_API bool tquerystring::decode_record(const char *content, size_t sz) {
-  std::string seg, value, origin_val;
-  std::vector<std::string> input_keys;
-  origin_val.assign(content, sz);
-  seg.reserve(sz);
+  nostd::string_view record(content, sz);
+  nostd::string_view raw_key = record;
+  std::string value, origin_val;
 
   // 计算值
-  size_t val_start = origin_val.find_last_of('=');
-  if (val_start != origin_val.npos) {
-    value = origin_val.substr(val_start + 1);
-    value = uri::decode_uri_component(value.data(), value.size());
-    origin_val = origin_val.substr(0, val_start);
+  size_t val_start = record.rfind('=');
+  if (val_start != nostd::string_view::npos) {
+    uri::decode_uri_component_to(value, record.substr(val_start + 1));
+    raw_key = record.substr(0, val_start);
   }
 
-  origin_val = uri::decode_uri_component(origin_val.data(), origin_val.size());
+  uri::decode_uri_component_to(origin_val, raw_key);
 
-  // 计算key列表
+  // 计算key列表，同一层的key可能由多段拼接而成(比如 a[b]c[d] 中的 bc)，所以拼接到 key_buffer 中再引用
+  std::string key_buffer;
+  key_buffer.reserve(origin_val.size());
+  std::vector<std::pair<size_t, size_t>> key_ranges;
+  size_t seg_start = 0;
   for (sz = 0; sz < origin_val.size(); ++sz) {
     while (sz < origin_val.size() && origin_val[sz] == ']') {
       ++sz;
     }
 
     while (sz < origin_val.size() && origin_val[sz] != '[') {
-      seg += origin_val[sz];
+      key_buffer += origin_val[sz];
       ++sz;
     }
 
-    input_keys.push_back(seg);
-    seg.clear();
+    key_ranges.push_back(std::make_pair(seg_start, key_buffer.size() - seg_start));
+    seg_start = key_buffer.size();
 
     if (sz >= origin_val.size()) {
       break;
     }
     for (++sz; sz < origin_val.size() && origin_val[sz] != ']'; ++sz) {
-      seg += origin_val[sz];
+      key_buffer += origin_val[sz];
     }
   }
 
-  if (seg.size() > 0) {
-    input_keys.push_back(seg);
-    return parse(input_keys, 0, value);
-  } else {
+  if (key_buffer.size() <= seg_start) {
     return false;
   }
+  key_ranges.push_back(std::make_pair(seg_start, key_buffer.size() - seg_start));
+
+  std::vector<nostd::string_view> input_keys;
+  input_keys.reserve(key_ranges.size());
+  for (auto &key_range : key_ranges) {
+    input_keys.push_back(nostd::string_view(key_buffer.data() + key_range.first, key_range.second));
+  }
+  return types::_parse_object_view(*this, gsl::span<const nostd::string_view>(input_keys.data(), input_keys.size()), 0,
+                                   value);
 }
 
 ATFRAMEWORK_UTILS_API bool tquerystring::encode(std::string &output, const char *) const {
@@ -568,5 +841,325 @@ ATFRAMEWORK_UTILS_API types::item_array::ptr_type tquerystring::create_array() {
 ATFRAMEWORK_UTILS_API types::item_object::ptr_type tquerystring::create_object() {
   return types::item_object::create();
 };
+
+// ==== tquerystring_arena ====
+struct tquerystring_arena::block_t {
+  block_t *next;
+  size_t capacity;
+  size_t used;
+};
+
+namespace {
+static inline size_t _arena_child_slot(nostd::string_view key, size_t mask) noexcept {
+  return static_cast<size_t>(hash::xxh3_64(key.data(), key.size())) & mask;
+}
+}  // namespace
+
+ATFRAMEWORK_UTILS_API const tquerystring_arena::node_t *tquerystring_arena::node_t::get(
+    nostd::string_view child_key) const noexcept {
+  if (nullptr != child_index) {
+    for (size_t slot = _arena_child_slot(child_key, child_index_mask); nullptr != child_index[slot];
+         slot = (slot + 1) & child_index_mask) {
+      if (child_index[slot]->key == child_key) {
+        return child_index[slot];
+      }
+    }
+    return nullptr;
+  }
+
+  for (const node_t *child = first_child; nullptr != child; child = child->next_sibling) {
+    if (child->key == child_key) {
+      return child;
+    }
+  }
+  return nullptr;
+}
+
+ATFRAMEWORK_UTILS_API const tquerystring_arena::node_t *tquerystring_arena::node_t::at(size_t index) const noexcept {
+  const node_t *child = first_child;
+  for (; nullptr != child && index > 0; --index) {
+    child = child->next_sibling;
+  }
+  return child;
+}
+
+ATFRAMEWORK_UTILS_API tquerystring_arena::tquerystring_arena(size_t block_size, nostd::string_view spliter)
+    : blocks_(nullptr), block_size_(block_size < 256 ? 256 : block_size), spliter_(spliter.data(), spliter.size()) {
+  root_.type = types::ITEM_TYPE_OBJECT;
+  root_.first_child = nullptr;
+  root_.last_child = nullptr;
+  root_.next_sibling = nullptr;
+  root_.child_count = 0;
+  root_.child_index = nullptr;
+  root_.child_index_mask = 0;
+}
+
+ATFRAMEWORK_UTILS_API tquerystring_arena::~tquerystring_arena() {
+  clear();
+  if (nullptr != blocks_) {
+    delete[] reinterpret_cast<char *>(blocks_);
+    blocks_ = nullptr;
+  }
+}
+
+ATFRAMEWORK_UTILS_API bool tquerystring_arena::decode(nostd::string_view content) {
+  bool ret = true;
+  uri::query_string_tokenizer tokenizer(content, spliter_);
+  uri::query_string_tokenizer::token_t token;
+  while (tokenizer.next(token)) {
+    ret = decode_record(token.record);
+  }
+
+  return ret;
+}
+
+ATFRAMEWORK_UTILS_API void tquerystring_arena::clear() noexcept {
+  // 保留一块普通大小的内存，单独分配的大块全部释放
+  block_t *kept = nullptr;
+  while (nullptr != blocks_) {
+    block_t *next = blocks_->next;
+    if (nullptr == kept && blocks_->capacity == block_size_) {
+      kept = blocks_;
+      kept->next = nullptr;
+      kept->used = 0;
+    } else {
+      delete[] reinterpret_cast<char *>(blocks_);
+    }
+    blocks_ = next;
+  }
+  blocks_ = kept;
+
+  root_.first_child = nullptr;
+  root_.last_child = nullptr;
+  root_.child_count = 0;
+  root_.child_index = nullptr;
+  root_.child_index_mask = 0;
+}
+
+ATFRAMEWORK_UTILS_API size_t tquerystring_arena::get_allocated_size() const noexcept {
+  size_t ret = 0;
+  for (block_t *block = blocks_; nullptr != block; block = block->next) {
+    ret += block->capacity;
+  }
+  return ret;
+}
+
+void *tquerystring_arena::allocate(size_t sz, size_t align) {
+  if (nullptr != blocks_) {
+    size_t offset = (blocks_->used + align - 1) / align * align;
+    if (offset + sz <= blocks_->capacity) {
+      blocks_->used = offset + sz;
+      return reinterpret_cast<char *>(blocks_ + 1) + offset;
+    }
+  }
+
+  // 大块内存单独分配并放在当前块后面，不浪费当前块的剩余空间
+  bool standalone = sz > block_size_ / 2 && nullptr != blocks_;
+  size_t capacity = (standalone || sz + align > block_size_) ? sz + align : block_size_;
+  block_t *block = reinterpret_cast<block_t *>(new char[sizeof(block_t) + capacity]);
+  block->capacity = capacity;
+  block->used = 0;
+  if (standalone) {
+    block->next = blocks_->next;
+    blocks_->next = block;
+  } else {
+    block->next = blocks_;
+    blocks_ = block;
+  }
+
+  size_t offset = (align - reinterpret_cast<uintptr_t>(block + 1) % align) % align;
+  block->used = offset + sz;
+  return reinterpret_cast<char *>(block + 1) + offset;
+}
+
+tquerystring_arena::node_t *tquerystring_arena::create_node(types::ITEM_TYPE type, nostd::string_view key) {
+  node_t *ret = reinterpret_cast<node_t *>(allocate(sizeof(node_t), alignof(node_t)));
+  ret->type = type;
+  ret->key = key;
+  ret->value = nostd::string_view();
+  ret->first_child = nullptr;
+  ret->last_child = nullptr;
+  ret->next_sibling = nullptr;
+  ret->child_count = 0;
+  ret->child_index = nullptr;
+  ret->child_index_mask = 0;
+  return ret;
+}
+
+void tquerystring_arena::append_child(node_t &parent, node_t *child) {
+  if (nullptr == parent.last_child) {
+    parent.first_child = child;
+  } else {
+    parent.last_child->next_sibling = child;
+  }
+  parent.last_child = child;
+  ++parent.child_count;
+
+  // 数组元素没有key，不需要索引
+  if (types::ITEM_TYPE_ARRAY == parent.type) {
+    return;
+  }
+
+  if (nullptr == parent.child_index) {
+    if (parent.child_count >= CHILD_INDEX_MIN_COUNT) {
+      rebuild_child_index(parent, CHILD_INDEX_MIN_COUNT * 4);
+    }
+    return;
+  }
+
+  // 负载因子不超过1/2，扩容时旧的索引留在内存池中，随 clear 一起释放
+  if (parent.child_count * 2 > parent.child_index_mask + 1) {
+    rebuild_child_index(parent, (parent.child_index_mask + 1) * 2);
+    return;
+  }
+
+  size_t slot = _arena_child_slot(child->key, parent.child_index_mask);
+  while (nullptr != parent.child_index[slot]) {
+    slot = (slot + 1) & parent.child_index_mask;
+  }
+  parent.child_index[slot] = child;
+}
+
+void tquerystring_arena::rebuild_child_index(node_t &parent, size_t slot_count) {
+  node_t **index = reinterpret_cast<node_t **>(allocate(sizeof(node_t *) * slot_count, alignof(node_t *)));
+  memset(index, 0, sizeof(node_t *) * slot_count);
+
+  size_t mask = slot_count - 1;
+  for (node_t *child = parent.first_child; nullptr != child; child = child->next_sibling) {
+    size_t slot = _arena_child_slot(child->key, mask);
+    while (nullptr != index[slot]) {
+      slot = (slot + 1) & mask;
+    }
+    index[slot] = child;
+  }
+
+  parent.child_index = index;
+  parent.child_index_mask = mask;
+}
+
+nostd::string_view tquerystring_arena::decode_component(nostd::string_view raw) {
+  // 没有转义字符时直接引用原始内容
+  size_t sz = uri::decoded_size(uri::uri_codec_t::kUriComponent, raw);
+  if (sz == raw.size()) {
+    return raw;
+  }
+
+  char *buffer = reinterpret_cast<char *>(allocate(sz, 1));
+  uri::decode_to(uri::uri_codec_t::kUriComponent, buffer, sz, raw);
+  return nostd::string_view(buffer, sz);
+}
+
+bool tquerystring_arena::decode_record(nostd::string_view record) {
+  nostd::string_view raw_key = record;
+  nostd::string_view value;
+
+  size_t val_start = record.rfind('=');
+  if (val_start != nostd::string_view::npos) {
+    value = decode_component(record.substr(val_start + 1));
+    raw_key = record.substr(0, val_start);
+  }
+
+  nostd::string_view origin_val = decode_component(raw_key);
+
+  // 和 tquerystring::decode_record 的拆分规则一致。同一层的key由多段拼接而成时(比如 a[b]c[d] 中的 bc)复制到内存池
+  key_cache_.clear();
+  const char *seg_data = nullptr;
+  size_t seg_size = 0;
+  auto append_segment = [this, &seg_data, &seg_size](const char *data, size_t sz) {
+    if (0 == sz) {
+      return;
+    }
+    if (0 == seg_size) {
+      seg_data = data;
+    } else if (seg_data + seg_size != data) {
+      char *buffer = reinterpret_cast<char *>(allocate(seg_size + sz, 1));
+      memcpy(buffer, seg_data, seg_size);
+      memcpy(buffer + seg_size, data, sz);
+      seg_data = buffer;
+      seg_size += sz;
+      return;
+    }
+    seg_size += sz;
+  };
+
+  size_t pos = 0;
+  for (; pos < origin_val.size(); ++pos) {
+    while (pos < origin_val.size() && origin_val[pos] == ']') {
+      ++pos;
+    }
+
+    size_t start = pos;
+    while (pos < origin_val.size() && origin_val[pos] != '[') {
+      ++pos;
+    }
+    append_segment(origin_val.data() + start, pos - start);
+
+    key_cache_.push_back(nostd::string_view(seg_data, seg_size));
+    seg_data = nullptr;
+    seg_size = 0;
+
+    if (pos >= origin_val.size()) {
+      break;
+    }
+
+    start = pos + 1;
+    for (++pos; pos < origin_val.size() && origin_val[pos] != ']'; ++pos) {
+    }
+    append_segment(origin_val.data() + start, pos - start);
+  }
+
+  if (0 == seg_size) {
+    return false;
+  }
+  key_cache_.push_back(nostd::string_view(seg_data, seg_size));
+
+  return parse(root_, gsl::span<const nostd::string_view>(key_cache_.data(), key_cache_.size()), 0, value);
+}
+
+bool tquerystring_arena::parse(node_t &parent, gsl::span<const nostd::string_view> keys, size_t index,
+                               nostd::string_view value) {
+  if (index >= keys.size()) {
+    return false;
+  }
+
+  node_t *child = const_cast<node_t *>(parent.get(keys[index]));
+  if (nullptr == child) {
+    // 最后一级，字符串类型
+    if (index + 1 == keys.size()) {
+      child = create_node(types::ITEM_TYPE_STRING, keys[index]);
+    }
+    // 倒数第二级，且最后一级key为空，数组类型
+    else if (index + 2 == keys.size() && keys[keys.size() - 1].empty()) {
+      child = create_node(types::ITEM_TYPE_ARRAY, keys[index]);
+    }
+    // Object类型
+    else {
+      child = create_node(types::ITEM_TYPE_OBJECT, keys[index]);
+    }
+
+    append_child(parent, child);
+  }
+
+  ++index;
+  switch (child->type) {
+    case types::ITEM_TYPE_STRING: {
+      child->value = value;
+      return true;
+    }
+    case types::ITEM_TYPE_ARRAY: {
+      if (index + 1 != keys.size() || !keys[index].empty()) {
+        return false;
+      }
+
+      node_t *element = create_node(types::ITEM_TYPE_STRING, nostd::string_view());
+      element->value = value;
+      append_child(*child, element);
+      return true;
+    }
+    default: {
+      return parse(*child, keys, index, value);
+    }
+  }
+}
 ATFRAMEWORK_UTILS_NAMESPACE_END
 
@@ -0,0 +1,784 @@
+// Copyright 2026 atframework
+//
+// Licensed under the MIT licenses.
+
+#include "string/utf8_utils.h"
+
+#include <cstring>
+
+#include "algorithm/bit.h"
+#include "common/cpu_features.h"
+
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+#  include <immintrin.h>
+#endif
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace string {
+
+namespace {
+// ============ 标量实现 ============
+
+static size_t _utf8_find_invalid_scalar(const unsigned char *s, size_t from, size_t sz) noexcept {
+  size_t i = from;
+  while (i < sz) {
+    unsigned char c = s[i];
+    if (c < 0x80) {
+      ++i;
+      continue;
+    }
+
+    if (c < 0xC2) {
+      // 后续字节或者过长的2字节编码
+      return i;
+    }
+
+    if (c < 0xE0) {
+      if (i + 1 >= sz || 0x80 != (s[i + 1] & 0xC0)) {
+        return i;
+      }
+      i += 2;
+    } else if (c < 0xF0) {
+      if (i + 2 >= sz) {
+        return i;
+      }
+      unsigned char c1 = s[i + 1];
+      if (0x80 != (c1 & 0xC0) || (0xE0 == c && c1 < 0xA0) || (0xED == c && c1 >= 0xA0) ||
+          0x80 != (s[i + 2] & 0xC0)) {
+        return i;
+      }
+      i += 3;
+    } else if (c < 0xF5) {
+      if (i + 3 >= sz) {
+        return i;
+      }
+      unsigned char c1 = s[i + 1];
+      if (0x80 != (c1 & 0xC0) || (0xF0 == c && c1 < 0x90) || (0xF4 == c && c1 >= 0x90) ||
+          0x80 != (s[i + 2] & 0xC0) || 0x80 != (s[i + 3] & 0xC0)) {
+        return i;
+      }
+      i += 4;
+    } else {
+      return i;
+    }
+  }
+
+  return sz;
+}
+
+static size_t _utf8_count_scalar(const unsigned char *s, size_t from, size_t sz) noexcept {
+  size_t ret = 0;
+  for (size_t i = from; i < sz; ++i) {
+    if (0x80 != (s[i] & 0xC0)) {
+      ++ret;
+    }
+  }
+  return ret;
+}
+
+// 返回第 (max_code_points + 1) 个码点的开始位置，不足时返回 sz
+static size_t _utf8_truncate_scalar(const unsigned char *s, size_t from, size_t sz, size_t counted,
+                                    size_t max_code_points) noexcept {
+  for (size_t i = from; i < sz; ++i) {
+    if (0x80 != (s[i] & 0xC0)) {
+      if (counted >= max_code_points) {
+        return i;
+      }
+      ++counted;
+    }
+  }
+  return sz;
+}
+
+static size_t _utf16_length_from_utf8_scalar(const unsigned char *s, size_t from, size_t sz) noexcept {
+  size_t ret = 0;
+  for (size_t i = from; i < sz; ++i) {
+    if (0x80 != (s[i] & 0xC0)) {
+      ++ret;
+    }
+    // 4字节编码需要代理对
+    if (s[i] >= 0xF0) {
+      ++ret;
+    }
+  }
+  return ret;
+}
+
+// 输入必须已经校验过
+static uint32_t _utf8_decode_valid(const unsigned char *s, size_t &i) noexcept {
+  uint32_t c = s[i];
+  if (c < 0x80) {
+    ++i;
+  } else if (c < 0xE0) {
+    c = ((c & 0x1F) << 6) | (s[i + 1] & 0x3F);
+    i += 2;
+  } else if (c < 0xF0) {
+    c = ((c & 0x0F) << 12) | (static_cast<uint32_t>(s[i + 1] & 0x3F) << 6) | (s[i + 2] & 0x3F);
+    i += 3;
+  } else {
+    c = ((c & 0x07) << 18) | (static_cast<uint32_t>(s[i + 1] & 0x3F) << 12) |
+        (static_cast<uint32_t>(s[i + 2] & 0x3F) << 6) | (s[i + 3] & 0x3F);
+    i += 4;
+  }
+  return c;
+}
+
+static size_t _utf8_encode(uint32_t c, char *output) noexcept {
+  if (c < 0x80) {
+    output[0] = static_cast<char>(c);
+    return 1;
+  }
+  if (c < 0x800) {
+    output[0] = static_cast<char>(0xC0 | (c >> 6));
+    output[1] = static_cast<char>(0x80 | (c & 0x3F));
+    return 2;
+  }
+  if (c < 0x10000) {
+    output[0] = static_cast<char>(0xE0 | (c >> 12));
+    output[1] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+    output[2] = static_cast<char>(0x80 | (c & 0x3F));
+    return 3;
+  }
+  output[0] = static_cast<char>(0xF0 | (c >> 18));
+  output[1] = static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+  output[2] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+  output[3] = static_cast<char>(0x80 | (c & 0x3F));
+  return 4;
+}
+
+static inline bool _is_high_surrogate(uint32_t c) noexcept { return c >= 0xD800 && c < 0xDC00; }
+
+static inline bool _is_low_surrogate(uint32_t c) noexcept { return c >= 0xDC00 && c < 0xE000; }
+
+// ============ SIMD实现 ============
+
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+// 按(前一个字节高4位, 前一个字节低4位, 当前字节高4位)查表，三个结果按位与后非0表示错误
+// 错误位的定义:
+//   TOO_SHORT      = 0x01  11______ 0_______ 或 11______ 11______
+//   TOO_LONG       = 0x02  0_______ 10______
+//   OVERLONG_3     = 0x04  11100000 100_____
+//   TOO_LARGE      = 0x08  11110100 1001____ 或 11110100 101_____ 或 11110101-11111111 10______
+//   SURROGATE      = 0x10  11101101 101_____
+//   OVERLONG_2     = 0x20  1100000_ 10______
+//   TOO_LARGE_1000 = 0x40  11110101-11111111 1000____
+//   OVERLONG_4     = 0x40  11110000 1000____
+//   TWO_CONTS      = 0x80  10______ 10______ (是否合法取决于再往前两个字节，单独检查)
+#  define UTF8_UTILS_BYTE_1_HIGH_TABLE                                                                             \
+    0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, static_cast<char>(0x80), static_cast<char>(0x80),            \
+        static_cast<char>(0x80), static_cast<char>(0x80), 0x21, 0x01, 0x15, 0x49
+#  define UTF8_UTILS_BYTE_1_LOW_TABLE                                                                              \
+    static_cast<char>(0xE7), static_cast<char>(0xA3), static_cast<char>(0x83), static_cast<char>(0x83),          \
+        static_cast<char>(0x8B), static_cast<char>(0xCB), static_cast<char>(0xCB), static_cast<char>(0xCB),      \
+        static_cast<char>(0xCB), static_cast<char>(0xCB), static_cast<char>(0xCB), static_cast<char>(0xCB),      \
+        static_cast<char>(0xCB), static_cast<char>(0xDB), static_cast<char>(0xCB), static_cast<char>(0xCB)
+#  define UTF8_UTILS_BYTE_2_HIGH_TABLE                                                                             \
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, static_cast<char>(0xE6), static_cast<char>(0xAE),            \
+        static_cast<char>(0xBA), static_cast<char>(0xBA), 0x01, 0x01, 0x01, 0x01
+
+ATFW_UTIL_FORCEINLINE ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("ssse3") static __m128i _utf8_check_block_ssse3(
+    __m128i input, __m128i prev_input) noexcept {
+  const __m128i byte_1_high_table = _mm_setr_epi8(UTF8_UTILS_BYTE_1_HIGH_TABLE);
+  const __m128i byte_1_low_table = _mm_setr_epi8(UTF8_UTILS_BYTE_1_LOW_TABLE);
+  const __m128i byte_2_high_table = _mm_setr_epi8(UTF8_UTILS_BYTE_2_HIGH_TABLE);
+  const __m128i nibble_mask = _mm_set1_epi8(0x0F);
+
+  __m128i prev1 = _mm_alignr_epi8(input, prev_input, 15);
+  __m128i byte_1_high = _mm_shuffle_epi8(byte_1_high_table, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble_mask));
+  __m128i byte_1_low = _mm_shuffle_epi8(byte_1_low_table, _mm_and_si128(prev1, nibble_mask));
+  __m128i byte_2_high = _mm_shuffle_epi8(byte_2_high_table, _mm_and_si128(_mm_srli_epi16(input, 4), nibble_mask));
+  __m128i special_cases = _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+
+  // 前2个字节是3/4字节编码的开头或者前3个字节是4字节编码的开头时，当前字节必须是后续字节
+  __m128i prev2 = _mm_alignr_epi8(input, prev_input, 14);
+  __m128i prev3 = _mm_alignr_epi8(input, prev_input, 13);
+  __m128i is_third_byte = _mm_subs_epu8(prev2, _mm_set1_epi8(static_cast<char>(0xE0 - 1)));
+  __m128i is_fourth_byte = _mm_subs_epu8(prev3, _mm_set1_epi8(static_cast<char>(0xF0 - 1)));
+  __m128i must23 = _mm_cmpgt_epi8(_mm_or_si128(is_third_byte, is_fourth_byte), _mm_setzero_si128());
+  __m128i must23_80 = _mm_and_si128(must23, _mm_set1_epi8(static_cast<char>(0x80)));
+  return _mm_xor_si128(must23_80, special_cases);
+}
+
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("ssse3")
+static bool _utf8_validate_ssse3(const unsigned char *s, size_t sz) noexcept {
+  // 最后3个字节是多字节编码的开头时，需要下一块来补全
+  const __m128i incomplete_max =
+      _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, static_cast<char>(0xF0 - 1),
+                    static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1));
+  __m128i error = _mm_setzero_si128();
+  __m128i prev_input = _mm_setzero_si128();
+  __m128i prev_incomplete = _mm_setzero_si128();
+
+  size_t i = 0;
+  unsigned char tail[16];
+  while (i < sz) {
+    __m128i input;
+    if (i + 16 <= sz) {
+      input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+    } else {
+      // 尾部补0，未结束的多字节编码后面跟着ASCII会被检查出来
+      memset(tail, 0, sizeof(tail));
+      memcpy(tail, s + i, sz - i);
+      input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(tail));
+    }
+    i += 16;
+
+    if (0 == _mm_movemask_epi8(input)) {
+      error = _mm_or_si128(error, prev_incomplete);
+      prev_incomplete = _mm_setzero_si128();
+    } else {
+      error = _mm_or_si128(error, _utf8_check_block_ssse3(input, prev_input));
+      prev_incomplete = _mm_subs_epu8(input, incomplete_max);
+    }
+    prev_input = input;
+  }
+
+  error = _mm_or_si128(error, prev_incomplete);
+  return 0xFFFF == _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128()));
+}
+
+ATFW_UTIL_FORCEINLINE ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("avx2") static __m256i _utf8_prev_avx2(
+    __m256i input, __m256i prev_input, int n) noexcept {
+  __m256i shifted = _mm256_permute2x128_si256(prev_input, input, 0x21);
+  switch (n) {
+    case 1:
+      return _mm256_alignr_epi8(input, shifted, 15);
+    case 2:
+      return _mm256_alignr_epi8(input, shifted, 14);
+    default:
+      return _mm256_alignr_epi8(input, shifted, 13);
+  }
+}
+
+ATFW_UTIL_FORCEINLINE ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("avx2") static __m256i _utf8_check_block_avx2(
+    __m256i input, __m256i prev_input) noexcept {
+  const __m256i byte_1_high_table =
+      _mm256_setr_epi8(UTF8_UTILS_BYTE_1_HIGH_TABLE, UTF8_UTILS_BYTE_1_HIGH_TABLE);
+  const __m256i byte_1_low_table = _mm256_setr_epi8(UTF8_UTILS_BYTE_1_LOW_TABLE, UTF8_UTILS_BYTE_1_LOW_TABLE);
+  const __m256i byte_2_high_table =
+      _mm256_setr_epi8(UTF8_UTILS_BYTE_2_HIGH_TABLE, UTF8_UTILS_BYTE_2_HIGH_TABLE);
+  const __m256i nibble_mask = _mm256_set1_epi8(0x0F);
+
+  __m256i prev1 = _utf8_prev_avx2(input, prev_input, 1);
+  __m256i byte_1_high =
+      _mm256_shuffle_epi8(byte_1_high_table, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble_mask));
+  __m256i byte_1_low = _mm256_shuffle_epi8(byte_1_low_table, _mm256_and_si256(prev1, nibble_mask));
+  __m256i byte_2_high =
+      _mm256_shuffle_epi8(byte_2_high_table, _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble_mask));
+  __m256i special_cases = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+  __m256i prev2 = _utf8_prev_avx2(input, prev_input, 2);
+  __m256i prev3 = _utf8_prev_avx2(input, prev_input, 3);
+  __m256i is_third_byte = _mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xE0 - 1)));
+  __m256i is_fourth_byte = _mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xF0 - 1)));
+  __m256i must23 = _mm256_cmpgt_epi8(_mm256_or_si256(is_third_byte, is_fourth_byte), _mm256_setzero_si256());
+  __m256i must23_80 = _mm256_and_si256(must23, _mm256_set1_epi8(static_cast<char>(0x80)));
+  return _mm256_xor_si256(must23_80, special_cases);
+}
+
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("avx2")
+static bool _utf8_validate_avx2(const unsigned char *s, size_t sz) noexcept {
+  const __m256i incomplete_max = _mm256_setr_epi8(
+      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+      -1, static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1));
+  __m256i error = _mm256_setzero_si256();
+  __m256i prev_input = _mm256_setzero_si256();
+  __m256i prev_incomplete = _mm256_setzero_si256();
+
+  size_t i = 0;
+  unsigned char tail[32];
+  while (i < sz) {
+    __m256i input;
+    if (i + 32 <= sz) {
+      input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + i));
+    } else {
+      memset(tail, 0, sizeof(tail));
+      memcpy(tail, s + i, sz - i);
+      input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(tail));
+    }
+    i += 32;
+
+    if (0 == _mm256_movemask_epi8(input)) {
+      error = _mm256_or_si256(error, prev_incomplete);
+      prev_incomplete = _mm256_setzero_si256();
+    } else {
+      error = _mm256_or_si256(error, _utf8_check_block_avx2(input, prev_input));
+      prev_incomplete = _mm256_subs_epu8(input, incomplete_max);
+    }
+    prev_input = input;
+  }
+
+  error = _mm256_or_si256(error, prev_incomplete);
+  return 0 != _mm256_testz_si256(error, error);
+}
+
+#  undef UTF8_UTILS_BYTE_1_HIGH_TABLE
+#  undef UTF8_UTILS_BYTE_1_LOW_TABLE
+#  undef UTF8_UTILS_BYTE_2_HIGH_TABLE
+
+// 非后续字节(不是10______)的掩码，有符号比较时 0x80-0xBF 都小于等于 -65
+ATFW_UTIL_FORCEINLINE ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("sse2") static uint32_t _utf8_lead_mask_sse2(
+    const unsigned char *s) noexcept {
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s));
+  return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(v, _mm_set1_epi8(-65))));
+}
+
+ATFW_UTIL_FORCEINLINE ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("avx2") static uint32_t _utf8_lead_mask_avx2(
+    const unsigned char *s) noexcept {
+  __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s));
+  return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(-65))));
+}
+
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("sse2")
+static size_t _utf8_count_sse2(const unsigned char *s, size_t sz) noexcept {
+  size_t ret = 0;
+  size_t i = 0;
+  for (; i + 16 <= sz; i += 16) {
+    ret += static_cast<size_t>(bit::popcount(_utf8_lead_mask_sse2(s + i)));
+  }
+  return ret + _utf8_count_scalar(s, i, sz);
+}
+
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("avx2")
+static size_t _utf8_count_avx2(const unsigned char *s, size_t sz) noexcept {
+  size_t ret = 0;
+  size_t i = 0;
+  for (; i + 32 <= sz; i += 32) {
+    ret += static_cast<size_t>(bit::popcount(_utf8_lead_mask_avx2(s + i)));
+  }
+  return ret + _utf8_count_scalar(s, i, sz);
+}
+
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("sse2")
+static size_t _utf8_truncate_sse2(const unsigned char *s, size_t sz, size_t max_code_points) noexcept {
+  size_t counted = 0;
+  size_t i = 0;
+  for (; i + 16 <= sz; i += 16) {
+    size_t block = static_cast<size_t>(bit::popcount(_utf8_lead_mask_sse2(s + i)));
+    if (counted + block > max_code_points) {
+      break;
+    }
+    counted += block;
+  }
+  return _utf8_truncate_scalar(s, i, sz, counted, max_code_points);
+}
+
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("avx2")
+static size_t _utf8_truncate_avx2(const unsigned char *s, size_t sz, size_t max_code_points) noexcept {
+  size_t counted = 0;
+  size_t i = 0;
+  for (; i + 32 <= sz; i += 32) {
+    size_t block = static_cast<size_t>(bit::popcount(_utf8_lead_mask_avx2(s + i)));
+    if (counted + block > max_code_points) {
+      break;
+    }
+    counted += block;
+  }
+  return _utf8_truncate_scalar(s, i, sz, counted, max_code_points);
+}
+
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("avx2")
+static size_t _utf16_length_from_utf8_avx2(const unsigned char *s, size_t sz) noexcept {
+  const __m256i four_bytes_lead = _mm256_set1_epi8(static_cast<char>(0xF0));
+  size_t ret = 0;
+  size_t i = 0;
+  for (; i + 32 <= sz; i += 32) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + i));
+    uint32_t leads = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(-65))));
+    uint32_t surrogates =
+        static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(v, four_bytes_lead), v)));
+    ret += static_cast<size_t>(bit::popcount(leads)) + static_cast<size_t>(bit::popcount(surrogates));
+  }
+  return ret + _utf16_length_from_utf8_scalar(s, i, sz);
+}
+
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("sse2")
+static size_t _utf16_length_from_utf8_sse2(const unsigned char *s, size_t sz) noexcept {
+  const __m128i four_bytes_lead = _mm_set1_epi8(static_cast<char>(0xF0));
+  size_t ret = 0;
+  size_t i = 0;
+  for (; i + 16 <= sz; i += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+    uint32_t leads = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(v, _mm_set1_epi8(-65))));
+    uint32_t surrogates = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(v, four_bytes_lead), v)));
+    ret += static_cast<size_t>(bit::popcount(leads)) + static_cast<size_t>(bit::popcount(surrogates));
+  }
+  return ret + _utf16_length_from_utf8_scalar(s, i, sz);
+}
+
+// ASCII批量展开，返回处理的字节数
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("sse2")
+static size_t _utf8_ascii_to_utf16_sse2(const unsigned char *s, size_t sz, char16_t *output) noexcept {
+  const __m128i zero = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + 16 <= sz; i += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+    if (0 != _mm_movemask_epi8(v)) {
+      break;
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i), _mm_unpacklo_epi8(v, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i + 8), _mm_unpackhi_epi8(v, zero));
+  }
+  return i;
+}
+
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("sse2")
+static size_t _utf8_ascii_to_utf32_sse2(const unsigned char *s, size_t sz, char32_t *output) noexcept {
+  const __m128i zero = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + 16 <= sz; i += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+    if (0 != _mm_movemask_epi8(v)) {
+      break;
+    }
+    __m128i low = _mm_unpacklo_epi8(v, zero);
+    __m128i high = _mm_unpackhi_epi8(v, zero);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i), _mm_unpacklo_epi16(low, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i + 4), _mm_unpackhi_epi16(low, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i + 8), _mm_unpacklo_epi16(high, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i + 12), _mm_unpackhi_epi16(high, zero));
+  }
+  return i;
+}
+
+// ASCII批量压缩，返回处理的char16_t个数
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("sse2")
+static size_t _utf16_ascii_to_utf8_sse2(const char16_t *s, size_t sz, char *output) noexcept {
+  const __m128i non_ascii = _mm_set1_epi16(static_cast<int16_t>(0xFF80));
+  const __m128i zero = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + 8 <= sz; i += 8) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+    if (0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, non_ascii), zero))) {
+      break;
+    }
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(output + i), _mm_packus_epi16(v, v));
+  }
+  return i;
+}
+
+ATFW_UTIL_MACRO_TARGET_ATTRIBUTE("sse2")
+static size_t _utf16_ascii_length_sse2(const char16_t *s, size_t sz) noexcept {
+  const __m128i non_ascii = _mm_set1_epi16(static_cast<int16_t>(0xFF80));
+  const __m128i zero = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + 8 <= sz; i += 8) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+    if (0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, non_ascii), zero))) {
+      break;
+    }
+  }
+  return i;
+}
+#endif
+
+static bool _utf8_validate(const unsigned char *s, size_t sz) noexcept {
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+  static const bool has_avx2 = platform::get_cpu_features().has_avx2;
+  static const bool has_ssse3 = platform::get_cpu_features().has_ssse3;
+  if (has_avx2) {
+    return _utf8_validate_avx2(s, sz);
+  }
+  if (has_ssse3) {
+    return _utf8_validate_ssse3(s, sz);
+  }
+#endif
+  return sz == _utf8_find_invalid_scalar(s, 0, sz);
+}
+
+static size_t _utf16_length_from_utf8(const unsigned char *s, size_t sz) noexcept {
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+  static const bool has_avx2 = platform::get_cpu_features().has_avx2;
+  static const bool has_sse2 = platform::get_cpu_features().has_sse2;
+  if (has_avx2) {
+    return _utf16_length_from_utf8_avx2(s, sz);
+  }
+  if (has_sse2) {
+    return _utf16_length_from_utf8_sse2(s, sz);
+  }
+#endif
+  return _utf16_length_from_utf8_scalar(s, 0, sz);
+}
+
+// 未配对的代理项返回 UTF_INVALID_LENGTH
+static size_t _utf8_length_from_utf16(const char16_t *s, size_t sz, bool strict) noexcept {
+  size_t i = 0;
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+  static const bool has_sse2 = platform::get_cpu_features().has_sse2;
+  if (has_sse2) {
+    i = _utf16_ascii_length_sse2(s, sz);
+  }
+#endif
+  size_t ret = i;
+  for (; i < sz; ++i) {
+    uint32_t c = s[i];
+    if (c < 0x80) {
+      ret += 1;
+    } else if (c < 0x800) {
+      ret += 2;
+    } else if (_is_high_surrogate(c) && i + 1 < sz && _is_low_surrogate(s[i + 1])) {
+      ret += 4;
+      ++i;
+    } else if (strict && (_is_high_surrogate(c) || _is_low_surrogate(c))) {
+      return UTF_INVALID_LENGTH;
+    } else {
+      ret += 3;
+    }
+  }
+  return ret;
+}
+
+static size_t _utf8_length_from_utf32(const char32_t *s, size_t sz, bool strict) noexcept {
+  size_t ret = 0;
+  for (size_t i = 0; i < sz; ++i) {
+    uint32_t c = s[i];
+    if (c < 0x80) {
+      ret += 1;
+    } else if (c < 0x800) {
+      ret += 2;
+    } else if (c < 0x10000) {
+      if (strict && (_is_high_surrogate(c) || _is_low_surrogate(c))) {
+        return UTF_INVALID_LENGTH;
+      }
+      ret += 3;
+    } else {
+      if (strict && c > 0x10FFFF) {
+        return UTF_INVALID_LENGTH;
+      }
+      ret += 4;
+    }
+  }
+  return ret;
+}
+
+// 输入必须已经校验过，输出缓冲区必须足够
+static void _utf8_to_utf16_valid(const unsigned char *s, size_t sz, char16_t *output) noexcept {
+  size_t i = 0;
+  size_t out = 0;
+  while (i < sz) {
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+    static const bool has_sse2 = platform::get_cpu_features().has_sse2;
+    if (has_sse2 && s[i] < 0x80) {
+      size_t ascii = _utf8_ascii_to_utf16_sse2(s + i, sz - i, output + out);
+      i += ascii;
+      out += ascii;
+      if (i >= sz) {
+        break;
+      }
+    }
+#endif
+    uint32_t c = _utf8_decode_valid(s, i);
+    if (c >= 0x10000) {
+      c -= 0x10000;
+      output[out++] = static_cast<char16_t>(0xD800 + (c >> 10));
+      output[out++] = static_cast<char16_t>(0xDC00 + (c & 0x3FF));
+    } else {
+      output[out++] = static_cast<char16_t>(c);
+    }
+  }
+}
+
+static void _utf8_to_utf32_valid(const unsigned char *s, size_t sz, char32_t *output) noexcept {
+  size_t i = 0;
+  size_t out = 0;
+  while (i < sz) {
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+    static const bool has_sse2 = platform::get_cpu_features().has_sse2;
+    if (has_sse2 && s[i] < 0x80) {
+      size_t ascii = _utf8_ascii_to_utf32_sse2(s + i, sz - i, output + out);
+      i += ascii;
+      out += ascii;
+      if (i >= sz) {
+        break;
+      }
+    }
+#endif
+    output[out++] = static_cast<char32_t>(_utf8_decode_valid(s, i));
+  }
+}
+
+static void _utf16_to_utf8_valid(const char16_t *s, size_t sz, char *output) noexcept {
+  size_t i = 0;
+  size_t out = 0;
+  while (i < sz) {
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+    static const bool has_sse2 = platform::get_cpu_features().has_sse2;
+    if (has_sse2 && s[i] < 0x80) {
+      size_t ascii = _utf16_ascii_to_utf8_sse2(s + i, sz - i, output + out);
+      i += ascii;
+      out += ascii;
+      if (i >= sz) {
+        break;
+      }
+    }
+#endif
+    uint32_t c = s[i++];
+    if (_is_high_surrogate(c)) {
+      c = 0x10000 + ((c - 0xD800) << 10) + (static_cast<uint32_t>(s[i++]) - 0xDC00);
+    }
+    out += _utf8_encode(c, output + out);
+  }
+}
+}  // namespace
+
+ATFRAMEWORK_UTILS_API bool utf8_validate(nostd::string_view input) noexcept {
+  return _utf8_validate(reinterpret_cast<const unsigned char *>(input.data()), input.size());
+}
+
+ATFRAMEWORK_UTILS_API size_t utf8_find_invalid(nostd::string_view input) noexcept {
+  const unsigned char *s = reinterpret_cast<const unsigned char *>(input.data());
+  if (_utf8_validate(s, input.size())) {
+    return input.size();
+  }
+  return _utf8_find_invalid_scalar(s, 0, input.size());
+}
+
+ATFRAMEWORK_UTILS_API size_t utf8_count(nostd::string_view input) noexcept {
+  const unsigned char *s = reinterpret_cast<const unsigned char *>(input.data());
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+  static const bool has_avx2 = platform::get_cpu_features().has_avx2;
+  static const bool has_sse2 = platform::get_cpu_features().has_sse2;
+  if (has_avx2) {
+    return _utf8_count_avx2(s, input.size());
+  }
+  if (has_sse2) {
+    return _utf8_count_sse2(s, input.size());
+  }
+#endif
+  return _utf8_count_scalar(s, 0, input.size());
+}
+
+ATFRAMEWORK_UTILS_API size_t utf8_truncate_position(nostd::string_view input, size_t max_code_points) noexcept {
+  const unsigned char *s = reinterpret_cast<const unsigned char *>(input.data());
+#if defined(ATFW_UTIL_MACRO_ENABLE_X86_SIMD_DISPATCH)
+  static const bool has_avx2 = platform::get_cpu_features().has_avx2;
+  static const bool has_sse2 = platform::get_cpu_features().has_sse2;
+  if (has_avx2) {
+    return _utf8_truncate_avx2(s, input.size(), max_code_points);
+  }
+  if (has_sse2) {
+    return _utf8_truncate_sse2(s, input.size(), max_code_points);
+  }
+#endif
+  return _utf8_truncate_scalar(s, 0, input.size(), 0, max_code_points);
+}
+
+ATFRAMEWORK_UTILS_API size_t utf16_length_from_utf8(nostd::string_view input) noexcept {
+  return _utf16_length_from_utf8(reinterpret_cast<const unsigned char *>(input.data()), input.size());
+}
+
+ATFRAMEWORK_UTILS_API size_t utf8_length_from_utf16(nostd::basic_string_view<char16_t> input) noexcept {
+  return _utf8_length_from_utf16(input.data(), input.size(), false);
+}
+
+ATFRAMEWORK_UTILS_API size_t utf8_length_from_utf32(nostd::basic_string_view<char32_t> input) noexcept {
+  return _utf8_length_from_utf32(input.data(), input.size(), false);
+}
+
+ATFRAMEWORK_UTILS_API size_t utf8_to_utf16(nostd::string_view input, char16_t *output, size_t output_size) noexcept {
+  const unsigned char *s = reinterpret_cast<const unsigned char *>(input.data());
+  if (!_utf8_validate(s, input.size())) {
+    return UTF_INVALID_LENGTH;
+  }
+
+  size_t ret = _utf16_length_from_utf8(s, input.size());
+  if (ret <= output_size && nullptr != output) {
+    _utf8_to_utf16_valid(s, input.size(), output);
+  }
+  return ret;
+}
+
+ATFRAMEWORK_UTILS_API bool utf8_to_utf16(nostd::string_view input, std::u16string &output) {
+  const unsigned char *s = reinterpret_cast<const unsigned char *>(input.data());
+  if (!_utf8_validate(s, input.size())) {
+    return false;
+  }
+
+  size_t offset = output.size();
+  output.resize(offset + _utf16_length_from_utf8(s, input.size()));
+  _utf8_to_utf16_valid(s, input.size(), &output[0] + offset);
+  return true;
+}
+
+ATFRAMEWORK_UTILS_API size_t utf8_to_utf32(nostd::string_view input, char32_t *output, size_t output_size) noexcept {
+  const unsigned char *s = reinterpret_cast<const unsigned char *>(input.data());
+  if (!_utf8_validate(s, input.size())) {
+    return UTF_INVALID_LENGTH;
+  }
+
+  size_t ret = utf8_count(input);
+  if (ret <= output_size && nullptr != output) {
+    _utf8_to_utf32_valid(s, input.size(), output);
+  }
+  return ret;
+}
+
+ATFRAMEWORK_UTILS_API bool utf8_to_utf32(nostd::string_view input, std::u32string &output) {
+  const unsigned char *s = reinterpret_cast<const unsigned char *>(input.data());
+  if (!_utf8_validate(s, input.size())) {
+    return false;
+  }
+
+  size_t offset = output.size();
+  output.resize(offset + utf8_count(input));
+  _utf8_to_utf32_valid(s, input.size(), &output[0] + offset);
+  return true;
+}
+
+ATFRAMEWORK_UTILS_API size_t utf16_to_utf8(nostd::basic_string_view<char16_t> input, char *output,
+                                           size_t output_size) noexcept {
+  size_t ret = _utf8_length_from_utf16(input.data(), input.size(), true);
+  if (UTF_INVALID_LENGTH == ret) {
+    return ret;
+  }
+
+  if (ret <= output_size && nullptr != output) {
+    _utf16_to_utf8_valid(input.data(), input.size(), output);
+  }
+  return ret;
+}
+
+ATFRAMEWORK_UTILS_API bool utf16_to_utf8(nostd::basic_string_view<char16_t> input, std::string &output) {
+  size_t length = _utf8_length_from_utf16(input.data(), input.size(), true);
+  if (UTF_INVALID_LENGTH == length) {
+    return false;
+  }
+
+  size_t offset = output.size();
+  output.resize(offset + length);
+  _utf16_to_utf8_valid(input.data(), input.size(), &output[0] + offset);
+  return true;
+}
+
+ATFRAMEWORK_UTILS_API size_t utf32_to_utf8(nostd::basic_string_view<char32_t> input, char *output,
+                                           size_t output_size) noexcept {
+  size_t ret = _utf8_length_from_utf32(input.data(), input.size(), true);
+  if (UTF_INVALID_LENGTH == ret) {
+    return ret;
+  }
+
+  if (ret <= output_size && nullptr != output) {
+    size_t out = 0;
+    for (size_t i = 0; i < input.size(); ++i) {
+      out += _utf8_encode(static_cast<uint32_t>(input[i]), output + out);
+    }
+  }
+  return ret;
+}
+
+ATFRAMEWORK_UTILS_API bool utf32_to_utf8(nostd::basic_string_view<char32_t> input, std::string &output) {
+  size_t length = _utf8_length_from_utf32(input.data(), input.size(), true);
+  if (UTF_INVALID_LENGTH == length) {
+    return false;
+  }
+
+  size_t offset = output.size();
+  output.resize(offset + length);
+  for (size_t i = 0; i < input.size(); ++i) {
+    offset += _utf8_encode(static_cast<uint32_t>(input[i]), &output[0] + offset);
+  }
+  return true;
+}
+
+}  // namespace string
+ATFRAMEWORK_UTILS_NAMESPACE_END
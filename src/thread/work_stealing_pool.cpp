@@ -0,0 +1,449 @@
+// Copyright 2026 atframework
+//
+// Licensed under the MIT licenses.
+
+#include "thread/work_stealing_pool.h"
+
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+
+#include "lock/hybrid_mutex.h"
+#include "lock/lock_holder.h"
+#include "std/thread.h"
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace thread {
+
+struct work_stealing_pool::worker_type {
+  worker_type(work_stealing_pool* o, int32_t idx)
+      : owner(o),
+        index(idx),
+        deque(DEFAULT_DEQUE_CAPACITY),
+        random_seed(static_cast<uint32_t>(idx) * 2654435761u + 1),
+        executed_count(0),
+        stolen_count(0),
+        parked_count(0) {}
+
+  ~worker_type() {
+    for (task_type* node : free_nodes) {
+      delete node;
+    }
+  }
+
+  work_stealing_pool* owner;
+  int32_t index;
+  detail::chase_lev_deque<task_type> deque;
+  ::std::vector<task_type*> free_nodes;  // 只在本工作线程内访问
+  uint32_t random_seed;
+
+  ::std::atomic<uint64_t> executed_count;
+  ::std::atomic<uint64_t> stolen_count;
+  ::std::atomic<uint64_t> parked_count;
+
+  ::std::thread thread_handle;
+};
+
+namespace {
+static THREAD_TLS work_stealing_pool::worker_type* g_current_worker = nullptr;
+
+static inline uint32_t next_random(uint32_t& seed) noexcept {
+  // xorshift32
+  seed ^= seed << 13;
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+  return seed;
+}
+
+struct ATFW_UTIL_SYMBOL_LOCAL parallel_for_state {
+  size_t count;
+  work_stealing_pool::parallel_for_function fn;
+  void* context;
+
+  ::std::atomic<size_t> next_slot;
+  ::std::atomic<size_t> next_index;
+  ::std::atomic<size_t> finished_count;
+  ::std::mutex finish_lock;
+  ::std::condition_variable finish_cv;
+};
+
+// 任务从共享计数器中领取，调用线程和所有辅助线程一直工作到最后一个任务
+static void run_parallel_for(parallel_for_state& state) noexcept {
+  size_t index = state.next_index.fetch_add(1, ::std::memory_order_relaxed);
+  if (index >= state.count) {
+    return;
+  }
+
+  // 领到任务后才占用slot和访问回调，启动晚的辅助线程不会访问已经结束的 parallel_for
+  size_t slot = state.next_slot.fetch_add(1, ::std::memory_order_relaxed);
+  do {
+    state.fn(state.context, slot, index);
+
+    if (state.finished_count.fetch_add(1, ::std::memory_order_acq_rel) + 1 == state.count) {
+      ::std::lock_guard<::std::mutex> guard(state.finish_lock);
+      state.finish_cv.notify_all();
+    }
+  } while ((index = state.next_index.fetch_add(1, ::std::memory_order_relaxed)) < state.count);
+}
+}  // namespace
+
+ATFRAMEWORK_UTILS_API work_stealing_pool::work_stealing_pool(size_t worker_count)
+    : global_size_(0), pending_count_(0), stopping_(false), wake_epoch_(0), sleeping_count_(0) {
+  if (0 == worker_count) {
+    worker_count = ::std::thread::hardware_concurrency();
+  }
+  if (0 == worker_count) {
+    worker_count = 1;
+  }
+
+  // 先创建所有工作线程的数据，再启动线程，窃取时不需要对 workers_ 加锁
+  workers_.reserve(worker_count);
+  for (size_t i = 0; i < worker_count; ++i) {
+    workers_.emplace_back(new worker_type(this, static_cast<int32_t>(i)));
+  }
+
+  for (auto& worker : workers_) {
+    worker_type* self = worker.get();
+    self->thread_handle = ::std::thread([this, self]() { worker_main(self); });
+  }
+}
+
+ATFRAMEWORK_UTILS_API work_stealing_pool::~work_stealing_pool() {
+  // 在工作线程中析构时无法等待自己退出，其他工作线程也仍然在访问线程池，release版本里也不能继续
+  if (get_current_pool() == this) {
+    fputs("work_stealing_pool can not be destroyed in its own worker thread\n", stderr);
+    ::std::abort();
+  }
+  stop();
+
+  for (task_type* node : global_queue_) {
+    delete node;
+  }
+  global_queue_.clear();
+}
+
+ATFRAMEWORK_UTILS_API bool work_stealing_pool::post(task_type&& task) {
+  if (!task) {
+    return false;
+  }
+
+  worker_type* self = g_current_worker;
+  bool from_worker = nullptr != self && self->owner == this;
+
+  // 先增加计数再检查停止标记，保证 stop() 等待时不会漏掉已经通过检查的任务
+  pending_count_.fetch_add(1, ::std::memory_order_seq_cst);
+  // 停止过程中工作线程内投递的子任务仍然需要执行完
+  if (!from_worker && stopping_.load(::std::memory_order_seq_cst)) {
+    if (1 == pending_count_.fetch_sub(1, ::std::memory_order_acq_rel)) {
+      wake_all();
+    }
+    return false;
+  }
+
+  task_type* node = allocate_task_node(::std::move(task));
+  if (from_worker) {
+    self->deque.push(node);
+  } else {
+    push_task_node(node);
+  }
+
+  // 和 worker_main 中挂起前的检查配对，避免丢失唤醒
+  ::std::atomic_thread_fence(::std::memory_order_seq_cst);
+  if (sleeping_count_.load(::std::memory_order_relaxed) > 0) {
+    wake_one();
+  }
+  return true;
+}
+
+ATFRAMEWORK_UTILS_API int work_stealing_pool::init_timer(time_t init_tick) {
+  lock::lock_holder<lock::spin_lock> holder(timer_lock_);
+  return timer_.init(init_tick);
+}
+
+ATFRAMEWORK_UTILS_API int work_stealing_pool::post_delayed(time_t delta, task_type&& task) {
+  // jiffies_timer 的回调需要可复制
+  ::std::shared_ptr<task_type> holder = ::std::make_shared<task_type>(::std::move(task));
+  timer_type::timer_callback_fn_t fn = [this, holder](time_t, const timer_type::timer_t&) {
+    post(::std::move(*holder));
+  };
+
+  lock::lock_holder<lock::spin_lock> timer_holder(timer_lock_);
+  return timer_.add_timer(delta, ::std::move(fn), nullptr);
+}
+
+ATFRAMEWORK_UTILS_API int work_stealing_pool::tick(time_t expires) {
+  lock::lock_holder<lock::spin_lock> holder(timer_lock_);
+  return timer_.tick(expires);
+}
+
+ATFRAMEWORK_UTILS_API void work_stealing_pool::wait_idle() {
+  worker_type* self = g_current_worker;
+  if (nullptr != self && self->owner == this) {
+    // 工作线程中等待会占用一个工作线程(本任务也计入了pending)，这里只帮忙执行能拿到的任务
+    task_type* node;
+    while (nullptr != (node = find_task(self))) {
+      run_task(self, node);
+    }
+    return;
+  }
+
+  unsigned int try_times = 0;
+  while (pending_count_.load(::std::memory_order_acquire) > 0) {
+    lock::detail::spin_wait(try_times++);
+  }
+}
+
+ATFRAMEWORK_UTILS_API void work_stealing_pool::parallel_for(size_t count, parallel_for_function fn, void* context) {
+  if (0 == count || nullptr == fn) {
+    return;
+  }
+
+  size_t helper_count = get_parallel_slot_count(count) - 1;
+  if (0 == helper_count) {
+    for (size_t i = 0; i < count; ++i) {
+      fn(context, 0, i);
+    }
+    return;
+  }
+
+  // 辅助线程可能在 parallel_for 返回后才开始执行，所以状态用 shared_ptr 保存
+  ::std::shared_ptr<parallel_for_state> state = ::std::make_shared<parallel_for_state>();
+  state->count = count;
+  state->fn = fn;
+  state->context = context;
+  state->next_slot.store(0, ::std::memory_order_relaxed);
+  state->next_index.store(0, ::std::memory_order_relaxed);
+  state->finished_count.store(0, ::std::memory_order_relaxed);
+
+  for (size_t i = 0; i < helper_count; ++i) {
+    // 投递失败只会减少并行度，剩下的任务由调用线程完成
+#if defined(ATFRAMEWORK_UTILS_ENABLE_EXCEPTION) && ATFRAMEWORK_UTILS_ENABLE_EXCEPTION
+    try {
+#endif
+      if (!post([state]() { run_parallel_for(*state); })) {
+        break;
+      }
+#if defined(ATFRAMEWORK_UTILS_ENABLE_EXCEPTION) && ATFRAMEWORK_UTILS_ENABLE_EXCEPTION
+    } catch (...) {
+      break;
+    }
+#endif
+  }
+  run_parallel_for(*state);
+
+  ::std::unique_lock<::std::mutex> guard(state->finish_lock);
+  state->finish_cv.wait(guard, [&state]() {
+    return state->finished_count.load(::std::memory_order_acquire) >= state->count;
+  });
+}
+
+ATFRAMEWORK_UTILS_API void work_stealing_pool::stop() {
+  stopping_.store(true, ::std::memory_order_seq_cst);
+  wake_all();
+
+  // 不能在工作线程里join自己，只设置标记
+  worker_type* self = g_current_worker;
+  if (nullptr != self && self->owner == this) {
+    return;
+  }
+
+  for (auto& worker : workers_) {
+    if (worker->thread_handle.joinable()) {
+      worker->thread_handle.join();
+    }
+  }
+}
+
+ATFRAMEWORK_UTILS_API work_stealing_pool_stats work_stealing_pool::get_stats() const noexcept {
+  work_stealing_pool_stats ret;
+  ret.executed_count = 0;
+  ret.stolen_count = 0;
+  ret.parked_count = 0;
+  for (auto& worker : workers_) {
+    ret.executed_count += worker->executed_count.load(::std::memory_order_relaxed);
+    ret.stolen_count += worker->stolen_count.load(::std::memory_order_relaxed);
+    ret.parked_count += worker->parked_count.load(::std::memory_order_relaxed);
+  }
+  return ret;
+}
+
+ATFRAMEWORK_UTILS_API work_stealing_pool* work_stealing_pool::get_current_pool() noexcept {
+  worker_type* self = g_current_worker;
+  return nullptr == self ? nullptr : self->owner;
+}
+
+ATFRAMEWORK_UTILS_API int32_t work_stealing_pool::get_current_worker_index() noexcept {
+  worker_type* self = g_current_worker;
+  return nullptr == self ? -1 : self->index;
+}
+
+void work_stealing_pool::worker_main(worker_type* self) {
+  g_current_worker = self;
+
+  size_t spin_times = 0;
+  while (true) {
+    task_type* node = find_task(self);
+    if (nullptr != node) {
+      run_task(self, node);
+      spin_times = 0;
+      continue;
+    }
+
+    if (stopping_.load(::std::memory_order_acquire) && 0 == pending_count_.load(::std::memory_order_acquire)) {
+      break;
+    }
+
+    if (spin_times < SPIN_BEFORE_PARK) {
+      if (spin_times < SPIN_BEFORE_PARK / 2) {
+        lock::detail::spin_pause();
+      } else {
+        lock::detail::thread_yield();
+      }
+      ++spin_times;
+      continue;
+    }
+
+    // 先读取唤醒序号再登记和检查，检查之后的唤醒会改变序号使 park_wait 立即返回
+    uint32_t epoch = wake_epoch_.load(::std::memory_order_acquire);
+    sleeping_count_.fetch_add(1, ::std::memory_order_seq_cst);
+    ::std::atomic_thread_fence(::std::memory_order_seq_cst);
+    bool should_exit =
+        stopping_.load(::std::memory_order_acquire) && 0 == pending_count_.load(::std::memory_order_acquire);
+    if (!should_exit && !has_visible_task()) {
+      self->parked_count.fetch_add(1, ::std::memory_order_relaxed);
+      lock::detail::park_wait(wake_epoch_, epoch);
+    }
+    sleeping_count_.fetch_sub(1, ::std::memory_order_relaxed);
+    spin_times = 0;
+  }
+
+  g_current_worker = nullptr;
+}
+
+work_stealing_pool::task_type* work_stealing_pool::allocate_task_node(task_type&& task) {
+  worker_type* self = g_current_worker;
+  if (nullptr != self && self->owner == this && !self->free_nodes.empty()) {
+    task_type* ret = self->free_nodes.back();
+    self->free_nodes.pop_back();
+    *ret = ::std::move(task);
+    return ret;
+  }
+
+  return new task_type(::std::move(task));
+}
+
+void work_stealing_pool::release_task_node(task_type* node) noexcept {
+  node->reset();
+
+  worker_type* self = g_current_worker;
+  if (nullptr != self && self->owner == this && self->free_nodes.size() < MAX_CACHED_TASK_NODES) {
+#if defined(ATFRAMEWORK_UTILS_ENABLE_EXCEPTION) && ATFRAMEWORK_UTILS_ENABLE_EXCEPTION
+    try {
+#endif
+      self->free_nodes.push_back(node);
+      return;
+#if defined(ATFRAMEWORK_UTILS_ENABLE_EXCEPTION) && ATFRAMEWORK_UTILS_ENABLE_EXCEPTION
+    } catch (...) {
+    }
+#endif
+  }
+
+  delete node;
+}
+
+void work_stealing_pool::push_task_node(task_type* node) {
+  lock::lock_holder<lock::spin_lock> holder(global_lock_);
+  global_queue_.push_back(node);
+  global_size_.fetch_add(1, ::std::memory_order_release);
+}
+
+work_stealing_pool::task_type* work_stealing_pool::pop_global() noexcept {
+  if (0 == global_size_.load(::std::memory_order_acquire)) {
+    return nullptr;
+  }
+
+  lock::lock_holder<lock::spin_lock> holder(global_lock_);
+  if (global_queue_.empty()) {
+    return nullptr;
+  }
+
+  task_type* ret = global_queue_.front();
+  global_queue_.pop_front();
+  global_size_.fetch_sub(1, ::std::memory_order_release);
+  return ret;
+}
+
+work_stealing_pool::task_type* work_stealing_pool::try_steal(worker_type* self) noexcept {
+  size_t worker_count = workers_.size();
+  if (worker_count <= 1) {
+    return nullptr;
+  }
+
+  // 随机起点，避免所有空闲线程同时窃取同一个队列
+  size_t start = static_cast<size_t>(next_random(self->random_seed)) % worker_count;
+  for (size_t i = 0; i < worker_count; ++i) {
+    worker_type* victim = workers_[(start + i) % worker_count].get();
+    if (victim == self) {
+      continue;
+    }
+
+    task_type* ret = victim->deque.steal();
+    if (nullptr != ret) {
+      self->stolen_count.fetch_add(1, ::std::memory_order_relaxed);
+      return ret;
+    }
+  }
+
+  return nullptr;
+}
+
+work_stealing_pool::task_type* work_stealing_pool::find_task(worker_type* self) noexcept {
+  task_type* ret = self->deque.pop();
+  if (nullptr != ret) {
+    return ret;
+  }
+
+  ret = pop_global();
+  if (nullptr != ret) {
+    return ret;
+  }
+
+  return try_steal(self);
+}
+
+void work_stealing_pool::run_task(worker_type* self, task_type* node) noexcept {
+  (*node)();
+  release_task_node(node);
+  self->executed_count.fetch_add(1, ::std::memory_order_relaxed);
+
+  if (1 == pending_count_.fetch_sub(1, ::std::memory_order_acq_rel) && stopping_.load(::std::memory_order_acquire)) {
+    wake_all();
+  }
+}
+
+bool work_stealing_pool::has_visible_task() const noexcept {
+  if (global_size_.load(::std::memory_order_acquire) > 0) {
+    return true;
+  }
+
+  for (auto& worker : workers_) {
+    if (!worker->deque.empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void work_stealing_pool::wake_one() noexcept {
+  wake_epoch_.fetch_add(1, ::std::memory_order_release);
+  lock::detail::park_wake_one(wake_epoch_);
+}
+
+void work_stealing_pool::wake_all() noexcept {
+  wake_epoch_.fetch_add(1, ::std::memory_order_release);
+  lock::detail::park_wake_all(wake_epoch_);
+}
+
+}  // namespace thread
+ATFRAMEWORK_UTILS_NAMESPACE_END
@@ -1,14 +1,22 @@
 // Copyright 2026 atframework
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstring>
 #include <ctime>
 #include <fstream>
+#include <random>
 #include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "common/file_system.h"
 #include "frame/test_macros.h"
 #include "string/ac_automation.h"
+#include "thread/work_stealing_pool.h"
 
 #if defined(_MSC_VER) && _MSC_VER >= 1900
 #  define U8_LITERALS(x) (const char *)(u8##x)
@@ -218,3 +226,549 @@ CASE_TEST(ac_automation, load_and_dump) {
   actree.dump_dot(fdot, nullptr, node_options, edge_options);
 }
 
+CASE_TEST(ac_automation, frozen) {
+  atfw::util::string::ac_automation<> actree;
+
+  actree.insert_keyword("acd");
+  actree.insert_keyword("aceb");
+  actree.insert_keyword("bef");
+  actree.insert_keyword("cef");
+  actree.insert_keyword("ef");
+  CASE_EXPECT_FALSE(actree.is_frozen());
+  CASE_EXPECT_EQ(0, actree.match_frozen("acefcabefefefcevfefbc").size());
+  size_t tree_count = actree.match("acefcabefefefcevfefbc").size();
+  CASE_EXPECT_TRUE(actree.freeze());
+  CASE_EXPECT_TRUE(actree.is_frozen());
+  CASE_EXPECT_EQ(5, actree.get_frozen().get_keyword_count());
+
+  // freeze() does not change the result of match()
+  CASE_EXPECT_EQ(tree_count, actree.match("acefcabefefefcevfefbc").size());
+
+  atfw::util::string::ac_automation<>::value_type res = actree.match_frozen("acefcabefefefcevfefbc");
+  CASE_EXPECT_EQ(5, res.size());
+  if (res.size() >= 2) {
+    CASE_EXPECT_EQ(1, res[0].start);
+    CASE_EXPECT_EQ(3, res[0].length);
+    CASE_EXPECT_EQ("cef", *res[0].keyword);
+
+    CASE_EXPECT_EQ(6, res[1].start);
+    CASE_EXPECT_EQ(3, res[1].length);
+    CASE_EXPECT_EQ("bef", *res[1].keyword);
+  }
+
+  CASE_EXPECT_EQ(0, actree.match_frozen("lolololnmmnmuiyt").size());
+  CASE_EXPECT_FALSE(actree.get_frozen().contains("lolololnmmnmuiyt"));
+  CASE_EXPECT_TRUE(actree.get_frozen().contains("lolololefnmuiyt"));
+
+  // Skip chars are applied after freeze again
+  actree.set_skip(' ');
+  CASE_EXPECT_FALSE(actree.is_frozen());
+  CASE_EXPECT_TRUE(actree.freeze());
+  res = actree.match_frozen("ac  efca   b   e f efefcevfefbc");
+  CASE_EXPECT_EQ(5, res.size());
+  if (res.size() >= 2) {
+    CASE_EXPECT_EQ(1, res[0].start);
+    CASE_EXPECT_EQ(5, res[0].length);
+
+    CASE_EXPECT_EQ(11, res[1].start);
+    CASE_EXPECT_EQ(7, res[1].length);
+    CASE_EXPECT_EQ('b', res[1].keyword->at(0));
+  }
+
+  // Keywords ending in the middle of a longer keyword are found by the failure links of match_frozen() only
+  atfw::util::string::ac_automation<> suffix_tree;
+  suffix_tree.insert_keyword("abcd");
+  suffix_tree.insert_keyword("bc");
+  CASE_EXPECT_TRUE(suffix_tree.freeze());
+  CASE_EXPECT_EQ(0, suffix_tree.match("xabce").size());
+  res = suffix_tree.match_frozen("xabce");
+  CASE_EXPECT_EQ(1, res.size());
+  if (!res.empty()) {
+    CASE_EXPECT_EQ(2, res[0].start);
+    CASE_EXPECT_EQ(2, res[0].length);
+  }
+}
+
+CASE_TEST(ac_automation, frozen_nocase_and_utf8) {
+  atfw::util::string::ac_automation<atfw::util::string::utf8_char_t> actree;
+  actree.set_nocase(true);
+
+  actree.insert_keyword(U8_LITERALS("艹"));
+  actree.insert_keyword(U8_LITERALS("测试脏字"));
+  actree.insert_keyword(U8_LITERALS("试脏字"));
+  actree.insert_keyword(U8_LITERALS("艹试脏"));
+  actree.insert_keyword("Bad");
+  actree.set_skip(' ');
+  actree.set_skip('\r');
+  actree.set_skip('\n');
+  CASE_EXPECT_TRUE(actree.freeze());
+
+  std::string input = U8_LITERALS("小册老艹，我干死试测  试脏测  试脏\r\n字艹 试脏 bAD");
+  atfw::util::string::ac_automation<atfw::util::string::utf8_char_t>::value_type res = actree.match_frozen(input);
+  CASE_EXPECT_EQ(4, res.size());
+  if (res.size() >= 4) {
+    CASE_EXPECT_EQ(U8_LITERALS("艹"), *res[0].keyword);
+    CASE_EXPECT_EQ(U8_LITERALS("测试脏字"), *res[1].keyword);
+    CASE_EXPECT_EQ(U8_LITERALS("测  试脏\r\n字"), input.substr(res[1].start, res[1].length));
+    CASE_EXPECT_EQ(U8_LITERALS("艹"), *res[2].keyword);
+    CASE_EXPECT_EQ("Bad", *res[3].keyword);
+    CASE_EXPECT_EQ("bAD", input.substr(res[3].start, res[3].length));
+  }
+}
+
+CASE_TEST(ac_automation, frozen_non_ascii_skip) {
+  atfw::util::string::ac_automation<atfw::util::string::utf8_char_t> actree;
+
+  actree.insert_keyword(U8_LITERALS("测试脏字"));
+  actree.set_skip(' ');
+  actree.set_skip(atfw::util::string::utf8_char_t(U8_LITERALS("，")));
+
+  // The frozen automaton only supports ASCII skip chars, match_frozen returns nothing
+  CASE_EXPECT_FALSE(actree.freeze());
+  CASE_EXPECT_FALSE(actree.is_frozen());
+  CASE_EXPECT_EQ(0, actree.match_frozen(U8_LITERALS("测试脏 字")).size());
+
+  std::string input = U8_LITERALS("测试脏 字");
+  atfw::util::string::ac_automation<atfw::util::string::utf8_char_t>::value_type res = actree.match(input);
+  CASE_EXPECT_EQ(1, res.size());
+  if (!res.empty()) {
+    CASE_EXPECT_EQ(U8_LITERALS("测试脏字"), *res[0].keyword);
+    CASE_EXPECT_EQ(input, input.substr(res[0].start, res[0].length));
+  }
+
+  actree.unset_skip(atfw::util::string::utf8_char_t(U8_LITERALS("，")));
+  CASE_EXPECT_TRUE(actree.freeze());
+}
+
+namespace {
+static std::string ac_automation_test_random_string(std::mt19937 &rnd, size_t min_len, size_t max_len,
+                                                    char max_char) {
+  std::string ret;
+  size_t len = min_len + rnd() % (max_len - min_len + 1);
+  for (size_t i = 0; i < len; ++i) {
+    ret.push_back(static_cast<char>('a' + rnd() % static_cast<uint32_t>(max_char - 'a' + 1)));
+  }
+  return ret;
+}
+
+// Reference: earliest ending keyword (longest one for the same end), restart after each match
+static std::vector<std::pair<size_t, size_t>> ac_automation_test_naive_match(const std::vector<std::string> &keywords,
+                                                                             const std::string &input) {
+  std::vector<std::pair<size_t, size_t>> ret;
+  size_t begin = 0;
+  for (size_t end = 1; end <= input.size(); ++end) {
+    size_t best = 0;
+    for (auto &keyword : keywords) {
+      if (keyword.size() > best && keyword.size() <= end - begin &&
+          0 == input.compare(end - keyword.size(), keyword.size(), keyword)) {
+        best = keyword.size();
+      }
+    }
+
+    if (best > 0) {
+      ret.push_back(std::make_pair(end - best, best));
+      begin = end;
+    }
+  }
+  return ret;
+}
+}  // namespace
+
+CASE_TEST(ac_automation, frozen_random) {
+  std::mt19937 rnd(20260417);
+  for (int round = 0; round < 32; ++round) {
+    std::vector<std::string> keywords;
+    std::vector<atfw::util::nostd::string_view> keyword_views;
+    for (int i = 0; i < 64; ++i) {
+      keywords.push_back(ac_automation_test_random_string(rnd, 1, 6, 'e'));
+    }
+    std::sort(keywords.begin(), keywords.end());
+    keywords.erase(std::unique(keywords.begin(), keywords.end()), keywords.end());
+    for (auto &keyword : keywords) {
+      keyword_views.push_back(keyword);
+    }
+
+    atfw::util::string::ac_automation_dfa dfa;
+    CASE_EXPECT_TRUE(dfa.build(keyword_views));
+
+    std::string input = ac_automation_test_random_string(rnd, 256, 512, 'f');
+    atfw::util::string::ac_automation_dfa::value_type res = dfa.match(input);
+    std::vector<std::pair<size_t, size_t>> expect = ac_automation_test_naive_match(keywords, input);
+    CASE_EXPECT_EQ(expect.size(), res.size());
+    for (size_t i = 0; i < res.size() && i < expect.size(); ++i) {
+      CASE_EXPECT_EQ(expect[i].first, res[i].start);
+      CASE_EXPECT_EQ(expect[i].second, res[i].length);
+      CASE_EXPECT_EQ(input.substr(res[i].start, res[i].length), dfa.get_keyword(res[i].keyword_index));
+    }
+  }
+}
+
+#if defined(PROJECT_TEST_MACRO_ENABLE_BENCHMARK) && PROJECT_TEST_MACRO_ENABLE_BENCHMARK
+CASE_TEST(ac_automation, frozen_benchmark) {
+  std::mt19937 rnd(20260417);
+  atfw::util::string::ac_automation<> actree;
+  for (int i = 0; i < 20000; ++i) {
+    actree.insert_keyword(ac_automation_test_random_string(rnd, 3, 8, 'z'));
+  }
+  std::string input = ac_automation_test_random_string(rnd, 1 << 20, 1 << 20, 'z');
+
+  // Warm up and build failure links before timing
+  size_t tree_count = actree.match(input).size();
+  auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < 4; ++i) {
+    tree_count = actree.match(input).size();
+  }
+  auto tree_cost = std::chrono::steady_clock::now() - begin;
+
+  begin = std::chrono::steady_clock::now();
+  CASE_EXPECT_TRUE(actree.freeze());
+  auto freeze_cost = std::chrono::steady_clock::now() - begin;
+
+  size_t frozen_count = 0;
+  begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < 4; ++i) {
+    frozen_count = actree.match_frozen(input).size();
+  }
+  auto frozen_cost = std::chrono::steady_clock::now() - begin;
+
+  // The frozen automaton also finds keywords which end inside a longer partial match
+  CASE_EXPECT_GE(frozen_count, tree_count);
+  CASE_MSG_INFO() << "ac_automation 20000 keywords, 4 x 1MB input, states: "
+                  << actree.get_frozen().get_state_count() << ", frozen size: " << actree.get_frozen().size()
+                  << " bytes, freeze cost: "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(freeze_cost).count() << "ms" << '\n';
+  CASE_MSG_INFO() << "  trie match: " << std::chrono::duration_cast<std::chrono::milliseconds>(tree_cost).count()
+                  << "ms, " << tree_count << " matches; frozen match: "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(frozen_cost).count() << "ms, "
+                  << frozen_count << " matches" << '\n';
+
+  // Startup cost when workers map a prebuilt file instead of rebuilding
+  std::string file_path;
+  atfw::util::file_system::generate_tmp_file_name(file_path);
+  CASE_EXPECT_TRUE(actree.get_frozen().save_file(file_path.c_str()));
+  begin = std::chrono::steady_clock::now();
+  atfw::util::string::ac_automation_dfa_image::ptr_t image =
+      atfw::util::string::ac_automation_dfa_image::open_file(file_path.c_str());
+  auto open_cost = std::chrono::steady_clock::now() - begin;
+  CASE_EXPECT_TRUE(!!image);
+  if (image) {
+    CASE_EXPECT_EQ(frozen_count, image->get().match(input).size());
+  }
+  CASE_MSG_INFO() << "  open mapped file with verify: "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(open_cost).count() << "us" << '\n';
+  atfw::util::file_system::remove(file_path.c_str());
+}
+#endif
+
+CASE_TEST(ac_automation, frozen_prefilter) {
+  std::mt19937 rnd(20260419);
+  for (int round = 0; round < 48; ++round) {
+    bool nocase = 0 != (round & 1);
+    atfw::util::nostd::string_view skip_bytes = 0 != (round & 2) ? " " : "";
+
+    std::vector<std::string> keywords;
+    std::vector<atfw::util::nostd::string_view> keyword_views;
+    // Few keywords over a large alphabet, so the prefilter is enabled
+    for (int i = 0; i < 12; ++i) {
+      keywords.push_back(ac_automation_test_random_string(rnd, 1 + (round % 4), 8, 'z'));
+    }
+    for (auto &keyword : keywords) {
+      keyword_views.push_back(keyword);
+    }
+
+    atfw::util::string::ac_automation_dfa with_prefilter;
+    atfw::util::string::ac_automation_dfa without_prefilter;
+    CASE_EXPECT_TRUE(with_prefilter.build(keyword_views, nocase, skip_bytes, true));
+    CASE_EXPECT_TRUE(without_prefilter.build(keyword_views, nocase, skip_bytes, false));
+    CASE_EXPECT_TRUE(with_prefilter.has_prefilter());
+    CASE_EXPECT_FALSE(without_prefilter.has_prefilter());
+
+    std::string input = ac_automation_test_random_string(rnd, 1024, 4096, 'z');
+    for (size_t i = 0; i < input.size(); ++i) {
+      if (0 == rnd() % 16) {
+        input[i] = ' ';
+      } else if (nocase && 0 == rnd() % 4) {
+        input[i] = static_cast<char>(input[i] - 'a' + 'A');
+      }
+    }
+    // Plant keywords, including ones at the tail which the vector loop can not cover
+    for (int i = 0; i < 8; ++i) {
+      const std::string &keyword = keywords[rnd() % keywords.size()];
+      input.replace(rnd() % (input.size() - keyword.size()), keyword.size(), keyword);
+    }
+    input += keywords[round % keywords.size()];
+
+    for (size_t len : {input.size(), input.size() - 1, static_cast<size_t>(17), static_cast<size_t>(33)}) {
+      atfw::util::nostd::string_view content(input.data(), len);
+      atfw::util::string::ac_automation_dfa::value_type expect = without_prefilter.match(content);
+      atfw::util::string::ac_automation_dfa::value_type res = with_prefilter.match(content);
+      CASE_EXPECT_EQ(expect.size(), res.size());
+      for (size_t i = 0; i < res.size() && i < expect.size(); ++i) {
+        CASE_EXPECT_EQ(expect[i].start, res[i].start);
+        CASE_EXPECT_EQ(expect[i].length, res[i].length);
+        CASE_EXPECT_EQ(expect[i].keyword_index, res[i].keyword_index);
+      }
+      CASE_EXPECT_EQ(without_prefilter.contains(content), with_prefilter.contains(content));
+    }
+  }
+
+  // Saturated masks disable the prefilter
+  std::vector<std::string> keywords;
+  std::vector<atfw::util::nostd::string_view> keyword_views;
+  for (int i = 0; i < 256; ++i) {
+    keywords.push_back(std::string(1, static_cast<char>(i)));
+  }
+  for (auto &keyword : keywords) {
+    keyword_views.push_back(keyword);
+  }
+  atfw::util::string::ac_automation_dfa dfa;
+  CASE_EXPECT_TRUE(dfa.build(keyword_views));
+  CASE_EXPECT_FALSE(dfa.has_prefilter());
+  CASE_EXPECT_EQ(3, dfa.match("abc").size());
+}
+
+#if defined(PROJECT_TEST_MACRO_ENABLE_BENCHMARK) && PROJECT_TEST_MACRO_ENABLE_BENCHMARK
+CASE_TEST(ac_automation, frozen_prefilter_benchmark) {
+  std::mt19937 rnd(20260419);
+  std::vector<std::string> keywords;
+  std::vector<atfw::util::nostd::string_view> keyword_views;
+  for (int i = 0; i < 24; ++i) {
+    keywords.push_back(ac_automation_test_random_string(rnd, 4, 10, 'z'));
+  }
+  for (auto &keyword : keywords) {
+    keyword_views.push_back(keyword);
+  }
+
+  // Text-like input: lower case words separated by spaces and punctuation
+  std::string input;
+  input.reserve((1 << 20) + 16);
+  const char separators[] = " .,\n";
+  while (input.size() < (1 << 20)) {
+    input += ac_automation_test_random_string(rnd, 1, 12, 'z');
+    input.push_back(separators[rnd() % 4]);
+  }
+
+  atfw::util::string::ac_automation_dfa with_prefilter;
+  atfw::util::string::ac_automation_dfa without_prefilter;
+  CASE_EXPECT_TRUE(with_prefilter.build(keyword_views, false, atfw::util::nostd::string_view(), true));
+  CASE_EXPECT_TRUE(without_prefilter.build(keyword_views, false, atfw::util::nostd::string_view(), false));
+  CASE_EXPECT_TRUE(with_prefilter.has_prefilter());
+
+  size_t plain_count = 0;
+  auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < 16; ++i) {
+    plain_count = without_prefilter.match(input).size();
+  }
+  auto plain_cost = std::chrono::steady_clock::now() - begin;
+
+  size_t prefilter_count = 0;
+  begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < 16; ++i) {
+    prefilter_count = with_prefilter.match(input).size();
+  }
+  auto prefilter_cost = std::chrono::steady_clock::now() - begin;
+
+  CASE_EXPECT_EQ(plain_count, prefilter_count);
+  CASE_MSG_INFO() << "ac_automation_dfa 24 keywords, 16 x 1MB text, " << prefilter_count << " matches" << '\n';
+  CASE_MSG_INFO() << "  without prefilter: "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(plain_cost).count()
+                  << "us, with prefilter: "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(prefilter_cost).count() << "us" << '\n';
+}
+#endif
+
+CASE_TEST(ac_automation, frozen_image) {
+  std::vector<atfw::util::nostd::string_view> keywords = {"he", "she", "his", "hers", "say"};
+  atfw::util::string::ac_automation_dfa dfa;
+  CASE_EXPECT_TRUE(dfa.build(keywords, true, " "));
+  atfw::util::string::ac_automation_dfa::value_type expect = dfa.match("uSHErs say h i s");
+  CASE_EXPECT_EQ(3, expect.size());
+
+  // Copy into an unaligned buffer and load
+  std::string raw(reinterpret_cast<const char *>(dfa.data()), dfa.size());
+  std::string unaligned = "x" + raw;
+  atfw::util::string::ac_automation_dfa loaded;
+  CASE_EXPECT_TRUE(loaded.load(unaligned.data() + 1, raw.size()));
+  CASE_EXPECT_TRUE(loaded.is_nocase());
+  CASE_EXPECT_EQ(expect.size(), loaded.match("uSHErs say h i s").size());
+
+  // Attach without copy
+  atfw::util::string::ac_automation_dfa attached;
+  CASE_EXPECT_TRUE(attached.attach(dfa.data(), dfa.size()));
+  CASE_EXPECT_EQ(dfa.data(), attached.data());
+  CASE_EXPECT_EQ(expect.size(), attached.match("uSHErs say h i s").size());
+
+  // Truncated, wrong version and corrupted data are rejected
+  CASE_EXPECT_FALSE(loaded.load(raw.data(), raw.size() - 4));
+  std::string bad_version = raw;
+  bad_version[4] = static_cast<char>(bad_version[4] + 1);
+  CASE_EXPECT_FALSE(loaded.load(bad_version.data(), bad_version.size()));
+  {
+    std::string bad_unit = raw;
+    const atfw::util::string::ac_automation_dfa::header_t *header =
+        reinterpret_cast<const atfw::util::string::ac_automation_dfa::header_t *>(dfa.data());
+    atfw::util::string::ac_automation_dfa::unit_t unit;
+    memcpy(&unit, raw.data() + header->units_offset, sizeof(unit));
+    // Let the root jump out of the unit array
+    unit.base = header->unit_count;
+    memcpy(&bad_unit[header->units_offset], &unit, sizeof(unit));
+    CASE_EXPECT_FALSE(loaded.load(bad_unit.data(), bad_unit.size()));
+  }
+  CASE_EXPECT_TRUE(loaded.empty());
+
+  // Map file, then replace the file while the old mapping is still in use
+  std::string file_path;
+  atfw::util::file_system::generate_tmp_file_name(file_path);
+  CASE_EXPECT_TRUE(dfa.save_file(file_path.c_str()));
+
+  std::string error_message;
+  atfw::util::string::ac_automation_dfa_image::ptr_t image =
+      atfw::util::string::ac_automation_dfa_image::open_file(file_path.c_str(), true, &error_message);
+  CASE_EXPECT_TRUE(!!image);
+  if (!image) {
+    CASE_MSG_INFO() << "open_file failed: " << error_message << '\n';
+    return;
+  }
+  CASE_EXPECT_TRUE(image->is_mapped());
+  CASE_EXPECT_EQ(expect.size(), image->get().match("uSHErs say h i s").size());
+
+  std::vector<atfw::util::nostd::string_view> new_keywords = {"abc"};
+  atfw::util::string::ac_automation_dfa new_dfa;
+  CASE_EXPECT_TRUE(new_dfa.build(new_keywords));
+  CASE_EXPECT_TRUE(new_dfa.save_file(file_path.c_str()));
+  CASE_EXPECT_EQ(expect.size(), image->get().match("uSHErs say h i s").size());
+  CASE_EXPECT_EQ("say", image->get().get_keyword(expect[1].keyword_index));
+
+  atfw::util::string::ac_automation_dfa_image::ptr_t new_image =
+      atfw::util::string::ac_automation_dfa_image::open_file(file_path.c_str());
+  CASE_EXPECT_TRUE(!!new_image);
+  if (new_image) {
+    CASE_EXPECT_EQ(1, new_image->get().match("xxabcxx").size());
+  }
+
+  // Not an automaton file
+  std::string bad_path = file_path + ".bad";
+  {
+    std::fstream fos(bad_path.c_str(), std::ios::out | std::ios::binary);
+    fos << "not an automaton";
+  }
+  CASE_EXPECT_FALSE(!!atfw::util::string::ac_automation_dfa_image::open_file(bad_path.c_str(), true, &error_message));
+  CASE_MSG_INFO() << "open invalid file: " << error_message << '\n';
+
+  atfw::util::file_system::remove(bad_path.c_str());
+  atfw::util::file_system::remove(file_path.c_str());
+}
+
+CASE_TEST(ac_automation, frozen_hot_swap) {
+  std::vector<atfw::util::nostd::string_view> keywords_a = {"alpha", "beta"};
+  std::vector<atfw::util::nostd::string_view> keywords_b = {"gamma"};
+  atfw::util::string::ac_automation_dfa dfa_a;
+  atfw::util::string::ac_automation_dfa dfa_b;
+  CASE_EXPECT_TRUE(dfa_a.build(keywords_a));
+  CASE_EXPECT_TRUE(dfa_b.build(keywords_b));
+  atfw::util::string::ac_automation_dfa_image::ptr_t image_a =
+      atfw::util::string::ac_automation_dfa_image::create(std::move(dfa_a));
+  atfw::util::string::ac_automation_dfa_image::ptr_t image_b =
+      atfw::util::string::ac_automation_dfa_image::create(std::move(dfa_b));
+  CASE_EXPECT_FALSE(image_a->is_mapped());
+
+  atfw::util::string::ac_automation_dfa_holder holder;
+  CASE_EXPECT_FALSE(!!holder.get());
+  holder.exchange(image_a);
+  CASE_EXPECT_EQ(1, holder.get_generation());
+
+  // Every snapshot must be one of the complete automata
+  std::atomic<bool> running(true);
+  std::atomic<size_t> bad_count(0);
+  std::atomic<size_t> match_count(0);
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 2; ++i) {
+    readers.emplace_back([&holder, &running, &bad_count, &match_count]() {
+      while (running.load()) {
+        atfw::util::string::ac_automation_dfa_image::ptr_t image = holder.get();
+        size_t count = image->get().match("alpha beta gamma").size();
+        if (count != 1 && count != 2) {
+          ++bad_count;
+        }
+        ++match_count;
+      }
+    });
+  }
+
+  for (int i = 0; i < 1000; ++i) {
+    holder.exchange(0 == (i & 1) ? image_b : image_a);
+  }
+  while (match_count.load() < 1000) {
+    std::this_thread::yield();
+  }
+  running.store(false);
+  for (auto &reader : readers) {
+    reader.join();
+  }
+
+  CASE_EXPECT_EQ(0, bad_count.load());
+  CASE_EXPECT_EQ(1001, holder.get_generation());
+  CASE_EXPECT_EQ(image_a, holder.get());
+  CASE_EXPECT_FALSE(holder.reload_file("/not/exists/ac_automation.bin"));
+  CASE_EXPECT_EQ(image_a, holder.get());
+}
+
+CASE_TEST(ac_automation, frozen_match_batch) {
+  std::mt19937 rnd(20260421);
+  std::vector<std::string> keywords;
+  std::vector<atfw::util::nostd::string_view> keyword_views;
+  for (int i = 0; i < 256; ++i) {
+    keywords.push_back(ac_automation_test_random_string(rnd, 2, 5, 'k'));
+  }
+  for (auto &keyword : keywords) {
+    keyword_views.push_back(keyword);
+  }
+  atfw::util::string::ac_automation_dfa dfa;
+  CASE_EXPECT_TRUE(dfa.build(keyword_views));
+
+  std::vector<std::string> inputs;
+  std::vector<atfw::util::nostd::string_view> input_views;
+  for (int i = 0; i < 3000; ++i) {
+    inputs.push_back(ac_automation_test_random_string(rnd, 0, 64, 'm'));
+  }
+  for (auto &input : inputs) {
+    input_views.push_back(input);
+  }
+
+  atfw::util::thread::work_stealing_pool pool(2);
+  atfw::util::string::ac_automation_dfa::batch_result_t serial_result;
+  atfw::util::string::ac_automation_dfa::batch_result_t parallel_result;
+  size_t serial_count = dfa.match_batch(input_views, serial_result);
+  size_t parallel_count = dfa.match_batch(input_views, parallel_result, &pool);
+  CASE_EXPECT_EQ(serial_count, parallel_count);
+  CASE_EXPECT_EQ(inputs.size(), serial_result.size());
+  CASE_EXPECT_EQ(inputs.size(), parallel_result.size());
+
+  size_t total = 0;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    atfw::util::string::ac_automation_dfa::value_type expect = dfa.match(inputs[i]);
+    total += expect.size();
+    auto serial = serial_result.get(i);
+    auto parallel = parallel_result.get(i);
+    CASE_EXPECT_EQ(expect.size(), serial.size());
+    CASE_EXPECT_EQ(expect.size(), parallel.size());
+    for (size_t j = 0; j < expect.size() && j < serial.size() && j < parallel.size(); ++j) {
+      CASE_EXPECT_EQ(expect[j].start, parallel[j].start);
+      CASE_EXPECT_EQ(expect[j].length, parallel[j].length);
+      CASE_EXPECT_EQ(expect[j].keyword_index, parallel[j].keyword_index);
+      CASE_EXPECT_EQ(expect[j].keyword_index, serial[j].keyword_index);
+    }
+  }
+  CASE_EXPECT_EQ(total, parallel_count);
+  CASE_EXPECT_FALSE(parallel_result.scratches.empty());
+
+  // Reuse the result and call from a worker of the same pool
+  std::atomic<size_t> worker_count(0);
+  pool.post([&dfa, &input_views, &parallel_result, &pool, &worker_count]() {
+    worker_count.store(dfa.match_batch(input_views, parallel_result, &pool) + 1);
+  });
+  pool.wait_idle();
+  CASE_EXPECT_EQ(total + 1, worker_count.load());
+  CASE_EXPECT_EQ(0, dfa.match_batch(gsl::span<const atfw::util::nostd::string_view>(), parallel_result, &pool));
+  CASE_EXPECT_EQ(0, parallel_result.size());
+}
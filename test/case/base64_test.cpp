@@ -1,8 +1,11 @@
 // Copyright 2026 atframework
 
+#include <chrono>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <string>
+#include <vector>
 
 #include "frame/test_macros.h"
 
@@ -250,3 +253,244 @@ CASE_TEST(base64, decode_url) {
   CASE_EXPECT_EQ(0, memcmp(base64_test_dec, buffer, 64));
 }
 
+
+namespace {
+static const atfw::util::base64_mode_t::type kBase64TestModes[] = {
+    atfw::util::base64_mode_t::EN_BMT_STANDARD, atfw::util::base64_mode_t::EN_BMT_UTF7,
+    atfw::util::base64_mode_t::EN_BMT_IMAP_MAILBOX_NAME, atfw::util::base64_mode_t::EN_BMT_URL_FILENAME_SAFE};
+
+// Plain reference implementation, used to check the SIMD paths
+static std::string base64_test_reference_encode(const std::string &in, atfw::util::base64_mode_t::type mode) {
+  std::string alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+  bool padding = true;
+  switch (mode) {
+    case atfw::util::base64_mode_t::EN_BMT_UTF7:
+      alphabet += "+/";
+      padding = false;
+      break;
+    case atfw::util::base64_mode_t::EN_BMT_IMAP_MAILBOX_NAME:
+      alphabet += "+,";
+      padding = false;
+      break;
+    case atfw::util::base64_mode_t::EN_BMT_URL_FILENAME_SAFE:
+      alphabet += "-_";
+      break;
+    default:
+      alphabet += "+/";
+      break;
+  }
+
+  std::string ret;
+  uint32_t bits = 0;
+  size_t bit_count = 0;
+  for (char c : in) {
+    bits = (bits << 8) | static_cast<unsigned char>(c);
+    bit_count += 8;
+    while (bit_count >= 6) {
+      bit_count -= 6;
+      ret.push_back(alphabet[(bits >> bit_count) & 0x3F]);
+    }
+  }
+  if (bit_count > 0) {
+    ret.push_back(alphabet[(bits << (6 - bit_count)) & 0x3F]);
+  }
+  while (padding && ret.size() % 4 != 0) {
+    ret.push_back('=');
+  }
+  return ret;
+}
+
+static std::string base64_test_random_bytes(size_t len, uint32_t &seed) {
+  std::string ret;
+  ret.resize(len);
+  for (size_t i = 0; i < len; ++i) {
+    seed = seed * 1103515245 + 12345;
+    ret[i] = static_cast<char>(seed >> 16);
+  }
+  return ret;
+}
+}  // namespace
+
+CASE_TEST(base64, simd_round_trip) {
+  uint32_t seed = 1;
+  for (atfw::util::base64_mode_t::type mode : kBase64TestModes) {
+    bool all_match = true;
+    for (size_t len = 0; len < 300; ++len) {
+      std::string in = base64_test_random_bytes(len, seed);
+      std::string encoded;
+      std::string decoded;
+      atfw::util::base64_encode(encoded, in, mode);
+      if (encoded != base64_test_reference_encode(in, mode)) {
+        all_match = false;
+      }
+      if (0 != atfw::util::base64_decode(decoded, encoded, mode) || decoded != in) {
+        all_match = false;
+      }
+    }
+    CASE_EXPECT_TRUE(all_match);
+  }
+
+  std::string in = base64_test_random_bytes(1000, seed);
+  std::string encoded;
+  atfw::util::base64_encode(encoded, in);
+
+  // Invalid character inside the range of SIMD blocks
+  for (size_t pos : {size_t(0), size_t(15), size_t(31), size_t(100), encoded.size() - 5}) {
+    std::string broken = encoded;
+    broken[pos] = '*';
+    std::string decoded;
+    CASE_EXPECT_EQ(-2, atfw::util::base64_decode(decoded, broken));
+    broken[pos] = static_cast<char>(0xC3);
+    CASE_EXPECT_EQ(-2, atfw::util::base64_decode(decoded, broken));
+  }
+
+  // Space inside a line is still an error after a SIMD prefix
+  {
+    std::string broken = encoded.substr(0, 64) + " " + encoded.substr(64);
+    std::string decoded;
+    CASE_EXPECT_EQ(-2, atfw::util::base64_decode(decoded, broken));
+  }
+
+  // MIME style line breaks
+  {
+    std::string wrapped;
+    for (size_t i = 0; i < encoded.size(); i += 76) {
+      wrapped += encoded.substr(i, 76);
+      wrapped += "\r\n";
+    }
+    std::string decoded;
+    CASE_EXPECT_EQ(0, atfw::util::base64_decode(decoded, wrapped));
+    CASE_EXPECT_TRUE(decoded == in);
+  }
+
+  // Output buffer shorter than the SIMD part, nothing is written when returning -1
+  {
+    std::vector<unsigned char> buffer(in.size() - 1, 0xA5);
+    size_t olen = 0;
+    CASE_EXPECT_EQ(-1, atfw::util::base64_decode(buffer.data(), buffer.size(), &olen,
+                                                 reinterpret_cast<const unsigned char *>(encoded.c_str()),
+                                                 encoded.size()));
+    CASE_EXPECT_EQ(in.size(), olen);
+    CASE_EXPECT_TRUE(std::vector<unsigned char>(in.size() - 1, 0xA5) == buffer);
+  }
+
+  // Invalid character after the SIMD prefix, nothing is written when returning -2
+  {
+    std::string broken = encoded;
+    broken[broken.size() - 3] = '*';
+    std::vector<unsigned char> buffer(broken.size(), 0xA5);
+    size_t olen = 0;
+    CASE_EXPECT_EQ(-2, atfw::util::base64_decode(buffer.data(), buffer.size(), &olen,
+                                                 reinterpret_cast<const unsigned char *>(broken.c_str()),
+                                                 broken.size()));
+    CASE_EXPECT_TRUE(std::vector<unsigned char>(broken.size(), 0xA5) == buffer);
+  }
+
+  // Line breaks make the upper bound larger than the real size, an exact buffer still works
+  {
+    std::string wrapped;
+    for (size_t i = 0; i < encoded.size(); i += 64) {
+      wrapped += encoded.substr(i, 64);
+      wrapped += "\n";
+    }
+    std::vector<unsigned char> buffer(in.size());
+    size_t olen = 0;
+    CASE_EXPECT_EQ(0, atfw::util::base64_decode(buffer.data(), buffer.size(), &olen,
+                                                reinterpret_cast<const unsigned char *>(wrapped.c_str()),
+                                                wrapped.size()));
+    CASE_EXPECT_EQ(in.size(), olen);
+    CASE_EXPECT_TRUE(in == std::string(reinterpret_cast<const char *>(buffer.data()), olen));
+  }
+}
+
+CASE_TEST(base64, streaming) {
+  uint32_t seed = 2;
+  std::string in = base64_test_random_bytes(4099, seed);
+  for (atfw::util::base64_mode_t::type mode : kBase64TestModes) {
+    std::string expect;
+    atfw::util::base64_encode(expect, in, mode);
+
+    for (size_t chunk : {size_t(1), size_t(2), size_t(7), size_t(16), size_t(100), size_t(4096)}) {
+      atfw::util::base64_encoder encoder(mode);
+      std::string encoded;
+      for (size_t i = 0; i < in.size(); i += chunk) {
+        size_t len = in.size() - i < chunk ? in.size() - i : chunk;
+        CASE_EXPECT_EQ(0, encoder.update(encoded, reinterpret_cast<const unsigned char *>(in.data()) + i, len));
+      }
+      CASE_EXPECT_EQ(0, encoder.finish(encoded));
+      CASE_EXPECT_TRUE(encoded == expect);
+
+      atfw::util::base64_decoder decoder(mode);
+      std::string decoded;
+      for (size_t i = 0; i < expect.size(); i += chunk) {
+        size_t len = expect.size() - i < chunk ? expect.size() - i : chunk;
+        CASE_EXPECT_EQ(0, decoder.update(decoded, reinterpret_cast<const unsigned char *>(expect.data()) + i, len));
+      }
+      CASE_EXPECT_EQ(0, decoder.finish(decoded));
+      CASE_EXPECT_TRUE(decoded == in);
+    }
+  }
+
+  // Insufficient buffer does not consume input
+  {
+    atfw::util::base64_encoder encoder;
+    unsigned char buffer[8];
+    size_t olen = 0;
+    CASE_EXPECT_EQ(-1, encoder.update(buffer, sizeof(buffer), &olen, base64_test_dec, 9));
+    CASE_EXPECT_EQ(12, olen);
+    CASE_EXPECT_EQ(0, encoder.update(buffer, sizeof(buffer), &olen, base64_test_dec, 4));
+    CASE_EXPECT_EQ(4, olen);
+    CASE_EXPECT_EQ(0, encoder.finish(buffer + 4, sizeof(buffer) - 4, &olen));
+    CASE_EXPECT_EQ(4, olen);
+    CASE_EXPECT_EQ(0, memcmp(buffer, "JEhuVg==", 8));
+  }
+
+  // Whitespace, padding and truncated stream
+  {
+    atfw::util::base64_decoder decoder;
+    std::string decoded;
+    const char *input = "JE hu\nVg=\r\n=";
+    CASE_EXPECT_EQ(0, decoder.update(decoded, reinterpret_cast<const unsigned char *>(input), strlen(input)));
+    CASE_EXPECT_EQ(0, decoder.finish(decoded));
+    CASE_EXPECT_EQ(4, decoded.size());
+    CASE_EXPECT_EQ(0, memcmp(decoded.data(), base64_test_dec, 4));
+
+    const char *truncated = "JEhuV";
+    CASE_EXPECT_EQ(0, decoder.update(decoded, reinterpret_cast<const unsigned char *>(truncated), 5));
+    CASE_EXPECT_EQ(-2, decoder.finish(decoded));
+    decoder.reset();
+
+    const char *bad_padding = "JE=h";
+    CASE_EXPECT_EQ(-2, decoder.update(decoded, reinterpret_cast<const unsigned char *>(bad_padding), 4));
+  }
+}
+
+#if defined(PROJECT_TEST_MACRO_ENABLE_BENCHMARK) && PROJECT_TEST_MACRO_ENABLE_BENCHMARK
+CASE_TEST(base64, benchmark) {
+  uint32_t seed = 3;
+  std::string in = base64_test_random_bytes(8 * 1024 * 1024, seed);
+  std::vector<unsigned char> encoded(in.size() / 3 * 4 + 8);
+  std::vector<unsigned char> decoded(in.size());
+  size_t encoded_len = 0;
+  size_t decoded_len = 0;
+
+  std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+  CASE_EXPECT_EQ(0, atfw::util::base64_encode(encoded.data(), encoded.size(), &encoded_len,
+                                              reinterpret_cast<const unsigned char *>(in.data()), in.size()));
+  std::chrono::steady_clock::time_point encode_end = std::chrono::steady_clock::now();
+  CASE_EXPECT_EQ(0, atfw::util::base64_decode(decoded.data(), decoded.size(), &decoded_len, encoded.data(),
+                                              encoded_len));
+  std::chrono::steady_clock::time_point decode_end = std::chrono::steady_clock::now();
+  CASE_EXPECT_EQ(in.size(), decoded_len);
+  CASE_EXPECT_EQ(0, memcmp(in.data(), decoded.data(), in.size()));
+
+  int64_t encode_usec =
+      static_cast<int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(encode_end - begin).count());
+  int64_t decode_usec =
+      static_cast<int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(decode_end - encode_end).count());
+  CASE_MSG_INFO() << "base64 encode " << in.size() << " bytes: " << encode_usec << "us("
+                  << (encode_usec > 0 ? static_cast<int64_t>(in.size()) / encode_usec : 0) << "MB/s), decode: "
+                  << decode_usec << "us(" << (decode_usec > 0 ? static_cast<int64_t>(in.size()) / decode_usec : 0)
+                  << "MB/s)" << '\n';
+}
+#endif
@@ -0,0 +1,146 @@
+// Copyright 2026 atframework
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "frame/test_macros.h"
+
+#include "string/compiled_format.h"
+
+#if defined(ATFRAMEWORK_UTILS_STRING_ENABLE_FWAPI) && ATFRAMEWORK_UTILS_STRING_ENABLE_FWAPI
+#  include "string/string_format.h"
+#endif
+
+namespace {
+static constexpr auto kCompiledFormatTestLogin =
+    atfw::util::string::make_compiled_format<int64_t, atfw::util::nostd::string_view, uint32_t, bool>(
+        "user {} login from {}, zone {:08}, new: {}");
+
+static constexpr auto kCompiledFormatTestFixed =
+    atfw::util::string::make_compiled_format<int32_t, uint64_t, char, double>("{}|{:x}|{}|{}");
+}  // namespace
+
+CASE_TEST(compiled_format, parse) {
+  CASE_EXPECT_TRUE(kCompiledFormatTestLogin.valid());
+  CASE_EXPECT_EQ(strlen("user  login from , zone , new: "), kCompiledFormatTestLogin.literal_size());
+
+  // The maximum size of fixed width types is known at compile time
+  static_assert(kCompiledFormatTestFixed.max_size() > 0, "max_size should be constexpr");
+  CASE_EXPECT_EQ(3 + (std::numeric_limits<int32_t>::digits10 + 2) + (std::numeric_limits<uint64_t>::digits10 + 2) +
+                     1 + (std::numeric_limits<double>::max_digits10 + 8),
+                 kCompiledFormatTestFixed.max_size());
+
+  constexpr auto escaped = atfw::util::string::make_compiled_format<int>("{{{}}}");
+  CASE_EXPECT_TRUE(escaped.valid());
+  CASE_EXPECT_EQ("{42}", escaped.format(42));
+
+  // Not constexpr, so invalid formats are only reported by valid()
+  auto unmatched = atfw::util::string::compiled_format<4, int>("{}}");
+  CASE_EXPECT_FALSE(unmatched.valid());
+  auto too_many = atfw::util::string::compiled_format<5, int>("{}{}");
+  CASE_EXPECT_FALSE(too_many.valid());
+  auto not_enough = atfw::util::string::compiled_format<3, int, int>("{}");
+  CASE_EXPECT_FALSE(not_enough.valid());
+  auto bad_spec = atfw::util::string::compiled_format<5, int>("{:q}");
+  CASE_EXPECT_FALSE(bad_spec.valid());
+  CASE_EXPECT_EQ("", bad_spec.format(1));
+}
+
+CASE_TEST(compiled_format, format) {
+  CASE_EXPECT_EQ("user -42 login from 127.0.0.1, zone 00000012, new: true",
+                 kCompiledFormatTestLogin.format(-42, "127.0.0.1", 12, true));
+  CASE_EXPECT_EQ("-2147483648|ffffffffffffffff|c|0.1",
+                 kCompiledFormatTestFixed.format(std::numeric_limits<int32_t>::min(),
+                                                 std::numeric_limits<uint64_t>::max(), 'c', 0.1));
+
+  constexpr auto padded = atfw::util::string::make_compiled_format<int, int, std::string, const char *, int>(
+      "[{:6}][{:06}][{:5}][{}][{:X}]");
+  CASE_EXPECT_EQ("[   -12][-00012][ab   ][][-FF]", padded.format(-12, -12, "ab", nullptr, -255));
+
+  const void *pointer = reinterpret_cast<const void *>(static_cast<uintptr_t>(0x1234));
+  constexpr auto pointer_format = atfw::util::string::make_compiled_format<const void *>("{}");
+  CASE_EXPECT_EQ("0x1234", pointer_format.format(pointer));
+
+  std::string append = "prefix:";
+  CASE_EXPECT_EQ(4, pointer_format.format_to(append, reinterpret_cast<const void *>(static_cast<uintptr_t>(0xab))));
+  CASE_EXPECT_EQ("prefix:0xab", append);
+}
+
+CASE_TEST(compiled_format, truncate) {
+  std::string expect = kCompiledFormatTestLogin.format(123456789, "192.168.100.200", 7, false);
+  CASE_EXPECT_GT(kCompiledFormatTestLogin.max_formatted_size(123456789, "192.168.100.200", 7, false), expect.size());
+
+  // Every buffer size shorter than the upper bound uses the checked path
+  for (size_t size = 0; size <= expect.size() + 2; ++size) {
+    char buffer[128];
+    memset(buffer, '#', sizeof(buffer));
+    size_t written = kCompiledFormatTestLogin.format_to(buffer, size, 123456789, "192.168.100.200", 7, false);
+    size_t expect_size = size < expect.size() ? size : expect.size();
+    CASE_EXPECT_EQ(expect_size, written);
+    CASE_EXPECT_EQ(expect.substr(0, expect_size), std::string(buffer, written));
+    CASE_EXPECT_EQ('#', buffer[size]);
+  }
+}
+
+#if defined(PROJECT_TEST_MACRO_ENABLE_BENCHMARK) && PROJECT_TEST_MACRO_ENABLE_BENCHMARK
+CASE_TEST(compiled_format, benchmark) {
+  std::mt19937_64 rnd(20261019);
+  std::vector<int64_t> user_ids;
+  std::vector<std::string> addresses;
+  for (int i = 0; i < 1024; ++i) {
+    user_ids.push_back(static_cast<int64_t>(rnd() >> (rnd() % 64)));
+    addresses.push_back(std::to_string(rnd() % 256) + "." + std::to_string(rnd() % 256) + "." +
+                        std::to_string(rnd() % 256) + "." + std::to_string(rnd() % 256));
+  }
+
+  char buffer[256];
+  size_t snprintf_size = 0;
+  auto begin = std::chrono::steady_clock::now();
+  for (int loop = 0; loop < 64; ++loop) {
+    for (size_t i = 0; i < user_ids.size(); ++i) {
+      int res = UTIL_STRFUNC_SNPRINTF(buffer, sizeof(buffer), "user %lld login from %s, zone %08u, new: %s",
+                                      static_cast<long long>(user_ids[i]), addresses[i].c_str(),
+                                      static_cast<unsigned int>(i), 0 == (i & 1) ? "true" : "false");
+      snprintf_size += static_cast<size_t>(res);
+    }
+  }
+  auto snprintf_cost = std::chrono::steady_clock::now() - begin;
+
+#  if defined(ATFRAMEWORK_UTILS_STRING_ENABLE_FWAPI) && ATFRAMEWORK_UTILS_STRING_ENABLE_FWAPI
+  size_t fwapi_size = 0;
+  begin = std::chrono::steady_clock::now();
+  for (int loop = 0; loop < 64; ++loop) {
+    for (size_t i = 0; i < user_ids.size(); ++i) {
+      auto res = atfw::util::string::format_to_n(buffer, sizeof(buffer), "user {} login from {}, zone {:08}, new: {}",
+                                                 user_ids[i], addresses[i], static_cast<uint32_t>(i), 0 == (i & 1));
+      fwapi_size += static_cast<size_t>(res.size);
+    }
+  }
+  auto fwapi_cost = std::chrono::steady_clock::now() - begin;
+  CASE_EXPECT_EQ(snprintf_size, fwapi_size);
+  CASE_MSG_INFO() << "format_to_n 64 x 1024 lines: "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(fwapi_cost).count() << "us" << '\n';
+#  endif
+
+  size_t compiled_size = 0;
+  begin = std::chrono::steady_clock::now();
+  for (int loop = 0; loop < 64; ++loop) {
+    for (size_t i = 0; i < user_ids.size(); ++i) {
+      compiled_size += kCompiledFormatTestLogin.format_to(buffer, sizeof(buffer), user_ids[i], addresses[i],
+                                                          static_cast<uint32_t>(i), 0 == (i & 1));
+    }
+  }
+  auto compiled_cost = std::chrono::steady_clock::now() - begin;
+
+  CASE_EXPECT_EQ(snprintf_size, compiled_size);
+  CASE_MSG_INFO() << "snprintf 64 x 1024 lines: "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(snprintf_cost).count()
+                  << "us, compiled_format: "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(compiled_cost).count() << "us" << '\n';
+}
+#endif
@@ -3,12 +3,15 @@
 #include <algorithm/compression.h>
 
 #include <algorithm>
+#include <chrono>
 #include <cstring>
 #include <string>
 #include <vector>
 
 #include "frame/test_macros.h"
 
+#include "thread/work_stealing_pool.h"
+
 #ifdef ATFW_UTIL_MACRO_COMPRESSION_ENABLED
 
 namespace {
@@ -42,6 +45,71 @@ static void verify_roundtrip(atfw::util::compression::algorithm_t algorithm) {
   }
 }
 
+// Small json-like messages which share most of their structure
+static std::vector<unsigned char> make_small_message(size_t index) {
+  std::string message = "{\"user_id\":" + std::to_string(100000 + index * 7) + ",\"zone_id\":" +
+                        std::to_string(index % 16) + ",\"name\":\"player_" + std::to_string(index) +
+                        "\",\"level\":" + std::to_string(index % 90) +
+                        ",\"items\":[{\"id\":1001,\"count\":" + std::to_string(index % 5) +
+                        "},{\"id\":2002,\"count\":1}],\"online\":true}";
+  return std::vector<unsigned char>(message.begin(), message.end());
+}
+
+// Looks like encrypted payloads
+static std::vector<unsigned char> make_random_data(size_t size, uint64_t seed) {
+  std::vector<unsigned char> data;
+  data.reserve(size);
+  for (size_t i = 0; i < size; ++i) {
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    data.push_back(static_cast<unsigned char>(seed >> 24));
+  }
+  return data;
+}
+
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZSTD) || defined(ATFW_UTIL_MACRO_COMPRESSION_LZ4) || \
+      defined(ATFW_UTIL_MACRO_COMPRESSION_ZLIB)
+static void verify_stream_roundtrip(atfw::util::compression::algorithm_t algorithm) {
+  std::vector<unsigned char> input = make_sample_data();
+  // Append some less compressible data so that output spans several blocks
+  for (size_t i = 0; i < 200000; ++i) {
+    input.push_back(static_cast<unsigned char>((i * 2654435761U) >> 13));
+  }
+
+  atfw::util::compression::compressor comp;
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk, comp.init(algorithm));
+
+  atfw::util::compression::decompressor decomp;
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk, decomp.init(algorithm));
+
+  // Run twice to make sure contexts are reusable between frames
+  for (int round = 0; round < 2; ++round) {
+    std::vector<unsigned char> compressed;
+    CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk, comp.stream_begin());
+    for (size_t offset = 0; offset < input.size(); offset += 1000) {
+      size_t len = std::min<size_t>(1000, input.size() - offset);
+      CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk,
+                     comp.stream_update(gsl::make_span(input.data() + offset, len), compressed));
+    }
+    CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk, comp.stream_end(compressed));
+    CASE_EXPECT_LT(compressed.size(), input.size());
+
+    // Split compressed data at arbitrary positions
+    std::vector<unsigned char> decompressed;
+    CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk, decomp.stream_begin());
+    for (size_t offset = 0; offset < compressed.size(); offset += 777) {
+      CASE_EXPECT_FALSE(decomp.is_stream_finished());
+      size_t len = std::min<size_t>(777, compressed.size() - offset);
+      CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk,
+                     decomp.stream_update(gsl::make_span(compressed.data() + offset, len), decompressed));
+    }
+    CASE_EXPECT_TRUE(decomp.is_stream_finished());
+    CASE_EXPECT_TRUE(input == decompressed);
+  }
+}
+#  endif
+
 }  // namespace
 
 CASE_TEST(compression, supported_algorithms_roundtrip) {
@@ -276,4 +344,610 @@ CASE_TEST(compression, small_input) {
   }
 }
 
+CASE_TEST(compression, compressor_roundtrip) {
+  auto algos = atfw::util::compression::get_supported_algorithms();
+  std::vector<unsigned char> input = make_sample_data();
+
+  for (auto algo : algos) {
+    atfw::util::compression::compressor comp;
+    CASE_EXPECT_FALSE(comp.is_valid());
+    CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk,
+                   comp.init(algo, atfw::util::compression::level_t::kBalanced));
+    CASE_EXPECT_TRUE(comp.is_valid());
+    CASE_EXPECT_TRUE(algo == comp.get_algorithm());
+
+    atfw::util::compression::decompressor decomp;
+    CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk, decomp.init(algo));
+
+    std::vector<unsigned char> compressed;
+    std::vector<unsigned char> decompressed;
+    for (size_t i = 0; i < 3; ++i) {
+      std::vector<unsigned char> message = make_small_message(i);
+      const std::vector<unsigned char>& data = i == 0 ? input : message;
+
+      CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk, comp.compress(gsl::make_span(data), compressed));
+      CASE_EXPECT_LE(compressed.size(), comp.compress_bound(data.size()));
+
+      // Output of compressor is compatible with compression::decompress()
+      CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk,
+                     atfw::util::compression::decompress(algo, gsl::make_span(compressed), data.size(), decompressed));
+      CASE_EXPECT_TRUE(data == decompressed);
+
+      CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk,
+                     decomp.decompress(gsl::make_span(compressed), data.size(), decompressed));
+      CASE_EXPECT_TRUE(data == decompressed);
+    }
+
+    // Output of compression::compress() can be decoded by decompressor
+    CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk,
+                   atfw::util::compression::compress(algo, gsl::make_span(input), compressed));
+    CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk,
+                   decomp.decompress(gsl::make_span(compressed), input.size(), decompressed));
+    CASE_EXPECT_TRUE(input == decompressed);
+
+    // Move keeps the context
+    atfw::util::compression::compressor moved = std::move(comp);
+    CASE_EXPECT_FALSE(comp.is_valid());
+    CASE_EXPECT_TRUE(moved.is_valid());
+    CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk, moved.compress(gsl::make_span(input), compressed));
+    moved.close();
+    CASE_EXPECT_FALSE(moved.is_valid());
+    CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kInvalidParam,
+                   moved.compress(gsl::make_span(input), compressed));
+  }
+
+  atfw::util::compression::compressor comp;
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kInvalidParam,
+                 comp.init(atfw::util::compression::algorithm_t::kNone));
+  atfw::util::compression::decompressor decomp;
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kInvalidParam,
+                 decomp.init(atfw::util::compression::algorithm_t::kNone));
+}
+
+CASE_TEST(compression, compressor_buffer_too_small) {
+  auto algos = atfw::util::compression::get_supported_algorithms();
+  std::vector<unsigned char> input = make_sample_data();
+
+  for (auto algo : algos) {
+    atfw::util::compression::compressor comp;
+    CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk, comp.init(algo));
+
+    std::vector<unsigned char> output;
+    output.resize(comp.compress_bound(input.size()));
+    size_t output_size = 0;
+    CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk,
+                   comp.compress(gsl::make_span(input), gsl::make_span(output), output_size));
+
+    unsigned char small_buffer[8];
+    size_t small_size = 0;
+    CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kBufferTooSmall,
+                   comp.compress(gsl::make_span(input), gsl::make_span(small_buffer), small_size));
+    CASE_EXPECT_EQ(0, small_size);
+
+    // Context is still usable after failure
+    std::vector<unsigned char> second;
+    CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk, comp.compress(gsl::make_span(input), second));
+    CASE_EXPECT_EQ(output_size, second.size());
+
+    atfw::util::compression::decompressor decomp;
+    CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk, decomp.init(algo));
+    std::vector<unsigned char> decompressed;
+    decompressed.resize(input.size());
+    size_t decompressed_size = 0;
+    CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk,
+                   decomp.decompress(gsl::make_span(second), gsl::make_span(decompressed), decompressed_size));
+    CASE_EXPECT_EQ(input.size(), decompressed_size);
+    if (algo != atfw::util::compression::algorithm_t::kLz4) {
+      // Raw LZ4 block can not tell a small buffer from corrupted data
+      CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kBufferTooSmall,
+                     decomp.decompress(gsl::make_span(second), gsl::make_span(small_buffer), decompressed_size));
+    }
+  }
+}
+
+CASE_TEST(compression, compressor_streaming) {
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZSTD)
+  verify_stream_roundtrip(atfw::util::compression::algorithm_t::kZstd);
+#  endif
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_LZ4)
+  verify_stream_roundtrip(atfw::util::compression::algorithm_t::kLz4);
+#  endif
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZLIB)
+  verify_stream_roundtrip(atfw::util::compression::algorithm_t::kZlib);
+#  endif
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_SNAPPY)
+  atfw::util::compression::compressor comp;
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk,
+                 comp.init(atfw::util::compression::algorithm_t::kSnappy));
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kNotSupport, comp.stream_begin());
+#  endif
+}
+
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZSTD)
+CASE_TEST(compression, zstd_dictionary) {
+  std::vector<unsigned char> samples;
+  std::vector<size_t> sample_sizes;
+  for (size_t i = 0; i < 2000; ++i) {
+    std::vector<unsigned char> message = make_small_message(i);
+    samples.insert(samples.end(), message.begin(), message.end());
+    sample_sizes.push_back(message.size());
+  }
+
+  std::vector<unsigned char> dictionary;
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk,
+                 atfw::util::compression::train_dictionary(atfw::util::compression::algorithm_t::kZstd,
+                                                           gsl::make_span(samples), gsl::make_span(sample_sizes), 8192,
+                                                           dictionary));
+  CASE_EXPECT_FALSE(dictionary.empty());
+  CASE_EXPECT_LE(dictionary.size(), 8192);
+
+  atfw::util::compression::compressor comp;
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk, comp.init(atfw::util::compression::algorithm_t::kZstd));
+  atfw::util::compression::decompressor decomp;
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk, decomp.init(atfw::util::compression::algorithm_t::kZstd));
+
+  std::vector<unsigned char> message = make_small_message(123456);
+  std::vector<unsigned char> without_dictionary;
+  std::vector<unsigned char> with_dictionary;
+  std::vector<unsigned char> decompressed;
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk,
+                 comp.compress(gsl::make_span(message), without_dictionary));
+
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk, comp.load_dictionary(gsl::make_span(dictionary)));
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk, comp.compress(gsl::make_span(message), with_dictionary));
+  CASE_MSG_INFO() << "zstd small message: " << message.size() << " bytes, without dictionary "
+                  << without_dictionary.size() << " bytes, with dictionary " << with_dictionary.size() << " bytes"
+                  << '\n';
+  CASE_EXPECT_LT(with_dictionary.size(), without_dictionary.size());
+
+  // Decompressing without the dictionary must fail
+  CASE_EXPECT_NE(atfw::util::compression::error_code_t::kOk,
+                 decomp.decompress(gsl::make_span(with_dictionary), 0, decompressed));
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk, decomp.load_dictionary(gsl::make_span(dictionary)));
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk,
+                 decomp.decompress(gsl::make_span(with_dictionary), 0, decompressed));
+  CASE_EXPECT_TRUE(message == decompressed);
+
+  // Streaming uses the dictionary too
+  std::vector<unsigned char> stream_output;
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk, comp.stream_begin());
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk,
+                 comp.stream_update(gsl::make_span(message), stream_output));
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk, comp.stream_end(stream_output));
+  decompressed.clear();
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk, decomp.stream_begin());
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk,
+                 decomp.stream_update(gsl::make_span(stream_output), decompressed));
+  CASE_EXPECT_TRUE(decomp.is_stream_finished());
+  CASE_EXPECT_TRUE(message == decompressed);
+
+  // Unload
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk,
+                 comp.load_dictionary(gsl::span<const unsigned char>()));
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk, comp.compress(gsl::make_span(message), with_dictionary));
+  CASE_EXPECT_TRUE(with_dictionary == without_dictionary);
+
+  // Other algorithms do not support dictionaries
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kInvalidParam,
+                 atfw::util::compression::train_dictionary(atfw::util::compression::algorithm_t::kNone,
+                                                           gsl::make_span(samples), gsl::make_span(sample_sizes), 8192,
+                                                           dictionary));
+}
+#  endif
+
+#  if defined(PROJECT_TEST_MACRO_ENABLE_BENCHMARK) && PROJECT_TEST_MACRO_ENABLE_BENCHMARK
+CASE_TEST(compression, small_message_benchmark) {
+  auto algos = atfw::util::compression::get_supported_algorithms();
+  std::vector<std::vector<unsigned char>> messages;
+  for (size_t i = 0; i < 1024; ++i) {
+    messages.push_back(make_small_message(i));
+  }
+
+  for (auto algo : algos) {
+    const size_t loop_count = 8;
+    std::vector<unsigned char> output;
+    size_t total_size = 0;
+
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    for (size_t loop = 0; loop < loop_count; ++loop) {
+      for (auto& message : messages) {
+        atfw::util::compression::compress(algo, gsl::make_span(message), output);
+        total_size += output.size();
+      }
+    }
+    auto free_function_usec =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count();
+
+    atfw::util::compression::compressor comp;
+    CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk, comp.init(algo));
+    begin = std::chrono::steady_clock::now();
+    for (size_t loop = 0; loop < loop_count; ++loop) {
+      for (auto& message : messages) {
+        comp.compress(gsl::make_span(message), output);
+        total_size += output.size();
+      }
+    }
+    auto reused_usec =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count();
+
+    CASE_MSG_INFO() << atfw::util::compression::get_algorithm_name(algo) << " " << messages.size() * loop_count
+                    << " small messages: free function " << free_function_usec << "us, reused compressor "
+                    << reused_usec << "us (output " << total_size << " bytes)" << '\n';
+  }
+}
+#  endif
+
+CASE_TEST(compression, compressor_worker_count) {
+#  if defined(ATFW_UTIL_MACRO_COMPRESSION_ZSTD)
+  std::vector<unsigned char> input;
+  for (size_t i = 0; i < 64; ++i) {
+    std::vector<unsigned char> sample = make_sample_data();
+    input.insert(input.end(), sample.begin(), sample.end());
+  }
+
+  atfw::util::compression::compressor comp;
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk, comp.init(atfw::util::compression::algorithm_t::kZstd));
+  int ret = comp.set_worker_count(4);
+  // libzstd may be built without multithread support
+  CASE_EXPECT_TRUE(atfw::util::compression::error_code_t::kOk == ret ||
+                   atfw::util::compression::error_code_t::kNotSupport == ret);
+
+  std::vector<unsigned char> compressed;
+  std::vector<unsigned char> decompressed;
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk, comp.compress(gsl::make_span(input), compressed));
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk,
+                 atfw::util::compression::decompress(atfw::util::compression::algorithm_t::kZstd,
+                                                     gsl::make_span(compressed), 0, decompressed));
+  CASE_EXPECT_TRUE(input == decompressed);
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk, comp.set_worker_count(0));
+#  endif
+}
+
+CASE_TEST(compression, block_container) {
+  auto algos = atfw::util::compression::get_supported_algorithms();
+  std::vector<unsigned char> input;
+  for (size_t i = 0; i < 300000; ++i) {
+    input.push_back(static_cast<unsigned char>(i % 251 < 200 ? 'a' + (i % 7) : (i * 2654435761U) >> 11));
+  }
+
+  atfw::util::thread::work_stealing_pool pool(4);
+  atfw::util::thread::work_stealing_pool* pools[] = {nullptr, &pool};
+  for (auto algo : algos) {
+    for (atfw::util::thread::work_stealing_pool* use_pool : pools) {
+      std::vector<unsigned char> container;
+      CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk,
+                     atfw::util::compression::compress_blocks(algo, gsl::make_span(input), container,
+                                                              atfw::util::compression::level_t::kDefault, 65536,
+                                                              use_pool));
+      CASE_EXPECT_LT(container.size(), input.size());
+
+      std::vector<unsigned char> decompressed;
+      CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk,
+                     atfw::util::compression::decompress_blocks(gsl::make_span(container), decompressed, use_pool));
+      CASE_EXPECT_TRUE(input == decompressed);
+
+      // Random access
+      atfw::util::compression::block_container_reader reader;
+      CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk, reader.open(gsl::make_span(container)));
+      CASE_EXPECT_TRUE(algo == reader.get_info().algorithm);
+      CASE_EXPECT_EQ(5, reader.get_info().block_count);
+      CASE_EXPECT_EQ(input.size(), reader.get_info().original_size);
+
+      size_t block_index = reader.find_block(200000);
+      CASE_EXPECT_EQ(3, block_index);
+      CASE_EXPECT_EQ(reader.get_info().block_count, reader.find_block(input.size()));
+
+      atfw::util::compression::block_info block;
+      CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk, reader.get_block_info(block_index, block));
+      CASE_EXPECT_EQ(3 * 65536, block.original_offset);
+      CASE_EXPECT_EQ(65536, block.original_size);
+
+      // A single block can be decoded by compression::decompress()
+      std::vector<unsigned char> block_data;
+      CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk,
+                     atfw::util::compression::decompress(
+                         algo, gsl::make_span(container.data() + block.compressed_offset, block.compressed_size),
+                         block.original_size, block_data));
+      CASE_EXPECT_TRUE(std::equal(block_data.begin(), block_data.end(), input.begin() + block.original_offset));
+
+      for (size_t i = reader.get_info().block_count; i > 0; --i) {
+        CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk, reader.decompress_block(i - 1, block_data));
+        CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk, reader.get_block_info(i - 1, block));
+        CASE_EXPECT_EQ(block.original_size, block_data.size());
+        CASE_EXPECT_TRUE(std::equal(block_data.begin(), block_data.end(), input.begin() + block.original_offset));
+      }
+      CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kInvalidParam,
+                     reader.decompress_block(reader.get_info().block_count, block_data));
+    }
+  }
+}
+
+CASE_TEST(compression, block_container_bad_format) {
+  auto algos = atfw::util::compression::get_supported_algorithms();
+  if (algos.empty()) {
+    return;
+  }
+
+  std::vector<unsigned char> input = make_sample_data();
+  std::vector<unsigned char> container;
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk,
+                 atfw::util::compression::compress_blocks(algos[0], gsl::make_span(input), container,
+                                                          atfw::util::compression::level_t::kDefault, 1024));
+
+  atfw::util::compression::block_container_reader reader;
+  std::vector<unsigned char> output;
+
+  // Truncated container
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kBadFormat,
+                 reader.open(gsl::make_span(container.data(), 20)));
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kBadFormat,
+                 reader.open(gsl::make_span(container.data(), container.size() - 1)));
+  CASE_EXPECT_FALSE(reader.is_valid());
+
+  // Broken magic
+  std::vector<unsigned char> broken = container;
+  broken[0] = 'X';
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kBadFormat,
+                 atfw::util::compression::decompress_blocks(gsl::make_span(broken), output));
+
+  // Broken block data
+  broken = container;
+  broken[broken.size() - 8] ^= 0x5a;
+  broken[broken.size() - 4] ^= 0xa5;
+  CASE_EXPECT_NE(atfw::util::compression::error_code_t::kOk,
+                 atfw::util::compression::decompress_blocks(gsl::make_span(broken), output));
+
+  // Original size near the limit of uint64 must not wrap the block count to 0
+  broken = container;
+  memset(broken.data() + 16, 0, 8);
+  memset(broken.data() + 24, 0xff, 8);
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kBadFormat, reader.open(gsl::make_span(broken)));
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kBadFormat,
+                 atfw::util::compression::decompress_blocks(gsl::make_span(broken), output));
+
+  // Original size larger than the limit of caller
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kBufferTooSmall,
+                 atfw::util::compression::decompress_blocks(gsl::make_span(container), output, nullptr,
+                                                            input.size() - 1));
+  CASE_EXPECT_TRUE(output.empty());
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk,
+                 atfw::util::compression::decompress_blocks(gsl::make_span(container), output, nullptr,
+                                                            input.size()));
+  CASE_EXPECT_TRUE(output == input);
+
+  // Empty input
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk,
+                 atfw::util::compression::compress_blocks(algos[0], gsl::span<const unsigned char>(), container));
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk,
+                 atfw::util::compression::decompress_blocks(gsl::make_span(container), output));
+  CASE_EXPECT_TRUE(output.empty());
+}
+
+#  if defined(PROJECT_TEST_MACRO_ENABLE_BENCHMARK) && PROJECT_TEST_MACRO_ENABLE_BENCHMARK
+CASE_TEST(compression, block_container_benchmark) {
+  auto algos = atfw::util::compression::get_supported_algorithms();
+  std::vector<unsigned char> input;
+  input.reserve(8 << 20);
+  for (size_t i = 0; input.size() < (8 << 20); ++i) {
+    std::vector<unsigned char> message = make_small_message(i);
+    input.insert(input.end(), message.begin(), message.end());
+  }
+
+  atfw::util::thread::work_stealing_pool pool(4);
+  for (auto algo : algos) {
+    std::vector<unsigned char> output;
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    atfw::util::compression::compress(algo, gsl::make_span(input), output);
+    auto single_usec =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count();
+    size_t single_size = output.size();
+
+    begin = std::chrono::steady_clock::now();
+    atfw::util::compression::compress_blocks(algo, gsl::make_span(input), output,
+                                             atfw::util::compression::level_t::kDefault, 0, &pool);
+    auto parallel_usec =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count();
+
+    std::vector<unsigned char> decompressed;
+    begin = std::chrono::steady_clock::now();
+    CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk,
+                   atfw::util::compression::decompress_blocks(gsl::make_span(output), decompressed, &pool));
+    auto decompress_usec =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count();
+    CASE_EXPECT_TRUE(input == decompressed);
+
+    CASE_MSG_INFO() << atfw::util::compression::get_algorithm_name(algo) << " " << input.size()
+                    << " bytes: single thread " << single_usec << "us/" << single_size << " bytes, "
+                    << pool.get_worker_count() << " workers " << parallel_usec << "us/" << output.size()
+                    << " bytes, parallel decompress " << decompress_usec << "us" << '\n';
+  }
+}
+#  endif
+
+CASE_TEST(compression, estimate_entropy) {
+  std::vector<unsigned char> zeros(65536, 0);
+  CASE_EXPECT_LT(atfw::util::compression::estimate_entropy(gsl::make_span(zeros)), 0.01);
+
+  std::vector<unsigned char> text = make_sample_data();
+  double text_entropy = atfw::util::compression::estimate_entropy(gsl::make_span(text));
+  CASE_EXPECT_GT(text_entropy, 3.0);
+  CASE_EXPECT_LT(text_entropy, 5.0);
+
+  // Both full scan and sampled estimation of random data are close to 8
+  std::vector<unsigned char> random_data = make_random_data(65536, 0x9e3779b97f4a7c15ULL);
+  CASE_EXPECT_GT(atfw::util::compression::estimate_entropy(gsl::make_span(random_data), random_data.size()), 7.9);
+  CASE_EXPECT_GT(atfw::util::compression::estimate_entropy(gsl::make_span(random_data), 1024), 7.6);
+  CASE_EXPECT_GT(atfw::util::compression::estimate_entropy(gsl::make_span(random_data.data(), 300)), 7.5);
+
+  CASE_EXPECT_EQ(0.0, atfw::util::compression::estimate_entropy(gsl::span<const unsigned char>()));
+}
+
+CASE_TEST(compression, adaptive_policy_skip) {
+  atfw::util::compression::adaptive_policy policy;
+  if (policy.get_candidates().empty()) {
+    return;
+  }
+
+  std::vector<unsigned char> output;
+  atfw::util::compression::adaptive_decision decision;
+
+  // Incompressible payload is detected by sampling, nothing is compressed
+  std::vector<unsigned char> random_data = make_random_data(16384, 0x123456789ULL);
+  CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk,
+                 policy.compress(gsl::make_span(random_data), output, decision));
+  CASE_EXPECT_TRUE(decision.skip);
+  CASE_EXPECT_TRUE(atfw::util::compression::algorithm_t::kNone == decision.algorithm);
+  CASE_EXPECT_GT(decision.entropy, 7.5);
+  CASE_EXPECT_TRUE(output.empty());
+  for (size_t i = 0; i < policy.get_candidates().size(); ++i) {
+    CASE_EXPECT_EQ(0, policy.get_stats(i, decision.size_bucket).sample_count);
+  }
+
+  // Small payload
+  std::vector<unsigned char> small_data = {1, 2, 3, 4};
+  decision = policy.choose(gsl::make_span(small_data));
+  CASE_EXPECT_TRUE(decision.skip);
+
+  // Compressible payload
+  std::vector<unsigned char> text = make_sample_data();
+  std::vector<unsigned char> decompressed;
+  for (size_t i = 0; i < policy.get_candidates().size() * 3; ++i) {
+    CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk, policy.compress(gsl::make_span(text), output, decision));
+    CASE_EXPECT_FALSE(decision.skip);
+    CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk,
+                   atfw::util::compression::decompress(decision.algorithm, gsl::make_span(output), text.size(),
+                                                       decompressed));
+    CASE_EXPECT_TRUE(text == decompressed);
+  }
+
+  // All candidates have been warmed up
+  for (size_t i = 0; i < policy.get_candidates().size(); ++i) {
+    atfw::util::compression::adaptive_policy_stats stats =
+        policy.get_stats(i, atfw::util::compression::adaptive_policy::get_size_bucket(text.size()));
+    CASE_EXPECT_GE(stats.sample_count, atfw::util::compression::adaptive_policy::kWarmupSamples);
+    CASE_EXPECT_LT(stats.compression_ratio, 0.5);
+  }
+}
+
+CASE_TEST(compression, adaptive_policy_budget) {
+  auto algos = atfw::util::compression::get_supported_algorithms();
+  if (algos.empty()) {
+    return;
+  }
+
+  atfw::util::compression::adaptive_policy_options options;
+  options.candidates.push_back(atfw::util::compression::adaptive_candidate{
+      algos[0], atfw::util::compression::level_t::kFast});
+  options.candidates.push_back(atfw::util::compression::adaptive_candidate{
+      algos[0], atfw::util::compression::level_t::kMaxRatio});
+  options.explore_interval = 0;
+
+  std::vector<unsigned char> text = make_sample_data();
+  const size_t bucket = atfw::util::compression::adaptive_policy::get_size_bucket(text.size());
+  atfw::util::compression::adaptive_decision decision;
+  decision.skip = false;
+  decision.size_bucket = bucket;
+
+  // Fake history: candidate 0 is fast, candidate 1 has better ratio
+  atfw::util::compression::adaptive_policy unlimited(options);
+  options.cpu_budget_ns_per_byte = 5.0;
+  atfw::util::compression::adaptive_policy limited(options);
+  options.cpu_budget_ns_per_byte = 0.1;
+  atfw::util::compression::adaptive_policy over_budget(options);
+  for (atfw::util::compression::adaptive_policy* policy : {&unlimited, &limited, &over_budget}) {
+    for (size_t i = 0; i < atfw::util::compression::adaptive_policy::kWarmupSamples; ++i) {
+      decision.candidate_index = 0;
+      policy->report(decision, 1000, 500, 1000);
+      decision.candidate_index = 1;
+      policy->report(decision, 1000, 300, 100000);
+    }
+  }
+
+  decision = unlimited.choose(gsl::make_span(text));
+  CASE_EXPECT_FALSE(decision.skip);
+  CASE_EXPECT_EQ(1, decision.candidate_index);
+  CASE_EXPECT_TRUE(atfw::util::compression::level_t::kMaxRatio == decision.level);
+
+  decision = limited.choose(gsl::make_span(text));
+  CASE_EXPECT_FALSE(decision.skip);
+  CASE_EXPECT_EQ(0, decision.candidate_index);
+
+  // Nothing fits the budget, use the fastest one
+  decision = over_budget.choose(gsl::make_span(text));
+  CASE_EXPECT_FALSE(decision.skip);
+  CASE_EXPECT_EQ(0, decision.candidate_index);
+
+  // Observed saving is too low, skip
+  for (size_t i = 0; i < 64; ++i) {
+    decision.candidate_index = 0;
+    decision.size_bucket = bucket;
+    decision.skip = false;
+    limited.report(decision, 1000, 990, 1000);
+  }
+  decision = limited.choose(gsl::make_span(text));
+  CASE_EXPECT_TRUE(decision.skip);
+}
+
+#  if defined(PROJECT_TEST_MACRO_ENABLE_BENCHMARK) && PROJECT_TEST_MACRO_ENABLE_BENCHMARK
+CASE_TEST(compression, adaptive_policy_benchmark) {
+  atfw::util::compression::adaptive_policy policy;
+  if (policy.get_candidates().empty()) {
+    return;
+  }
+
+  // Half of the payloads are encrypted
+  std::vector<std::vector<unsigned char>> payloads;
+  for (size_t i = 0; i < 256; ++i) {
+    if (i & 1) {
+      payloads.push_back(make_random_data(4096, i + 1));
+    } else {
+      std::vector<unsigned char> payload;
+      for (size_t j = 0; payload.size() < 4096; ++j) {
+        std::vector<unsigned char> message = make_small_message(i * 100 + j);
+        payload.insert(payload.end(), message.begin(), message.end());
+      }
+      payloads.push_back(payload);
+    }
+  }
+
+  const size_t loop_count = 8;
+  std::vector<unsigned char> output;
+  size_t always_size = 0;
+  atfw::util::compression::algorithm_t fixed_algorithm = policy.get_candidates()[0].algorithm;
+  std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+  for (size_t loop = 0; loop < loop_count; ++loop) {
+    for (auto& payload : payloads) {
+      atfw::util::compression::compress(fixed_algorithm, gsl::make_span(payload), output);
+      always_size += std::min(output.size(), payload.size());
+    }
+  }
+  auto always_usec =
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count();
+
+  size_t adaptive_size = 0;
+  size_t skip_count = 0;
+  atfw::util::compression::adaptive_decision decision;
+  begin = std::chrono::steady_clock::now();
+  for (size_t loop = 0; loop < loop_count; ++loop) {
+    for (auto& payload : payloads) {
+      policy.compress(gsl::make_span(payload), output, decision);
+      if (decision.skip) {
+        ++skip_count;
+        adaptive_size += payload.size();
+      } else {
+        adaptive_size += output.size();
+      }
+    }
+  }
+  auto adaptive_usec =
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count();
+
+  CASE_EXPECT_GE(skip_count, payloads.size() * loop_count / 2);
+  CASE_MSG_INFO() << payloads.size() * loop_count << " mixed payloads: always "
+                  << atfw::util::compression::get_algorithm_name(fixed_algorithm) << " " << always_usec << "us/"
+                  << always_size << " bytes, adaptive " << adaptive_usec << "us/" << adaptive_size << " bytes, skipped "
+                  << skip_count << '\n';
+}
+#  endif
+
 #endif  // ATFW_UTIL_MACRO_COMPRESSION_ENABLED
@@ -0,0 +1,214 @@
+// Copyright 2026 atframework
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "frame/test_macros.h"
+
+#include "data_structure/concurrent_flat_map.h"
+#include "lock/lock_holder.h"
+#include "lock/spin_rw_lock.h"
+
+CASE_TEST(concurrent_flat_map, basic) {
+  atfw::util::ds::concurrent_flat_map<uint64_t, uint64_t> map;
+  CASE_EXPECT_TRUE(map.empty());
+
+  uint64_t value = 0;
+  CASE_EXPECT_FALSE(map.find(1, value));
+  CASE_EXPECT_TRUE(map.insert(1, 100));
+  CASE_EXPECT_FALSE(map.insert(1, 200));
+  CASE_EXPECT_TRUE(map.find(1, value));
+  CASE_EXPECT_EQ(100, value);
+
+  CASE_EXPECT_FALSE(map.insert_or_assign(1, 300));
+  CASE_EXPECT_TRUE(map.find(1, value));
+  CASE_EXPECT_EQ(300, value);
+  CASE_EXPECT_EQ(1, map.size());
+
+  CASE_EXPECT_TRUE(map.erase(1));
+  CASE_EXPECT_FALSE(map.erase(1));
+  CASE_EXPECT_FALSE(map.contains(1));
+  CASE_EXPECT_TRUE(map.empty());
+}
+
+CASE_TEST(concurrent_flat_map, rehash) {
+  atfw::util::ds::concurrent_flat_map<uint32_t, uint32_t> map;
+  size_t init_capacity = map.capacity();
+
+  for (uint32_t i = 0; i < 10000; ++i) {
+    CASE_EXPECT_TRUE(map.insert(i, i * 3));
+  }
+  CASE_EXPECT_EQ(10000, map.size());
+  CASE_EXPECT_GT(map.capacity(), init_capacity);
+
+  // Erase half, then reinsert into tombstones
+  for (uint32_t i = 0; i < 10000; i += 2) {
+    CASE_EXPECT_TRUE(map.erase(i));
+  }
+  CASE_EXPECT_EQ(5000, map.size());
+
+  bool all_match = true;
+  for (uint32_t i = 0; i < 10000; ++i) {
+    uint32_t value = 0;
+    bool found = map.find(i, value);
+    if (found != (i % 2 == 1) || (found && value != i * 3)) {
+      all_match = false;
+    }
+  }
+  CASE_EXPECT_TRUE(all_match);
+
+  for (uint32_t i = 0; i < 10000; i += 2) {
+    CASE_EXPECT_TRUE(map.insert(i, i));
+  }
+  CASE_EXPECT_EQ(10000, map.size());
+
+  CASE_EXPECT_GT(map.reclaim_retired_tables(), 0);
+  CASE_EXPECT_EQ(0, map.reclaim_retired_tables());
+
+  uint32_t value = 0;
+  CASE_EXPECT_TRUE(map.find(9998, value));
+  CASE_EXPECT_EQ(9998, value);
+  CASE_EXPECT_TRUE(map.find(9999, value));
+  CASE_EXPECT_EQ(9999 * 3, value);
+}
+
+CASE_TEST(concurrent_flat_map, concurrent_read_write) {
+  // Readers must always observe the stable keys while writers insert/erase and trigger incremental rehash
+  atfw::util::ds::concurrent_flat_map<uint64_t, uint64_t> map;
+  const uint64_t stable_key_count = 1000;
+  for (uint64_t i = 0; i < stable_key_count; ++i) {
+    map.insert(i, i + 1);
+  }
+
+  std::atomic<bool> stop{false};
+  std::atomic<size_t> read_errors{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&map, &stop, &read_errors, stable_key_count]() {
+      while (!stop.load(std::memory_order_acquire)) {
+        for (uint64_t k = 0; k < stable_key_count; ++k) {
+          uint64_t value = 0;
+          if (!map.find(k, value) || value != k + 1) {
+            ++read_errors;
+          }
+        }
+      }
+    });
+  }
+
+  std::vector<std::thread> writers;
+  for (uint64_t w = 0; w < 4; ++w) {
+    writers.emplace_back([&map, w]() {
+      uint64_t base = (w + 1) << 32;
+      for (uint64_t k = 0; k < 20000; ++k) {
+        map.insert(base + k, k);
+      }
+      for (uint64_t k = 0; k < 20000; k += 2) {
+        map.erase(base + k);
+      }
+    });
+  }
+
+  for (auto& thd : writers) {
+    thd.join();
+  }
+  stop.store(true, std::memory_order_release);
+  for (auto& thd : threads) {
+    thd.join();
+  }
+
+  CASE_EXPECT_EQ(0, read_errors.load());
+  CASE_EXPECT_EQ(stable_key_count + 4 * 10000, map.size());
+  uint64_t value = 0;
+  CASE_EXPECT_TRUE(map.find((static_cast<uint64_t>(3) << 32) + 19999, value));
+  CASE_EXPECT_EQ(19999, value);
+  CASE_EXPECT_FALSE(map.contains((static_cast<uint64_t>(3) << 32) + 19998));
+}
+
+#if defined(PROJECT_TEST_MACRO_ENABLE_BENCHMARK) && PROJECT_TEST_MACRO_ENABLE_BENCHMARK
+namespace {
+static const uint64_t kConcurrentFlatMapBenchKeys = 1 << 16;
+static const size_t kConcurrentFlatMapBenchLookups = 1 << 20;
+
+template <class TFind>
+static int64_t concurrent_flat_map_bench_read(size_t thread_count, std::atomic<uint64_t>& sink, TFind&& find_fn) {
+  std::vector<std::thread> threads;
+  std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < thread_count; ++i) {
+    threads.emplace_back([&find_fn, &sink, i]() {
+      uint64_t k = i * 7919;
+      uint64_t sum = 0;
+      for (size_t j = 0; j < kConcurrentFlatMapBenchLookups; ++j) {
+        sum += find_fn(k & (kConcurrentFlatMapBenchKeys - 1));
+        k += 40503;
+      }
+      sink.fetch_add(sum, std::memory_order_relaxed);
+    });
+  }
+  for (auto& thd : threads) {
+    thd.join();
+  }
+  return static_cast<int64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count());
+}
+}  // namespace
+
+CASE_TEST(concurrent_flat_map, benchmark) {
+  atfw::util::ds::concurrent_flat_map<uint64_t, uint64_t> map;
+  std::unordered_map<uint64_t, uint64_t> std_map;
+  atfw::util::lock::spin_rw_lock std_map_lock;
+  for (uint64_t i = 0; i < kConcurrentFlatMapBenchKeys; ++i) {
+    map.insert(i, i);
+    std_map[i] = i;
+  }
+
+  std::atomic<uint64_t> sink{0};
+  for (size_t thread_count = 1; thread_count <= 4; thread_count *= 2) {
+    int64_t flat_usec = concurrent_flat_map_bench_read(thread_count, sink, [&map](uint64_t k) {
+      uint64_t value = 0;
+      map.find(k, value);
+      return value;
+    });
+
+    int64_t std_usec = concurrent_flat_map_bench_read(thread_count, sink, [&std_map, &std_map_lock](uint64_t k) {
+      atfw::util::lock::read_lock_holder<atfw::util::lock::spin_rw_lock> holder(std_map_lock);
+      auto iter = std_map.find(k);
+      return iter == std_map.end() ? static_cast<uint64_t>(0) : iter->second;
+    });
+
+    CASE_MSG_INFO() << "concurrent_flat_map find " << thread_count << " thread(s) x " << kConcurrentFlatMapBenchLookups
+                    << ": " << flat_usec << "us, unordered_map+spin_rw_lock: " << std_usec << "us" << '\n';
+  }
+
+  // Insert throughput, single thread, including rehash
+  {
+    atfw::util::ds::concurrent_flat_map<uint64_t, uint64_t> insert_map;
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < kConcurrentFlatMapBenchKeys; ++i) {
+      insert_map.insert(i, i);
+    }
+    int64_t flat_usec = static_cast<int64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count());
+
+    std::unordered_map<uint64_t, uint64_t> insert_std_map;
+    atfw::util::lock::spin_rw_lock insert_std_lock;
+    begin = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < kConcurrentFlatMapBenchKeys; ++i) {
+      atfw::util::lock::write_lock_holder<atfw::util::lock::spin_rw_lock> holder(insert_std_lock);
+      insert_std_map[i] = i;
+    }
+    int64_t std_usec = static_cast<int64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count());
+
+    CASE_MSG_INFO() << "concurrent_flat_map insert x " << kConcurrentFlatMapBenchKeys << ": " << flat_usec
+                    << "us, unordered_map+spin_rw_lock: " << std_usec << "us" << '\n';
+    CASE_EXPECT_EQ(insert_std_map.size(), insert_map.size());
+  }
+
+  CASE_EXPECT_GT(sink.load(), 0);
+}
+#endif
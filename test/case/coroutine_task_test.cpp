@@ -0,0 +1,274 @@
+// Copyright 2026 atframework
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include "frame/test_macros.h"
+
+#include "coroutine/task.h"
+#include "coroutine/timer_awaitable.h"
+
+CASE_TEST(coroutine_task, frame_allocator) {
+  atfw::util::coroutine::frame_allocator::release_thread_cache();
+  atfw::util::coroutine::frame_allocator_stats before = atfw::util::coroutine::frame_allocator::get_thread_stats();
+  CASE_EXPECT_EQ(0, before.cached_block_count);
+
+  void* ptr1 = atfw::util::coroutine::frame_allocator::allocate(100);
+  atfw::util::coroutine::frame_allocator::deallocate(ptr1, 100);
+  CASE_EXPECT_EQ(1, atfw::util::coroutine::frame_allocator::get_thread_stats().cached_block_count);
+
+  // Same size class reuses the cached block
+  void* ptr2 = atfw::util::coroutine::frame_allocator::allocate(120);
+  CASE_EXPECT_EQ(ptr1, ptr2);
+  atfw::util::coroutine::frame_allocator::deallocate(ptr2, 120);
+
+  // Large frames bypass the cache
+  void* ptr3 = atfw::util::coroutine::frame_allocator::allocate(
+      atfw::util::coroutine::frame_allocator::MAX_CACHED_SIZE + 1);
+  atfw::util::coroutine::frame_allocator::deallocate(ptr3, atfw::util::coroutine::frame_allocator::MAX_CACHED_SIZE + 1);
+
+  atfw::util::coroutine::frame_allocator_stats after = atfw::util::coroutine::frame_allocator::get_thread_stats();
+  CASE_EXPECT_EQ(before.allocate_count + 2, after.allocate_count);
+  CASE_EXPECT_EQ(before.cache_hit_count + 1, after.cache_hit_count);
+  CASE_EXPECT_EQ(1, after.cached_block_count);
+
+  atfw::util::coroutine::frame_allocator::release_thread_cache();
+  CASE_EXPECT_EQ(0, atfw::util::coroutine::frame_allocator::get_thread_stats().cached_block_count);
+}
+
+#if defined(ATFW_UTIL_MACRO_ENABLE_COROUTINE) && ATFW_UTIL_MACRO_ENABLE_COROUTINE
+
+namespace {
+using coroutine_test_timer_t = atfw::util::time::jiffies_timer<6, 3, 4>;
+using coroutine_test_int_task = atfw::util::coroutine::task<int32_t>;
+using coroutine_test_string_task = atfw::util::coroutine::task<std::string, int32_t>;
+
+static coroutine_test_int_task coroutine_task_test_add(int32_t a, int32_t b) {
+  co_return coroutine_test_int_task::result_type::make_success(a + b);
+}
+
+static coroutine_test_int_task coroutine_task_test_fail(int32_t code) {
+  co_return coroutine_test_int_task::result_type::make_error(code);
+}
+
+static coroutine_test_string_task coroutine_task_test_chain(int32_t depth) {
+  int32_t sum = 0;
+  for (int32_t i = 0; i < depth; ++i) {
+    auto res = co_await coroutine_task_test_add(sum, i);
+    if (!res.is_success()) {
+      co_return coroutine_test_string_task::result_type::make_error(-1);
+    }
+    sum = *res.get_success();
+  }
+
+  auto fail_res = co_await coroutine_task_test_fail(-5);
+  if (!fail_res.is_error()) {
+    co_return coroutine_test_string_task::result_type::make_error(-2);
+  }
+
+  co_return coroutine_test_string_task::result_type::make_success(std::to_string(sum + *fail_res.get_error()));
+}
+
+static coroutine_test_int_task coroutine_task_test_sleep(coroutine_test_timer_t& timer, int32_t& step) {
+  step = 1;
+  auto res = co_await atfw::util::coroutine::sleep_for(timer, 3);
+  if (res.is_error()) {
+    co_return coroutine_test_int_task::result_type::make_error(*res.get_error());
+  }
+  step = 2;
+
+  res = co_await atfw::util::coroutine::sleep_for(timer, 5);
+  if (res.is_error()) {
+    co_return coroutine_test_int_task::result_type::make_error(*res.get_error());
+  }
+  step = 3;
+  co_return coroutine_test_int_task::result_type::make_success(static_cast<int32_t>(*res.get_success()));
+}
+
+static coroutine_test_int_task coroutine_task_test_await_started(coroutine_test_int_task& sub, int32_t& step) {
+  step = 1;
+  auto res = co_await sub;
+  step = 2;
+  if (res.is_error()) {
+    co_return coroutine_test_int_task::result_type::make_error(*res.get_error());
+  }
+  co_return coroutine_test_int_task::result_type::make_success(*res.get_success() + 1);
+}
+
+#  if defined(ATFRAMEWORK_UTILS_ENABLE_EXCEPTION) && ATFRAMEWORK_UTILS_ENABLE_EXCEPTION
+static coroutine_test_int_task coroutine_task_test_throw(coroutine_test_timer_t& timer, bool should_throw) {
+  co_await atfw::util::coroutine::sleep_for(timer, 3);
+  if (should_throw) {
+    throw std::runtime_error("coroutine_task_test_throw");
+  }
+  co_return coroutine_test_int_task::result_type::make_success(1);
+}
+
+static coroutine_test_int_task coroutine_task_test_catch(coroutine_test_timer_t& timer, int32_t& step) {
+  step = 1;
+  bool caught = false;
+  try {
+    co_await coroutine_task_test_throw(timer, true);
+  } catch (const std::runtime_error&) {
+    caught = true;
+  }
+  step = 2;
+  co_return coroutine_test_int_task::result_type::make_error(caught ? -1 : 0);
+}
+#  endif
+}  // namespace
+
+CASE_TEST(coroutine_task, chain) {
+  coroutine_test_string_task t = coroutine_task_test_chain(10);
+  CASE_EXPECT_TRUE(t.valid());
+  CASE_EXPECT_FALSE(t.is_done());
+  CASE_EXPECT_TRUE(t.get_result().is_none());
+
+  // Lazy start
+  CASE_EXPECT_TRUE(t.start());
+  CASE_EXPECT_FALSE(t.start());
+  CASE_EXPECT_TRUE(t.is_done());
+  CASE_EXPECT_TRUE(t.get_result().is_success());
+  if (t.get_result().is_success()) {
+    CASE_EXPECT_EQ("40", *t.get_result().get_success());
+  }
+
+  coroutine_test_string_task moved = std::move(t);
+  CASE_EXPECT_FALSE(t.valid());
+  CASE_EXPECT_TRUE(moved.is_done());
+
+  // Frames of finished tasks go back to the thread cache and are reused
+  atfw::util::coroutine::frame_allocator_stats before = atfw::util::coroutine::frame_allocator::get_thread_stats();
+  for (int i = 0; i < 100; ++i) {
+    coroutine_test_int_task sub = coroutine_task_test_add(i, 1);
+    sub.start();
+  }
+  atfw::util::coroutine::frame_allocator_stats after = atfw::util::coroutine::frame_allocator::get_thread_stats();
+  CASE_EXPECT_EQ(before.allocate_count + 100, after.allocate_count);
+  CASE_EXPECT_GE(after.cache_hit_count - before.cache_hit_count, 99);
+}
+
+CASE_TEST(coroutine_task, timer_sleep) {
+  coroutine_test_timer_t timer;
+  CASE_EXPECT_EQ(0, timer.init(100));
+
+  int32_t step = 0;
+  coroutine_test_int_task t = coroutine_task_test_sleep(timer, step);
+  t.start();
+  CASE_EXPECT_EQ(1, step);
+  CASE_EXPECT_EQ(1, timer.size());
+
+  timer.tick(102);
+  CASE_EXPECT_EQ(1, step);
+  timer.tick(103);
+  CASE_EXPECT_EQ(2, step);
+  CASE_EXPECT_FALSE(t.is_done());
+
+  timer.tick(108);
+  CASE_EXPECT_EQ(3, step);
+  CASE_EXPECT_TRUE(t.is_done());
+  CASE_EXPECT_TRUE(t.get_result().is_success());
+  if (t.get_result().is_success()) {
+    CASE_EXPECT_EQ(108, *t.get_result().get_success());
+  }
+}
+
+CASE_TEST(coroutine_task, timer_cancel) {
+  coroutine_test_timer_t timer;
+  CASE_EXPECT_EQ(0, timer.init(100));
+
+  int32_t step = 0;
+  {
+    coroutine_test_int_task t = coroutine_task_test_sleep(timer, step);
+    t.start();
+    CASE_EXPECT_EQ(1, step);
+  }
+
+  // Destroyed frame disables the pending timer
+  timer.tick(200);
+  CASE_EXPECT_EQ(1, step);
+
+  // Not inited timer fails without suspend
+  coroutine_test_timer_t not_inited_timer;
+  coroutine_test_int_task t = coroutine_task_test_sleep(not_inited_timer, step);
+  t.start();
+  CASE_EXPECT_TRUE(t.is_done());
+  CASE_EXPECT_TRUE(t.get_result().is_error());
+  if (t.get_result().is_error()) {
+    CASE_EXPECT_EQ(coroutine_test_timer_t::error_type_t::EN_JTET_NOT_INITED, *t.get_result().get_error());
+  }
+}
+
+CASE_TEST(coroutine_task, await_started) {
+  coroutine_test_timer_t timer;
+  CASE_EXPECT_EQ(0, timer.init(100));
+
+  // The sub task is already suspended inside its body when it is awaited
+  int32_t sub_step = 0;
+  coroutine_test_int_task sub = coroutine_task_test_sleep(timer, sub_step);
+  CASE_EXPECT_TRUE(sub.start());
+  CASE_EXPECT_EQ(1, sub_step);
+
+  int32_t step = 0;
+  coroutine_test_int_task t = coroutine_task_test_await_started(sub, step);
+  CASE_EXPECT_TRUE(t.start());
+  CASE_EXPECT_EQ(1, step);
+  CASE_EXPECT_EQ(1, sub_step);
+
+  timer.tick(103);
+  CASE_EXPECT_EQ(2, sub_step);
+  CASE_EXPECT_EQ(1, step);
+
+  // Finishing the sub task resumes the awaiting task
+  timer.tick(108);
+  CASE_EXPECT_EQ(3, sub_step);
+  CASE_EXPECT_EQ(2, step);
+  CASE_EXPECT_TRUE(t.is_done());
+  CASE_EXPECT_TRUE(t.get_result().is_success());
+  if (t.get_result().is_success()) {
+    CASE_EXPECT_EQ(109, *t.get_result().get_success());
+  }
+
+  coroutine_test_int_task::result_type taken = t.take_result();
+  CASE_EXPECT_TRUE(taken.is_success());
+  CASE_EXPECT_TRUE(coroutine_test_int_task().take_result().is_none());
+}
+
+#  if defined(ATFRAMEWORK_UTILS_ENABLE_EXCEPTION) && ATFRAMEWORK_UTILS_ENABLE_EXCEPTION
+CASE_TEST(coroutine_task, exception) {
+  coroutine_test_timer_t timer;
+  CASE_EXPECT_EQ(0, timer.init(100));
+
+  // The sub task throws after it is resumed by the timer, the awaiting task is still resumed and catches it
+  int32_t step = 0;
+  coroutine_test_int_task t = coroutine_task_test_catch(timer, step);
+  CASE_EXPECT_TRUE(t.start());
+  CASE_EXPECT_EQ(1, step);
+
+  timer.tick(103);
+  CASE_EXPECT_EQ(2, step);
+  CASE_EXPECT_TRUE(t.is_done());
+  CASE_EXPECT_TRUE(t.get_result().is_error());
+  if (t.get_result().is_error()) {
+    CASE_EXPECT_EQ(-1, *t.get_result().get_error());
+  }
+
+  // Top level task rethrows from take_result()
+  coroutine_test_int_task top = coroutine_task_test_throw(timer, true);
+  CASE_EXPECT_TRUE(top.start());
+  timer.tick(106);
+  CASE_EXPECT_TRUE(top.is_done());
+  CASE_EXPECT_TRUE(top.get_result().is_none());
+
+  bool caught = false;
+  try {
+    top.take_result();
+  } catch (const std::runtime_error&) {
+    caught = true;
+  }
+  CASE_EXPECT_TRUE(caught);
+}
+#  endif
+
+#endif
@@ -1,8 +1,11 @@
 // Copyright 2026 atframework
 
+#include <chrono>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <string>
+#include <vector>
 
 #include "frame/test_macros.h"
 
@@ -28,3 +31,135 @@ CASE_TEST(crc, crc64) {
   CASE_EXPECT_EQ(0x1D240DCFEDFF621BULL, atfw::util::crc64(data, 18, 0xFFFFFFFFFFFFFFFFULL) ^ 0xFFFFFFFFFFFFFFFFULL);
 }
 
+
+CASE_TEST(crc, crc32c) {
+  unsigned char data[24] = "123456789";
+
+  CASE_EXPECT_EQ(0xE3069283, atfw::util::crc32c(data, 9, 0xFFFFFFFF) ^ 0xFFFFFFFF);
+}
+
+namespace {
+static std::vector<unsigned char> crc_test_make_buffer(size_t len) {
+  std::vector<unsigned char> ret;
+  ret.resize(len);
+  uint32_t seed = 0x12345678;
+  for (size_t i = 0; i < len; ++i) {
+    seed = seed * 1103515245 + 12345;
+    ret[i] = static_cast<unsigned char>(seed >> 16);
+  }
+  return ret;
+}
+}  // namespace
+
+CASE_TEST(crc, engines) {
+  std::vector<unsigned char> buffer = crc_test_make_buffer(4096 + 17);
+  const atfw::util::crc_engine_t engines[] = {atfw::util::crc_engine_t::kAuto, atfw::util::crc_engine_t::kSlice8,
+                                              atfw::util::crc_engine_t::kSlice16,
+                                              atfw::util::crc_engine_t::kHardware};
+  CASE_MSG_INFO() << "crc32 hardware: " << atfw::util::crc32_has_hardware_engine()
+                  << ", crc32c hardware: " << atfw::util::crc32c_has_hardware_engine()
+                  << ", crc64 hardware: " << atfw::util::crc64_has_hardware_engine() << '\n';
+
+  // All engines must be byte-identical with the byte table version, including unaligned heads and tails
+  size_t mismatch = 0;
+  const size_t lengths[] = {0, 1, 7, 8, 15, 16, 17, 63, 64, 65, 127, 128, 200, 1000, 4096};
+  for (size_t offset = 0; offset < 3; ++offset) {
+    for (size_t len : lengths) {
+      const unsigned char* s = &buffer[offset];
+      uint16_t c16 = atfw::util::crc16_with_engine(atfw::util::crc_engine_t::kByteTable, s, len, 0x1D0F);
+      uint32_t c32 = atfw::util::crc32_with_engine(atfw::util::crc_engine_t::kByteTable, s, len, 0xFFFFFFFF);
+      uint32_t c32c = atfw::util::crc32c_with_engine(atfw::util::crc_engine_t::kByteTable, s, len, 0xFFFFFFFF);
+      uint64_t c64 = atfw::util::crc64_with_engine(atfw::util::crc_engine_t::kByteTable, s, len, 0xFFFFFFFFFFFFFFFFULL);
+
+      for (atfw::util::crc_engine_t engine : engines) {
+        if (c16 != atfw::util::crc16_with_engine(engine, s, len, 0x1D0F)) {
+          ++mismatch;
+        }
+        if (c32 != atfw::util::crc32_with_engine(engine, s, len, 0xFFFFFFFF)) {
+          ++mismatch;
+        }
+        if (c32c != atfw::util::crc32c_with_engine(engine, s, len, 0xFFFFFFFF)) {
+          ++mismatch;
+        }
+        if (c64 != atfw::util::crc64_with_engine(engine, s, len, 0xFFFFFFFFFFFFFFFFULL)) {
+          ++mismatch;
+        }
+      }
+    }
+  }
+  CASE_EXPECT_EQ(0, mismatch);
+}
+
+CASE_TEST(crc, combine) {
+  std::vector<unsigned char> buffer = crc_test_make_buffer(3000);
+  const size_t splits[] = {0, 1, 100, 1500, 2999, 3000};
+
+  for (size_t split : splits) {
+    const unsigned char* a = buffer.data();
+    const unsigned char* b = buffer.data() + split;
+    size_t len2 = buffer.size() - split;
+
+    CASE_EXPECT_EQ(atfw::util::crc16(a, buffer.size(), 0xFFFF),
+                   atfw::util::crc16_combine(atfw::util::crc16(a, split, 0xFFFF), atfw::util::crc16(b, len2, 0xFFFF),
+                                             len2, 0xFFFF));
+    CASE_EXPECT_EQ(atfw::util::crc32(a, buffer.size(), 0xFFFFFFFF),
+                   atfw::util::crc32_combine(atfw::util::crc32(a, split, 0xFFFFFFFF),
+                                             atfw::util::crc32(b, len2, 0xFFFFFFFF), len2, 0xFFFFFFFF));
+    CASE_EXPECT_EQ(atfw::util::crc32c(a, buffer.size()),
+                   atfw::util::crc32c_combine(atfw::util::crc32c(a, split), atfw::util::crc32c(b, len2), len2));
+    CASE_EXPECT_EQ(atfw::util::crc64(a, buffer.size(), 0xFFFFFFFFFFFFFFFFULL),
+                   atfw::util::crc64_combine(atfw::util::crc64(a, split, 0xFFFFFFFFFFFFFFFFULL),
+                                             atfw::util::crc64(b, len2, 0xFFFFFFFFFFFFFFFFULL), len2,
+                                             0xFFFFFFFFFFFFFFFFULL));
+  }
+}
+
+#if defined(PROJECT_TEST_MACRO_ENABLE_BENCHMARK) && PROJECT_TEST_MACRO_ENABLE_BENCHMARK
+namespace {
+template <class TFN>
+static void crc_test_benchmark(const char* name, const std::vector<unsigned char>& buffer, size_t len, TFN&& fn) {
+  size_t loop_count = (static_cast<size_t>(16) << 20) / len;
+  uint64_t sink = 0;
+  std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < loop_count; ++i) {
+    sink += fn(buffer.data(), len);
+  }
+  int64_t usec = static_cast<int64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count());
+  if (usec <= 0) {
+    usec = 1;
+  }
+
+  CASE_MSG_INFO() << "  " << name << " " << len << " bytes: " << (loop_count * len) / static_cast<size_t>(usec)
+                  << " MB/s (" << (sink & 0xff) << ")" << '\n';
+}
+}  // namespace
+
+CASE_TEST(crc, benchmark) {
+  std::vector<unsigned char> buffer = crc_test_make_buffer(65536);
+  const size_t lengths[] = {64, 1024, 65536};
+  const atfw::util::crc_engine_t engines[] = {atfw::util::crc_engine_t::kByteTable, atfw::util::crc_engine_t::kSlice8,
+                                              atfw::util::crc_engine_t::kSlice16,
+                                              atfw::util::crc_engine_t::kHardware};
+  const char* engine_names[] = {"byte_table", "slice8", "slice16", "hardware"};
+
+  for (size_t len : lengths) {
+    CASE_MSG_INFO() << "crc benchmark for " << len << " bytes" << '\n';
+    for (size_t i = 0; i < sizeof(engines) / sizeof(engines[0]); ++i) {
+      atfw::util::crc_engine_t engine = engines[i];
+      std::string name = std::string("crc32 ") + engine_names[i];
+      crc_test_benchmark(name.c_str(), buffer, len, [engine](const unsigned char* s, size_t l) {
+        return static_cast<uint64_t>(atfw::util::crc32_with_engine(engine, s, l, 0xFFFFFFFF));
+      });
+      name = std::string("crc32c ") + engine_names[i];
+      crc_test_benchmark(name.c_str(), buffer, len, [engine](const unsigned char* s, size_t l) {
+        return static_cast<uint64_t>(atfw::util::crc32c_with_engine(engine, s, l, 0xFFFFFFFF));
+      });
+      name = std::string("crc64 ") + engine_names[i];
+      crc_test_benchmark(name.c_str(), buffer, len, [engine](const unsigned char* s, size_t l) {
+        return atfw::util::crc64_with_engine(engine, s, l, 0xFFFFFFFFFFFFFFFFULL);
+      });
+    }
+  }
+}
+#endif
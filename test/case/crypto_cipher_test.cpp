@@ -5,6 +5,8 @@
 #include <cstring>
 #include <fstream>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "algorithm/crypto_cipher.h"
 #include "common/file_system.h"
@@ -761,4 +763,217 @@ CASE_TEST(crypto_cipher, evp_test) {
   }
 }
 
+
+static const char *aead_batch_test_ciphers[] = {"aes-128-gcm", "aes-256-gcm", "chacha20-poly1305-ietf"};
+
+static bool aead_batch_test_init(atfw::util::crypto::cipher &ci, const char *name, int32_t mode) {
+  if (0 != ci.init(name, mode)) {
+    return false;
+  }
+
+  unsigned char key[32];
+  unsigned char iv[12];
+  for (size_t i = 0; i < sizeof(key); ++i) {
+    key[i] = static_cast<unsigned char>(i * 7 + 1);
+  }
+  for (size_t i = 0; i < sizeof(iv); ++i) {
+    iv[i] = static_cast<unsigned char>(0xF0 + i);
+  }
+  // Start near the byte boundary so the counter carries across packets
+  iv[sizeof(iv) - 1] = 0xFE;
+
+  CASE_EXPECT_EQ(0, ci.set_key(key, ci.get_key_bits()));
+  CASE_EXPECT_EQ(0, ci.set_iv(iv, sizeof(iv)));
+  return true;
+}
+
+CASE_TEST(crypto_cipher, aead_batch) {
+#  if defined(ATFRAMEWORK_UTILS_CRYPTO_USE_OPENSSL) || defined(ATFRAMEWORK_UTILS_CRYPTO_USE_LIBRESSL) || \
+      defined(ATFRAMEWORK_UTILS_CRYPTO_USE_BORINGSSL)
+  if (!openssl_test_inited) {
+    openssl_test_inited = std::make_shared<openssl_test_init_wrapper>();
+  }
+#  endif
+
+  const size_t packet_sizes[] = {1, 15, 16, 64, 100, 1500, 4096, 0};
+  const size_t packet_count = sizeof(packet_sizes) / sizeof(packet_sizes[0]);
+
+  for (const char *name : aead_batch_test_ciphers) {
+    atfw::util::crypto::cipher batch_ci;
+    atfw::util::crypto::cipher single_ci;
+    if (!aead_batch_test_init(batch_ci, name, atfw::util::crypto::cipher::mode_t::kEncrypt |
+                                                  atfw::util::crypto::cipher::mode_t::kDecrypt) ||
+        !aead_batch_test_init(single_ci, name, static_cast<int32_t>(atfw::util::crypto::cipher::mode_t::kEncrypt))) {
+      CASE_MSG_INFO() << "\tCipher: " << name << " => not available for current crypto libraries, skipped." << '\n';
+      continue;
+    }
+    const size_t tag_len = batch_ci.get_tag_size();
+    std::vector<unsigned char> saved_iv(batch_ci.get_iv().begin(), batch_ci.get_iv().end());
+
+    std::vector<std::vector<unsigned char>> plaintexts;
+    std::vector<std::vector<unsigned char>> buffers;
+    std::vector<std::vector<unsigned char>> tags;
+    std::vector<std::string> ads;
+    for (size_t i = 0; i < packet_count; ++i) {
+      std::vector<unsigned char> plaintext;
+      for (size_t j = 0; j < packet_sizes[i]; ++j) {
+        plaintext.push_back(static_cast<unsigned char>(i * 31 + j));
+      }
+      plaintexts.push_back(plaintext);
+      buffers.push_back(plaintext);
+      tags.push_back(std::vector<unsigned char>(tag_len, 0));
+      ads.push_back(i % 2 == 0 ? std::string() : "ad-" + std::to_string(i));
+    }
+
+    std::vector<atfw::util::crypto::cipher::aead_packet_t> packets;
+    packets.resize(packet_count);
+    for (size_t i = 0; i < packet_count; ++i) {
+      packets[i].data = gsl::span<unsigned char>(buffers[i].data(), buffers[i].size());
+      packets[i].tag = gsl::span<unsigned char>(tags[i].data(), tags[i].size());
+      packets[i].ad =
+          gsl::span<const unsigned char>(reinterpret_cast<const unsigned char *>(ads[i].data()), ads[i].size());
+    }
+
+    size_t processed = 0;
+    CASE_EXPECT_EQ(0, batch_ci.encrypt_aead_batch(gsl::span<atfw::util::crypto::cipher::aead_packet_t>(packets),
+                                                  &processed));
+    CASE_EXPECT_EQ(packet_count, processed);
+
+    // Must be the same as encrypting packets one by one with the rolled iv
+    for (size_t i = 0; i < packet_count; ++i) {
+      if (plaintexts[i].empty()) {
+        continue;
+      }
+      std::vector<unsigned char> output;
+      output.resize(plaintexts[i].size() + single_ci.get_block_size() + tag_len);
+      size_t olen = output.size();
+      CASE_EXPECT_EQ(0, single_ci.encrypt_aead(plaintexts[i].data(), plaintexts[i].size(), output.data(), &olen,
+                                               reinterpret_cast<const unsigned char *>(ads[i].data()), ads[i].size()));
+      CASE_EXPECT_EQ(plaintexts[i].size() + tag_len, olen);
+      CASE_EXPECT_EQ(0, memcmp(output.data(), buffers[i].data(), buffers[i].size()));
+      CASE_EXPECT_EQ(0, memcmp(output.data() + buffers[i].size(), tags[i].data(), tag_len));
+    }
+
+    // The empty packet also consumes a nonce, iv is rolled by the whole batch
+    std::vector<unsigned char> expect_iv = saved_iv;
+    for (size_t i = 0; i < packet_count; ++i) {
+      for (size_t j = expect_iv.size(); j > 0; --j) {
+        if (0 != ++expect_iv[j - 1]) {
+          break;
+        }
+      }
+    }
+    CASE_EXPECT_TRUE(expect_iv == std::vector<unsigned char>(batch_ci.get_iv().begin(), batch_ci.get_iv().end()));
+
+    CASE_EXPECT_EQ(0, batch_ci.set_iv(saved_iv.data(), saved_iv.size()));
+    CASE_EXPECT_EQ(0, batch_ci.decrypt_aead_batch(gsl::span<atfw::util::crypto::cipher::aead_packet_t>(packets),
+                                                  &processed));
+    CASE_EXPECT_EQ(packet_count, processed);
+    for (size_t i = 0; i < packet_count; ++i) {
+      CASE_EXPECT_TRUE(plaintexts[i] == buffers[i]);
+    }
+  }
+}
+
+CASE_TEST(crypto_cipher, aead_batch_tamper) {
+#  if defined(ATFRAMEWORK_UTILS_CRYPTO_USE_OPENSSL) || defined(ATFRAMEWORK_UTILS_CRYPTO_USE_LIBRESSL) || \
+      defined(ATFRAMEWORK_UTILS_CRYPTO_USE_BORINGSSL)
+  if (!openssl_test_inited) {
+    openssl_test_inited = std::make_shared<openssl_test_init_wrapper>();
+  }
+#  endif
+
+  for (const char *name : aead_batch_test_ciphers) {
+    atfw::util::crypto::cipher ci;
+    if (!aead_batch_test_init(ci, name, atfw::util::crypto::cipher::mode_t::kEncrypt |
+                                            atfw::util::crypto::cipher::mode_t::kDecrypt)) {
+      continue;
+    }
+    std::vector<unsigned char> saved_iv(ci.get_iv().begin(), ci.get_iv().end());
+
+    std::vector<unsigned char> buffer(4 * 256, 0x5A);
+    std::vector<unsigned char> tags(4 * ci.get_tag_size(), 0);
+    atfw::util::crypto::cipher::aead_packet_t packets[4];
+    for (size_t i = 0; i < 4; ++i) {
+      packets[i].data = gsl::span<unsigned char>(buffer.data() + i * 256, 256);
+      packets[i].tag = gsl::span<unsigned char>(tags.data() + i * ci.get_tag_size(), ci.get_tag_size());
+    }
+    CASE_EXPECT_EQ(0, ci.encrypt_aead_batch(gsl::span<atfw::util::crypto::cipher::aead_packet_t>(packets)));
+
+    // Tag smaller than get_tag_size() is rejected before any packet is touched
+    atfw::util::crypto::cipher::aead_packet_t bad_packet = packets[0];
+    bad_packet.tag = gsl::span<unsigned char>(tags.data(), 1);
+    size_t processed = 1;
+    CASE_EXPECT_NE(0, ci.encrypt_aead_batch(gsl::span<atfw::util::crypto::cipher::aead_packet_t>(&bad_packet, 1),
+                                            &processed));
+    CASE_EXPECT_EQ(0, processed);
+
+    buffer[2 * 256 + 10] ^= 0x01;
+    CASE_EXPECT_EQ(0, ci.set_iv(saved_iv.data(), saved_iv.size()));
+    CASE_EXPECT_NE(0, ci.decrypt_aead_batch(gsl::span<atfw::util::crypto::cipher::aead_packet_t>(packets), &processed));
+    CASE_EXPECT_EQ(2, processed);
+    CASE_EXPECT_EQ(0x5A, buffer[0]);
+    CASE_EXPECT_EQ(0x5A, buffer[256 + 255]);
+  }
+}
+
+#  if defined(PROJECT_TEST_MACRO_ENABLE_BENCHMARK) && PROJECT_TEST_MACRO_ENABLE_BENCHMARK
+CASE_TEST(crypto_cipher, aead_batch_benchmark) {
+#  if defined(ATFRAMEWORK_UTILS_CRYPTO_USE_OPENSSL) || defined(ATFRAMEWORK_UTILS_CRYPTO_USE_LIBRESSL) || \
+      defined(ATFRAMEWORK_UTILS_CRYPTO_USE_BORINGSSL)
+  if (!openssl_test_inited) {
+    openssl_test_inited = std::make_shared<openssl_test_init_wrapper>();
+  }
+#  endif
+
+  const size_t packet_sizes[] = {64, 256, 1024, 4096, 16384};
+  const size_t total_bytes = 8 * 1024 * 1024;
+  const size_t batch_size = 64;
+
+  for (const char *name : aead_batch_test_ciphers) {
+    atfw::util::crypto::cipher ci;
+    if (!aead_batch_test_init(ci, name, static_cast<int32_t>(atfw::util::crypto::cipher::mode_t::kEncrypt))) {
+      continue;
+    }
+    const size_t tag_len = ci.get_tag_size();
+
+    for (size_t packet_size : packet_sizes) {
+      const size_t rounds = total_bytes / (packet_size * batch_size) + 1;
+      std::vector<unsigned char> buffer(packet_size * batch_size, 0x33);
+      std::vector<unsigned char> tags(tag_len * batch_size, 0);
+      std::vector<unsigned char> output(packet_size + ci.get_block_size() + tag_len, 0);
+      std::vector<atfw::util::crypto::cipher::aead_packet_t> packets;
+      packets.resize(batch_size);
+      for (size_t i = 0; i < batch_size; ++i) {
+        packets[i].data = gsl::span<unsigned char>(buffer.data() + i * packet_size, packet_size);
+        packets[i].tag = gsl::span<unsigned char>(tags.data() + i * tag_len, tag_len);
+      }
+
+      std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+      for (size_t r = 0; r < rounds; ++r) {
+        for (size_t i = 0; i < batch_size; ++i) {
+          size_t olen = output.size();
+          ci.encrypt_aead(buffer.data() + i * packet_size, packet_size, output.data(), &olen, nullptr, 0);
+        }
+      }
+      std::chrono::steady_clock::time_point single_end = std::chrono::steady_clock::now();
+      for (size_t r = 0; r < rounds; ++r) {
+        CASE_EXPECT_EQ(0, ci.encrypt_aead_batch(gsl::span<atfw::util::crypto::cipher::aead_packet_t>(packets)));
+      }
+      std::chrono::steady_clock::time_point batch_end = std::chrono::steady_clock::now();
+
+      double bytes = static_cast<double>(rounds * batch_size * packet_size);
+      double single_us =
+          static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(single_end - begin).count()) + 1;
+      double batch_us =
+          static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(batch_end - single_end).count()) +
+          1;
+      CASE_MSG_INFO() << "\tCipher: " << name << ", packet size: " << packet_size
+                      << ", encrypt_aead: " << bytes / single_us << "MB/s, encrypt_aead_batch: " << bytes / batch_us
+                      << "MB/s" << '\n';
+    }
+  }
+}
+#  endif
+
 #endif
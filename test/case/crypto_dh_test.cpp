@@ -1,10 +1,13 @@
 // Copyright 2026 atframework
 
 #include "algorithm/crypto_dh.h"
+#include <atomic>
+#include <chrono>
 #include <cstring>
 #include "algorithm/crypto_cipher.h"
 #include "common/file_system.h"
 #include "frame/test_macros.h"
+#include "thread/work_stealing_pool.h"
 
 #ifdef CRYPTO_DH_ENABLED
 
@@ -362,4 +365,228 @@ CASE_TEST(crypto_dh, ecdh_alias_and_both_server) {
   }
 }
 
+#  if defined(ATFRAMEWORK_UTILS_CRYPTO_USE_OPENSSL) || defined(ATFRAMEWORK_UTILS_CRYPTO_USE_LIBRESSL) || \
+      defined(ATFRAMEWORK_UTILS_CRYPTO_USE_BORINGSSL)
+namespace {
+static std::string crypto_dh_test_dhparam_path() {
+  std::string dir;
+  atfw::util::file_system::dirname(__FILE__, 0, dir, 2);
+  dir += atfw::util::file_system::DIRECTORY_SEPARATOR;
+  dir += "resource";
+  dir += atfw::util::file_system::DIRECTORY_SEPARATOR;
+  dir += "test-dhparam.pem";
+  return dir;
+}
+
+// Run a full handshake with a new client, server side uses the given shared context
+static bool crypto_dh_test_key_pool_handshake(const atfw::util::crypto::dh::shared_context::ptr_t &svr_shctx) {
+  atfw::util::crypto::dh svr_dh;
+  atfw::util::crypto::dh cli_dh;
+  atfw::util::crypto::dh::shared_context::ptr_t cli_shctx = atfw::util::crypto::dh::shared_context::create();
+  if (atfw::util::crypto::dh::error_code_t::kOk != cli_shctx->init(svr_shctx->get_method()) ||
+      atfw::util::crypto::dh::error_code_t::kOk != svr_dh.init(svr_shctx) ||
+      atfw::util::crypto::dh::error_code_t::kOk != cli_dh.init(cli_shctx)) {
+    return false;
+  }
+
+  std::vector<unsigned char> switch_params;
+  std::vector<unsigned char> switch_public;
+  std::vector<unsigned char> cli_secret;
+  std::vector<unsigned char> svr_secret;
+  if (atfw::util::crypto::dh::error_code_t::kOk != svr_dh.make_params(switch_params) ||
+      atfw::util::crypto::dh::error_code_t::kOk != cli_dh.read_params(switch_params.data(), switch_params.size()) ||
+      atfw::util::crypto::dh::error_code_t::kOk != cli_dh.make_public(switch_public) ||
+      atfw::util::crypto::dh::error_code_t::kOk != cli_dh.calc_secret(cli_secret) ||
+      atfw::util::crypto::dh::error_code_t::kOk != svr_dh.read_public(switch_public.data(), switch_public.size()) ||
+      atfw::util::crypto::dh::error_code_t::kOk != svr_dh.calc_secret(svr_secret)) {
+    return false;
+  }
+
+  return !svr_secret.empty() && cli_secret == svr_secret;
+}
+}  // namespace
+
+CASE_TEST(crypto_dh, key_pool) {
+  if (!openssl_test_inited_for_dh) {
+    openssl_test_inited_for_dh = std::make_shared<openssl_test_init_wrapper_for_dh>();
+  }
+
+  std::vector<std::string> shctx_names = {"ecdh:P-256"};
+#    if !defined(ATFRAMEWORK_UTILS_CRYPTO_USE_BORINGSSL)
+  shctx_names.push_back(crypto_dh_test_dhparam_path());
+#    endif
+
+  for (auto &name : shctx_names) {
+    CASE_MSG_INFO() << "Test key pool of " << name << std::endl;
+    atfw::util::crypto::dh::shared_context::ptr_t svr_shctx = atfw::util::crypto::dh::shared_context::create();
+    CASE_EXPECT_EQ(atfw::util::crypto::dh::error_code_t::kOk, svr_shctx->init(name.c_str()));
+
+    CASE_EXPECT_EQ(atfw::util::crypto::dh::error_code_t::kInvalidParam, svr_shctx->set_key_pool(4, 2));
+    CASE_EXPECT_EQ(atfw::util::crypto::dh::error_code_t::kOk, svr_shctx->set_key_pool(1, 4));
+    CASE_EXPECT_EQ(2, svr_shctx->refill_key_pool(2));
+    CASE_EXPECT_EQ(2, svr_shctx->refill_key_pool());
+    CASE_EXPECT_EQ(0, svr_shctx->refill_key_pool());
+    CASE_EXPECT_EQ(4, svr_shctx->get_key_pool_stats().cached_count);
+    CASE_EXPECT_EQ(4, svr_shctx->get_key_pool_stats().generated_count);
+
+    // The shared context is reused by all handshakes, pooled key pairs are taken first
+    for (int i = 0; i < 5; ++i) {
+      CASE_EXPECT_TRUE(crypto_dh_test_key_pool_handshake(svr_shctx));
+    }
+
+    atfw::util::crypto::dh::key_pool_stats_t stats = svr_shctx->get_key_pool_stats();
+    CASE_EXPECT_EQ(0, stats.cached_count);
+    CASE_EXPECT_EQ(4, stats.hit_count);
+    CASE_EXPECT_EQ(1, stats.miss_count);
+
+    // Disable pool
+    CASE_EXPECT_EQ(2, svr_shctx->refill_key_pool(2));
+    CASE_EXPECT_EQ(atfw::util::crypto::dh::error_code_t::kOk, svr_shctx->set_key_pool(0, 0));
+    CASE_EXPECT_EQ(0, svr_shctx->get_key_pool_stats().cached_count);
+    CASE_EXPECT_TRUE(crypto_dh_test_key_pool_handshake(svr_shctx));
+    CASE_EXPECT_EQ(1, svr_shctx->get_key_pool_stats().miss_count);
+
+    // Reset drops all cached key pairs
+    CASE_EXPECT_EQ(atfw::util::crypto::dh::error_code_t::kOk, svr_shctx->set_key_pool(1, 4));
+    CASE_EXPECT_EQ(4, svr_shctx->refill_key_pool());
+    svr_shctx->reset();
+    CASE_EXPECT_EQ(0, svr_shctx->get_key_pool_stats().cached_count);
+  }
+}
+
+CASE_TEST(crypto_dh, key_pool_background_refill) {
+  if (!openssl_test_inited_for_dh) {
+    openssl_test_inited_for_dh = std::make_shared<openssl_test_init_wrapper_for_dh>();
+  }
+
+  atfw::util::thread::work_stealing_pool pool(1);
+  atfw::util::crypto::dh::shared_context::ptr_t svr_shctx = atfw::util::crypto::dh::shared_context::create();
+  CASE_EXPECT_EQ(atfw::util::crypto::dh::error_code_t::kOk, svr_shctx->init("ecdh:P-256"));
+  CASE_EXPECT_EQ(atfw::util::crypto::dh::error_code_t::kOk, svr_shctx->set_key_pool(4, 8, &pool));
+  pool.wait_idle();
+  CASE_EXPECT_EQ(8, svr_shctx->get_key_pool_stats().cached_count);
+
+  // Refill is started after the pool drop below low watermark
+  for (int i = 0; i < 6; ++i) {
+    CASE_EXPECT_TRUE(crypto_dh_test_key_pool_handshake(svr_shctx));
+  }
+  pool.wait_idle();
+
+  // Handshakes may race with the background refill, only the low watermark is guaranteed here
+  atfw::util::crypto::dh::key_pool_stats_t stats = svr_shctx->get_key_pool_stats();
+  CASE_EXPECT_GE(stats.cached_count, 4);
+  CASE_EXPECT_EQ(6, stats.hit_count + stats.miss_count);
+  CASE_EXPECT_EQ(stats.cached_count + stats.hit_count, stats.generated_count);
+
+  // Refill on the calling thread to get a deterministic count
+  svr_shctx->refill_key_pool();
+  stats = svr_shctx->get_key_pool_stats();
+  CASE_EXPECT_EQ(8, stats.cached_count);
+  CASE_EXPECT_EQ(8 + stats.hit_count, stats.generated_count);
+
+  CASE_EXPECT_EQ(atfw::util::crypto::dh::error_code_t::kOk, svr_shctx->set_key_pool(0, 0, nullptr));
+}
+
+CASE_TEST(crypto_dh, calc_secret_async) {
+  if (!openssl_test_inited_for_dh) {
+    openssl_test_inited_for_dh = std::make_shared<openssl_test_init_wrapper_for_dh>();
+  }
+
+  atfw::util::thread::work_stealing_pool pool(2);
+  atfw::util::crypto::dh cli_dh;
+  atfw::util::crypto::dh svr_dh;
+  {
+    atfw::util::crypto::dh::shared_context::ptr_t svr_shctx = atfw::util::crypto::dh::shared_context::create();
+    CASE_EXPECT_EQ(atfw::util::crypto::dh::error_code_t::kOk, svr_shctx->init("ecdh:P-256"));
+    CASE_EXPECT_EQ(atfw::util::crypto::dh::error_code_t::kOk, svr_dh.init(svr_shctx));
+
+    atfw::util::crypto::dh::shared_context::ptr_t cli_shctx = atfw::util::crypto::dh::shared_context::create();
+    CASE_EXPECT_EQ(atfw::util::crypto::dh::error_code_t::kOk,
+                   cli_shctx->init(atfw::util::crypto::dh::method_t::kEcdh));
+    CASE_EXPECT_EQ(atfw::util::crypto::dh::error_code_t::kOk, cli_dh.init(cli_shctx));
+  }
+
+  CASE_EXPECT_EQ(atfw::util::crypto::dh::error_code_t::kInvalidParam,
+                 svr_dh.calc_secret_async(pool, atfw::util::crypto::dh::calc_secret_callback_t()));
+
+  std::vector<unsigned char> switch_params;
+  std::vector<unsigned char> switch_public;
+  CASE_EXPECT_EQ(atfw::util::crypto::dh::error_code_t::kOk, svr_dh.make_params(switch_params));
+  CASE_EXPECT_EQ(atfw::util::crypto::dh::error_code_t::kOk,
+                 cli_dh.read_params(switch_params.data(), switch_params.size()));
+  CASE_EXPECT_EQ(atfw::util::crypto::dh::error_code_t::kOk, cli_dh.make_public(switch_public));
+  CASE_EXPECT_EQ(atfw::util::crypto::dh::error_code_t::kOk,
+                 svr_dh.read_public(switch_public.data(), switch_public.size()));
+
+  std::vector<unsigned char> cli_secret;
+  std::vector<unsigned char> svr_secret;
+  std::atomic<int> callback_count{0};
+  atfw::util::crypto::dh::error_code_t cli_result = atfw::util::crypto::dh::error_code_t::kInvalidParam;
+  atfw::util::crypto::dh::error_code_t svr_result = atfw::util::crypto::dh::error_code_t::kInvalidParam;
+  CASE_EXPECT_EQ(atfw::util::crypto::dh::error_code_t::kOk,
+                 cli_dh.calc_secret_async(pool, [&](atfw::util::crypto::dh &, atfw::util::crypto::dh::error_code_t res,
+                                                    std::vector<unsigned char> &secret) {
+                   cli_result = res;
+                   cli_secret.swap(secret);
+                   ++callback_count;
+                 }));
+  CASE_EXPECT_EQ(atfw::util::crypto::dh::error_code_t::kOk,
+                 svr_dh.calc_secret_async(pool, [&](atfw::util::crypto::dh &, atfw::util::crypto::dh::error_code_t res,
+                                                    std::vector<unsigned char> &secret) {
+                   svr_result = res;
+                   svr_secret.swap(secret);
+                   ++callback_count;
+                 }));
+  pool.wait_idle();
+
+  CASE_EXPECT_EQ(2, callback_count.load());
+  CASE_EXPECT_EQ(atfw::util::crypto::dh::error_code_t::kOk, cli_result);
+  CASE_EXPECT_EQ(atfw::util::crypto::dh::error_code_t::kOk, svr_result);
+  CASE_EXPECT_FALSE(svr_secret.empty());
+  CASE_EXPECT_TRUE(cli_secret == svr_secret);
+
+  pool.stop();
+  CASE_EXPECT_EQ(atfw::util::crypto::dh::error_code_t::kOperation,
+                 svr_dh.calc_secret_async(pool, [](atfw::util::crypto::dh &, atfw::util::crypto::dh::error_code_t,
+                                                   std::vector<unsigned char> &) {}));
+}
+
+#    if defined(PROJECT_TEST_MACRO_ENABLE_BENCHMARK) && PROJECT_TEST_MACRO_ENABLE_BENCHMARK
+CASE_TEST(crypto_dh, key_pool_benchmark) {
+  if (!openssl_test_inited_for_dh) {
+    openssl_test_inited_for_dh = std::make_shared<openssl_test_init_wrapper_for_dh>();
+  }
+
+  const int test_times = 64;
+  atfw::util::crypto::dh::shared_context::ptr_t svr_shctx = atfw::util::crypto::dh::shared_context::create();
+  CASE_EXPECT_EQ(atfw::util::crypto::dh::error_code_t::kOk, svr_shctx->init("ecdh:P-256"));
+
+  std::vector<unsigned char> switch_params;
+  auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < test_times; ++i) {
+    atfw::util::crypto::dh svr_dh;
+    svr_dh.init(svr_shctx);
+    CASE_EXPECT_EQ(atfw::util::crypto::dh::error_code_t::kOk, svr_dh.make_params(switch_params));
+  }
+  auto inline_cost = std::chrono::steady_clock::now() - begin;
+
+  CASE_EXPECT_EQ(atfw::util::crypto::dh::error_code_t::kOk, svr_shctx->set_key_pool(0, test_times));
+  CASE_EXPECT_EQ(test_times, svr_shctx->refill_key_pool());
+  begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < test_times; ++i) {
+    atfw::util::crypto::dh svr_dh;
+    svr_dh.init(svr_shctx);
+    CASE_EXPECT_EQ(atfw::util::crypto::dh::error_code_t::kOk, svr_dh.make_params(switch_params));
+  }
+  auto pool_cost = std::chrono::steady_clock::now() - begin;
+  CASE_EXPECT_EQ(test_times, svr_shctx->get_key_pool_stats().hit_count);
+
+  CASE_MSG_INFO() << "ECDH P-256 make_params " << test_times << " times, inline keygen: "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(inline_cost).count()
+                  << "us, key pool: " << std::chrono::duration_cast<std::chrono::microseconds>(pool_cost).count()
+                  << "us" << '\n';
+}
+#    endif
+#  endif
+
 #endif
@@ -1,5 +1,6 @@
 // Copyright 2026 atframework
 
+#include <chrono>
 #include <cstdlib>
 #include <cstring>
 #include <memory>
@@ -352,6 +353,161 @@ CASE_TEST(crypto_hmac, hmac_empty_data) {
   CASE_EXPECT_EQ(32u, result.size());
 }
 
+CASE_TEST(crypto_hmac, hmac_reset_and_rekey) {
+  ensure_openssl_inited();
+
+  std::vector<unsigned char> key1(20, 0x0b);
+  std::vector<unsigned char> key2 = hex_to_bytes("4a656665");
+  const char* data1 = "Hi There";
+  const char* data2 = "what do ya want for nothing?";
+
+  atfw::util::crypto::hmac h;
+  CASE_EXPECT_EQ(atfw::util::crypto::hmac_error_code_t::kNotInitialized, h.reset());
+  CASE_EXPECT_EQ(atfw::util::crypto::hmac_error_code_t::kNotInitialized, h.rekey(key1.data(), key1.size()));
+
+  CASE_EXPECT_EQ(atfw::util::crypto::hmac_error_code_t::kOk,
+                 h.init(atfw::util::crypto::digest_type_t::kSha256, key1.data(), key1.size()));
+  CASE_EXPECT_TRUE(atfw::util::crypto::digest_type_t::kSha256 == h.get_digest_type());
+
+  // Partial update is discarded by reset
+  h.update(reinterpret_cast<const unsigned char*>(data2), 4);
+  CASE_EXPECT_EQ(atfw::util::crypto::hmac_error_code_t::kOk, h.reset());
+
+  std::vector<unsigned char> output(32);
+  for (int i = 0; i < 2; ++i) {
+    size_t output_len = output.size();
+    h.update(reinterpret_cast<const unsigned char*>(data1), strlen(data1));
+    CASE_EXPECT_EQ(atfw::util::crypto::hmac_error_code_t::kOk, h.final(output.data(), &output_len));
+    // RFC 4231 test case 1
+    CASE_EXPECT_EQ("b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7", bytes_to_hex(output));
+    CASE_EXPECT_EQ(atfw::util::crypto::hmac_error_code_t::kOk, h.reset());
+  }
+
+  // RFC 4231 test case 2
+  CASE_EXPECT_EQ(atfw::util::crypto::hmac_error_code_t::kOk, h.rekey(key2.data(), key2.size()));
+  size_t output_len = output.size();
+  h.update(reinterpret_cast<const unsigned char*>(data2), strlen(data2));
+  CASE_EXPECT_EQ(atfw::util::crypto::hmac_error_code_t::kOk, h.final(output.data(), &output_len));
+  CASE_EXPECT_EQ("5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843", bytes_to_hex(output));
+
+  // Empty key must not keep the previous key
+  CASE_EXPECT_EQ(atfw::util::crypto::hmac_error_code_t::kOk, h.rekey(nullptr, 0));
+  output_len = output.size();
+  h.update(reinterpret_cast<const unsigned char*>(data2), strlen(data2));
+  CASE_EXPECT_EQ(atfw::util::crypto::hmac_error_code_t::kOk, h.final(output.data(), &output_len));
+  CASE_EXPECT_EQ("76d9e7194e7dbc3aa00bbe8ffb9f6fcb5a932170f971f948bb2ab61607d2b9d6", bytes_to_hex(output));
+}
+
+CASE_TEST(crypto_hmac, hmac_compute_batch) {
+  ensure_openssl_inited();
+
+  std::vector<unsigned char> data(4096);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<unsigned char>(i * 31 + 7);
+  }
+
+  std::vector<const unsigned char*> inputs;
+  std::vector<size_t> lengths;
+  for (size_t i = 0; i < 100; ++i) {
+    lengths.push_back((i * 97) % 2048);
+    inputs.push_back(data.data() + i);
+  }
+
+  atfw::util::crypto::digest_type_t types[] = {
+      atfw::util::crypto::digest_type_t::kSha1, atfw::util::crypto::digest_type_t::kSha256,
+      atfw::util::crypto::digest_type_t::kSha512};
+  for (atfw::util::crypto::digest_type_t type : types) {
+    size_t digest_len = atfw::util::crypto::get_digest_output_length(type);
+    // Two different keys to check that the cached context is rekeyed
+    for (size_t key_len : {static_cast<size_t>(16), static_cast<size_t>(200)}) {
+      std::vector<unsigned char> key(key_len, static_cast<unsigned char>(key_len));
+      std::vector<unsigned char> output(digest_len * inputs.size());
+      CASE_EXPECT_EQ(atfw::util::crypto::hmac_error_code_t::kOk,
+                     atfw::util::crypto::hmac::compute_batch(type, key.data(), key.size(), inputs.data(),
+                                                             lengths.data(), inputs.size(), output.data(),
+                                                             output.size()));
+
+      size_t mismatch = 0;
+      for (size_t i = 0; i < inputs.size(); ++i) {
+        std::vector<unsigned char> expect =
+            atfw::util::crypto::hmac::compute_to_binary(type, key.data(), key.size(), inputs[i], lengths[i]);
+        if (expect.size() != digest_len || 0 != memcmp(expect.data(), output.data() + i * digest_len, digest_len)) {
+          ++mismatch;
+        }
+      }
+      CASE_EXPECT_EQ(0, mismatch);
+    }
+  }
+
+  std::vector<unsigned char> key(16, 0x0b);
+  unsigned char output[32];
+  CASE_EXPECT_EQ(atfw::util::crypto::hmac_error_code_t::kOutputBufferTooSmall,
+                 atfw::util::crypto::hmac::compute_batch(atfw::util::crypto::digest_type_t::kSha256, key.data(),
+                                                         key.size(), inputs.data(), lengths.data(), 2, output,
+                                                         sizeof(output)));
+  CASE_EXPECT_EQ(atfw::util::crypto::hmac_error_code_t::kDigestNotSupport,
+                 atfw::util::crypto::hmac::compute_batch(atfw::util::crypto::digest_type_t::kNone, key.data(),
+                                                         key.size(), inputs.data(), lengths.data(), 1, output,
+                                                         sizeof(output)));
+  CASE_EXPECT_EQ(atfw::util::crypto::hmac_error_code_t::kInvalidParam,
+                 atfw::util::crypto::hmac::compute_batch(atfw::util::crypto::digest_type_t::kSha256, key.data(),
+                                                         key.size(), nullptr, lengths.data(), 1, output,
+                                                         sizeof(output)));
+}
+
+#  if defined(PROJECT_TEST_MACRO_ENABLE_BENCHMARK) && PROJECT_TEST_MACRO_ENABLE_BENCHMARK
+CASE_TEST(crypto_hmac, hmac_compute_batch_benchmark) {
+  ensure_openssl_inited();
+
+  const size_t batch_size = 256;
+  std::vector<unsigned char> key(32, 0x5c);
+  std::vector<unsigned char> data(4096 * batch_size);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<unsigned char>(i * 131 + 17);
+  }
+  std::vector<unsigned char> output(32 * batch_size);
+
+  for (size_t len : {static_cast<size_t>(64), static_cast<size_t>(256), static_cast<size_t>(1024),
+                     static_cast<size_t>(4096)}) {
+    std::vector<const unsigned char*> inputs;
+    std::vector<size_t> lengths;
+    for (size_t i = 0; i < batch_size; ++i) {
+      inputs.push_back(data.data() + i * len);
+      lengths.push_back(len);
+    }
+
+    const size_t loop_count = (static_cast<size_t>(8) << 20) / (len * batch_size) + 1;
+    unsigned char sink = 0;
+
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    for (size_t loop = 0; loop < loop_count; ++loop) {
+      for (size_t i = 0; i < batch_size; ++i) {
+        size_t output_len = 32;
+        atfw::util::crypto::hmac::compute(atfw::util::crypto::digest_type_t::kSha256, key.data(), key.size(),
+                                          inputs[i], len, output.data(), &output_len);
+        sink ^= output[0];
+      }
+    }
+    auto single_usec =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count();
+
+    begin = std::chrono::steady_clock::now();
+    for (size_t loop = 0; loop < loop_count; ++loop) {
+      atfw::util::crypto::hmac::compute_batch(atfw::util::crypto::digest_type_t::kSha256, key.data(), key.size(),
+                                              inputs.data(), lengths.data(), batch_size, output.data(),
+                                              output.size());
+      sink ^= output[0];
+    }
+    auto batch_usec =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count();
+
+    CASE_MSG_INFO() << "hmac-sha256 " << loop_count * batch_size << " messages of " << len
+                    << " bytes, compute: " << single_usec << "us, compute_batch: " << batch_usec
+                    << "us, sink: " << static_cast<int>(sink) << '\n';
+  }
+}
+#  endif
+
 // ============================================================================
 // HKDF Tests
 // ============================================================================
@@ -0,0 +1,102 @@
+// Copyright 2026 atframework
+
+#include <cstdint>
+#include <vector>
+
+#include "frame/test_macros.h"
+
+#include "data_structure/dense_finite_state_machine.h"
+
+namespace {
+enum class dense_fsm_test_state : uint8_t {
+  kIdle = 0,
+  kConnecting,
+  kConnected,
+  kClosed,
+  kMax,
+};
+
+using dense_fsm_test_table =
+    atfw::util::ds::dense_finite_state_machine_table<dense_fsm_test_state,
+                                                     static_cast<size_t>(dense_fsm_test_state::kMax), int&>;
+using dense_fsm_test_machine =
+    atfw::util::ds::dense_finite_state_machine<dense_fsm_test_state, static_cast<size_t>(dense_fsm_test_state::kMax),
+                                               int&>;
+
+static void dense_fsm_test_on_connecting(dense_fsm_test_state, dense_fsm_test_state, int& counter) { ++counter; }
+
+static void dense_fsm_test_on_connected(dense_fsm_test_state, dense_fsm_test_state to, int& counter) {
+  CASE_EXPECT_TRUE(to == dense_fsm_test_state::kConnected);
+  counter += 100;
+}
+}  // namespace
+
+CASE_TEST(dense_finite_state_machine, basic) {
+  std::vector<int> sequence;
+  auto on_leave_idle = [&sequence](dense_fsm_test_state, dense_fsm_test_state, int&) { sequence.push_back(1); };
+  auto on_enter_connecting = [&sequence](dense_fsm_test_state, dense_fsm_test_state, int&) { sequence.push_back(2); };
+  auto on_switch = [&sequence](dense_fsm_test_state, dense_fsm_test_state, int& counter) {
+    sequence.push_back(3);
+    ++counter;
+  };
+
+  dense_fsm_test_table table;
+  CASE_EXPECT_TRUE(table.add_listener(dense_fsm_test_state::kIdle, dense_fsm_test_state::kConnecting, on_switch));
+  CASE_EXPECT_TRUE(table.add_leave_listener(dense_fsm_test_state::kIdle, on_leave_idle));
+  CASE_EXPECT_TRUE(table.add_enter_listener(dense_fsm_test_state::kConnecting, on_enter_connecting));
+  CASE_EXPECT_TRUE(table.add_listener(dense_fsm_test_state::kConnecting, dense_fsm_test_state::kConnected,
+                                      dense_fsm_test_on_connected));
+  CASE_EXPECT_TRUE(table.add_transition(dense_fsm_test_state::kConnected, dense_fsm_test_state::kClosed));
+  CASE_EXPECT_FALSE(table.add_transition(dense_fsm_test_state::kClosed, dense_fsm_test_state::kMax));
+
+  dense_fsm_test_machine fsm(table);
+  int counter = 0;
+  CASE_EXPECT_TRUE(fsm.get_state() == dense_fsm_test_state::kIdle);
+  CASE_EXPECT_FALSE(fsm.test(dense_fsm_test_state::kConnected));
+  CASE_EXPECT_FALSE(fsm.set_state(dense_fsm_test_state::kConnected, counter));
+  CASE_EXPECT_TRUE(fsm.get_state() == dense_fsm_test_state::kIdle);
+
+  CASE_EXPECT_TRUE(fsm.test(dense_fsm_test_state::kConnecting));
+  CASE_EXPECT_TRUE(fsm.set_state(dense_fsm_test_state::kConnecting, counter));
+  CASE_EXPECT_TRUE(fsm.get_state() == dense_fsm_test_state::kConnecting);
+  CASE_EXPECT_EQ(1, counter);
+  CASE_EXPECT_EQ(3, sequence.size());
+  if (sequence.size() == 3) {
+    CASE_EXPECT_EQ(1, sequence[0]);
+    CASE_EXPECT_EQ(2, sequence[1]);
+    CASE_EXPECT_EQ(3, sequence[2]);
+  }
+
+  CASE_EXPECT_TRUE(fsm.set_state(dense_fsm_test_state::kConnected, counter));
+  CASE_EXPECT_EQ(101, counter);
+
+  // transition without listeners
+  CASE_EXPECT_TRUE(fsm.set_state(dense_fsm_test_state::kClosed, counter));
+  CASE_EXPECT_TRUE(fsm.get_state() == dense_fsm_test_state::kClosed);
+  CASE_EXPECT_EQ(101, counter);
+  CASE_EXPECT_FALSE(fsm.set_state(dense_fsm_test_state::kIdle, counter));
+}
+
+CASE_TEST(dense_finite_state_machine, shared_table) {
+  dense_fsm_test_table table;
+  table.add_listener(dense_fsm_test_state::kIdle, dense_fsm_test_state::kConnecting, dense_fsm_test_on_connecting);
+  table.add_transition(dense_fsm_test_state::kConnecting, dense_fsm_test_state::kIdle);
+
+  std::vector<dense_fsm_test_machine> machines;
+  machines.reserve(128);
+  for (int i = 0; i < 128; ++i) {
+    machines.emplace_back(table, (i & 1) ? dense_fsm_test_state::kConnecting : dense_fsm_test_state::kIdle);
+  }
+
+  int counter = 0;
+  for (auto& fsm : machines) {
+    if (fsm.get_state() == dense_fsm_test_state::kIdle) {
+      CASE_EXPECT_TRUE(fsm.set_state(dense_fsm_test_state::kConnecting, counter));
+    } else {
+      CASE_EXPECT_TRUE(fsm.set_state(dense_fsm_test_state::kIdle, counter));
+    }
+    CASE_EXPECT_TRUE(&fsm.get_table() == &table);
+  }
+
+  CASE_EXPECT_EQ(64, counter);
+}
@@ -4,6 +4,7 @@
 
 #include "config/compiler_features.h"
 
+#include "lock/hybrid_mutex.h"
 #include "lock/lock_holder.h"
 #include "lock/spin_lock.h"
 #include "lock/spin_rw_lock.h"
@@ -53,6 +54,36 @@ CASE_TEST(lock_test, lock_holder) {
   CASE_EXPECT_FALSE(lock.is_locked());
 }
 
+CASE_TEST(lock_test, hybrid_mutex) {
+  atfw::util::lock::hybrid_mutex lock;
+  CASE_EXPECT_FALSE(lock.is_locked());
+
+  lock.lock();
+  CASE_EXPECT_TRUE(lock.is_locked());
+
+  CASE_EXPECT_FALSE(lock.try_lock());
+
+  lock.unlock();
+  CASE_EXPECT_FALSE(lock.is_locked());
+
+  CASE_EXPECT_TRUE(lock.try_lock());
+  CASE_EXPECT_TRUE(lock.try_unlock());
+  CASE_EXPECT_FALSE(lock.try_unlock());
+
+  {
+    atfw::util::lock::lock_holder<atfw::util::lock::hybrid_mutex> holder(lock);
+    CASE_EXPECT_TRUE(holder.is_available());
+    CASE_EXPECT_TRUE(lock.is_locked());
+  }
+  CASE_EXPECT_FALSE(lock.is_locked());
+
+  // No contention, no stats
+  atfw::util::lock::hybrid_mutex_stats stats = lock.get_stats();
+  CASE_EXPECT_EQ(0, stats.contended_count);
+  CASE_EXPECT_EQ(0, stats.parked_count);
+  CASE_EXPECT_LE(stats.spin_limit, lock.get_max_spin());
+}
+
 CASE_TEST(lock_test, spin_rw_lock) {
   atfw::util::lock::spin_rw_lock lock;
 
@@ -191,4 +222,47 @@ CASE_TEST(lock_test, spin_rw_lock_mt) {
   CASE_EXPECT_FALSE(lock.is_read_locked());
 }
 
+CASE_TEST(lock_test, hybrid_mutex_mt) {
+  atfw::util::lock::hybrid_mutex lock;
+  size_t counter = 0;
+
+  lock.lock();
+  std::thread *lock_thd[8];
+  for (int i = 0; i < 8; ++i) {
+    lock_thd[i] = new std::thread([&lock, &counter]() {
+      for (int j = 0; j < 1000; ++j) {
+        atfw::util::lock::lock_holder<atfw::util::lock::hybrid_mutex> holder(lock);
+        ++counter;
+      }
+    });
+  }
+
+  // Hold the lock until waiters run out of spin budget and park
+  while (lock.get_stats().parked_count == 0) {
+    atfw::util::lock::detail::thread_sleep();
+  }
+  lock.unlock();
+
+  for (int i = 0; i < 8; ++i) {
+    if (lock_thd[i]->joinable()) {
+      lock_thd[i]->join();
+    }
+
+    delete lock_thd[i];
+  }
+
+  CASE_EXPECT_EQ(8000, counter);
+  CASE_EXPECT_FALSE(lock.is_locked());
+
+  atfw::util::lock::hybrid_mutex_stats stats = lock.get_stats();
+  CASE_MSG_INFO() << "hybrid_mutex contended: " << stats.contended_count << ", spin acquired: "
+                  << stats.spin_acquired_count << ", parked: " << stats.parked_count
+                  << ", spin limit: " << stats.spin_limit << '\n';
+  CASE_EXPECT_GT(stats.contended_count, 0);
+  CASE_EXPECT_GT(stats.parked_count, 0);
+
+  lock.reset_stats();
+  CASE_EXPECT_EQ(0, lock.get_stats().contended_count);
+}
+
 #endif
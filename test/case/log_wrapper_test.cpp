@@ -0,0 +1,45 @@
+// Copyright 2026 atframework
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "frame/test_macros.h"
+
+#include "log/log_wrapper.h"
+#include "string/compiled_format.h"
+
+CASE_TEST(log_wrapper, compiled_format) {
+  atfw::util::log::log_wrapper::ptr_t logger = atfw::util::log::log_wrapper::create_user_logger();
+  CASE_EXPECT_TRUE(!!logger);
+  if (!logger) {
+    return;
+  }
+
+  std::vector<std::string> contents;
+  logger->set_prefix_format("");
+  logger->add_sink([&contents](const atfw::util::log::log_wrapper::caller_info_t &,
+                               atfw::util::nostd::string_view content) {
+    contents.push_back(std::string(content.data(), content.size()));
+  });
+
+  constexpr auto format = atfw::util::string::make_compiled_format<int, atfw::util::nostd::string_view>(
+      "id={}, name={}");
+  atfw::util::log::log_wrapper::caller_info_t caller(atfw::util::log::log_level::kInfo, {}, __FILE__, __LINE__,
+                                                     __FUNCTION__);
+  logger->format_log(caller, format, 42, "hello");
+  CASE_EXPECT_EQ(1, contents.size());
+  if (!contents.empty()) {
+    CASE_EXPECT_EQ("id=42, name=hello", contents.back());
+  }
+
+  // Content longer than the log buffer is truncated to the buffer size
+  std::string long_name(ATFRAMEWORK_UTILS_LOG_MAX_SIZE_PER_LINE * 2, 'x');
+  logger->format_log(caller, format, 7, long_name);
+  CASE_EXPECT_EQ(2, contents.size());
+  if (contents.size() >= 2) {
+    std::string expect = "id=7, name=" + long_name;
+    CASE_EXPECT_EQ(static_cast<size_t>(ATFRAMEWORK_UTILS_LOG_MAX_SIZE_PER_LINE - 1), contents.back().size());
+    CASE_EXPECT_EQ(expect.substr(0, contents.back().size()), contents.back());
+  }
+}
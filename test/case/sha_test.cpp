@@ -1,7 +1,10 @@
 // Copyright 2026 atframework
 
 #include <time.h>
+#include <chrono>
+#include <cstring>
 #include <string>
+#include <vector>
 
 #include <config/compiler_features.h>
 
@@ -197,3 +200,147 @@ CASE_TEST(sha, sha512) {
   }
 }
 
+
+namespace {
+static std::vector<unsigned char> sha_test_make_data(size_t len) {
+  std::vector<unsigned char> ret;
+  ret.resize(len);
+  uint32_t seed = 1;
+  for (size_t i = 0; i < len; ++i) {
+    seed = seed * 1103515245 + 12345;
+    ret[i] = static_cast<unsigned char>(seed >> 16);
+  }
+  return ret;
+}
+}  // namespace
+
+CASE_TEST(sha, reset) {
+  const char* data = "abc";
+  atfw::util::hash::sha obj;
+  CASE_EXPECT_FALSE(obj.reset());
+
+  CASE_EXPECT_TRUE(obj.init(atfw::util::hash::sha::EN_ALGORITHM_SHA256));
+  CASE_EXPECT_EQ(atfw::util::hash::sha::EN_ALGORITHM_SHA256, obj.get_type());
+  obj.update(reinterpret_cast<const unsigned char*>("garbage"), 7);
+  CASE_EXPECT_TRUE(obj.reset());
+  obj.update(reinterpret_cast<const unsigned char*>(data), 3);
+  obj.final();
+  CASE_EXPECT_EQ("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad", obj.get_output_hex());
+
+  // Reset after final
+  CASE_EXPECT_TRUE(obj.reset());
+  obj.update(reinterpret_cast<const unsigned char*>(data), 3);
+  obj.final();
+  CASE_EXPECT_EQ("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad", obj.get_output_hex());
+}
+
+CASE_TEST(sha, hash_batch) {
+  std::vector<unsigned char> data = sha_test_make_data(8192);
+
+  // Lengths cover empty message, one/two padding blocks and unbalanced lanes
+  std::vector<size_t> lengths;
+  for (size_t i = 0; i <= 130; ++i) {
+    lengths.push_back(i);
+  }
+  lengths.push_back(4096);
+  for (size_t i = 0; i < 37; ++i) {
+    lengths.push_back((i * 977) % 8192);
+  }
+  lengths.push_back(8192);
+
+  std::vector<const void*> inputs;
+  for (size_t i = 0; i < lengths.size(); ++i) {
+    inputs.push_back(data.data() + (i * 13) % (data.size() - lengths[i] + 1));
+  }
+
+  atfw::util::hash::sha::type types[] = {
+      atfw::util::hash::sha::EN_ALGORITHM_SHA1, atfw::util::hash::sha::EN_ALGORITHM_SHA224,
+      atfw::util::hash::sha::EN_ALGORITHM_SHA256, atfw::util::hash::sha::EN_ALGORITHM_SHA384,
+      atfw::util::hash::sha::EN_ALGORITHM_SHA512};
+  for (atfw::util::hash::sha::type t : types) {
+    const size_t output_length = atfw::util::hash::sha::get_output_length(t);
+    // Every prefix count exercises a different lane occupancy
+    for (size_t count : {static_cast<size_t>(1), static_cast<size_t>(3), static_cast<size_t>(9), lengths.size()}) {
+      std::vector<unsigned char> outputs;
+      outputs.resize(count * output_length);
+      CASE_EXPECT_TRUE(
+          atfw::util::hash::sha::hash_batch(t, inputs.data(), lengths.data(), count, outputs.data(), outputs.size()));
+
+      size_t mismatch = 0;
+      for (size_t i = 0; i < count; ++i) {
+        std::string expect = atfw::util::hash::sha::hash_to_binary(t, inputs[i], lengths[i]);
+        if (expect.size() != output_length ||
+            0 != memcmp(expect.data(), outputs.data() + i * output_length, output_length)) {
+          ++mismatch;
+        }
+      }
+      CASE_EXPECT_EQ(0, mismatch);
+    }
+  }
+
+  // Invalid parameters
+  unsigned char output[32];
+  size_t length = 0;
+  CASE_EXPECT_TRUE(atfw::util::hash::sha::hash_batch(atfw::util::hash::sha::EN_ALGORITHM_SHA256, nullptr, nullptr, 0,
+                                                     nullptr, 0));
+  CASE_EXPECT_FALSE(atfw::util::hash::sha::hash_batch(atfw::util::hash::sha::EN_ALGORITHM_SHA256, nullptr, &length, 1,
+                                                      output, sizeof(output)));
+  CASE_EXPECT_FALSE(atfw::util::hash::sha::hash_batch(atfw::util::hash::sha::EN_ALGORITHM_UNINITED, inputs.data(),
+                                                      &length, 1, output, sizeof(output)));
+
+  // Output buffer too small
+  CASE_EXPECT_TRUE(atfw::util::hash::sha::hash_batch(atfw::util::hash::sha::EN_ALGORITHM_SHA256, inputs.data(),
+                                                     &length, 1, output, sizeof(output)));
+  CASE_EXPECT_FALSE(atfw::util::hash::sha::hash_batch(atfw::util::hash::sha::EN_ALGORITHM_SHA256, inputs.data(),
+                                                      &length, 1, output, sizeof(output) - 1));
+  CASE_EXPECT_FALSE(atfw::util::hash::sha::hash_batch(atfw::util::hash::sha::EN_ALGORITHM_SHA512, inputs.data(),
+                                                      &length, 1, output, sizeof(output)));
+}
+
+#if defined(PROJECT_TEST_MACRO_ENABLE_BENCHMARK) && PROJECT_TEST_MACRO_ENABLE_BENCHMARK
+CASE_TEST(sha, hash_batch_benchmark) {
+  const size_t batch_size = 256;
+  std::vector<unsigned char> data = sha_test_make_data(4096 * batch_size);
+  std::vector<unsigned char> outputs;
+  outputs.resize(batch_size * 32);
+
+  for (size_t len : {static_cast<size_t>(64), static_cast<size_t>(256), static_cast<size_t>(1024),
+                     static_cast<size_t>(4096)}) {
+    std::vector<const void*> inputs;
+    std::vector<size_t> lengths;
+    for (size_t i = 0; i < batch_size; ++i) {
+      inputs.push_back(data.data() + i * len);
+      lengths.push_back(len);
+    }
+
+    const size_t loop_count = (static_cast<size_t>(8) << 20) / (len * batch_size) + 1;
+    unsigned char sink = 0;
+
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    for (size_t loop = 0; loop < loop_count; ++loop) {
+      for (size_t i = 0; i < batch_size; ++i) {
+        atfw::util::hash::sha obj;
+        obj.init(atfw::util::hash::sha::EN_ALGORITHM_SHA256);
+        obj.update(reinterpret_cast<const unsigned char*>(inputs[i]), len);
+        obj.final();
+        sink ^= obj.get_output()[0];
+      }
+    }
+    auto single_usec =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count();
+
+    begin = std::chrono::steady_clock::now();
+    for (size_t loop = 0; loop < loop_count; ++loop) {
+      atfw::util::hash::sha::hash_batch(atfw::util::hash::sha::EN_ALGORITHM_SHA256, inputs.data(), lengths.data(),
+                                        batch_size, outputs.data(), outputs.size());
+      sink ^= outputs[0];
+    }
+    auto batch_usec =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count();
+
+    CASE_MSG_INFO() << "sha256 " << loop_count * batch_size << " messages of " << len
+                    << " bytes, new context per message: " << single_usec << "us, hash_batch: " << batch_usec
+                    << "us, sink: " << static_cast<int>(sink) << '\n';
+  }
+}
+#endif
@@ -1,6 +1,14 @@
 // Copyright 2026 atframework
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
 #include <map>
+#include <random>
+#include <string>
 #include <vector>
 
 #include "common/string_oprs.h"
@@ -150,3 +158,528 @@ CASE_TEST(string_oprs, int2str) {
   CASE_EXPECT_EQ(0, atfw::util::string::int2str(buffer, 8, 123456789U));
 }
 
+
+namespace {
+#if defined(PROJECT_TEST_MACRO_ENABLE_BENCHMARK) && PROJECT_TEST_MACRO_ENABLE_BENCHMARK
+// The previous digit by digit implementation, used as the reference of benchmark
+static size_t string_oprs_test_int2str_digit_by_digit(char *str, size_t strsz, uint64_t in) {
+  if (0 == in) {
+    *str = '0';
+    return 1;
+  }
+
+  size_t ret = 0;
+  while (ret < strsz && in > 0) {
+    str[ret++] = static_cast<char>((in % 10) + '0');
+    in /= 10;
+  }
+  atfw::util::string::reverse(str, str + ret);
+  return ret;
+}
+#endif
+
+template <class T>
+static void string_oprs_test_int2str_value(T value) {
+  char buffer[32];
+  size_t len = atfw::util::string::int2str(buffer, sizeof(buffer), value);
+  CASE_EXPECT_EQ(std::to_string(value), std::string(buffer, len));
+
+  // Buffer too small
+  if (len > 1) {
+    CASE_EXPECT_EQ(0, atfw::util::string::int2str(buffer, len - 1, value));
+  }
+}
+}  // namespace
+
+CASE_TEST(string_oprs, int2str_limits) {
+  string_oprs_test_int2str_value(std::numeric_limits<int8_t>::min());
+  string_oprs_test_int2str_value(std::numeric_limits<int16_t>::min());
+  string_oprs_test_int2str_value(std::numeric_limits<int32_t>::min());
+  string_oprs_test_int2str_value(std::numeric_limits<int64_t>::min());
+  string_oprs_test_int2str_value(std::numeric_limits<int64_t>::max());
+  string_oprs_test_int2str_value(std::numeric_limits<uint8_t>::max());
+  string_oprs_test_int2str_value(std::numeric_limits<uint16_t>::max());
+  string_oprs_test_int2str_value(std::numeric_limits<uint32_t>::max());
+  string_oprs_test_int2str_value(std::numeric_limits<uint64_t>::max());
+
+  std::mt19937_64 rnd(20261019);
+  for (int i = 0; i < 2000; ++i) {
+    uint64_t value = rnd() >> (rnd() % 64);
+    string_oprs_test_int2str_value(value);
+    string_oprs_test_int2str_value(static_cast<int64_t>(value));
+    string_oprs_test_int2str_value(static_cast<int32_t>(value));
+    string_oprs_test_int2str_value(static_cast<uint16_t>(value));
+  }
+}
+
+CASE_TEST(string_oprs, str2int_long_digits) {
+  // Eight digits at a time when the length is known
+  CASE_EXPECT_EQ(1234567890123456789LL, atfw::util::string::to_int<int64_t>(std::string("1234567890123456789")));
+  CASE_EXPECT_EQ(-1234567890123456789LL, atfw::util::string::to_int<int64_t>(std::string("-1234567890123456789")));
+  CASE_EXPECT_EQ(12345678, atfw::util::string::to_int<int32_t>(std::string("12345678a9")));
+  CASE_EXPECT_EQ(1234567, atfw::util::string::to_int<int32_t>(std::string("1234567/89")));
+  CASE_EXPECT_EQ(1234567, atfw::util::string::to_int<int32_t>(std::string("1234567:89")));
+  CASE_EXPECT_EQ(18446744073709551615ULL,
+                 atfw::util::string::to_int<uint64_t>(std::string("18446744073709551615")));
+
+  std::string input = "12345678901234567890";
+  uint64_t prefix = 0;
+  const char *end = atfw::util::string::str2int(prefix, input.c_str(), 8);
+  CASE_EXPECT_EQ(input.c_str() + 8, end);
+  CASE_EXPECT_EQ(12345678, prefix);
+
+  std::mt19937_64 rnd(20261019);
+  for (int i = 0; i < 2000; ++i) {
+    uint64_t value = rnd() >> (rnd() % 64);
+    std::string text = std::to_string(value) + (0 == i % 2 ? "" : " tail");
+    CASE_EXPECT_EQ(value, atfw::util::string::to_int<uint64_t>(text));
+    CASE_EXPECT_EQ(value, atfw::util::string::to_int<uint64_t>(text.c_str()));
+    CASE_EXPECT_EQ(static_cast<uint32_t>(value), atfw::util::string::to_int<uint32_t>(text));
+  }
+}
+
+CASE_TEST(string_oprs, float_round_trip) {
+  char buffer[64];
+  CASE_EXPECT_EQ(3, atfw::util::string::float2str(buffer, sizeof(buffer), 0.1));
+  CASE_EXPECT_EQ("0.1", std::string(buffer));
+  CASE_EXPECT_EQ(1, atfw::util::string::float2str(buffer, sizeof(buffer), 0.0));
+  CASE_EXPECT_EQ("0", std::string(buffer));
+  CASE_EXPECT_EQ(0, atfw::util::string::float2str(buffer, 2, 0.125));
+
+  double d = 0;
+  CASE_EXPECT_EQ("", std::string(atfw::util::string::str2float(d, " +1.5e3")));
+  CASE_EXPECT_EQ(1500.0, d);
+  std::string with_tail = "-0.25,next";
+  CASE_EXPECT_EQ(',', *atfw::util::string::str2float(d, with_tail));
+  CASE_EXPECT_EQ(-0.25, d);
+  const char *not_number = "abc";
+  CASE_EXPECT_EQ(not_number, atfw::util::string::str2float(d, not_number));
+  CASE_EXPECT_EQ(0.0, d);
+
+  std::mt19937_64 rnd(20261019);
+  for (int i = 0; i < 5000; ++i) {
+    uint64_t bits = rnd();
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    if (value != value || value - value != 0) {
+      continue;
+    }
+
+    size_t len = atfw::util::string::float2str(buffer, sizeof(buffer), value);
+    CASE_EXPECT_GT(len, 0);
+    CASE_EXPECT_LE(len, 24);
+    double parsed = 0;
+    atfw::util::string::str2float(parsed, buffer, len);
+    CASE_EXPECT_EQ(0, memcmp(&value, &parsed, sizeof(value)));
+
+    float fvalue = static_cast<float>(value);
+    if (fvalue - fvalue != 0) {
+      continue;
+    }
+    len = atfw::util::string::float2str(buffer, sizeof(buffer), fvalue);
+    float fparsed = 0;
+    atfw::util::string::str2float(fparsed, buffer, len);
+    CASE_EXPECT_EQ(fvalue, fparsed);
+  }
+}
+
+#if defined(PROJECT_TEST_MACRO_ENABLE_BENCHMARK) && PROJECT_TEST_MACRO_ENABLE_BENCHMARK
+CASE_TEST(string_oprs, conversion_benchmark) {
+  std::mt19937_64 rnd(20261019);
+  std::vector<uint64_t> integers;
+  std::vector<std::string> integer_texts;
+  std::vector<double> floats;
+  std::vector<std::string> float_texts;
+  for (int i = 0; i < 4096; ++i) {
+    integers.push_back(rnd() >> (rnd() % 64));
+    integer_texts.push_back(std::to_string(integers.back()));
+    floats.push_back(static_cast<double>(rnd() % 100000000) / static_cast<double>(1 + rnd() % 10000));
+    char buffer[64];
+    UTIL_STRFUNC_SNPRINTF(buffer, sizeof(buffer), "%.17g", floats.back());
+    float_texts.push_back(buffer);
+  }
+
+  char buffer[64];
+  size_t checksum[3] = {0, 0, 0};
+  std::chrono::steady_clock::duration costs[3];
+
+  // integer to string
+  auto begin = std::chrono::steady_clock::now();
+  for (int loop = 0; loop < 16; ++loop) {
+    for (auto value : integers) {
+      checksum[0] += static_cast<size_t>(UTIL_STRFUNC_SNPRINTF(buffer, sizeof(buffer), "%llu",
+                                                               static_cast<unsigned long long>(value)));
+    }
+  }
+  costs[0] = std::chrono::steady_clock::now() - begin;
+  begin = std::chrono::steady_clock::now();
+  for (int loop = 0; loop < 16; ++loop) {
+    for (auto value : integers) {
+      checksum[1] += string_oprs_test_int2str_digit_by_digit(buffer, sizeof(buffer), value);
+    }
+  }
+  costs[1] = std::chrono::steady_clock::now() - begin;
+  begin = std::chrono::steady_clock::now();
+  for (int loop = 0; loop < 16; ++loop) {
+    for (auto value : integers) {
+      checksum[2] += atfw::util::string::int2str(buffer, sizeof(buffer), value);
+    }
+  }
+  costs[2] = std::chrono::steady_clock::now() - begin;
+  CASE_EXPECT_EQ(checksum[0], checksum[2]);
+  CASE_EXPECT_EQ(checksum[1], checksum[2]);
+  CASE_MSG_INFO() << "int2str 16 x 4096 integers, snprintf: "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(costs[0]).count()
+                  << "us, digit by digit: " << std::chrono::duration_cast<std::chrono::microseconds>(costs[1]).count()
+                  << "us, two digits table: "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(costs[2]).count() << "us" << '\n';
+
+  // string to integer
+  checksum[0] = checksum[1] = 0;
+  begin = std::chrono::steady_clock::now();
+  for (int loop = 0; loop < 16; ++loop) {
+    for (auto &text : integer_texts) {
+      checksum[0] += static_cast<size_t>(strtoull(text.c_str(), nullptr, 10));
+    }
+  }
+  costs[0] = std::chrono::steady_clock::now() - begin;
+  begin = std::chrono::steady_clock::now();
+  for (int loop = 0; loop < 16; ++loop) {
+    for (auto &text : integer_texts) {
+      checksum[1] += static_cast<size_t>(atfw::util::string::to_int<uint64_t>(text));
+    }
+  }
+  costs[1] = std::chrono::steady_clock::now() - begin;
+  CASE_EXPECT_EQ(checksum[0], checksum[1]);
+  CASE_MSG_INFO() << "str2int 16 x 4096 integers, strtoull: "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(costs[0]).count()
+                  << "us, eight digits SWAR: "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(costs[1]).count() << "us" << '\n';
+
+  // float to string
+  checksum[0] = checksum[1] = 0;
+  begin = std::chrono::steady_clock::now();
+  for (int loop = 0; loop < 16; ++loop) {
+    for (auto value : floats) {
+      checksum[0] += static_cast<size_t>(UTIL_STRFUNC_SNPRINTF(buffer, sizeof(buffer), "%.17g", value));
+    }
+  }
+  costs[0] = std::chrono::steady_clock::now() - begin;
+  begin = std::chrono::steady_clock::now();
+  for (int loop = 0; loop < 16; ++loop) {
+    for (auto value : floats) {
+      checksum[1] += atfw::util::string::float2str(buffer, sizeof(buffer), value);
+    }
+  }
+  costs[1] = std::chrono::steady_clock::now() - begin;
+  CASE_EXPECT_GE(checksum[0], checksum[1]);
+  CASE_MSG_INFO() << "float2str 16 x 4096 doubles, snprintf(%.17g): "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(costs[0]).count()
+                  << "us, shortest: " << std::chrono::duration_cast<std::chrono::microseconds>(costs[1]).count()
+                  << "us" << '\n';
+
+  // string to float
+  double sum[2] = {0, 0};
+  begin = std::chrono::steady_clock::now();
+  for (int loop = 0; loop < 16; ++loop) {
+    for (auto &text : float_texts) {
+      sum[0] += strtod(text.c_str(), nullptr);
+    }
+  }
+  costs[0] = std::chrono::steady_clock::now() - begin;
+  begin = std::chrono::steady_clock::now();
+  for (int loop = 0; loop < 16; ++loop) {
+    for (auto &text : float_texts) {
+      double value = 0;
+      atfw::util::string::str2float(value, text);
+      sum[1] += value;
+    }
+  }
+  costs[1] = std::chrono::steady_clock::now() - begin;
+  CASE_EXPECT_EQ(sum[0], sum[1]);
+  CASE_MSG_INFO() << "str2float 16 x 4096 doubles, strtod: "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(costs[0]).count()
+                  << "us, str2float: " << std::chrono::duration_cast<std::chrono::microseconds>(costs[1]).count()
+                  << "us" << '\n';
+}
+#endif
+
+namespace {
+// Per-character references, also used as the baseline of benchmark
+static size_t string_oprs_test_ifind_per_char(const std::string &haystack, const std::string &needle, size_t pos) {
+  for (size_t i = pos; i + needle.size() <= haystack.size(); ++i) {
+    size_t j = 0;
+    while (j < needle.size() &&
+           atfw::util::string::tolower(haystack[i + j]) == atfw::util::string::tolower(needle[j])) {
+      ++j;
+    }
+    if (j == needle.size()) {
+      return i;
+    }
+  }
+  return atfw::util::nostd::string_view::npos;
+}
+
+static std::vector<std::string> string_oprs_test_split_per_char(const std::string &input, const std::string &delimiters,
+                                                                bool skip_empty) {
+  std::vector<std::string> ret;
+  std::string token;
+  for (char c : input) {
+    if (std::string::npos == delimiters.find(c)) {
+      token.push_back(c);
+      continue;
+    }
+    if (!skip_empty || !token.empty()) {
+      ret.push_back(token);
+    }
+    token.clear();
+  }
+  if (!skip_empty || !token.empty()) {
+    ret.push_back(token);
+  }
+  return ret;
+}
+
+static std::string string_oprs_test_random_text(std::mt19937_64 &rnd, size_t length) {
+  static const char charset[] = "aAbBzZ@[`{ ,;\t\x80\xC1\xE1";
+  std::string ret;
+  ret.reserve(length);
+  for (size_t i = 0; i < length; ++i) {
+    ret.push_back(charset[rnd() % (sizeof(charset) - 1)]);
+  }
+  return ret;
+}
+}  // namespace
+
+CASE_TEST(string_oprs, ascii_case) {
+  std::string all_bytes;
+  for (int i = 0; i < 256; ++i) {
+    all_bytes.push_back(static_cast<char>(i));
+  }
+  all_bytes += all_bytes;
+
+  // Every length covers both the SIMD blocks and the scalar tail
+  for (size_t length = 0; length <= all_bytes.size(); ++length) {
+    std::string lower = all_bytes.substr(0, length);
+    std::string upper = lower;
+    atfw::util::string::ascii_tolower(lower);
+    atfw::util::string::ascii_toupper(upper);
+    for (size_t i = 0; i < length; ++i) {
+      CASE_EXPECT_EQ(static_cast<int>(atfw::util::string::tolower(all_bytes[i])), static_cast<int>(lower[i]));
+      CASE_EXPECT_EQ(static_cast<int>(atfw::util::string::toupper(all_bytes[i])), static_cast<int>(upper[i]));
+    }
+
+    CASE_EXPECT_TRUE(atfw::util::string::ascii_iequals(lower, upper));
+    if (length > 0) {
+      // A single different byte at any position breaks the equality
+      size_t index = length / 2;
+      upper[index] = '#' == lower[index] ? '$' : '#';
+      CASE_EXPECT_FALSE(atfw::util::string::ascii_iequals(lower, upper));
+    }
+  }
+
+  char out[64];
+  const char *mixed = "Content-Type: Application/JSON; Charset=UTF-8\xC3\x89";
+  atfw::util::string::ascii_tolower(out, mixed, strlen(mixed));
+  CASE_EXPECT_EQ("content-type: application/json; charset=utf-8\xC3\x89", std::string(out, strlen(mixed)));
+
+  CASE_EXPECT_TRUE(atfw::util::string::ascii_iequals("", ""));
+  CASE_EXPECT_TRUE(atfw::util::string::ascii_iequals("Keep-Alive", "keep-alive"));
+  CASE_EXPECT_FALSE(atfw::util::string::ascii_iequals("Keep-Alive", "keep-alive "));
+  CASE_EXPECT_FALSE(atfw::util::string::ascii_iequals("@[", "`{"));
+  CASE_EXPECT_FALSE(atfw::util::string::ascii_iequals("\xC3\x89", "\xE3\xA9"));
+}
+
+CASE_TEST(string_oprs, ascii_ifind) {
+  CASE_EXPECT_EQ(0, atfw::util::string::ascii_ifind("abc", ""));
+  CASE_EXPECT_EQ(2, atfw::util::string::ascii_ifind("abc", "", 2));
+  CASE_EXPECT_EQ(atfw::util::nostd::string_view::npos, atfw::util::string::ascii_ifind("abc", "", 4));
+  CASE_EXPECT_EQ(atfw::util::nostd::string_view::npos, atfw::util::string::ascii_ifind("ab", "abc"));
+  CASE_EXPECT_EQ(13, atfw::util::string::ascii_ifind("Accept: text/HTML, application/xhtml+xml", "html, APP"));
+  CASE_EXPECT_EQ(36, atfw::util::string::ascii_ifind("Accept: text/HTML, application/xhtml+xml", "+XML", 8));
+
+  std::mt19937_64 rnd(20261019);
+  for (int i = 0; i < 4096; ++i) {
+    std::string haystack = string_oprs_test_random_text(rnd, static_cast<size_t>(rnd() % 160));
+    std::string needle;
+    if (!haystack.empty() && 0 == (i & 1)) {
+      // Pick a substring and change the case of its letters
+      size_t begin = static_cast<size_t>(rnd() % haystack.size());
+      needle = haystack.substr(begin, static_cast<size_t>(rnd() % 48));
+      atfw::util::string::ascii_toupper(needle);
+    } else {
+      needle = string_oprs_test_random_text(rnd, 1 + static_cast<size_t>(rnd() % 4));
+    }
+    size_t pos = haystack.empty() ? 0 : static_cast<size_t>(rnd() % haystack.size());
+    CASE_EXPECT_EQ(string_oprs_test_ifind_per_char(haystack, needle, pos),
+                   atfw::util::string::ascii_ifind(haystack, needle, pos));
+  }
+}
+
+CASE_TEST(string_oprs, split) {
+  atfw::util::nostd::string_view tokens[8];
+  CASE_EXPECT_EQ(3, atfw::util::string::split(",a,,b; c,", ",; ", tokens));
+  CASE_EXPECT_EQ("a", tokens[0]);
+  CASE_EXPECT_EQ("b", tokens[1]);
+  CASE_EXPECT_EQ("c", tokens[2]);
+
+  CASE_EXPECT_EQ(6, atfw::util::string::split(",a,,b;c,", ",;", tokens, false));
+  CASE_EXPECT_EQ("", tokens[0]);
+  CASE_EXPECT_EQ("a", tokens[1]);
+  CASE_EXPECT_EQ("", tokens[2]);
+  CASE_EXPECT_EQ("b", tokens[3]);
+  CASE_EXPECT_EQ("c", tokens[4]);
+  CASE_EXPECT_EQ("", tokens[5]);
+
+  CASE_EXPECT_EQ(0, atfw::util::string::split("", ",", tokens));
+  CASE_EXPECT_EQ(1, atfw::util::string::split("", ",", tokens, false));
+  CASE_EXPECT_EQ(1, atfw::util::string::split("no delimiter", "", tokens));
+  CASE_EXPECT_EQ("no delimiter", tokens[0]);
+
+  // Returns the total count even if the output is too small
+  CASE_EXPECT_EQ(5, atfw::util::string::split("1 2 3 4 5", " ", gsl::span<atfw::util::nostd::string_view>(tokens, 2)));
+  CASE_EXPECT_EQ("1", tokens[0]);
+  CASE_EXPECT_EQ("2", tokens[1]);
+
+  // More than 16 delimiters use the lookup table only
+  std::string many_delimiters = "0123456789abcdefgh";
+  std::mt19937_64 rnd(20261019);
+  std::vector<atfw::util::nostd::string_view> output;
+  for (int i = 0; i < 2048; ++i) {
+    std::string input = string_oprs_test_random_text(rnd, static_cast<size_t>(rnd() % 200));
+    std::string delimiters = ",;\t";
+    if (i % 3 == 0) {
+      delimiters = many_delimiters;
+    } else if (i % 3 == 1) {
+      delimiters = " ";
+    }
+    bool skip_empty = 0 == (i & 1);
+    std::vector<std::string> expect = string_oprs_test_split_per_char(input, delimiters, skip_empty);
+
+    output.resize(input.size() + 1);
+    size_t count = atfw::util::string::split(input, delimiters, output, skip_empty);
+    CASE_EXPECT_EQ(expect.size(), count);
+    for (size_t j = 0; j < count && j < expect.size(); ++j) {
+      CASE_EXPECT_EQ(expect[j], output[j]);
+    }
+  }
+}
+
+#if defined(PROJECT_TEST_MACRO_ENABLE_BENCHMARK) && PROJECT_TEST_MACRO_ENABLE_BENCHMARK
+CASE_TEST(string_oprs, ascii_benchmark) {
+  std::mt19937_64 rnd(20261019);
+  std::vector<std::string> headers;
+  for (int i = 0; i < 1024; ++i) {
+    std::string header = "X-Request-Header-" + std::to_string(rnd() % 100000) + ": ";
+    header += string_oprs_test_random_text(rnd, 64 + static_cast<size_t>(rnd() % 192));
+    headers.push_back(header);
+  }
+  const std::string needle = "Z@A B;";
+
+  size_t checksum[2] = {0, 0};
+  std::chrono::steady_clock::duration costs[2];
+
+  // case folding
+  std::string buffer;
+  auto begin = std::chrono::steady_clock::now();
+  for (int loop = 0; loop < 16; ++loop) {
+    for (auto &header : headers) {
+      buffer = header;
+      std::transform(buffer.begin(), buffer.end(), buffer.begin(), atfw::util::string::tolower<char>);
+      checksum[0] += static_cast<unsigned char>(buffer[buffer.size() - 1]);
+    }
+  }
+  costs[0] = std::chrono::steady_clock::now() - begin;
+  begin = std::chrono::steady_clock::now();
+  for (int loop = 0; loop < 16; ++loop) {
+    for (auto &header : headers) {
+      buffer = header;
+      atfw::util::string::ascii_tolower(buffer);
+      checksum[1] += static_cast<unsigned char>(buffer[buffer.size() - 1]);
+    }
+  }
+  costs[1] = std::chrono::steady_clock::now() - begin;
+  CASE_EXPECT_EQ(checksum[0], checksum[1]);
+  CASE_MSG_INFO() << "tolower 16 x 1024 headers, per char: "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(costs[0]).count()
+                  << "us, ascii_tolower: " << std::chrono::duration_cast<std::chrono::microseconds>(costs[1]).count()
+                  << "us" << '\n';
+
+  // case-insensitive equals
+  std::vector<std::string> upper_headers = headers;
+  for (auto &header : upper_headers) {
+    atfw::util::string::ascii_toupper(header);
+  }
+  checksum[0] = checksum[1] = 0;
+  begin = std::chrono::steady_clock::now();
+  for (int loop = 0; loop < 16; ++loop) {
+    for (size_t i = 0; i < headers.size(); ++i) {
+      checksum[0] += (headers[i].size() == upper_headers[i].size() &&
+                      std::equal(headers[i].begin(), headers[i].end(), upper_headers[i].begin(),
+                                 [](char l, char r) {
+                                   return atfw::util::string::tolower(l) == atfw::util::string::tolower(r);
+                                 }))
+                         ? 1
+                         : 0;
+    }
+  }
+  costs[0] = std::chrono::steady_clock::now() - begin;
+  begin = std::chrono::steady_clock::now();
+  for (int loop = 0; loop < 16; ++loop) {
+    for (size_t i = 0; i < headers.size(); ++i) {
+      checksum[1] += atfw::util::string::ascii_iequals(headers[i], upper_headers[i]) ? 1 : 0;
+    }
+  }
+  costs[1] = std::chrono::steady_clock::now() - begin;
+  CASE_EXPECT_EQ(checksum[0], checksum[1]);
+  CASE_MSG_INFO() << "iequals 16 x 1024 headers, per char: "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(costs[0]).count()
+                  << "us, ascii_iequals: " << std::chrono::duration_cast<std::chrono::microseconds>(costs[1]).count()
+                  << "us" << '\n';
+
+  // case-insensitive find
+  checksum[0] = checksum[1] = 0;
+  begin = std::chrono::steady_clock::now();
+  for (int loop = 0; loop < 16; ++loop) {
+    for (auto &header : headers) {
+      checksum[0] += string_oprs_test_ifind_per_char(header, needle, 0);
+    }
+  }
+  costs[0] = std::chrono::steady_clock::now() - begin;
+  begin = std::chrono::steady_clock::now();
+  for (int loop = 0; loop < 16; ++loop) {
+    for (auto &header : headers) {
+      checksum[1] += atfw::util::string::ascii_ifind(header, needle);
+    }
+  }
+  costs[1] = std::chrono::steady_clock::now() - begin;
+  CASE_EXPECT_EQ(checksum[0], checksum[1]);
+  CASE_MSG_INFO() << "ifind 16 x 1024 headers, per char: "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(costs[0]).count()
+                  << "us, ascii_ifind: " << std::chrono::duration_cast<std::chrono::microseconds>(costs[1]).count()
+                  << "us" << '\n';
+
+  // split
+  checksum[0] = checksum[1] = 0;
+  begin = std::chrono::steady_clock::now();
+  for (int loop = 0; loop < 16; ++loop) {
+    for (auto &header : headers) {
+      checksum[0] += string_oprs_test_split_per_char(header, ",; ", true).size();
+    }
+  }
+  costs[0] = std::chrono::steady_clock::now() - begin;
+  atfw::util::nostd::string_view tokens[256];
+  begin = std::chrono::steady_clock::now();
+  for (int loop = 0; loop < 16; ++loop) {
+    for (auto &header : headers) {
+      checksum[1] += atfw::util::string::split(header, ",; ", tokens);
+    }
+  }
+  costs[1] = std::chrono::steady_clock::now() - begin;
+  CASE_EXPECT_EQ(checksum[0], checksum[1]);
+  CASE_MSG_INFO() << "split 16 x 1024 headers, per char: "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(costs[0]).count()
+                  << "us, split: " << std::chrono::duration_cast<std::chrono::microseconds>(costs[1]).count() << "us"
+                  << '\n';
+}
+#endif
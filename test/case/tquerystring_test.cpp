@@ -1,5 +1,8 @@
 // Copyright 2026 atframework
 
+#include <chrono>
+#include <cstring>
+#include <random>
 #include <string>
 #include <vector>
 
@@ -477,3 +480,388 @@ CASE_TEST(tquerystring, item_string_parse) {
   CASE_EXPECT_TRUE(str->parse(keys, 0, "parsed_value"));
   CASE_EXPECT_EQ("parsed_value", str->data());
 }
+
+// ======== Zero-allocation codec tests ========
+
+namespace {
+// Byte-by-byte reference implementation
+static std::string tquerystring_test_reference_encode(atfw::util::uri::uri_codec_t codec, const std::string &input) {
+  std::string safe_chars = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789-_.";
+  if (atfw::util::uri::uri_codec_t::kUri == codec || atfw::util::uri::uri_codec_t::kUriComponent == codec) {
+    safe_chars += "!~*'()";
+  }
+  if (atfw::util::uri::uri_codec_t::kUri == codec) {
+    safe_chars += ";/?:@&=+$,#";
+  }
+
+  const char *hex = "0123456789ABCDEF";
+  std::string ret;
+  for (char c : input) {
+    if (safe_chars.find(c) != std::string::npos) {
+      ret += c;
+    } else if (atfw::util::uri::uri_codec_t::kUrl == codec && ' ' == c) {
+      ret += '+';
+    } else {
+      ret += '%';
+      ret += hex[static_cast<unsigned char>(c) >> 4];
+      ret += hex[static_cast<unsigned char>(c) & 0x0F];
+    }
+  }
+  return ret;
+}
+
+static std::string tquerystring_test_random_bytes(std::mt19937 &rnd, size_t len, bool mostly_safe) {
+  std::string ret;
+  for (size_t i = 0; i < len; ++i) {
+    if (mostly_safe && 0 != rnd() % 24) {
+      ret += static_cast<char>('a' + rnd() % 26);
+    } else {
+      ret += static_cast<char>(rnd() % 256);
+    }
+  }
+  return ret;
+}
+}  // namespace
+
+CASE_TEST(tquerystring, codec_to_matches_reference) {
+  std::mt19937 rnd(20261019);
+  atfw::util::uri::uri_codec_t codecs[] = {
+      atfw::util::uri::uri_codec_t::kUri, atfw::util::uri::uri_codec_t::kUriComponent,
+      atfw::util::uri::uri_codec_t::kRawUrl, atfw::util::uri::uri_codec_t::kUrl};
+
+  for (int round = 0; round < 64; ++round) {
+    std::string input = tquerystring_test_random_bytes(rnd, rnd() % 100, 0 != (round & 1));
+    for (auto codec : codecs) {
+      std::string expect = tquerystring_test_reference_encode(codec, input);
+      CASE_EXPECT_EQ(expect.size(), atfw::util::uri::encoded_size(codec, input));
+
+      // Appender keeps the existing content
+      std::string appended = "prefix";
+      atfw::util::uri::encode_to(codec, appended, input);
+      CASE_EXPECT_EQ("prefix" + expect, appended);
+
+      std::string decoded;
+      atfw::util::uri::decode_to(codec, decoded, expect);
+      CASE_EXPECT_EQ(input, decoded);
+      CASE_EXPECT_EQ(input.size(), atfw::util::uri::decoded_size(codec, expect));
+    }
+
+    // Old API shares the implementation but must keep its results
+    CASE_EXPECT_EQ(tquerystring_test_reference_encode(atfw::util::uri::uri_codec_t::kUriComponent, input),
+                   atfw::util::uri::encode_uri_component(input.c_str(), input.size()));
+  }
+}
+
+CASE_TEST(tquerystring, codec_to_buffer) {
+  std::string input = "a b&c=d/\xE4\xB8\xAD";
+  size_t expect_size = atfw::util::uri::encoded_size(atfw::util::uri::uri_codec_t::kUrl, input);
+  CASE_EXPECT_EQ(strlen("a+b%26c%3Dd%2F%E4%B8%AD"), expect_size);
+
+  // Too small buffer: report the size and write nothing
+  char buffer[64];
+  memset(buffer, '#', sizeof(buffer));
+  CASE_EXPECT_EQ(expect_size, atfw::util::uri::encode_url_to(buffer, expect_size - 1, input));
+  CASE_EXPECT_EQ('#', buffer[0]);
+  CASE_EXPECT_EQ(expect_size, atfw::util::uri::encode_url_to(nullptr, 0, input));
+
+  CASE_EXPECT_EQ(expect_size, atfw::util::uri::encode_url_to(buffer, sizeof(buffer), input));
+  CASE_EXPECT_EQ("a+b%26c%3Dd%2F%E4%B8%AD", std::string(buffer, expect_size));
+
+  char decoded[64];
+  size_t decoded_size =
+      atfw::util::uri::decode_url_to(decoded, sizeof(decoded), atfw::util::nostd::string_view(buffer, expect_size));
+  CASE_EXPECT_EQ(input, std::string(decoded, decoded_size));
+
+  // Malformed escapes behave the same as decode_uri_component: invalid hex digits count as 0 and a % without two
+  // following bytes is kept
+  std::string malformed = "%41%4%%2";
+  std::string expect = atfw::util::uri::decode_uri_component(malformed.c_str(), malformed.size());
+  CASE_EXPECT_EQ("A@%2", expect);
+  CASE_EXPECT_EQ(expect.size(),
+                 atfw::util::uri::decoded_size(atfw::util::uri::uri_codec_t::kUriComponent, malformed));
+  std::string output;
+  atfw::util::uri::decode_uri_component_to(output, malformed);
+  CASE_EXPECT_EQ(expect, output);
+
+  // Only the form codec decodes + into space
+  output.clear();
+  atfw::util::uri::raw_decode_url_to(output, "a+b");
+  CASE_EXPECT_EQ("a+b", output);
+  output.clear();
+  atfw::util::uri::decode_url_to(output, "a+b");
+  CASE_EXPECT_EQ("a b", output);
+}
+
+CASE_TEST(tquerystring, query_string_tokenizer) {
+  std::string content = "a=1&b[c]=x%20y&&flag&d=e=f";
+  atfw::util::uri::query_string_tokenizer tokenizer(content);
+  atfw::util::uri::query_string_tokenizer::token_t token;
+
+  CASE_EXPECT_TRUE(tokenizer.next(token));
+  CASE_EXPECT_EQ("a", token.key);
+  CASE_EXPECT_EQ("1", token.value);
+  CASE_EXPECT_TRUE(token.has_value);
+  // Tokens point to the original content
+  CASE_EXPECT_EQ(content.data(), token.key.data());
+
+  CASE_EXPECT_TRUE(tokenizer.next(token));
+  CASE_EXPECT_EQ("b[c]", token.key);
+  CASE_EXPECT_EQ("x%20y", token.value);
+  std::string value;
+  atfw::util::uri::decode_uri_component_to(value, token.value);
+  CASE_EXPECT_EQ("x y", value);
+
+  CASE_EXPECT_TRUE(tokenizer.next(token));
+  CASE_EXPECT_TRUE(token.record.empty());
+
+  CASE_EXPECT_TRUE(tokenizer.next(token));
+  CASE_EXPECT_EQ("flag", token.key);
+  CASE_EXPECT_FALSE(token.has_value);
+
+  // The last = splits key and value, the same as tquerystring::decode
+  CASE_EXPECT_TRUE(tokenizer.next(token));
+  CASE_EXPECT_EQ("d=e", token.key);
+  CASE_EXPECT_EQ("f", token.value);
+
+  CASE_EXPECT_FALSE(tokenizer.next(token));
+  CASE_EXPECT_TRUE(tokenizer.get_remain().empty());
+}
+
+#if defined(PROJECT_TEST_MACRO_ENABLE_BENCHMARK) && PROJECT_TEST_MACRO_ENABLE_BENCHMARK
+CASE_TEST(tquerystring, codec_to_benchmark) {
+  std::mt19937 rnd(20261019);
+  std::vector<std::string> inputs;
+  for (int i = 0; i < 1024; ++i) {
+    inputs.push_back(tquerystring_test_random_bytes(rnd, 16 + rnd() % 240, true));
+  }
+
+  size_t reference_size = 0;
+  auto begin = std::chrono::steady_clock::now();
+  for (int loop = 0; loop < 16; ++loop) {
+    for (auto &input : inputs) {
+      reference_size += tquerystring_test_reference_encode(atfw::util::uri::uri_codec_t::kUriComponent, input).size();
+    }
+  }
+  auto reference_cost = std::chrono::steady_clock::now() - begin;
+
+  size_t to_size = 0;
+  std::string output;
+  begin = std::chrono::steady_clock::now();
+  for (int loop = 0; loop < 16; ++loop) {
+    for (auto &input : inputs) {
+      output.clear();
+      atfw::util::uri::encode_uri_component_to(output, input);
+      to_size += output.size();
+    }
+  }
+  auto to_cost = std::chrono::steady_clock::now() - begin;
+
+  CASE_EXPECT_EQ(reference_size, to_size);
+  CASE_MSG_INFO() << "encode_uri_component 16 x 1024 strings, byte by byte: "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(reference_cost).count()
+                  << "us, encode_uri_component_to: "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(to_cost).count() << "us" << '\n';
+}
+#endif
+
+// ======== tquerystring_arena tests ========
+
+namespace {
+// Compare an arena node with the shared_ptr DOM built by tquerystring
+static bool tquerystring_test_same_tree(const atfw::util::tquerystring_arena::node_t &node,
+                                        const atfw::util::types::item_impl &item) {
+  if (atfw::util::types::ITEM_TYPE_STRING == node.type) {
+    return atfw::util::types::ITEM_TYPE_STRING == item.type() && item.to_string() == std::string(node.value);
+  }
+
+  if (atfw::util::types::ITEM_TYPE_ARRAY == node.type) {
+    const atfw::util::types::item_array *array = dynamic_cast<const atfw::util::types::item_array *>(&item);
+    if (nullptr == array || array->size() != node.child_count) {
+      return false;
+    }
+    for (size_t i = 0; i < node.child_count; ++i) {
+      if (array->get_string(i) != std::string(node.at(i)->value)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  const atfw::util::types::item_object *object = dynamic_cast<const atfw::util::types::item_object *>(&item);
+  if (nullptr == object || object->size() != node.child_count) {
+    return false;
+  }
+  for (const atfw::util::tquerystring_arena::node_t *child = node.first_child; nullptr != child;
+       child = child->next_sibling) {
+    auto iter = object->data().find(std::string(child->key));
+    if (iter == object->data().end() || !tquerystring_test_same_tree(*child, *iter->second)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static std::string tquerystring_test_make_request(std::mt19937 &rnd) {
+  const char *names[] = {"user", "filter", "page", "sort", "session", "items", "profile", "tags"};
+  std::string ret;
+  for (int i = 0; i < 12; ++i) {
+    if (!ret.empty()) {
+      ret += '&';
+    }
+    switch (rnd() % 4) {
+      case 0:
+        ret += std::string(names[rnd() % 8]) + "[" + names[rnd() % 8] + "]=value" + std::to_string(rnd() % 1000);
+        break;
+      case 1:
+        ret += std::string("list_") + names[rnd() % 8] + "[]=item%20" + std::to_string(rnd() % 100);
+        break;
+      case 2:
+        ret += std::string("deep[") + names[rnd() % 8] + "][" + names[rnd() % 8] + "]=%E4%B8%AD%E6%96%87";
+        break;
+      default:
+        ret += std::string("data[") + names[rnd() % 8] + "]=" + std::to_string(rnd());
+        break;
+    }
+  }
+  return ret;
+}
+}  // namespace
+
+CASE_TEST(tquerystring, arena_decode) {
+  std::string content = "user[name]=hello%20world&user[age]=25&tags[list][]=a&tags[list][]=b&a[b][c]=deep&plain=1";
+  atfw::util::tquerystring_arena arena;
+  CASE_EXPECT_FALSE(arena.decode(content));  // The last record has no brackets, the same as tquerystring
+
+  const atfw::util::tquerystring_arena::node_t *user = arena.get("user");
+  CASE_EXPECT_TRUE(nullptr != user);
+  if (nullptr != user) {
+    CASE_EXPECT_EQ(atfw::util::types::ITEM_TYPE_OBJECT, user->type);
+    CASE_EXPECT_EQ("hello world", user->get("name")->value);
+    CASE_EXPECT_EQ("25", user->get("age")->value);
+    // Values which need no decoding point into the source
+    CASE_EXPECT_TRUE(user->get("age")->value.data() >= content.data() &&
+                     user->get("age")->value.data() < content.data() + content.size());
+  }
+
+  // Like tquerystring, a trailing [] is not accepted and the record is dropped
+  CASE_EXPECT_TRUE(nullptr == arena.get("tags"));
+  CASE_EXPECT_EQ("deep", arena.get("a")->get("b")->get("c")->value);
+  CASE_EXPECT_TRUE(nullptr == arena.get("plain"));
+  CASE_EXPECT_EQ(2, arena.size());
+
+  // Children keep the insertion order
+  const atfw::util::tquerystring_arena::node_t &root = arena.get_root();
+  CASE_EXPECT_EQ(arena.get("user"), root.at(0));
+  CASE_EXPECT_TRUE(nullptr == root.at(2));
+
+  // Large values use their own block, clear keeps one block for reuse
+  std::string large = "big[value]=" + std::string(10000, 'x');
+  CASE_EXPECT_TRUE(arena.decode(large));
+  CASE_EXPECT_EQ(10000, arena.get("big")->get("value")->value.size());
+  arena.clear();
+  CASE_EXPECT_TRUE(arena.empty());
+  CASE_EXPECT_EQ(static_cast<size_t>(atfw::util::tquerystring_arena::DEFAULT_BLOCK_SIZE), arena.get_allocated_size());
+}
+
+CASE_TEST(tquerystring, arena_same_as_tquerystring) {
+  std::mt19937 rnd(20261019);
+  atfw::util::tquerystring_arena arena(512);
+  for (int i = 0; i < 64; ++i) {
+    std::string content = tquerystring_test_make_request(rnd);
+    // Edge cases of key splitting
+    content += "&x[a]y[b]=1&x[a]y[b][]=2&]z[c]=3&q[]=1&q[]=2&q[0]=3";
+
+    atfw::util::tquerystring qs;
+    arena.clear();
+    CASE_EXPECT_EQ(qs.decode(content.c_str(), content.size()), arena.decode(content));
+    CASE_EXPECT_TRUE(tquerystring_test_same_tree(arena.get_root(), qs));
+  }
+}
+
+CASE_TEST(tquerystring, arena_child_index) {
+  // Enough children on the root and on one nested object to build and grow the hashed child index
+  std::string content;
+  for (int i = 0; i < 500; ++i) {
+    content += "k" + std::to_string(i) + "[v]=" + std::to_string(i) + "&obj[f" + std::to_string(i) +
+               "]=" + std::to_string(i) + "&";
+  }
+  // Existing children are found and updated instead of being appended again
+  content += "k7[v]=updated&obj[f7]=updated";
+
+  atfw::util::tquerystring qs;
+  atfw::util::tquerystring_arena arena;
+  for (int round = 0; round < 2; ++round) {
+    arena.clear();
+    CASE_EXPECT_TRUE(arena.decode(content));
+    CASE_EXPECT_EQ(501, arena.size());
+
+    const atfw::util::tquerystring_arena::node_t *obj = arena.get("obj");
+    CASE_EXPECT_TRUE(nullptr != obj);
+    if (nullptr == obj) {
+      continue;
+    }
+    CASE_EXPECT_EQ(500, obj->child_count);
+
+    size_t mismatch = 0;
+    for (int i = 0; i < 500; ++i) {
+      std::string expect = 7 == i ? "updated" : std::to_string(i);
+      const atfw::util::tquerystring_arena::node_t *key_node = arena.get("k" + std::to_string(i));
+      const atfw::util::tquerystring_arena::node_t *field_node = obj->get("f" + std::to_string(i));
+      if (nullptr == key_node || nullptr == key_node->get("v") || key_node->get("v")->value != expect ||
+          nullptr == field_node || field_node->value != expect) {
+        ++mismatch;
+      }
+    }
+    CASE_EXPECT_EQ(0, mismatch);
+    CASE_EXPECT_TRUE(nullptr == arena.get("k500"));
+    CASE_EXPECT_TRUE(nullptr == obj->get("f500"));
+
+    // Insertion order is kept
+    CASE_EXPECT_EQ(arena.get("k0"), arena.get_root().at(0));
+    CASE_EXPECT_EQ(obj->get("f499"), obj->at(499));
+  }
+
+  CASE_EXPECT_TRUE(qs.decode(content.c_str(), content.size()));
+  CASE_EXPECT_TRUE(tquerystring_test_same_tree(arena.get_root(), qs));
+}
+
+#if defined(PROJECT_TEST_MACRO_ENABLE_BENCHMARK) && PROJECT_TEST_MACRO_ENABLE_BENCHMARK
+CASE_TEST(tquerystring, arena_decode_benchmark) {
+  std::mt19937 rnd(20261019);
+  std::vector<std::string> requests;
+  size_t total_size = 0;
+  for (int i = 0; i < 1024; ++i) {
+    requests.push_back(tquerystring_test_make_request(rnd));
+    total_size += requests.back().size();
+  }
+
+  size_t dom_count = 0;
+  auto begin = std::chrono::steady_clock::now();
+  for (int loop = 0; loop < 8; ++loop) {
+    for (auto &request : requests) {
+      atfw::util::tquerystring qs;
+      qs.decode(request.c_str(), request.size());
+      dom_count += qs.size();
+    }
+  }
+  auto dom_cost = std::chrono::steady_clock::now() - begin;
+
+  size_t arena_count = 0;
+  atfw::util::tquerystring_arena arena;
+  begin = std::chrono::steady_clock::now();
+  for (int loop = 0; loop < 8; ++loop) {
+    for (auto &request : requests) {
+      arena.clear();
+      arena.decode(request);
+      arena_count += arena.size();
+    }
+  }
+  auto arena_cost = std::chrono::steady_clock::now() - begin;
+
+  CASE_EXPECT_EQ(dom_count, arena_count);
+  CASE_MSG_INFO() << "decode 8 x 1024 nested query strings (" << total_size << " bytes per round), tquerystring: "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(dom_cost).count()
+                  << "us, tquerystring_arena: "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(arena_cost).count() << "us" << '\n';
+}
+#endif
@@ -0,0 +1,283 @@
+// Copyright 2026 atframework
+
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "frame/test_macros.h"
+
+#include "string/utf8_char_t.h"
+#include "string/utf8_utils.h"
+
+namespace {
+// Straightforward decoder used as the reference, returns the invalid position or input.size()
+static size_t utf8_utils_test_reference_find_invalid(const std::string &input) {
+  size_t i = 0;
+  while (i < input.size()) {
+    uint32_t c = static_cast<unsigned char>(input[i]);
+    size_t len;
+    uint32_t min_value;
+    if (c < 0x80) {
+      ++i;
+      continue;
+    } else if ((c & 0xE0) == 0xC0) {
+      len = 2;
+      min_value = 0x80;
+      c &= 0x1F;
+    } else if ((c & 0xF0) == 0xE0) {
+      len = 3;
+      min_value = 0x800;
+      c &= 0x0F;
+    } else if ((c & 0xF8) == 0xF0) {
+      len = 4;
+      min_value = 0x10000;
+      c &= 0x07;
+    } else {
+      return i;
+    }
+
+    if (i + len > input.size()) {
+      return i;
+    }
+    for (size_t j = 1; j < len; ++j) {
+      unsigned char next = static_cast<unsigned char>(input[i + j]);
+      if ((next & 0xC0) != 0x80) {
+        return i;
+      }
+      c = (c << 6) | (next & 0x3F);
+    }
+    if (c < min_value || c > 0x10FFFF || (c >= 0xD800 && c < 0xE000)) {
+      return i;
+    }
+    i += len;
+  }
+  return input.size();
+}
+
+static void utf8_utils_test_append(std::string &output, uint32_t c) {
+  if (c < 0x80) {
+    output.push_back(static_cast<char>(c));
+  } else if (c < 0x800) {
+    output.push_back(static_cast<char>(0xC0 | (c >> 6)));
+    output.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+  } else if (c < 0x10000) {
+    output.push_back(static_cast<char>(0xE0 | (c >> 12)));
+    output.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+    output.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+  } else {
+    output.push_back(static_cast<char>(0xF0 | (c >> 18)));
+    output.push_back(static_cast<char>(0x80 | ((c >> 12) & 0x3F)));
+    output.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+    output.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+  }
+}
+
+static uint32_t utf8_utils_test_random_code_point(std::mt19937 &rnd) {
+  switch (rnd() % 6) {
+    case 0:
+    case 1:
+      return rnd() % 0x80;
+    case 2:
+      return 0x80 + rnd() % (0x800 - 0x80);
+    case 3: {
+      uint32_t c = 0x800 + rnd() % (0x10000 - 0x800);
+      return (c >= 0xD800 && c < 0xE000) ? 0x4E2D : c;
+    }
+    case 4:
+      return 0x4E00 + rnd() % 0x5000;
+    default:
+      return 0x10000 + rnd() % (0x110000 - 0x10000);
+  }
+}
+
+static std::string utf8_utils_test_random_string(std::mt19937 &rnd, size_t code_points, std::u32string *utf32) {
+  std::string ret;
+  for (size_t i = 0; i < code_points; ++i) {
+    uint32_t c = utf8_utils_test_random_code_point(rnd);
+    utf8_utils_test_append(ret, c);
+    if (nullptr != utf32) {
+      utf32->push_back(static_cast<char32_t>(c));
+    }
+  }
+  return ret;
+}
+}  // namespace
+
+CASE_TEST(utf8_utils, validate) {
+  CASE_EXPECT_TRUE(atfw::util::string::utf8_validate(""));
+  CASE_EXPECT_TRUE(atfw::util::string::utf8_validate("hello"));
+  CASE_EXPECT_TRUE(atfw::util::string::utf8_validate("\xE6\xAC\xA7o\xF0\x9F\x98\x80"));
+
+  // overlong, surrogate, too large, truncated and stray continuation
+  const char *invalid_cases[] = {"\xC0\xAF", "\xC1\xBF",     "\xE0\x80\xAF", "\xED\xA0\x80", "\xF0\x80\x80\xAF",
+                                 "\xF4\x90\x80\x80", "\xF5\x80\x80\x80", "\xFF", "\x80", "\xE6\xAC", "\xF0\x9F\x98",
+                                 "a\xBF", "\xC3\xA9\xA9"};
+  for (auto &invalid_case : invalid_cases) {
+    std::string input = invalid_case;
+    CASE_EXPECT_FALSE(atfw::util::string::utf8_validate(input));
+    CASE_EXPECT_EQ(utf8_utils_test_reference_find_invalid(input), atfw::util::string::utf8_find_invalid(input));
+
+    // Put the error at every position around the 16/32 bytes block boundary
+    for (size_t prefix = 1; prefix < 70; ++prefix) {
+      std::string padded = std::string(prefix, 'x') + input + std::string(prefix % 7, 'y');
+      CASE_EXPECT_FALSE(atfw::util::string::utf8_validate(padded));
+      CASE_EXPECT_EQ(prefix + utf8_utils_test_reference_find_invalid(input),
+                     atfw::util::string::utf8_find_invalid(padded));
+    }
+  }
+
+  // Valid multibyte characters crossing block boundaries
+  for (size_t prefix = 0; prefix < 70; ++prefix) {
+    std::string input = std::string(prefix, 'x') + "\xF0\x9F\x98\x80\xE6\xAC\xA7\xC3\xA9";
+    CASE_EXPECT_TRUE(atfw::util::string::utf8_validate(input));
+    CASE_EXPECT_EQ(input.size(), atfw::util::string::utf8_find_invalid(input));
+  }
+}
+
+CASE_TEST(utf8_utils, validate_random) {
+  std::mt19937 rnd(20261019);
+  size_t invalid_count = 0;
+  for (int i = 0; i < 4000; ++i) {
+    std::string input = utf8_utils_test_random_string(rnd, rnd() % 96, nullptr);
+    // Mutate some bytes to produce all kinds of invalid sequences
+    if (!input.empty() && 0 != rnd() % 3) {
+      size_t mutate_count = 1 + rnd() % 3;
+      for (size_t j = 0; j < mutate_count; ++j) {
+        input[rnd() % input.size()] = static_cast<char>(rnd() % 256);
+      }
+    }
+
+    size_t expect = utf8_utils_test_reference_find_invalid(input);
+    if (expect != input.size()) {
+      ++invalid_count;
+    }
+    CASE_EXPECT_EQ(expect == input.size(), atfw::util::string::utf8_validate(input));
+    CASE_EXPECT_EQ(expect, atfw::util::string::utf8_find_invalid(input));
+  }
+  CASE_EXPECT_GT(invalid_count, 0);
+}
+
+CASE_TEST(utf8_utils, count_and_truncate) {
+  CASE_EXPECT_EQ(0, atfw::util::string::utf8_count(""));
+  CASE_EXPECT_EQ(3, atfw::util::string::utf8_count("\xE6\xAC\xA7o\xF0\x9F\x98\x80"));
+
+  std::string input = "\xE6\xAC\xA7o\xF0\x9F\x98\x80";
+  CASE_EXPECT_EQ(0, atfw::util::string::utf8_truncate_position(input, 0));
+  CASE_EXPECT_EQ(3, atfw::util::string::utf8_truncate_position(input, 1));
+  CASE_EXPECT_EQ(4, atfw::util::string::utf8_truncate_position(input, 2));
+  CASE_EXPECT_EQ(8, atfw::util::string::utf8_truncate_position(input, 3));
+  CASE_EXPECT_EQ(8, atfw::util::string::utf8_truncate_position(input, 100));
+  CASE_EXPECT_EQ("\xE6\xAC\xA7o", atfw::util::string::utf8_truncate(input, 2));
+
+  std::mt19937 rnd(20261019);
+  for (int i = 0; i < 500; ++i) {
+    std::u32string code_points;
+    std::string text = utf8_utils_test_random_string(rnd, rnd() % 200, &code_points);
+    CASE_EXPECT_EQ(code_points.size(), atfw::util::string::utf8_count(text));
+    CASE_EXPECT_EQ(atfw::util::string::utf8_char_t::utf8_string_length(text), atfw::util::string::utf8_count(text));
+
+    size_t max_code_points = rnd() % 220;
+    std::string expect;
+    for (size_t j = 0; j < max_code_points && j < code_points.size(); ++j) {
+      utf8_utils_test_append(expect, static_cast<uint32_t>(code_points[j]));
+    }
+    CASE_EXPECT_EQ(expect.size(), atfw::util::string::utf8_truncate_position(text, max_code_points));
+  }
+}
+
+CASE_TEST(utf8_utils, transcode) {
+  std::u16string utf16;
+  CASE_EXPECT_TRUE(atfw::util::string::utf8_to_utf16("\xE6\xAC\xA7o\xF0\x9F\x98\x80", utf16));
+  CASE_EXPECT_TRUE(std::u16string(u"欧o\U0001F600") == utf16);
+  CASE_EXPECT_FALSE(atfw::util::string::utf8_to_utf16("o\xED\xA0\x80", utf16));
+  CASE_EXPECT_EQ(4, utf16.size());
+
+  std::string utf8;
+  CASE_EXPECT_TRUE(atfw::util::string::utf16_to_utf8(utf16, utf8));
+  CASE_EXPECT_EQ("\xE6\xAC\xA7o\xF0\x9F\x98\x80", utf8);
+
+  // Unpaired surrogates
+  char16_t unpaired[] = {u'a', static_cast<char16_t>(0xD800), u'b'};
+  atfw::util::nostd::basic_string_view<char16_t> unpaired_view(unpaired, 3);
+  CASE_EXPECT_FALSE(atfw::util::string::utf16_to_utf8(unpaired_view, utf8));
+  CASE_EXPECT_EQ(atfw::util::string::UTF_INVALID_LENGTH, atfw::util::string::utf16_to_utf8(unpaired_view, nullptr, 0));
+  char32_t too_large[] = {U'a', static_cast<char32_t>(0x110000)};
+  atfw::util::nostd::basic_string_view<char32_t> too_large_view(too_large, 2);
+  CASE_EXPECT_EQ(atfw::util::string::UTF_INVALID_LENGTH, atfw::util::string::utf32_to_utf8(too_large_view, nullptr, 0));
+
+  // Buffer too small: return the required size and write nothing
+  char16_t buffer[4] = {u'x', u'x', u'x', u'x'};
+  CASE_EXPECT_EQ(4, atfw::util::string::utf8_to_utf16("\xE6\xAC\xA7o\xF0\x9F\x98\x80", buffer, 3));
+  CASE_EXPECT_EQ(static_cast<uint32_t>(u'x'), static_cast<uint32_t>(buffer[0]));
+  CASE_EXPECT_EQ(4, atfw::util::string::utf8_to_utf16("\xE6\xAC\xA7o\xF0\x9F\x98\x80", buffer, 4));
+  CASE_EXPECT_EQ(0xD83D, static_cast<uint32_t>(buffer[2]));
+
+  std::mt19937 rnd(20261019);
+  for (int i = 0; i < 500; ++i) {
+    std::u32string code_points;
+    std::string text = utf8_utils_test_random_string(rnd, rnd() % 200, &code_points);
+
+    std::u32string utf32;
+    CASE_EXPECT_TRUE(atfw::util::string::utf8_to_utf32(text, utf32));
+    CASE_EXPECT_TRUE(code_points == utf32);
+
+    utf16.clear();
+    CASE_EXPECT_TRUE(atfw::util::string::utf8_to_utf16(text, utf16));
+    CASE_EXPECT_EQ(utf16.size(), atfw::util::string::utf16_length_from_utf8(text));
+    CASE_EXPECT_EQ(text.size(), atfw::util::string::utf8_length_from_utf16(utf16));
+    CASE_EXPECT_EQ(text.size(), atfw::util::string::utf8_length_from_utf32(utf32));
+
+    std::string back;
+    CASE_EXPECT_TRUE(atfw::util::string::utf16_to_utf8(utf16, back));
+    CASE_EXPECT_EQ(text, back);
+
+    back.clear();
+    CASE_EXPECT_TRUE(atfw::util::string::utf32_to_utf8(utf32, back));
+    CASE_EXPECT_EQ(text, back);
+  }
+}
+
+#if defined(PROJECT_TEST_MACRO_ENABLE_BENCHMARK) && PROJECT_TEST_MACRO_ENABLE_BENCHMARK
+CASE_TEST(utf8_utils, benchmark) {
+  std::mt19937 rnd(20261019);
+  std::vector<std::string> names;
+  for (int i = 0; i < 4096; ++i) {
+    names.push_back(utf8_utils_test_random_string(rnd, 8 + rnd() % 120, nullptr));
+  }
+
+  size_t reference_count = 0;
+  size_t reference_valid = 0;
+  auto begin = std::chrono::steady_clock::now();
+  for (int loop = 0; loop < 16; ++loop) {
+    for (auto &name : names) {
+      if (utf8_utils_test_reference_find_invalid(name) == name.size()) {
+        ++reference_valid;
+      }
+      reference_count += atfw::util::string::utf8_char_t::utf8_string_length(name);
+    }
+  }
+  auto reference_cost = std::chrono::steady_clock::now() - begin;
+
+  size_t bulk_count = 0;
+  size_t bulk_valid = 0;
+  begin = std::chrono::steady_clock::now();
+  for (int loop = 0; loop < 16; ++loop) {
+    for (auto &name : names) {
+      if (atfw::util::string::utf8_validate(name)) {
+        ++bulk_valid;
+      }
+      bulk_count += atfw::util::string::utf8_count(name);
+    }
+  }
+  auto bulk_cost = std::chrono::steady_clock::now() - begin;
+
+  CASE_EXPECT_EQ(reference_valid, bulk_valid);
+  CASE_EXPECT_EQ(reference_count, bulk_count);
+  CASE_MSG_INFO() << "validate + count 16 x 4096 strings, code point by code point: "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(reference_cost).count()
+                  << "us, bulk: " << std::chrono::duration_cast<std::chrono::microseconds>(bulk_cost).count() << "us"
+                  << '\n';
+}
+#endif
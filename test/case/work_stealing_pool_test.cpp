@@ -0,0 +1,183 @@
+// Copyright 2026 atframework
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "frame/test_macros.h"
+
+#include "thread/work_stealing_pool.h"
+
+CASE_TEST(work_stealing_pool, task_function) {
+  int counter = 0;
+  atfw::util::thread::task_function empty_fn;
+  CASE_EXPECT_FALSE(!!empty_fn);
+
+  // Small callable is stored inline
+  atfw::util::thread::task_function small_fn = [&counter]() { ++counter; };
+  CASE_EXPECT_TRUE(!!small_fn);
+  small_fn();
+  CASE_EXPECT_EQ(1, counter);
+
+  // Large callable falls back to heap, move-only capture is allowed
+  char padding[atfw::util::thread::task_function::INLINE_SIZE * 2] = {1};
+  std::unique_ptr<int> move_only(new int(10));
+  atfw::util::thread::task_function large_fn = [&counter, padding, move_only = std::move(move_only)]() {
+    counter += *move_only + padding[0];
+  };
+
+  atfw::util::thread::task_function moved_fn = std::move(large_fn);
+  CASE_EXPECT_FALSE(!!large_fn);
+  moved_fn();
+  CASE_EXPECT_EQ(12, counter);
+
+  small_fn = std::move(moved_fn);
+  small_fn();
+  CASE_EXPECT_EQ(23, counter);
+  small_fn.reset();
+  CASE_EXPECT_FALSE(!!small_fn);
+}
+
+CASE_TEST(work_stealing_pool, post_and_wait) {
+  atfw::util::thread::work_stealing_pool pool(4);
+  CASE_EXPECT_EQ(4, pool.get_worker_count());
+  CASE_EXPECT_TRUE(nullptr == atfw::util::thread::work_stealing_pool::get_current_pool());
+  CASE_EXPECT_EQ(-1, atfw::util::thread::work_stealing_pool::get_current_worker_index());
+
+  std::atomic<size_t> counter{0};
+  std::atomic<size_t> in_worker{0};
+  for (int i = 0; i < 10000; ++i) {
+    CASE_EXPECT_TRUE(pool.post([&counter, &in_worker, &pool]() {
+      ++counter;
+      if (atfw::util::thread::work_stealing_pool::get_current_pool() == &pool &&
+          atfw::util::thread::work_stealing_pool::get_current_worker_index() >= 0) {
+        ++in_worker;
+      }
+    }));
+  }
+
+  pool.wait_idle();
+  CASE_EXPECT_EQ(10000, counter.load());
+  CASE_EXPECT_EQ(10000, in_worker.load());
+  CASE_EXPECT_EQ(0, pool.get_pending_count());
+  CASE_EXPECT_EQ(10000, pool.get_stats().executed_count);
+}
+
+namespace {
+static void work_stealing_pool_test_fork(atfw::util::thread::work_stealing_pool& pool, std::atomic<size_t>& leaves,
+                                         int depth) {
+  if (depth <= 0) {
+    ++leaves;
+    return;
+  }
+
+  // Subtasks go to the local deque of current worker and can be stolen by others
+  pool.post([&pool, &leaves, depth]() { work_stealing_pool_test_fork(pool, leaves, depth - 1); });
+  pool.post([&pool, &leaves, depth]() { work_stealing_pool_test_fork(pool, leaves, depth - 1); });
+}
+}  // namespace
+
+CASE_TEST(work_stealing_pool, fork_tasks) {
+  atfw::util::thread::work_stealing_pool pool(4);
+  std::atomic<size_t> leaves{0};
+
+  pool.post([&pool, &leaves]() { work_stealing_pool_test_fork(pool, leaves, 14); });
+  pool.wait_idle();
+  CASE_EXPECT_EQ(static_cast<size_t>(1) << 14, leaves.load());
+
+  atfw::util::thread::work_stealing_pool_stats stats = pool.get_stats();
+  CASE_MSG_INFO() << "work_stealing_pool executed: " << stats.executed_count << ", stolen: " << stats.stolen_count
+                  << ", parked: " << stats.parked_count << '\n';
+  CASE_EXPECT_EQ((static_cast<uint64_t>(1) << 15) - 1, stats.executed_count);
+}
+
+CASE_TEST(work_stealing_pool, parallel_for) {
+  atfw::util::thread::work_stealing_pool pool(4);
+  CASE_EXPECT_EQ(1, pool.get_parallel_slot_count(1));
+  CASE_EXPECT_EQ(3, pool.get_parallel_slot_count(3));
+  CASE_EXPECT_EQ(5, pool.get_parallel_slot_count(1000));
+
+  // Every index runs exactly once and each slot is only used by one thread
+  const size_t count = 1000;
+  size_t slot_count = pool.get_parallel_slot_count(count);
+  std::vector<std::atomic<int>> visited(count);
+  std::vector<std::atomic<int>> slot_busy(slot_count);
+  std::vector<size_t> slot_counter(slot_count, 0);
+  std::atomic<size_t> slot_conflict{0};
+  auto fn = [&](size_t slot, size_t index) {
+    if (slot >= slot_count || index >= count) {
+      ++slot_conflict;
+      return;
+    }
+    if (0 != slot_busy[slot].fetch_add(1)) {
+      ++slot_conflict;
+    }
+    ++visited[index];
+    ++slot_counter[slot];
+    slot_busy[slot].fetch_sub(1);
+  };
+  pool.parallel_for(count, fn);
+
+  size_t total = 0;
+  for (size_t i = 0; i < count; ++i) {
+    CASE_EXPECT_EQ(1, visited[i].load());
+  }
+  for (size_t i = 0; i < slot_count; ++i) {
+    total += slot_counter[i];
+  }
+  CASE_EXPECT_EQ(count, total);
+  CASE_EXPECT_EQ(0, slot_conflict.load());
+
+  // The calling worker takes part, so it can be called from a task of the same pool
+  std::atomic<size_t> nested_sum{0};
+  pool.post([&pool, &nested_sum]() {
+    pool.parallel_for(100, [&nested_sum](size_t, size_t index) { nested_sum += index; });
+  });
+  pool.wait_idle();
+  CASE_EXPECT_EQ(4950, nested_sum.load());
+
+  // Runs on the calling thread after the pool stopped
+  pool.stop();
+  size_t serial_sum = 0;
+  pool.parallel_for(100, [&serial_sum](size_t slot, size_t index) { serial_sum += slot + index; });
+  CASE_EXPECT_EQ(4950, serial_sum);
+}
+
+CASE_TEST(work_stealing_pool, delayed_task) {
+  atfw::util::thread::work_stealing_pool pool(2);
+  std::atomic<int> counter{0};
+
+  CASE_EXPECT_EQ(0, pool.init_timer(100));
+  CASE_EXPECT_EQ(0, pool.post_delayed(3, [&counter]() { counter += 1; }));
+  CASE_EXPECT_EQ(0, pool.post_delayed(10, [&counter]() { counter += 10; }));
+
+  CASE_EXPECT_EQ(0, pool.tick(102));
+  pool.wait_idle();
+  CASE_EXPECT_EQ(0, counter.load());
+
+  CASE_EXPECT_EQ(1, pool.tick(103));
+  pool.wait_idle();
+  CASE_EXPECT_EQ(1, counter.load());
+
+  CASE_EXPECT_EQ(1, pool.tick(200));
+  pool.wait_idle();
+  CASE_EXPECT_EQ(11, counter.load());
+}
+
+CASE_TEST(work_stealing_pool, stop) {
+  std::atomic<size_t> counter{0};
+  {
+    atfw::util::thread::work_stealing_pool pool(2);
+    for (int i = 0; i < 1000; ++i) {
+      pool.post([&counter]() { ++counter; });
+    }
+
+    // Pending tasks are drained before stop returns
+    pool.stop();
+    CASE_EXPECT_TRUE(pool.is_stopping());
+    CASE_EXPECT_EQ(1000, counter.load());
+    CASE_EXPECT_FALSE(pool.post([&counter]() { ++counter; }));
+  }
+  CASE_EXPECT_EQ(1000, counter.load());
+}
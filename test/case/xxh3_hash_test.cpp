@@ -0,0 +1,239 @@
+// Copyright 2026 atframework
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "frame/test_macros.h"
+
+#include "algorithm/hash.h"
+#include "algorithm/murmur_hash.h"
+#include "algorithm/xxh3_hash.h"
+
+namespace {
+struct xxh3_hash_test_vector {
+  size_t len;
+  uint64_t hash64;
+  uint64_t hash64_seed;
+  uint64_t hash128_seed_low;
+  uint64_t hash128_seed_high;
+};
+
+// Generated by the reference implementation of xxHash v0.8.2, seed = 0x9E3779B97F4A7C15
+static const xxh3_hash_test_vector kXxh3HashTestVectors[] = {
+    {0, 0x2d06800538d394c2ULL, 0x602b0e2cd6662c8bULL, 0x4ca5176998171787ULL, 0xd142977a2cca554bULL},
+    {1, 0xe5e62017e96f839cULL, 0x65a8b0cec13e3805ULL, 0x65a8b0cec13e3805ULL, 0x21dfe48ecc9598c1ULL},
+    {3, 0xd3bcc83c6f14e70fULL, 0xc7f43f94e211daa8ULL, 0xc7f43f94e211daa8ULL, 0xbebfc505d163e93fULL},
+    {4, 0xc7f159f34b126cb4ULL, 0x5918648bb4ab248dULL, 0x94c3bc33a4798858ULL, 0x194735e586c7694aULL},
+    {8, 0x0f25a2a1cc43dda2ULL, 0xb12f1868c1b6fd51ULL, 0x8e9b9a5fe7c251b6ULL, 0x82c3a5dbece92349ULL},
+    {9, 0x1e3be9699baa50cfULL, 0x3a486e2f2acb9e92ULL, 0x3a561d33c9b4c990ULL, 0x6c82110a4a1b88b1ULL},
+    {16, 0x9ec324145cea1dcbULL, 0x036dd9b27415d197ULL, 0x8b89fe5b69448d7dULL, 0x799c7ac59d9ac16aULL},
+    {17, 0x48f3651d7436310aULL, 0x3a0a764841f125cfULL, 0xc42ecb4f29193160ULL, 0xe656eec12683d638ULL},
+    {128, 0x5d813d42c0005ea8ULL, 0x6e97f6e483277db3ULL, 0xa5a42c7589eb0cf1ULL, 0xb9a18e56a4474095ULL},
+    {129, 0xc61639b552225575ULL, 0xbead343d833a63b0ULL, 0xd115f1c7f3b62ad7ULL, 0x2d6e053c98712d90ULL},
+    {240, 0x7d85b8d4f8b10c82ULL, 0x47c3a135d10df2eaULL, 0xde64efe1c6018840ULL, 0x3f215a8093ffb90dULL},
+    {241, 0x5c56141c894cd97eULL, 0xfaaea887697730edULL, 0xfaaea887697730edULL, 0x95e5e791e8c25a5eULL},
+    {1024, 0x0551dea22e104ea8ULL, 0x722455d8b6426701ULL, 0x722455d8b6426701ULL, 0x2ecb2c907976ded8ULL},
+    {4096, 0x869423345af97371ULL, 0x3e8802a073054cfbULL, 0x3e8802a073054cfbULL, 0xea860631210daf0bULL},
+};
+
+static const uint64_t kXxh3HashTestSeed = 0x9E3779B97F4A7C15ULL;
+
+static std::vector<unsigned char> xxh3_hash_test_data(size_t len) {
+  std::vector<unsigned char> ret;
+  ret.resize(len);
+  uint32_t seed = 1;
+  for (size_t i = 0; i < len; ++i) {
+    seed = seed * 1103515245 + 12345;
+    ret[i] = static_cast<unsigned char>(seed >> 16);
+  }
+  return ret;
+}
+
+#if defined(PROJECT_TEST_MACRO_ENABLE_BENCHMARK) && PROJECT_TEST_MACRO_ENABLE_BENCHMARK
+static int64_t xxh3_hash_test_elapsed_usec(std::chrono::steady_clock::time_point begin) {
+  return static_cast<int64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count());
+}
+#endif
+}  // namespace
+
+CASE_TEST(xxh3_hash, known_answer) {
+  std::vector<unsigned char> data = xxh3_hash_test_data(4096);
+  for (const xxh3_hash_test_vector &vec : kXxh3HashTestVectors) {
+    CASE_EXPECT_EQ(vec.hash64, atfw::util::hash::xxh3_64(data.data(), vec.len));
+    CASE_EXPECT_EQ(vec.hash64_seed, atfw::util::hash::xxh3_64(data.data(), vec.len, kXxh3HashTestSeed));
+
+    atfw::util::hash::xxh3_hash128_t h128 = atfw::util::hash::xxh3_128(data.data(), vec.len, kXxh3HashTestSeed);
+    CASE_EXPECT_EQ(vec.hash128_seed_low, h128.low64);
+    CASE_EXPECT_EQ(vec.hash128_seed_high, h128.high64);
+  }
+
+  CASE_EXPECT_EQ(0x78af5f94892f3950ULL, atfw::util::hash::xxh3_64("abc", 3));
+}
+
+CASE_TEST(xxh3_hash, streaming) {
+  std::vector<unsigned char> data = xxh3_hash_test_data(4096);
+  bool all_match = true;
+  for (size_t len = 0; len <= data.size(); len += (len < 600 ? 1 : 97)) {
+    uint64_t expect64 = atfw::util::hash::xxh3_64(data.data(), len, kXxh3HashTestSeed);
+    atfw::util::hash::xxh3_hash128_t expect128 = atfw::util::hash::xxh3_128(data.data(), len, kXxh3HashTestSeed);
+
+    for (size_t chunk : {size_t(1), size_t(13), size_t(64), size_t(255), size_t(256), size_t(1000)}) {
+      atfw::util::hash::xxh3_state state(kXxh3HashTestSeed);
+      for (size_t i = 0; i < len; i += chunk) {
+        state.update(data.data() + i, len - i < chunk ? len - i : chunk);
+      }
+      if (state.digest64() != expect64 || state.digest128() != expect128) {
+        all_match = false;
+      }
+    }
+  }
+  CASE_EXPECT_TRUE(all_match);
+
+  // digest does not change the state
+  atfw::util::hash::xxh3_state state;
+  state.update(data.data(), 1000);
+  CASE_EXPECT_EQ(atfw::util::hash::xxh3_64(data.data(), 1000), state.digest64());
+  state.update(data.data() + 1000, 1000);
+  CASE_EXPECT_EQ(atfw::util::hash::xxh3_64(data.data(), 2000), state.digest64());
+  CASE_EXPECT_EQ(2000, state.get_total_length());
+
+  state.reset(7);
+  CASE_EXPECT_EQ(atfw::util::hash::xxh3_64(nullptr, 0, 7), state.digest64());
+}
+
+CASE_TEST(xxh3_hash, hasher) {
+  std::unordered_map<std::string, int, atfw::util::hash::xxh3_hasher<std::string>> string_map;
+  std::unordered_set<uint64_t, atfw::util::hash::xxh3_hasher<uint64_t>> int_set;
+  for (int i = 0; i < 1000; ++i) {
+    string_map["key_" + std::to_string(i)] = i;
+    int_set.insert(static_cast<uint64_t>(i) << 32);
+  }
+  CASE_EXPECT_EQ(1000, string_map.size());
+  CASE_EXPECT_EQ(1000, int_set.size());
+  CASE_EXPECT_EQ(123, string_map["key_123"]);
+  CASE_EXPECT_TRUE(int_set.end() != int_set.find(static_cast<uint64_t>(999) << 32));
+
+  std::string key = "hello world";
+  atfw::util::nostd::string_view key_view = key;
+  CASE_EXPECT_EQ(atfw::util::hash::xxh3_hasher<std::string>()(key),
+                 atfw::util::hash::xxh3_hasher<atfw::util::nostd::string_view>()(key_view));
+}
+
+// SMHasher style avalanche test: flipping any input bit should flip each output bit with probability 0.5
+CASE_TEST(xxh3_hash, quality_avalanche) {
+  const size_t sample_count = 600;
+  uint32_t seed = 17;
+  for (size_t len : {size_t(3), size_t(8), size_t(16), size_t(32), size_t(200), size_t(256)}) {
+    std::vector<uint32_t> flip_count(len * 8 * 64, 0);
+    std::vector<unsigned char> key(len);
+    for (size_t sample = 0; sample < sample_count; ++sample) {
+      for (size_t i = 0; i < len; ++i) {
+        seed = seed * 1103515245 + 12345;
+        key[i] = static_cast<unsigned char>(seed >> 16);
+      }
+
+      uint64_t base = atfw::util::hash::xxh3_64(key.data(), len);
+      for (size_t bit = 0; bit < len * 8; ++bit) {
+        key[bit / 8] ^= static_cast<unsigned char>(1 << (bit % 8));
+        uint64_t diff = base ^ atfw::util::hash::xxh3_64(key.data(), len);
+        key[bit / 8] ^= static_cast<unsigned char>(1 << (bit % 8));
+        for (size_t out = 0; out < 64; ++out) {
+          flip_count[bit * 64 + out] += static_cast<uint32_t>((diff >> out) & 1);
+        }
+      }
+    }
+
+    double worst_bias = 0.0;
+    for (uint32_t count : flip_count) {
+      double bias = static_cast<double>(count) / sample_count - 0.5;
+      if (bias < 0) {
+        bias = -bias;
+      }
+      if (bias > worst_bias) {
+        worst_bias = bias;
+      }
+    }
+    CASE_MSG_INFO() << "xxh3_64 avalanche len " << len << ": worst bias " << worst_bias << '\n';
+    CASE_EXPECT_LT(worst_bias, 0.12);
+  }
+}
+
+// SMHasher style collision and distribution test on sparse keys
+CASE_TEST(xxh3_hash, quality_collision) {
+  const size_t key_count = 1 << 18;
+  const size_t bucket_count = 1 << 12;
+  std::unordered_set<uint64_t> hashes;
+  std::vector<uint32_t> buckets(bucket_count, 0);
+  hashes.reserve(key_count * 2);
+
+  for (size_t i = 0; i < key_count; ++i) {
+    uint64_t int_key = static_cast<uint64_t>(i) << 20;
+    hashes.insert(atfw::util::hash::xxh3_64(&int_key, sizeof(int_key)));
+
+    std::string str_key = "user:" + std::to_string(i);
+    uint64_t h = atfw::util::hash::xxh3_64(str_key.data(), str_key.size());
+    hashes.insert(h);
+    ++buckets[h & (bucket_count - 1)];
+  }
+  CASE_EXPECT_EQ(key_count * 2, hashes.size());
+
+  // chi-square of low bits, expected close to bucket_count - 1
+  double expect = static_cast<double>(key_count) / bucket_count;
+  double chi_square = 0.0;
+  for (uint32_t count : buckets) {
+    chi_square += (count - expect) * (count - expect) / expect;
+  }
+  CASE_MSG_INFO() << "xxh3_64 chi-square of " << bucket_count << " buckets: " << chi_square << '\n';
+  CASE_EXPECT_LT(chi_square, bucket_count * 1.2);
+}
+
+#if defined(PROJECT_TEST_MACRO_ENABLE_BENCHMARK) && PROJECT_TEST_MACRO_ENABLE_BENCHMARK
+CASE_TEST(xxh3_hash, benchmark) {
+  std::vector<unsigned char> data = xxh3_hash_test_data(16 * 1024 * 1024);
+  uint64_t sink = 0;
+
+  std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+  sink += atfw::util::hash::xxh3_64(data.data(), data.size());
+  int64_t xxh3_usec = xxh3_hash_test_elapsed_usec(begin);
+
+  begin = std::chrono::steady_clock::now();
+  uint64_t murmur_out[2] = {0, 0};
+  atfw::util::hash::murmur_hash3_x64_128(data.data(), static_cast<int>(data.size()), 0, murmur_out);
+  sink += murmur_out[0];
+  int64_t murmur_usec = xxh3_hash_test_elapsed_usec(begin);
+
+  begin = std::chrono::steady_clock::now();
+  sink += atfw::util::hash::hash_fnv1a<uint64_t>(data.data(), data.size());
+  int64_t fnv_usec = xxh3_hash_test_elapsed_usec(begin);
+
+  CASE_MSG_INFO() << "hash " << data.size() << " bytes, xxh3_64: " << xxh3_usec
+                  << "us, murmur3_x64_128: " << murmur_usec << "us, fnv1a_64: " << fnv_usec << "us" << '\n';
+
+  // Small keys, as used by hash tables
+  for (size_t len : {size_t(8), size_t(16), size_t(32), size_t(64)}) {
+    const size_t loop_count = 1 << 20;
+    begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < loop_count; ++i) {
+      sink += atfw::util::hash::xxh3_64(data.data() + (i & 1023), len);
+    }
+    int64_t small_xxh3_usec = xxh3_hash_test_elapsed_usec(begin);
+
+    begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < loop_count; ++i) {
+      sink += atfw::util::hash::murmur_hash2_64a(data.data() + (i & 1023), static_cast<int>(len), 0);
+    }
+    int64_t small_murmur_usec = xxh3_hash_test_elapsed_usec(begin);
+
+    CASE_MSG_INFO() << "hash " << loop_count << " keys of " << len << " bytes, xxh3_64: " << small_xxh3_usec
+                    << "us, murmur2_64a: " << small_murmur_usec << "us" << '\n';
+  }
+
+  CASE_EXPECT_NE(0, sink);
+}
+#endif
@@ -1,7 +1,9 @@
 // Copyright 2026 atframework
 
+#include <chrono>
 #include <cstdlib>
 #include <cstring>
+#include <vector>
 
 #include "frame/test_macros.h"
 
@@ -67,4 +69,86 @@ CASE_TEST(xxtea, input_output) {
     CASE_EXPECT_EQ(0, memcmp(test_data_out, xtea_test_pt[i], 8));
     CASE_EXPECT_EQ(8, olen);
   }
-}
\ No newline at end of file
+}
+CASE_TEST(xxtea, multi_buffer) {
+  atfw::util::xxtea_key key;
+  atfw::util::xxtea_setup(&key, xtea_test_key[0]);
+
+  // 11 buffers of the same length use both 8 and 4 lanes when AVX2 is available
+  const size_t lens[] = {64, 4, 64, 8, 64, 64, 1500, 64, 64, 64, 8, 64, 64, 64, 0, 1500, 64, 16, 4};
+  const size_t count = sizeof(lens) / sizeof(lens[0]);
+
+  std::vector<std::vector<unsigned char>> plain;
+  std::vector<std::vector<unsigned char>> expect;
+  std::vector<std::vector<unsigned char>> real;
+  std::vector<void *> buffers;
+  plain.resize(count);
+  expect.resize(count);
+  real.resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    plain[i].resize(lens[i] + 1);
+    for (size_t j = 0; j < lens[i]; ++j) {
+      plain[i][j] = static_cast<unsigned char>(i * 131 + j * 7);
+    }
+    expect[i] = plain[i];
+    real[i] = plain[i];
+    atfw::util::xxtea_encrypt(&key, expect[i].data(), lens[i]);
+    buffers.push_back(real[i].data());
+  }
+
+  atfw::util::xxtea_encrypt_multi(&key, buffers.data(), lens, count);
+  for (size_t i = 0; i < count; ++i) {
+    CASE_EXPECT_TRUE(expect[i] == real[i]);
+  }
+
+  // XXTEA can not restore a single uint32_t, so compare with the scalar decrypt instead of the plain text
+  atfw::util::xxtea_decrypt_multi(&key, buffers.data(), lens, count);
+  for (size_t i = 0; i < count; ++i) {
+    atfw::util::xxtea_decrypt(&key, expect[i].data(), lens[i]);
+    CASE_EXPECT_TRUE(expect[i] == real[i]);
+    if (lens[i] > 4) {
+      CASE_EXPECT_TRUE(plain[i] == real[i]);
+    }
+  }
+}
+
+#if defined(PROJECT_TEST_MACRO_ENABLE_BENCHMARK) && PROJECT_TEST_MACRO_ENABLE_BENCHMARK
+CASE_TEST(xxtea, multi_buffer_benchmark) {
+  atfw::util::xxtea_key key;
+  atfw::util::xxtea_setup(&key, xtea_test_key[0]);
+
+  const size_t packet_sizes[] = {16, 64, 256, 1024};
+  const size_t packet_count = 1024;
+  for (size_t packet_size : packet_sizes) {
+    std::vector<unsigned char> scalar_data(packet_size * packet_count, 0x5A);
+    std::vector<unsigned char> multi_data(packet_size * packet_count, 0x5A);
+    std::vector<void *> buffers;
+    std::vector<size_t> lens(packet_count, packet_size);
+    for (size_t i = 0; i < packet_count; ++i) {
+      buffers.push_back(multi_data.data() + i * packet_size);
+    }
+
+    const size_t rounds = 4;
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < rounds; ++r) {
+      for (size_t i = 0; i < packet_count; ++i) {
+        atfw::util::xxtea_encrypt(&key, scalar_data.data() + i * packet_size, packet_size);
+      }
+    }
+    std::chrono::steady_clock::time_point scalar_end = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < rounds; ++r) {
+      atfw::util::xxtea_encrypt_multi(&key, buffers.data(), lens.data(), packet_count);
+    }
+    std::chrono::steady_clock::time_point multi_end = std::chrono::steady_clock::now();
+    CASE_EXPECT_TRUE(scalar_data == multi_data);
+
+    double bytes = static_cast<double>(rounds * packet_count * packet_size);
+    double scalar_us =
+        static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(scalar_end - begin).count()) + 1;
+    double multi_us =
+        static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(multi_end - scalar_end).count()) + 1;
+    CASE_MSG_INFO() << "xxtea packet size: " << packet_size << ", xxtea_encrypt: " << bytes / scalar_us
+                    << "MB/s, xxtea_encrypt_multi: " << bytes / multi_us << "MB/s" << '\n';
+  }
+}
+#endif
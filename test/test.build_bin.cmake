@@ -46,6 +46,10 @@ function(atframe_add_test_executable TARGET_NAME)
     endif()
   endif()
 
+  if(PROJECT_TEST_ENABLE_BENCHMARK)
+    list(APPEND PROJECT_TEST_DEFINITIONS PROJECT_TEST_MACRO_ENABLE_BENCHMARK=1)
+  endif()
+
   add_executable(${TARGET_NAME} ${ARGN})
   set_property(TARGET ${TARGET_NAME} PROPERTY FOLDER "atframework/test")
   # add_target_properties(${TARGET_NAME} LINK_FLAGS /NODEFAULTLIB:library)